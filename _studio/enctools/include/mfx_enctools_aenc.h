@@ -35,7 +35,6 @@ class AEnc_EncTool
 {
 public:
     AEnc_EncTool() :
-        m_ptmpFrame(nullptr),
         m_bInit(false)
     {
         m_aencPar = {};
@@ -58,7 +57,8 @@ protected:
     mfxStatus FindOutFrame(mfxU32 displayOrder);
     mfxHDL       m_aenc;
     AEncParam    m_aencPar;
-    mfxU8 *m_ptmpFrame;
+    std::vector<mfxU8> m_tmpFrame; // downscaled luma for analysis
+    EncToolsUtils::AreaDownScaler m_downScaler;
     bool m_bInit;
     mfxU32 FrameWidth_aligned;
     mfxU32 FrameHeight_aligned;
@@ -26,11 +26,33 @@
 #include "mfxdefs.h"
 #include "mfx_utils_defs.h"
 
+#include <vector>
+
 
 namespace EncToolsUtils
 {
 
-template <typename T> mfxStatus DownScaleNN(T const & pSrc, mfxU32 srcWidth, mfxU32 srcHeight, mfxU32 srcPitch,
-    T & pDst, mfxU32 dstWidth, mfxU32 dstHeight, mfxU32 dstPitch);
+// Column sums of numRows rows (at most 257) of 8-bit samples for all columns, pitch is in bytes.
+// SumRows_*_AVX2 kernels do the same for leading columns, these ones are used for the rest.
+int SumRows_8u16u_C(const mfxU8* pSrc, int srcPitch, int width, int numRows, mfxU16* pSum);
+
+// the same for 16-bit samples taken as (sample >> shift), which must fit in 8 bits
+int SumRows_16u16u_C(const mfxU16* pSrc, int srcPitch, int width, int numRows, int shift, mfxU16* pSum);
+
+// Every destination pixel is the rounded average of the source pixels it covers, (sample >> shift)
+// must fit in 8 bits. Pitches are in samples. Only destination rows [firstRow, firstRow + numRows)
+// are written, so bands of one frame can be scaled in parallel by separate instances.
+// Scratch buffers are kept between calls.
+class AreaDownScaler
+{
+public:
+    template <typename T> mfxStatus DownScaleArea(T const & pSrc, mfxU32 srcWidth, mfxU32 srcHeight, mfxU32 srcPitch, mfxU32 shift,
+        mfxU8 & pDst, mfxU32 dstWidth, mfxU32 dstHeight, mfxU32 dstPitch, mfxU32 firstRow, mfxU32 numRows);
+
+protected:
+    std::vector<mfxU32> m_left;   // first source column of every destination column and the end
+    std::vector<mfxU16> m_rowSum; // column sums of up to 257 source rows
+    std::vector<mfxU32> m_colSum; // column sums of taller areas
+};
 
 };
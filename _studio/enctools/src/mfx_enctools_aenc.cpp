@@ -112,7 +112,7 @@ mfxStatus AEnc_EncTool::SubmitFrame(mfxFrameSurface1 *surface)
     MFX_CHECK(m_bInit, MFX_ERR_NOT_INITIALIZED);
     mfxStatus sts = MFX_ERR_NONE;
     mfxU32 wS, hS, pitch;
-    mfxU8 *pS0, *pS;
+    mfxU8 *pS;
 
     if (surface->Info.CropH > 0 && surface->Info.CropW > 0)
     {
@@ -126,17 +126,29 @@ mfxStatus AEnc_EncTool::SubmitFrame(mfxFrameSurface1 *surface)
     }
     pitch = surface->Data.Pitch;
 
-    pS = pS0 = surface->Data.Y + surface->Info.CropX + surface->Info.CropY * pitch;
+    // analysis works on 8-bit luma, 10-bit input is converted along with scaling
+    bool bHighBitDepth = surface->Info.FourCC == MFX_FOURCC_P010;
+    mfxU32 bpp = bHighBitDepth ? 2 : 1;
 
-    if (wS > m_aencPar.FrameWidth || hS > m_aencPar.FrameHeight)
+    pS = surface->Data.Y + surface->Info.CropX * bpp + surface->Info.CropY * pitch;
+
+    if (pS && (wS > m_aencPar.FrameWidth || hS > m_aencPar.FrameHeight || bHighBitDepth))
     {
-        if (!m_ptmpFrame)
-            m_ptmpFrame = new mfxU8[m_aencPar.FrameWidth * m_aencPar.FrameHeight];
+        mfxU32 wD = std::min(wS, m_aencPar.FrameWidth);
+        mfxU32 hD = std::min(hS, m_aencPar.FrameHeight);
+        m_tmpFrame.resize(m_aencPar.FrameWidth * m_aencPar.FrameHeight);
 
-        sts = DownScaleNN(*pS, wS, hS, pitch, *m_ptmpFrame, m_aencPar.FrameWidth, m_aencPar.FrameHeight, m_aencPar.FrameWidth);
-        pitch = m_aencPar.FrameWidth;
-        pS = m_ptmpFrame;
+        if (bHighBitDepth)
+        {
+            mfxU32 shift = surface->Info.Shift ? 8 : std::max<mfxU32>(surface->Info.BitDepthLuma, 10) - 8;
+            sts = m_downScaler.DownScaleArea(*(mfxU16*)pS, wS, hS, pitch / 2, shift, m_tmpFrame[0], wD, hD, m_aencPar.FrameWidth, 0, hD);
+        }
+        else
+            sts = m_downScaler.DownScaleArea(*pS, wS, hS, pitch, 0, m_tmpFrame[0], wD, hD, m_aencPar.FrameWidth, 0, hD);
         MFX_CHECK_STS(sts);
+
+        pitch = m_aencPar.FrameWidth;
+        pS = m_tmpFrame.data();
     }
 
     AEncFrame res;
@@ -290,7 +302,7 @@ void AEnc_EncTool::Close()
     if (m_bInit)
     {
         AEncClose(m_aenc);
-        delete m_ptmpFrame;
+        m_tmpFrame.clear();
         m_bInit = false;
     }
 }
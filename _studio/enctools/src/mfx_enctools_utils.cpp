@@ -20,27 +20,100 @@
 
 #include <cstring>
 #include <assert.h>
+#include <algorithm>
+#include <vector>
 #include "mfx_enctools_utils.h"
+#include "mfx_enctools_utils_avx2.h"
 
 namespace EncToolsUtils
 {
+    int SumRows_8u16u_C(const mfxU8* pSrc, int srcPitch, int width, int numRows, mfxU16* pSum)
+    {
+        std::fill(pSum, pSum + width, 0);
+        for (int y = 0; y < numRows; y++, pSrc += srcPitch)
+            for (int x = 0; x < width; x++)
+                pSum[x] += pSrc[x];
+        return width;
+    }
+
+    int SumRows_16u16u_C(const mfxU16* pSrc, int srcPitch, int width, int numRows, int shift, mfxU16* pSum)
+    {
+        std::fill(pSum, pSum + width, 0);
+        for (int y = 0; y < numRows; y++, pSrc = (const mfxU16*)((const mfxU8*)pSrc + srcPitch))
+            for (int x = 0; x < width; x++)
+                pSum[x] += pSrc[x] >> shift;
+        return width;
+    }
 
-    template <typename T> mfxStatus DownScaleNN(T const & pSrc, mfxU32 srcWidth, mfxU32 srcHeight, mfxU32 srcPitch,
-        T & pDst, mfxU32 dstWidth, mfxU32 dstHeight, mfxU32 dstPitch)
+    // column sums of numRows rows, samples are taken as (sample >> shift), pitch is in samples
+    static void SumRows(mfxU8 const * pSrc, mfxU32 srcPitch, mfxU32 width, mfxU32 numRows, mfxU32, mfxU16 * pSum)
     {
-        mfxI32 step_w = srcWidth / dstWidth;
-        mfxI32 step_h = srcHeight / dstHeight;
-        for (mfxI32 y = 0; y < (mfxI32)dstHeight; y++) {
-            for (mfxI32 x = 0; x < (mfxI32)dstWidth; x++) {
-                T const * ps = &pSrc + ((y * step_h) * srcPitch) + (x * step_w);
-                T* pd = &pDst + (y * dstPitch) + x;
-                pd[0] = ps[0];
+        mfxU32 x0 = UseAVX2() ? SumRows_8u16u_AVX2(pSrc, srcPitch, width, numRows, pSum) : 0;
+        SumRows_8u16u_C(pSrc + x0, srcPitch, width - x0, numRows, pSum + x0);
+    }
+
+    static void SumRows(mfxU16 const * pSrc, mfxU32 srcPitch, mfxU32 width, mfxU32 numRows, mfxU32 shift, mfxU16 * pSum)
+    {
+        mfxU32 x0 = UseAVX2() ? SumRows_16u16u_AVX2(pSrc, srcPitch * sizeof(mfxU16), width, numRows, shift, pSum) : 0;
+        SumRows_16u16u_C(pSrc + x0, srcPitch * sizeof(mfxU16), width - x0, numRows, shift, pSum + x0);
+    }
+
+    template <typename T> mfxStatus AreaDownScaler::DownScaleArea(T const & pSrc, mfxU32 srcWidth, mfxU32 srcHeight, mfxU32 srcPitch, mfxU32 shift,
+        mfxU8 & pDst, mfxU32 dstWidth, mfxU32 dstHeight, mfxU32 dstPitch, mfxU32 firstRow, mfxU32 numRows)
+    {
+        MFX_CHECK(dstWidth && dstHeight && srcWidth >= dstWidth && srcHeight >= dstHeight, MFX_ERR_UNSUPPORTED);
+        MFX_CHECK(firstRow + numRows <= dstHeight, MFX_ERR_UNSUPPORTED);
+
+        // 16-bit column sums of 8-bit samples can't overflow
+        const mfxU32 maxRowsPerSum = 257;
+
+        // resize() reallocates only when the frame gets wider
+        m_left.resize(dstWidth + 1);
+        for (mfxU32 x = 0; x <= dstWidth; x++)
+            m_left[x] = x * srcWidth / dstWidth;
+
+        m_rowSum.resize(srcWidth);
+
+        for (mfxU32 y = firstRow; y < firstRow + numRows; y++)
+        {
+            mfxU32 top = y * srcHeight / dstHeight;
+            mfxU32 bottom = (y + 1) * srcHeight / dstHeight;
+            T const * ps = &pSrc + top * srcPitch;
+            bool bTall = bottom - top > maxRowsPerSum;
+
+            SumRows(ps, srcPitch, srcWidth, std::min(bottom - top, maxRowsPerSum), shift, m_rowSum.data());
+            if (bTall)
+            {
+                m_colSum.assign(m_rowSum.begin(), m_rowSum.end());
+                for (mfxU32 r = top + maxRowsPerSum; r < bottom; r += maxRowsPerSum)
+                {
+                    SumRows(&pSrc + r * srcPitch, srcPitch, srcWidth, std::min(bottom - r, maxRowsPerSum), shift, m_rowSum.data());
+                    for (mfxU32 x = 0; x < srcWidth; x++)
+                        m_colSum[x] += m_rowSum[x];
+                }
+            }
+
+            mfxU8* pd = &pDst + y * dstPitch;
+            for (mfxU32 x = 0; x < dstWidth; x++)
+            {
+                mfxU32 sum = 0;
+                if (!bTall)
+                    for (mfxU32 i = m_left[x]; i < m_left[x + 1]; i++)
+                        sum += m_rowSum[i];
+                else
+                    for (mfxU32 i = m_left[x]; i < m_left[x + 1]; i++)
+                        sum += m_colSum[i];
+
+                mfxU32 area = (m_left[x + 1] - m_left[x]) * (bottom - top);
+                pd[x] = (mfxU8)((sum + area / 2) / area);
             }
         }
         return MFX_ERR_NONE;
     }
 
-    template mfxStatus DownScaleNN(mfxU8 const & pSrc, mfxU32 srcWidth, mfxU32 srcHeight, mfxU32 srcPitch,
-        mfxU8 & pDst, mfxU32 dstWidth, mfxU32 dstHeight, mfxU32 dstPitch);
+    template mfxStatus AreaDownScaler::DownScaleArea(mfxU8 const & pSrc, mfxU32 srcWidth, mfxU32 srcHeight, mfxU32 srcPitch, mfxU32 shift,
+        mfxU8 & pDst, mfxU32 dstWidth, mfxU32 dstHeight, mfxU32 dstPitch, mfxU32 firstRow, mfxU32 numRows);
+    template mfxStatus AreaDownScaler::DownScaleArea(mfxU16 const & pSrc, mfxU32 srcWidth, mfxU32 srcHeight, mfxU32 srcPitch, mfxU32 shift,
+        mfxU8 & pDst, mfxU32 dstWidth, mfxU32 dstHeight, mfxU32 dstPitch, mfxU32 firstRow, mfxU32 numRows);
 
 }
@@ -0,0 +1,66 @@
+// Copyright (c) 2020 Intel Corporation
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <immintrin.h>
+#include "mfx_enctools_utils_avx2.h"
+
+namespace EncToolsUtils
+{
+
+int SumRows_8u16u_AVX2(const uint8_t* pSrc, int srcPitch, int width, int numRows, uint16_t* pSum)
+{
+    int x = 0;
+    for (; x + 32 <= width; x += 32)
+    {
+        const uint8_t* ps = pSrc + x;
+        __m256i lo = _mm256_setzero_si256();
+        __m256i hi = _mm256_setzero_si256();
+        for (int y = 0; y < numRows; y++, ps += srcPitch)
+        {
+            __m256i s = _mm256_loadu_si256((const __m256i*)ps);
+            lo = _mm256_add_epi16(lo, _mm256_unpacklo_epi8(s, _mm256_setzero_si256()));
+            hi = _mm256_add_epi16(hi, _mm256_unpackhi_epi8(s, _mm256_setzero_si256()));
+        }
+        // unpack works within 128-bit lanes, restore column order
+        _mm256_storeu_si256((__m256i*)(pSum + x),      _mm256_permute2x128_si256(lo, hi, 0x20));
+        _mm256_storeu_si256((__m256i*)(pSum + x + 16), _mm256_permute2x128_si256(lo, hi, 0x31));
+    }
+    return x;
+}
+
+int SumRows_16u16u_AVX2(const uint16_t* pSrc, int srcPitch, int width, int numRows, int shift, uint16_t* pSum)
+{
+    const __m128i vShift = _mm_cvtsi32_si128(shift);
+    int x = 0;
+    for (; x + 16 <= width; x += 16)
+    {
+        const uint8_t* ps = (const uint8_t*)(pSrc + x);
+        __m256i sum = _mm256_setzero_si256();
+        for (int y = 0; y < numRows; y++, ps += srcPitch)
+        {
+            __m256i s = _mm256_loadu_si256((const __m256i*)ps);
+            sum = _mm256_add_epi16(sum, _mm256_srl_epi16(s, vShift));
+        }
+        _mm256_storeu_si256((__m256i*)(pSum + x), sum);
+    }
+    return x;
+}
+
+};
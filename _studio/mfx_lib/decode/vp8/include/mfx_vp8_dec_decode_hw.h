@@ -42,71 +42,61 @@
 class MFX_VP8_BoolDecoder
 {
 private:
+    // not consumed bits of the stream, MSB aligned
+    uint64_t m_value;
+    // number of valid bits in m_value, never less than 8 between calls
+    int32_t m_bits;
     uint32_t m_range;
-    uint32_t m_value;
-    int32_t m_bitcount;
-    uint32_t m_pos;
+    // next byte to be loaded into m_value
+    uint32_t m_load_pos;
     uint8_t *m_input;
     int32_t m_input_size;
 
     static const int range_normalization_shift[64];
 
-    int decode_bit(int probability)
+    // loads as many whole bytes as m_value can take, bytes past the end read as zeros
+    void fill()
     {
+        int32_t n = (64 - m_bits) >> 3;
+        uint64_t chunk = 0;
 
-        uint32_t bit = 0;
-        uint32_t split;
-        uint32_t bigsplit;
-        uint32_t count = this->m_bitcount;
-        uint32_t range = this->m_range;
-        uint32_t value = this->m_value;
-
-        split = 1 +  (((range - 1) * probability) >> 8);
-        bigsplit = (split << 24);
-
-        range = split;
-        if(value >= bigsplit)
+        if (m_load_pos + 8 <= (uint32_t)m_input_size)
         {
-           range = this->m_range - split;
-           value = value - bigsplit;
-           bit = 1;
-        }
+            const uint8_t *p = m_input + m_load_pos;
 
-        if(range >= 0x80)
-        {
-            this->m_value = value;
-            this->m_range = range;
-            return bit;
+            chunk = ((uint64_t)p[0] << 56) | ((uint64_t)p[1] << 48) |
+                    ((uint64_t)p[2] << 40) | ((uint64_t)p[3] << 32) |
+                    ((uint64_t)p[4] << 24) | ((uint64_t)p[5] << 16) |
+                    ((uint64_t)p[6] << 8)  |  (uint64_t)p[7];
+            chunk >>= 64 - 8 * n;
         }
         else
         {
-            do
+            for (int32_t i = 0; i < n; i++)
             {
-                range += range;
-                value += value;
-
-                if (!--count)
-                {
-                    count = 8;
-                    value |= static_cast<uint32_t>(this->m_input[this->m_pos]);
-                    this->m_pos++;
-                }
-             }
-             while(range < 0x80);
+                chunk <<= 8;
+                if (m_load_pos + i < (uint32_t)m_input_size)
+                    chunk |= m_input[m_load_pos + i];
+            }
         }
-        this->m_bitcount = count;
-        this->m_value = value;
-        this->m_range = range;
-        return bit;
 
+        m_value |= chunk << (64 - 8 * n - m_bits);
+        m_bits += 8 * n;
+        m_load_pos += n;
+    }
+
+    // number of bits consumed since init
+    uint32_t consumed() const
+    {
+        return m_load_pos * 8 - m_bits;
     }
 
 public:
     MFX_VP8_BoolDecoder() :
-        m_range(0),
         m_value(0),
-        m_bitcount(0),
-        m_pos(0),
+        m_bits(0),
+        m_range(0),
+        m_load_pos(0),
         m_input(0),
         m_input_size(0)
     {}
@@ -118,14 +108,48 @@ public:
 
     void init(uint8_t *pBitStream, int32_t dataSize)
     {
+        m_value = 0;
+        m_bits = 0;
         m_range = 255;
-        m_bitcount = 8;
-        m_pos = 0;
-        m_value = (pBitStream[0] << 24) + (pBitStream[1] << 16) +
-                  (pBitStream[2] << 8) + pBitStream[3];
-        m_pos += 4;
+        m_load_pos = 0;
         m_input     = pBitStream;
         m_input_size = dataSize;
+
+        fill();
+    }
+
+    // decodes one bool, doesn't check for the end of data
+    int decode_bit(int probability)
+    {
+        uint32_t split = 1 + (((m_range - 1) * probability) >> 8);
+        uint64_t bigsplit = (uint64_t)split << 56;
+        int bit = 0;
+
+        if (m_value >= bigsplit)
+        {
+            m_range -= split;
+            m_value -= bigsplit;
+            bit = 1;
+        }
+        else
+        {
+            m_range = split;
+        }
+
+        if (m_range < 0x80)
+        {
+            int shift = range_normalization_shift[m_range >> 1];
+
+            m_range <<= shift;
+            m_value <<= shift;
+            m_bits -= shift;
+
+            // keep at least one whole byte in m_value, value() reports it
+            if (m_bits < 8)
+                fill();
+        }
+
+        return bit;
     }
 
     uint32_t decode(int bits = 1, int prob = 128)
@@ -133,9 +157,9 @@ public:
         uint32_t z = 0;
         int bit;
 
-        if (m_pos >= (uint32_t)m_input_size)
+        if (end())
             throw vp8_exception(MFX_ERR_MORE_DATA);
-        
+
         for (bit = bits - 1; bit >= 0;bit--)
         {
             z |= (decode_bit(prob) << bit);
@@ -143,19 +167,27 @@ public:
         return z;
     }
 
+    bool end() const
+    {
+        return pos() >= (uint32_t)m_input_size;
+    }
+
+    // position and bit count below are reported the same way as by a decoder
+    // which keeps 4 bytes ahead and refills them byte by byte (what VA expects)
+
     uint8_t * input()
     {
-        return &m_input[m_pos];
+        return &m_input[pos()];
     }
 
     uint32_t pos() const
     {
-        return m_pos;
+        return 4 + (consumed() >> 3);
     }
 
     int32_t bitcount() const
     {
-        return m_bitcount;
+        return 8 - (consumed() & 7);
     }
 
     uint32_t range() const
@@ -165,7 +197,7 @@ public:
 
     uint32_t value() const
     {
-        return m_value;
+        return (uint32_t)(m_value >> 32);
     }
 };
 
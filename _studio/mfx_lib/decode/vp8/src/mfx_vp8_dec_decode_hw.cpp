@@ -1241,20 +1241,25 @@ mfxStatus VideoDECODEVP8_HW::DecodeFrameHeader(mfxBitstream *in)
         else
             m_refresh_info.refreshLastFrame = 1;
 
-        for (int i = 0; i < VP8_NUM_COEFF_PLANES; i++)
         {
-            for (int j = 0; j < VP8_NUM_COEFF_BANDS; j++)
+            // walk update probabilities and coefficient probabilities as flat tables,
+            // end of data is checked once since decode_bit reads zeros past it
+            MFX_VP8_BoolDecoder &bd = m_boolDecoder[VP8_FIRST_PARTITION];
+            const mfxU8 *up = &vp8_coeff_update_probs[0][0][0][0];
+            mfxU8 *p = &m_frameProbs.coeff_probs[0][0][0][0];
+            const mfxU32 count = sizeof(m_frameProbs.coeff_probs);
+
+            if (bd.end())
+                throw vp8_exception(MFX_ERR_MORE_DATA);
+
+            for (mfxU32 i = 0; i < count; i++)
             {
-                for (int k = 0; k < VP8_NUM_LOCAL_COMPLEXITIES; k++)
+                if (bd.decode_bit(up[i]))
                 {
-                    for (int l = 0; l < VP8_NUM_COEFF_NODES; l++)
-                    {
-                        mfxU8 prob = vp8_coeff_update_probs[i][j][k][l];
-                        mfxU8 flag = (uint8_t)m_boolDecoder[VP8Defs::VP8_FIRST_PARTITION].decode(1, prob);
-
-                        if (flag)
-                            m_frameProbs.coeff_probs[i][j][k][l] = (uint8_t)m_boolDecoder[VP8_FIRST_PARTITION].decode(8);
-                    }
+                    mfxU8 x = 0;
+                    for (int bit = 0; bit < 8; bit++)
+                        x = (mfxU8)((x << 1) | bd.decode_bit(128));
+                    p[i] = x;
                 }
             }
         }
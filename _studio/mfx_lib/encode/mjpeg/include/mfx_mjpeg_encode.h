@@ -34,6 +34,15 @@
 #include <mutex>
 #include <queue>
 
+// Frame passed by mfxExtJPEGBatch
+struct MJPEGEncodeBatchFrame
+{
+    mfxFrameSurface1 *surface;
+    mfxBitstream     *bs;
+    mfxU16           quality;
+    mfxU32           initialDataLength;
+};
+
 class MJPEGEncodeTask
 {
 public:
@@ -45,8 +54,8 @@ public:
     // Initialize the task object
     mfxStatus Initialize(UMC::VideoEncoderParams* params);
 
-    // Add a picture to the task
-    mfxStatus AddSource(mfxFrameSurface1* surface, mfxFrameInfo* frameInfo, bool useAuxInput);
+    // Add a picture to the task or to the given frame
+    mfxStatus AddSource(mfxFrameSurface1* surface, mfxFrameInfo* frameInfo, bool useAuxInput, UMC::MJPEGEncoderFrame* frame = NULL);
 
     // Calculate number of pieces to split the task between threads
     mfxU32    CalculateNumPieces(mfxFrameSurface1* surface, mfxFrameInfo* frameInfo);
@@ -69,7 +78,11 @@ public:
 
     std::unique_ptr<UMC::MJPEGVideoEncoder> m_pMJPEGVideoEncoder;
 
+    // Frames of the batch, each one is encoded entirely by a single thread
+    std::vector<MJPEGEncodeBatchFrame> m_batch;
+
     mfxStatus EncodePiece(const mfxU32 threadNumber);
+    mfxStatus EncodeBatchFrame(VideoCORE* core, const mfxU32 threadNumber);
 
 protected:
     // Close the object, release all resources
@@ -78,6 +91,7 @@ protected:
     std::mutex m_guard;
 
     mfxU32 encodedPieces;
+    mfxU32 encodedBatchFrames;
 };
 
 class MFXVideoENCODEMJPEG : public VideoENCODE
@@ -146,6 +160,10 @@ protected:
     mfxExtOpaqueSurfaceAlloc m_checkedOpaqAllocReq;
     mfxExtBuffer*            m_pCheckedExt[3];
 
+#if (MFX_VERSION >= MFX_VERSION_NEXT)
+    mfxStatus CheckBatch(mfxExtJPEGBatch* batch, mfxFrameSurface1* surface, mfxBitstream* bs);
+#endif
+
     //
     // Asynchronous processing functions
     //
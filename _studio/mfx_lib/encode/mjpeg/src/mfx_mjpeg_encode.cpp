@@ -46,6 +46,7 @@ MJPEGEncodeTask::MJPEGEncodeTask(void)
     , auxInput()
     , m_initialDataLength(0)
     , encodedPieces(0)
+    , encodedBatchFrames(0)
 {
 } // MJPEGEncodeTask::MJPEGEncodeTask(void)
 
@@ -59,6 +60,8 @@ void MJPEGEncodeTask::Close(void)
 {
     m_initialDataLength = 0;
     encodedPieces = 0;
+    encodedBatchFrames = 0;
+    m_batch.clear();
 
     if(m_pMJPEGVideoEncoder)
     {
@@ -96,6 +99,8 @@ void MJPEGEncodeTask::Reset(void)
 {
     m_initialDataLength = 0;
     encodedPieces = 0;
+    encodedBatchFrames = 0;
+    m_batch.clear();
 
     if(m_pMJPEGVideoEncoder)
     {
@@ -114,7 +119,7 @@ mfxU32 MJPEGEncodeTask::NumPiecesCollected(void)
     return m_pMJPEGVideoEncoder->NumPiecesCollected();
 }
 
-mfxStatus MJPEGEncodeTask::AddSource(mfxFrameSurface1* frameSurface, mfxFrameInfo* frameInfo, bool useAuxInput)
+mfxStatus MJPEGEncodeTask::AddSource(mfxFrameSurface1* frameSurface, mfxFrameInfo* frameInfo, bool useAuxInput, UMC::MJPEGEncoderFrame* frame)
 {
     uint32_t  width       = frameInfo->CropW - frameInfo->CropX;
     uint32_t  height      = frameInfo->CropH - frameInfo->CropY;
@@ -157,7 +162,7 @@ mfxStatus MJPEGEncodeTask::AddSource(mfxFrameSurface1* frameSurface, mfxFrameInf
     }
 
     // create an entry in the array
-    while (NumPicsCollected() < numFields)
+    while ((frame ? frame->GetNumPics() : NumPicsCollected()) < numFields)
     {
         std::unique_ptr<UMC::MJPEGEncoderPicture> encPic(new UMC::MJPEGEncoderPicture());
 
@@ -464,7 +469,10 @@ mfxStatus MJPEGEncodeTask::AddSource(mfxFrameSurface1* frameSurface, mfxFrameInf
             }
         }
 
-        m_pMJPEGVideoEncoder->AddPicture(encPic.release());
+        if (frame)
+            frame->m_pics.push_back(encPic.release());
+        else
+            m_pMJPEGVideoEncoder->AddPicture(encPic.release());
 
         isBottom = 1 - isBottom;
     }
@@ -626,6 +634,77 @@ mfxStatus MJPEGEncodeTask::EncodePiece(const mfxU32 threadNumber)
     return (pieceNum == NumPiecesCollected()) ? (MFX_TASK_DONE) : (MFX_TASK_WORKING);
 }
 
+mfxStatus MJPEGEncodeTask::EncodeBatchFrame(VideoCORE* core, const mfxU32 threadNumber)
+{
+    mfxStatus mfxRes = MFX_ERR_NONE;
+    mfxU32 frameNum = 0;
+
+    {
+        std::lock_guard<std::mutex> guard(m_guard);
+        frameNum = encodedBatchFrames;
+
+        if (frameNum >= m_batch.size())
+        {
+            return MFX_TASK_DONE;
+        }
+
+        encodedBatchFrames++;
+    }
+
+    MJPEGEncodeBatchFrame& batchFrame = m_batch[frameNum];
+    mfxFrameSurface1* frameSurface = batchFrame.surface;
+    mfxBitstream* frameBs = batchFrame.bs;
+    bool locked = false;
+
+    if (frameSurface->Data.Y == 0 && frameSurface->Data.U == 0 && frameSurface->Data.V == 0 && frameSurface->Data.A == 0)
+    {
+        mfxRes = core->LockExternalFrame(frameSurface->Data.MemId, &frameSurface->Data);
+        MFX_CHECK_STS(mfxRes);
+
+        if (!frameSurface->Data.Y)
+        {
+            core->UnlockExternalFrame(frameSurface->Data.MemId, &frameSurface->Data);
+            return MFX_ERR_UNDEFINED_BEHAVIOR;
+        }
+
+        locked = true;
+    }
+
+    // pictures of the frame are released by the frame, not by the encoder
+    UMC::MJPEGEncoderFrame frame;
+    UMC::MediaData pDataOut;
+
+    mfxRes = AddSource(frameSurface, &frameSurface->Info, locked, &frame);
+    if (MFX_ERR_NONE == mfxRes)
+    {
+        pDataOut.SetBufferPointer(frameBs->Data + frameBs->DataOffset + frameBs->DataLength, frameBs->MaxLength - frameBs->DataOffset - frameBs->DataLength);
+
+        // the surface is kept locked until the frame is encoded
+        UMC::Status umc_sts = m_pMJPEGVideoEncoder->EncodeFrame(threadNumber, &frame, batchFrame.quality, &pDataOut);
+        if(UMC::UMC_ERR_NOT_ENOUGH_BUFFER == umc_sts)
+            mfxRes = MFX_ERR_NOT_ENOUGH_BUFFER;
+        else if(UMC::UMC_ERR_INVALID_PARAMS == umc_sts)
+            mfxRes = MFX_ERR_UNDEFINED_BEHAVIOR;
+        else if(UMC::UMC_OK != umc_sts)
+            mfxRes = MFX_ERR_UNKNOWN;
+    }
+
+    if (locked)
+    {
+        mfxStatus sts = core->UnlockExternalFrame(frameSurface->Data.MemId, &frameSurface->Data);
+        if (MFX_ERR_NONE == mfxRes)
+            mfxRes = sts;
+    }
+    MFX_CHECK_STS(mfxRes);
+
+    frameBs->DataLength += (mfxU32)(pDataOut.GetDataSize());
+    frameBs->TimeStamp = frameSurface->Data.TimeStamp;
+    frameBs->DecodeTimeStamp = frameSurface->Data.TimeStamp;
+    frameBs->FrameType = MFX_FRAMETYPE_I;
+
+    return MFX_TASK_WORKING;
+}
+
 mfxStatus MFXVideoENCODEMJPEG::MJPEGENCODERoutine(void *pState, void *pParam, mfxU32 threadNumber, mfxU32 callNumber)
 {
     mfxStatus mfxRes = MFX_ERR_NONE;
@@ -679,6 +758,21 @@ mfxStatus MFXVideoENCODEMJPEG::MJPEGENCODECompleteProc(void *pState, void *pPara
         obj.m_core->DecreaseReference(&(surf->Data));
     }
 
+    for (size_t i = 0; i < pTask->m_batch.size(); i++)
+    {
+        MJPEGEncodeBatchFrame& frame = pTask->m_batch[i];
+
+        obj.m_frameCount++;
+
+        if(frame.bs->DataLength - frame.initialDataLength)
+        {
+            obj.m_encodedFrames++;
+            obj.m_totalBits += (frame.bs->DataLength - frame.initialDataLength) * 8;
+        }
+
+        obj.m_core->DecreaseReference(&(frame.surface->Data));
+    }
+
     pTask->Reset();
 
     {
@@ -797,6 +891,9 @@ mfxStatus MFXVideoENCODEMJPEG::Query(mfxVideoParam *in, mfxVideoParam *out)
         out->mfx.Interleaved             = MFX_SCANTYPE_INTERLEAVED;
         out->mfx.Quality                 = 1;
         out->mfx.RestartInterval         = 0;
+#if (MFX_VERSION >= MFX_VERSION_NEXT)
+        out->mfx.OptimizeHuffman         = 1;
+#endif
         out->AsyncDepth                  = 1;
         out->IOPattern                   = 1;
         out->Protected                   = 0;
@@ -1035,6 +1132,32 @@ mfxStatus MFXVideoENCODEMJPEG::Query(mfxVideoParam *in, mfxVideoParam *out)
             out->mfx.Quality = in->mfx.Quality;
         }
 
+#if (MFX_VERSION >= MFX_VERSION_NEXT)
+        switch (in->mfx.OptimizeHuffman)
+        {
+            case MFX_CODINGOPTION_UNKNOWN:
+            case MFX_CODINGOPTION_OFF:
+                out->mfx.OptimizeHuffman = in->mfx.OptimizeHuffman;
+                break;
+            case MFX_CODINGOPTION_ON:
+                // optimized tables are built for the whole scan, restart intervals are encoded independently
+                if (in->mfx.RestartInterval)
+                {
+                    out->mfx.OptimizeHuffman = MFX_CODINGOPTION_OFF;
+                    isCorrected++;
+                }
+                else
+                {
+                    out->mfx.OptimizeHuffman = in->mfx.OptimizeHuffman;
+                }
+                break;
+            default:
+                isInvalid++;
+                out->mfx.OptimizeHuffman = MFX_CODINGOPTION_UNKNOWN;
+                break;
+        }
+#endif
+
         switch (in->mfx.FrameInfo.PicStruct)
         {
             case MFX_PICSTRUCT_UNKNOWN:
@@ -1323,6 +1446,9 @@ mfxStatus MFXVideoENCODEMJPEG::Init(mfxVideoParam *par_in)
     m_pUmcVideoParams->buf_size              = 16384 + m_vParam.mfx.FrameInfo.Width * m_vParam.mfx.FrameInfo.Height * DoubleBytesPerPx / 2;
     m_pUmcVideoParams->restart_interval      = m_vParam.mfx.RestartInterval;
     m_pUmcVideoParams->interleaved           = (m_vParam.mfx.Interleaved == MFX_SCANTYPE_INTERLEAVED) ? 1 : 0;
+#if (MFX_VERSION >= MFX_VERSION_NEXT)
+    m_pUmcVideoParams->huffman_opt           = (m_vParam.mfx.OptimizeHuffman == MFX_CODINGOPTION_ON) ? 1 : 0;
+#endif
 
     switch(m_vParam.mfx.FrameInfo.PicStruct)
     {
@@ -1491,6 +1617,9 @@ mfxStatus MFXVideoENCODEMJPEG::Reset(mfxVideoParam *par)
     m_pUmcVideoParams->buf_size              = 16384 + m_vParam.mfx.FrameInfo.Width * m_vParam.mfx.FrameInfo.Height * DoubleBytesPerPx / 2;
     m_pUmcVideoParams->restart_interval      = m_vParam.mfx.RestartInterval;
     m_pUmcVideoParams->interleaved           = (m_vParam.mfx.Interleaved == MFX_SCANTYPE_INTERLEAVED) ? 1 : 0;
+#if (MFX_VERSION >= MFX_VERSION_NEXT)
+    m_pUmcVideoParams->huffman_opt           = (m_vParam.mfx.OptimizeHuffman == MFX_CODINGOPTION_ON) ? 1 : 0;
+#endif
 
     switch(m_vParam.mfx.FrameInfo.PicStruct)
     {
@@ -1700,10 +1829,17 @@ mfxStatus MFXVideoENCODEMJPEG::RunThread(MJPEGEncodeTask &task, mfxU32 threadNum
     }
     else if(task.m_pMJPEGVideoEncoder->NumPicsCollected() != numFields)
     {
-        return MFX_TASK_WORKING;
+        // batch frames don't wait for the main one
+        mfxRes = task.EncodeBatchFrame(m_core, threadNumber);
+        return (MFX_TASK_DONE == mfxRes) ? MFX_TASK_WORKING : mfxRes;
     }
 
-    return task.EncodePiece(threadNumber);
+    mfxRes = task.EncodePiece(threadNumber);
+    if (MFX_TASK_DONE != mfxRes)
+        return mfxRes;
+
+    // pieces of the frame are over, the thread takes whole frames of the batch
+    return task.EncodeBatchFrame(m_core, threadNumber);
 }
 
 mfxStatus MFXVideoENCODEMJPEG::EncodeFrame(mfxEncodeCtrl *, mfxEncodeInternalParams *, mfxFrameSurface1* /*inputSurface*/, mfxBitstream* /*bs*/)
@@ -1725,6 +1861,79 @@ mfxStatus MFXVideoENCODEMJPEG::GetEncodeStat(mfxEncodeStat *stat)
     return MFX_ERR_NONE;
 }
 
+#if (MFX_VERSION >= MFX_VERSION_NEXT)
+mfxStatus MFXVideoENCODEMJPEG::CheckBatch(mfxExtJPEGBatch* batch, mfxFrameSurface1* surface, mfxBitstream* bs)
+{
+    if (!batch || !batch->NumFrame)
+        return MFX_ERR_NONE;
+
+    // batch frames are encoded straight from the surfaces
+    if (m_useAuxInput || m_isOpaque)
+        return MFX_ERR_UNSUPPORTED;
+
+    MFX_CHECK_NULL_PTR2(batch->Surfaces, batch->Bitstreams);
+
+    for (mfxU32 i = 0; i < batch->NumFrame; i++)
+    {
+        mfxFrameSurface1* frameSurface = batch->Surfaces[i];
+        mfxBitstream* frameBs = batch->Bitstreams[i];
+
+        MFX_CHECK_NULL_PTR2(frameSurface, frameBs);
+
+        if (frameBs->Data == 0)
+            return MFX_ERR_NULL_PTR;
+
+        if (frameBs == bs || frameBs->MaxLength < (frameBs->DataOffset + frameBs->DataLength))
+            return MFX_ERR_UNDEFINED_BEHAVIOR;
+
+        // frames of the batch are encoded in parallel, so they can't share surfaces or bitstreams
+        if (frameSurface == surface)
+            return MFX_ERR_UNDEFINED_BEHAVIOR;
+
+        for (mfxU32 j = 0; j < i; j++)
+        {
+            if (batch->Surfaces[j] == frameSurface || batch->Bitstreams[j] == frameBs)
+                return MFX_ERR_UNDEFINED_BEHAVIOR;
+        }
+
+        if (frameBs->MaxLength - frameBs->DataOffset == 0)
+            return MFX_ERR_NOT_ENOUGH_BUFFER;
+
+        if (frameSurface->Info.FourCC != m_vParam.mfx.FrameInfo.FourCC ||
+            frameSurface->Info.ChromaFormat != m_vParam.mfx.FrameInfo.ChromaFormat ||
+            !frameSurface->Info.CropW || frameSurface->Info.CropX + frameSurface->Info.CropW > frameSurface->Info.Width ||
+            !frameSurface->Info.CropH || frameSurface->Info.CropY + frameSurface->Info.CropH > frameSurface->Info.Height)
+        {
+            return MFX_ERR_INVALID_VIDEO_PARAM;
+        }
+
+        if (batch->Quality && batch->Quality[i] > 100)
+            return MFX_ERR_INVALID_VIDEO_PARAM;
+
+        if (frameSurface->Data.Y)
+        {
+            if ((frameSurface->Info.FourCC == MFX_FOURCC_YV12 && (!frameSurface->Data.U || !frameSurface->Data.V)) ||
+                (frameSurface->Info.FourCC == MFX_FOURCC_NV12 && !frameSurface->Data.UV))
+            {
+                return MFX_ERR_UNDEFINED_BEHAVIOR;
+            }
+
+            mfxU32 pitch = frameSurface->Data.PitchLow + ((mfxU32)frameSurface->Data.PitchHigh << 16);
+            if (!pitch)
+            {
+                return MFX_ERR_UNDEFINED_BEHAVIOR;
+            }
+        }
+        else if (!frameSurface->Data.MemId)
+        {
+            return MFX_ERR_UNDEFINED_BEHAVIOR;
+        }
+    }
+
+    return MFX_ERR_NONE;
+}
+#endif
+
 mfxStatus MFXVideoENCODEMJPEG::EncodeFrameCheck(mfxEncodeCtrl *ctrl, mfxFrameSurface1 *surface, mfxBitstream *bs, mfxFrameSurface1 **reordered_surface, mfxEncodeInternalParams * /*pInternalParams*/)
 {
     mfxStatus sts = MFX_ERR_NONE;
@@ -1761,30 +1970,6 @@ mfxStatus MFXVideoENCODEMJPEG::EncodeFrameCheck(mfxEncodeCtrl *ctrl, mfxFrameSur
                 pTask->auxInput.Info = m_vParam.mfx.FrameInfo;
             }
 
-            // Set Quant/Huffman tables if they were passed by ext buffer in init/reset
-            {
-                if (m_vParam.ExtParam && m_vParam.NumExtParam > 0)
-                {
-                    jpegQT = (mfxExtJPEGQuantTables*)   GetExtBuffer( m_vParam.ExtParam, m_vParam.NumExtParam, MFX_EXTBUFF_JPEG_QT );
-                    jpegHT = (mfxExtJPEGHuffmanTables*) GetExtBuffer( m_vParam.ExtParam, m_vParam.NumExtParam, MFX_EXTBUFF_JPEG_HUFFMAN );
-                }
-
-                UMC::MJPEGVideoEncoder*  pMJPEGVideoEncoder = pTask->m_pMJPEGVideoEncoder.get();
-
-                if(jpegQT)
-                {
-                    umc_sts = pMJPEGVideoEncoder->SetQuantTableExtBuf(jpegQT);
-                }
-
-                if(jpegHT)
-                {
-                    umc_sts = pMJPEGVideoEncoder->SetHuffmanTableExtBuf(jpegHT);
-                }
-
-                if(umc_sts != UMC::UMC_OK)
-                    return MFX_ERR_UNDEFINED_BEHAVIOR;
-            }
-
             m_tasksCount++;
 
             // save the task object into the queue
@@ -1864,32 +2049,26 @@ mfxStatus MFXVideoENCODEMJPEG::EncodeFrameCheck(mfxEncodeCtrl *ctrl, mfxFrameSur
     {
         jpegQT = (mfxExtJPEGQuantTables*)   GetExtBuffer( ctrl->ExtParam, ctrl->NumExtParam, MFX_EXTBUFF_JPEG_QT );
         jpegHT = (mfxExtJPEGHuffmanTables*) GetExtBuffer( ctrl->ExtParam, ctrl->NumExtParam, MFX_EXTBUFF_JPEG_HUFFMAN );
-    }
-
-    UMC::MJPEGVideoEncoder* pMJPEGVideoEncoder = m_freeTasks.front()->m_pMJPEGVideoEncoder.get();
 
-    if(jpegQT)
-    {
-        umc_sts = pMJPEGVideoEncoder->SetQuantTableExtBuf(jpegQT);
-    }
-    else if(!pMJPEGVideoEncoder->IsQuantTableInited())
-    {
-        umc_sts = pMJPEGVideoEncoder->SetDefaultQuantTable(m_vParam.mfx.Quality);
+#if (MFX_VERSION >= MFX_VERSION_NEXT)
+        sts = CheckBatch((mfxExtJPEGBatch*) GetExtBuffer( ctrl->ExtParam, ctrl->NumExtParam, MFX_EXTBUFF_JPEG_BATCH ), surface, bs);
+        MFX_CHECK_STS(sts);
+#endif
     }
 
-    if(umc_sts != UMC::UMC_OK)
-        return MFX_ERR_UNDEFINED_BEHAVIOR;
-
-    if(jpegHT)
+    // tables passed by ext buffer in init/reset are used unless the frame has its own ones
+    if (m_vParam.ExtParam && m_vParam.NumExtParam > 0)
     {
-        umc_sts = pMJPEGVideoEncoder->SetHuffmanTableExtBuf(jpegHT);
-    }
-    else if(!pMJPEGVideoEncoder->IsHuffmanTableInited())
-    {
-        umc_sts = pMJPEGVideoEncoder->SetDefaultHuffmanTable();
+        if (!jpegQT)
+            jpegQT = (mfxExtJPEGQuantTables*)   GetExtBuffer( m_vParam.ExtParam, m_vParam.NumExtParam, MFX_EXTBUFF_JPEG_QT );
+        if (!jpegHT)
+            jpegHT = (mfxExtJPEGHuffmanTables*) GetExtBuffer( m_vParam.ExtParam, m_vParam.NumExtParam, MFX_EXTBUFF_JPEG_HUFFMAN );
     }
 
-    if(umc_sts != UMC::UMC_OK)
+    UMC::MJPEGVideoEncoder* pMJPEGVideoEncoder = m_freeTasks.front()->m_pMJPEGVideoEncoder.get();
+
+    umc_sts = pMJPEGVideoEncoder->SetTables(m_vParam.mfx.Quality, jpegQT, jpegHT);
+    if(umc_sts != UMC::UMC_OK || !pMJPEGVideoEncoder->IsQuantTableInited())
         return MFX_ERR_UNDEFINED_BEHAVIOR;
 
     m_frameCountSync++;
@@ -1949,8 +2128,35 @@ mfxStatus MFXVideoENCODEMJPEG::EncodeFrameCheck(mfxEncodeCtrl *ctrl, mfxFrameSur
             pTask = m_freeTasks.front();
         }
 
-        pEntryPoint->requiredNumThreads = std::min<mfxU32>( { pTask->m_pMJPEGVideoEncoder->NumEncodersAllocated(), m_vParam.mfx.NumThread,
-                                                      pTask->CalculateNumPieces(pOriginalSurface, &(m_vParam.mfx.FrameInfo)) } );
+        mfxU32 numPieces = pTask->CalculateNumPieces(pOriginalSurface, &(m_vParam.mfx.FrameInfo));
+
+#if (MFX_VERSION >= MFX_VERSION_NEXT)
+        mfxExtJPEGBatch* batch = NULL;
+        if (ctrl && ctrl->ExtParam && ctrl->NumExtParam > 0)
+            batch = (mfxExtJPEGBatch*) GetExtBuffer( ctrl->ExtParam, ctrl->NumExtParam, MFX_EXTBUFF_JPEG_BATCH );
+
+        if (batch && batch->NumFrame)
+        {
+            pTask->m_batch.resize(batch->NumFrame);
+
+            for (mfxU32 i = 0; i < batch->NumFrame; i++)
+            {
+                MJPEGEncodeBatchFrame& frame = pTask->m_batch[i];
+
+                frame.surface           = batch->Surfaces[i];
+                frame.bs                = batch->Bitstreams[i];
+                frame.quality           = batch->Quality ? batch->Quality[i] : 0;
+                frame.initialDataLength = frame.bs->DataLength;
+
+                m_core->IncreaseReference(&(frame.surface->Data));
+            }
+
+            // every frame of the batch is a single piece of work
+            numPieces += batch->NumFrame;
+        }
+#endif
+
+        pEntryPoint->requiredNumThreads = std::min<mfxU32>( { pTask->m_pMJPEGVideoEncoder->NumEncodersAllocated(), m_vParam.mfx.NumThread, numPieces } );
 
         pTask->bs           = bs;
         pTask->ctrl         = ctrl;
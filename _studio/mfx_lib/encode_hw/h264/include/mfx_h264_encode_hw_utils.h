@@ -3009,6 +3009,9 @@ private:
         CmDevicePtr         m_cmDevice;
         MfxVideoParam       m_video;
         MfxVideoParam       m_videoInit;  // m_video may change by Reset, m_videoInit doesn't change
+        MfxVideoParam       m_resetParIn; // parameters of the last successful Reset as passed by application
+        mfxStatus           m_resetCheckStatus; // their check status
+        bool                m_resetParInValid;  // m_video is the result of checking m_resetParIn
         mfxEncodeStat       m_stat;
 
         std::list<std::pair<mfxBitstream *, mfxU32> > m_listOfPairsForFieldOutputMode;
@@ -621,6 +621,8 @@ mfxStatus ImplementationAvc::QueryIOSurf(
 ImplementationAvc::ImplementationAvc(VideoCORE * core)
 : m_core(core)
 , m_video()
+, m_resetCheckStatus(MFX_ERR_NONE)
+, m_resetParInValid(false)
 , m_stat()
 , m_sliceDivider()
 , m_stagesToGo(0)
@@ -775,6 +777,7 @@ mfxStatus ImplementationAvc::Init(mfxVideoParam * par)
 
 
     m_video = *par;
+    m_resetParInValid = false;
     eMFXHWType platform = m_core->GetHWType();
     mfxStatus lpSts = SetLowPowerDefault(m_video, platform);
 
@@ -1304,35 +1307,54 @@ mfxStatus ImplementationAvc::ProcessAndCheckNewParameters(
 
 
     mfxExtEncoderResetOption & extResetOpt = GetExtBufferRef(newPar);
+    mfxStatus checkStatus = MFX_ERR_NONE;
 
-    sts = ReadSpsPpsHeaders(newPar);
-    MFX_CHECK_STS(sts);
+    // Checks of the same parameters against the same m_video give the same
+    // result, so Reset which repeats the previous one and changes only
+    // mfxExtEncoderResetOption (e.g. to start a new sequence) takes checked
+    // parameters from m_video. Any other change goes through the full checks,
+    // since defaults and corrections made there depend on each other.
+    // Query mode 3 (newParIn == 0) is always checked in full.
+    if (newParIn && m_resetParInValid &&
+        (GetChangedResetGroups(m_resetParIn, newPar) & ~RESET_GROUP_CONTROL) == 0)
+    {
+        mfxExtEncoderResetOption const resetOpt = extResetOpt;
 
-    mfxExtOpaqueSurfaceAlloc & extOpaqNew = GetExtBufferRef(newPar);
-    mfxExtOpaqueSurfaceAlloc & extOpaqOld = GetExtBufferRef(m_video);
-    MFX_CHECK(
-        extOpaqOld.In.Type       == extOpaqNew.In.Type       &&
-        extOpaqOld.In.NumSurface == extOpaqNew.In.NumSurface,
-        MFX_ERR_INCOMPATIBLE_VIDEO_PARAM);
+        newPar      = m_video;
+        extResetOpt = resetOpt;
+        checkStatus = m_resetCheckStatus;
+    }
+    else
+    {
+        sts = ReadSpsPpsHeaders(newPar);
+        MFX_CHECK_STS(sts);
 
-    mfxStatus spsppsSts = CopySpsPpsToVideoParam(newPar);
+        mfxExtOpaqueSurfaceAlloc & extOpaqNew = GetExtBufferRef(newPar);
+        mfxExtOpaqueSurfaceAlloc & extOpaqOld = GetExtBufferRef(m_video);
+        MFX_CHECK(
+            extOpaqOld.In.Type       == extOpaqNew.In.Type       &&
+            extOpaqOld.In.NumSurface == extOpaqNew.In.NumSurface,
+            MFX_ERR_INCOMPATIBLE_VIDEO_PARAM);
 
+        mfxStatus spsppsSts = CopySpsPpsToVideoParam(newPar);
 
-    //set NumSliceI/P/B to Numslice if not set by new parameters.
-    ResetNumSliceIPB(newPar);
 
-    InheritDefaultValues(m_video, newPar, m_caps, newParIn);
+        //set NumSliceI/P/B to Numslice if not set by new parameters.
+        ResetNumSliceIPB(newPar);
 
-    eMFXGTConfig* pMFXGTConfig = QueryCoreInterface<eMFXGTConfig>(m_core, MFXICORE_GT_CONFIG_GUID);
-    MFX_CHECK(pMFXGTConfig != nullptr, MFX_ERR_NULL_PTR);
+        InheritDefaultValues(m_video, newPar, m_caps, newParIn);
 
-    mfxStatus checkStatus = CheckVideoParam(newPar, m_caps, m_core->IsExternalFrameAllocator(), m_currentPlatform, m_currentVaType, *pMFXGTConfig);
-    if (checkStatus == MFX_WRN_PARTIAL_ACCELERATION)
-        return MFX_ERR_INVALID_VIDEO_PARAM;
-    else if (checkStatus < MFX_ERR_NONE)
-        return checkStatus;
-    else if (checkStatus == MFX_ERR_NONE)
-        checkStatus = spsppsSts;
+        eMFXGTConfig* pMFXGTConfig = QueryCoreInterface<eMFXGTConfig>(m_core, MFXICORE_GT_CONFIG_GUID);
+        MFX_CHECK(pMFXGTConfig != nullptr, MFX_ERR_NULL_PTR);
+
+        checkStatus = CheckVideoParam(newPar, m_caps, m_core->IsExternalFrameAllocator(), m_currentPlatform, m_currentVaType, *pMFXGTConfig);
+        if (checkStatus == MFX_WRN_PARTIAL_ACCELERATION)
+            return MFX_ERR_INVALID_VIDEO_PARAM;
+        else if (checkStatus < MFX_ERR_NONE)
+            return checkStatus;
+        else if (checkStatus == MFX_ERR_NONE)
+            checkStatus = spsppsSts;
+    }
 
     // check if change of temporal scalability required by new parameters
     mfxU32 tempLayerIdx = 0;
@@ -1614,6 +1636,7 @@ mfxStatus ImplementationAvc::Reset(mfxVideoParam *par)
         }
     }
     m_video = newPar;
+    m_resetParInValid = false;
     bool bModParams = false;
     if (m_enabledSwBrc)
     {
@@ -1641,6 +1664,11 @@ mfxStatus ImplementationAvc::Reset(mfxVideoParam *par)
     }
     if (bModParams)
         mod_par.Restore(newPar);
+
+    m_resetParIn       = *par;
+    m_resetCheckStatus = checkStatus;
+    m_resetParInValid  = true;
+
     return checkStatus;
 }
 
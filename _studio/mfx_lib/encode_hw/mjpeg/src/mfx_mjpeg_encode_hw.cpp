@@ -448,6 +448,21 @@ mfxStatus MFXVideoENCODEMJPEG_HW::Query(VideoCORE * core, mfxVideoParam *in, mfx
         out->mfx.Interleaved = in->mfx.Interleaved;
         out->mfx.RestartInterval = in->mfx.RestartInterval;
 
+#if (MFX_VERSION >= MFX_VERSION_NEXT)
+        // MFX_CODINGOPTION_ON is rejected by CheckJpegParam above
+        switch (in->mfx.OptimizeHuffman)
+        {
+            case MFX_CODINGOPTION_UNKNOWN:
+            case MFX_CODINGOPTION_OFF:
+                out->mfx.OptimizeHuffman = in->mfx.OptimizeHuffman;
+                break;
+            default:
+                isInvalid++;
+                out->mfx.OptimizeHuffman = MFX_CODINGOPTION_UNKNOWN;
+                break;
+        }
+#endif
+
         switch (in->mfx.FrameInfo.PicStruct)
         {
             case MFX_PICSTRUCT_UNKNOWN:
@@ -731,6 +746,11 @@ mfxStatus MFXVideoENCODEMJPEG_HW::Reset(mfxVideoParam *par)
     sts = CheckExtBufferId(*par);
     MFX_CHECK_STS(sts);
 
+#if (MFX_VERSION >= MFX_VERSION_NEXT)
+    // initialized HW encoder can't switch to SW one which builds optimized tables
+    MFX_CHECK(par->mfx.OptimizeHuffman != MFX_CODINGOPTION_ON, MFX_ERR_INVALID_VIDEO_PARAM);
+#endif
+
     mfxExtJPEGQuantTables*    jpegQT       = (mfxExtJPEGQuantTables*)   GetExtBuffer( par->ExtParam, par->NumExtParam, MFX_EXTBUFF_JPEG_QT );
     mfxExtJPEGHuffmanTables*  jpegHT       = (mfxExtJPEGHuffmanTables*) GetExtBuffer( par->ExtParam, par->NumExtParam, MFX_EXTBUFF_JPEG_HUFFMAN );
     mfxExtOpaqueSurfaceAlloc* opaqAllocReq = (mfxExtOpaqueSurfaceAlloc*)GetExtBuffer( par->ExtParam, par->NumExtParam, MFX_EXTBUFF_OPAQUE_SURFACE_ALLOCATION );
@@ -924,6 +944,12 @@ mfxStatus MFXVideoENCODEMJPEG_HW::EncodeFrameCheck(
     {
         jpegQT = (mfxExtJPEGQuantTables*)   GetExtBuffer( ctrl->ExtParam, ctrl->NumExtParam, MFX_EXTBUFF_JPEG_QT );
         jpegHT = (mfxExtJPEGHuffmanTables*) GetExtBuffer( ctrl->ExtParam, ctrl->NumExtParam, MFX_EXTBUFF_JPEG_HUFFMAN );
+
+#if (MFX_VERSION >= MFX_VERSION_NEXT)
+        // batch encoding is implemented by the software encoder only
+        if (GetExtBuffer( ctrl->ExtParam, ctrl->NumExtParam, MFX_EXTBUFF_JPEG_BATCH ))
+            return MFX_ERR_UNSUPPORTED;
+#endif
     }
 
     // Check new tables if exists
@@ -95,6 +95,11 @@ mfxStatus MfxHwMJpegEncode::CheckJpegParam(VideoCORE *core, mfxVideoParam & par,
     MFX_CHECK((par.mfx.Interleaved && hwCaps.Interleaved) || (!par.mfx.Interleaved && hwCaps.NonInterleaved),
         MFX_WRN_PARTIAL_ACCELERATION);
 
+#if (MFX_VERSION >= MFX_VERSION_NEXT)
+    // HW codes every picture with the tables set at Init, optimized tables are built by SW encoder only
+    MFX_CHECK(par.mfx.OptimizeHuffman != MFX_CODINGOPTION_ON, MFX_WRN_PARTIAL_ACCELERATION);
+#endif
+
     MFX_CHECK(par.mfx.FrameInfo.Width > 0 && par.mfx.FrameInfo.Height > 0,
         MFX_ERR_INCOMPATIBLE_VIDEO_PARAM);
 
@@ -56,7 +56,11 @@ enum
 
 enum
 {
-    MFX_THREAD_TIME_TO_WAIT     = 1000
+    // period (in usec) of polling tasks waiting for hardware,
+    // if no task completion wakes threads up earlier. Hardware status
+    // (e.g. encoder feedback) has no event to wait for, so the period trades
+    // the detection latency for CPU time spent in polling
+    MFX_THREAD_POLL_PERIOD      = 1000
 };
 
 
@@ -213,6 +217,10 @@ public:
     // WA for SINGLE THREAD MODE
     virtual
     mfxStatus GetTimeout(mfxU32 & maxTimeToRun);
+
+    // Get statistic of the real-time (earliest deadline first) tasks
+    virtual
+    mfxStatus GetDeadlineStat(MFX_SCHEDULER_DEADLINE_STAT *pStat);
 protected:
     // Destructor is protected to avoid deletion the object by occasion.
     virtual
@@ -263,6 +271,10 @@ protected:
     void GetTimeStat(mfxU64 timeSpent[MFX_PRIORITY_NUMBER],
                      mfxU64 totalTimeSpent[MFX_PRIORITY_NUMBER]);
 
+    // Get the ready task with the earliest deadline
+    mfxStatus GetDeadlineTask(MFX_CALL_INFO &callInfo,
+                              const mfxU32 threadNum);
+
     // Check if the thread can continue the previous task.
     mfxStatus CanContinuePreviousTask(MFX_CALL_INFO &callInfo,
                                       mfxTaskHandle previousTask,
@@ -304,8 +316,8 @@ protected:
     // Sets scheduling for the specified thread
     bool SetScheduling(std::thread& handle);
 
-    // Assign socket affinity for every thread
-    void SetThreadsAffinityToSockets(void);
+    // Binds every thread to the CPU set or NUMA node requested in mfxExtThreadsParam
+    bool SetThreadsAffinityToSockets(void);
 
     inline MFX_SCHEDULER_THREAD_CONTEXT* GetThreadCtx(mfxU32 thread_id)
     { return &m_pThreadCtx[thread_id]; }
@@ -352,7 +364,9 @@ protected:
     // Time wait period for 'waiting' tasks
     const
     mfxU64 m_timeWaitPeriod;
-    // HW 'buffer done' event counter
+    // Some 'waiting' tasks are to be polled after the wait period
+    bool m_bPollWaitingTasks;
+    // Task completion event counter, 'waiting' tasks retry when it changes
     volatile
     mfxU64 m_hwEventCounter;
     // Frequency for vm_tick to get msec
@@ -367,16 +381,9 @@ protected:
     // THREADING STUFF
     //
 
-    // Initialize and start a wake up thread
-    mfxStatus StartWakeUpThread(void);
-    // Stop and terminate the wake up thread
-    mfxStatus StopWakeUpThread(void);
-
     // 'quit' flag for threads
     volatile
     bool m_bQuit;
-    volatile
-    bool m_bQuitWakeUpThread;
 
     // Threads contexts
     MFX_SCHEDULER_THREAD_CONTEXT *m_pThreadCtx;
@@ -386,12 +393,9 @@ protected:
     // Condition variable to wait free task objects
     mfxU16 m_freeTasksCount;
     std::condition_variable m_freeTasks;
-    // Handle to the wakeup thread
-    std::thread m_hwWakeUpThread;
 
     // declare thread working routine
     void ThreadProc(MFX_SCHEDULER_THREAD_CONTEXT *pContext);
-    void WakeupThreadProc();
 
     //
     // TASKING STUFF
@@ -409,6 +413,10 @@ protected:
     mfxU32 m_DedicatedThreadsToWakeUp;
     // Number of tasks for non-dedicated threads
     mfxU32 m_RegularThreadsToWakeUp;
+    // Tasks having a deadline were ever added
+    bool m_bDeadlineTasks;
+    // Deadline statistic of completed tasks
+    MFX_SCHEDULER_DEADLINE_STAT m_deadlineStat;
 
     // these members are used only from the main thread,
     // so synchronization is not necessary to access them.
@@ -440,8 +448,6 @@ protected:
     // Number of job submitted
     mfxU32 m_jobCounter;
 
-    mfxU32 m_timer_hw_event;
-
 
 private:
     // declare a assignment operator to avoid warnings
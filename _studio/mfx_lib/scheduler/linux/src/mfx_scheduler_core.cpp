@@ -31,10 +31,10 @@
 
 mfxSchedulerCore::mfxSchedulerCore(void)
     :  m_currentTimeStamp(0)
-    // since on Linux we have blocking synchronization which means an absence of polling,
-    // there is no need to use 'waiting' time period.
-    , m_timeWaitPeriod(0)
-    , m_hwWakeUpThread()
+    // tasks waiting for hardware are not re-entered within the period,
+    // unless a completion event comes
+    , m_timeWaitPeriod(vm_time_get_frequency() * MFX_THREAD_POLL_PERIOD / 1000000)
+    , m_bPollWaitingTasks(false)
     , m_DedicatedThreadsToWakeUp(0)
     , m_RegularThreadsToWakeUp(0)
 {
@@ -53,6 +53,8 @@ mfxSchedulerCore::mfxSchedulerCore(void)
     memset(m_pTasks, 0, sizeof(m_pTasks));
     memset(m_numAssignedTasks, 0, sizeof(m_numAssignedTasks));
     m_pFailedTasks = NULL;
+    m_bDeadlineTasks = false;
+    memset(&m_deadlineStat, 0, sizeof(m_deadlineStat));
 
     m_pFreeTasks = NULL;
 
@@ -68,8 +70,6 @@ mfxSchedulerCore::mfxSchedulerCore(void)
 
     m_hwEventCounter = 0;
 
-    m_timer_hw_event = MFX_THREAD_TIME_TO_WAIT;
-
     // set number of free tasks
     m_freeTasksCount = MFX_MAX_NUMBER_TASK;
 
@@ -95,13 +95,59 @@ bool mfxSchedulerCore::SetScheduling(std::thread& handle)
     return true;
 }
 
-void mfxSchedulerCore::SetThreadsAffinityToSockets(void)
+bool mfxSchedulerCore::SetThreadsAffinityToSockets(void)
 {
+#if (MFX_VERSION >= MFX_VERSION_NEXT)
+    const mfxExtThreadsParam& params = m_param.params;
+    const mfxU32 maskSize = sizeof(params.CpuMask) / sizeof(params.CpuMask[0]);
+    uint32_t mask[maskSize] = {};
+    bool bCpuMask = false;
+
+    for (mfxU32 i = 0; i < maskSize; i++)
+    {
+        mask[i] = params.CpuMask[i];
+        bCpuMask |= !!mask[i];
+    }
+
+    if (!bCpuMask)
+    {
+        if (!params.NumaNode)
+            return true;
+
+        if (!vm_sys_info_get_numa_node_cpus(params.NumaNode - 1, mask, maskSize))
+            return false;
+    }
+
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+
+    for (mfxU32 cpu = 0; cpu < maskSize * 32 && cpu < CPU_SETSIZE; cpu++)
+    {
+        if (mask[cpu / 32] & (1u << (cpu % 32)))
+            CPU_SET(cpu, &cpuSet);
+    }
+
+    for (mfxU32 i = 0; i < m_param.numberOfThreads; i++)
+    {
+        if (m_pThreadCtx[i].threadHandle.joinable() &&
+            pthread_setaffinity_np(m_pThreadCtx[i].threadHandle.native_handle(), sizeof(cpuSet), &cpuSet))
+        {
+            return false;
+        }
+    }
+#endif
+    return true;
 }
 
 void mfxSchedulerCore::Close(void)
 {
-    StopWakeUpThread();
+    if (m_deadlineStat.numTasks)
+    {
+        MFX_LTRACE_3(MFX_TRACE_LEVEL_SCHED, "^Deadlines^", "missed %llu of %llu, max lateness %llu us",
+                     (unsigned long long)m_deadlineStat.numMissed,
+                     (unsigned long long)m_deadlineStat.numTasks,
+                     (unsigned long long)m_deadlineStat.maxLateness);
+    }
 
     // stop threads
     if (m_pThreadCtx)
@@ -158,6 +204,8 @@ void mfxSchedulerCore::Close(void)
     memset(m_pTasks, 0, sizeof(m_pTasks));
     memset(m_numAssignedTasks, 0, sizeof(m_numAssignedTasks));
     m_pFailedTasks = NULL;
+    m_bDeadlineTasks = false;
+    memset(&m_deadlineStat, 0, sizeof(m_deadlineStat));
 
     m_pFreeTasks = NULL;
 
@@ -201,7 +249,13 @@ void mfxSchedulerCore::Wait(const mfxU32 curThreadNum, std::unique_lock<std::mut
     MFX_SCHEDULER_THREAD_CONTEXT* thctx = GetThreadCtx(curThreadNum);
 
     if (thctx) {
-        thctx->taskAdded.wait(mutex);
+        if (m_bPollWaitingTasks) {
+            // poll tasks waiting for hardware after the period,
+            // completion events wake the thread up earlier
+            thctx->taskAdded.wait_for(mutex, std::chrono::microseconds(MFX_THREAD_POLL_PERIOD));
+        } else {
+            thctx->taskAdded.wait(mutex);
+        }
     }
 }
 
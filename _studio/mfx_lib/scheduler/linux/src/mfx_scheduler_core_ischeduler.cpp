@@ -120,7 +120,9 @@ mfxStatus mfxSchedulerCore::Initialize2(const MFX_SCHEDULER_PARAM2 *pParam)
         }
 
 
-        SetThreadsAffinityToSockets();
+        if (!SetThreadsAffinityToSockets()) {
+            return MFX_ERR_UNSUPPORTED;
+        }
     }
     else
     {
@@ -192,7 +194,12 @@ mfxStatus mfxSchedulerCore::Synchronize(mfxTaskHandle handle, mfxU32 timeToWait)
             task_sts = GetTask(call, previousTaskHandle, 0);
 
             if (task_sts != MFX_ERR_NONE)
+            {
+                // all tasks wait for hardware, poll them after the period
+                if (m_bPollWaitingTasks)
+                    pTask->done.wait_for(guard, std::chrono::microseconds(MFX_THREAD_POLL_PERIOD));
                 continue;
+            }
 
             guard.unlock();
 
@@ -210,11 +217,6 @@ mfxStatus mfxSchedulerCore::Synchronize(mfxTaskHandle handle, mfxU32 timeToWait)
 
             if ((mfxU32)((GetHighPerformanceCounter() - start)/frequency) > timeToWait)
                 break;
-
-            if (MFX_TASK_DONE!= call.res)
-            {
-                IncrementHWEventCounter();
-            }
         }
         //
         // inspect the task
@@ -276,6 +278,21 @@ mfxStatus mfxSchedulerCore::GetTimeout(mfxU32& maxTimeToRun)
     return MFX_ERR_UNSUPPORTED;
 }
 
+mfxStatus mfxSchedulerCore::GetDeadlineStat(MFX_SCHEDULER_DEADLINE_STAT *pStat)
+{
+    if (NULL == pStat)
+    {
+        return MFX_ERR_NULL_PTR;
+    }
+
+    std::lock_guard<std::mutex> guard(m_guard);
+
+    *pStat = m_deadlineStat;
+
+    return MFX_ERR_NONE;
+
+} // mfxStatus mfxSchedulerCore::GetDeadlineStat(MFX_SCHEDULER_DEADLINE_STAT *pStat)
+
 mfxStatus mfxSchedulerCore::WaitForDependencyResolved(const void *pDependency)
 {
     mfxTaskHandle waitHandle = {};
@@ -388,11 +405,11 @@ mfxStatus mfxSchedulerCore::WaitForAllTasksCompletion(const void *pOwner)
 
 mfxStatus mfxSchedulerCore::ResetWaitingStatus(const void *pOwner)
 {
+    std::lock_guard<std::mutex> guard(m_guard);
+
     // reset 'waiting' tasks belong to the given state
     ResetWaitingTasks(pOwner);
 
-    std::lock_guard<std::mutex> guard(m_guard);
-
     // wake up sleeping threads
     WakeUpThreads();
 
@@ -472,18 +489,11 @@ mfxStatus mfxSchedulerCore::AdjustPerformance(const mfxSchedulerMessage message)
     case MFX_SCHEDULER_RESET_TO_DEFAULTS:
         break;
 
+    // threads are woken up by task completion events and poll tasks
+    // waiting for hardware only while there are such tasks,
+    // so there is no listener to start or stop
     case MFX_SCHEDULER_START_HW_LISTENING:
-        if (m_param.flags != MFX_SINGLE_THREAD)
-        {
-            mfxRes = StartWakeUpThread();
-        }
-        break;
-
     case MFX_SCHEDULER_STOP_HW_LISTENING:
-        if (m_param.flags != MFX_SINGLE_THREAD)
-        {
-            mfxRes = StopWakeUpThread();
-        }
         break;
 
         // unknown message
@@ -618,6 +628,8 @@ mfxStatus mfxSchedulerCore::AddTask(const MFX_TASK &task, mfxSyncPoint *pSyncPoi
 
         // add the task to the end of the corresponding queue
         *ppTemp = pTask;
+        // real-time tasks are looked up by the deadline from now on
+        m_bDeadlineTasks |= (0 != task.deadline);
 
         // reset all 'waiting' tasks to prevent freezing
         // so called 'permanent' tasks.
@@ -24,6 +24,8 @@
 
 #include <vm_time.h>
 
+#include <algorithm>
+
 // declare the static section of the file
 namespace
 {
@@ -127,12 +129,27 @@ mfxStatus mfxSchedulerCore::GetTask(MFX_CALL_INFO &callInfo,
     // get the current time stamp
     m_currentTimeStamp = GetHighPerformanceCounter();
 
+    // IsReadyToRun raises the flag again, if a 'waiting' task is still there
+    m_bPollWaitingTasks = false;
+
     // get time spent statistic
     GetTimeStat(timeSpent, totalTimeSpent);
 
     // get the priority of the previous task
     prevTaskPriority = GetTaskPriority(previousTask);
 
+    // real-time tasks go ahead of any priority. Threads come here between
+    // calls, so a task with an earlier deadline preempts the previous task
+    // at the call boundary.
+    if (m_bDeadlineTasks)
+    {
+        mfxStatus mfxRes = GetDeadlineTask(callInfo, threadNum);
+        if (MFX_ERR_NONE == mfxRes)
+        {
+            return mfxRes;
+        }
+    }
+
     // there are three runs over the tasks lists. On the 1st run,
     // the scheduler keeping workload balance, which is described by
     // the TaskPriorityRatio table. On the 2nd run, the scheduler chooses
@@ -207,6 +224,50 @@ mfxStatus mfxSchedulerCore::GetTask(MFX_CALL_INFO &callInfo,
 
 } // mfxStatus mfxSchedulerCore::GetTask(MFX_CALL_INFO &callInfo,
 
+mfxStatus mfxSchedulerCore::GetDeadlineTask(MFX_CALL_INFO &callInfo,
+                                            const mfxU32 threadNum)
+{
+    MFX_SCHEDULER_TASK *pBest = nullptr;
+    int priority, type;
+
+    //
+    // THE EXECUTION IS ALREADY IN SECURE SECTION.
+    // Just do what need to do.
+    //
+
+    for (priority = MFX_PRIORITY_HIGH;
+         priority >= MFX_PRIORITY_LOW;
+         priority -= 1)
+    {
+        for (type = (threadNum) ? (MFX_TYPE_SOFTWARE) : (MFX_TYPE_HARDWARE);
+             type <= MFX_TYPE_SOFTWARE;
+             type += 1)
+        {
+            MFX_SCHEDULER_TASK *pTask = m_pTasks[priority][type];
+
+            for (; pTask; pTask = pTask->pNext)
+            {
+                const mfxU64 deadline = pTask->param.task.deadline;
+
+                if (deadline &&
+                    (nullptr == pBest || deadline < pBest->param.task.deadline) &&
+                    IsReadyToRun(pTask))
+                {
+                    pBest = pTask;
+                }
+            }
+        }
+    }
+
+    if (nullptr == pBest)
+    {
+        return MFX_ERR_NOT_FOUND;
+    }
+
+    return WrapUpTask(callInfo, pBest, threadNum);
+
+} // mfxStatus mfxSchedulerCore::GetDeadlineTask(MFX_CALL_INFO &callInfo,
+
 mfxStatus mfxSchedulerCore::CanContinuePreviousTask(MFX_CALL_INFO &callInfo,
                                                     mfxTaskHandle previousTask,
                                                     const mfxU32 threadNum)
@@ -299,6 +360,7 @@ bool mfxSchedulerCore::IsReadyToRun(MFX_SCHEDULER_TASK *pTask)
                 const mfxU64 hwCounter = GetHWEventCounter();
 
                 if (hwCounter == pTask->param.timing.hwCounterLastEnter) {
+                    m_bPollWaitingTasks = true;
                     return false;
                 }
             }
@@ -556,6 +618,21 @@ void mfxSchedulerCore::MarkTaskCompleted(const MFX_CALL_INFO *pCallInfo,
             mfxU32 i;
 
 
+            // account the real-time task
+            if (pTask->param.task.deadline)
+            {
+                const mfxU64 now = GetHighPerformanceCounter();
+
+                m_deadlineStat.numTasks += 1;
+                if (now > pTask->param.task.deadline)
+                {
+                    const mfxU64 lateness = (now - pTask->param.task.deadline) * 1000000 / vm_time_get_frequency();
+
+                    m_deadlineStat.numMissed += 1;
+                    m_deadlineStat.maxLateness = std::max(m_deadlineStat.maxLateness, lateness);
+                }
+            }
+
             // reset jobID to avoid false waiting on complete tasks, which were reused
             pTask->jobID = 0;
             // save the status
@@ -582,6 +659,20 @@ void mfxSchedulerCore::MarkTaskCompleted(const MFX_CALL_INFO *pCallInfo,
             // task object becomes free
             taskReleased = true;
         }
+
+        // completion of any task (successful or not) is the event, which lets
+        // 'waiting' tasks retry before the poll period. Tasks waiting for
+        // other tasks (free VPP regions, slices of the neighbour thread) get
+        // it right away, only tasks polling hardware status wait for the period.
+        if (isFailed(pTask->curStatus) || (MFX_TASK_DONE == pTask->curStatus))
+        {
+            IncrementHWEventCounter();
+            if (m_bPollWaitingTasks)
+            {
+                m_DedicatedThreadsToWakeUp += 1;
+                m_RegularThreadsToWakeUp += 1;
+            }
+        }
     }
 
 
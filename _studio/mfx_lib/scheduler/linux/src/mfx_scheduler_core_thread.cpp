@@ -26,28 +26,6 @@
 #include <vm_time.h>
 
 
-mfxStatus mfxSchedulerCore::StartWakeUpThread(void)
-{
-    // stop the thread before creating it again
-    // don't try to check thread status, it might lead to interesting effects.
-    if (m_hwWakeUpThread.joinable())
-        StopWakeUpThread();
-
-    m_timer_hw_event = MFX_THREAD_TIME_TO_WAIT;
-
-
-
-    return MFX_ERR_NONE;
-
-} // mfxStatus mfxSchedulerCore::StartWakeUpThread(void)
-
-mfxStatus mfxSchedulerCore::StopWakeUpThread(void)
-{
-
-    return MFX_ERR_NONE;
-
-} // mfxStatus mfxSchedulerCore::StopWakeUpThread(void)
-
 void mfxSchedulerCore::ThreadProc(MFX_SCHEDULER_THREAD_CONTEXT *pContext)
 {
     std::unique_lock<std::mutex> guard(m_guard);
@@ -74,6 +52,12 @@ void mfxSchedulerCore::ThreadProc(MFX_SCHEDULER_THREAD_CONTEXT *pContext)
         if (MFX_ERR_NONE == mfxRes)
         {
             pContext->state = MFX_SCHEDULER_THREAD_CONTEXT::Running;
+            // the thread leaves 'waiting' tasks it has passed by,
+            // hand their polling over to a sleeping thread
+            if (m_bPollWaitingTasks)
+            {
+                WakeUpThreads(0, 1);
+            }
             guard.unlock();
             {
                 // perform asynchronous operation
@@ -111,22 +95,3 @@ void mfxSchedulerCore::ThreadProc(MFX_SCHEDULER_THREAD_CONTEXT *pContext)
         }
     }
 }
-
-void mfxSchedulerCore::WakeupThreadProc()
-{
-    {
-        const char thread_name[30] = "ThreadName=MSDKHWL#0";
-        (void)thread_name;
-        MFX_AUTO_LTRACE(MFX_TRACE_LEVEL_SCHED, thread_name);
-    }
-
-    // main working cycle for threads
-    while (false == m_bQuitWakeUpThread)
-    {
-        IncrementHWEventCounter();
-        {
-            std::lock_guard<std::mutex> guard(m_guard);
-            WakeUpThreads(1,1);
-        }
-    }
-}
@@ -832,6 +832,20 @@ namespace MfxHwH264Encode
         MFX_ENCODE_CAPS const & hwCaps,
         mfxVideoParam const * parResetIn = 0);
 
+    // groups of parameters compared by GetChangedResetGroups
+    enum
+    {
+        RESET_GROUP_CONTROL = 0x1, // mfxExtEncoderResetOption, takes no part in parameter checks
+        RESET_GROUP_RATE    = 0x2, // bitrate, HRD buffer size and initial delay
+        RESET_GROUP_HEADERS = 0x4, // internal SPS/PPS
+        RESET_GROUP_OTHER   = 0x8  // everything else
+    };
+
+    // returns mask of RESET_GROUP_* which values differ between prev and next
+    mfxU32 GetChangedResetGroups(
+        MfxVideoParam const & prev,
+        MfxVideoParam const & next);
+
     mfxStatus CheckPayloads(
         mfxPayload const * const * payload,
         mfxU16                     numPayload);
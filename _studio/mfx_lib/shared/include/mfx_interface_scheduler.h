@@ -129,6 +129,16 @@ struct MFX_SCHEDULER_PARAM2: public MFX_SCHEDULER_PARAM
     mfxExtThreadsParam params;
 };
 
+struct MFX_SCHEDULER_DEADLINE_STAT
+{
+    // Number of completed tasks having a deadline
+    mfxU64 numTasks;
+    // Number of tasks completed after the deadline
+    mfxU64 numMissed;
+    // The worst lateness of a task in microseconds
+    mfxU64 maxLateness;
+};
+
 class MFXIScheduler2 : public MFXIScheduler
 {
 public:
@@ -140,6 +150,10 @@ public:
 
     virtual
     mfxStatus GetTimeout(mfxU32 & maxTimeToRun) = 0;
+
+    // Get statistic of the real-time (earliest deadline first) tasks
+    virtual
+    mfxStatus GetDeadlineStat(MFX_SCHEDULER_DEADLINE_STAT *pStat) = 0;
 };
 
 #endif // __MFX_INTERFACE_SCHEDULER_H
@@ -204,6 +204,13 @@ public:
 
 MFXIPtr<MFXISession_1_10> TryGetSession_1_10(mfxSession session);
 
+// Deadline of a task processing the frame with given time stamp,
+// 0 if tasks of the session have no deadlines
+mfxU64 GetTaskDeadline(mfxSession session, mfxU64 timeStamp);
+
+// Deadline statistic of the scheduler, common for all sessions joined together
+MFX_SCHEDULER_DEADLINE_STAT GetDeadlineStat(mfxSession session);
+
 class _mfxSession_1_10: public _mfxSession, public MFXISession_1_10
 {
 public:
@@ -272,6 +279,33 @@ mfxStatus MFXVideo##component##_##func_name formal_param_list \
     } \
 }
 
+#undef FUNCTION_STAT_IMPL
+#if (MFX_VERSION >= MFX_VERSION_NEXT)
+#define FUNCTION_STAT_IMPL(component, func_name, formal_param_list, actual_param_list) \
+mfxStatus MFXVideo##component##_##func_name formal_param_list \
+{ \
+    MFX_CHECK(session, MFX_ERR_INVALID_HANDLE); \
+    MFX_CHECK(session->m_p##component.get(), MFX_ERR_NOT_INITIALIZED); \
+    try { \
+        /* call the codec's method */ \
+        mfxStatus mfxRes = session->m_p##component->func_name actual_param_list; \
+        if (mfxRes >= MFX_ERR_NONE && stat) \
+        { \
+            /* deadlines are tracked by the scheduler, not by the component */ \
+            const MFX_SCHEDULER_DEADLINE_STAT deadlineStat = GetDeadlineStat(session); \
+            stat->NumDeadlineTask     = deadlineStat.numTasks; \
+            stat->NumMissedDeadline   = deadlineStat.numMissed; \
+            stat->MaxDeadlineLateness = deadlineStat.maxLateness; \
+        } \
+        return mfxRes; \
+    } catch(...) { \
+        return MFX_ERR_NULL_PTR; \
+    } \
+}
+#else
+#define FUNCTION_STAT_IMPL FUNCTION_IMPL
+#endif
+
 #undef FUNCTION_AUDIO_IMPL
 #define FUNCTION_AUDIO_IMPL(component, func_name, formal_param_list, actual_param_list) \
     mfxStatus MFXAudio##component##_##func_name formal_param_list \
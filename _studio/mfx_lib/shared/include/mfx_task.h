@@ -127,6 +127,10 @@ struct MFX_TASK
 
     // Task's priority
     mfxPriority priority;
+    // Absolute deadline of the task in vm_time ticks. Tasks having a deadline
+    // form the real-time class, which is served earliest deadline first
+    // ahead of all priorities. Zero means no deadline.
+    mfxU64 deadline;
     // how the object processes the tasks
     mfxTaskThreadingPolicy threadingPolicy;
 
@@ -544,6 +544,7 @@ mfxStatus MFXVideoDECODE_DecodeFrameAsync(mfxSession session, mfxBitstream *bs,
 
             task.pOwner = session->m_pDECODE.get();
             task.priority = session->m_priority;
+            task.deadline = GetTaskDeadline(session, bs ? bs->TimeStamp : MFX_TIME_STAMP_INVALID);
             task.threadingPolicy = session->m_pDECODE->GetThreadingPolicy();
             // fill dependencies
             task.pSrc[0] = *surface_out;
@@ -616,6 +617,6 @@ mfxStatus MFXVideoDECODE_DecodeFrameAsync(mfxSession session, mfxBitstream *bs,
 FUNCTION_RESET_IMPL(DECODE, Reset, (mfxSession session, mfxVideoParam *par), (par))
 
 FUNCTION_IMPL(DECODE, GetVideoParam, (mfxSession session, mfxVideoParam *par), (par))
-FUNCTION_IMPL(DECODE, GetDecodeStat, (mfxSession session, mfxDecodeStat *stat), (stat))
+FUNCTION_STAT_IMPL(DECODE, GetDecodeStat, (mfxSession session, mfxDecodeStat *stat), (stat))
 FUNCTION_IMPL(DECODE, SetSkipMode, (mfxSession session, mfxSkipMode mode), (mode))
 FUNCTION_IMPL(DECODE, GetPayload, (mfxSession session, mfxU64 *ts, mfxPayload *payload), (ts, payload))
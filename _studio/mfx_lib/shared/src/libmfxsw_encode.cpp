@@ -844,6 +844,9 @@ mfxStatus MFXVideoENCODE_EncodeFrameAsync(mfxSession session, mfxEncodeCtrl *ctr
             ((mfxStatus)MFX_ERR_MORE_DATA_SUBMIT_TASK == mfxRes) ||
             (MFX_ERR_MORE_BITSTREAM == mfxRes))
         {
+            const mfxFrameSurface1 *deadlineSurface = reordered_surface ? reordered_surface : surface;
+            const mfxU64 deadline = GetTaskDeadline(session, deadlineSurface ? deadlineSurface->Data.TimeStamp : MFX_TIME_STAMP_INVALID);
+
             // prepare the obsolete kind of task.
             // it is obsolete and must be removed.
             if (NULL == entryPoints[0].pRoutine)
@@ -867,6 +870,7 @@ mfxStatus MFXVideoENCODE_EncodeFrameAsync(mfxSession session, mfxEncodeCtrl *ctr
                 // END OF OBSOLETE PART
 
                 task.priority = session->m_priority;
+                task.deadline = deadline;
                 task.threadingPolicy = session->m_pENCODE->GetThreadingPolicy();
                 // fill dependencies
                 task.pSrc[0] = surface;
@@ -891,6 +895,7 @@ mfxStatus MFXVideoENCODE_EncodeFrameAsync(mfxSession session, mfxEncodeCtrl *ctr
                 task.pOwner = session->m_pENCODE.get();
                 task.entryPoint = entryPoints[0];
                 task.priority = session->m_priority;
+                task.deadline = deadline;
                 task.threadingPolicy = session->m_pENCODE->GetThreadingPolicy();
                 // fill dependencies
                 task.pSrc[0] = surface;
@@ -914,6 +919,7 @@ mfxStatus MFXVideoENCODE_EncodeFrameAsync(mfxSession session, mfxEncodeCtrl *ctr
                 task.pOwner = session->m_pENCODE.get();
                 task.entryPoint = entryPoints[0];
                 task.priority = session->m_priority;
+                task.deadline = deadline;
                 task.threadingPolicy = session->m_pENCODE->GetThreadingPolicy();
                 // fill dependencies
                 task.pSrc[0] = surface;
@@ -931,6 +937,7 @@ mfxStatus MFXVideoENCODE_EncodeFrameAsync(mfxSession session, mfxEncodeCtrl *ctr
                 task.pOwner = session->m_pENCODE.get();
                 task.entryPoint = entryPoints[1];
                 task.priority = session->m_priority;
+                task.deadline = deadline;
                 task.threadingPolicy = session->m_pENCODE->GetThreadingPolicy();
                 // fill dependencies
                 task.pSrc[0] = entryPoints[0].pParam;
@@ -978,4 +985,4 @@ mfxStatus MFXVideoENCODE_EncodeFrameAsync(mfxSession session, mfxEncodeCtrl *ctr
 
 FUNCTION_RESET_IMPL(ENCODE, Reset, (mfxSession session, mfxVideoParam *par), (par))
 FUNCTION_IMPL(ENCODE, GetVideoParam, (mfxSession session, mfxVideoParam *par), (par))
-FUNCTION_IMPL(ENCODE, GetEncodeStat, (mfxSession session, mfxEncodeStat *stat), (stat))
+FUNCTION_STAT_IMPL(ENCODE, GetEncodeStat, (mfxSession session, mfxEncodeStat *stat), (stat))
@@ -278,6 +278,7 @@ mfxStatus MFXVideoVPP_RunFrameVPPAsync(mfxSession session, mfxFrameSurface1 *in,
 
               task.pOwner = session->m_plgVPP.get();
               task.priority = session->m_priority;
+              task.deadline = GetTaskDeadline(session, in ? in->Data.TimeStamp : MFX_TIME_STAMP_INVALID);
               task.threadingPolicy = session->m_plgVPP->GetThreadingPolicy();
               // fill dependencies
               task.pSrc[0] = in;
@@ -314,6 +315,8 @@ mfxStatus MFXVideoVPP_RunFrameVPPAsync(mfxSession session, mfxFrameSurface1 *in,
             (MFX_ERR_MORE_SURFACE == mfxRes) ||
             (MFX_WRN_INCOMPATIBLE_VIDEO_PARAM == mfxRes))
         {
+            const mfxU64 deadline = GetTaskDeadline(session, in ? in->Data.TimeStamp : MFX_TIME_STAMP_INVALID);
+
             // prepare the absolete kind of task.
             // it is absolete and must be removed.
             if (NULL == entryPoints[0].pRoutine)
@@ -336,6 +339,7 @@ mfxStatus MFXVideoVPP_RunFrameVPPAsync(mfxSession session, mfxFrameSurface1 *in,
                 // END OF OBSOLETE PART
 
                 task.priority = session->m_priority;
+                task.deadline = deadline;
                 task.threadingPolicy = session->m_pVPP->GetThreadingPolicy();
                 // fill dependencies
                 task.pSrc[0] = in;
@@ -360,6 +364,7 @@ mfxStatus MFXVideoVPP_RunFrameVPPAsync(mfxSession session, mfxFrameSurface1 *in,
                 task.pOwner = session->m_pVPP.get();
                 task.entryPoint = entryPoints[0];
                 task.priority = session->m_priority;
+                task.deadline = deadline;
                 task.threadingPolicy = session->m_pVPP->GetThreadingPolicy();
                 // fill dependencies
                 task.pSrc[0] = in;
@@ -383,6 +388,7 @@ mfxStatus MFXVideoVPP_RunFrameVPPAsync(mfxSession session, mfxFrameSurface1 *in,
                 task.pOwner = session->m_pVPP.get();
                 task.entryPoint = entryPoints[0];
                 task.priority = session->m_priority;
+                task.deadline = deadline;
                 task.threadingPolicy = session->m_pVPP->GetThreadingPolicy();
                 // fill dependencies
                 task.pSrc[0] = in;
@@ -400,6 +406,7 @@ mfxStatus MFXVideoVPP_RunFrameVPPAsync(mfxSession session, mfxFrameSurface1 *in,
                 task.pOwner = session->m_pVPP.get();
                 task.entryPoint = entryPoints[1];
                 task.priority = session->m_priority;
+                task.deadline = deadline;
                 task.threadingPolicy = session->m_pVPP->GetThreadingPolicy();
 
                 // fill dependencies
@@ -485,6 +492,7 @@ mfxStatus MFXVideoVPP_RunFrameVPPAsyncEx(mfxSession session, mfxFrameSurface1 *i
 
               task.pOwner = session->m_plgVPP.get();
               task.priority = session->m_priority;
+              task.deadline = GetTaskDeadline(session, in ? in->Data.TimeStamp : MFX_TIME_STAMP_INVALID);
               task.threadingPolicy = session->m_plgVPP->GetThreadingPolicy();
               // fill dependencies
               task.pSrc[0] = in;
@@ -540,4 +548,4 @@ mfxStatus MFXVideoVPP_RunFrameVPPAsyncEx(mfxSession session, mfxFrameSurface1 *i
 FUNCTION_RESET_IMPL(VPP, Reset, (mfxSession session, mfxVideoParam *par), (par))
 
 FUNCTION_IMPL(VPP, GetVideoParam, (mfxSession session, mfxVideoParam *par), (par))
-FUNCTION_IMPL(VPP, GetVPPStat, (mfxSession session, mfxVPPStat *stat), (stat))
+FUNCTION_STAT_IMPL(VPP, GetVPPStat, (mfxSession session, mfxVPPStat *stat), (stat))
@@ -5491,6 +5491,110 @@ void MfxHwH264Encode::InheritDefaultValues(
     // InheritOption(parInit.mfx.FrameInfo.ChromaFormat,   parReset.mfx.FrameInfo.ChromaFormat);
 }
 
+mfxU32 MfxHwH264Encode::GetChangedResetGroups(
+    MfxVideoParam const & prev,
+    MfxVideoParam const & next)
+{
+    mfxU32 changed = 0;
+
+    // rate control fields of mfxInfoMFX and their calculable copies
+    mfxVideoParam prevVideo = prev;
+    mfxVideoParam nextVideo = next;
+    MfxVideoParam::CalculableParam prevCalc = prev.calcParam;
+    MfxVideoParam::CalculableParam nextCalc = next.calcParam;
+
+    if (prevVideo.mfx.InitialDelayInKB   != nextVideo.mfx.InitialDelayInKB   ||
+        prevVideo.mfx.TargetKbps         != nextVideo.mfx.TargetKbps         ||
+        prevVideo.mfx.MaxKbps            != nextVideo.mfx.MaxKbps            ||
+        prevVideo.mfx.BufferSizeInKB     != nextVideo.mfx.BufferSizeInKB     ||
+        prevVideo.mfx.BRCParamMultiplier != nextVideo.mfx.BRCParamMultiplier ||
+        prevCalc.bufferSizeInKB          != nextCalc.bufferSizeInKB          ||
+        prevCalc.initialDelayInKB        != nextCalc.initialDelayInKB        ||
+        prevCalc.targetKbps              != nextCalc.targetKbps              ||
+        prevCalc.maxKbps                 != nextCalc.maxKbps                 ||
+        prevCalc.WinBRCMaxAvgKbps        != nextCalc.WinBRCMaxAvgKbps        ||
+        prevCalc.TCBRCTargetFrameSize    != nextCalc.TCBRCTargetFrameSize    ||
+        !Equal(prevCalc.decorativeHrdParam, nextCalc.decorativeHrdParam))
+        changed |= RESET_GROUP_RATE;
+
+    for (mfxVideoParam * video : { &prevVideo, &nextVideo })
+    {
+        video->ExtParam              = 0;
+        video->NumExtParam           = 0;
+        video->mfx.InitialDelayInKB   = 0;
+        video->mfx.TargetKbps         = 0;
+        video->mfx.MaxKbps            = 0;
+        video->mfx.BufferSizeInKB     = 0;
+        video->mfx.BRCParamMultiplier = 0;
+    }
+    for (MfxVideoParam::CalculableParam * calc : { &prevCalc, &nextCalc })
+    {
+        calc->bufferSizeInKB       = 0;
+        calc->initialDelayInKB     = 0;
+        calc->targetKbps           = 0;
+        calc->maxKbps              = 0;
+        calc->WinBRCMaxAvgKbps     = 0;
+        calc->TCBRCTargetFrameSize = 0;
+        Zero(calc->decorativeHrdParam);
+    }
+
+    if (!Equal(prevVideo, nextVideo) || !Equal(prevCalc, nextCalc))
+        changed |= RESET_GROUP_OTHER;
+
+    // both sets are built by MfxVideoParam::Construct, so buffers go in the same order
+    if (prev.NumExtParam != next.NumExtParam)
+        return changed | RESET_GROUP_HEADERS | RESET_GROUP_OTHER;
+
+    for (mfxU32 i = 0; i < prev.NumExtParam; i++)
+    {
+        mfxExtBuffer const * prevBuf = prev.ExtParam[i];
+        mfxExtBuffer const * nextBuf = next.ExtParam[i];
+
+        mfxU32 group;
+        switch (prevBuf->BufferId)
+        {
+        case MFX_EXTBUFF_ENCODER_RESET_OPTION:
+            group = RESET_GROUP_CONTROL;
+            break;
+        case MFX_EXTBUFF_SPS_HEADER:
+        case MFX_EXTBUFF_PPS_HEADER:
+            group = RESET_GROUP_HEADERS;
+            break;
+        default:
+            group = RESET_GROUP_OTHER;
+            break;
+        }
+
+        if (changed & group)
+            continue;
+
+        if (prevBuf->BufferId != nextBuf->BufferId || prevBuf->BufferSz != nextBuf->BufferSz)
+        {
+            changed |= group;
+            continue;
+        }
+
+        if (prevBuf->BufferId == MFX_EXTBUFF_CODING_OPTION_SPSPPS)
+        {
+            // headers in application memory may be rewritten behind the same pointers
+            mfxExtCodingOptionSPSPPS const & prevBits = *(mfxExtCodingOptionSPSPPS const *)prevBuf;
+            mfxExtCodingOptionSPSPPS const & nextBits = *(mfxExtCodingOptionSPSPPS const *)nextBuf;
+            if (prevBits.SPSBuffer || prevBits.PPSBuffer || nextBits.SPSBuffer || nextBits.PPSBuffer)
+            {
+                changed |= group;
+                continue;
+            }
+        }
+
+        if (prevBuf->BufferId == MFX_EXTBUFF_SPS_HEADER
+            ? !Equal(*(mfxExtSpsHeader const *)prevBuf, *(mfxExtSpsHeader const *)nextBuf)
+            : memcmp(prevBuf, nextBuf, prevBuf->BufferSz) != 0)
+            changed |= group;
+    }
+
+    return changed;
+}
+
 
 namespace
 {
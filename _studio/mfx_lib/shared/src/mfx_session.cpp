@@ -452,6 +452,24 @@ void InitCoreInterface(mfxCoreInterface *pCoreInterface,
 
 } // void InitCoreInterface(mfxCoreInterface *pCoreInterface,
 
+#if (MFX_VERSION >= MFX_VERSION_NEXT)
+// NUMA node of the threads bound by mfxExtThreadsParam, -1 if threads are not bound
+mfxI32 GetThreadsNumaNode(const mfxExtThreadsParam &params)
+{
+    const mfxU32 maskSize = sizeof(params.CpuMask) / sizeof(params.CpuMask[0]);
+
+    // memory follows the first CPU of the set
+    for (mfxU32 cpu = 0; cpu < maskSize * 32; cpu++)
+    {
+        if (params.CpuMask[cpu / 32] & (1u << (cpu % 32)))
+            return vm_sys_info_get_cpu_numa_node(cpu);
+    }
+
+    return params.NumaNode ? params.NumaNode - 1 : -1;
+
+} // mfxI32 GetThreadsNumaNode(const mfxExtThreadsParam &params)
+#endif
+
 } // namespace
 
 
@@ -477,6 +495,37 @@ MFXIPtr<MFXISession_1_10> TryGetSession_1_10(mfxSession session)
     return MFXIPtr<MFXISession_1_10>( newPtr->QueryInterface(MFXISession_1_10_GUID) );
 }
 
+mfxU64 GetTaskDeadline(mfxSession session, mfxU64 timeStamp)
+{
+    CommonCORE *pCore = (CommonCORE *)session->m_pCORE->QueryCoreInterface(MFXIVideoCORE_GUID);
+
+    return pCore ? pCore->GetTaskDeadline(timeStamp) : 0;
+
+} // mfxU64 GetTaskDeadline(mfxSession session, mfxU64 timeStamp)
+
+MFX_SCHEDULER_DEADLINE_STAT GetDeadlineStat(mfxSession session)
+{
+    MFX_SCHEDULER_DEADLINE_STAT stat = {};
+
+    // QueryInterface() would create a new scheduler for NULL
+    if (!session->m_pScheduler)
+    {
+        return stat;
+    }
+
+    MFXIUnknown * pInt = session->m_pScheduler;
+    MFXIScheduler2 *pScheduler2 = ::QueryInterface<MFXIScheduler2>(pInt, MFXIScheduler2_GUID);
+
+    if (pScheduler2)
+    {
+        pScheduler2->GetDeadlineStat(&stat);
+        pScheduler2->Release();
+    }
+
+    return stat;
+
+} // MFX_SCHEDULER_DEADLINE_STAT GetDeadlineStat(mfxSession session)
+
 //////////////////////////////////////////////////////////////////////////
 //  _mfxSession members
 //////////////////////////////////////////////////////////////////////////
@@ -901,6 +950,22 @@ mfxStatus _mfxSession_1_10::InitEx(mfxInitParam& par)
         return mfxRes;
     }
 
+#if (MFX_VERSION >= MFX_VERSION_NEXT)
+    if (par.NumExtParam)
+    {
+        // place internal system memory surfaces next to the bound threads
+        // and enable the real-time scheduling class
+        CommonCORE *pCore = (CommonCORE *)m_pCORE->QueryCoreInterface(MFXIVideoCORE_GUID);
+        if (pCore)
+        {
+            const mfxExtThreadsParam &threadsParam = *(mfxExtThreadsParam*)par.ExtParam[0];
+
+            pCore->SetNumaNode(GetThreadsNumaNode(threadsParam));
+            pCore->SetFrameDeadline(threadsParam.FrameDeadline);
+        }
+    }
+#endif
+
     m_pOperatorCore = new OperatorCORE(m_pCORE.get());
 
     if (MFX_PLATFORM_SOFTWARE == m_currentPlatform && MFX_GPUCOPY_ON == par.GPUCopy)
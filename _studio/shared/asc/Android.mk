@@ -32,6 +32,33 @@ include $(BUILD_STATIC_LIBRARY)
 include $(CLEAR_VARS)
 include $(MFX_HOME)/android/mfx_defs.mk
 
+LOCAL_SRC_FILES := $(addprefix src/, asc_avx512_impl.cpp)
+
+LOCAL_C_INCLUDES := \
+    $(MFX_INCLUDES_INTERNAL_HW) \
+    $(MFX_HOME)/_studio/mfx_lib/cmrt_cross_platform/include \
+    $(MFX_HOME)/_studio/mfx_lib/genx/asc/isa
+
+LOCAL_CFLAGS := \
+    $(MFX_CFLAGS_INTERNAL_HW) \
+    -mavx512f -mavx512bw \
+    -Wall -Werror
+LOCAL_CFLAGS += -I $(MFX_HOME)/_studio/shared/asc/include/
+
+LOCAL_CFLAGS_32 := $(MFX_CFLAGS_INTERNAL_32)
+LOCAL_CFLAGS_64 := $(MFX_CFLAGS_INTERNAL_64)
+
+LOCAL_HEADER_LIBRARIES := libmfx_headers
+
+LOCAL_MODULE_TAGS := optional
+LOCAL_MODULE := libasc_avx512
+include $(BUILD_STATIC_LIBRARY)
+
+# =============================================================================
+
+include $(CLEAR_VARS)
+include $(MFX_HOME)/android/mfx_defs.mk
+
 LOCAL_SRC_FILES := $(addprefix src/, asc_sse4_impl.cpp)
 
 LOCAL_C_INCLUDES := \
@@ -74,6 +101,7 @@ LOCAL_C_INCLUDES := \
 
 LOCAL_STATIC_LIBRARIES := \
 	libasc_avx2 \
+	libasc_avx512 \
 	libasc_sse4
 
 LOCAL_CFLAGS := \
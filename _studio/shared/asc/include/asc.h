@@ -178,6 +178,7 @@ private:
     std::map<void *, CmSurface2D *> m_tableCmRelations2;
     std::map<CmSurface2D *, SurfaceIndex *> m_tableCmIndex2;
 
+    int m_AVX512_available;
     int m_AVX2_available;
     int m_SSE4_available;
     t_GainOffset               GainOffset;
@@ -37,6 +37,10 @@ static inline mfxI32 CpuFeature_AVX2() {
     return((__builtin_cpu_supports("avx2")));
 }
 
+static inline mfxI32 CpuFeature_AVX512() {
+    return((__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")));
+}
+
 //
 // end Dispatcher
 //
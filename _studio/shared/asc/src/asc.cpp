@@ -218,6 +218,7 @@ ASC_API ASC::ASC()
     m_height = 0;
     m_pitch = 0;
 
+    m_AVX512_available = 0;
     m_AVX2_available = 0;
     m_SSE4_available = 0;
     GainOffset              = nullptr;
@@ -668,6 +669,10 @@ mfxStatus ASC::SetDimensions(mfxI32 Width, mfxI32 Height, mfxI32 Pitch) {
 #define ASC_CPU_DISP_INIT_AVX2_SSE4_C(func) (m_AVX2_available ? ASC_CPU_DISP_INIT_AVX2(func) : ASC_CPU_DISP_INIT_SSE4_C(func))
 #define ASC_CPU_DISP_INIT_AVX2_C(func)      (m_AVX2_available ? ASC_CPU_DISP_INIT_AVX2(func) : ASC_CPU_DISP_INIT_C(func))
 
+#define ASC_CPU_DISP_INIT_AVX512(func)              (func = (func ## _AVX512))
+#define ASC_CPU_DISP_INIT_AVX512_SSE4_C(func)       (m_AVX512_available ? ASC_CPU_DISP_INIT_AVX512(func) : ASC_CPU_DISP_INIT_SSE4_C(func))
+#define ASC_CPU_DISP_INIT_AVX512_AVX2_SSE4_C(func)  (m_AVX512_available ? ASC_CPU_DISP_INIT_AVX512(func) : ASC_CPU_DISP_INIT_AVX2_SSE4_C(func))
+
 ASC_API mfxStatus ASC::Init(mfxI32 Width, mfxI32 Height, mfxI32 Pitch, mfxU32 PicStruct, CmDevice* pCmDevice)
 {
     mfxStatus sts = MFX_ERR_NONE;
@@ -679,6 +684,7 @@ ASC_API mfxStatus ASC::Init(mfxI32 Width, mfxI32 Height, mfxI32 Pitch, mfxU32 Pi
     m_task = nullptr;
     m_taskCp = nullptr;
 
+    m_AVX512_available = CpuFeature_AVX512();
     m_AVX2_available = CpuFeature_AVX2();
     m_SSE4_available = CpuFeature_SSE41();
 
@@ -689,12 +695,12 @@ ASC_API mfxStatus ASC::Init(mfxI32 Width, mfxI32 Height, mfxI32 Pitch, mfxU32 Pi
     ME_VAR_8x8_Block    = ME_VAR_8x8_Block_SSE4;
 
     ASC_CPU_DISP_INIT_C(GainOffset);
-    ASC_CPU_DISP_INIT_SSE4_C(RsCsCalc_4x4);
+    ASC_CPU_DISP_INIT_AVX512_SSE4_C(RsCsCalc_4x4);
     ASC_CPU_DISP_INIT_C(RsCsCalc_bound);
     ASC_CPU_DISP_INIT_C(RsCsCalc_diff);
-    ASC_CPU_DISP_INIT_SSE4_C(ImageDiffHistogram);
-    ASC_CPU_DISP_INIT_AVX2_SSE4_C(ME_SAD_8x8_Block_Search);
-    ASC_CPU_DISP_INIT_SSE4_C(Calc_RaCa_pic);
+    ASC_CPU_DISP_INIT_AVX512_SSE4_C(ImageDiffHistogram);
+    ASC_CPU_DISP_INIT_AVX512_AVX2_SSE4_C(ME_SAD_8x8_Block_Search);
+    ASC_CPU_DISP_INIT_AVX512_SSE4_C(Calc_RaCa_pic);
 
     InitStruct();
     try
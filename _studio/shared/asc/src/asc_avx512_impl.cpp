@@ -0,0 +1,256 @@
+/*//////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2020 Intel Corporation
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+*/
+#include "asc_avx512_impl.h"
+
+#if defined(__AVX512F__) && defined(__AVX512BW__)
+
+#include <algorithm>
+
+// mask of [n] low bits, n = 0..64
+static inline __mmask64 LowMask64(mfxI32 n)
+{
+    return n >= 64 ? ~0ull : ((1ull << n) - 1);
+}
+
+static inline mfxU32 CountBits(__mmask64 m)
+{
+#ifdef ARCH64
+    return (mfxU32)_mm_popcnt_u64(m);
+#else
+    return _mm_popcnt_u32((mfxU32)m) + _mm_popcnt_u32((mfxU32)(m >> 32));
+#endif
+}
+
+// Load 0..32 bytes zero extended to words
+static inline __m512i LoadPartialZmm16(pmfxU8 pSrc, __mmask64 mask)
+{
+    return _mm512_cvtepu8_epi16(_mm512_castsi512_si256(_mm512_maskz_loadu_epi8(mask, pSrc)));
+}
+
+// qword k selects words k..k+3, i.e. 8 reference bytes at even position 2k
+static const mfxU16 tab_evenpos[32] = {
+    0, 1, 2, 3,  1, 2, 3, 4,  2, 3, 4, 5,  3, 4, 5, 6,
+    4, 5, 6, 7,  5, 6, 7, 8,  6, 7, 8, 9,  7, 8, 9, 10
+};
+
+// Evaluates all search positions of one reference row, 8 candidates x, x + 2, .., x + 14
+// per iteration, and keeps the best SAD and its position per candidate lane
+static inline void ME_SAD_8x8_Row_AVX512(const __m512i s[8], mfxU8 *pRef, int pitch, int xrange, int y,
+    __m512i &bestSAD, __m512i &bestPos) {
+    const __m512i perm = _mm512_loadu_si512(tab_evenpos);
+    const __m512i step = _mm512_setr_epi64(0, 2, 4, 6, 8, 10, 12, 14);
+
+    for (int x = 0; x < xrange; x += 16) {
+        // candidates below xrange and reference bytes they cover
+        __mmask8  lanes = (__mmask8)((1u << std::min((xrange - x + 1) >> 1, 8)) - 1);
+        __mmask64 bytes = LowMask64(std::min(xrange - x + 7, 22));
+        pmfxU8 pr = pRef + x;
+        __m512i sad = _mm512_setzero_si512();
+        for (int i = 0; i < 8; i++) {
+            __m512i r = _mm512_maskz_loadu_epi8(bytes, &pr[i * pitch]);
+            r = _mm512_permutexvar_epi16(perm, r);
+            sad = _mm512_add_epi64(sad, _mm512_sad_epu8(r, s[i]));
+        }
+        // strict compare keeps the first position in scan order
+        __mmask8 better = _mm512_mask_cmplt_epu64_mask(lanes, sad, bestSAD);
+        bestSAD = _mm512_mask_mov_epi64(bestSAD, better, sad);
+        bestPos = _mm512_mask_mov_epi64(bestPos, better,
+            _mm512_add_epi64(_mm512_set1_epi64(((mfxI64)y << 16) + x), step));
+    }
+}
+
+void ME_SAD_8x8_Block_Search_AVX512(mfxU8 *pSrc, mfxU8 *pRef, int pitch, int xrange, int yrange,
+    mfxU16 *bestSAD, int *bestX, int *bestY) {
+    __m512i s[8];
+    for (int i = 0; i < 8; i++)
+        s[i] = _mm512_broadcastq_epi64(_mm_loadl_epi64((__m128i *)&pSrc[i * pitch]));
+
+    // 8x8 SAD never exceeds 0xffff
+    __m512i bestSADv = _mm512_set1_epi64(0xffff);
+    __m512i bestPos = _mm512_setzero_si512();
+    for (int y = 0; y < yrange; y += SAD_SEARCH_VSTEP)
+        ME_SAD_8x8_Row_AVX512(s, pRef + y * pitch, pitch, xrange, y, bestSADv, bestPos);
+
+    // the first position in scan order among the best ones, as sequential search does
+    mfxU64 SAD = _mm512_reduce_min_epu64(bestSADv);
+    __mmask8 best = _mm512_cmpeq_epu64_mask(bestSADv, _mm512_set1_epi64(SAD));
+    mfxU64 pos = _mm512_mask_reduce_min_epu64(best, bestPos);
+
+    if (SAD < *bestSAD) {
+        *bestSAD = (mfxU16)SAD;
+        *bestX = (int)(pos & 0xffff);
+        *bestY = (int)(pos >> 16);
+    }
+}
+
+void RsCsCalc_4x4_AVX512(pmfxU8 pSrc, int srcPitch, int wblocks, int hblocks, pmfxU16 pRs, pmfxU16 pCs)
+{
+    pSrc += (4 * srcPitch) + 4;
+    for (mfxI32 i = 0; i < hblocks - 2; i++)
+    {
+        // 8 horizontal blocks at a time, the last iteration takes remaining 1..8 ones
+        for (mfxI32 j = 0; j < wblocks - 2; j += 8)
+        {
+            mfxI32 n = std::min(wblocks - 2 - j, 8);
+            __mmask64 valid = LowMask64(4 * n);
+            pmfxU8 p = pSrc + 4 * j;
+
+            __m512i rs = _mm512_setzero_si512();
+            __m512i cs = _mm512_setzero_si512();
+            __m512i a = LoadPartialZmm16(&p[-srcPitch], valid);
+
+            for (mfxI32 k = 0; k < 4; k++)
+            {
+                __m512i b = LoadPartialZmm16(&p[-1], valid);
+                __m512i c = LoadPartialZmm16(&p[0], valid);
+                p += srcPitch;
+
+                // accRs += dRs * dRs
+                a = _mm512_srai_epi16(_mm512_abs_epi16(_mm512_sub_epi16(c, a)), 2);
+                rs = _mm512_add_epi32(rs, _mm512_madd_epi16(a, a));
+
+                // accCs += dCs * dCs
+                b = _mm512_srai_epi16(_mm512_abs_epi16(_mm512_sub_epi16(c, b)), 2);
+                cs = _mm512_add_epi32(cs, _mm512_madd_epi16(b, b));
+
+                // reuse next iteration
+                a = c;
+            }
+
+            // qword k holds two partial sums of block k
+            rs = _mm512_add_epi32(rs, _mm512_srli_epi64(rs, 32));
+            cs = _mm512_add_epi32(cs, _mm512_srli_epi64(cs, 32));
+
+            _mm512_mask_cvtepi64_storeu_epi16(&pRs[i * wblocks + j], (__mmask8)((1 << n) - 1), rs);
+            _mm512_mask_cvtepi64_storeu_epi16(&pCs[i * wblocks + j], (__mmask8)((1 << n) - 1), cs);
+        }
+        pSrc += 4 * srcPitch;
+    }
+}
+
+void ImageDiffHistogram_AVX512(pmfxU8 pSrc, pmfxU8 pRef, mfxU32 pitch, mfxU32 width, mfxU32 height, mfxI32 histogram[5], mfxI64 *pSrcDC, mfxI64 *pRefDC) {
+    __m512i sDC = _mm512_setzero_si512();
+    __m512i rDC = _mm512_setzero_si512();
+
+    const __m512i zero = _mm512_setzero_si512();
+    const __m512i lo = _mm512_set1_epi8(HIST_THRESH_LO);
+    const __m512i hi = _mm512_set1_epi8(HIST_THRESH_HI);
+
+    mfxU32 h0 = 0, h1 = 0, h2 = 0, h3 = 0;
+
+    for (mfxU32 i = 0; i < height; i++)
+    {
+        // process 64 pixels per iteration, the last iteration takes remaining 1..64 ones
+        for (mfxU32 j = 0; j < width; j += 64)
+        {
+            __mmask64 valid = LowMask64((mfxI32)std::min(width - j, 64u));
+            __m512i s = _mm512_maskz_loadu_epi8(valid, &pSrc[j]);
+            __m512i r = _mm512_maskz_loadu_epi8(valid, &pRef[j]);
+
+            sDC = _mm512_add_epi64(sDC, _mm512_sad_epu8(s, zero));    //accumulate horizontal sums
+            rDC = _mm512_add_epi64(rDC, _mm512_sad_epu8(r, zero));
+
+            r = _mm512_sub_epi8(r, _mm512_set1_epi8(-128));   // convert to signed
+            s = _mm512_sub_epi8(s, _mm512_set1_epi8(-128));
+
+            __m512i dn = _mm512_subs_epi8(r, s);   // -d saturated to [-128,127]
+            __m512i dp = _mm512_subs_epi8(s, r);   // +d saturated to [-128,127]
+
+            // unused elements are not counted
+            h0 += CountBits(_mm512_mask_cmpgt_epi8_mask(valid, dn, hi)); // d < -12
+            h1 += CountBits(_mm512_mask_cmpgt_epi8_mask(valid, dn, lo)); // d < -4
+            h2 += CountBits(_mm512_mask_cmpgt_epi8_mask(valid, lo, dp)); // d < +4
+            h3 += CountBits(_mm512_mask_cmpgt_epi8_mask(valid, hi, dp)); // d < +12
+        }
+        pSrc += pitch;
+        pRef += pitch;
+    }
+
+    *pSrcDC = _mm512_reduce_add_epi64(sDC);
+    *pRefDC = _mm512_reduce_add_epi64(rDC);
+
+    histogram[0] = h0;
+    histogram[1] = h1;
+    histogram[2] = h2;
+    histogram[3] = h3;
+    histogram[4] = width * height;
+
+    // undo cumulative counts, by differencing
+    histogram[4] -= histogram[3];
+    histogram[3] -= histogram[2];
+    histogram[2] -= histogram[1];
+    histogram[1] -= histogram[0];
+}
+
+mfxStatus Calc_RaCa_pic_AVX512(mfxU8 *pSrc, mfxI32 width, mfxI32 height, mfxI32 pitch, mfxF64 &RsCs) {
+    mfxU8*
+        pY = pSrc + (4 * pitch) + 4;
+    mfxI32
+        nblocks = (width - 8 + 3) >> 2;
+    const __m512i
+        ones = _mm512_set1_epi16(1),
+        lo32 = _mm512_set1_epi64(0xffffffff);
+    __m512i
+        RS = _mm512_setzero_si512(),
+        CS = _mm512_setzero_si512();
+
+    for (mfxI32 i = 0; i < height - 8; i += 4)
+    {
+        // 8 horizontal blocks at a time, the last iteration takes remaining 1..8 ones
+        for (mfxI32 j = 0; j < nblocks; j += 8)
+        {
+            __mmask64 valid = LowMask64(4 * std::min(nblocks - j, 8));
+            mfxU8 *p = pY + 4 * j;
+
+            __m512i rs = _mm512_setzero_si512();
+            __m512i cs = _mm512_setzero_si512();
+            __m512i c = LoadPartialZmm16(&p[0], valid);
+            for (mfxI32 k = 0; k < 4; k++)
+            {
+                __m512i b = LoadPartialZmm16(&p[1], valid);
+                __m512i a = LoadPartialZmm16(&p[pitch], valid);
+                p += pitch;
+
+                // Cs += (pS[j] > pS[j + 1]) ? (pS[j] - pS[j + 1]) : (pS[j + 1] - pS[j]);
+                cs = _mm512_add_epi16(cs, _mm512_abs_epi16(_mm512_sub_epi16(c, b)));
+                // Rs += (pS[j] > pS2[j]) ? (pS[j] - pS2[j]) : (pS2[j] - pS[j]);
+                rs = _mm512_add_epi16(rs, _mm512_abs_epi16(_mm512_sub_epi16(c, a)));
+
+                // reuse next iteration
+                c = a;
+            }
+
+            // per block sums in qwords, Cs >> 4; Rs >> 4;
+            rs = _mm512_madd_epi16(rs, ones);
+            cs = _mm512_madd_epi16(cs, ones);
+            rs = _mm512_and_si512(_mm512_add_epi32(rs, _mm512_srli_epi64(rs, 32)), lo32);
+            cs = _mm512_and_si512(_mm512_add_epi32(cs, _mm512_srli_epi64(cs, 32)), lo32);
+            RS = _mm512_add_epi64(RS, _mm512_srli_epi64(rs, 4));
+            CS = _mm512_add_epi64(CS, _mm512_srli_epi64(cs, 4));
+        }
+        pY += 4 * pitch;
+    }
+    RsCs = calc_RACA_pic_C((mfxI32)_mm512_reduce_add_epi64(RS), (mfxI32)_mm512_reduce_add_epi64(CS), width, height);
+    return MFX_ERR_NONE;
+}
+
+#endif //defined(__AVX512F__) && defined(__AVX512BW__)
@@ -39,10 +39,16 @@ enum
 typedef void(*t_copyVideoToSys)(const mfxU8* src, mfxU8* dst, int width);
 typedef void(*t_copyVideoToSysShift)(const mfxU16* src, mfxU16* dst, int width, int shift);
 typedef void(*t_copySysToVideoShift)(const mfxU16* src, mfxU16* dst, int width, int shift);
+typedef void(*t_copyVideoToSysSplitUV)(const mfxU8* src, mfxU8* dstU, mfxU8* dstV, int width);
+typedef void(*t_copyVideoToSysSplitUVShift)(const mfxU16* src, mfxU16* dstU, mfxU16* dstV, int width, int shift);
+typedef void(*t_copyVideoToSysSplitRGB4)(const mfxU8* src, mfxU8* dstR, mfxU8* dstG, mfxU8* dstB, int width);
 
 void copyVideoToSys(const mfxU8* src, mfxU8* dst, int width);
 void copyVideoToSysShift(const mfxU16* src, mfxU16* dst, int width, int shift);
 void copySysToVideoShift(const mfxU16* src, mfxU16* dst, int width, int shift);
+void copyVideoToSysSplitUV(const mfxU8* src, mfxU8* dstU, mfxU8* dstV, int width);
+void copyVideoToSysSplitUVShift(const mfxU16* src, mfxU16* dstU, mfxU16* dstV, int width, int shift);
+void copyVideoToSysSplitRGB4(const mfxU8* src, mfxU8* dstR, mfxU8* dstG, mfxU8* dstB, int width);
 
 template<typename T>
 inline int mfxCopyRect(const T* pSrc, int srcStep, T* pDst, int dstStep, mfxSize roiSize, int flag)
@@ -121,6 +127,67 @@ public:
         }
         return MFX_ERR_NONE;
     }
+
+    // copy interleaved UV plane to separate U and V planes, roi.width is in UV pairs
+    static mfxStatus CopySplitUV(mfxU8 *pDstU, mfxU8 *pDstV, mfxU32 dstPitch, mfxU8 *pSrc, mfxU32 srcPitch, mfxSize roi)
+    {
+        MFX_AUTO_LTRACE(MFX_TRACE_LEVEL_HOTSPOTS, "FastCopy::CopySplitUV");
+
+        if (NULL == pDstU || NULL == pDstV || NULL == pSrc)
+        {
+            return MFX_ERR_NULL_PTR;
+        }
+
+        for (int h = 0; h < roi.height; h++)
+        {
+            copyVideoToSysSplitUV(pSrc, pDstU, pDstV, roi.width);
+            pSrc  += srcPitch;
+            pDstU += dstPitch;
+            pDstV += dstPitch;
+        }
+        return MFX_ERR_NONE;
+    }
+
+    // same for 16-bit samples, which are shifted right by rshift
+    static mfxStatus CopySplitUVAndShift(mfxU16 *pDstU, mfxU16 *pDstV, mfxU32 dstPitch, mfxU16 *pSrc, mfxU32 srcPitch, mfxSize roi, mfxU8 rshift)
+    {
+        MFX_AUTO_LTRACE(MFX_TRACE_LEVEL_HOTSPOTS, "FastCopy::CopySplitUVAndShift");
+
+        if (NULL == pDstU || NULL == pDstV || NULL == pSrc)
+        {
+            return MFX_ERR_NULL_PTR;
+        }
+
+        for (int h = 0; h < roi.height; h++)
+        {
+            copyVideoToSysSplitUVShift(pSrc, pDstU, pDstV, roi.width, rshift);
+            pSrc  = (mfxU16 *)((mfxU8*)pSrc + srcPitch);
+            pDstU = (mfxU16 *)((mfxU8*)pDstU + dstPitch);
+            pDstV = (mfxU16 *)((mfxU8*)pDstV + dstPitch);
+        }
+        return MFX_ERR_NONE;
+    }
+
+    // copy packed RGB4 to separate R, G and B planes, alpha is dropped
+    static mfxStatus CopySplitRGB4(mfxU8 *pDstR, mfxU8 *pDstG, mfxU8 *pDstB, mfxU32 dstPitch, mfxU8 *pSrc, mfxU32 srcPitch, mfxSize roi)
+    {
+        MFX_AUTO_LTRACE(MFX_TRACE_LEVEL_HOTSPOTS, "FastCopy::CopySplitRGB4");
+
+        if (NULL == pDstR || NULL == pDstG || NULL == pDstB || NULL == pSrc)
+        {
+            return MFX_ERR_NULL_PTR;
+        }
+
+        for (int h = 0; h < roi.height; h++)
+        {
+            copyVideoToSysSplitRGB4(pSrc, pDstR, pDstG, pDstB, roi.width);
+            pSrc  += srcPitch;
+            pDstR += dstPitch;
+            pDstG += dstPitch;
+            pDstB += dstPitch;
+        }
+        return MFX_ERR_NONE;
+    }
 };
 
 #endif // __FAST_COPY_H__
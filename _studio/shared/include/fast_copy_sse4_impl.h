@@ -27,5 +27,8 @@
 void copyVideoToSys_SSE4(const mfxU8* src, mfxU8* dst, int width);
 void copyVideoToSysShift_SSE4(const mfxU16* src, mfxU16* dst, int width, int shift);
 void copySysToVideoShift_SSE4(const mfxU16* src, mfxU16* dst, int width, int shift);
+void copyVideoToSysSplitUV_SSE4(const mfxU8* src, mfxU8* dstU, mfxU8* dstV, int width);
+void copyVideoToSysSplitUVShift_SSE4(const mfxU16* src, mfxU16* dstU, mfxU16* dstV, int width, int shift);
+void copyVideoToSysSplitRGB4_SSE4(const mfxU8* src, mfxU8* dstR, mfxU8* dstG, mfxU8* dstB, int width);
 
 #endif // __FAST_COPY_SSE4_IMPL_H__
@@ -22,6 +22,8 @@
 #define _LIBMFX_ALLOCATOR_H_
 
 #include <vector>
+#include <map>
+#include <mutex>
 #include "mfxvideo.h"
 
 
@@ -53,6 +55,50 @@ namespace mfxDefaultAllocator
     };
 }
 
+// Large buffers carved out of slabs backed by 2MB pages where the system
+// allows (transparent huge pages otherwise). Freed buffers stay in the pool
+// and are reused by following allocations of about the same size, so frame
+// pools reallocated on Reset don't fault their pages in again. Slabs are
+// released when a new one is needed and they have no buffers in use, and
+// with the pool.
+class mfxSlabPool
+{
+public:
+    mfxSlabPool();
+    ~mfxSlabPool();
+
+    // makes sure count buffers of the size can be allocated without new slabs
+    void   Reserve(size_t size, mfxU32 count, mfxI32 numaNode);
+    mfxU8* Alloc(size_t size, mfxI32 numaNode);
+    // returns false if the buffer doesn't belong to the pool
+    bool   Free(mfxU8 *ptr);
+
+protected:
+    struct Slab
+    {
+        mfxU8  *base;
+        size_t  size;
+        size_t  used;   // bytes carved out
+        mfxU32  live;   // buffers in use
+    };
+    struct Block
+    {
+        size_t  size;
+        size_t  slab;
+    };
+
+    bool   AddSlab(size_t size, mfxI32 numaNode);
+    void   ReleaseIdleSlabs();
+    mfxU8* Carve(size_t size);
+    size_t CountFree(size_t size);
+    std::multimap<size_t, mfxU8*>::iterator FindFree(size_t size);
+
+    std::vector<Slab>             m_slabs;
+    std::map<mfxU8*, Block>       m_blocks;   // all carved blocks
+    std::multimap<size_t, mfxU8*> m_free;     // free blocks by size
+    std::mutex                    m_guard;
+};
+
 class mfxWideBufferAllocator
 {
 public:
@@ -60,6 +106,10 @@ public:
     mfxWideBufferAllocator(void);
     ~mfxWideBufferAllocator(void);
     mfxBufferAllocator bufferAllocator;
+    // NUMA node preferred for allocated buffers, -1 for default policy
+    mfxI32 numaNode;
+    // large buffers
+    mfxSlabPool pool;
 };
 
 class mfxBaseWideFrameAllocator
@@ -22,6 +22,7 @@
 #define __LIBMFX_CORE_H__
 
 #include <map>
+#include <atomic>
 
 #include "umc_mutex.h"
 #include "libmfx_allocator.h"
@@ -159,6 +160,14 @@ public:
     // non-virtual QueryPlatform, as we should not change vtable
     mfxStatus QueryPlatform(mfxPlatform* platform);
 
+    // NUMA node preferred for internal system memory, -1 for default policy
+    void SetNumaNode(mfxI32 node) { m_bufferAllocator.numaNode = node; }
+
+    // frame deadline of the real-time scheduling class in microseconds, 0 disables the class
+    void SetFrameDeadline(mfxU32 deadline);
+    // deadline of a task processing the frame with given time stamp, 0 if the session has no deadlines
+    mfxU64 GetTaskDeadline(mfxU64 timeStamp);
+
 protected:
 
     CommonCORE(const mfxU32 numThreadsAvailable, const mfxSession session = nullptr);
@@ -272,6 +281,13 @@ protected:
 
     mfxU16                                     m_deviceId;
 
+    // frame deadline in vm_time ticks and the frame, which maps time stamps to the wall clock,
+    // all are guarded by m_guard, m_frameDeadline is also checked without the guard
+    std::atomic<mfxU64>                        m_frameDeadline;
+    mfxU64                                     m_deadlineBaseTick;
+    mfxU64                                     m_deadlineBaseTimeStamp;
+    mfxU64                                     m_deadlineLastTimeStamp;
+
     CommonCORE & operator = (const CommonCORE &) = delete;
 };
 
@@ -27,9 +27,65 @@
 #include <map>
 #include <list>
 #include <vector>
+#include <memory>
 #include <condition_variable>
 #include <mfxstructures.h>
 
+// Statistics of frames combining, times are in microseconds
+struct MFEBatchStat
+{
+    mfxU64 NumSubmissions;      // number of vaMFSubmit calls
+    mfxU64 NumFramesSubmitted;  // frames passed to all vaMFSubmit calls
+    mfxU64 NumFramesExpected;   // frames all submissions were waiting for
+    mfxU64 NumTimeouts;         // submissions done with incomplete batch
+    mfxU64 TotalWaitTime;       // sum of all frames waiting time
+    mfxU64 MaxWaitTime;         // longest waiting time of a frame
+};
+
+// Decides how long a frame can wait for frames of other streams
+class MFEBatchPolicy
+{
+public:
+    virtual ~MFEBatchPolicy() {}
+
+    // called for every frame going to be combined, time in microseconds
+    virtual void OnFrameArrival(long long now) = 0;
+
+    // returns time to wait for framesMissing frames, budget - latency budget of the frame
+    virtual long long GetWaitTime(mfxU32 framesMissing, long long budget) = 0;
+
+    // called for every submission
+    virtual void OnSubmit(mfxU32 framesSubmitted, mfxU32 framesExpected) = 0;
+};
+
+// Always waits for whole latency budget
+class MFEFixedBatchPolicy : public MFEBatchPolicy
+{
+public:
+    virtual void OnFrameArrival(long long) {}
+    virtual long long GetWaitTime(mfxU32, long long budget) { return budget; }
+    virtual void OnSubmit(mfxU32, mfxU32) {}
+};
+
+// Estimates time needed to fill the batch from frames arrival rate
+// and doesn't hold a frame for a batch which won't be filled in budget.
+// Wait is shortened further while batches are not filled (e.g. one of
+// live streams paused) and restored with the first filled batch
+class MFEAdaptiveBatchPolicy : public MFEBatchPolicy
+{
+public:
+    MFEAdaptiveBatchPolicy();
+
+    virtual void OnFrameArrival(long long now);
+    virtual long long GetWaitTime(mfxU32 framesMissing, long long budget);
+    virtual void OnSubmit(mfxU32 framesSubmitted, mfxU32 framesExpected);
+
+private:
+    long long m_lastArrival;
+    long long m_avgInterval; // moving average of interval between frames of all streams
+    mfxU32    m_misses;      // number of incomplete batches in a row
+};
+
 class MFEVAAPIEncoder
 {
     struct m_stream_ids_t
@@ -40,6 +96,7 @@ class MFEVAAPIEncoder
         mfxU32 restoreCount;
         mfxU32 restoreCountBase;
         bool isSubmitted;
+        long long arrivalTime;
         m_stream_ids_t( VAContextID _ctx,
                         mfxStatus _sts,
                         long long defaultTimeout):
@@ -48,7 +105,8 @@ class MFEVAAPIEncoder
         timeout(defaultTimeout),
         restoreCount(0),
         restoreCountBase(0),
-        isSubmitted(false)
+        isSubmitted(false),
+        arrivalTime(0)
         {
         };
         inline void reset()
@@ -88,12 +146,17 @@ public:
     mfxStatus Destroy();
     mfxStatus Submit(VAContextID context, long long timeToWait, bool skipFrame);//time passed in microseconds
 
+    // takes ownership of policy, MFEFixedBatchPolicy is used by default
+    void SetBatchPolicy(MFEBatchPolicy* policy);
+    void GetBatchStat(MFEBatchStat& stat);
+
     virtual void AddRef();
     virtual void Release();
 
 private:
 
     mfxStatus   reconfigureRestorationCounts(VAContextID newCtx);
+    void        updateBatchStat(mfxU32 framesExpected, long long now);
     mfxU32      m_refCounter;
 
     std::condition_variable     m_mfe_wait;
@@ -135,6 +198,10 @@ private:
     std::map<VAContextID, StreamsIter_t> m_streamsMap;
     //minimal timeout of all streams
     long long m_minTimeToWait;
+
+    std::unique_ptr<MFEBatchPolicy> m_policy;
+    MFEBatchStat                    m_stat;
+
     // currently up-to-to 3 frames worth combining
     static const mfxU32 MAX_FRAMES_TO_COMBINE = 3;
 };
@@ -53,3 +53,30 @@ void copySysToVideoShift(const mfxU16* src, mfxU16* dst, int width, int shift)
 
     copySysToVideoShift_impl(src, dst, width, shift);
 }
+
+void copyVideoToSysSplitUV(const mfxU8* src, mfxU8* dstU, mfxU8* dstV, int width)
+{
+    static const int m_SSE4_available = CpuFeature_SSE41();
+
+    static const t_copyVideoToSysSplitUV copyVideoToSysSplitUV_impl = FAFT_COPY_CPU_DISP_INIT_SSE4_C(copyVideoToSysSplitUV);
+
+    copyVideoToSysSplitUV_impl(src, dstU, dstV, width);
+}
+
+void copyVideoToSysSplitUVShift(const mfxU16* src, mfxU16* dstU, mfxU16* dstV, int width, int shift)
+{
+    static const int m_SSE4_available = CpuFeature_SSE41();
+
+    static const t_copyVideoToSysSplitUVShift copyVideoToSysSplitUVShift_impl = FAFT_COPY_CPU_DISP_INIT_SSE4_C(copyVideoToSysSplitUVShift);
+
+    copyVideoToSysSplitUVShift_impl(src, dstU, dstV, width, shift);
+}
+
+void copyVideoToSysSplitRGB4(const mfxU8* src, mfxU8* dstR, mfxU8* dstG, mfxU8* dstB, int width)
+{
+    static const int m_SSE4_available = CpuFeature_SSE41();
+
+    static const t_copyVideoToSysSplitRGB4 copyVideoToSysSplitRGB4_impl = FAFT_COPY_CPU_DISP_INIT_SSE4_C(copyVideoToSysSplitRGB4);
+
+    copyVideoToSysSplitRGB4_impl(src, dstR, dstG, dstB, width);
+}
@@ -37,3 +37,32 @@ void copySysToVideoShift_C(const mfxU16* src, mfxU16* dst, int width, int shift)
     for (int i = 0; i < width; i++)
         *dst++ = (*src++) << shift;
 }
+
+void copyVideoToSysSplitUV_C(const mfxU8* src, mfxU8* dstU, mfxU8* dstV, int width)
+{
+    for (int i = 0; i < width; i++)
+    {
+        *dstU++ = *src++;
+        *dstV++ = *src++;
+    }
+}
+
+void copyVideoToSysSplitUVShift_C(const mfxU16* src, mfxU16* dstU, mfxU16* dstV, int width, int shift)
+{
+    for (int i = 0; i < width; i++)
+    {
+        *dstU++ = (*src++) >> shift;
+        *dstV++ = (*src++) >> shift;
+    }
+}
+
+void copyVideoToSysSplitRGB4_C(const mfxU8* src, mfxU8* dstR, mfxU8* dstG, mfxU8* dstB, int width)
+{
+    // RGB4 pixel is B, G, R, A in memory
+    for (int i = 0; i < width; i++, src += 4)
+    {
+        *dstB++ = src[0];
+        *dstG++ = src[1];
+        *dstR++ = src[2];
+    }
+}
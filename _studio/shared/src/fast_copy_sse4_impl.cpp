@@ -191,4 +191,141 @@ void copySysToVideoShift_SSE4(const mfxU16* src, mfxU16* dst, int width, int shi
     }
 }
 
+// Following kernels read source by streaming loads once and write each component
+// to its own plane. Head is processed by scalar code till source is 16-byte aligned,
+// source not aligned to element size is processed by scalar code completely.
+
+void copyVideoToSysSplitUV_SSE4(const mfxU8* src, mfxU8* dstU, mfxU8* dstV, int width)
+{
+    static const int item_size = 4 * sizeof(__m128i) / 2;
+
+    int align16 = (reinterpret_cast<size_t>(src) & 1) ? width : ((0x10 - (reinterpret_cast<size_t>(src) & 0xf)) & 0xf) / 2;
+    align16 = std::min(align16, width);
+
+    int i = 0;
+    for (; i < align16; i++)
+    {
+        *dstU++ = *src++;
+        *dstV++ = *src++;
+    }
+
+    const __m128i mask = _mm_set1_epi16(0x00ff);
+
+    for (; i + item_size <= width; i += item_size)
+    {
+        __m128i xmm0 = _mm_stream_load_si128((__m128i *)src);
+        __m128i xmm1 = _mm_stream_load_si128((__m128i *)src + 1);
+        __m128i xmm2 = _mm_stream_load_si128((__m128i *)src + 2);
+        __m128i xmm3 = _mm_stream_load_si128((__m128i *)src + 3);
+        __m128i u0 = _mm_packus_epi16(_mm_and_si128(xmm0, mask), _mm_and_si128(xmm1, mask));
+        __m128i u1 = _mm_packus_epi16(_mm_and_si128(xmm2, mask), _mm_and_si128(xmm3, mask));
+        __m128i v0 = _mm_packus_epi16(_mm_srli_epi16(xmm0, 8), _mm_srli_epi16(xmm1, 8));
+        __m128i v1 = _mm_packus_epi16(_mm_srli_epi16(xmm2, 8), _mm_srli_epi16(xmm3, 8));
+        _mm_storeu_si128((__m128i *)dstU, u0);
+        _mm_storeu_si128((__m128i *)dstU + 1, u1);
+        _mm_storeu_si128((__m128i *)dstV, v0);
+        _mm_storeu_si128((__m128i *)dstV + 1, v1);
+
+        src  += 2 * item_size;
+        dstU += item_size;
+        dstV += item_size;
+    }
+
+    for (; i < width; i++)
+    {
+        *dstU++ = *src++;
+        *dstV++ = *src++;
+    }
+}
+
+void copyVideoToSysSplitUVShift_SSE4(const mfxU16* src, mfxU16* dstU, mfxU16* dstV, int width, int shift)
+{
+    static const int item_size = 4 * sizeof(__m128i) / 4;
+
+    int align16 = (reinterpret_cast<size_t>(src) & 3) ? width : ((0x10 - (reinterpret_cast<size_t>(src) & 0xf)) & 0xf) / 4;
+    align16 = std::min(align16, width);
+
+    int i = 0;
+    for (; i < align16; i++)
+    {
+        *dstU++ = (*src++) >> shift;
+        *dstV++ = (*src++) >> shift;
+    }
+
+    const __m128i zero = _mm_setzero_si128();
+
+    for (; i + item_size <= width; i += item_size)
+    {
+        __m128i xmm0 = _mm_srli_epi16(_mm_stream_load_si128((__m128i *)src), shift);
+        __m128i xmm1 = _mm_srli_epi16(_mm_stream_load_si128((__m128i *)src + 1), shift);
+        __m128i xmm2 = _mm_srli_epi16(_mm_stream_load_si128((__m128i *)src + 2), shift);
+        __m128i xmm3 = _mm_srli_epi16(_mm_stream_load_si128((__m128i *)src + 3), shift);
+        __m128i u0 = _mm_packus_epi32(_mm_blend_epi16(xmm0, zero, 0xaa), _mm_blend_epi16(xmm1, zero, 0xaa));
+        __m128i u1 = _mm_packus_epi32(_mm_blend_epi16(xmm2, zero, 0xaa), _mm_blend_epi16(xmm3, zero, 0xaa));
+        __m128i v0 = _mm_packus_epi32(_mm_srli_epi32(xmm0, 16), _mm_srli_epi32(xmm1, 16));
+        __m128i v1 = _mm_packus_epi32(_mm_srli_epi32(xmm2, 16), _mm_srli_epi32(xmm3, 16));
+        _mm_storeu_si128((__m128i *)dstU, u0);
+        _mm_storeu_si128((__m128i *)dstU + 1, u1);
+        _mm_storeu_si128((__m128i *)dstV, v0);
+        _mm_storeu_si128((__m128i *)dstV + 1, v1);
+
+        src  += 2 * item_size;
+        dstU += item_size;
+        dstV += item_size;
+    }
+
+    for (; i < width; i++)
+    {
+        *dstU++ = (*src++) >> shift;
+        *dstV++ = (*src++) >> shift;
+    }
+}
+
+void copyVideoToSysSplitRGB4_SSE4(const mfxU8* src, mfxU8* dstR, mfxU8* dstG, mfxU8* dstB, int width)
+{
+    static const int item_size = 4 * sizeof(__m128i) / 4;
+
+    int align16 = (reinterpret_cast<size_t>(src) & 3) ? width : ((0x10 - (reinterpret_cast<size_t>(src) & 0xf)) & 0xf) / 4;
+    align16 = std::min(align16, width);
+
+    // RGB4 pixel is B, G, R, A in memory
+    int i = 0;
+    for (; i < align16; i++, src += 4)
+    {
+        *dstB++ = src[0];
+        *dstG++ = src[1];
+        *dstR++ = src[2];
+    }
+
+    // groups components of 4 pixels in 32-bit lanes: BBBB GGGG RRRR AAAA
+    const __m128i shuffle = _mm_setr_epi8(0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15);
+
+    for (; i + item_size <= width; i += item_size)
+    {
+        __m128i xmm0 = _mm_shuffle_epi8(_mm_stream_load_si128((__m128i *)src), shuffle);
+        __m128i xmm1 = _mm_shuffle_epi8(_mm_stream_load_si128((__m128i *)src + 1), shuffle);
+        __m128i xmm2 = _mm_shuffle_epi8(_mm_stream_load_si128((__m128i *)src + 2), shuffle);
+        __m128i xmm3 = _mm_shuffle_epi8(_mm_stream_load_si128((__m128i *)src + 3), shuffle);
+        __m128i bg01 = _mm_unpacklo_epi32(xmm0, xmm1);
+        __m128i ra01 = _mm_unpackhi_epi32(xmm0, xmm1);
+        __m128i bg23 = _mm_unpacklo_epi32(xmm2, xmm3);
+        __m128i ra23 = _mm_unpackhi_epi32(xmm2, xmm3);
+        _mm_storeu_si128((__m128i *)dstB, _mm_unpacklo_epi64(bg01, bg23));
+        _mm_storeu_si128((__m128i *)dstG, _mm_unpackhi_epi64(bg01, bg23));
+        _mm_storeu_si128((__m128i *)dstR, _mm_unpacklo_epi64(ra01, ra23));
+
+        src  += 4 * item_size;
+        dstR += item_size;
+        dstG += item_size;
+        dstB += item_size;
+    }
+
+    for (; i < width; i++, src += 4)
+    {
+        *dstB++ = src[0];
+        *dstG++ = src[1];
+        *dstR++ = src[2];
+    }
+}
+
 #endif // __SSE4_1__ || _WIN32
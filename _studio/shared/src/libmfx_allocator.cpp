@@ -25,7 +25,17 @@
 #include "mfx_utils.h"
 #include "mfx_common.h"
 
+#include <algorithm>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 #define ALIGN32(X) (((mfxU32)((X)+31)) & (~ (mfxU32)31))
+// frame data and rows start at cache line boundaries
+#define ALIGN64(X) (((mfxU32)((X)+63)) & (~ (mfxU32)63))
 #define ID_BUFFER MFX_MAKEFOURCC('B','U','F','F')
 #define ID_FRAME  MFX_MAKEFOURCC('F','R','M','E')
 
@@ -33,6 +43,234 @@
 
 #define DEFAULT_ALIGNMENT_SIZE 64
 
+#define SLAB_PAGE_SIZE  (2 * 1024 * 1024)
+// smaller buffers are allocated from the heap
+#define SLAB_MIN_BUFFER (256 * 1024)
+
+// prefers the node for pages of the buffer which are not touched yet
+static void BindToNumaNode(mfxU8 *ptr, size_t size, mfxI32 node)
+{
+#if defined(__linux__) && defined(SYS_mbind)
+    const int MPOL_PREFERRED_ = 1;
+    const size_t page = (size_t)sysconf(_SC_PAGESIZE);
+
+    if (node < 0 || node >= 64 || !page)
+        return;
+
+    // only whole pages of the buffer, not to affect neighbour allocations
+    size_t begin = ((size_t)ptr + page - 1) & ~(page - 1);
+    size_t end   = ((size_t)ptr + size) & ~(page - 1);
+    if (end <= begin)
+        return;
+
+    unsigned long nodeMask = 1ul << node;
+    // failure is not fatal, memory is just allocated by the default policy
+    syscall(SYS_mbind, begin, end - begin, MPOL_PREFERRED_, &nodeMask, sizeof(nodeMask) * 8, 0);
+#else
+    (void)ptr;
+    (void)size;
+    (void)node;
+#endif
+}
+
+static mfxU8* MapSlab(size_t size)
+{
+#if defined(__linux__)
+    void *ptr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (ptr != MAP_FAILED)
+        return (mfxU8 *)ptr;
+
+    // no reserved huge pages, map 2MB aligned range and let transparent huge pages back it
+    size_t mapSize = size + SLAB_PAGE_SIZE;
+    ptr = mmap(NULL, mapSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ptr == MAP_FAILED)
+        return NULL;
+
+    mfxU8 *raw  = (mfxU8 *)ptr;
+    mfxU8 *base = (mfxU8 *)(((size_t)raw + SLAB_PAGE_SIZE - 1) & ~(size_t)(SLAB_PAGE_SIZE - 1));
+    if (base > raw)
+        munmap(raw, base - raw);
+    if (raw + mapSize > base + size)
+        munmap(base + size, raw + mapSize - (base + size));
+#if defined(MADV_HUGEPAGE)
+    madvise(base, size, MADV_HUGEPAGE);
+#endif
+    return base;
+#else
+    return (mfxU8 *)malloc(size);
+#endif
+}
+
+static void UnmapSlab(mfxU8 *ptr, size_t size)
+{
+#if defined(__linux__)
+    munmap(ptr, size);
+#else
+    (void)size;
+    free(ptr);
+#endif
+}
+
+static size_t GetBufferAllocSize(mfxU32 nbytes)
+{
+    return ALIGN32(sizeof(mfxDefaultAllocator::BufferStruct)) + nbytes + DEFAULT_ALIGNMENT_SIZE;
+}
+
+mfxSlabPool::mfxSlabPool()
+{
+}
+
+mfxSlabPool::~mfxSlabPool()
+{
+    for (Slab &slab : m_slabs)
+    {
+        if (slab.base)
+            UnmapSlab(slab.base, slab.size);
+    }
+}
+
+// free block of at least the size, at most a quarter bigger
+std::multimap<size_t, mfxU8*>::iterator mfxSlabPool::FindFree(size_t size)
+{
+    auto it = m_free.lower_bound(size);
+    if (it != m_free.end() && it->first <= size + size / 4)
+        return it;
+    return m_free.end();
+}
+
+size_t mfxSlabPool::CountFree(size_t size)
+{
+    size_t count = std::distance(m_free.lower_bound(size), m_free.upper_bound(size + size / 4));
+
+    for (const Slab &slab : m_slabs)
+    {
+        if (slab.base)
+            count += (slab.size - slab.used) / size;
+    }
+    return count;
+}
+
+bool mfxSlabPool::AddSlab(size_t size, mfxI32 numaNode)
+{
+    size = (size + SLAB_PAGE_SIZE - 1) & ~(size_t)(SLAB_PAGE_SIZE - 1);
+
+    mfxU8 *base = MapSlab(size);
+    if (!base)
+        return false;
+
+    // pages are not touched yet
+    BindToNumaNode(base, size, numaNode);
+
+    Slab slab = { base, size, 0, 0 };
+
+    // blocks refer to slabs by index, so released entries are reused instead of erased
+    auto it = std::find_if(m_slabs.begin(), m_slabs.end(), [](const Slab &s) { return !s.base; });
+    if (it != m_slabs.end())
+        *it = slab;
+    else
+        m_slabs.push_back(slab);
+
+    return true;
+}
+
+void mfxSlabPool::ReleaseIdleSlabs()
+{
+    for (size_t i = 0; i < m_slabs.size(); i++)
+    {
+        Slab &slab = m_slabs[i];
+        if (!slab.base || slab.live)
+            continue;
+
+        for (auto it = m_free.begin(); it != m_free.end();)
+        {
+            auto block = m_blocks.find(it->second);
+            if (block != m_blocks.end() && block->second.slab == i)
+            {
+                m_blocks.erase(block);
+                it = m_free.erase(it);
+            }
+            else
+                ++it;
+        }
+
+        UnmapSlab(slab.base, slab.size);
+        slab = Slab();
+    }
+}
+
+mfxU8* mfxSlabPool::Carve(size_t size)
+{
+    for (size_t i = m_slabs.size(); i-- > 0;)
+    {
+        Slab &slab = m_slabs[i];
+        if (!slab.base || slab.size - slab.used < size)
+            continue;
+
+        mfxU8 *ptr = slab.base + slab.used;
+        slab.used += size;
+        slab.live++;
+
+        Block block = { size, i };
+        m_blocks[ptr] = block;
+        return ptr;
+    }
+    return NULL;
+}
+
+void mfxSlabPool::Reserve(size_t size, mfxU32 count, mfxI32 numaNode)
+{
+    std::lock_guard<std::mutex> guard(m_guard);
+
+    size = (size + DEFAULT_ALIGNMENT_SIZE - 1) & ~(size_t)(DEFAULT_ALIGNMENT_SIZE - 1);
+    if (CountFree(size) >= count)
+        return;
+
+    // the request can't be served by slabs in use, so idle ones are stale
+    ReleaseIdleSlabs();
+
+    size_t available = CountFree(size);
+    if (available < count)
+        AddSlab((count - available) * size, numaNode);
+}
+
+mfxU8* mfxSlabPool::Alloc(size_t size, mfxI32 numaNode)
+{
+    std::lock_guard<std::mutex> guard(m_guard);
+
+    size = (size + DEFAULT_ALIGNMENT_SIZE - 1) & ~(size_t)(DEFAULT_ALIGNMENT_SIZE - 1);
+
+    auto it = FindFree(size);
+    if (it != m_free.end())
+    {
+        mfxU8 *ptr = it->second;
+        m_free.erase(it);
+        m_slabs[m_blocks[ptr].slab].live++;
+        return ptr;
+    }
+
+    mfxU8 *ptr = Carve(size);
+    if (!ptr)
+    {
+        ReleaseIdleSlabs();
+        if (AddSlab(size, numaNode))
+            ptr = Carve(size);
+    }
+    return ptr;
+}
+
+bool mfxSlabPool::Free(mfxU8 *ptr)
+{
+    std::lock_guard<std::mutex> guard(m_guard);
+
+    auto it = m_blocks.find(ptr);
+    if (it == m_blocks.end())
+        return false;
+
+    m_slabs[it->second.slab].live--;
+    m_free.insert(std::make_pair(it->second.size, ptr));
+    return true;
+}
+
 // Implementation of Internal allocators
 mfxStatus mfxDefaultAllocator::AllocBuffer(mfxHDL pthis, mfxU32 nbytes, mfxU16 type, mfxHDL *mid)
 {
@@ -41,10 +279,21 @@ mfxStatus mfxDefaultAllocator::AllocBuffer(mfxHDL pthis, mfxU32 nbytes, mfxU16 t
     if(!mid)
         return MFX_ERR_NULL_PTR;
     mfxU32 header_size = ALIGN32(sizeof(BufferStruct));
-    mfxU8 *buffer_ptr=(mfxU8 *)malloc(header_size + nbytes + DEFAULT_ALIGNMENT_SIZE);
+    size_t alloc_size = GetBufferAllocSize(nbytes);
+    mfxWideBufferAllocator* pBA = (mfxWideBufferAllocator*)pthis;
+    mfxU8 *buffer_ptr = NULL;
+
+    if (alloc_size >= SLAB_MIN_BUFFER)
+        buffer_ptr = pBA->pool.Alloc(alloc_size, pBA->numaNode);
 
     if (!buffer_ptr)
-        return MFX_ERR_MEMORY_ALLOC;
+    {
+        buffer_ptr = (mfxU8 *)malloc(alloc_size);
+        if (!buffer_ptr)
+            return MFX_ERR_MEMORY_ALLOC;
+
+        BindToNumaNode(buffer_ptr, alloc_size, pBA->numaNode);
+    }
 
     memset(buffer_ptr, 0, header_size + nbytes);
 
@@ -56,7 +305,6 @@ mfxStatus mfxDefaultAllocator::AllocBuffer(mfxHDL pthis, mfxU32 nbytes, mfxU16 t
 
     // save index
     {
-        mfxWideBufferAllocator* pBA = (mfxWideBufferAllocator*)pthis;
         pBA->m_bufHdl.push_back(bs);
         *mid = (mfxHDL) pBA->m_bufHdl.size();
     }
@@ -138,7 +386,8 @@ mfxStatus mfxDefaultAllocator::FreeBuffer(mfxHDL pthis, mfxMemId mid)
             return MFX_ERR_INVALID_HANDLE;
         if (bs->id!=ID_BUFFER)
             return MFX_ERR_INVALID_HANDLE;
-        free(bs);
+        if (!pBA->pool.Free((mfxU8 *)bs))
+            free(bs);
         return MFX_ERR_NONE;
     }
     catch (...)
@@ -168,7 +417,7 @@ mfxStatus mfxDefaultAllocator::AllocFrames(mfxHDL pthis, mfxFrameAllocRequest *r
         }
     }
 
-    mfxU32 Pitch=ALIGN32(request->Info.Width);
+    mfxU32 Pitch=ALIGN64(request->Info.Width);
     mfxU32 Height2=ALIGN32(request->Info.Height);
     mfxU32 nbytes;
     // Decoders and Encoders use YV12 and NV12 only
@@ -183,11 +432,11 @@ mfxStatus mfxDefaultAllocator::AllocFrames(mfxHDL pthis, mfxFrameAllocRequest *r
 #if (MFX_VERSION >= 1031)
     case MFX_FOURCC_P016:
 #endif
-        Pitch=ALIGN32(request->Info.Width*2);
+        Pitch=ALIGN64(request->Info.Width*2);
         nbytes=Pitch*Height2 + (Pitch>>1)*(Height2>>1) + (Pitch>>1)*(Height2>>1);
         break;
     case MFX_FOURCC_P210:
-        Pitch=ALIGN32(request->Info.Width*2);
+        Pitch=ALIGN64(request->Info.Width*2);
         nbytes=Pitch*Height2 + (Pitch>>1)*(Height2) + (Pitch>>1)*(Height2);
         break;
     case MFX_FOURCC_YUY2:
@@ -243,19 +492,19 @@ mfxStatus mfxDefaultAllocator::AllocFrames(mfxHDL pthis, mfxFrameAllocRequest *r
 #if (MFX_VERSION >= 1031)
     case MFX_FOURCC_Y216:
 #endif
-        Pitch=ALIGN32(request->Info.Width*2);
+        Pitch=ALIGN64(request->Info.Width)*2;
         nbytes=Pitch*Height2 + (Pitch>>1)*(Height2) + (Pitch>>1)*(Height2);
         break;
 
     case MFX_FOURCC_Y410:
-        Pitch=ALIGN32(request->Info.Width*4);
+        Pitch=ALIGN64(request->Info.Width)*4;
         nbytes=Pitch*Height2;
         break;
 #endif
 
 #if (MFX_VERSION >= 1031)
     case MFX_FOURCC_Y416:
-        Pitch=ALIGN32(request->Info.Width*8);
+        Pitch=ALIGN64(request->Info.Width)*8;
         nbytes=Pitch*Height2;
         break;
 #endif
@@ -266,10 +515,16 @@ mfxStatus mfxDefaultAllocator::AllocFrames(mfxHDL pthis, mfxFrameAllocRequest *r
 
     // allocate frames in cycle
     maxNumFrames = request->NumFrameSuggested;
+
+    // carve all frames out of the same slabs
+    size_t alloc_size = GetBufferAllocSize(nbytes + ALIGN64(sizeof(FrameStruct)));
+    if (alloc_size >= SLAB_MIN_BUFFER)
+        pSelf->wbufferAllocator.pool.Reserve(alloc_size, maxNumFrames, pSelf->wbufferAllocator.numaNode);
+
     pSelf->m_frameHandles.resize(request->NumFrameSuggested);
     for (numAllocated = 0; numAllocated < maxNumFrames; numAllocated += 1)
     {
-        mfxStatus sts = (pSelf->wbufferAllocator.bufferAllocator.Alloc)(pSelf->wbufferAllocator.bufferAllocator.pthis, nbytes + ALIGN32(sizeof(FrameStruct)), request->Type, &pSelf->m_frameHandles[numAllocated]);
+        mfxStatus sts = (pSelf->wbufferAllocator.bufferAllocator.Alloc)(pSelf->wbufferAllocator.bufferAllocator.pthis, nbytes + ALIGN64(sizeof(FrameStruct)), request->Type, &pSelf->m_frameHandles[numAllocated]);
         if (ERROR_STATUS(sts)) break;
 
         FrameStruct *fs;
@@ -314,11 +569,11 @@ mfxStatus mfxDefaultAllocator::LockFrame(mfxHDL pthis, mfxHDL mid, mfxFrameData
 
     //ptr->MemId = mid; !!!!!!!!!!!!!!!!!!!!!!!!!
     mfxU32 Height2=ALIGN32(fs->info.Height);
-    mfxU8 *sptr = (mfxU8 *)fs+ALIGN32(sizeof(FrameStruct));
+    mfxU8 *sptr = (mfxU8 *)fs+ALIGN64(sizeof(FrameStruct));
     switch (fs->info.FourCC) {
     case MFX_FOURCC_NV12:
         ptr->PitchHigh=0;
-        ptr->PitchLow=(mfxU16)ALIGN32(fs->info.Width);
+        ptr->PitchLow=(mfxU16)ALIGN64(fs->info.Width);
         ptr->Y = sptr;
         ptr->U = ptr->Y + ptr->Pitch*Height2;
         ptr->V = ptr->U + 1;
@@ -328,21 +583,21 @@ mfxStatus mfxDefaultAllocator::LockFrame(mfxHDL pthis, mfxHDL mid, mfxFrameData
     case MFX_FOURCC_P016:
 #endif
         ptr->PitchHigh=0;
-        ptr->PitchLow=(mfxU16)ALIGN32(fs->info.Width*2);
+        ptr->PitchLow=(mfxU16)ALIGN64(fs->info.Width*2);
         ptr->Y = sptr;
         ptr->U = ptr->Y + ptr->Pitch*Height2;
         ptr->V = ptr->U + 2;
         break;
     case MFX_FOURCC_P210:
         ptr->PitchHigh=0;
-        ptr->PitchLow=(mfxU16)ALIGN32(fs->info.Width*2);
+        ptr->PitchLow=(mfxU16)ALIGN64(fs->info.Width*2);
         ptr->Y = sptr;
         ptr->U = ptr->Y + ptr->Pitch*Height2;
         ptr->V = ptr->U + 2;
         break;
     case MFX_FOURCC_YV12:
         ptr->PitchHigh=0;
-        ptr->PitchLow=(mfxU16)ALIGN32(fs->info.Width);
+        ptr->PitchLow=(mfxU16)ALIGN64(fs->info.Width);
         ptr->Y = sptr;
         ptr->V = ptr->Y + ptr->Pitch*Height2;
         ptr->U = ptr->V + (ptr->Pitch>>1)*(Height2>>1);
@@ -351,32 +606,32 @@ mfxStatus mfxDefaultAllocator::LockFrame(mfxHDL pthis, mfxHDL mid, mfxFrameData
         ptr->Y = sptr;
         ptr->U = ptr->Y + 1;
         ptr->V = ptr->Y + 3;
-        ptr->PitchHigh = (mfxU16)((2*ALIGN32(fs->info.Width)) / (1 << 16));
-        ptr->PitchLow  = (mfxU16)((2*ALIGN32(fs->info.Width)) % (1 << 16));
+        ptr->PitchHigh = (mfxU16)((2*ALIGN64(fs->info.Width)) / (1 << 16));
+        ptr->PitchLow  = (mfxU16)((2*ALIGN64(fs->info.Width)) % (1 << 16));
         break;
 #if defined (MFX_ENABLE_FOURCC_RGB565)
     case MFX_FOURCC_RGB565:
         ptr->B = sptr;
         ptr->G = ptr->B;
         ptr->R = ptr->B;
-        ptr->PitchHigh = (mfxU16)((2*ALIGN32(fs->info.Width)) >> 16);
-        ptr->PitchLow  = (mfxU16)((2*ALIGN32(fs->info.Width)) & 0xffff);
+        ptr->PitchHigh = (mfxU16)((2*ALIGN64(fs->info.Width)) >> 16);
+        ptr->PitchLow  = (mfxU16)((2*ALIGN64(fs->info.Width)) & 0xffff);
         break;
 #endif // MFX_ENABLE_FOURCC_RGB565
     case MFX_FOURCC_RGB3:
         ptr->B = sptr;
         ptr->G = ptr->B + 1;
         ptr->R = ptr->B + 2;
-        ptr->PitchHigh = (mfxU16)((3*ALIGN32(fs->info.Width)) / (1 << 16));
-        ptr->PitchLow  = (mfxU16)((3*ALIGN32(fs->info.Width)) % (1 << 16));
+        ptr->PitchHigh = (mfxU16)((3*ALIGN64(fs->info.Width)) / (1 << 16));
+        ptr->PitchLow  = (mfxU16)((3*ALIGN64(fs->info.Width)) % (1 << 16));
         break;
 #ifdef MFX_ENABLE_RGBP
     case MFX_FOURCC_RGBP:
         ptr->B = sptr;
         ptr->G = ptr->B + ptr->Pitch*Height2;
         ptr->R = ptr->B + 2*ptr->Pitch*Height2;;
-        ptr->PitchHigh = (mfxU16)((3*ALIGN32(fs->info.Width)) / (1 << 16));
-        ptr->PitchLow  = (mfxU16)((3*ALIGN32(fs->info.Width)) % (1 << 16));
+        ptr->PitchHigh = (mfxU16)((3*ALIGN64(fs->info.Width)) / (1 << 16));
+        ptr->PitchLow  = (mfxU16)((3*ALIGN64(fs->info.Width)) % (1 << 16));
         break;
 #endif
     case MFX_FOURCC_RGB4:
@@ -384,32 +639,32 @@ mfxStatus mfxDefaultAllocator::LockFrame(mfxHDL pthis, mfxHDL mid, mfxFrameData
         ptr->G = ptr->B + 1;
         ptr->R = ptr->B + 2;
         ptr->A = ptr->B + 3;
-        ptr->PitchHigh = (mfxU16)((4*ALIGN32(fs->info.Width)) / (1 << 16));
-        ptr->PitchLow  = (mfxU16)((4*ALIGN32(fs->info.Width)) % (1 << 16));
+        ptr->PitchHigh = (mfxU16)((4*ALIGN64(fs->info.Width)) / (1 << 16));
+        ptr->PitchLow  = (mfxU16)((4*ALIGN64(fs->info.Width)) % (1 << 16));
         break;
     case MFX_FOURCC_BGR4:
         ptr->R = sptr;
         ptr->G = ptr->R + 1;
         ptr->B = ptr->R + 2;
         ptr->A = ptr->R + 3;
-        ptr->PitchHigh = (mfxU16)((4 * ALIGN32(fs->info.Width)) / (1 << 16));
-        ptr->PitchLow = (mfxU16)((4 * ALIGN32(fs->info.Width)) % (1 << 16));
+        ptr->PitchHigh = (mfxU16)((4 * ALIGN64(fs->info.Width)) / (1 << 16));
+        ptr->PitchLow = (mfxU16)((4 * ALIGN64(fs->info.Width)) % (1 << 16));
         break;
     case MFX_FOURCC_A2RGB10:
         ptr->R = ptr->G = ptr->B = ptr->A = sptr;
-        ptr->PitchHigh = (mfxU16)((4*ALIGN32(fs->info.Width)) / (1 << 16));
-        ptr->PitchLow  = (mfxU16)((4*ALIGN32(fs->info.Width)) % (1 << 16));
+        ptr->PitchHigh = (mfxU16)((4*ALIGN64(fs->info.Width)) / (1 << 16));
+        ptr->PitchLow  = (mfxU16)((4*ALIGN64(fs->info.Width)) % (1 << 16));
         break;
     case MFX_FOURCC_P8:
         ptr->PitchHigh=0;
-        ptr->PitchLow=(mfxU16)ALIGN32(fs->info.Width);
+        ptr->PitchLow=(mfxU16)ALIGN64(fs->info.Width);
         ptr->Y = sptr;
         ptr->U = 0;
         ptr->V = 0;
         break;
     case MFX_FOURCC_AYUV:
-        ptr->PitchHigh = (mfxU16)((4 * ALIGN32(fs->info.Width)) / (1 << 16));
-        ptr->PitchLow  = (mfxU16)((4 * ALIGN32(fs->info.Width)) % (1 << 16));
+        ptr->PitchHigh = (mfxU16)((4 * ALIGN64(fs->info.Width)) / (1 << 16));
+        ptr->PitchLow  = (mfxU16)((4 * ALIGN64(fs->info.Width)) % (1 << 16));
         ptr->V = sptr;
         ptr->U = ptr->V + 1;
         ptr->Y = ptr->V + 2;
@@ -420,16 +675,16 @@ mfxStatus mfxDefaultAllocator::LockFrame(mfxHDL pthis, mfxHDL mid, mfxFrameData
 #if (MFX_VERSION >= 1031)
     case MFX_FOURCC_Y216:
 #endif
-        ptr->PitchHigh = (mfxU16)((4 * ALIGN32(fs->info.Width)) / (1 << 16));
-        ptr->PitchLow  = (mfxU16)((4 * ALIGN32(fs->info.Width)) % (1 << 16));
+        ptr->PitchHigh = (mfxU16)((4 * ALIGN64(fs->info.Width)) / (1 << 16));
+        ptr->PitchLow  = (mfxU16)((4 * ALIGN64(fs->info.Width)) % (1 << 16));
         ptr->Y16 = (mfxU16*)sptr;
         ptr->U16 = ptr->Y16 + 1;
         ptr->V16 = ptr->Y16 + 3;
         break;
 
     case MFX_FOURCC_Y410:
-        ptr->PitchHigh = (mfxU16)((4 * ALIGN32(fs->info.Width)) / (1 << 16));
-        ptr->PitchLow  = (mfxU16)((4 * ALIGN32(fs->info.Width)) % (1 << 16));
+        ptr->PitchHigh = (mfxU16)((4 * ALIGN64(fs->info.Width)) / (1 << 16));
+        ptr->PitchLow  = (mfxU16)((4 * ALIGN64(fs->info.Width)) % (1 << 16));
         ptr->Y = ptr->U = ptr->V = ptr->A = 0;
         ptr->Y410 = (mfxY410*)sptr;
         break;
@@ -437,8 +692,8 @@ mfxStatus mfxDefaultAllocator::LockFrame(mfxHDL pthis, mfxHDL mid, mfxFrameData
 
 #if (MFX_VERSION >= 1031)
     case MFX_FOURCC_Y416:
-        ptr->PitchHigh = (mfxU16)(8 * ALIGN32(fs->info.Width) / (1 << 16));
-        ptr->PitchLow  = (mfxU16)(8 * ALIGN32(fs->info.Width) % (1 << 16));
+        ptr->PitchHigh = (mfxU16)(8 * ALIGN64(fs->info.Width) / (1 << 16));
+        ptr->PitchLow  = (mfxU16)(8 * ALIGN64(fs->info.Width) % (1 << 16));
         ptr->U16 = (mfxU16*)sptr;
         ptr->Y16 = ptr->U16 + 1;
         ptr->V16 = ptr->Y16 + 1;
@@ -512,6 +767,7 @@ mfxWideBufferAllocator::mfxWideBufferAllocator()
     bufferAllocator.Free = &mfxDefaultAllocator::FreeBuffer;
 
     bufferAllocator.pthis = 0;
+    numaNode = -1;
 }
 
 mfxWideBufferAllocator::~mfxWideBufferAllocator()
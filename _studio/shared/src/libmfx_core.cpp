@@ -32,6 +32,7 @@
 #include "mfx_umc_alloc_wrapper.h"
 
 #include "vm_sys_info.h"
+#include "vm_time.h"
 
 using namespace std;
 //
@@ -658,7 +659,11 @@ CommonCORE::CommonCORE(const mfxU32 numThreadsAvailable, const mfxSession sessio
     m_CoreId(0),
     m_pWrp(NULL),
     m_API_1_19(this),
-    m_deviceId(0)
+    m_deviceId(0),
+    m_frameDeadline(0),
+    m_deadlineBaseTick(0),
+    m_deadlineBaseTimeStamp(0),
+    m_deadlineLastTimeStamp(0)
 {
     m_bufferAllocator.bufferAllocator.pthis = &m_bufferAllocator;
     CheckTimingLog();
@@ -775,6 +780,53 @@ mfxStatus CommonCORE::QueryPlatform(mfxPlatform* platform)
     return MFX_ERR_NONE;
 } // mfxStatus CommonCORE::QueryPlatform(mfxPlatform* platform)
 
+void CommonCORE::SetFrameDeadline(mfxU32 deadline)
+{
+    UMC::AutomaticUMCMutex guard(m_guard);
+
+    m_frameDeadline = (mfxU64)deadline * vm_time_get_frequency() / 1000000;
+    m_deadlineBaseTick = 0;
+
+} // void CommonCORE::SetFrameDeadline(mfxU32 deadline)
+
+mfxU64 CommonCORE::GetTaskDeadline(mfxU64 timeStamp)
+{
+    // lock-free check for sessions without deadlines,
+    // the value is read again under the guard as it may be reset meanwhile
+    if (!m_frameDeadline.load(std::memory_order_relaxed))
+        return 0;
+
+    UMC::AutomaticUMCMutex guard(m_guard);
+
+    const mfxU64 frameDeadline = m_frameDeadline;
+    if (!frameDeadline)
+        return 0;
+
+    const mfxU64 now = vm_time_get_tick();
+    const mfxU64 freq = vm_time_get_frequency();
+
+    // frames without time stamps are due since submission
+    if (MFX_TIME_STAMP_INVALID == timeStamp || (m_deadlineBaseTick && timeStamp == m_deadlineLastTimeStamp))
+        return now + frameDeadline;
+    m_deadlineLastTimeStamp = timeStamp;
+
+    // time stamps are in 90KHz units, the first frame is due right now
+    mfxI64 offset = (mfxI64)(timeStamp - m_deadlineBaseTimeStamp);
+    mfxI64 tick = (mfxI64)(m_deadlineBaseTick - now) + offset * (mfxI64)freq / MFX_TIME_STAMP_FREQUENCY;
+
+    // re-anchor on the first frame and on time stamp discontinuities,
+    // which are more than a second away from the wall clock
+    if (!m_deadlineBaseTick || tick > (mfxI64)freq || tick < -(mfxI64)freq)
+    {
+        m_deadlineBaseTick = now;
+        m_deadlineBaseTimeStamp = timeStamp;
+        tick = 0;
+    }
+
+    return now + tick + frameDeadline;
+
+} // mfxU64 CommonCORE::GetTaskDeadline(mfxU64 timeStamp)
+
 mfxStatus CommonCORE::SetBufferAllocator(mfxBufferAllocator *allocator)
 {
     UMC::AutomaticUMCMutex guard(m_guard);
@@ -28,9 +28,59 @@
 #include "vm_interlocked.h"
 #include <assert.h>
 #include <iterator>
+#include <algorithm>
+#include <chrono>
 
 #define CTX(dpy) (((VADisplayContextP)dpy)->pDriverContext)
 
+static inline long long GetTimeUs()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+MFEAdaptiveBatchPolicy::MFEAdaptiveBatchPolicy() :
+      m_lastArrival(-1)
+    , m_avgInterval(-1)
+    , m_misses(0)
+{
+}
+
+void MFEAdaptiveBatchPolicy::OnFrameArrival(long long now)
+{
+    if (m_lastArrival >= 0)
+    {
+        long long interval = now - m_lastArrival;
+        //new interval has 1/8 weight, enough to follow streams joining/leaving in few frames
+        m_avgInterval = m_avgInterval < 0 ? interval : m_avgInterval + (interval - m_avgInterval) / 8;
+    }
+    m_lastArrival = now;
+}
+
+long long MFEAdaptiveBatchPolicy::GetWaitTime(mfxU32 framesMissing, long long budget)
+{
+    //no statistics yet - wait whole budget as fixed policy does
+    if (!framesMissing || budget <= 0 || m_avgInterval < 0)
+        return budget;
+
+    long long expected = framesMissing * m_avgInterval;
+
+    //if batch is not expected to be filled in budget - give a chance to one more frame only
+    //instead of holding live stream for the whole budget, otherwise add margin for arrival
+    //jitter, wait is interrupted anyway as soon as batch is filled
+    long long wait = std::min(budget, expected > budget ? m_avgInterval : 2 * expected);
+
+    return wait >> std::min<mfxU32>(m_misses, 3);
+}
+
+void MFEAdaptiveBatchPolicy::OnSubmit(mfxU32 framesSubmitted, mfxU32 framesExpected)
+{
+    if (framesSubmitted < framesExpected)
+        m_misses++;
+    else
+        m_misses = 0;
+}
+
 
 MFEVAAPIEncoder::MFEVAAPIEncoder() :
       m_refCounter(1)
@@ -40,6 +90,8 @@ MFEVAAPIEncoder::MFEVAAPIEncoder() :
     , m_maxFramesToCombine(0)
     , m_framesCollected(0)
     , m_minTimeToWait(0)
+    , m_policy(new MFEFixedBatchPolicy)
+    , m_stat()
 {
     m_contexts.reserve(MAX_FRAMES_TO_COMBINE);
     m_streams.reserve(MAX_FRAMES_TO_COMBINE);
@@ -190,12 +242,14 @@ mfxStatus MFEVAAPIEncoder::Disjoin(VAContextID ctx)
     std::lock_guard<std::mutex> guard(m_mfe_guard);//need to protect in case there are streams added/removed in runtime
     std::map<VAContextID, StreamsIter_t>::iterator iter = m_streamsMap.find(ctx);
 
-    VAStatus vaSts = vaMFReleaseContext(m_vaDisplay, m_mfe_context, ctx);
-
+    //context which wasn't joined is not passed to the driver
     if(iter == m_streamsMap.end())
     {
         return MFX_ERR_UNDEFINED_BEHAVIOR;
     }
+
+    VAStatus vaSts = vaMFReleaseContext(m_vaDisplay, m_mfe_context, ctx);
+
     m_streams_pool.erase(iter->second);
     m_streamsMap.erase(iter);
     if (m_framesToCombine > 0 && m_framesToCombine >= m_maxFramesToCombine)
@@ -289,6 +343,9 @@ mfxStatus MFEVAAPIEncoder::Submit(VAContextID context, long long timeToWait, boo
         return MFX_ERR_NONE;
     }
     ++m_framesCollected;
+    cur_stream->arrivalTime = GetTimeUs();
+    m_policy->OnFrameArrival(cur_stream->arrivalTime);
+
     if (m_streams_pool.empty())
     {
         //if streams are over in a pool - submit available frames
@@ -303,7 +360,10 @@ mfxStatus MFEVAAPIEncoder::Submit(VAContextID context, long long timeToWait, boo
     {
         return MFX_ERR_UNDEFINED_BEHAVIOR;
     }
-    m_mfe_wait.wait_for(guard, std::chrono::microseconds(timeToWait), [this, framesToSubmit, cur_stream] {
+    long long timeout = m_policy->GetWaitTime(
+        m_framesCollected < framesToSubmit ? framesToSubmit - m_framesCollected : 0, timeToWait);
+
+    m_mfe_wait.wait_for(guard, std::chrono::microseconds(timeout), [this, framesToSubmit, cur_stream] {
         return (m_framesCollected >= framesToSubmit) || cur_stream->isFrameSubmitted();
     });
 
@@ -337,6 +397,7 @@ mfxStatus MFEVAAPIEncoder::Submit(VAContextID context, long long timeToWait, boo
                                          &m_contexts[0], m_contexts.size());
             
             mfxStatus tmp_res = VA_STATUS_SUCCESS == vaSts ? MFX_ERR_NONE : MFX_ERR_DEVICE_FAILED;
+            updateBatchStat(framesToSubmit, GetTimeUs());
             for (std::vector<StreamsIter_t>::iterator it = m_streams.begin();
                  it != m_streams.end(); ++it)
             {
@@ -360,4 +421,35 @@ mfxStatus MFEVAAPIEncoder::Submit(VAContextID context, long long timeToWait, boo
     return res;
 }
 
+void MFEVAAPIEncoder::updateBatchStat(mfxU32 framesExpected, long long now)
+{
+    //used in Submit function which already covered by mutex
+    m_stat.NumSubmissions++;
+    m_stat.NumFramesSubmitted += m_streams.size();
+    m_stat.NumFramesExpected += framesExpected;
+    if (m_streams.size() < framesExpected)
+        m_stat.NumTimeouts++;
+
+    m_policy->OnSubmit((mfxU32)m_streams.size(), framesExpected);
+
+    for (std::vector<StreamsIter_t>::iterator it = m_streams.begin(); it != m_streams.end(); ++it)
+    {
+        mfxU64 waited = (mfxU64)std::max(0LL, now - (*it)->arrivalTime);
+        m_stat.TotalWaitTime += waited;
+        m_stat.MaxWaitTime = std::max(m_stat.MaxWaitTime, waited);
+    }
+}
+
+void MFEVAAPIEncoder::SetBatchPolicy(MFEBatchPolicy* policy)
+{
+    std::lock_guard<std::mutex> guard(m_mfe_guard);
+    m_policy.reset(policy ? policy : new MFEFixedBatchPolicy);
+}
+
+void MFEVAAPIEncoder::GetBatchStat(MFEBatchStat& stat)
+{
+    std::lock_guard<std::mutex> guard(m_mfe_guard);
+    stat = m_stat;
+}
+
 #endif //MFX_VA_LINUX && MFX_ENABLE_MFE
@@ -231,9 +231,15 @@
     #if defined(LINUX64)
         MSDK_STATIC_ASSERT_STRUCT_SIZE(mfxExtJPEGQuantTables      ,536  )
         MSDK_STATIC_ASSERT_STRUCT_SIZE(mfxExtJPEGHuffmanTables    ,840  )
+#if (MFX_VERSION >= MFX_VERSION_NEXT)
+        MSDK_STATIC_ASSERT_STRUCT_SIZE(mfxExtJPEGBatch            ,72   )
+#endif
     #elif defined(LINUX32)
         MSDK_STATIC_ASSERT_STRUCT_SIZE(mfxExtJPEGQuantTables      ,536  )
         MSDK_STATIC_ASSERT_STRUCT_SIZE(mfxExtJPEGHuffmanTables    ,840  )
+#if (MFX_VERSION >= MFX_VERSION_NEXT)
+        MSDK_STATIC_ASSERT_STRUCT_SIZE(mfxExtJPEGBatch            ,60   )
+#endif
     #endif
 #endif //defined (__MFX_JPEG_H__)
 
@@ -783,6 +789,11 @@
         MSDK_STATIC_ASSERT_STRUCT_OFFSET(mfxExtThreadsParam                 ,NumThread                     ,8    )
         MSDK_STATIC_ASSERT_STRUCT_OFFSET(mfxExtThreadsParam                 ,SchedulingType                ,12   )
         MSDK_STATIC_ASSERT_STRUCT_OFFSET(mfxExtThreadsParam                 ,Priority                      ,16   )
+#if (MFX_VERSION >= MFX_VERSION_NEXT)
+        MSDK_STATIC_ASSERT_STRUCT_OFFSET(mfxExtThreadsParam                 ,NumaNode                      ,20   )
+        MSDK_STATIC_ASSERT_STRUCT_OFFSET(mfxExtThreadsParam                 ,CpuMask                       ,24   )
+        MSDK_STATIC_ASSERT_STRUCT_OFFSET(mfxExtThreadsParam                 ,FrameDeadline                 ,88   )
+#endif
 
         MSDK_STATIC_ASSERT_STRUCT_OFFSET(mfxPlatform                        ,CodeName                      ,0    )
         MSDK_STATIC_ASSERT_STRUCT_OFFSET(mfxPlatform                        ,DeviceId                      ,2    )
@@ -821,6 +832,11 @@
         MSDK_STATIC_ASSERT_STRUCT_OFFSET(mfxExtThreadsParam                 ,NumThread                     ,8    )
         MSDK_STATIC_ASSERT_STRUCT_OFFSET(mfxExtThreadsParam                 ,SchedulingType                ,12   )
         MSDK_STATIC_ASSERT_STRUCT_OFFSET(mfxExtThreadsParam                 ,Priority                      ,16   )
+#if (MFX_VERSION >= MFX_VERSION_NEXT)
+        MSDK_STATIC_ASSERT_STRUCT_OFFSET(mfxExtThreadsParam                 ,NumaNode                      ,20   )
+        MSDK_STATIC_ASSERT_STRUCT_OFFSET(mfxExtThreadsParam                 ,CpuMask                       ,24   )
+        MSDK_STATIC_ASSERT_STRUCT_OFFSET(mfxExtThreadsParam                 ,FrameDeadline                 ,88   )
+#endif
 
         MSDK_STATIC_ASSERT_STRUCT_OFFSET(mfxPlatform                        ,CodeName                      ,0    )
         MSDK_STATIC_ASSERT_STRUCT_OFFSET(mfxPlatform                        ,DeviceId                      ,2    )
@@ -958,6 +974,9 @@
         MSDK_STATIC_ASSERT_STRUCT_OFFSET(mfxInfoMFX                         ,Interleaved                   ,110  )
         MSDK_STATIC_ASSERT_STRUCT_OFFSET(mfxInfoMFX                         ,Quality                       ,112  )
         MSDK_STATIC_ASSERT_STRUCT_OFFSET(mfxInfoMFX                         ,RestartInterval               ,114  )
+#if (MFX_VERSION >= MFX_VERSION_NEXT)
+        MSDK_STATIC_ASSERT_STRUCT_OFFSET(mfxInfoMFX                         ,OptimizeHuffman               ,116  )
+#endif
 
         MSDK_STATIC_ASSERT_STRUCT_OFFSET(mfxInfoVPP                         ,In                            ,32   )
         MSDK_STATIC_ASSERT_STRUCT_OFFSET(mfxInfoVPP                         ,Out                           ,100  )
@@ -1126,6 +1145,17 @@
 
         MSDK_STATIC_ASSERT_STRUCT_OFFSET(mfxVPPStat                         ,NumFrame                      ,64   )
         MSDK_STATIC_ASSERT_STRUCT_OFFSET(mfxVPPStat                         ,NumCachedFrame                ,68   )
+#if (MFX_VERSION >= MFX_VERSION_NEXT)
+        MSDK_STATIC_ASSERT_STRUCT_OFFSET(mfxEncodeStat                      ,NumDeadlineTask               ,0    )
+        MSDK_STATIC_ASSERT_STRUCT_OFFSET(mfxEncodeStat                      ,NumMissedDeadline             ,8    )
+        MSDK_STATIC_ASSERT_STRUCT_OFFSET(mfxEncodeStat                      ,MaxDeadlineLateness           ,16   )
+        MSDK_STATIC_ASSERT_STRUCT_OFFSET(mfxDecodeStat                      ,NumDeadlineTask               ,0    )
+        MSDK_STATIC_ASSERT_STRUCT_OFFSET(mfxDecodeStat                      ,NumMissedDeadline             ,8    )
+        MSDK_STATIC_ASSERT_STRUCT_OFFSET(mfxDecodeStat                      ,MaxDeadlineLateness           ,16   )
+        MSDK_STATIC_ASSERT_STRUCT_OFFSET(mfxVPPStat                         ,NumDeadlineTask               ,0    )
+        MSDK_STATIC_ASSERT_STRUCT_OFFSET(mfxVPPStat                         ,NumMissedDeadline             ,8    )
+        MSDK_STATIC_ASSERT_STRUCT_OFFSET(mfxVPPStat                         ,MaxDeadlineLateness           ,16   )
+#endif
 
         MSDK_STATIC_ASSERT_STRUCT_OFFSET(mfxExtVppAuxData                   ,Header                        ,0    )
         MSDK_STATIC_ASSERT_STRUCT_OFFSET(mfxExtVppAuxData                   ,SpatialComplexity             ,8    )
@@ -1751,6 +1781,9 @@
         MSDK_STATIC_ASSERT_STRUCT_OFFSET(mfxInfoMFX                         ,Interleaved                   ,110  )
         MSDK_STATIC_ASSERT_STRUCT_OFFSET(mfxInfoMFX                         ,Quality                       ,112  )
         MSDK_STATIC_ASSERT_STRUCT_OFFSET(mfxInfoMFX                         ,RestartInterval               ,114  )
+#if (MFX_VERSION >= MFX_VERSION_NEXT)
+        MSDK_STATIC_ASSERT_STRUCT_OFFSET(mfxInfoMFX                         ,OptimizeHuffman               ,116  )
+#endif
 
         MSDK_STATIC_ASSERT_STRUCT_OFFSET(mfxInfoVPP                         ,In                            ,32   )
         MSDK_STATIC_ASSERT_STRUCT_OFFSET(mfxInfoVPP                         ,Out                           ,100  )
@@ -1919,6 +1952,17 @@
 
         MSDK_STATIC_ASSERT_STRUCT_OFFSET(mfxVPPStat                         ,NumFrame                      ,64   )
         MSDK_STATIC_ASSERT_STRUCT_OFFSET(mfxVPPStat                         ,NumCachedFrame                ,68   )
+#if (MFX_VERSION >= MFX_VERSION_NEXT)
+        MSDK_STATIC_ASSERT_STRUCT_OFFSET(mfxEncodeStat                      ,NumDeadlineTask               ,0    )
+        MSDK_STATIC_ASSERT_STRUCT_OFFSET(mfxEncodeStat                      ,NumMissedDeadline             ,8    )
+        MSDK_STATIC_ASSERT_STRUCT_OFFSET(mfxEncodeStat                      ,MaxDeadlineLateness           ,16   )
+        MSDK_STATIC_ASSERT_STRUCT_OFFSET(mfxDecodeStat                      ,NumDeadlineTask               ,0    )
+        MSDK_STATIC_ASSERT_STRUCT_OFFSET(mfxDecodeStat                      ,NumMissedDeadline             ,8    )
+        MSDK_STATIC_ASSERT_STRUCT_OFFSET(mfxDecodeStat                      ,MaxDeadlineLateness           ,16   )
+        MSDK_STATIC_ASSERT_STRUCT_OFFSET(mfxVPPStat                         ,NumDeadlineTask               ,0    )
+        MSDK_STATIC_ASSERT_STRUCT_OFFSET(mfxVPPStat                         ,NumMissedDeadline             ,8    )
+        MSDK_STATIC_ASSERT_STRUCT_OFFSET(mfxVPPStat                         ,MaxDeadlineLateness           ,16   )
+#endif
 
         MSDK_STATIC_ASSERT_STRUCT_OFFSET(mfxExtVppAuxData                   ,Header                        ,0    )
         MSDK_STATIC_ASSERT_STRUCT_OFFSET(mfxExtVppAuxData                   ,SpatialComplexity             ,8    )
@@ -3204,6 +3248,14 @@
         MSDK_STATIC_ASSERT_STRUCT_OFFSET(mfxExtJPEGHuffmanTables            ,DCTables[0].Values            ,32   )
         MSDK_STATIC_ASSERT_STRUCT_OFFSET(mfxExtJPEGHuffmanTables            ,ACTables[0].Bits              ,128  )
         MSDK_STATIC_ASSERT_STRUCT_OFFSET(mfxExtJPEGHuffmanTables            ,ACTables[0].Values            ,144  )
+#if (MFX_VERSION >= MFX_VERSION_NEXT)
+
+        MSDK_STATIC_ASSERT_STRUCT_OFFSET(mfxExtJPEGBatch                    ,Header                        ,0    )
+        MSDK_STATIC_ASSERT_STRUCT_OFFSET(mfxExtJPEGBatch                    ,NumFrame                      ,14   )
+        MSDK_STATIC_ASSERT_STRUCT_OFFSET(mfxExtJPEGBatch                    ,Surfaces                      ,16   )
+        MSDK_STATIC_ASSERT_STRUCT_OFFSET(mfxExtJPEGBatch                    ,Bitstreams                    ,24   )
+        MSDK_STATIC_ASSERT_STRUCT_OFFSET(mfxExtJPEGBatch                    ,Quality                       ,32   )
+#endif
     #elif defined(LINUX32)
         MSDK_STATIC_ASSERT_STRUCT_OFFSET(mfxExtJPEGQuantTables              ,Header                        ,0    )
         MSDK_STATIC_ASSERT_STRUCT_OFFSET(mfxExtJPEGQuantTables              ,NumTable                      ,22   )
@@ -3216,6 +3268,14 @@
         MSDK_STATIC_ASSERT_STRUCT_OFFSET(mfxExtJPEGHuffmanTables            ,DCTables[0].Values            ,32   )
         MSDK_STATIC_ASSERT_STRUCT_OFFSET(mfxExtJPEGHuffmanTables            ,ACTables[0].Bits              ,128  )
         MSDK_STATIC_ASSERT_STRUCT_OFFSET(mfxExtJPEGHuffmanTables            ,ACTables[0].Values            ,144  )
+#if (MFX_VERSION >= MFX_VERSION_NEXT)
+
+        MSDK_STATIC_ASSERT_STRUCT_OFFSET(mfxExtJPEGBatch                    ,Header                        ,0    )
+        MSDK_STATIC_ASSERT_STRUCT_OFFSET(mfxExtJPEGBatch                    ,NumFrame                      ,14   )
+        MSDK_STATIC_ASSERT_STRUCT_OFFSET(mfxExtJPEGBatch                    ,Surfaces                      ,16   )
+        MSDK_STATIC_ASSERT_STRUCT_OFFSET(mfxExtJPEGBatch                    ,Bitstreams                    ,20   )
+        MSDK_STATIC_ASSERT_STRUCT_OFFSET(mfxExtJPEGBatch                    ,Quality                       ,24   )
+#endif
     #endif
 #endif //defined (__MFX_JPEG_H__)
 
@@ -22,6 +22,7 @@
 #define __UMC_COLOR_SPACE_CONVERSION_H__
 
 #include "umc_base_codec.h"
+#include "umc_color_space_conversion_kernels.h"
 
 namespace UMC
 {
@@ -30,8 +31,11 @@ class ColorSpaceConversion : public BaseCodec
 {
   DYNAMIC_CAST_DECL(ColorSpaceConversion, BaseCodec)
 public:
-  // Initialize codec with specified parameter(s)
-  virtual Status Init(BaseCodecParams *) { return UMC_OK; };
+  ColorSpaceConversion() : m_iThreads(1) {}
+
+  // Initialize codec with specified parameter(s),
+  // numThreads > 1 enables row-band threading of SIMD conversions
+  virtual Status Init(BaseCodecParams *init);
 
   // Convert next frame
   virtual Status GetFrame(MediaData *in, MediaData *out);
@@ -47,6 +51,12 @@ public:
 
 private:
   Status GetFrameInternal(MediaData *in, MediaData *out);
+  Status RunKernel(const ColorConvertKernelInfo *pKernel,
+                   const uint8_t *pSrc[3], int32_t pSrcStep[3],
+                   uint8_t *pDst[3], int32_t pDstStep[3],
+                   mfxSize size, int32_t srcBitDepth);
+
+  int32_t m_iThreads;
 };
 
 } // namespace UMC
@@ -0,0 +1,82 @@
+// Copyright (c) 2020 Intel Corporation
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __UMC_COLOR_SPACE_CONVERSION_KERNELS_H__
+#define __UMC_COLOR_SPACE_CONVERSION_KERNELS_H__
+
+#include "umc_defs.h"
+#include "umc_structures.h"
+
+namespace UMC
+{
+
+// All kernels share one signature so that a frame can be split into row bands.
+// Plane order follows the UMC ColorFormat plane order (Y, U, V or Y, UV).
+// roi is given in luma pixels. Odd width and height are allowed: chroma planes
+// have rounded up size (as UMC::VideoData allocates them) and the last packed
+// YUY2 macropixel of an odd row repeats the last luma sample.
+typedef void (*ColorConvertKernel)(const uint8_t *pSrc[3], const int32_t pSrcStep[3],
+                                   uint8_t *pDst[3], const int32_t pDstStep[3],
+                                   mfxSize roi, int32_t srcBitDepth);
+
+struct ColorConvertKernelInfo
+{
+    ColorFormat        srcFormat;
+    ColorFormat        dstFormat;
+    ColorConvertKernel func;
+    int32_t            srcHeightDiv[3]; // vertical subsampling of every source plane
+    int32_t            dstHeightDiv[3]; // vertical subsampling of every destination plane
+};
+
+// returns kernel for the pair of formats or NULL if there is no fast path;
+// AVX2 version is selected when supported by CPU
+const ColorConvertKernelInfo *GetColorConvertKernel(ColorFormat srcFormat, ColorFormat dstFormat);
+
+#define CC_KERNEL_DECL(name) \
+    void name(const uint8_t *pSrc[3], const int32_t pSrcStep[3], \
+              uint8_t *pDst[3], const int32_t pDstStep[3], mfxSize roi, int32_t srcBitDepth)
+
+#define CC_KERNEL_DECL_ALL(name) \
+    CC_KERNEL_DECL(name ## _C); \
+    CC_KERNEL_DECL(name ## _AVX2)
+
+// number of chroma samples or rows for 2x subsampled direction
+inline int32_t SubsampledSize(int32_t size)
+{
+    return (size + 1) / 2;
+}
+
+CC_KERNEL_DECL_ALL(cc_NV12_to_YUV420);
+CC_KERNEL_DECL_ALL(cc_YUV420_to_NV12);
+CC_KERNEL_DECL_ALL(cc_NV12_to_YUY2);
+CC_KERNEL_DECL_ALL(cc_YUV420_to_YUY2);
+CC_KERNEL_DECL_ALL(cc_YUV422_to_YUY2);
+CC_KERNEL_DECL_ALL(cc_YUY2_to_YUV420);
+CC_KERNEL_DECL_ALL(cc_YUY2_to_YUV422);
+CC_KERNEL_DECL_ALL(cc_P010_to_NV12);
+CC_KERNEL_DECL_ALL(cc_P010_to_YUV420);
+CC_KERNEL_DECL_ALL(cc_Y210_to_YUY2);
+CC_KERNEL_DECL_ALL(cc_AYUV_to_YUV444);
+
+#undef CC_KERNEL_DECL_ALL
+
+} // namespace UMC
+
+#endif /* __UMC_COLOR_SPACE_CONVERSION_KERNELS_H__ */
@@ -24,6 +24,10 @@
 #include "ippcc.h"
 #include "ippvc.h"
 
+#include <algorithm>
+#include <thread>
+#include <vector>
+
 using namespace UMC;
 
 template <class T> inline
@@ -154,6 +158,63 @@ int cc_IMC3_to_YUV420(const uint8_t *pSrc[3], int32_t pSrcStep[3], uint8_t *pDst
     return ippStsNoErr;
 }
 
+Status ColorSpaceConversion::Init(BaseCodecParams *init)
+{
+    m_iThreads = 1;
+    if (init && init->numThreads > 1)
+        m_iThreads = init->numThreads;
+
+    return UMC_OK;
+}
+
+// minimal band height which is worth a separate thread
+enum { MIN_ROWS_PER_BAND = 64 };
+
+// splits picture into bands of even number of rows and converts bands in parallel,
+// the last band also takes the odd last row if any
+
+Status ColorSpaceConversion::RunKernel(const ColorConvertKernelInfo *pKernel,
+                                       const uint8_t *pSrc[3], int32_t pSrcStep[3],
+                                       uint8_t *pDst[3], int32_t pDstStep[3],
+                                       mfxSize size, int32_t srcBitDepth)
+{
+    if (size.width <= 0 || size.height <= 0)
+        return UMC_ERR_INVALID_PARAMS;
+
+    int32_t numBands = std::min(m_iThreads, std::max(size.height / MIN_ROWS_PER_BAND, 1));
+    int32_t bandHeight = (size.height / numBands) & ~1;
+
+    auto runBand = [&](int32_t band)
+    {
+        int32_t y0 = band * bandHeight;
+        int32_t y1 = (band == numBands - 1) ? size.height : y0 + bandHeight;
+        const uint8_t *pSrcBand[3] = {};
+        uint8_t *pDstBand[3] = {};
+
+        for (int32_t i = 0; i < 3; i++)
+        {
+            if (pSrc[i])
+                pSrcBand[i] = pSrc[i] + (y0 / pKernel->srcHeightDiv[i]) * pSrcStep[i];
+            if (pDst[i])
+                pDstBand[i] = pDst[i] + (y0 / pKernel->dstHeightDiv[i]) * pDstStep[i];
+        }
+
+        mfxSize bandSize = {size.width, y1 - y0};
+        pKernel->func(pSrcBand, pSrcStep, pDstBand, pDstStep, bandSize, srcBitDepth);
+    };
+
+    std::vector<std::thread> workers;
+    for (int32_t band = 1; band < numBands; band++)
+        workers.emplace_back(runBand, band);
+
+    runBand(0);
+
+    for (auto &worker : workers)
+        worker.join();
+
+    return UMC_OK;
+}
+
 Status ColorSpaceConversion::GetFrame(MediaData *input, MediaData *output)
 {
     VideoData *in = DynamicCast<VideoData>(input);
@@ -272,6 +333,11 @@ Status ColorSpaceConversion::GetFrameInternal(MediaData *input, MediaData *outpu
   int32_t pYVUStep[3] = {pSrcStep[0], pSrcStep[2], pSrcStep[1]};
   int status;
 
+  const ColorConvertKernelInfo *pKernel = GetColorConvertKernel((srcFormat == YUV422A) ? YUV422 : srcFormat, dstFormat);
+  if (pKernel) {
+    return RunKernel(pKernel, pSrc, pSrcStep, pDst, pDstStep, srcSize, in->GetPlaneBitDepth(0));
+  }
+
   switch (srcFormat) {
   case IMC3:
     switch (dstFormat) {
@@ -0,0 +1,399 @@
+// Copyright (c) 2020 Intel Corporation
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "umc_color_space_conversion_kernels.h"
+
+#include <algorithm>
+#include <immintrin.h>
+
+namespace UMC
+{
+
+static inline void CopyRows_AVX2(const uint8_t *pSrc, int32_t srcStep, uint8_t *pDst, int32_t dstStep,
+                                 int32_t width, int32_t height)
+{
+    for (int32_t y = 0; y < height; y++)
+        std::copy(pSrc + y * srcStep, pSrc + y * srcStep + width, pDst + y * dstStep);
+}
+
+// splits 16 interleaved byte pairs into 16 first and 16 second bytes
+static inline void DeinterleaveUV_AVX2(__m256i uv, uint8_t *u, uint8_t *v)
+{
+    const __m256i mask = _mm256_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15,
+                                          0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15);
+    uv = _mm256_shuffle_epi8(uv, mask);
+    uv = _mm256_permute4x64_epi64(uv, 0xD8);
+    _mm_storeu_si128((__m128i *)u, _mm256_castsi256_si128(uv));
+    _mm_storeu_si128((__m128i *)v, _mm256_extracti128_si256(uv, 1));
+}
+
+static inline void DeinterleaveUVRow_AVX2(const uint8_t *uv, uint8_t *u, uint8_t *v, int32_t pairs)
+{
+    int32_t x = 0;
+    for (; x + 16 <= pairs; x += 16)
+        DeinterleaveUV_AVX2(_mm256_loadu_si256((const __m256i *)(uv + 2 * x)), u + x, v + x);
+    for (; x < pairs; x++)
+    {
+        u[x] = uv[2 * x + 0];
+        v[x] = uv[2 * x + 1];
+    }
+}
+
+// converts 32 16-bit samples to 8 bits with rounding and saturation
+static inline __m256i DownShift32_AVX2(const uint16_t *src, __m256i rnd, __m128i shift)
+{
+    const __m256i max8u = _mm256_set1_epi16(255);
+    __m256i a = _mm256_loadu_si256((const __m256i *)(src + 0));
+    __m256i b = _mm256_loadu_si256((const __m256i *)(src + 16));
+
+    a = _mm256_min_epu16(_mm256_srl_epi16(_mm256_adds_epu16(a, rnd), shift), max8u);
+    b = _mm256_min_epu16(_mm256_srl_epi16(_mm256_adds_epu16(b, rnd), shift), max8u);
+
+    return _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), 0xD8);
+}
+
+static inline uint8_t DownShift16u(uint16_t val, int32_t shift, int32_t rnd)
+{
+    uint32_t res = ((uint32_t)val + rnd) >> shift;
+    return (uint8_t)(res > 255 ? 255 : res);
+}
+
+static void DownShiftPlane_AVX2(const uint8_t *pSrc, int32_t srcStep, uint8_t *pDst, int32_t dstStep,
+                                int32_t samples, int32_t height, int32_t srcBitDepth)
+{
+    int32_t shift = srcBitDepth > 8 ? srcBitDepth - 8 : 0;
+    int32_t rnd = shift ? 1 << (shift - 1) : 0;
+    __m256i vrnd = _mm256_set1_epi16((int16_t)rnd);
+    __m128i vshift = _mm_cvtsi32_si128(shift);
+
+    for (int32_t y = 0; y < height; y++)
+    {
+        const uint16_t *src = (const uint16_t *)(pSrc + y * srcStep);
+        uint8_t *dst = pDst + y * dstStep;
+        int32_t x = 0;
+
+        for (; x + 32 <= samples; x += 32)
+            _mm256_storeu_si256((__m256i *)(dst + x), DownShift32_AVX2(src + x, vrnd, vshift));
+        for (; x < samples; x++)
+            dst[x] = DownShift16u(src[x], shift, rnd);
+    }
+}
+
+// packs 32 luma samples and 16 interleaved chroma pairs into YUY2
+static inline void PackYUY2_AVX2(const uint8_t *srcY, __m256i uv, uint8_t *dst)
+{
+    __m256i y  = _mm256_loadu_si256((const __m256i *)srcY);
+    __m256i lo = _mm256_unpacklo_epi8(y, uv);
+    __m256i hi = _mm256_unpackhi_epi8(y, uv);
+
+    _mm256_storeu_si256((__m256i *)(dst + 0),  _mm256_permute2x128_si256(lo, hi, 0x20));
+    _mm256_storeu_si256((__m256i *)(dst + 32), _mm256_permute2x128_si256(lo, hi, 0x31));
+}
+
+static inline void PackYUY2Row_AVX2(const uint8_t *srcY, const uint8_t *srcU, const uint8_t *srcV, uint8_t *dst, int32_t width)
+{
+    int32_t pairs = width / 2;
+    int32_t x = 0;
+
+    for (; x + 16 <= pairs; x += 16)
+    {
+        __m128i u = _mm_loadu_si128((const __m128i *)(srcU + x));
+        __m128i v = _mm_loadu_si128((const __m128i *)(srcV + x));
+        __m256i uv = _mm256_set_m128i(_mm_unpackhi_epi8(u, v), _mm_unpacklo_epi8(u, v));
+
+        PackYUY2_AVX2(srcY + 2 * x, uv, dst + 4 * x);
+    }
+    for (; x < pairs; x++)
+    {
+        dst[4 * x + 0] = srcY[2 * x + 0];
+        dst[4 * x + 1] = srcU[x];
+        dst[4 * x + 2] = srcY[2 * x + 1];
+        dst[4 * x + 3] = srcV[x];
+    }
+    if (width & 1)
+    {
+        dst[4 * x + 0] = dst[4 * x + 2] = srcY[2 * x];
+        dst[4 * x + 1] = srcU[x];
+        dst[4 * x + 3] = srcV[x];
+    }
+}
+
+static inline void UnpackYUY2Row_AVX2(const uint8_t *src, uint8_t *dstY, uint8_t *dstU, uint8_t *dstV, int32_t width)
+{
+    const __m256i maskYUV = _mm256_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, 1, 5, 9, 13, 3, 7, 11, 15,
+                                             0, 2, 4, 6, 8, 10, 12, 14, 1, 5, 9, 13, 3, 7, 11, 15);
+    const __m128i maskUV = _mm_setr_epi8(0, 1, 2, 3, 8, 9, 10, 11, 4, 5, 6, 7, 12, 13, 14, 15);
+    int32_t pairs = width / 2;
+    int32_t x = 0;
+
+    for (; x + 16 <= pairs; x += 16)
+    {
+        // after shuffle and permute: low lane is 16 Y, high lane is U0-3 V0-3 U4-7 V4-7
+        __m256i a = _mm256_loadu_si256((const __m256i *)(src + 4 * x));
+        __m256i b = _mm256_loadu_si256((const __m256i *)(src + 4 * x + 32));
+        a = _mm256_permute4x64_epi64(_mm256_shuffle_epi8(a, maskYUV), 0xD8);
+        b = _mm256_permute4x64_epi64(_mm256_shuffle_epi8(b, maskYUV), 0xD8);
+
+        _mm256_storeu_si256((__m256i *)(dstY + 2 * x), _mm256_permute2x128_si256(a, b, 0x20));
+
+        if (dstU)
+        {
+            __m128i ca = _mm_shuffle_epi8(_mm256_extracti128_si256(a, 1), maskUV);
+            __m128i cb = _mm_shuffle_epi8(_mm256_extracti128_si256(b, 1), maskUV);
+            _mm_storeu_si128((__m128i *)(dstU + x), _mm_unpacklo_epi64(ca, cb));
+            _mm_storeu_si128((__m128i *)(dstV + x), _mm_unpackhi_epi64(ca, cb));
+        }
+    }
+    for (; x < pairs; x++)
+    {
+        dstY[2 * x + 0] = src[4 * x + 0];
+        dstY[2 * x + 1] = src[4 * x + 2];
+        if (dstU)
+        {
+            dstU[x] = src[4 * x + 1];
+            dstV[x] = src[4 * x + 3];
+        }
+    }
+    if (width & 1)
+    {
+        dstY[2 * x] = src[4 * x + 0];
+        if (dstU)
+        {
+            dstU[x] = src[4 * x + 1];
+            dstV[x] = src[4 * x + 3];
+        }
+    }
+}
+
+CC_KERNEL_DECL(cc_NV12_to_YUV420_AVX2)
+{
+    (void)srcBitDepth;
+
+    CopyRows_AVX2(pSrc[0], pSrcStep[0], pDst[0], pDstStep[0], roi.width, roi.height);
+
+    for (int32_t y = 0; y < SubsampledSize(roi.height); y++)
+    {
+        DeinterleaveUVRow_AVX2(pSrc[1] + y * pSrcStep[1],
+                               pDst[1] + y * pDstStep[1],
+                               pDst[2] + y * pDstStep[2],
+                               SubsampledSize(roi.width));
+    }
+}
+
+CC_KERNEL_DECL(cc_YUV420_to_NV12_AVX2)
+{
+    (void)srcBitDepth;
+
+    CopyRows_AVX2(pSrc[0], pSrcStep[0], pDst[0], pDstStep[0], roi.width, roi.height);
+
+    for (int32_t y = 0; y < SubsampledSize(roi.height); y++)
+    {
+        const uint8_t *u = pSrc[1] + y * pSrcStep[1];
+        const uint8_t *v = pSrc[2] + y * pSrcStep[2];
+        uint8_t *uv = pDst[1] + y * pDstStep[1];
+        int32_t pairs = SubsampledSize(roi.width);
+        int32_t x = 0;
+
+        for (; x + 32 <= pairs; x += 32)
+        {
+            __m256i vu = _mm256_loadu_si256((const __m256i *)(u + x));
+            __m256i vv = _mm256_loadu_si256((const __m256i *)(v + x));
+            __m256i lo = _mm256_unpacklo_epi8(vu, vv);
+            __m256i hi = _mm256_unpackhi_epi8(vu, vv);
+
+            _mm256_storeu_si256((__m256i *)(uv + 2 * x + 0),  _mm256_permute2x128_si256(lo, hi, 0x20));
+            _mm256_storeu_si256((__m256i *)(uv + 2 * x + 32), _mm256_permute2x128_si256(lo, hi, 0x31));
+        }
+        for (; x < pairs; x++)
+        {
+            uv[2 * x + 0] = u[x];
+            uv[2 * x + 1] = v[x];
+        }
+    }
+}
+
+CC_KERNEL_DECL(cc_NV12_to_YUY2_AVX2)
+{
+    (void)srcBitDepth;
+
+    for (int32_t y = 0; y < roi.height; y++)
+    {
+        const uint8_t *srcY  = pSrc[0] + y * pSrcStep[0];
+        const uint8_t *srcUV = pSrc[1] + (y >> 1) * pSrcStep[1];
+        uint8_t *dst = pDst[0] + y * pDstStep[0];
+        int32_t pairs = roi.width / 2;
+        int32_t x = 0;
+
+        for (; x + 16 <= pairs; x += 16)
+            PackYUY2_AVX2(srcY + 2 * x, _mm256_loadu_si256((const __m256i *)(srcUV + 2 * x)), dst + 4 * x);
+        for (; x < pairs; x++)
+        {
+            dst[4 * x + 0] = srcY[2 * x + 0];
+            dst[4 * x + 1] = srcUV[2 * x + 0];
+            dst[4 * x + 2] = srcY[2 * x + 1];
+            dst[4 * x + 3] = srcUV[2 * x + 1];
+        }
+        if (roi.width & 1)
+        {
+            dst[4 * x + 0] = dst[4 * x + 2] = srcY[2 * x];
+            dst[4 * x + 1] = srcUV[2 * x + 0];
+            dst[4 * x + 3] = srcUV[2 * x + 1];
+        }
+    }
+}
+
+CC_KERNEL_DECL(cc_YUV420_to_YUY2_AVX2)
+{
+    (void)srcBitDepth;
+
+    for (int32_t y = 0; y < roi.height; y++)
+    {
+        PackYUY2Row_AVX2(pSrc[0] + y * pSrcStep[0],
+                         pSrc[1] + (y >> 1) * pSrcStep[1],
+                         pSrc[2] + (y >> 1) * pSrcStep[2],
+                         pDst[0] + y * pDstStep[0], roi.width);
+    }
+}
+
+CC_KERNEL_DECL(cc_YUV422_to_YUY2_AVX2)
+{
+    (void)srcBitDepth;
+
+    for (int32_t y = 0; y < roi.height; y++)
+    {
+        PackYUY2Row_AVX2(pSrc[0] + y * pSrcStep[0],
+                         pSrc[1] + y * pSrcStep[1],
+                         pSrc[2] + y * pSrcStep[2],
+                         pDst[0] + y * pDstStep[0], roi.width);
+    }
+}
+
+CC_KERNEL_DECL(cc_YUY2_to_YUV420_AVX2)
+{
+    (void)srcBitDepth;
+
+    for (int32_t y = 0; y < roi.height; y++)
+    {
+        bool bChroma = !(y & 1);
+        UnpackYUY2Row_AVX2(pSrc[0] + y * pSrcStep[0],
+                           pDst[0] + y * pDstStep[0],
+                           bChroma ? pDst[1] + (y >> 1) * pDstStep[1] : NULL,
+                           bChroma ? pDst[2] + (y >> 1) * pDstStep[2] : NULL,
+                           roi.width);
+    }
+}
+
+CC_KERNEL_DECL(cc_YUY2_to_YUV422_AVX2)
+{
+    (void)srcBitDepth;
+
+    for (int32_t y = 0; y < roi.height; y++)
+    {
+        UnpackYUY2Row_AVX2(pSrc[0] + y * pSrcStep[0],
+                           pDst[0] + y * pDstStep[0],
+                           pDst[1] + y * pDstStep[1],
+                           pDst[2] + y * pDstStep[2],
+                           roi.width);
+    }
+}
+
+CC_KERNEL_DECL(cc_P010_to_NV12_AVX2)
+{
+    DownShiftPlane_AVX2(pSrc[0], pSrcStep[0], pDst[0], pDstStep[0], roi.width, roi.height, srcBitDepth);
+    DownShiftPlane_AVX2(pSrc[1], pSrcStep[1], pDst[1], pDstStep[1], 2 * SubsampledSize(roi.width), SubsampledSize(roi.height), srcBitDepth);
+}
+
+CC_KERNEL_DECL(cc_P010_to_YUV420_AVX2)
+{
+    int32_t shift = srcBitDepth > 8 ? srcBitDepth - 8 : 0;
+    int32_t rnd = shift ? 1 << (shift - 1) : 0;
+    __m256i vrnd = _mm256_set1_epi16((int16_t)rnd);
+    __m128i vshift = _mm_cvtsi32_si128(shift);
+
+    DownShiftPlane_AVX2(pSrc[0], pSrcStep[0], pDst[0], pDstStep[0], roi.width, roi.height, srcBitDepth);
+
+    for (int32_t y = 0; y < SubsampledSize(roi.height); y++)
+    {
+        const uint16_t *uv = (const uint16_t *)(pSrc[1] + y * pSrcStep[1]);
+        uint8_t *u = pDst[1] + y * pDstStep[1];
+        uint8_t *v = pDst[2] + y * pDstStep[2];
+        int32_t pairs = SubsampledSize(roi.width);
+        int32_t x = 0;
+
+        for (; x + 16 <= pairs; x += 16)
+            DeinterleaveUV_AVX2(DownShift32_AVX2(uv + 2 * x, vrnd, vshift), u + x, v + x);
+        for (; x < pairs; x++)
+        {
+            u[x] = DownShift16u(uv[2 * x + 0], shift, rnd);
+            v[x] = DownShift16u(uv[2 * x + 1], shift, rnd);
+        }
+    }
+}
+
+CC_KERNEL_DECL(cc_Y210_to_YUY2_AVX2)
+{
+    DownShiftPlane_AVX2(pSrc[0], pSrcStep[0], pDst[0], pDstStep[0], 4 * SubsampledSize(roi.width), roi.height, srcBitDepth);
+}
+
+CC_KERNEL_DECL(cc_AYUV_to_YUV444_AVX2)
+{
+    (void)srcBitDepth;
+
+    // groups every lane into V0-3 U0-3 Y0-3 A0-3, then merges lanes into 8 pixels per component
+    const __m256i maskLane = _mm256_setr_epi8(0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15,
+                                              0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15);
+    const __m256i maskCross = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+
+    for (int32_t y = 0; y < roi.height; y++)
+    {
+        const uint8_t *src = pSrc[0] + y * pSrcStep[0];
+        uint8_t *dstY = pDst[0] + y * pDstStep[0];
+        uint8_t *dstU = pDst[1] + y * pDstStep[1];
+        uint8_t *dstV = pDst[2] + y * pDstStep[2];
+        int32_t x = 0;
+
+        for (; x + 32 <= roi.width; x += 32)
+        {
+            __m256i r[4];
+            for (int32_t i = 0; i < 4; i++)
+            {
+                r[i] = _mm256_loadu_si256((const __m256i *)(src + 4 * x + 32 * i));
+                r[i] = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(r[i], maskLane), maskCross);
+            }
+
+            __m256i vy0 = _mm256_unpacklo_epi64(r[0], r[1]); // V0-15 | Y0-15
+            __m256i ua0 = _mm256_unpackhi_epi64(r[0], r[1]); // U0-15 | A0-15
+            __m256i vy1 = _mm256_unpacklo_epi64(r[2], r[3]);
+            __m256i ua1 = _mm256_unpackhi_epi64(r[2], r[3]);
+
+            _mm256_storeu_si256((__m256i *)(dstV + x), _mm256_permute2x128_si256(vy0, vy1, 0x20));
+            _mm256_storeu_si256((__m256i *)(dstY + x), _mm256_permute2x128_si256(vy0, vy1, 0x31));
+            _mm256_storeu_si256((__m256i *)(dstU + x), _mm256_permute2x128_si256(ua0, ua1, 0x20));
+        }
+        for (; x < roi.width; x++)
+        {
+            dstV[x] = src[4 * x + 0];
+            dstU[x] = src[4 * x + 1];
+            dstY[x] = src[4 * x + 2];
+        }
+    }
+}
+
+} // namespace UMC
@@ -0,0 +1,314 @@
+// Copyright (c) 2020 Intel Corporation
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "umc_color_space_conversion_kernels.h"
+
+#include <algorithm>
+
+namespace UMC
+{
+
+// 16 bit samples with srcBitDepth significant bits are rounded to 8 bits
+static inline uint8_t DownShift16u(uint16_t val, int32_t shift, int32_t rnd)
+{
+    uint32_t res = ((uint32_t)val + rnd) >> shift;
+    return (uint8_t)(res > 255 ? 255 : res);
+}
+
+static inline int32_t GetDownShift(int32_t srcBitDepth)
+{
+    return srcBitDepth > 8 ? srcBitDepth - 8 : 0;
+}
+
+CC_KERNEL_DECL(cc_NV12_to_YUV420_C)
+{
+    (void)srcBitDepth;
+
+    for (int32_t y = 0; y < roi.height; y++)
+        std::copy(pSrc[0] + y * pSrcStep[0], pSrc[0] + y * pSrcStep[0] + roi.width, pDst[0] + y * pDstStep[0]);
+
+    for (int32_t y = 0; y < SubsampledSize(roi.height); y++)
+    {
+        const uint8_t *uv = pSrc[1] + y * pSrcStep[1];
+        uint8_t *u = pDst[1] + y * pDstStep[1];
+        uint8_t *v = pDst[2] + y * pDstStep[2];
+
+        for (int32_t x = 0; x < SubsampledSize(roi.width); x++)
+        {
+            u[x] = uv[2 * x + 0];
+            v[x] = uv[2 * x + 1];
+        }
+    }
+}
+
+CC_KERNEL_DECL(cc_YUV420_to_NV12_C)
+{
+    (void)srcBitDepth;
+
+    for (int32_t y = 0; y < roi.height; y++)
+        std::copy(pSrc[0] + y * pSrcStep[0], pSrc[0] + y * pSrcStep[0] + roi.width, pDst[0] + y * pDstStep[0]);
+
+    for (int32_t y = 0; y < SubsampledSize(roi.height); y++)
+    {
+        const uint8_t *u = pSrc[1] + y * pSrcStep[1];
+        const uint8_t *v = pSrc[2] + y * pSrcStep[2];
+        uint8_t *uv = pDst[1] + y * pDstStep[1];
+
+        for (int32_t x = 0; x < SubsampledSize(roi.width); x++)
+        {
+            uv[2 * x + 0] = u[x];
+            uv[2 * x + 1] = v[x];
+        }
+    }
+}
+
+CC_KERNEL_DECL(cc_NV12_to_YUY2_C)
+{
+    (void)srcBitDepth;
+
+    for (int32_t y = 0; y < roi.height; y++)
+    {
+        const uint8_t *srcY  = pSrc[0] + y * pSrcStep[0];
+        const uint8_t *srcUV = pSrc[1] + (y >> 1) * pSrcStep[1];
+        uint8_t *dst = pDst[0] + y * pDstStep[0];
+
+        for (int32_t x = 0; x < roi.width / 2; x++)
+        {
+            dst[4 * x + 0] = srcY[2 * x + 0];
+            dst[4 * x + 1] = srcUV[2 * x + 0];
+            dst[4 * x + 2] = srcY[2 * x + 1];
+            dst[4 * x + 3] = srcUV[2 * x + 1];
+        }
+        if (roi.width & 1)
+        {
+            int32_t x = roi.width / 2;
+            dst[4 * x + 0] = dst[4 * x + 2] = srcY[2 * x];
+            dst[4 * x + 1] = srcUV[2 * x + 0];
+            dst[4 * x + 3] = srcUV[2 * x + 1];
+        }
+    }
+}
+
+static inline void PackYUY2Row_C(const uint8_t *srcY, const uint8_t *srcU, const uint8_t *srcV, uint8_t *dst, int32_t width)
+{
+    for (int32_t x = 0; x < width / 2; x++)
+    {
+        dst[4 * x + 0] = srcY[2 * x + 0];
+        dst[4 * x + 1] = srcU[x];
+        dst[4 * x + 2] = srcY[2 * x + 1];
+        dst[4 * x + 3] = srcV[x];
+    }
+    if (width & 1)
+    {
+        int32_t x = width / 2;
+        dst[4 * x + 0] = dst[4 * x + 2] = srcY[2 * x];
+        dst[4 * x + 1] = srcU[x];
+        dst[4 * x + 3] = srcV[x];
+    }
+}
+
+CC_KERNEL_DECL(cc_YUV420_to_YUY2_C)
+{
+    (void)srcBitDepth;
+
+    for (int32_t y = 0; y < roi.height; y++)
+    {
+        PackYUY2Row_C(pSrc[0] + y * pSrcStep[0],
+                      pSrc[1] + (y >> 1) * pSrcStep[1],
+                      pSrc[2] + (y >> 1) * pSrcStep[2],
+                      pDst[0] + y * pDstStep[0], roi.width);
+    }
+}
+
+CC_KERNEL_DECL(cc_YUV422_to_YUY2_C)
+{
+    (void)srcBitDepth;
+
+    for (int32_t y = 0; y < roi.height; y++)
+    {
+        PackYUY2Row_C(pSrc[0] + y * pSrcStep[0],
+                      pSrc[1] + y * pSrcStep[1],
+                      pSrc[2] + y * pSrcStep[2],
+                      pDst[0] + y * pDstStep[0], roi.width);
+    }
+}
+
+static inline void UnpackYUY2Row_C(const uint8_t *src, uint8_t *dstY, uint8_t *dstU, uint8_t *dstV, int32_t width)
+{
+    for (int32_t x = 0; x < width / 2; x++)
+    {
+        dstY[2 * x + 0] = src[4 * x + 0];
+        dstY[2 * x + 1] = src[4 * x + 2];
+        if (dstU)
+        {
+            dstU[x] = src[4 * x + 1];
+            dstV[x] = src[4 * x + 3];
+        }
+    }
+    if (width & 1)
+    {
+        int32_t x = width / 2;
+        dstY[2 * x] = src[4 * x + 0];
+        if (dstU)
+        {
+            dstU[x] = src[4 * x + 1];
+            dstV[x] = src[4 * x + 3];
+        }
+    }
+}
+
+CC_KERNEL_DECL(cc_YUY2_to_YUV420_C)
+{
+    (void)srcBitDepth;
+
+    // chroma of odd rows is dropped, same as mfxiYCbCr422ToYCbCr420_8u_C2P3R
+    for (int32_t y = 0; y < roi.height; y++)
+    {
+        bool bChroma = !(y & 1);
+        UnpackYUY2Row_C(pSrc[0] + y * pSrcStep[0],
+                        pDst[0] + y * pDstStep[0],
+                        bChroma ? pDst[1] + (y >> 1) * pDstStep[1] : NULL,
+                        bChroma ? pDst[2] + (y >> 1) * pDstStep[2] : NULL,
+                        roi.width);
+    }
+}
+
+CC_KERNEL_DECL(cc_YUY2_to_YUV422_C)
+{
+    (void)srcBitDepth;
+
+    for (int32_t y = 0; y < roi.height; y++)
+    {
+        UnpackYUY2Row_C(pSrc[0] + y * pSrcStep[0],
+                        pDst[0] + y * pDstStep[0],
+                        pDst[1] + y * pDstStep[1],
+                        pDst[2] + y * pDstStep[2],
+                        roi.width);
+    }
+}
+
+static void DownShiftPlane_C(const uint8_t *pSrc, int32_t srcStep, uint8_t *pDst, int32_t dstStep,
+                             int32_t samples, int32_t height, int32_t srcBitDepth)
+{
+    int32_t shift = GetDownShift(srcBitDepth);
+    int32_t rnd = shift ? 1 << (shift - 1) : 0;
+
+    for (int32_t y = 0; y < height; y++)
+    {
+        const uint16_t *src = (const uint16_t *)(pSrc + y * srcStep);
+        uint8_t *dst = pDst + y * dstStep;
+
+        for (int32_t x = 0; x < samples; x++)
+            dst[x] = DownShift16u(src[x], shift, rnd);
+    }
+}
+
+CC_KERNEL_DECL(cc_P010_to_NV12_C)
+{
+    DownShiftPlane_C(pSrc[0], pSrcStep[0], pDst[0], pDstStep[0], roi.width, roi.height, srcBitDepth);
+    DownShiftPlane_C(pSrc[1], pSrcStep[1], pDst[1], pDstStep[1], 2 * SubsampledSize(roi.width), SubsampledSize(roi.height), srcBitDepth);
+}
+
+CC_KERNEL_DECL(cc_P010_to_YUV420_C)
+{
+    int32_t shift = GetDownShift(srcBitDepth);
+    int32_t rnd = shift ? 1 << (shift - 1) : 0;
+
+    DownShiftPlane_C(pSrc[0], pSrcStep[0], pDst[0], pDstStep[0], roi.width, roi.height, srcBitDepth);
+
+    for (int32_t y = 0; y < SubsampledSize(roi.height); y++)
+    {
+        const uint16_t *uv = (const uint16_t *)(pSrc[1] + y * pSrcStep[1]);
+        uint8_t *u = pDst[1] + y * pDstStep[1];
+        uint8_t *v = pDst[2] + y * pDstStep[2];
+
+        for (int32_t x = 0; x < SubsampledSize(roi.width); x++)
+        {
+            u[x] = DownShift16u(uv[2 * x + 0], shift, rnd);
+            v[x] = DownShift16u(uv[2 * x + 1], shift, rnd);
+        }
+    }
+}
+
+CC_KERNEL_DECL(cc_Y210_to_YUY2_C)
+{
+    // Y210 has the same sample order as YUY2, only the sample size differs
+    DownShiftPlane_C(pSrc[0], pSrcStep[0], pDst[0], pDstStep[0], 4 * SubsampledSize(roi.width), roi.height, srcBitDepth);
+}
+
+CC_KERNEL_DECL(cc_AYUV_to_YUV444_C)
+{
+    (void)srcBitDepth;
+
+    // AYUV is stored as V, U, Y, A bytes
+    for (int32_t y = 0; y < roi.height; y++)
+    {
+        const uint8_t *src = pSrc[0] + y * pSrcStep[0];
+        uint8_t *dstY = pDst[0] + y * pDstStep[0];
+        uint8_t *dstU = pDst[1] + y * pDstStep[1];
+        uint8_t *dstV = pDst[2] + y * pDstStep[2];
+
+        for (int32_t x = 0; x < roi.width; x++)
+        {
+            dstV[x] = src[4 * x + 0];
+            dstU[x] = src[4 * x + 1];
+            dstY[x] = src[4 * x + 2];
+        }
+    }
+}
+
+#define CC_KERNEL_ENTRY(src, dst, name, srcDiv, dstDiv) \
+    { { src, dst, name ## _C, srcDiv, dstDiv }, { src, dst, name ## _AVX2, srcDiv, dstDiv } }
+
+#define CC_DIV(a, b, c) { a, b, c }
+
+static const ColorConvertKernelInfo g_ColorConvertKernels[][2] =
+{
+    CC_KERNEL_ENTRY(NV12,   YUV420, cc_NV12_to_YUV420,  CC_DIV(1, 2, 1), CC_DIV(1, 2, 2)),
+    CC_KERNEL_ENTRY(YUV420, NV12,   cc_YUV420_to_NV12,  CC_DIV(1, 2, 2), CC_DIV(1, 2, 1)),
+    CC_KERNEL_ENTRY(NV12,   YUY2,   cc_NV12_to_YUY2,    CC_DIV(1, 2, 1), CC_DIV(1, 1, 1)),
+    CC_KERNEL_ENTRY(YUV420, YUY2,   cc_YUV420_to_YUY2,  CC_DIV(1, 2, 2), CC_DIV(1, 1, 1)),
+    CC_KERNEL_ENTRY(YUV422, YUY2,   cc_YUV422_to_YUY2,  CC_DIV(1, 1, 1), CC_DIV(1, 1, 1)),
+    CC_KERNEL_ENTRY(YUY2,   YUV420, cc_YUY2_to_YUV420,  CC_DIV(1, 1, 1), CC_DIV(1, 2, 2)),
+    CC_KERNEL_ENTRY(YUY2,   YUV422, cc_YUY2_to_YUV422,  CC_DIV(1, 1, 1), CC_DIV(1, 1, 1)),
+    CC_KERNEL_ENTRY(P010,   NV12,   cc_P010_to_NV12,    CC_DIV(1, 2, 1), CC_DIV(1, 2, 1)),
+    CC_KERNEL_ENTRY(P010,   YUV420, cc_P010_to_YUV420,  CC_DIV(1, 2, 1), CC_DIV(1, 2, 2)),
+    CC_KERNEL_ENTRY(Y210,   YUY2,   cc_Y210_to_YUY2,    CC_DIV(1, 1, 1), CC_DIV(1, 1, 1)),
+    CC_KERNEL_ENTRY(AYUV,   YUV444, cc_AYUV_to_YUV444,  CC_DIV(1, 1, 1), CC_DIV(1, 1, 1)),
+};
+
+#undef CC_DIV
+#undef CC_KERNEL_ENTRY
+
+const ColorConvertKernelInfo *GetColorConvertKernel(ColorFormat srcFormat, ColorFormat dstFormat)
+{
+    static const int32_t iAVX2 = __builtin_cpu_supports("avx2") ? 1 : 0;
+
+    for (size_t i = 0; i < sizeof(g_ColorConvertKernels) / sizeof(g_ColorConvertKernels[0]); i++)
+    {
+        const ColorConvertKernelInfo &info = g_ColorConvertKernels[i][iAVX2];
+        if (info.srcFormat == srcFormat && info.dstFormat == dstFormat)
+            return &info;
+    }
+
+    return NULL;
+}
+
+} // namespace UMC
@@ -129,6 +129,9 @@ static ColorFormat GetIntermediatedColor(ColorFormat src_color)
     case YUV422A: return YUV422;
     case YUV444A: return YUV444;
     case YVU9: return YUV420;
+    case AYUV: return YUV444;
+    case P010: return NV12;
+    case Y210: return YUY2;
     default: return YUV420;
   }
 }
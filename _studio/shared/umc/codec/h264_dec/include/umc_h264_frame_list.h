@@ -50,17 +50,25 @@ public:
 
     void append(H264DecoderFrame *pFrame);
 
-    int32_t GetFreeIndex()
+    // Marks indices of all frames in the list, indices outside of [0, size) are ignored
+    void MarkUsedIndices(bool *pUsed, int32_t size)
     {
-        for (int32_t i = 0; i < 127; i++)
+        for (H264DecoderFrame *pFrm = head(); pFrm; pFrm = pFrm->future())
         {
-            H264DecoderFrame *pFrm;
+            if (pFrm->m_index >= 0 && pFrm->m_index < size)
+                pUsed[pFrm->m_index] = true;
+        }
+    }
 
-            for (pFrm = head(); pFrm && pFrm->m_index != i; pFrm = pFrm->future())
-            {
-            }
+    int32_t GetFreeIndex()
+    {
+        // one walk over the list instead of one walk per candidate index
+        bool used[127] = {};
+        MarkUsedIndices(used, 127);
 
-            if (pFrm == NULL)
+        for (int32_t i = 0; i < 127; i++)
+        {
+            if (!used[i])
             {
                 return i;
             }
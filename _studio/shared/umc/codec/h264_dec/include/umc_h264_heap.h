@@ -32,6 +32,8 @@
 namespace UMC
 {
 
+class H264_Heap_Objects;
+
 //*********************************************************************************************/
 //
 //*********************************************************************************************/
@@ -43,6 +45,7 @@ public:
     {
         m_pNext = 0;
         m_pts = 0;
+        m_pHeap = 0;
         Reset();
     }
 
@@ -52,11 +55,7 @@ public:
         Release();
     }
 
-    void Release()
-    {
-        delete[] m_pSourceBuffer;
-        Reset();
-    }
+    inline void Release();
 
     void SetData(MediaData *out)
     {
@@ -67,28 +66,10 @@ public:
         m_pts = out->GetTime();
     }
 
-    void MoveToInternalBuffer()
-    {
-        if (m_pSourceBuffer)
-            return;
+    inline void MoveToInternalBuffer(H264_Heap_Objects * heap = 0);
 
-        m_nSourceSize = m_nDataSize + DEFAULT_NU_TAIL_SIZE;
-        m_pSourceBuffer = h264_new_array_throw<uint8_t>((int32_t)m_nSourceSize);
-        MFX_INTERNAL_CPY(m_pSourceBuffer, m_pDataPointer, m_nDataSize);
-        m_pDataPointer = m_pSourceBuffer;
-    }
-
-    // Allocate memory piece
-    bool Allocate(size_t nSize)
-    {
-        Release();
-
-        // allocate little more
-        m_pSourceBuffer = h264_new_array_throw<uint8_t>((int32_t)nSize);
-        m_pDataPointer = m_pSourceBuffer;
-        m_nSourceSize = nSize;
-        return true;
-    }
+    // Allocate memory piece, from the heap's free lists if heap is given
+    inline bool Allocate(size_t nSize, H264_Heap_Objects * heap = 0);
 
     // Get next element
     H264MemoryPiece *GetNext(){return m_pNext;}
@@ -110,6 +91,7 @@ protected:
     size_t m_nDataSize;                                         // (size_t) data memory size
     H264MemoryPiece *m_pNext;                                   // (H264MemoryPiece *) pointer to next memory piece
     double   m_pts;
+    H264_Heap_Objects *m_pHeap;                                 // (H264_Heap_Objects *) owner of source memory, 0 for new[]
 
     void Reset()
     {
@@ -117,6 +99,7 @@ protected:
         m_pDataPointer = 0;
         m_nSourceSize = 0;
         m_nDataSize = 0;
+        m_pHeap = 0;
     }
 
 private:
@@ -128,8 +111,6 @@ private:
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Item class
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-class H264_Heap_Objects;
-
 class Item
 {
 public:
@@ -138,6 +119,7 @@ public:
         , m_Ptr(ptr)
         , m_Size(size)
         , m_isTyped(isTyped)
+        , m_isFree(false)
         , m_heap(heap)
     {
     }
@@ -150,6 +132,7 @@ public:
     void * m_Ptr;
     size_t m_Size;
     bool   m_isTyped;
+    bool   m_isFree;
     H264_Heap_Objects * m_heap;
 
     static Item * Allocate(H264_Heap_Objects * heap, size_t size, bool isTyped = false)
@@ -175,6 +158,15 @@ public:
     }
 };
 
+// allocation counters of H264_Heap_Objects, cumulative since decoder creation
+struct H264HeapStatistics
+{
+    uint64_t m_systemAllocations;   // items got from operator new
+    uint64_t m_systemBytes;         // bytes got from operator new
+    uint64_t m_reuses;              // allocations served from free lists
+    uint64_t m_frees;               // items returned to free lists
+};
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // H264_Heap_Objects class
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -182,9 +174,21 @@ class H264_Heap_Objects
 {
 public:
 
+    enum
+    {
+        // raw buffers (NAL payloads) are rounded up to power of 2 size classes
+        MIN_RAW_SIZE_LOG2 = 6,
+        NUM_RAW_SIZE_CLASSES = 22,  // 64 bytes .. 128 Mb
+        // typed objects are kept by exact size, one free list per object type
+        MAX_TYPED_SIZES = 32
+    };
+
     H264_Heap_Objects()
-        : m_pFirstFree(0)
+        : m_numTypedLists(0)
     {
+        memset(m_pFreeRaw, 0, sizeof(m_pFreeRaw));
+        memset(m_FreeTyped, 0, sizeof(m_FreeTyped));
+        memset(&m_stat, 0, sizeof(m_stat));
     }
 
     virtual ~H264_Heap_Objects()
@@ -192,43 +196,28 @@ public:
         Release();
     }
 
-    Item * GetItemForAllocation(size_t size, bool typed = false)
+    void* Allocate(size_t size, bool isTyped = false)
     {
-        if (!m_pFirstFree)
-        {
-            return 0;
-        }
+        Item ** list = GetFreeList(size, isTyped);
 
-        if (m_pFirstFree->m_Size == size && m_pFirstFree->m_isTyped == typed)
+        if (!isTyped && list)
         {
-            Item * ptr = m_pFirstFree;
-            m_pFirstFree = m_pFirstFree->m_pNext;
-            return ptr;
+            size = GetRawSizeClass(size);
         }
 
-        Item * temp = m_pFirstFree;
-
-        while (temp->m_pNext)
+        Item * item = list ? *list : 0;
+        if (item)
         {
-            if (temp->m_pNext->m_Size == size && temp->m_pNext->m_isTyped == typed)
-            {
-                Item * ptr = temp->m_pNext;
-                temp->m_pNext = temp->m_pNext->m_pNext;
-                return ptr;
-            }
-
-            temp = temp->m_pNext;
+            *list = item->m_pNext;
+            item->m_pNext = 0;
+            item->m_isFree = false;
+            m_stat.m_reuses++;
         }
-
-        return 0;
-    }
-
-    void* Allocate(size_t size, bool isTyped = false)
-    {
-        Item * item = GetItemForAllocation(size);
-        if (!item)
+        else
         {
             item = Item::Allocate(this, size, isTyped);
+            m_stat.m_systemAllocations++;
+            m_stat.m_systemBytes += size;
         }
 
         return item->m_Ptr;
@@ -243,15 +232,16 @@ public:
     template <typename T>
     T* AllocateObject()
     {
-        Item * item = GetItemForAllocation(sizeof(T), true);
+        Item ** list = GetFreeList(sizeof(T), true);
 
-        if (!item)
+        if (list && *list)
         {
-            void * ptr = Allocate(sizeof(T), true);
-            return new(ptr) T();
+            // object was constructed before and reset when freed
+            return (T*)Allocate(sizeof(T), true);
         }
 
-        return (T*)(item->m_Ptr);
+        void * ptr = Allocate(sizeof(T), true);
+        return new(ptr) T();
     }
 
     void FreeObject(void * obj, bool force = false)
@@ -266,52 +256,142 @@ public:
 
         Item * item = (Item *) ((uint8_t*)obj - sizeof(Item));
 
-        // check
-        Item * temp = m_pFirstFree;
-
-        while (temp)
-        {
-            if (temp == item)
-            { //was removed yet
-                return;
-            }
-
-            temp = temp->m_pNext;
+        if (item->m_isFree)
+        { //was removed yet
+            return;
         }
 
-        if (force)
+        Item ** list = force ? 0 : GetFreeList(item->m_Size, item->m_isTyped);
+
+        if (!list)
         {
             Item::Free(item);
             return;
         }
-        else
+
+        if (item->m_isTyped)
         {
-            if (item->m_isTyped)
-            {
-                HeapObject * object = reinterpret_cast<HeapObject *>(item->m_Ptr);
-                object->Reset();
-            }
+            HeapObject * object = reinterpret_cast<HeapObject *>(item->m_Ptr);
+            object->Reset();
         }
 
-        item->m_pNext = m_pFirstFree;
-        m_pFirstFree = item;
+        item->m_isFree = true;
+        item->m_pNext = *list;
+        *list = item;
+        m_stat.m_frees++;
     }
 
     void Release()
     {
-        while (m_pFirstFree)
+        // objects first, their destructors may return buffers to raw lists
+        for (uint32_t i = 0; i < m_numTypedLists; i++)
         {
-            Item *pTemp = m_pFirstFree->m_pNext;
-            Item::Free(m_pFirstFree);
-            m_pFirstFree = pTemp;
+            ReleaseList(m_FreeTyped[i].m_pFirstFree);
         }
+
+        for (uint32_t i = 0; i < NUM_RAW_SIZE_CLASSES; i++)
+        {
+            ReleaseList(m_pFreeRaw[i]);
+        }
+    }
+
+    const H264HeapStatistics & GetStatistics() const
+    {
+        return m_stat;
     }
 
 private:
 
-    Item * m_pFirstFree;
+    struct TypedList
+    {
+        size_t  m_size;
+        Item  * m_pFirstFree;
+    };
+
+    static uint32_t GetRawSizeClassIndex(size_t size)
+    {
+        uint32_t idx = 0;
+        while (idx < NUM_RAW_SIZE_CLASSES && ((size_t)1 << (idx + MIN_RAW_SIZE_LOG2)) < size)
+            idx++;
+        return idx;
+    }
+
+    static size_t GetRawSizeClass(size_t size)
+    {
+        return (size_t)1 << (GetRawSizeClassIndex(size) + MIN_RAW_SIZE_LOG2);
+    }
+
+    // returns free list for items of the size, 0 if such items are not pooled
+    Item ** GetFreeList(size_t size, bool typed)
+    {
+        if (!typed)
+        {
+            uint32_t idx = GetRawSizeClassIndex(size);
+            return idx < NUM_RAW_SIZE_CLASSES ? &m_pFreeRaw[idx] : 0;
+        }
+
+        for (uint32_t i = 0; i < m_numTypedLists; i++)
+        {
+            if (m_FreeTyped[i].m_size == size)
+                return &m_FreeTyped[i].m_pFirstFree;
+        }
+
+        if (m_numTypedLists == MAX_TYPED_SIZES)
+            return 0;
+
+        m_FreeTyped[m_numTypedLists].m_size = size;
+        return &m_FreeTyped[m_numTypedLists++].m_pFirstFree;
+    }
+
+    static void ReleaseList(Item *& pFirstFree)
+    {
+        while (pFirstFree)
+        {
+            Item *pTemp = pFirstFree->m_pNext;
+            Item::Free(pFirstFree);
+            pFirstFree = pTemp;
+        }
+    }
+
+    Item     * m_pFreeRaw[NUM_RAW_SIZE_CLASSES];
+    TypedList  m_FreeTyped[MAX_TYPED_SIZES];
+    uint32_t   m_numTypedLists;
+
+    H264HeapStatistics m_stat;
 };
 
+inline void H264MemoryPiece::Release()
+{
+    if (m_pHeap)
+        m_pHeap->Free(m_pSourceBuffer);
+    else
+        delete[] m_pSourceBuffer;
+    Reset();
+}
+
+inline void H264MemoryPiece::MoveToInternalBuffer(H264_Heap_Objects * heap)
+{
+    if (m_pSourceBuffer)
+        return;
+
+    m_nSourceSize = m_nDataSize + DEFAULT_NU_TAIL_SIZE;
+    m_pSourceBuffer = heap ? heap->Allocate<uint8_t>(m_nSourceSize) : h264_new_array_throw<uint8_t>((int32_t)m_nSourceSize);
+    m_pHeap = heap;
+    MFX_INTERNAL_CPY(m_pSourceBuffer, m_pDataPointer, m_nDataSize);
+    m_pDataPointer = m_pSourceBuffer;
+}
+
+inline bool H264MemoryPiece::Allocate(size_t nSize, H264_Heap_Objects * heap)
+{
+    Release();
+
+    // allocate little more
+    m_pSourceBuffer = heap ? heap->Allocate<uint8_t>(nSize) : h264_new_array_throw<uint8_t>((int32_t)nSize);
+    m_pHeap = heap;
+    m_pDataPointer = m_pSourceBuffer;
+    m_nSourceSize = nSize;
+    return true;
+}
 
 //*********************************************************************************************/
 // H264_List implementation
@@ -381,7 +381,7 @@ Status MFXTaskSupplier::DecodeSEI(NalUnit *nalUnit)
         mem.SetData(nalUnit);
 
         H264MemoryPiece swappedMem;
-        swappedMem.Allocate(nalUnit->GetDataSize() + DEFAULT_NU_TAIL_SIZE);
+        swappedMem.Allocate(nalUnit->GetDataSize() + DEFAULT_NU_TAIL_SIZE, &m_ObjHeap);
 
         SwapperBase * swapper = m_pNALSplitter->GetSwapper();
         swapper->SwapMemory(&swappedMem, &mem, DEFAULT_NU_HEADER_TAIL_VALUE);
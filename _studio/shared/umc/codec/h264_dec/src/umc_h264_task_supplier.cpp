@@ -38,12 +38,16 @@
 #include "umc_h264_notify.h"
 
 #include "umc_h264_dec_debug.h"
+#include "umc_param_set_cache.h"
 
 using namespace UMC_H264_DECODER;
 
 namespace UMC
 {
 
+// SPS parsing depends on bitstream and m_ignoreLevelConstrain only
+typedef ParamSetCache<H264SeqParamSet> SPSCache;
+
 #if (MFX_VERSION >= 1025)
 inline void SetDecodeErrorTypes(NAL_Unit_Type nalUnit, mfxExtDecodeErrorReport *pDecodeErrorReport)
 {
@@ -2381,7 +2385,7 @@ Status TaskSupplier::DecodeSEI(NalUnit *nalUnit)
         mem.SetData(nalUnit);
 
         H264MemoryPiece swappedMem;
-        swappedMem.Allocate(nalUnit->GetDataSize() + DEFAULT_NU_TAIL_SIZE);
+        swappedMem.Allocate(nalUnit->GetDataSize() + DEFAULT_NU_TAIL_SIZE, &m_ObjHeap);
 
         SwapperBase * swapper = m_pNALSplitter->GetSwapper();
         swapper->SwapMemory(&swappedMem, &mem, DEFAULT_NU_HEADER_TAIL_VALUE);
@@ -2430,38 +2434,53 @@ Status TaskSupplier::DecodeHeaders(NalUnit *nalUnit)
 
     try
     {
-        H264MemoryPiece mem;
-        mem.SetData(nalUnit);
+        const uint8_t * nalData = (const uint8_t *)nalUnit->GetDataPointer();
+        size_t nalSize = nalUnit->GetDataSize();
+
+        // SPS already parsed by any decoder instance is taken from process-wide cache
+        H264SeqParamSet sps;
+        bool isCachedSPS = nalSize && (nalData[0] & NAL_UNITTYPE_BITS) == NAL_UT_SPS &&
+            SPSCache::Instance().Find(nalData, nalSize, m_ignoreLevelConstrain, sps);
+
+        NAL_Unit_Type nal_unit_type = NAL_UT_SPS;
+        uint32_t nal_ref_idc = 0;
 
         H264MemoryPiece swappedMem;
 
-        swappedMem.Allocate(nalUnit->GetDataSize() + DEFAULT_NU_TAIL_SIZE);
+        if (!isCachedSPS)
+        {
+            H264MemoryPiece mem;
+            mem.SetData(nalUnit);
 
-        SwapperBase * swapper = m_pNALSplitter->GetSwapper();
-        swapper->SwapMemory(&swappedMem, &mem);
+            swappedMem.Allocate(nalUnit->GetDataSize() + DEFAULT_NU_TAIL_SIZE, &m_ObjHeap);
 
-        bitStream.Reset((uint8_t*)swappedMem.GetPointer(), (uint32_t)swappedMem.GetDataSize());
-        bitStream.SetTailBsSize(DEFAULT_NU_TAIL_SIZE);
+            SwapperBase * swapper = m_pNALSplitter->GetSwapper();
+            swapper->SwapMemory(&swappedMem, &mem);
 
-        NAL_Unit_Type nal_unit_type;
-        uint32_t nal_ref_idc;
+            bitStream.Reset((uint8_t*)swappedMem.GetPointer(), (uint32_t)swappedMem.GetDataSize());
+            bitStream.SetTailBsSize(DEFAULT_NU_TAIL_SIZE);
 
-        bitStream.GetNALUnitType(nal_unit_type, nal_ref_idc);
+            bitStream.GetNALUnitType(nal_unit_type, nal_ref_idc);
+        }
 
         switch(nal_unit_type)
         {
         // sequence parameter set
         case NAL_UT_SPS:
             {
-                H264SeqParamSet sps;
-                sps.seq_parameter_set_id = MAX_NUM_SEQ_PARAM_SETS;
-                umcRes = bitStream.GetSequenceParamSet(&sps, m_ignoreLevelConstrain);
-                if (umcRes != UMC_OK)
+                if (!isCachedSPS)
                 {
-                    H264SeqParamSet * old_sps = m_Headers.m_SeqParams.GetHeader(sps.seq_parameter_set_id);
-                    if (old_sps)
-                        old_sps->errorFlags = 1;
-                    return UMC_ERR_INVALID_STREAM;
+                    sps.seq_parameter_set_id = MAX_NUM_SEQ_PARAM_SETS;
+                    umcRes = bitStream.GetSequenceParamSet(&sps, m_ignoreLevelConstrain);
+                    if (umcRes != UMC_OK)
+                    {
+                        H264SeqParamSet * old_sps = m_Headers.m_SeqParams.GetHeader(sps.seq_parameter_set_id);
+                        if (old_sps)
+                            old_sps->errorFlags = 1;
+                        return UMC_ERR_INVALID_STREAM;
+                    }
+
+                    SPSCache::Instance().Add(nalData, nalSize, m_ignoreLevelConstrain, sps);
                 }
 
                 uint8_t newDPBsize = (uint8_t)CalculateDPBSize(sps.level_idc,
@@ -3460,7 +3479,7 @@ H264Slice * TaskSupplier::DecodeSliceHeader(NalUnit *nalUnit)
     H264MemoryPiece memCopy;
     memCopy.SetData(nalUnit);
 
-    pSlice->m_pSource.Allocate(nalUnit->GetDataSize() + DEFAULT_NU_SLICE_TAIL_SIZE);
+    pSlice->m_pSource.Allocate(nalUnit->GetDataSize() + DEFAULT_NU_SLICE_TAIL_SIZE, &m_ObjHeap);
 
     notifier0<H264MemoryPiece> memory_leak_preventing(&pSlice->m_pSource, &H264MemoryPiece::Release);
 
@@ -403,7 +403,7 @@ H264Slice * VATaskSupplier::DecodeSliceHeader(NalUnit *nalUnit)
     }
     else
     {
-        slice->m_pSource.Allocate(nalUnit->GetDataSize() + DEFAULT_NU_TAIL_SIZE);
+        slice->m_pSource.Allocate(nalUnit->GetDataSize() + DEFAULT_NU_TAIL_SIZE, &m_ObjHeap);
         MFX_INTERNAL_CPY(slice->m_pSource.GetPointer(), nalUnit->GetDataPointer(), (uint32_t)nalUnit->GetDataSize());
         memset(slice->m_pSource.GetPointer() + nalUnit->GetDataSize(), DEFAULT_NU_TAIL_VALUE, DEFAULT_NU_TAIL_SIZE);
         slice->m_pSource.SetDataSize(nalUnit->GetDataSize());
@@ -429,36 +429,21 @@ H264Slice * VATaskSupplier::DecodeSliceHeader(NalUnit *nalUnit)
 // returns free index or -1 if no free index found
 int32_t VATaskSupplier::GetFreeFrameIndex()
 {
-    for (int32_t i = 0; i < 127; i++)
-    {
-        ViewList::iterator iter = m_views.begin();
-        ViewList::iterator iter_end = m_views.end();
-        H264DecoderFrame *pFrm = NULL;
-
-        // run over the list and try to find the corresponding view
-        for (; iter != iter_end; ++iter)
-        {
-            ViewItem & item = *iter;
-            H264DBPList *pDPBList = item.GetDPBList();
-            pFrm = pDPBList->head();
+    bool used[127] = {};
 
-            // walk over the list
-            while(pFrm != NULL && pFrm->m_index != i)
-            {
-                pFrm = pFrm->future();
-            }
-
-            if (pFrm != NULL)
-            {
-                // go next index
-                // no need to check next View
-                break;
-            }
-        }
+    // collect indices used in all views with a single walk over each DPB
+    ViewList::iterator iter = m_views.begin();
+    ViewList::iterator iter_end = m_views.end();
+    for (; iter != iter_end; ++iter)
+    {
+        ViewItem & item = *iter;
+        item.GetDPBList()->MarkUsedIndices(used, 127);
+    }
 
-        if (pFrm == NULL)
+    for (int32_t i = 0; i < 127; i++)
+    {
+        if (!used[i])
         {
-            // we wall over each frame in all Views
             // this index is free
             return i;
         }
@@ -49,16 +49,25 @@ public:
     void append(H265DecoderFrame *pFrame);
     // Append the given frame to our tail
 
-    int32_t GetFreeIndex()
+    // Marks indices of all frames in the list, indices outside of [0, size) are ignored
+    void MarkUsedIndices(bool *pUsed, int32_t size)
     {
-        for(int32_t i = 0; i < 128; i++)
+        for (H265DecoderFrame *pFrm = head(); pFrm; pFrm = pFrm->future())
         {
-            H265DecoderFrame *pFrm;
+            if (pFrm->m_index >= 0 && pFrm->m_index < size)
+                pUsed[pFrm->m_index] = true;
+        }
+    }
 
-            for (pFrm = head(); pFrm && pFrm->m_index != i; pFrm = pFrm->future())
-            {}
+    int32_t GetFreeIndex()
+    {
+        // one walk over the list instead of one walk per candidate index
+        bool used[128] = {};
+        MarkUsedIndices(used, 128);
 
-            if(pFrm == NULL)
+        for(int32_t i = 0; i < 128; i++)
+        {
+            if (!used[i])
             {
                 return i;
             }
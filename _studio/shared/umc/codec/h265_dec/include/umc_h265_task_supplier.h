@@ -475,9 +475,11 @@ protected:
 
 private:
     // Decode video parameters set NAL unit
-    UMC::Status xDecodeVPS(H265HeadersBitstream *);
+    UMC::Status xDecodeVPS(H265HeadersBitstream *, UMC::MediaDataEx *);
     // Decode sequence parameters set NAL unit
-    UMC::Status xDecodeSPS(H265HeadersBitstream *);
+    UMC::Status xDecodeSPS(H265HeadersBitstream *, UMC::MediaDataEx *);
+    // Validate parsed sequence parameters set and make it active
+    UMC::Status xApplySPS(H265SeqParamSet &);
     // Decode picture parameters set NAL unit
     UMC::Status xDecodePPS(H265HeadersBitstream *);
 
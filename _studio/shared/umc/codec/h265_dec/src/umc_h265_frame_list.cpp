@@ -183,45 +183,24 @@ H265DecoderFrame * H265DBPList::findOldestDisplayable(int32_t /*dbpSize*/ )
     H265DecoderFrame *pOldest = NULL;
     int32_t  SmallestPicOrderCnt = 0x7fffffff;    // very large positive
     int32_t  LargestRefPicListResetCount = 0;
-    int32_t  uid = 0x7fffffff;
 
+    // single walk: largest reset count first, then smallest POC, then smallest UID
     while (pCurr)
     {
         if (pCurr->isDisplayable() && !pCurr->wasOutputted())
         {
-            // corresponding frame
-            if (pCurr->RefPicListResetCount() > LargestRefPicListResetCount)
-            {
-                pOldest = pCurr;
-                SmallestPicOrderCnt = pCurr->PicOrderCnt();
-                LargestRefPicListResetCount = pCurr->RefPicListResetCount();
-            }
-            else if (pCurr->PicOrderCnt() <= SmallestPicOrderCnt && pCurr->RefPicListResetCount() == LargestRefPicListResetCount)
-            {
-                pOldest = pCurr;
-                SmallestPicOrderCnt = pCurr->PicOrderCnt();
-            }
-        }
+            int32_t const resetCount = pCurr->RefPicListResetCount();
+            int32_t const poc = pCurr->PicOrderCnt();
 
-        pCurr = pCurr->future();
-    }
-
-    if (!pOldest)
-        return 0;
-
-    pCurr = m_pHead;
-
-    while (pCurr)
-    {
-        if (pCurr->isDisplayable() && !pCurr->wasOutputted())
-        {
             // corresponding frame
-            if (pCurr->RefPicListResetCount() == LargestRefPicListResetCount && pCurr->PicOrderCnt() == SmallestPicOrderCnt && pCurr->m_UID < uid)
+            if (resetCount > LargestRefPicListResetCount ||
+                (resetCount == LargestRefPicListResetCount &&
+                 (poc < SmallestPicOrderCnt ||
+                  (poc == SmallestPicOrderCnt && (!pOldest || pCurr->m_UID < pOldest->m_UID)))))
             {
                 pOldest = pCurr;
-                SmallestPicOrderCnt = pCurr->PicOrderCnt();
-                LargestRefPicListResetCount = pCurr->RefPicListResetCount();
-                uid = pCurr->m_UID;
+                SmallestPicOrderCnt = poc;
+                LargestRefPicListResetCount = resetCount;
             }
         }
 
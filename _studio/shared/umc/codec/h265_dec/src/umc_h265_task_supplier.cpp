@@ -40,6 +40,7 @@
 #include "umc_structures.h"
 #include "umc_frame_data.h"
 #include "umc_h265_debug.h"
+#include "umc_param_set_cache.h"
 
 
 #include "mfx_common.h" //  for trace routines
@@ -47,6 +48,10 @@
 namespace UMC_HEVC_DECODER
 {
 
+// VPS and SPS parsing depends on bitstream only
+typedef UMC::ParamSetCache<H265VideoParamSet> VPSCache;
+typedef UMC::ParamSetCache<H265SeqParamSet> SPSCache;
+
 #if (MFX_VERSION >= 1025)
 inline void SetDecodeErrorTypes(NalUnitType nalUnit, mfxExtDecodeErrorReport *pDecodeErrorReport)
 {
@@ -1051,19 +1056,22 @@ UMC::Status TaskSupplier_H265::DecodeSEI(UMC::MediaDataEx *nalUnit)
 }
 
 // Decode video parameters set NAL unit
-UMC::Status TaskSupplier_H265::xDecodeVPS(H265HeadersBitstream *bs)
+UMC::Status TaskSupplier_H265::xDecodeVPS(H265HeadersBitstream *bs, UMC::MediaDataEx *nalUnit)
 {
     H265VideoParamSet vps;
 
     UMC::Status s = bs->GetVideoParamSet(&vps);
     if(s == UMC::UMC_OK)
+    {
+        VPSCache::Instance().Add((const uint8_t*)nalUnit->GetDataPointer(), nalUnit->GetDataSize(), 0, vps);
         m_Headers.m_VideoParams.AddHeader(&vps);
+    }
 
     return s;
 }
 
 // Decode sequence parameters set NAL unit
-UMC::Status TaskSupplier_H265::xDecodeSPS(H265HeadersBitstream *bs)
+UMC::Status TaskSupplier_H265::xDecodeSPS(H265HeadersBitstream *bs, UMC::MediaDataEx *nalUnit)
 {
     H265SeqParamSet sps;
     sps.Reset();
@@ -1072,6 +1080,14 @@ UMC::Status TaskSupplier_H265::xDecodeSPS(H265HeadersBitstream *bs)
     if(s != UMC::UMC_OK)
         return s;
 
+    SPSCache::Instance().Add((const uint8_t*)nalUnit->GetDataPointer(), nalUnit->GetDataSize(), 0, sps);
+
+    return xApplySPS(sps);
+}
+
+// Validate parsed sequence parameters set and make it active
+UMC::Status TaskSupplier_H265::xApplySPS(H265SeqParamSet &sps)
+{
     if (sps.need16bitOutput && sps.m_pcPTL.GetGeneralPTL()->profile_idc == H265_PROFILE_MAIN10 && sps.bit_depth_luma == 8 && sps.bit_depth_chroma == 8 &&
         m_initializationParams.info.color_format == UMC::NV12)
         sps.need16bitOutput = 0;
@@ -1388,6 +1404,36 @@ UMC::Status TaskSupplier_H265::DecodeHeaders(UMC::MediaDataEx *nalUnit)
 
     try
     {
+        const uint8_t * nalData = (const uint8_t *)nalUnit->GetDataPointer();
+        size_t nalSize = nalUnit->GetDataSize();
+
+        // VPS and SPS already parsed by any decoder instance are taken from process-wide cache
+        if (nalSize > 2)
+        {
+            switch ((nalData[0] >> 1) & 0x3f)
+            {
+            case NAL_UT_VPS:
+                {
+                    H265VideoParamSet vps;
+                    if (VPSCache::Instance().Find(nalData, nalSize, 0, vps))
+                    {
+                        m_Headers.m_VideoParams.AddHeader(&vps);
+                        return UMC::UMC_OK;
+                    }
+                }
+                break;
+            case NAL_UT_SPS:
+                {
+                    H265SeqParamSet sps;
+                    if (SPSCache::Instance().Find(nalData, nalSize, 0, sps))
+                        return xApplySPS(sps);
+                }
+                break;
+            default:
+                break;
+            }
+        }
+
         MemoryPiece mem;
         mem.SetData(nalUnit);
 
@@ -1409,10 +1455,10 @@ UMC::Status TaskSupplier_H265::DecodeHeaders(UMC::MediaDataEx *nalUnit)
         switch(nal_unit_type)
         {
         case NAL_UT_VPS:
-            umcRes = xDecodeVPS(&bitStream);
+            umcRes = xDecodeVPS(&bitStream, nalUnit);
             break;
         case NAL_UT_SPS:
-            umcRes = xDecodeSPS(&bitStream);
+            umcRes = xDecodeSPS(&bitStream, nalUnit);
             break;
         case NAL_UT_PPS:
             umcRes = xDecodePPS(&bitStream);
@@ -72,11 +72,14 @@ JERRCODE CBitStreamOutput::Detach(void)
 
 JERRCODE CBitStreamOutput::Init(int bufSize)
 {
-  m_DataLen = (int)bufSize;
+  if(0 == m_pData || m_DataLen != bufSize)
+  {
+    m_DataLen = (int)bufSize;
 
-  delete[] m_pData;
+    delete[] m_pData;
 
-  m_pData = new uint8_t[m_DataLen];
+    m_pData = new uint8_t[m_DataLen];
+  }
 
   m_currPos = 0; // no data yet
 
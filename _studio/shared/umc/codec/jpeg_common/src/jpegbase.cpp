@@ -187,6 +187,10 @@ void set_num_threads(int /*maxThreads*/)
 
 JERRCODE CMemoryBuffer::Allocate(int size)
 {
+  // keep the buffer if it is big enough, contents are not preserved anyway
+  if(0 != m_buffer && m_buffer_size >= size)
+    return JPEG_OK;
+
   Delete();
 
   m_buffer_size = size;
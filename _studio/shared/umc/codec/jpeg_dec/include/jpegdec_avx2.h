@@ -0,0 +1,62 @@
+// Copyright (c) 2020 Intel Corporation
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __JPEGDEC_AVX2_H__
+#define __JPEGDEC_AVX2_H__
+
+#include "umc_defs.h"
+#if defined (MFX_ENABLE_MJPEG_VIDEO_DECODE) && defined(MFX_ENABLE_SW_FALLBACK)
+
+#include <stdint.h>
+
+// AVX2 kernels of the software JPEG decoder. Results are bit exact
+// with the corresponding mfxi* primitives, so they can be mixed freely.
+
+inline bool JpegDecUseAVX2()
+{
+    static const bool avx2 = __builtin_cpu_supports("avx2");
+    return avx2;
+}
+
+// dequantization, inverse DCT, level shift and clamp of two independent 8x8 blocks
+void DCTQuantInv8x8LS_JPEG_16s8u_C1R_x2_AVX2(
+    const int16_t* pSrc0, uint8_t* pDst0, int dstStep0, const uint16_t* pQuantInvTable0,
+    const int16_t* pSrc1, uint8_t* pDst1, int dstStep1, const uint16_t* pQuantInvTable1);
+
+// the same with 4x4 and 2x2 output for scaled decoding
+void DCTQuantInv8x8To4x4LS_JPEG_16s8u_C1R_x2_AVX2(
+    const int16_t* pSrc0, uint8_t* pDst0, int dstStep0, const uint16_t* pQuantInvTable0,
+    const int16_t* pSrc1, uint8_t* pDst1, int dstStep1, const uint16_t* pQuantInvTable1);
+void DCTQuantInv8x8To2x2LS_JPEG_16s8u_C1R_x2_AVX2(
+    const int16_t* pSrc0, uint8_t* pDst0, int dstStep0, const uint16_t* pQuantInvTable0,
+    const int16_t* pSrc1, uint8_t* pDst1, int dstStep1, const uint16_t* pQuantInvTable1);
+
+// triangle filter up sampling of one row, srcWidth must be at least 18
+void SampleUpRowH2V1_Triangle_JPEG_8u_C1_AVX2(const uint8_t* pSrc, int srcWidth, uint8_t* pDst);
+void SampleUpRowH2V2_Triangle_JPEG_8u_C1_AVX2(const uint8_t* pSrc1, const uint8_t* pSrc2, int srcWidth, uint8_t* pDst);
+
+// converts (width & ~31) leftmost columns of roi, returns number of processed columns
+int YCbCrToBGR_JPEG_8u_P3C4R_AVX2(const uint8_t* pYCC[3], int yccStep, uint8_t* pBGR, int bgrStep, mfxSize roi, uint8_t aval);
+
+// interleaves two chroma rows into one NV12 UV row
+void InterleaveUV_8u_AVX2(const uint8_t* pU, const uint8_t* pV, int width, uint8_t* pUV);
+
+#endif // MFX_ENABLE_MJPEG_VIDEO_DECODE && MFX_ENABLE_SW_FALLBACK
+#endif // __JPEGDEC_AVX2_H__
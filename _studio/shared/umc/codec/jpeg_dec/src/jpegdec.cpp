@@ -28,6 +28,7 @@
 #include <string.h>
 #include "jpegbase.h"
 #include "jpegdec.h"
+#include "jpegdec_avx2.h"
 #include <cstdlib>
 #include <assert.h>
 
@@ -44,6 +45,128 @@ extern void ConvertFrom_YUV422V_4Y_To_NV12(const uint8_t *src[3], uint32_t srcPi
   dst[0] = (uint8_t)(val > 255 ? 255 : (val < 0 ? 0 : val));\
 }
 
+// AVX2 kernels give the same output as IPP ones, so they are selected per call
+
+typedef IppStatus (*DCTQuantInvFunc)(const int16_t* pSrc, uint8_t* pDst, int dstStep, const uint16_t* qtbl);
+typedef void (*DCTQuantInvx2Func)(const int16_t* pSrc0, uint8_t* pDst0, int dstStep0, const uint16_t* qtbl0,
+                                  const int16_t* pSrc1, uint8_t* pDst1, int dstStep1, const uint16_t* qtbl1);
+
+// block waiting for a pair to be transformed together with
+struct IDCTPendingBlock
+{
+  const int16_t*  pSrc;
+  uint8_t*        pDst;
+  int             dstStep;
+  const uint16_t* qtbl;
+  DCTQuantInvFunc func;
+};
+
+// one pending block per output size: 8x8, 4x4 and 2x2
+struct IDCT8x8Pending
+{
+  IDCTPendingBlock block[3];
+};
+
+static IppStatus DCTQuantInvPaired(IDCTPendingBlock& pending, DCTQuantInvFunc func, DCTQuantInvx2Func funcx2,
+                                   const int16_t* pSrc, uint8_t* pDst, int dstStep, const uint16_t* qtbl)
+{
+  if(!JpegDecUseAVX2())
+    return func(pSrc, pDst, dstStep, qtbl);
+
+  if(!pending.pSrc)
+  {
+    pending.pSrc    = pSrc;
+    pending.pDst    = pDst;
+    pending.dstStep = dstStep;
+    pending.qtbl    = qtbl;
+    pending.func    = func;
+    return ippStsNoErr;
+  }
+
+  funcx2(pending.pSrc, pending.pDst, pending.dstStep, pending.qtbl, pSrc, pDst, dstStep, qtbl);
+  pending.pSrc = 0;
+
+  return ippStsNoErr;
+} // DCTQuantInvPaired()
+
+static IppStatus DCTQuantInv8x8LS(IDCT8x8Pending& pending, const int16_t* pSrc, uint8_t* pDst, int dstStep, const uint16_t* qtbl)
+{
+  return DCTQuantInvPaired(pending.block[0], mfxiDCTQuantInv8x8LS_JPEG_16s8u_C1R,
+                           DCTQuantInv8x8LS_JPEG_16s8u_C1R_x2_AVX2, pSrc, pDst, dstStep, qtbl);
+} // DCTQuantInv8x8LS()
+
+static IppStatus DCTQuantInv8x8To4x4LS(IDCT8x8Pending& pending, const int16_t* pSrc, uint8_t* pDst, int dstStep, const uint16_t* qtbl)
+{
+  return DCTQuantInvPaired(pending.block[1], mfxiDCTQuantInv8x8To4x4LS_JPEG_16s8u_C1R,
+                           DCTQuantInv8x8To4x4LS_JPEG_16s8u_C1R_x2_AVX2, pSrc, pDst, dstStep, qtbl);
+} // DCTQuantInv8x8To4x4LS()
+
+static IppStatus DCTQuantInv8x8To2x2LS(IDCT8x8Pending& pending, const int16_t* pSrc, uint8_t* pDst, int dstStep, const uint16_t* qtbl)
+{
+  return DCTQuantInvPaired(pending.block[2], mfxiDCTQuantInv8x8To2x2LS_JPEG_16s8u_C1R,
+                           DCTQuantInv8x8To2x2LS_JPEG_16s8u_C1R_x2_AVX2, pSrc, pDst, dstStep, qtbl);
+} // DCTQuantInv8x8To2x2LS()
+
+static IppStatus FlushDCTQuantInv8x8LS(IDCT8x8Pending& pending)
+{
+  IppStatus status = ippStsNoErr;
+
+  for(IDCTPendingBlock& block : pending.block)
+  {
+    if(block.pSrc && ippStsNoErr <= status)
+      status = block.func(block.pSrc, block.pDst, block.dstStep, block.qtbl);
+    block.pSrc = 0;
+  }
+
+  return status;
+} // FlushDCTQuantInv8x8LS()
+
+static IppStatus SampleUpRowH2V1_Triangle(const uint8_t* pSrc, int srcWidth, uint8_t* pDst)
+{
+  if(JpegDecUseAVX2() && srcWidth >= 18)
+  {
+    SampleUpRowH2V1_Triangle_JPEG_8u_C1_AVX2(pSrc, srcWidth, pDst);
+    return ippStsNoErr;
+  }
+
+  return mfxiSampleUpRowH2V1_Triangle_JPEG_8u_C1(pSrc, srcWidth, pDst);
+} // SampleUpRowH2V1_Triangle()
+
+static IppStatus SampleUpRowH2V2_Triangle(const uint8_t* pSrc1, const uint8_t* pSrc2, int srcWidth, uint8_t* pDst)
+{
+  if(JpegDecUseAVX2() && srcWidth >= 18)
+  {
+    SampleUpRowH2V2_Triangle_JPEG_8u_C1_AVX2(pSrc1, pSrc2, srcWidth, pDst);
+    return ippStsNoErr;
+  }
+
+  return mfxiSampleUpRowH2V2_Triangle_JPEG_8u_C1(pSrc1, pSrc2, srcWidth, pDst);
+} // SampleUpRowH2V2_Triangle()
+
+static IppStatus YCbCrToBGR(const uint8_t* pSrc[3], int srcStep, uint8_t* pDst, int dstStep, mfxSize roi)
+{
+  int done = 0;
+
+  if(JpegDecUseAVX2())
+  {
+    // IPP rejects a one column wide roi, so leave it 33 columns instead
+    mfxSize roiAVX2 = roi;
+    if((roi.width & 31) == 1)
+      roiAVX2.width -= 32;
+
+    if(roiAVX2.width >= 32)
+      done = YCbCrToBGR_JPEG_8u_P3C4R_AVX2(pSrc, srcStep, pDst, dstStep, roiAVX2, 0xFF);
+  }
+
+  if(done == roi.width)
+    return ippStsNoErr;
+
+  const uint8_t* pTail[3] = { pSrc[0] + done, pSrc[1] + done, pSrc[2] + done };
+  roi.width -= done;
+
+  return mfxiYCbCrToBGR_JPEG_8u_P3C4R(pTail, srcStep, pDst + 4 * done, dstStep, roi, 0xFF);
+} // YCbCrToBGR()
+
 CJPEGDecoder::CJPEGDecoder(void)
     : m_dst()
 {
@@ -1503,6 +1626,11 @@ JERRCODE CJPEGDecoder::ColorConvert(uint32_t rowMCU, uint32_t colMCU, uint32_t m
           rowMCU * m_curr_scan->mcuHeight * m_curr_scan->min_v_factor * dstStep[1] / (2 * m_dd_factor) + 
           colMCU * m_curr_scan->mcuWidth * m_curr_scan->min_h_factor;
 
+      // both chroma components in the scan, interleave them in one pass
+      bool interleaveUV = JpegDecUseAVX2() &&
+                          m_curr_scan->first_comp <= 1 &&
+                          m_curr_scan->first_comp + m_curr_scan->ncomps >= 3;
+
       for(int n = m_curr_scan->first_comp; n < m_curr_scan->first_comp + m_curr_scan->ncomps; n++)
       {
           if(n == 0)
@@ -1513,6 +1641,14 @@ JERRCODE CJPEGDecoder::ColorConvert(uint32_t rowMCU, uint32_t colMCU, uint32_t m
                       pDst8u[0][i*dstStep[0] + j] = pSrc8u[0][i*srcStep[0] + j];
                   }
           }
+          else if(interleaveUV)
+          {
+              if(n == 1)
+              {
+                  for(int i=0; i < roi.height >> 1; i++)
+                      InterleaveUV_8u_AVX2(pSrc8u[1] + i*srcStep[1], pSrc8u[2] + i*srcStep[2], roi.width >> 1, pDst8u[1] + i*dstStep[1]);
+              }
+          }
           else
           {
               for(int i=0; i < roi.height >> 1; i++)
@@ -1691,7 +1827,7 @@ JERRCODE CJPEGDecoder::ColorConvert(uint32_t rowMCU, uint32_t colMCU, uint32_t m
           pDst8u   = m_dst.p.Data8u[0] + rowMCU * m_curr_scan->mcuHeight * m_curr_scan->min_v_factor * dstStep / m_dd_factor + 
               colMCU * m_curr_scan->mcuWidth * m_curr_scan->min_h_factor * bpp;
 
-          status = mfxiYCbCrToBGR_JPEG_8u_P3C4R(pSrc8u, srcStep, pDst8u, dstStep, roi, 0xFF);
+          status = YCbCrToBGR(pSrc8u, srcStep, pDst8u, dstStep, roi);
 
           if(ippStsNoErr != status)
           {
@@ -1759,7 +1895,7 @@ JERRCODE CJPEGDecoder::UpSampling(uint32_t rowMCU, uint32_t colMCU, uint32_t max
               pixelToProcess = std::min(tileSize, srcWidth / m_dd_factor);
               while(j < (int) srcWidth / m_dd_factor)
               {
-                  status = mfxiSampleUpRowH2V1_Triangle_JPEG_8u_C1(pSrc + j, pixelToProcess , pDst + j * 2);
+                  status = SampleUpRowH2V1_Triangle(pSrc + j, pixelToProcess , pDst + j * 2);
                   if(ippStsNoErr != status)
                   {
                     LOG0("Error: mfxiSampleUpRowH2V1_Triangle_JPEG_8u_C1() failed!");
@@ -1849,7 +1985,7 @@ JERRCODE CJPEGDecoder::UpSampling(uint32_t rowMCU, uint32_t colMCU, uint32_t max
           pixelToProcess = std::min(tileSize, srcWidth / m_dd_factor);
           while(j < (int) srcWidth / m_dd_factor)
           {
-              status = mfxiSampleUpRowH2V2_Triangle_JPEG_8u_C1(pSrc + j, pSrc + j, pixelToProcess, pDst + j * 2);    
+              status = SampleUpRowH2V2_Triangle(pSrc + j, pSrc + j, pixelToProcess, pDst + j * 2);    
               if(ippStsNoErr != status)
               {
                 LOG0("Error: mfxiSampleUpRowH2V2_Triangle_JPEG_8u_C1() failed!");
@@ -1868,7 +2004,7 @@ JERRCODE CJPEGDecoder::UpSampling(uint32_t rowMCU, uint32_t colMCU, uint32_t max
               pixelToProcess = std::min(tileSize, srcWidth / m_dd_factor);
               while(j < (int) srcWidth / m_dd_factor)
               {
-                  status = mfxiSampleUpRowH2V2_Triangle_JPEG_8u_C1(pSrc + j, pSrc + srcStep + j, pixelToProcess, pDst + j * 2);    
+                  status = SampleUpRowH2V2_Triangle(pSrc + j, pSrc + srcStep + j, pixelToProcess, pDst + j * 2);    
                   if(ippStsNoErr != status)
                   {
                     LOG0("Error: mfxiSampleUpRowH2V2_Triangle_JPEG_8u_C1() failed!");
@@ -1884,7 +2020,7 @@ JERRCODE CJPEGDecoder::UpSampling(uint32_t rowMCU, uint32_t colMCU, uint32_t max
               pixelToProcess = std::min(tileSize, srcWidth / m_dd_factor);
               while(j < (int) srcWidth / m_dd_factor)
               {
-                  status = mfxiSampleUpRowH2V2_Triangle_JPEG_8u_C1(pSrc + srcStep + j, pSrc + j, pixelToProcess, pDst + j * 2);    
+                  status = SampleUpRowH2V2_Triangle(pSrc + srcStep + j, pSrc + j, pixelToProcess, pDst + j * 2);    
                   if(ippStsNoErr != status)
                   {
                     LOG0("Error: mfxiSampleUpRowH2V2_Triangle_JPEG_8u_C1() failed!");
@@ -1907,7 +2043,7 @@ JERRCODE CJPEGDecoder::UpSampling(uint32_t rowMCU, uint32_t colMCU, uint32_t max
                  LOG0("Error: CCBuferPtr out of bound!");
                  return JPEG_ERR_BUFF;
               }
-              status = mfxiSampleUpRowH2V2_Triangle_JPEG_8u_C1(pSrc + j, pSrc + j, pixelToProcess, pDst + j * 2);    
+              status = SampleUpRowH2V2_Triangle(pSrc + j, pSrc + j, pixelToProcess, pDst + j * 2);    
               if(ippStsNoErr != status)
               {
                 LOG0("Error: mfxiSampleUpRowH2V2_Triangle_JPEG_8u_C1() failed!");
@@ -1954,7 +2090,7 @@ JERRCODE CJPEGDecoder::UpSampling(uint32_t rowMCU, uint32_t colMCU, uint32_t max
               pixelToProcess = std::min(tileSize, srcWidth / m_dd_factor);
               while(j < (int) srcWidth / m_dd_factor)
               {
-                  status = mfxiSampleUpRowH2V1_Triangle_JPEG_8u_C1(pSrc + j, pixelToProcess, pTmp.get() + j * 2);
+                  status = SampleUpRowH2V1_Triangle(pSrc + j, pixelToProcess, pTmp.get() + j * 2);
                   if(ippStsNoErr != status)
                   {
                     LOG0("Error: mfxiSampleUpRowH2V1_Triangle_JPEG_8u_C1() failed!");
@@ -1968,7 +2104,7 @@ JERRCODE CJPEGDecoder::UpSampling(uint32_t rowMCU, uint32_t colMCU, uint32_t max
               pixelToProcess = std::min(2 * tileSize, 2 * srcWidth / m_dd_factor);
               while(j < 2 * (int) srcWidth / m_dd_factor)
               {
-                  status = mfxiSampleUpRowH2V1_Triangle_JPEG_8u_C1(pTmp.get() + j, pixelToProcess, pDst + j * 2);
+                  status = SampleUpRowH2V1_Triangle(pTmp.get() + j, pixelToProcess, pDst + j * 2);
                   if(ippStsNoErr != status)
                   {
                     LOG0("Error: mfxiSampleUpRowH2V1_Triangle_JPEG_8u_C1() failed!");
@@ -2535,6 +2671,7 @@ JERRCODE CJPEGDecoder::ReconstructMCURowBL8x8_NxN(int16_t* pMCUBuf,
   int       dstStep = m_ccWidth;
   int status;
   CJPEGColorComponent* curr_comp;
+  IDCT8x8Pending pending = {};
   const int thread_id = 0;
 
   for(mcu_col = colMCU; mcu_col < maxMCU; mcu_col++)
@@ -2603,7 +2740,7 @@ JERRCODE CJPEGDecoder::ReconstructMCURowBL8x8_NxN(int16_t* pMCUBuf,
           }
           else      // 8x8
           {
-            status = mfxiDCTQuantInv8x8LS_JPEG_16s8u_C1R(pMCUBuf, dst, dstStep, qtbl);
+            status = DCTQuantInv8x8LS(pending, pMCUBuf, dst, dstStep, qtbl);
           }
 
           curr_lnz = curr_lnz + 1;
@@ -2620,6 +2757,13 @@ JERRCODE CJPEGDecoder::ReconstructMCURowBL8x8_NxN(int16_t* pMCUBuf,
     } // for m_jpeg_ncomp
   } // for m_numxMCU
 
+  status = FlushDCTQuantInv8x8LS(pending);
+  if(ippStsNoErr > status)
+  {
+    LOG0("Error: mfxiDCTQuantInv8x8LS_JPEG_16s8u_C1R() failed!");
+    return JPEG_ERR_INTERNAL;
+  }
+
   return JPEG_OK;
 } // CJPEGDecoder::ReconstructMCURowBL8x8_NxN()
 
@@ -2636,6 +2780,7 @@ JERRCODE CJPEGDecoder::ReconstructMCURowBL8x8(int16_t* pMCUBuf,
   uint16_t*   qtbl;
   int status;
   CJPEGColorComponent* curr_comp;
+  IDCT8x8Pending pending = {};
   const uint32_t thread_id = 0;
 
   for(mcu_col = colMCU; mcu_col < maxMCU; mcu_col++)
@@ -2673,7 +2818,7 @@ JERRCODE CJPEGDecoder::ReconstructMCURowBL8x8(int16_t* pMCUBuf,
           p = dst + l*8;
 
 
-          status = mfxiDCTQuantInv8x8LS_JPEG_16s8u_C1R(pMCUBuf, p, dstStep, qtbl);
+          status = DCTQuantInv8x8LS(pending, pMCUBuf, p, dstStep, qtbl);
 
           if(ippStsNoErr > status)
           {
@@ -2687,6 +2832,13 @@ JERRCODE CJPEGDecoder::ReconstructMCURowBL8x8(int16_t* pMCUBuf,
     } // for m_jpeg_ncomp
   } // for m_numxMCU
 
+  status = FlushDCTQuantInv8x8LS(pending);
+  if(ippStsNoErr > status)
+  {
+    LOG0("Error: mfxiDCTQuantInv8x8LS_JPEG_16s8u_C1R() failed!");
+    return JPEG_ERR_INTERNAL;
+  }
+
   return JPEG_OK;
 
 } // CJPEGDecoder::ReconstructMCURowBL8x8()
@@ -2704,6 +2856,7 @@ JERRCODE CJPEGDecoder::ReconstructMCURowBL8x8To4x4(int16_t* pMCUBuf,
   int status;
   CJPEGColorComponent* curr_comp;
   const int thread_id = 0;
+  IDCT8x8Pending pending = {};
 
   for(mcu_col = colMCU; mcu_col < maxMCU; mcu_col++)
   {
@@ -2730,7 +2883,7 @@ JERRCODE CJPEGDecoder::ReconstructMCURowBL8x8To4x4(int16_t* pMCUBuf,
           {
             dst += ((l == 0) ? 0 : 1)*4;
 
-          status = mfxiDCTQuantInv8x8To4x4LS_JPEG_16s8u_C1R(pMCUBuf, dst, dstStep, qtbl);
+          status = DCTQuantInv8x8To4x4LS(pending, pMCUBuf, dst, dstStep, qtbl);
 
           if(ippStsNoErr > status)
           {
@@ -2751,7 +2904,7 @@ JERRCODE CJPEGDecoder::ReconstructMCURowBL8x8To4x4(int16_t* pMCUBuf,
             {
               dst += ((l == 0) ? 0 : 1)*8;
 
-              status = mfxiDCTQuantInv8x8LS_JPEG_16s8u_C1R(pMCUBuf, dst, dstStep, qtbl);
+              status = DCTQuantInv8x8LS(pending, pMCUBuf, dst, dstStep, qtbl);
 
               if(ippStsNoErr > status)
               {
@@ -2778,7 +2931,7 @@ JERRCODE CJPEGDecoder::ReconstructMCURowBL8x8To4x4(int16_t* pMCUBuf,
             {
               dst += ((l == 0) ? 0 : 1)*4;
 
-              status = mfxiDCTQuantInv8x8To4x4LS_JPEG_16s8u_C1R(pMCUBuf, dst, dstStep, qtbl);
+              status = DCTQuantInv8x8To4x4LS(pending, pMCUBuf, dst, dstStep, qtbl);
 
               if(ippStsNoErr > status)
               {
@@ -2793,6 +2946,13 @@ JERRCODE CJPEGDecoder::ReconstructMCURowBL8x8To4x4(int16_t* pMCUBuf,
     } // for m_jpeg_ncomp
   } // for m_numxMCU
 
+  status = FlushDCTQuantInv8x8LS(pending);
+  if(ippStsNoErr > status)
+  {
+    LOG0("Error: mfxiDCTQuantInv8x8To4x4LS_JPEG_16s8u_C1R() failed!");
+    return JPEG_ERR_INTERNAL;
+  }
+
   return JPEG_OK;
 } // CJPEGDecoder::ReconstructMCURowBL8x8To4x4()
 
@@ -2809,6 +2969,7 @@ JERRCODE CJPEGDecoder::ReconstructMCURowBL8x8To2x2(int16_t* pMCUBuf,
   int status;
   CJPEGColorComponent* curr_comp;
   const int thread_id = 0;
+  IDCT8x8Pending pending = {};
 
   for(mcu_col = colMCU; mcu_col < maxMCU; mcu_col++)
   {
@@ -2835,7 +2996,7 @@ JERRCODE CJPEGDecoder::ReconstructMCURowBL8x8To2x2(int16_t* pMCUBuf,
           {
             dst += ((l == 0) ? 0 : 1)*2;
 
-            status = mfxiDCTQuantInv8x8To2x2LS_JPEG_16s8u_C1R(pMCUBuf, dst, dstStep, qtbl);
+            status = DCTQuantInv8x8To2x2LS(pending, pMCUBuf, dst, dstStep, qtbl);
 
             if(ippStsNoErr > status)
             {
@@ -2856,7 +3017,7 @@ JERRCODE CJPEGDecoder::ReconstructMCURowBL8x8To2x2(int16_t* pMCUBuf,
             {
               dst += ((l == 0) ? 0 : 1)*4;
 
-              status = mfxiDCTQuantInv8x8To4x4LS_JPEG_16s8u_C1R(pMCUBuf, dst, dstStep, qtbl);
+              status = DCTQuantInv8x8To4x4LS(pending, pMCUBuf, dst, dstStep, qtbl);
 
               if(ippStsNoErr > status)
               {
@@ -2883,7 +3044,7 @@ JERRCODE CJPEGDecoder::ReconstructMCURowBL8x8To2x2(int16_t* pMCUBuf,
             {
               dst += ((l == 0) ? 0 : 1)*2;
 
-              status = mfxiDCTQuantInv8x8To2x2LS_JPEG_16s8u_C1R(pMCUBuf, dst, dstStep, qtbl);
+              status = DCTQuantInv8x8To2x2LS(pending, pMCUBuf, dst, dstStep, qtbl);
 
               if(ippStsNoErr > status)
               {
@@ -2898,6 +3059,13 @@ JERRCODE CJPEGDecoder::ReconstructMCURowBL8x8To2x2(int16_t* pMCUBuf,
     } // for m_jpeg_ncomp
   } // for m_numxMCU
 
+  status = FlushDCTQuantInv8x8LS(pending);
+  if(ippStsNoErr > status)
+  {
+    LOG0("Error: mfxiDCTQuantInv8x8To2x2LS_JPEG_16s8u_C1R() failed!");
+    return JPEG_ERR_INTERNAL;
+  }
+
   return JPEG_OK;
 } // CJPEGDecoder::ReconstructMCURowBL8x8To2x2()
 
@@ -2915,6 +3083,7 @@ JERRCODE CJPEGDecoder::ReconstructMCURowBL8x8To1x1(int16_t* pMCUBuf,
 
   CJPEGColorComponent* curr_comp;
   const int thread_id = 0;
+  IDCT8x8Pending pending = {};
 
   for(mcu_col = colMCU; mcu_col < maxMCU; mcu_col++)
   {
@@ -2957,7 +3126,7 @@ JERRCODE CJPEGDecoder::ReconstructMCURowBL8x8To1x1(int16_t* pMCUBuf,
             {
               dst += ((l == 0) ? 0 : 1)*2;
 
-              status = mfxiDCTQuantInv8x8To2x2LS_JPEG_16s8u_C1R(pMCUBuf, dst, dstStep, qtbl);
+              status = DCTQuantInv8x8To2x2LS(pending, pMCUBuf, dst, dstStep, qtbl);
 
               if(ippStsNoErr > status)
               {
@@ -2994,6 +3163,13 @@ JERRCODE CJPEGDecoder::ReconstructMCURowBL8x8To1x1(int16_t* pMCUBuf,
     } // for m_jpeg_ncomp
   } // for m_numxMCU
 
+  status = FlushDCTQuantInv8x8LS(pending);
+  if(ippStsNoErr > status)
+  {
+    LOG0("Error: mfxiDCTQuantInv8x8To2x2LS_JPEG_16s8u_C1R() failed!");
+    return JPEG_ERR_INTERNAL;
+  }
+
   return JPEG_OK;
 } // CJPEGDecoder::ReconstructMCURowBL8x8To1x1()
 
@@ -0,0 +1,591 @@
+// Copyright (c) 2020 Intel Corporation
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "umc_defs.h"
+#if defined (MFX_ENABLE_MJPEG_VIDEO_DECODE) && defined(MFX_ENABLE_SW_FALLBACK)
+
+#include <immintrin.h>
+#include "jpegdec_avx2.h"
+
+// Inverse DCT is the two-lane version of the SSE2 code in contrib/ipp
+// (pjdecdctcn.c): every 128-bit lane holds one row of its own block,
+// so the arithmetic and rounding are exactly the same.
+
+#define SH_2020 _MM_SHUFFLE(2,0,2,0)
+#define SH_3131 _MM_SHUFFLE(3,1,3,1)
+#define SH_1032 _MM_SHUFFLE(1,0,3,2)
+#define SH_0123 _MM_SHUFFLE(0,1,2,3)
+
+#define SHIFT_INV_ROW 11
+#define SHIFT_INV_COL 6
+
+alignas(16) static const int16_t tab_i_04[32] =
+   { 16384,  21407,  16384,   8867, -16384,  21407,  16384,  -8867,
+     16384,  -8867,  16384, -21407,  16384,   8867, -16384, -21407,
+     22725,  19266,  19266,  -4520,   4520,  19266,  19266, -22725,
+     12873, -22725,   4520, -12873,  12873,   4520, -22725, -12873 };
+alignas(16) static const int16_t tab_i_17[32] =
+   { 22725,  29692,  22725,  12299, -22725,  29692,  22725, -12299,
+     22725, -12299,  22725, -29692,  22725,  12299, -22725, -29692,
+     31521,  26722,  26722,  -6270,   6270,  26722,  26722, -31521,
+     17855, -31521,   6270, -17855,  17855,   6270, -31521, -17855 };
+alignas(16) static const int16_t tab_i_26[32] =
+   { 21407,  27969,  21407,  11585, -21407,  27969,  21407, -11585,
+     21407, -11585,  21407, -27969,  21407,  11585, -21407, -27969,
+     29692,  25172,  25172,  -5906,   5906,  25172,  25172, -29692,
+     16819, -29692,   5906, -16819,  16819,   5906, -29692, -16819 };
+alignas(16) static const int16_t tab_i_35[32] =
+   { 19266,  25172,  19266,  10426, -19266,  25172,  19266, -10426,
+     19266, -10426,  19266, -25172,  19266,  10426, -19266, -25172,
+     26722,  22654,  22654,  -5315,   5315,  22654,  22654, -26722,
+     15137, -26722,   5315, -15137,  15137,   5315, -26722, -15137 };
+
+// row rounding with the precision correction of every row
+static const int32_t round_i[8] = { 65536, 2901, 2260, 1704, 1024, 455, 512, 373 };
+
+static inline __m256i Load2x128(const void* p0, const void* p1)
+{
+    return _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)p0)),
+                                   _mm_loadu_si128((const __m128i*)p1), 1);
+}
+
+static inline __m256i LoadTab(const int16_t* p)
+{
+    return _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i*)p));
+}
+
+static inline __m256i IDCTRow(const int16_t* pSrc0, const uint16_t* pQnt0,
+                              const int16_t* pSrc1, const uint16_t* pQnt1,
+                              int row, const int16_t* tab)
+{
+    __m256i x = _mm256_mullo_epi16(Load2x128(pSrc0 + row*8, pSrc1 + row*8),
+                                   Load2x128(pQnt0 + row*8, pQnt1 + row*8));
+
+    __m256i xe = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(x, SH_2020), SH_2020);
+    __m256i xo = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(x, SH_3131), SH_3131);
+
+    __m256i t1e = _mm256_madd_epi16(xe, LoadTab(tab + 0));
+    __m256i t2e = _mm256_madd_epi16(xe, LoadTab(tab + 8));
+    __m256i t1o = _mm256_madd_epi16(xo, LoadTab(tab + 16));
+    __m256i t2o = _mm256_madd_epi16(xo, LoadTab(tab + 24));
+
+    t1e = _mm256_add_epi32(t1e, _mm256_set1_epi32(round_i[row]));
+    t2e = _mm256_shuffle_epi32(t2e, SH_1032);
+    t2o = _mm256_shuffle_epi32(t2o, SH_1032);
+
+    __m256i a0 = _mm256_add_epi32(t1e, t2e);
+    __m256i b0 = _mm256_add_epi32(t1o, t2o);
+    __m256i s0 = _mm256_srai_epi32(_mm256_add_epi32(a0, b0), SHIFT_INV_ROW);
+    __m256i s1 = _mm256_srai_epi32(_mm256_sub_epi32(a0, b0), SHIFT_INV_ROW);
+
+    return _mm256_shufflehi_epi16(_mm256_packs_epi32(s0, s1), SH_0123);
+}
+
+static inline void StoreRows(__m256i ya, __m256i yb, int row,
+                             uint8_t* pDst0, int dstStep0, uint8_t* pDst1, int dstStep1)
+{
+    const __m256i level = _mm256_set1_epi16(128);
+    __m256i y = _mm256_packus_epi16(_mm256_add_epi16(ya, level), _mm256_add_epi16(yb, level));
+    __m128i lo = _mm256_castsi256_si128(y);
+    __m128i hi = _mm256_extracti128_si256(y, 1);
+
+    _mm_storel_epi64((__m128i*)(pDst0 + row*dstStep0), lo);
+    _mm_storeh_pd((double*)(pDst0 + (row + 1)*dstStep0), _mm_castsi128_pd(lo));
+    _mm_storel_epi64((__m128i*)(pDst1 + row*dstStep1), hi);
+    _mm_storeh_pd((double*)(pDst1 + (row + 1)*dstStep1), _mm_castsi128_pd(hi));
+}
+
+void DCTQuantInv8x8LS_JPEG_16s8u_C1R_x2_AVX2(
+    const int16_t* pSrc0, uint8_t* pDst0, int dstStep0, const uint16_t* pQuantInvTable0,
+    const int16_t* pSrc1, uint8_t* pDst1, int dstStep1, const uint16_t* pQuantInvTable1)
+{
+    // rows
+    __m256i x0 = IDCTRow(pSrc0, pQuantInvTable0, pSrc1, pQuantInvTable1, 0, tab_i_04);
+    __m256i x4 = IDCTRow(pSrc0, pQuantInvTable0, pSrc1, pQuantInvTable1, 4, tab_i_04);
+    __m256i x1 = IDCTRow(pSrc0, pQuantInvTable0, pSrc1, pQuantInvTable1, 1, tab_i_17);
+    __m256i x7 = IDCTRow(pSrc0, pQuantInvTable0, pSrc1, pQuantInvTable1, 7, tab_i_17);
+    __m256i x3 = IDCTRow(pSrc0, pQuantInvTable0, pSrc1, pQuantInvTable1, 3, tab_i_35);
+    __m256i x5 = IDCTRow(pSrc0, pQuantInvTable0, pSrc1, pQuantInvTable1, 5, tab_i_35);
+    __m256i x2 = IDCTRow(pSrc0, pQuantInvTable0, pSrc1, pQuantInvTable1, 2, tab_i_26);
+    __m256i x6 = IDCTRow(pSrc0, pQuantInvTable0, pSrc1, pQuantInvTable1, 6, tab_i_26);
+
+    // columns
+    const __m256i tg_1_16  = _mm256_set1_epi16(13036);
+    const __m256i tg_2_16  = _mm256_set1_epi16(27146);
+    const __m256i tg_3_16  = _mm256_set1_epi16(-21746);
+    const __m256i cos_4_16 = _mm256_set1_epi16(-19195);
+
+    __m256i t0, t1, t2, t3, t4, t5, t6, t7;
+    __m256i tp03, tm03, tp12, tm12, tp65, tm65, tp465, tm465, tp765, tm765;
+
+    t3    = _mm256_adds_epi16(_mm256_mulhi_epi16(x3, tg_3_16), x3);
+    t5    = _mm256_adds_epi16(_mm256_mulhi_epi16(x5, tg_3_16), x5);
+    tm765 = _mm256_adds_epi16(t5, x3);
+    tm465 = _mm256_subs_epi16(x5, t3);
+
+    t1    = _mm256_mulhi_epi16(x1, tg_1_16);
+    t7    = _mm256_mulhi_epi16(x7, tg_1_16);
+    tp765 = _mm256_adds_epi16(x1, t7);
+    tp465 = _mm256_subs_epi16(t1, x7);
+
+    t7    = _mm256_adds_epi16(tp765, tm765);
+    tp65  = _mm256_subs_epi16(tp765, tm765);
+    t4    = _mm256_adds_epi16(tp465, tm465);
+    tm65  = _mm256_subs_epi16(tp465, tm465);
+
+    t2    = _mm256_mulhi_epi16(x2, tg_2_16);
+    t6    = _mm256_mulhi_epi16(x6, tg_2_16);
+    tm03  = _mm256_adds_epi16(x2, t6);
+    tm12  = _mm256_subs_epi16(t2, x6);
+
+    t5    = _mm256_subs_epi16(tp65, tm65);
+    t6    = _mm256_adds_epi16(tp65, tm65);
+    t5    = _mm256_adds_epi16(_mm256_mulhi_epi16(t5, cos_4_16), t5);
+    t6    = _mm256_adds_epi16(_mm256_mulhi_epi16(t6, cos_4_16), t6);
+
+    tp03  = _mm256_adds_epi16(x0, x4);
+    tp12  = _mm256_subs_epi16(x0, x4);
+
+    t0    = _mm256_adds_epi16(tp03, tm03);
+    t3    = _mm256_subs_epi16(tp03, tm03);
+    t1    = _mm256_adds_epi16(tp12, tm12);
+    t2    = _mm256_subs_epi16(tp12, tm12);
+
+    StoreRows(_mm256_srai_epi16(_mm256_adds_epi16(t0, t7), SHIFT_INV_COL),
+              _mm256_srai_epi16(_mm256_adds_epi16(t1, t6), SHIFT_INV_COL),
+              0, pDst0, dstStep0, pDst1, dstStep1);
+    StoreRows(_mm256_srai_epi16(_mm256_adds_epi16(t2, t5), SHIFT_INV_COL),
+              _mm256_srai_epi16(_mm256_adds_epi16(t3, t4), SHIFT_INV_COL),
+              2, pDst0, dstStep0, pDst1, dstStep1);
+    StoreRows(_mm256_srai_epi16(_mm256_subs_epi16(t3, t4), SHIFT_INV_COL),
+              _mm256_srai_epi16(_mm256_subs_epi16(t2, t5), SHIFT_INV_COL),
+              4, pDst0, dstStep0, pDst1, dstStep1);
+    StoreRows(_mm256_srai_epi16(_mm256_subs_epi16(t1, t6), SHIFT_INV_COL),
+              _mm256_srai_epi16(_mm256_subs_epi16(t0, t7), SHIFT_INV_COL),
+              6, pDst0, dstStep0, pDst1, dstStep1);
+} // DCTQuantInv8x8LS_JPEG_16s8u_C1R_x2_AVX2()
+
+
+// Scaled inverse DCTs for 1/2 and 1/4 size decoding, two-lane versions of
+// mfxdct_8x8To4x4_inv_16s and mfxdct_8x8To2x2_inv_16s
+// (asm_intel64/pidct8844im7as.s). Row rounding is added to the low half
+// of a row only, as there.
+
+alignas(16) static const int16_t tab_i4_04[16] =
+   { 16384,  15137,  16384, -15137,  20995,   7373,   8697, -17799,
+         0,  -6270,      0,   6270,  -4926,  -4176,  11893,  -1730 };
+alignas(16) static const int16_t tab_i4_17[16] =
+   { 22725,  20995,  22725, -20995,  29121,  10226,  12063, -24688,
+         0,  -8697,      0,   8697,  -6833,  -5793,  16496,  -2399 };
+alignas(16) static const int16_t tab_i4_26[16] =
+   { 21407,  19777,  21407, -19777,  27432,   9633,  11363, -23256,
+         0,  -8192,      0,   8192,  -6436,  -5457,  15539,  -2260 };
+alignas(16) static const int16_t tab_i4_35[16] =
+   { 19266,  17799,  19266, -17799,  24688,   8669,  10226, -20929,
+         0,  -7373,      0,   7373,  -5793,  -4911,  13985,  -2034 };
+
+alignas(16) static const int16_t tab_i2_04[16] =
+   { 16384,      0,  16384,      0,      0,      0,      0,      0,
+     14846,  -5213, -14846,   5213,   3483,  -2953,  -3483,   2953 };
+alignas(16) static const int16_t tab_i2_17[16] =
+   { 22725,      0,  22725,      0,      0,      0,      0,      0,
+     20592,  -7231, -20592,   7231,   4832,  -4096,  -4832,   4096 };
+alignas(16) static const int16_t tab_i2_35[16] =
+   { 19266,      0,  19266,      0,      0,      0,      0,      0,
+     17457,  -6130, -17457,   6130,   4096,  -3472,  -4096,   3472 };
+
+#define SH_3120 _MM_SHUFFLE(3,1,2,0)
+#define SH_1100 _MM_SHUFFLE(1,1,0,0)
+#define SH_3322 _MM_SHUFFLE(3,3,2,2)
+#define SH_3232 _MM_SHUFFLE(3,2,3,2)
+#define SH_2301 _MM_SHUFFLE(2,3,0,1)
+
+#define SHIFT_INV_ROW_SCALED 12
+
+static inline __m256i LowRound(int32_t round)
+{
+    return _mm256_setr_epi32(round, round, 0, 0, round, round, 0, 0);
+}
+
+static inline __m256i DequantRow(const int16_t* pSrc0, const uint16_t* pQnt0,
+                                 const int16_t* pSrc1, const uint16_t* pQnt1, int row)
+{
+    return _mm256_mullo_epi16(Load2x128(pSrc0 + row*8, pSrc1 + row*8),
+                              Load2x128(pQnt0 + row*8, pQnt1 + row*8));
+}
+
+// rows a and b of the same table give four outputs each
+static inline void IDCTRowPairTo4x4(__m256i xa, __m256i xb, const int16_t* tab, int32_t rounda, int32_t roundb,
+                                    __m256i& ya, __m256i& yb)
+{
+    xa = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(xa, SH_3120), SH_3120);
+    xb = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(xb, SH_3120), SH_3120);
+
+    __m256i a = _mm256_add_epi32(_mm256_madd_epi16(_mm256_shuffle_epi32(xa, SH_1100), LoadTab(tab)), LowRound(rounda));
+    __m256i b = _mm256_add_epi32(_mm256_madd_epi16(_mm256_shuffle_epi32(xb, SH_1100), LoadTab(tab)), LowRound(roundb));
+    a = _mm256_add_epi32(a, _mm256_madd_epi16(_mm256_shuffle_epi32(xa, SH_3322), LoadTab(tab + 8)));
+    b = _mm256_add_epi32(b, _mm256_madd_epi16(_mm256_shuffle_epi32(xb, SH_3322), LoadTab(tab + 8)));
+
+    __m256i lo = _mm256_unpacklo_epi64(a, b);
+    __m256i hi = _mm256_unpackhi_epi64(a, b);
+    __m256i s  = _mm256_add_epi32(lo, hi);
+    __m256i d  = _mm256_shuffle_epi32(_mm256_sub_epi32(lo, hi), SH_2301);
+
+    ya = _mm256_srai_epi32(_mm256_unpacklo_epi64(s, d), SHIFT_INV_ROW_SCALED);
+    yb = _mm256_srai_epi32(_mm256_unpackhi_epi64(s, d), SHIFT_INV_ROW_SCALED);
+    ya = _mm256_packs_epi32(ya, ya);
+    yb = _mm256_packs_epi32(yb, yb);
+}
+
+static inline __m256i IDCTRow0To4x4(__m256i x)
+{
+    x = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(x, SH_3120), SH_3120);
+
+    __m256i a = _mm256_add_epi32(_mm256_madd_epi16(_mm256_shuffle_epi32(x, SH_1100), LoadTab(tab_i4_04)),
+                                 _mm256_madd_epi16(_mm256_shuffle_epi32(x, SH_3322), LoadTab(tab_i4_04 + 8)));
+    __m256i b = _mm256_shuffle_epi32(a, SH_3232);
+    a = _mm256_add_epi32(a, LowRound(66560));
+
+    __m256i s = _mm256_add_epi32(b, a);
+    __m256i d = _mm256_sub_epi32(a, b);
+    __m256i y = _mm256_castps_si256(_mm256_shuffle_ps(_mm256_castsi256_ps(s), _mm256_castsi256_ps(d), _MM_SHUFFLE(0,1,1,0)));
+
+    y = _mm256_srai_epi32(y, SHIFT_INV_ROW_SCALED);
+    return _mm256_packs_epi32(y, y);
+}
+
+void DCTQuantInv8x8To4x4LS_JPEG_16s8u_C1R_x2_AVX2(
+    const int16_t* pSrc0, uint8_t* pDst0, int dstStep0, const uint16_t* pQuantInvTable0,
+    const int16_t* pSrc1, uint8_t* pDst1, int dstStep1, const uint16_t* pQuantInvTable1)
+{
+    __m256i x[8];
+    for (int i = 0; i < 8; i++)
+        x[i] = DequantRow(pSrc0, pQuantInvTable0, pSrc1, pQuantInvTable1, i);
+
+    // rows
+    __m256i x0, x1, x2, x3, x5, x6, x7;
+    IDCTRowPairTo4x4(x[3], x[5], tab_i4_35, 3408, 910, x3, x5);
+    IDCTRowPairTo4x4(x[2], x[6], tab_i4_26, 4520, 1024, x2, x6);
+    IDCTRowPairTo4x4(x[1], x[7], tab_i4_17, 5802, 746, x1, x7);
+    x0 = IDCTRow0To4x4(x[0]);
+
+    // columns
+    const __m256i tg_1_16  = _mm256_set1_epi16(13036);
+    const __m256i tg_2_16  = _mm256_set1_epi16(27146);
+    const __m256i tg_3_16  = _mm256_set1_epi16(-21746);
+    const __m256i cos_4_16 = _mm256_set1_epi16(-19195);
+
+    __m256i a = _mm256_adds_epi16(_mm256_adds_epi16(_mm256_mulhi_epi16(x5, tg_3_16), x5), x3);
+    __m256i b = _mm256_subs_epi16(x5, _mm256_adds_epi16(_mm256_mulhi_epi16(x3, tg_3_16), x3));
+    __m256i c = _mm256_subs_epi16(_mm256_mulhi_epi16(x1, tg_1_16), x7);
+    __m256i d = _mm256_adds_epi16(_mm256_mulhi_epi16(x7, tg_1_16), x1);
+    __m256i e = _mm256_adds_epi16(_mm256_mulhi_epi16(x6, tg_2_16), x2);
+    __m256i f = _mm256_subs_epi16(_mm256_mulhi_epi16(x2, tg_2_16), x6);
+
+    __m256i tp = _mm256_adds_epi16(a, d);
+    __m256i tm = _mm256_subs_epi16(d, a);
+    __m256i cm = _mm256_subs_epi16(c, b);
+    __m256i cp = _mm256_adds_epi16(c, b);
+    __m256i fe = _mm256_adds_epi16(f, e);
+
+    __m256i g = _mm256_adds_epi16(tm, cm);
+    __m256i h = _mm256_subs_epi16(tm, cm);
+    g = _mm256_adds_epi16(_mm256_adds_epi16(g, _mm256_mulhi_epi16(g, cos_4_16)), tp);
+    h = _mm256_adds_epi16(_mm256_adds_epi16(_mm256_mulhi_epi16(h, cos_4_16), h), cp);
+
+    __m256i x00 = _mm256_adds_epi16(x0, x0);
+    __m256i ep  = _mm256_adds_epi16(fe, x00);
+    __m256i em  = _mm256_subs_epi16(x00, fe);
+
+    __m256i y0 = _mm256_srai_epi16(_mm256_adds_epi16(g, ep), SHIFT_INV_COL);
+    __m256i y1 = _mm256_srai_epi16(_mm256_adds_epi16(h, em), SHIFT_INV_COL);
+    __m256i y2 = _mm256_srai_epi16(_mm256_subs_epi16(em, h), SHIFT_INV_COL);
+    __m256i y3 = _mm256_srai_epi16(_mm256_subs_epi16(ep, g), SHIFT_INV_COL);
+
+    // level shift, four rows of four pixels per lane
+    const __m256i level = _mm256_set1_epi16(128);
+    __m256i y = _mm256_packus_epi16(_mm256_adds_epi16(_mm256_unpacklo_epi64(y0, y1), level),
+                                    _mm256_adds_epi16(_mm256_unpacklo_epi64(y2, y3), level));
+    __m128i lo = _mm256_castsi256_si128(y);
+    __m128i hi = _mm256_extracti128_si256(y, 1);
+
+    for (int i = 0; i < 4; i++)
+    {
+        *(int32_t*)(pDst0 + i*dstStep0) = _mm_cvtsi128_si32(lo);
+        *(int32_t*)(pDst1 + i*dstStep1) = _mm_cvtsi128_si32(hi);
+        lo = _mm_srli_si128(lo, 4);
+        hi = _mm_srli_si128(hi, 4);
+    }
+} // DCTQuantInv8x8To4x4LS_JPEG_16s8u_C1R_x2_AVX2()
+
+
+static inline __m256i IDCTRowTo2x2(__m256i x, const int16_t* tab, int32_t round)
+{
+    __m256i xe = _mm256_shufflelo_epi16(x, SH_2020);
+    __m256i xo = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(x, SH_3131), SH_3131);
+
+    __m256i a = _mm256_add_epi32(_mm256_madd_epi16(xe, LoadTab(tab)), LowRound(round));
+    __m256i b = _mm256_madd_epi16(xo, LoadTab(tab + 8));
+    b = _mm256_add_epi32(_mm256_shuffle_epi32(b, SH_3232), b);
+
+    __m256i y = _mm256_srai_epi32(_mm256_add_epi32(a, b), SHIFT_INV_ROW_SCALED);
+    return _mm256_packs_epi32(y, y);
+}
+
+void DCTQuantInv8x8To2x2LS_JPEG_16s8u_C1R_x2_AVX2(
+    const int16_t* pSrc0, uint8_t* pDst0, int dstStep0, const uint16_t* pQuantInvTable0,
+    const int16_t* pSrc1, uint8_t* pDst1, int dstStep1, const uint16_t* pQuantInvTable1)
+{
+    // rows, even ones but the first don't contribute
+    __m256i x0 = IDCTRowTo2x2(DequantRow(pSrc0, pQuantInvTable0, pSrc1, pQuantInvTable1, 0), tab_i2_04, 67072);
+    __m256i x1 = IDCTRowTo2x2(DequantRow(pSrc0, pQuantInvTable0, pSrc1, pQuantInvTable1, 1), tab_i2_17, 5802);
+    __m256i x7 = IDCTRowTo2x2(DequantRow(pSrc0, pQuantInvTable0, pSrc1, pQuantInvTable1, 7), tab_i2_17, 746);
+    __m256i x3 = IDCTRowTo2x2(DequantRow(pSrc0, pQuantInvTable0, pSrc1, pQuantInvTable1, 3), tab_i2_35, 3408);
+    __m256i x5 = IDCTRowTo2x2(DequantRow(pSrc0, pQuantInvTable0, pSrc1, pQuantInvTable1, 5), tab_i2_35, 910);
+
+    // columns
+    const __m256i tg_1_16  = _mm256_set1_epi16(13036);
+    const __m256i tg_3_16  = _mm256_set1_epi16(-21746);
+    const __m256i cos_4_16 = _mm256_set1_epi16(-19195);
+
+    __m256i a = _mm256_adds_epi16(_mm256_adds_epi16(_mm256_mulhi_epi16(x5, tg_3_16), x5), x3);
+    __m256i b = _mm256_subs_epi16(x5, _mm256_adds_epi16(_mm256_mulhi_epi16(x3, tg_3_16), x3));
+    __m256i c = _mm256_subs_epi16(_mm256_mulhi_epi16(x1, tg_1_16), x7);
+    __m256i d = _mm256_adds_epi16(_mm256_mulhi_epi16(x7, tg_1_16), x1);
+
+    __m256i g = _mm256_subs_epi16(d, a);
+    g = _mm256_adds_epi16(g, _mm256_mulhi_epi16(g, cos_4_16));
+    g = _mm256_adds_epi16(g, g);
+
+    __m256i odd = _mm256_adds_epi16(_mm256_adds_epi16(_mm256_adds_epi16(a, d), _mm256_adds_epi16(c, b)), g);
+
+    __m256i x00 = _mm256_adds_epi16(x0, x0);
+    x00 = _mm256_adds_epi16(x00, x00);
+
+    __m256i y = _mm256_unpacklo_epi32(_mm256_adds_epi16(x00, odd), _mm256_subs_epi16(x00, odd));
+    y = _mm256_srai_epi16(y, 7);
+    y = _mm256_packus_epi16(_mm256_adds_epi16(y, _mm256_set1_epi16(128)), y);
+
+    uint32_t lo = (uint32_t)_mm_cvtsi128_si32(_mm256_castsi256_si128(y));
+    uint32_t hi = (uint32_t)_mm_cvtsi128_si32(_mm256_extracti128_si256(y, 1));
+
+    *(uint16_t*)(pDst0)            = (uint16_t)lo;
+    *(uint16_t*)(pDst0 + dstStep0) = (uint16_t)(lo >> 16);
+    *(uint16_t*)(pDst1)            = (uint16_t)hi;
+    *(uint16_t*)(pDst1 + dstStep1) = (uint16_t)(hi >> 16);
+} // DCTQuantInv8x8To2x2LS_JPEG_16s8u_C1R_x2_AVX2()
+
+
+static inline __m256i Load16u8(const uint8_t* p)
+{
+    return _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)p));
+}
+
+static inline __m256i Mul3(__m256i x)
+{
+    return _mm256_add_epi16(x, _mm256_add_epi16(x, x));
+}
+
+void SampleUpRowH2V1_Triangle_JPEG_8u_C1_AVX2(const uint8_t* pSrc, int srcWidth, uint8_t* pDst)
+{
+    const __m256i rnd_e = _mm256_set1_epi16(1);
+    const __m256i rnd_o = _mm256_set1_epi16(2);
+    int i, invalue;
+
+    // first column
+    pDst[0] = pSrc[0];
+    pDst[1] = (uint8_t)((pSrc[0] * 3 + pSrc[1] + 2) >> 2);
+
+    // 3/4 * nearer pixel + 1/4 * further pixel
+    for(i = 1; i + 16 <= srcWidth - 1; i += 16)
+    {
+        __m256i cur3 = Mul3(Load16u8(pSrc + i));
+        __m256i even = _mm256_srli_epi16(_mm256_add_epi16(_mm256_add_epi16(cur3, Load16u8(pSrc + i - 1)), rnd_e), 2);
+        __m256i odd  = _mm256_srli_epi16(_mm256_add_epi16(_mm256_add_epi16(cur3, Load16u8(pSrc + i + 1)), rnd_o), 2);
+
+        _mm256_storeu_si256((__m256i*)(pDst + 2*i), _mm256_or_si256(even, _mm256_slli_epi16(odd, 8)));
+    }
+
+    for(; i < srcWidth - 1; i++)
+    {
+        invalue = pSrc[i] * 3;
+        pDst[2*i]     = (uint8_t)((invalue + pSrc[i - 1] + 1) >> 2);
+        pDst[2*i + 1] = (uint8_t)((invalue + pSrc[i + 1] + 2) >> 2);
+    }
+
+    // last column
+    invalue = pSrc[srcWidth - 1];
+    pDst[2*srcWidth - 2] = (uint8_t)((invalue * 3 + pSrc[srcWidth - 2] + 1) >> 2);
+    pDst[2*srcWidth - 1] = (uint8_t)invalue;
+} // SampleUpRowH2V1_Triangle_JPEG_8u_C1_AVX2()
+
+
+void SampleUpRowH2V2_Triangle_JPEG_8u_C1_AVX2(const uint8_t* pSrc1, const uint8_t* pSrc2, int srcWidth, uint8_t* pDst)
+{
+    const __m256i rnd_e = _mm256_set1_epi16(8);
+    const __m256i rnd_o = _mm256_set1_epi16(7);
+    int i, thiscolsum, lastcolsum, nextcolsum;
+
+    // first column
+    thiscolsum = pSrc1[0] * 3 + pSrc2[0];
+    nextcolsum = pSrc1[1] * 3 + pSrc2[1];
+    pDst[0] = (uint8_t)((thiscolsum * 4 + 8) >> 4);
+    pDst[1] = (uint8_t)((thiscolsum * 3 + nextcolsum + 7) >> 4);
+
+    // 9/16, 3/16, 3/16, 1/16 of the four nearest pixels
+    for(i = 1; i + 16 <= srcWidth - 1; i += 16)
+    {
+        __m256i last = _mm256_add_epi16(Mul3(Load16u8(pSrc1 + i - 1)), Load16u8(pSrc2 + i - 1));
+        __m256i cur3 = Mul3(_mm256_add_epi16(Mul3(Load16u8(pSrc1 + i)), Load16u8(pSrc2 + i)));
+        __m256i next = _mm256_add_epi16(Mul3(Load16u8(pSrc1 + i + 1)), Load16u8(pSrc2 + i + 1));
+
+        __m256i even = _mm256_srli_epi16(_mm256_add_epi16(_mm256_add_epi16(cur3, last), rnd_e), 4);
+        __m256i odd  = _mm256_srli_epi16(_mm256_add_epi16(_mm256_add_epi16(cur3, next), rnd_o), 4);
+
+        _mm256_storeu_si256((__m256i*)(pDst + 2*i), _mm256_or_si256(even, _mm256_slli_epi16(odd, 8)));
+    }
+
+    lastcolsum = pSrc1[i - 1] * 3 + pSrc2[i - 1];
+    thiscolsum = pSrc1[i] * 3 + pSrc2[i];
+    for(; i < srcWidth - 1; i++)
+    {
+        nextcolsum = pSrc1[i + 1] * 3 + pSrc2[i + 1];
+        pDst[2*i]     = (uint8_t)((thiscolsum * 3 + lastcolsum + 8) >> 4);
+        pDst[2*i + 1] = (uint8_t)((thiscolsum * 3 + nextcolsum + 7) >> 4);
+
+        lastcolsum = thiscolsum;
+        thiscolsum = nextcolsum;
+    }
+
+    // last column
+    pDst[2*srcWidth - 2] = (uint8_t)((thiscolsum * 3 + lastcolsum + 8) >> 4);
+    pDst[2*srcWidth - 1] = (uint8_t)((thiscolsum * 4 + 7) >> 4);
+} // SampleUpRowH2V2_Triangle_JPEG_8u_C1_AVX2()
+
+
+// YCbCr to BGR constants of the SSE code in contrib/ipp (pjencccpsy8.c)
+#define kRCr  0x00002cdd
+#define kGCr  0x000016da
+#define kGCb  0x00000b03
+#define kBCb  0x000038b4
+#define kR    0x00000b37
+#define kG    0x00000877
+#define kB    0x00000e2d
+
+int YCbCrToBGR_JPEG_8u_P3C4R_AVX2(const uint8_t* pYCC[3], int yccStep, uint8_t* pBGR, int bgrStep, mfxSize roi, uint8_t aval)
+{
+    const __m256i iRCr = _mm256_set1_epi16(kRCr);
+    const __m256i iGCr = _mm256_set1_epi16(kGCr);
+    const __m256i iGCb = _mm256_set1_epi16(kGCb);
+    const __m256i iBCb = _mm256_set1_epi16(kBCb);
+    const __m256i iR   = _mm256_set1_epi16(kR);
+    const __m256i iG   = _mm256_set1_epi16(kG);
+    const __m256i iB   = _mm256_set1_epi16(kB);
+    const __m256i rnd  = _mm256_set1_epi16(8);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i eA   = _mm256_set1_epi8(aval);
+    const __m256i sHf  = _mm256_broadcastsi128_si256(_mm_set_epi32(0x0f03070b, 0x0e02060a, 0x0d010509, 0x0c000408));
+    const int width32  = roi.width & ~31;
+
+    for(int h = 0; h < roi.height; h++)
+    {
+        const uint8_t* srcy = pYCC[0] + h * yccStep;
+        const uint8_t* srcu = pYCC[1] + h * yccStep;
+        const uint8_t* srcv = pYCC[2] + h * yccStep;
+        uint8_t* dst = pBGR + h * bgrStep;
+
+        for(int w = 0; w < width32; w += 32)
+        {
+            __m256i t0 = _mm256_loadu_si256((const __m256i*)(srcy + w));
+            __m256i tU = _mm256_loadu_si256((const __m256i*)(srcu + w));
+            __m256i tV = _mm256_loadu_si256((const __m256i*)(srcv + w));
+
+            __m256i eY0 = _mm256_slli_epi16(_mm256_unpacklo_epi8(t0, zero), 4);
+            __m256i eY1 = _mm256_slli_epi16(_mm256_unpackhi_epi8(t0, zero), 4);
+            __m256i eU0 = _mm256_slli_epi16(_mm256_unpacklo_epi8(tU, zero), 7);
+            __m256i eU1 = _mm256_slli_epi16(_mm256_unpackhi_epi8(tU, zero), 7);
+            __m256i eV0 = _mm256_slli_epi16(_mm256_unpacklo_epi8(tV, zero), 7);
+            __m256i eV1 = _mm256_slli_epi16(_mm256_unpackhi_epi8(tV, zero), 7);
+            __m256i eR0, eR1, eB0, eB1, eG0, eG1;
+
+            eR0 = _mm256_adds_epi16(_mm256_mulhi_epi16(eV0, iRCr), eY0);
+            eR0 = _mm256_srai_epi16(_mm256_adds_epi16(_mm256_subs_epi16(eR0, iR), rnd), 4);
+            eR1 = _mm256_adds_epi16(_mm256_mulhi_epi16(eV1, iRCr), eY1);
+            eR1 = _mm256_srai_epi16(_mm256_adds_epi16(_mm256_subs_epi16(eR1, iR), rnd), 4);
+            eR0 = _mm256_packus_epi16(eR0, eR1);
+
+            eB0 = _mm256_adds_epi16(_mm256_mulhi_epi16(eU0, iBCb), eY0);
+            eB0 = _mm256_srai_epi16(_mm256_adds_epi16(_mm256_subs_epi16(eB0, iB), rnd), 4);
+            eB1 = _mm256_adds_epi16(_mm256_mulhi_epi16(eU1, iBCb), eY1);
+            eB1 = _mm256_srai_epi16(_mm256_adds_epi16(_mm256_subs_epi16(eB1, iB), rnd), 4);
+            eB0 = _mm256_packus_epi16(eB0, eB1);
+
+            eG0 = _mm256_adds_epi16(_mm256_mulhi_epi16(eU0, iGCb), _mm256_mulhi_epi16(eV0, iGCr));
+            eG0 = _mm256_subs_epi16(_mm256_adds_epi16(eY0, iG), eG0);
+            eG0 = _mm256_srai_epi16(_mm256_adds_epi16(eG0, rnd), 4);
+            eG1 = _mm256_adds_epi16(_mm256_mulhi_epi16(eU1, iGCb), _mm256_mulhi_epi16(eV1, iGCr));
+            eG1 = _mm256_subs_epi16(_mm256_adds_epi16(eY1, iG), eG1);
+            eG1 = _mm256_srai_epi16(_mm256_adds_epi16(eG1, rnd), 4);
+            eG0 = _mm256_packus_epi16(eG0, eG1);
+
+            // every lane holds 16 pixels: 0..15 in the low lane, 16..31 in the high one
+            __m256i rg = _mm256_unpacklo_epi32(eR0, eG0);
+            __m256i ba = _mm256_unpacklo_epi32(eB0, eA);
+            __m256i p0 = _mm256_shuffle_epi8(_mm256_unpacklo_epi64(rg, ba), sHf);
+            __m256i p1 = _mm256_shuffle_epi8(_mm256_unpackhi_epi64(rg, ba), sHf);
+            rg = _mm256_unpackhi_epi32(eR0, eG0);
+            ba = _mm256_unpackhi_epi32(eB0, eA);
+            __m256i p2 = _mm256_shuffle_epi8(_mm256_unpacklo_epi64(rg, ba), sHf);
+            __m256i p3 = _mm256_shuffle_epi8(_mm256_unpackhi_epi64(rg, ba), sHf);
+
+            _mm256_storeu_si256((__m256i*)(dst + 4*w +  0), _mm256_permute2x128_si256(p0, p1, 0x20));
+            _mm256_storeu_si256((__m256i*)(dst + 4*w + 32), _mm256_permute2x128_si256(p2, p3, 0x20));
+            _mm256_storeu_si256((__m256i*)(dst + 4*w + 64), _mm256_permute2x128_si256(p0, p1, 0x31));
+            _mm256_storeu_si256((__m256i*)(dst + 4*w + 96), _mm256_permute2x128_si256(p2, p3, 0x31));
+        }
+    }
+
+    return width32;
+} // YCbCrToBGR_JPEG_8u_P3C4R_AVX2()
+
+
+void InterleaveUV_8u_AVX2(const uint8_t* pU, const uint8_t* pV, int width, uint8_t* pUV)
+{
+    int i;
+
+    for(i = 0; i + 32 <= width; i += 32)
+    {
+        __m256i u  = _mm256_loadu_si256((const __m256i*)(pU + i));
+        __m256i v  = _mm256_loadu_si256((const __m256i*)(pV + i));
+        __m256i lo = _mm256_unpacklo_epi8(u, v);
+        __m256i hi = _mm256_unpackhi_epi8(u, v);
+
+        _mm256_storeu_si256((__m256i*)(pUV + 2*i),      _mm256_permute2x128_si256(lo, hi, 0x20));
+        _mm256_storeu_si256((__m256i*)(pUV + 2*i + 32), _mm256_permute2x128_si256(lo, hi, 0x31));
+    }
+
+    for(; i < width; i++)
+    {
+        pUV[2*i]     = pU[i];
+        pUV[2*i + 1] = pV[i];
+    }
+} // InterleaveUV_8u_AVX2()
+
+#endif // MFX_ENABLE_MJPEG_VIDEO_DECODE && MFX_ENABLE_SW_FALLBACK
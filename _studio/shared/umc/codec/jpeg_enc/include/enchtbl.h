@@ -44,6 +44,8 @@ public:
   JERRCODE Create(void);
   JERRCODE Destroy(void);
   JERRCODE Init(int id,int hclass,uint8_t* bits,uint8_t* vals);
+  // copy already derived table
+  JERRCODE Init(const CJPEGEncoderHuffmanTable& src);
   
   bool     IsValid(void)                { return m_bValid; }
 
@@ -46,6 +46,8 @@ public:
 
   JERRCODE Init(int id,uint8_t  raw[DCTSIZE2],int quality);
   JERRCODE Init(int id,uint16_t raw[DCTSIZE2],int quality);
+  // copy already derived table
+  JERRCODE Init(const CJPEGEncoderQuantTable& src);
 
   operator uint16_t*() { return m_precision == 0 ? m_qnt16u : 0; }
   operator float*() { return m_precision == 1 ? m_qnt32f : 0; }
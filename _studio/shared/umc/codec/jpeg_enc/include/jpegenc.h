@@ -52,6 +52,25 @@ typedef struct _JPEG_SCAN
 } JPEG_SCAN;
 
 
+// Quant and Huffman tables of the encoder, derived tables are immutable
+// once built, so the same object may be shared by many encoders
+class CJPEGEncoderTables
+{
+public:
+  CJPEGEncoderTables(void) : m_externalQuantTable(false), m_externalHuffmanTable(false) {}
+
+  CJPEGEncoderTables(const CJPEGEncoderTables&) = delete;
+  CJPEGEncoderTables& operator=(const CJPEGEncoderTables&) = delete;
+
+  CJPEGEncoderQuantTable   m_qntbl[MAX_QUANT_TABLES];
+  CJPEGEncoderHuffmanTable m_dctbl[MAX_HUFF_TABLES];
+  CJPEGEncoderHuffmanTable m_actbl[MAX_HUFF_TABLES];
+
+  bool                     m_externalQuantTable;
+  bool                     m_externalHuffmanTable;
+};
+
+
 class CJPEGEncoder
 {
 public:
@@ -163,6 +182,10 @@ public:
   bool     IsACTableInited();
   bool     IsDCTableInited();
 
+  // copy all quant and Huffman tables without deriving them again
+  JERRCODE GetTables(CJPEGEncoderTables& tables);
+  JERRCODE SetTables(const CJPEGEncoderTables& tables);
+
 protected:
   IMAGE      m_src;
 
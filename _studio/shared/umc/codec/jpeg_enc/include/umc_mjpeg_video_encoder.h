@@ -39,6 +39,7 @@
 // internal JPEG decoder object forward declaration
 class CBaseStreamOutput;
 class CJPEGEncoder;
+class CJPEGEncoderTables;
 
 namespace UMC
 {
@@ -156,7 +157,7 @@ public:
     // Initialize for subsequent frame decoding.
     virtual Status Init(BaseCodecParams* init);
 
-    // Reset decoder to initial state
+    // Drop collected pictures, encoders and their tables are kept
     virtual Status Reset(void);
 
     // Close decoding & free all allocated resources
@@ -168,6 +169,11 @@ public:
     // 
     virtual Status EncodePiece(const mfxU32 threadNumber, const uint32_t numPiece);
 
+    // Encode all pieces of the frame by the calling thread directly to the output buffer.
+    // The frame is not collected, so other threads may encode other frames meanwhile.
+    // Non-zero quality overrides tables set by SetTables() for this frame.
+    virtual Status EncodeFrame(const mfxU32 threadNumber, MJPEGEncoderFrame* frame, const mfxU16 quality, MediaData* out);
+
     // Get codec working (initialization) parameter(s)
     virtual Status GetInfo(BaseCodecParams *info);
 
@@ -198,10 +204,23 @@ public:
     bool   IsQuantTableInited();
     bool   IsHuffmanTableInited();
 
+    // Set tables derived from the quality and optional external tables to all encoders.
+    // Derived tables are cached process-wide and shared by all encoders with the same
+    // settings, so switching between known settings costs a copy only.
+    Status SetTables(const mfxU16 quality, mfxExtJPEGQuantTables* quantTables, mfxExtJPEGHuffmanTables* huffmanTables);
+
 protected:
 
+    Status EncodePiece(const mfxU32 threadNumber, MJPEGEncoderFrame* frame, const uint32_t numPiece, uint8_t* dst, size_t dstSize, size_t* pieceSize);
+    Status SetEncoderTables(const mfxU32 threadNumber, const std::shared_ptr<const CJPEGEncoderTables>& tables);
+    void   DropSharedTables();
+
     // JPEG encoders allocated
     std::vector<std::unique_ptr<CJPEGEncoder>> m_enc;
+    // Shared tables set to each encoder, null if tables were changed another way
+    std::vector<std::shared_ptr<const CJPEGEncoderTables>> m_encTables;
+    // Tables set by SetTables()
+    std::shared_ptr<const CJPEGEncoderTables> m_tables;
     // Bitstream buffer for each thread
     std::vector<std::unique_ptr<MediaData>>    m_pBitstreamBuffer;
     //
@@ -61,11 +61,9 @@ JERRCODE CJPEGEncoderHuffmanTable::Create(void)
     return JPEG_ERR_INTERNAL;
   }
 
+  // buffer size doesn't depend on the contents, so the buffer is reused
   if(0 != m_table)
-  {
-    mfxFree(m_table);
-    m_table = 0;
-  }
+    return JPEG_OK;
 
   m_table = (IppiEncodeHuffmanSpec*)mfxMalloc(size);
   if(0 == m_table)
@@ -120,6 +118,44 @@ JERRCODE CJPEGEncoderHuffmanTable::Init(int id,int hclass,uint8_t* bits,uint8_t*
 } // CJPEGEncoderHuffmanTable::Init()
 
 
+JERRCODE CJPEGEncoderHuffmanTable::Init(const CJPEGEncoderHuffmanTable& src)
+{
+  int      size;
+  int      status;
+  JERRCODE jerr;
+
+  if(!src.m_bValid)
+  {
+    m_bValid = false;
+    return JPEG_OK;
+  }
+
+  jerr = Create();
+  if(JPEG_OK != jerr)
+    return jerr;
+
+  status = mfxiEncodeHuffmanSpecGetBufSize_JPEG_8u(&size);
+  if(ippStsNoErr != status)
+  {
+    LOG1("IPP Error: ippiEncodeHuffmanSpecGetBufSize_JPEG_8u() failed - ",status);
+    return JPEG_ERR_INTERNAL;
+  }
+
+  m_id     = src.m_id;
+  m_hclass = src.m_hclass;
+
+  MFX_INTERNAL_CPY(m_bits,src.m_bits,16);
+  MFX_INTERNAL_CPY(m_vals,src.m_vals,256);
+
+  // derived table has no pointers inside
+  MFX_INTERNAL_CPY((uint8_t*)m_table,(const uint8_t*)src.m_table,size);
+
+  m_bValid = true;
+
+  return JPEG_OK;
+} // CJPEGEncoderHuffmanTable::Init()
+
+
 
 
 CJPEGEncoderHuffmanState::CJPEGEncoderHuffmanState(void)
@@ -148,11 +184,9 @@ JERRCODE CJPEGEncoderHuffmanState::Create(void)
     return JPEG_ERR_INTERNAL;
   }
 
+  // buffer size doesn't depend on the contents, so the buffer is reused
   if(0 != m_state)
-  {
-    mfxFree(m_state);
-    m_state = 0;
-  }
+    return JPEG_OK;
 
   m_state = (IppiEncodeHuffmanState*)mfxMalloc(size);
   if(0 == m_state)
@@ -189,4 +189,18 @@ JERRCODE CJPEGEncoderQuantTable::Init(int id,uint16_t raw[64],int quality)
   return JPEG_OK;
 } // CJPEGEncoderQuantTable::Init()
 
+
+JERRCODE CJPEGEncoderQuantTable::Init(const CJPEGEncoderQuantTable& src)
+{
+  m_id          = src.m_id;
+  m_precision   = src.m_precision;
+  m_initialized = src.m_initialized;
+
+  // both objects have own aligned pointers, so copy data, not pointers
+  MFX_INTERNAL_CPY((uint8_t*)m_raw16u,(const uint8_t*)src.m_raw16u,DCTSIZE2*sizeof(uint16_t));
+  MFX_INTERNAL_CPY((uint8_t*)m_qnt32f,(const uint8_t*)src.m_qnt32f,DCTSIZE2*sizeof(float));
+
+  return JPEG_OK;
+} // CJPEGEncoderQuantTable::Init()
+
 #endif // MFX_ENABLE_MJPEG_VIDEO_ENCODE
@@ -504,6 +504,10 @@ JERRCODE CJPEGEncoder::SetParams(
 
   m_jpeg_restart_interval = restart_interval;
 
+  // optimized tables are generated for the whole scan, so it can't be split to pieces
+  if(m_optimal_htbl && m_jpeg_restart_interval)
+    return JPEG_ERR_PARAMS;
+
   if(m_jpeg_restart_interval)
   {
       m_mcu_encoded = m_jpeg_restart_interval * m_piecePosInScan;
@@ -1022,6 +1026,64 @@ bool CJPEGEncoder::IsDCTableInited()
 } // CJPEGEncoder::IsDCTableInited()
 
 
+JERRCODE CJPEGEncoder::GetTables(CJPEGEncoderTables& tables)
+{
+    JERRCODE jerr = JPEG_OK;
+
+    for(int i=0; i<MAX_QUANT_TABLES; i++)
+    {
+        jerr = tables.m_qntbl[i].Init(m_qntbl[i]);
+        if(JPEG_OK != jerr)
+            return jerr;
+    }
+
+    for(int i=0; i<MAX_HUFF_TABLES; i++)
+    {
+        jerr = tables.m_dctbl[i].Init(m_dctbl[i]);
+        if(JPEG_OK != jerr)
+            return jerr;
+
+        jerr = tables.m_actbl[i].Init(m_actbl[i]);
+        if(JPEG_OK != jerr)
+            return jerr;
+    }
+
+    tables.m_externalQuantTable   = m_externalQuantTable;
+    tables.m_externalHuffmanTable = m_externalHuffmanTable;
+
+    return JPEG_OK;
+} // CJPEGEncoder::GetTables(CJPEGEncoderTables& tables)
+
+
+JERRCODE CJPEGEncoder::SetTables(const CJPEGEncoderTables& tables)
+{
+    JERRCODE jerr = JPEG_OK;
+
+    for(int i=0; i<MAX_QUANT_TABLES; i++)
+    {
+        jerr = m_qntbl[i].Init(tables.m_qntbl[i]);
+        if(JPEG_OK != jerr)
+            return jerr;
+    }
+
+    for(int i=0; i<MAX_HUFF_TABLES; i++)
+    {
+        jerr = m_dctbl[i].Init(tables.m_dctbl[i]);
+        if(JPEG_OK != jerr)
+            return jerr;
+
+        jerr = m_actbl[i].Init(tables.m_actbl[i]);
+        if(JPEG_OK != jerr)
+            return jerr;
+    }
+
+    m_externalQuantTable   = tables.m_externalQuantTable;
+    m_externalHuffmanTable = tables.m_externalHuffmanTable;
+
+    return JPEG_OK;
+} // CJPEGEncoder::SetTables(const CJPEGEncoderTables& tables)
+
+
 JERRCODE CJPEGEncoder::WriteSOI(void)
 {
   JERRCODE jerr;
@@ -3413,13 +3475,16 @@ JERRCODE CJPEGEncoder::GenerateHuffmanTables(void)
 } // CJPEGEncoder::GenerateHuffmanTables()
 
 
+// Builds optimized tables for the current scan. DCT is done once: quantized
+// coefficients of all scan MCUs are kept in m_block_buffer for the entropy pass.
 JERRCODE CJPEGEncoder::GenerateHuffmanTablesEX(void)
 {
-  int       i, j, c, cc, htbl_limit;
-  int       vs;
-  int       hs;
-  int       dc_Statistics[4][256];
-  int       ac_Statistics[4][256];
+  int       c, vs, hs, mcu, tbl;
+  uint32_t  rowMCU, colMCU, maxMCU, mcu_to_encode;
+  int       dc_Statistics[MAX_HUFF_TABLES][256];
+  int       ac_Statistics[MAX_HUFF_TABLES][256];
+  bool      dc_used[MAX_HUFF_TABLES];
+  bool      ac_used[MAX_HUFF_TABLES];
   uint8_t     bits[16];
   uint8_t     vals[256];
   int16_t*   pMCUBuf;
@@ -3427,196 +3492,140 @@ JERRCODE CJPEGEncoder::GenerateHuffmanTablesEX(void)
   JERRCODE  jerr;
   int status;
 
-  //m_next_restart_num = 0;
-  //m_restarts_to_go   = m_jpeg_restart_interval;
+  mfxsZero_8u((uint8_t*)dc_Statistics,sizeof(dc_Statistics));
+  mfxsZero_8u((uint8_t*)ac_Statistics,sizeof(ac_Statistics));
 
-  status = mfxiEncodeHuffmanStateInit_JPEG_8u(m_state);
-  if(ippStsNoErr != status)
+  for(tbl = 0; tbl < MAX_HUFF_TABLES; tbl++)
   {
-    return JPEG_ERR_INTERNAL;
+    dc_used[tbl] = false;
+    ac_used[tbl] = false;
   }
 
-  mfxsZero_8u((uint8_t*)dc_Statistics,sizeof(dc_Statistics));
-  mfxsZero_8u((uint8_t*)ac_Statistics,sizeof(ac_Statistics));
+  for(c = m_curr_scan.first_comp; c < m_curr_scan.first_comp + m_curr_scan.ncomps; c++)
+  {
+    m_ccomp[c].m_lastDC = 0;
+    dc_used[m_ccomp[c].m_dc_selector] = true;
+    ac_used[m_ccomp[c].m_ac_selector] = true;
+  }
 
-  for(i = 0; i < m_numyMCU; i++)
+  pMCUBuf = m_block_buffer;
+
+  // the same MCUs as EncodeScanBaseline() encodes
+  rowMCU = m_mcu_encoded / m_curr_scan.numxMCU;
+  colMCU = m_mcu_encoded % m_curr_scan.numxMCU;
+  mcu_to_encode = m_mcu_to_encode;
+
+  while(mcu_to_encode && rowMCU < (uint32_t)m_curr_scan.numyMCU)
   {
-    pMCUBuf = m_block_buffer + i * m_numxMCU * m_nblock * DCTSIZE2;
-    if(JD_PIXEL == m_src.order)
+    maxMCU = std::min((uint32_t)m_curr_scan.numxMCU, colMCU + mcu_to_encode);
+
+    if(m_src.color == m_jpeg_color && JD_PLANE == m_src.order)
     {
-      jerr = ColorConvert(i, 0, m_numxMCU);
-      if(JPEG_OK != jerr)
-        return jerr;
-      jerr = DownSampling(i, 0, m_numxMCU);
+      jerr = ProcessBuffer(rowMCU, colMCU, maxMCU);
       if(JPEG_OK != jerr)
         return jerr;
     }
-    else // m_src.order == JD_PLANE
+    else
     {
-      jerr = ProcessBuffer(i, 0, m_numxMCU);
+      jerr = ColorConvert(rowMCU, colMCU, maxMCU);
       if(JPEG_OK != jerr)
         return jerr;
-    }
 
-    if(JPEG_BASELINE == m_jpeg_mode)
-    {
-      jerr = TransformMCURowBL(pMCUBuf, 0, m_numxMCU);
-    }
-    else
-    {
-      if(m_jpeg_precision > 8)
-        jerr = TransformMCURowEX(pMCUBuf, 0);
-      else
-        jerr = TransformMCURowBL(pMCUBuf, 0, m_numxMCU);
+      jerr = DownSampling(rowMCU, colMCU, maxMCU);
+      if(JPEG_OK != jerr)
+        return jerr;
     }
 
+    jerr = TransformMCURowBL(pMCUBuf, colMCU, maxMCU);
     if(JPEG_OK != jerr)
       return jerr;
 
-    for(j = 0; j < m_numxMCU; j++)
+    for(mcu = 0; mcu < (int)(maxMCU - colMCU); mcu++)
     {
-      // process restart interval, if any
-      if(m_jpeg_restart_interval)
+      for(c = m_curr_scan.first_comp; c < m_curr_scan.first_comp + m_curr_scan.ncomps; c++)
       {
-        //if(m_restarts_to_go == 0)
-        //{
-        //  jerr = ProcessRestart(0,0,0,63,0,0);
-        //  if(JPEG_OK != jerr)
-        //    return jerr;
-        //}
-      }
-
-      for(c = 0; c < m_jpeg_ncomp; c++)
-      {
-        cc = c;
-        if(JPEG_BASELINE == m_jpeg_mode)
-        {
-          if(m_jpeg_ncomp > 1 && (m_jpeg_color == JC_YCBCR || m_jpeg_color == JC_YCCK || m_jpeg_color == JC_NV12))
-            cc = !!c;
-          else
-            cc = 0;
-        }
-
-
         curr_comp = &m_ccomp[c];
-        for(vs = 0; vs < curr_comp->m_vsampling; vs++)
+
+        for(vs = 0; vs < m_curr_scan.mcuHeight / (8 * curr_comp->m_v_factor); vs++)
         {
-          for(hs = 0; hs < curr_comp->m_hsampling; hs++)
+          for(hs = 0; hs < m_curr_scan.mcuWidth / (8 * curr_comp->m_h_factor); hs++)
           {
             status = mfxiGetHuffmanStatistics8x8_JPEG_16s_C1(
-                       pMCUBuf, dc_Statistics[cc], ac_Statistics[cc], &m_ccomp[c].m_lastDC);
+                       pMCUBuf, dc_Statistics[curr_comp->m_dc_selector],
+                       ac_Statistics[curr_comp->m_ac_selector], &curr_comp->m_lastDC);
 
-          if(ippStsNoErr > status)
-          {
-            LOG1("IPP Error: mfxiGetHuffmanStatistics8x8_JPEG_16s_C1() failed - ",status);
-            return JPEG_ERR_INTERNAL;
-          }
+            if(ippStsNoErr > status)
+            {
+              LOG1("IPP Error: mfxiGetHuffmanStatistics8x8_JPEG_16s_C1() failed - ",status);
+              return JPEG_ERR_INTERNAL;
+            }
 
-          pMCUBuf += DCTSIZE2;
+            pMCUBuf += DCTSIZE2;
           }
         }
-      } // for m_jpeg_ncomp
-
-      if(m_jpeg_restart_interval)
-      {
-        //if(m_restarts_to_go == 0)
-        //{
-        //  m_restarts_to_go = m_jpeg_restart_interval;
-        //}
-        //m_restarts_to_go --;
-      }
-    } // for numxMCU
-  } // for numyMCU
+      } // for scan components
+    } // for MCUs in row
 
+    mcu_to_encode -= maxMCU - colMCU;
+    rowMCU++;
+    colMCU = 0;
+  } // for MCU rows
 
-
-  for(c = 0; c < m_jpeg_ncomp; c++)
+  for(c = m_curr_scan.first_comp; c < m_curr_scan.first_comp + m_curr_scan.ncomps; c++)
   {
-    cc = c;
-    if(JPEG_BASELINE == m_jpeg_mode)
-    {
-      if(m_jpeg_ncomp > 1 && (m_jpeg_color == JC_YCBCR || m_jpeg_color == JC_YCCK || m_jpeg_color == JC_NV12))
-        cc = !!c;
-      else
-        cc = 0;
-    }
-
-    mfxsZero_8u(bits,sizeof(bits));
-    mfxsZero_8u(vals,sizeof(vals));
-
-    status = mfxiEncodeHuffmanRawTableInit_JPEG_8u(dc_Statistics[cc],bits,vals);
-    if(ippStsNoErr > status)
-    {
-      LOG0("Error: mfxiEncodeHuffmanRawTableInit_JPEG_8u() failed!");
-      return JPEG_ERR_INTERNAL;
-    }
-
-    jerr = AttachHuffmanTable(cc, DC, c);
-    if(JPEG_OK != jerr)
-      return jerr;
+    m_ccomp[c].m_lastDC = 0;
+  }
 
-    jerr = InitHuffmanTable(bits, vals, m_ccomp[c].m_dc_selector, DC);
-    if(JPEG_OK != jerr)
+  // tables are written before SOS, so every scan may redefine them
+  for(tbl = 0; tbl < MAX_HUFF_TABLES; tbl++)
+  {
+    if(dc_used[tbl])
     {
-      LOG0("Error: can't init huffman table");
-      return jerr;
-    }
-
-    mfxsZero_8u(bits,sizeof(bits));
-    mfxsZero_8u(vals,sizeof(vals));
+      mfxsZero_8u(bits,sizeof(bits));
+      mfxsZero_8u(vals,sizeof(vals));
 
-    status = mfxiEncodeHuffmanRawTableInit_JPEG_8u(ac_Statistics[cc],bits,vals);
-    if(ippStsNoErr > status)
-    {
-      LOG0("Error: mfxiEncodeHuffmanRawTableInit_JPEG_8u() failed!");
-      return JPEG_ERR_INTERNAL;
-    }
+      status = mfxiEncodeHuffmanRawTableInit_JPEG_8u(dc_Statistics[tbl],bits,vals);
+      if(ippStsNoErr > status)
+      {
+        LOG0("Error: mfxiEncodeHuffmanRawTableInit_JPEG_8u() failed!");
+        return JPEG_ERR_INTERNAL;
+      }
 
-    jerr = AttachHuffmanTable(cc, AC, c);
-    if(JPEG_OK != jerr)
-      return jerr;
+      jerr = InitHuffmanTable(bits, vals, tbl, DC);
+      if(JPEG_OK != jerr)
+      {
+        LOG0("Error: can't init huffman table");
+        return jerr;
+      }
 
-    jerr = InitHuffmanTable(bits, vals, m_ccomp[c].m_ac_selector, AC);
-    if(JPEG_OK != jerr)
-    {
-      LOG0("Error: can't init huffman table");
-      return jerr;
+      jerr = WriteDHT(&m_dctbl[tbl]);
+      if(JPEG_OK != jerr)
+      {
+        LOG0("Error: WriteDHT() failed");
+        return jerr;
+      }
     }
 
-    if(JPEG_BASELINE == m_jpeg_mode)
+    if(ac_used[tbl])
     {
-      if(m_jpeg_ncomp > 1 && (m_jpeg_color == JC_YCBCR || m_jpeg_color == JC_YCCK || m_jpeg_color == JC_NV12))
-        htbl_limit = 2;
-      else
-        htbl_limit = 1;
+      mfxsZero_8u(bits,sizeof(bits));
+      mfxsZero_8u(vals,sizeof(vals));
 
-      if(c < htbl_limit)
+      status = mfxiEncodeHuffmanRawTableInit_JPEG_8u(ac_Statistics[tbl],bits,vals);
+      if(ippStsNoErr > status)
       {
-        jerr = WriteDHT(&m_dctbl[cc]);
-        if(JPEG_OK != jerr)
-        {
-          LOG0("Error: WriteDHT() failed");
-          return jerr;
-        }
-
-        jerr = WriteDHT(&m_actbl[cc]);
-        if(JPEG_OK != jerr)
-        {
-          LOG0("Error: WriteDHT() failed");
-          return jerr;
-        }
+        LOG0("Error: mfxiEncodeHuffmanRawTableInit_JPEG_8u() failed!");
+        return JPEG_ERR_INTERNAL;
       }
-    }
-    else
-    {
-      jerr = WriteDHT(&m_dctbl[c]);
+
+      jerr = InitHuffmanTable(bits, vals, tbl, AC);
       if(JPEG_OK != jerr)
       {
-        LOG0("Error: WriteDHT() failed");
+        LOG0("Error: can't init huffman table");
         return jerr;
       }
 
-      jerr = WriteDHT(&m_actbl[c]);
+      jerr = WriteDHT(&m_actbl[tbl]);
       if(JPEG_OK != jerr)
       {
         LOG0("Error: WriteDHT() failed");
@@ -3956,6 +3965,17 @@ JERRCODE CJPEGEncoder::EncodeScanBaseline(void)
   JERRCODE  jerr = JPEG_OK;
   int status;
 
+  if(m_optimal_htbl)
+  {
+    // the scan is the only piece, so its tables go right before SOS
+    jerr = GenerateHuffmanTablesEX();
+    if(JPEG_OK != jerr)
+    {
+      LOG0("Error: GenerateHuffmanTablesEX() failed");
+      return jerr;
+    }
+  }
+
   for(i = 0; i < m_jpeg_ncomp; i++)
   {
     m_ccomp[i].m_lastDC = 0;
@@ -3999,7 +4019,18 @@ JERRCODE CJPEGEncoder::EncodeScanBaseline(void)
     {
 
 
-      if(rowMCU < (uint32_t)m_curr_scan.numyMCU)
+      if(rowMCU < (uint32_t)m_curr_scan.numyMCU && m_optimal_htbl)
+      {
+        // coefficients are kept by GenerateHuffmanTablesEX()
+        jerr = EncodeHuffmanMCURowBL(pMCUBuf, colMCU, maxMCU);
+        if(JPEG_OK != jerr)
+        {
+            return jerr;
+        }
+
+        pMCUBuf += (maxMCU - colMCU) * m_nblock * DCTSIZE2;
+      }
+      else if(rowMCU < (uint32_t)m_curr_scan.numyMCU)
       {
         if(m_src.color == m_jpeg_color && JD_PLANE == m_src.order)
         {
@@ -4518,10 +4549,7 @@ JERRCODE CJPEGEncoder::WriteHeader(void)
             }
           }
         }
-        else
-        {
-          GenerateHuffmanTablesEX();
-        }
+        // optimized tables are written by EncodeScanBaseline() before every scan
         break;
 
       case JPEG_PROGRESSIVE:
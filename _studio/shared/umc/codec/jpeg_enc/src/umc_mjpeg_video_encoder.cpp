@@ -24,6 +24,7 @@
 #include <string.h>
 #include "umc_video_data.h"
 #include "umc_mjpeg_video_encoder.h"
+#include "umc_param_set_cache.h"
 #include "membuffout.h"
 #include "jpegenc.h"
 
@@ -163,6 +164,94 @@ Status MJPEGEncoderFrame::GetPiecePosition(uint32_t pieceNum, uint32_t* fieldNum
 VideoEncoder *CreateMJPEGEncoder() { return new MJPEGVideoEncoder(); }
 
 
+typedef std::shared_ptr<const CJPEGEncoderTables> JPEGEncoderTablesPtr;
+
+// Derived tables are looked up by quality plus external tables as they are passed
+// by application, so streams with the same settings share one set of tables
+static Status GetSharedTables(const mfxU16 quality, mfxExtJPEGQuantTables* quantTables, mfxExtJPEGHuffmanTables* huffmanTables, JPEGEncoderTablesPtr& tables)
+{
+    uint8_t  key[sizeof(mfxExtJPEGQuantTables) + sizeof(mfxExtJPEGHuffmanTables)];
+    size_t   keySize = 0;
+    uint32_t context = quality;
+
+    if(quantTables)
+    {
+        MFX_INTERNAL_CPY(key + keySize, (uint8_t*)quantTables + sizeof(mfxExtBuffer), sizeof(mfxExtJPEGQuantTables) - sizeof(mfxExtBuffer));
+        keySize += sizeof(mfxExtJPEGQuantTables) - sizeof(mfxExtBuffer);
+        context |= 1 << 16;
+    }
+
+    if(huffmanTables)
+    {
+        MFX_INTERNAL_CPY(key + keySize, (uint8_t*)huffmanTables + sizeof(mfxExtBuffer), sizeof(mfxExtJPEGHuffmanTables) - sizeof(mfxExtBuffer));
+        keySize += sizeof(mfxExtJPEGHuffmanTables) - sizeof(mfxExtBuffer);
+        context |= 1 << 17;
+    }
+
+    ParamSetCache<JPEGEncoderTablesPtr> & cache = ParamSetCache<JPEGEncoderTablesPtr>::Instance();
+
+    if(cache.Find(key, keySize, context, tables))
+        return UMC_OK;
+
+    // build tables the same way as they are set to encoder one by one
+    std::unique_ptr<CJPEGEncoder> enc(new CJPEGEncoder());
+    JERRCODE jerr = JPEG_OK;
+
+    if(quality)
+    {
+        jerr = enc->SetDefaultQuantTable(quality);
+        if(JPEG_OK != jerr)
+            return UMC_ERR_FAILED;
+    }
+
+    jerr = enc->SetDefaultACTable();
+    if(JPEG_OK != jerr)
+        return UMC_ERR_FAILED;
+
+    jerr = enc->SetDefaultDCTable();
+    if(JPEG_OK != jerr)
+        return UMC_ERR_FAILED;
+
+    if(quantTables)
+    {
+        for(uint16_t j=0; j<quantTables->NumTable; j++)
+        {
+            jerr = enc->SetQuantTable(j, quantTables->Qm[j]);
+            if(JPEG_OK != jerr)
+                return UMC_ERR_FAILED;
+        }
+    }
+
+    if(huffmanTables)
+    {
+        for(int j=0; j<huffmanTables->NumACTable; j++)
+        {
+            jerr = enc->SetACTable(j, huffmanTables->ACTables[j].Bits, huffmanTables->ACTables[j].Values);
+            if(JPEG_OK != jerr)
+                return UMC_ERR_FAILED;
+        }
+
+        for(int j=0; j<huffmanTables->NumDCTable; j++)
+        {
+            jerr = enc->SetDCTable(j, huffmanTables->DCTables[j].Bits, huffmanTables->DCTables[j].Values);
+            if(JPEG_OK != jerr)
+                return UMC_ERR_FAILED;
+        }
+    }
+
+    std::shared_ptr<CJPEGEncoderTables> built(new CJPEGEncoderTables());
+
+    jerr = enc->GetTables(*built);
+    if(JPEG_OK != jerr)
+        return UMC_ERR_FAILED;
+
+    tables = built;
+    cache.Add(key, keySize, context, tables);
+
+    return UMC_OK;
+}
+
+
 MJPEGVideoEncoder::MJPEGVideoEncoder(void)
 {
     m_IsInit      = false;
@@ -177,7 +266,6 @@ Status MJPEGVideoEncoder::Init(BaseCodecParams* lpInit)
 {
     MJPEGEncoderParams* pEncoderParams = (MJPEGEncoderParams*) lpInit;
     Status status = UMC_OK;
-    JERRCODE jerr = JPEG_OK;
     uint32_t i, numThreads;
 
     if(!pEncoderParams)
@@ -206,26 +294,22 @@ Status MJPEGVideoEncoder::Init(BaseCodecParams* lpInit)
         numThreads = m_EncoderParams.numThreads;
     }
 
+    m_tables.reset();
+    status = GetSharedTables((mfxU16)m_EncoderParams.quality, NULL, NULL, m_tables);
+    if(UMC_OK != status)
+        return status;
+
     m_enc.resize(numThreads);
+    m_encTables.clear();
+    m_encTables.resize(numThreads);
     m_pBitstreamBuffer.resize(numThreads);
     for (i = 0; i < numThreads; i += 1)
     {
         m_enc[i].reset(new CJPEGEncoder());
 
-        if(m_EncoderParams.quality)
-        {
-            jerr = m_enc[i]->SetDefaultQuantTable((uint16_t)m_EncoderParams.quality);
-            if(JPEG_OK != jerr)
-                return UMC_ERR_FAILED;
-        }
-
-        jerr = m_enc[i]->SetDefaultACTable();
-        if(JPEG_OK != jerr)
-            return UMC_ERR_FAILED;
-
-        jerr = m_enc[i]->SetDefaultDCTable();
-        if(JPEG_OK != jerr)
-            return UMC_ERR_FAILED;
+        status = SetEncoderTables(i, m_tables);
+        if(UMC_OK != status)
+            return status;
 
         if(!m_pBitstreamBuffer[i])
             m_pBitstreamBuffer[i].reset(new MediaData(m_EncoderParams.buf_size));
@@ -243,7 +327,17 @@ Status MJPEGVideoEncoder::Init(BaseCodecParams* lpInit)
 
 Status MJPEGVideoEncoder::Reset(void)
 {
-    return Init(&m_EncoderParams);
+    if (!m_IsInit)
+        return UMC_ERR_NOT_INITIALIZED;
+
+    for (auto& buffer: m_pBitstreamBuffer)
+    {
+        buffer->Reset();
+    }
+
+    m_frame->Reset();
+
+    return UMC_OK;
 }
 
 Status MJPEGVideoEncoder::Close(void)
@@ -257,6 +351,9 @@ Status MJPEGVideoEncoder::Close(void)
         buffer.reset();
     }
 
+    m_encTables.clear();
+    m_tables.reset();
+
     if(m_frame)
         m_frame->Reset();
 
@@ -316,6 +413,8 @@ Status MJPEGVideoEncoder::SetDefaultQuantTable(const mfxU16 quality)
     if (!m_IsInit)
         return UMC_ERR_NOT_INITIALIZED;
 
+    DropSharedTables();
+
     for(auto& enc: m_enc)
     {
         jerr = enc->SetDefaultQuantTable(quality);
@@ -333,6 +432,8 @@ Status MJPEGVideoEncoder::SetDefaultHuffmanTable()
     if (!m_IsInit)
         return UMC_ERR_NOT_INITIALIZED;
 
+    DropSharedTables();
+
     for(auto& enc: m_enc)
     {
         jerr = enc->SetDefaultACTable();
@@ -354,6 +455,8 @@ Status MJPEGVideoEncoder::SetQuantTableExtBuf(mfxExtJPEGQuantTables* quantTables
     if (!m_IsInit)
         return UMC_ERR_NOT_INITIALIZED;
 
+    DropSharedTables();
+
     for(auto& enc: m_enc)
     {
         for(uint16_t j=0; j<quantTables->NumTable; j++)
@@ -374,6 +477,8 @@ Status MJPEGVideoEncoder::SetHuffmanTableExtBuf(mfxExtJPEGHuffmanTables* huffman
     if (!m_IsInit)
         return UMC_ERR_NOT_INITIALIZED;
 
+    DropSharedTables();
+
     for(auto& enc: m_enc)
     {
         for(int j=0; j<huffmanTables->NumACTable; j++)
@@ -394,6 +499,58 @@ Status MJPEGVideoEncoder::SetHuffmanTableExtBuf(mfxExtJPEGHuffmanTables* huffman
     return UMC_OK;
 }
 
+Status MJPEGVideoEncoder::SetTables(const mfxU16 quality, mfxExtJPEGQuantTables* quantTables, mfxExtJPEGHuffmanTables* huffmanTables)
+{
+    Status status = UMC_OK;
+    JPEGEncoderTablesPtr tables;
+
+    if (!m_IsInit)
+        return UMC_ERR_NOT_INITIALIZED;
+
+    status = GetSharedTables(quality, quantTables, huffmanTables, tables);
+    if(UMC_OK != status)
+        return status;
+
+    for(uint32_t i=0; i<m_enc.size(); i++)
+    {
+        status = SetEncoderTables(i, tables);
+        if(UMC_OK != status)
+            return status;
+    }
+
+    m_tables = tables;
+
+    return UMC_OK;
+}
+
+Status MJPEGVideoEncoder::SetEncoderTables(const mfxU32 threadNumber, const JPEGEncoderTablesPtr& tables)
+{
+    // most frames are encoded with the same tables, so there is nothing to do
+    if(m_encTables[threadNumber] == tables)
+        return UMC_OK;
+
+    m_encTables[threadNumber].reset();
+
+    JERRCODE jerr = m_enc[threadNumber]->SetTables(*tables);
+    if(JPEG_OK != jerr)
+        return UMC_ERR_FAILED;
+
+    m_encTables[threadNumber] = tables;
+
+    return UMC_OK;
+}
+
+void MJPEGVideoEncoder::DropSharedTables()
+{
+    // tables are changed in place, so encoders don't have shared ones any more
+    m_tables.reset();
+
+    for (auto& tables: m_encTables)
+    {
+        tables.reset();
+    }
+}
+
 bool MJPEGVideoEncoder::IsQuantTableInited()
 {
     return m_enc[0]->IsQuantTableInited();
@@ -450,6 +607,102 @@ Status MJPEGVideoEncoder::GetFrame(MediaData* /*in*/, MediaData* /*out*/)
 }
 
 Status MJPEGVideoEncoder::EncodePiece(const mfxU32 threadNumber, const uint32_t numPiece)
+{
+    uint32_t  numField, numScan, piecePosInField, piecePosInScan;
+    size_t    pieceSize = 0;
+    Status    status;
+
+    if (!m_IsInit)
+        return UMC_ERR_NOT_INITIALIZED;
+
+    // the thread may have encoded a frame with other tables by EncodeFrame()
+    if(m_tables)
+    {
+        status = SetEncoderTables(threadNumber, m_tables);
+        if(UMC_OK != status)
+            return status;
+    }
+
+    MediaData* buffer = m_pBitstreamBuffer[threadNumber].get();
+
+    status = EncodePiece(threadNumber, m_frame.get(), numPiece,
+                         (uint8_t*)buffer->GetBufferPointer() + buffer->GetDataSize(),
+                         buffer->GetBufferSize() - buffer->GetDataSize(),
+                         &pieceSize);
+    if(UMC_OK != status)
+        return status;
+
+    m_frame->GetPiecePosition(numPiece, &numField, &numScan, &piecePosInField, &piecePosInScan);
+
+    MJPEGEncoderScan* scan = m_frame->m_pics[numField]->m_scans[numScan];
+
+    scan->m_pieceLocation[piecePosInScan] = threadNumber;
+    scan->m_pieceOffset[piecePosInScan] = buffer->GetDataSize();
+    scan->m_pieceSize[piecePosInScan] = pieceSize;
+
+    buffer->SetDataSize(buffer->GetDataSize() + pieceSize);
+
+    return UMC_OK;
+}
+
+Status MJPEGVideoEncoder::EncodeFrame(const mfxU32 threadNumber, MJPEGEncoderFrame* frame, const mfxU16 quality, MediaData* out)
+{
+    uint32_t  numField, numScan, piecePosInField, piecePosInScan;
+    size_t    pieceSize = 0;
+    Status    status = UMC_OK;
+    JPEGEncoderTablesPtr tables = m_tables;
+
+    if (!m_IsInit)
+        return UMC_ERR_NOT_INITIALIZED;
+
+    if (!frame || !out)
+        return UMC_ERR_NULL_PTR;
+
+    if(quality)
+    {
+        status = GetSharedTables(quality, NULL, NULL, tables);
+        if(UMC_OK != status)
+            return status;
+    }
+
+    // no shared tables if they were set one by one, encoder has them already
+    if(tables)
+    {
+        status = SetEncoderTables(threadNumber, tables);
+        if(UMC_OK != status)
+            return status;
+    }
+
+    for(uint32_t numPiece=0; numPiece<frame->GetNumPieces(); numPiece++)
+    {
+        uint8_t* dst     = (uint8_t*)out->GetBufferPointer() + out->GetDataSize();
+        size_t   dstSize = out->GetBufferSize() - out->GetDataSize();
+
+        status = EncodePiece(threadNumber, frame, numPiece, dst, dstSize, &pieceSize);
+        if(UMC_OK != status)
+            return status;
+
+        frame->GetPiecePosition(numPiece, &numField, &numScan, &piecePosInField, &piecePosInScan);
+
+        // the same restart markers PostProcessing() inserts between pieces
+        if(piecePosInScan != frame->m_pics[numField]->m_scans[numScan]->GetNumPieces() - 1)
+        {
+            if(dstSize - pieceSize < 2)
+                return UMC_ERR_NOT_ENOUGH_BUFFER;
+
+            dst[pieceSize]     = 0xFF;
+            dst[pieceSize + 1] = (uint8_t)(0xD0 + (piecePosInScan % 8));
+
+            pieceSize += 2;
+        }
+
+        out->SetDataSize(out->GetDataSize() + pieceSize);
+    }
+
+    return UMC_OK;
+}
+
+Status MJPEGVideoEncoder::EncodePiece(const mfxU32 threadNumber, MJPEGEncoderFrame* frame, const uint32_t numPiece, uint8_t* dst, size_t dstSize, size_t* pieceSize)
 {
     mfxSize       srcSize;
     JCOLOR         jsrcColor = JC_NV12;
@@ -464,12 +717,11 @@ Status MJPEGVideoEncoder::EncodePiece(const mfxU32 threadNumber, const uint32_t
     CMemBuffOutput streamOut;
     uint32_t         numField, numScan, piecePosInField, piecePosInScan;
 
-    if (!m_IsInit)
-        return UMC_ERR_NOT_INITIALIZED;
+    *pieceSize = 0;
 
-    m_frame->GetPiecePosition(numPiece, &numField, &numScan, &piecePosInField, &piecePosInScan);
+    frame->GetPiecePosition(numPiece, &numField, &numScan, &piecePosInField, &piecePosInScan);
 
-    VideoData *in = m_frame->m_pics[numField]->m_sourceData.get();
+    VideoData *in = frame->m_pics[numField]->m_sourceData.get();
     VideoData *pDataIn = DynamicCast<VideoData, MediaData>(in);
 
     if(!in)
@@ -523,8 +775,7 @@ Status MJPEGVideoEncoder::EncodePiece(const mfxU32 threadNumber, const uint32_t
         return UMC_ERR_UNSUPPORTED;
     }
 
-    status = streamOut.Open((uint8_t*)m_pBitstreamBuffer[threadNumber]->GetBufferPointer() + m_pBitstreamBuffer[threadNumber]->GetDataSize(),
-                            (int)m_pBitstreamBuffer[threadNumber]->GetBufferSize() - (int)m_pBitstreamBuffer[threadNumber]->GetDataSize());
+    status = streamOut.Open(dst, (int)dstSize);
     if(JPEG_OK != status)
         return UMC_ERR_FAILED;
 
@@ -577,6 +828,10 @@ Status MJPEGVideoEncoder::EncodePiece(const mfxU32 threadNumber, const uint32_t
     else
         return UMC_ERR_UNSUPPORTED;
 
+    // generated tables replace ones set to encoder
+    if(m_EncoderParams.huffman_opt)
+        m_encTables[threadNumber].reset();
+
     if(jmode == JPEG_LOSSLESS)
     {
         status = m_enc[threadNumber]->SetParams(JPEG_LOSSLESS,
@@ -596,7 +851,7 @@ Status MJPEGVideoEncoder::EncodePiece(const mfxU32 threadNumber, const uint32_t
                                                 jss,
                                                 m_EncoderParams.restart_interval,
                                                 m_EncoderParams.interleaved,
-                                                m_frame->m_pics[numField]->GetNumPieces(),
+                                                frame->m_pics[numField]->GetNumPieces(),
                                                 piecePosInField,
                                                 numScan,
                                                 piecePosInScan,
@@ -613,23 +868,19 @@ Status MJPEGVideoEncoder::EncodePiece(const mfxU32 threadNumber, const uint32_t
 
     status = m_enc[threadNumber]->WriteHeader();
     if(JPEG_OK != status)
-        return UMC_ERR_FAILED;
+        return (streamOut.GetPosition() == dstSize) ? UMC_ERR_NOT_ENOUGH_BUFFER : UMC_ERR_FAILED;
 
     status = m_enc[threadNumber]->WriteData();
     if(JPEG_ERR_DHT_DATA == status)
         return UMC_ERR_INVALID_PARAMS;
     else if(JPEG_OK != status)
-        return UMC_ERR_FAILED;
-
-    m_frame->m_pics[numField]->m_scans[numScan]->m_pieceLocation[piecePosInScan] = threadNumber; //m_pOutputBuffer[numPic].get()->m_pieceLocation[numPiece] = threadNumber;
-    m_frame->m_pics[numField]->m_scans[numScan]->m_pieceOffset[piecePosInScan] = m_pBitstreamBuffer[threadNumber]->GetDataSize(); //m_pOutputBuffer[numPic].get()->m_pieceOffset[numPiece] = m_pBitstreamBuffer[threadNumber].get()->GetDataSize();
-    m_frame->m_pics[numField]->m_scans[numScan]->m_pieceSize[piecePosInScan] = streamOut.GetPosition(); //m_pOutputBuffer[numPic].get()->m_pieceSize[numPiece] = streamOut.GetPosition();
+        return (streamOut.GetPosition() == dstSize) ? UMC_ERR_NOT_ENOUGH_BUFFER : UMC_ERR_FAILED;
 
     //out->SetTime(pDataIn->GetTime());
 
-    m_pBitstreamBuffer[threadNumber]->SetDataSize(m_pBitstreamBuffer[threadNumber]->GetDataSize() + streamOut.GetPosition());
+    *pieceSize = streamOut.GetPosition();
 
-    return status;
+    return UMC_OK;
 }
 
 Status MJPEGVideoEncoder::PostProcessing(MediaData* out)
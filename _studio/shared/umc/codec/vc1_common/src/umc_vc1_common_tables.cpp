@@ -202,11 +202,12 @@ const extern int32_t VC1_Bitplane_IMODE_tbl[] =
 //58      3           5         1       8 = (3 << 8)|  1    13
 //60      3           5         0       8 = (3 << 8)|  0    13
 
+//one level table, a tile code is decoded by a single lookup
 const extern int32_t VC1_BitplaneTaledbitsTbl[] =
 {
  13, /* max bits */
- 2,  /* total subtables */
- 6,7,/* subtable sizes */
+ 1,  /* total subtables */
+ 13, /* subtable sizes */
 
  1, /* 1-bit codes */
     1,       0 ,
@@ -25,6 +25,9 @@
 #ifndef __UMC_VC1_HUFFMAN_H__
 #define __UMC_VC1_HUFFMAN_H__
 
+// value of the table entries which do not match any code word
+#define VLC_FORBIDDEN 0xf0f1
+
 // return value 0 means ok, != 0 - failed.
 
 int DecodeHuffmanOne(uint32_t**  pBitStream, int* pOffset,
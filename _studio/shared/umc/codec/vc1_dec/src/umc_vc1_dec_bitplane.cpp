@@ -23,7 +23,6 @@
 #if defined (MFX_ENABLE_VC1_VIDEO_DECODE)
 
 #include <string.h>
-#include <tuple>
 
 #include "umc_vc1_dec_seq.h"
 #include "umc_vc1_huffman.h"
@@ -59,46 +58,153 @@
 
 
 
+//Bitplane values are 0 or 1 per byte, so the inversion and differential
+//restore below work on eight macroblocks per 64-bit word.
+static const uint64_t VC1_BITPLANE_ONES = 0x0101010101010101ull;
+
+static inline uint64_t LoadBitplaneWord(const uint8_t* pSrc)
+{
+    uint64_t w;
+    memcpy(&w, pSrc, sizeof(w));
+    return w;
+}
+
+static inline void StoreBitplaneWord(uint8_t* pDst, uint64_t w)
+{
+    memcpy(pDst, &w, sizeof(w));
+}
+
+//Differential restore, 4.10.3.4:
+//  top left:     b = d ^ INVERT
+//  first column: b = d ^ b(above)
+//  first row:    b = d ^ b(left)
+//  otherwise:    b = d ^ (b(left) != b(above) ? INVERT : b(left))
+//For 0/1 values the last rule is b = d ^ (b(left) & b(above)) when INVERT
+//is 0 and b = (d ^ b(above)) ^ (b(left) & ~b(above)) when INVERT is 1, so
+//every row is a chain b[j] = c[j] ^ (m[j] & b[j-1]). The chain is resolved
+//for eight values at once by composing the (m, c) pairs in log2(8) steps.
+//The first row uses m = 1 and starts from INVERT, the other rows start from
+//b(above) of the first column, which gives the first column rule for both
+//INVERT values.
 static void InverseDiff(VC1Bitplane* pBitplane, int32_t widthMB, int32_t heightMB,int32_t MaxWidthMB)
 {
+    const uint64_t invertMask = pBitplane->m_invert ? VC1_BITPLANE_ONES : 0;
+    uint8_t* pRow = pBitplane->m_databits;
+    const uint8_t* pAbove = NULL;
     int32_t i, j;
 
-    for(i = 0; i < heightMB; i++)
+    for(i = 0; i < heightMB; i++, pAbove = pRow, pRow += MaxWidthMB)
     {
-        for(j = 0; j < widthMB; j++)
+        uint8_t left = pAbove ? pAbove[0] : pBitplane->m_invert;
+
+        for(j = 0; j + 8 <= widthMB; j += 8)
         {
-            if((i == 0 && j == 0))
-            {
-                pBitplane->m_databits[i*MaxWidthMB + j] = pBitplane->m_databits[i*MaxWidthMB + j] ^ pBitplane->m_invert;
-            }
-            else if(j == 0)
-            {
-                pBitplane->m_databits[i*MaxWidthMB + j] = pBitplane->m_databits[i*MaxWidthMB + j] ^pBitplane->m_databits[MaxWidthMB*(i-1)];
-            }
-            else if(((i>0) && (pBitplane->m_databits[i*MaxWidthMB+j-1] != pBitplane->m_databits[(i-1)*MaxWidthMB+j])))
+            uint64_t c = LoadBitplaneWord(pRow + j);
+            uint64_t m = VC1_BITPLANE_ONES;
+
+            if (pAbove)
             {
-                pBitplane->m_databits[i*MaxWidthMB + j] = pBitplane->m_databits[i*MaxWidthMB + j] ^ pBitplane->m_invert;
+                uint64_t a = LoadBitplaneWord(pAbove + j);
+                c ^= a & invertMask;
+                m  = a ^ invertMask;
             }
-            else
+
+            //prefix composition: (m, c) at byte k becomes the map from
+            //the value left of this word to the value at byte k
+            c ^= m & (c << 8);
+            m &= (m << 8) | 0x01;
+            c ^= m & (c << 16);
+            m &= (m << 16) | 0x0101;
+            c ^= m & (c << 32);
+            m &= (m << 32) | 0x01010101;
+
+            c ^= m & (left * VC1_BITPLANE_ONES);
+            StoreBitplaneWord(pRow + j, c);
+            left = (uint8_t)(c >> 56);
+        }
+
+        for(; j < widthMB; j++)
+        {
+            uint8_t m = 1;
+            uint8_t c = pRow[j];
+
+            if (pAbove)
             {
-                pBitplane->m_databits[i*MaxWidthMB + j] = pBitplane->m_databits[i*MaxWidthMB + j] ^ pBitplane->m_databits[i*MaxWidthMB + j - 1];
+                c ^= pAbove[j] & pBitplane->m_invert;
+                m  = pAbove[j] ^ pBitplane->m_invert;
             }
+
+            left = c ^ (m & left);
+            pRow[j] = left;
         }
     }
-
 }
 
 
 static void InverseBitplane(VC1Bitplane* pBitplane, int32_t size)
 {
+    uint8_t* pData = pBitplane->m_databits;
     int32_t i;
 
-    for(i = 0; i < size; i++)
+    for(i = 0; i + 8 <= size; i += 8)
+    {
+        StoreBitplaneWord(pData + i, LoadBitplaneWord(pData + i) ^ VC1_BITPLANE_ONES);
+    }
+
+    for(; i < size; i++)
+    {
+        pData[i] ^= 1;
+    }
+}
+
+//Single lookup VLC decode. The bitplane tables are built from one level
+//specs, so an entry never refers to a subtable. Entry layout is the one of
+//DecodeHuffmanOne: value << 8 | number of looked ahead bits to return.
+static inline int32_t DecodeBitplaneVLC(VC1Context* pContext, const int32_t* pTable)
+{
+    int32_t tableBits = pTable[0];
+    uint32_t pos;
+    int32_t val;
+    int32_t codeLen;
+
+    VC1_NEXT_BITS(tableBits, pos);
+    val = pTable[pos + 1];
+    VM_ASSERT(!(val & 0x80));
+
+    codeLen = tableBits - (val & 0xff);
+    val >>= 8;
+    //like DecodeHuffmanOne, do not return bits of a forbidden code
+    if (val == VLC_FORBIDDEN)
+        codeLen = tableBits;
+
+    VC1_GET_BITS(codeLen, pos);
+    return val;
+}
+
+//Copies count raw bits to pDst with the given step, up to 24 bits per read
+static void GetRawBitplaneBits(VC1Context* pContext, uint8_t* pDst, int32_t count, int32_t step)
+{
+    while (count > 0)
     {
-        pBitplane->m_databits[i] = pBitplane->m_databits[i] ^ 1;
+        int32_t nBits = (count < 24) ? count : 24;
+        uint32_t bits;
+
+        VC1_GET_BITS(nBits, bits);
+        count -= nBits;
+
+        for (int32_t n = nBits - 1; n >= 0; n--, pDst += step)
+            *pDst = (uint8_t)((bits >> n) & 1);
     }
 }
 
+//Norm-2/Diff-2 pairs by the next three bits:
+//bit 0 - first symbol, bit 1 - second symbol, bits 4..5 - code length
+static const uint8_t VC1_Norm2Pairs[8] =
+{
+    0x10, 0x10, 0x10, 0x10, //0   -> 0 0
+    0x31, 0x32,             //100 -> 1 0, 101 -> 0 1
+    0x23, 0x23              //11  -> 1 1
+};
 
 static void Norm2ModeDecode(VC1Context* pContext,VC1Bitplane* pBitplane, int32_t width, int32_t height,int32_t MaxWidthMB)
 {
@@ -116,7 +222,7 @@ static void Norm2ModeDecode(VC1Context* pContext,VC1Bitplane* pBitplane, int32_t
     k = 0;
     for(i = (width*height) & 1; i < (width*height/2)*2; i+=2)
     {
-        int32_t tmp;
+        uint32_t bits;
         int32_t index = k*MaxWidthMB + j;
         
         j++;
@@ -127,35 +233,12 @@ static void Norm2ModeDecode(VC1Context* pContext,VC1Bitplane* pBitplane, int32_t
         j++;
         if(j == width) {j = 0; k++;}
 
-        VC1_GET_BITS(1, tmp);
-        if(tmp == 0)
-        {
-            pBitplane->m_databits[index]   = 0;
-            pBitplane->m_databits[indexNext] = 0;
-        }
-        else
-        {
-            VC1_GET_BITS(1, tmp);
-            if(tmp == 1)
-            {
-                pBitplane->m_databits[index]   = 1;
-                pBitplane->m_databits[indexNext] = 1;
-            }
-            else
-            {
-                VC1_GET_BITS(1, tmp);
-                if(tmp == 0)
-                {
-                    pBitplane->m_databits[index]   = 1;
-                    pBitplane->m_databits[indexNext] = 0;
-                }
-                else
-                {
-                    pBitplane->m_databits[index]   = 0;
-                    pBitplane->m_databits[indexNext] = 1;
-                }
-            }
-        }
+        VC1_NEXT_BITS(3, bits);
+        uint8_t pair = VC1_Norm2Pairs[bits];
+        VC1_GET_BITS(pair >> 4, bits);
+
+        pBitplane->m_databits[index]     = pair & 1;
+        pBitplane->m_databits[indexNext] = (pair >> 1) & 1;
     }
 
 }
@@ -163,7 +246,6 @@ static void Norm2ModeDecode(VC1Context* pContext,VC1Bitplane* pBitplane, int32_t
 
 static void Norm6ModeDecode(VC1Context* pContext, VC1Bitplane* pBitplane, int32_t width, int32_t height,int32_t MaxWidthMB)
 {
-    int ret;
     int32_t i, j;
     int32_t k;
     int32_t ResidualX = 0;
@@ -188,14 +270,8 @@ static void Norm6ModeDecode(VC1Context* pContext, VC1Bitplane* pBitplane, int32_
 
             for(j = 0; j < sizeW; j++)
             {
-                ret = DecodeHuffmanOne(
-                            &pContext->m_bitstream.pBitstream,
-                            &pContext->m_bitstream.bitOffset,
-                            &k,
-                            pContext->m_vlcTbl->m_BitplaneTaledbits
-                            );
-                std::ignore = ret;
-                VM_ASSERT(ret == 0);
+                k = DecodeBitplaneVLC(pContext, pContext->m_vlcTbl->m_BitplaneTaledbits);
+                VM_ASSERT(k != VLC_FORBIDDEN);
 
                 currRowTails[0] = (uint8_t)(k&1);
                 currRowTails[1] = (uint8_t)((k&2)>>1);
@@ -231,13 +307,8 @@ static void Norm6ModeDecode(VC1Context* pContext, VC1Bitplane* pBitplane, int32_
 
             for(j = 0; j < sizeW; j++)
             {
-                ret = DecodeHuffmanOne(
-                            &pContext->m_bitstream.pBitstream,
-                            &pContext->m_bitstream.bitOffset,
-                            &k,
-                            pContext->m_vlcTbl->m_BitplaneTaledbits
-                            );
-                VM_ASSERT(ret == ippStsNoErr);
+                k = DecodeBitplaneVLC(pContext, pContext->m_vlcTbl->m_BitplaneTaledbits);
+                VM_ASSERT(k != VLC_FORBIDDEN);
 
                 currRowTails[0] = (uint8_t)(k&1);
                 currRowTails[1] = (uint8_t)((k&2)>>1);
@@ -263,12 +334,7 @@ static void Norm6ModeDecode(VC1Context* pContext, VC1Bitplane* pBitplane, int32_
 
         if(1 == ColSkip)
         {
-            for(j = 0; j < height; j++)
-            {
-                int32_t Value = 0;
-                VC1_GET_BITS(1, Value);
-                pBitplane->m_databits[i + MaxWidthMB * j] = (uint8_t)Value;
-            }
+            GetRawBitplaneBits(pContext, &pBitplane->m_databits[i], height, MaxWidthMB);
         }
         else
         {
@@ -288,12 +354,7 @@ static void Norm6ModeDecode(VC1Context* pContext, VC1Bitplane* pBitplane, int32_
 
         if(1 == RowSkip)
         {
-            for(i = ResidualX; i < width; i++)
-            {
-                int32_t Value = 0;
-                VC1_GET_BITS(1, Value);
-                pBitplane->m_databits[i] = (uint8_t)Value;
-            }
+            GetRawBitplaneBits(pContext, &pBitplane->m_databits[ResidualX], width - ResidualX, 1);
         }
         else
         {
@@ -310,9 +371,7 @@ void DecodeBitplane(VC1Context* pContext, VC1Bitplane* pBitplane, int32_t width,
 {
     int32_t tmp;
     int32_t i, j;
-    int ret;
     int32_t tmp_invert = 0;
-    int32_t tmp_databits = 0;
 
     memset(pBitplane, 0, sizeof(VC1Bitplane));
 
@@ -349,14 +408,8 @@ void DecodeBitplane(VC1Context* pContext, VC1Bitplane* pBitplane, int32_t width,
     //Diff-6        0001
     //Rowskip        010
     //Colskip        011
-    ret = DecodeHuffmanOne(
-                &pContext->m_bitstream.pBitstream,
-                &pContext->m_bitstream.bitOffset,
-                &pBitplane->m_imode,
-                pContext->m_vlcTbl->m_Bitplane_IMODE
-                );
-    std::ignore = ret;
-    VM_ASSERT(ret == 0);
+    pBitplane->m_imode = DecodeBitplaneVLC(pContext, pContext->m_vlcTbl->m_Bitplane_IMODE);
+    VM_ASSERT(pBitplane->m_imode != VLC_FORBIDDEN);
 
     //The DATABITS field shown in the syntax diagram of Figure 28 is an entropy
     //coded stream of symbols that is based on the coding mode. The seven coding
@@ -433,11 +486,7 @@ void DecodeBitplane(VC1Context* pContext, VC1Bitplane* pBitplane, int32_t width,
             }
             else
             {
-                for(j = 0; j < width; j++)
-                {
-                    VC1_GET_BITS(1, tmp_databits);
-                    pBitplane->m_databits[pContext->m_seqLayerHeader.MaxWidthMB*i + j] = (uint8_t)tmp_databits;
-                }
+                GetRawBitplaneBits(pContext, &pBitplane->m_databits[pContext->m_seqLayerHeader.MaxWidthMB*i], width, 1);
             }
         }
         if(pBitplane->m_invert)
@@ -459,11 +508,7 @@ void DecodeBitplane(VC1Context* pContext, VC1Bitplane* pBitplane, int32_t width,
             }
             else
             {
-                for(j = 0; j < height; j++)
-                {
-                    VC1_GET_BITS(1, tmp_databits);
-                    pBitplane->m_databits[i + j*pContext->m_seqLayerHeader.MaxWidthMB] = (uint8_t)tmp_databits;
-                }
+                GetRawBitplaneBits(pContext, &pBitplane->m_databits[i], height, pContext->m_seqLayerHeader.MaxWidthMB);
             }
         }
         if(pBitplane->m_invert)
@@ -27,8 +27,6 @@
 #include <cstdlib>
 using namespace UMC;
 
-#define VLC_FORBIDDEN 0xf0f1
-
 static uint32_t bit_mask[33] =
 {
     0x0,
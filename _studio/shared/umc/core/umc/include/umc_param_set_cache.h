@@ -0,0 +1,198 @@
+// Copyright (c) 2020 Intel Corporation
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __UMC_PARAM_SET_CACHE_H__
+#define __UMC_PARAM_SET_CACHE_H__
+
+#include <list>
+#include <algorithm>
+#include <vector>
+#include <unordered_map>
+#include "umc_mutex.h"
+
+namespace UMC
+{
+
+// Process-wide cache of parsed parameter sets shared by all decoder instances.
+// Parameter set is looked up by raw NAL unit payload (as it is in the bitstream,
+// with emulation prevention bytes) plus parsing context (decoder flags which
+// affect parsing result), so a hit skips both payload unescaping and parsing.
+// Only parameter sets which are parsed independently of other ones may be cached.
+template <class T>
+class ParamSetCache
+{
+public:
+    enum
+    {
+        DEFAULT_CAPACITY = 1024
+    };
+
+    struct Stats
+    {
+        unsigned long long hits;
+        unsigned long long misses;
+        unsigned long long evictions;
+        size_t             size;
+    };
+
+    static ParamSetCache & Instance()
+    {
+        static ParamSetCache cache;
+        return cache;
+    }
+
+    // Copies cached parameter set to [ps], returns false if there is no one
+    bool Find(const uint8_t * data, size_t size, uint32_t context, T & ps)
+    {
+        uint64_t key = Hash(data, size, context);
+
+        AutomaticUMCMutex guard(m_guard);
+
+        typename Index::iterator it = m_index.find(key);
+        if (it == m_index.end() || !it->second->Equal(data, size, context))
+        {
+            m_stats.misses++;
+            return false;
+        }
+
+        // move to the head of LRU list
+        m_entries.splice(m_entries.begin(), m_entries, it->second);
+        m_stats.hits++;
+
+        ps = it->second->ps;
+        return true;
+    }
+
+    void Add(const uint8_t * data, size_t size, uint32_t context, const T & ps)
+    {
+        uint64_t key = Hash(data, size, context);
+
+        AutomaticUMCMutex guard(m_guard);
+
+        if (!m_capacity)
+            return;
+
+        typename Index::iterator it = m_index.find(key);
+        if (it != m_index.end())
+        {
+            // same content added by concurrent session or hash collision
+            m_entries.erase(it->second);
+            m_index.erase(it);
+        }
+
+        while (m_entries.size() >= m_capacity)
+            Evict();
+
+        m_entries.push_front(Entry());
+
+        Entry & entry = m_entries.front();
+        entry.key = key;
+        entry.context = context;
+        entry.data.assign(data, data + size);
+        entry.ps = ps;
+
+        m_index[key] = m_entries.begin();
+    }
+
+    // 0 disables caching
+    void SetCapacity(size_t capacity)
+    {
+        AutomaticUMCMutex guard(m_guard);
+
+        m_capacity = capacity;
+        while (m_entries.size() > m_capacity)
+            Evict();
+    }
+
+    void Clear()
+    {
+        AutomaticUMCMutex guard(m_guard);
+
+        m_entries.clear();
+        m_index.clear();
+    }
+
+    Stats GetStats()
+    {
+        AutomaticUMCMutex guard(m_guard);
+
+        Stats stats = m_stats;
+        stats.size = m_entries.size();
+        return stats;
+    }
+
+private:
+
+    struct Entry
+    {
+        uint64_t             key;
+        uint32_t             context;
+        std::vector<uint8_t> data;
+        T                    ps;
+
+        bool Equal(const uint8_t * d, size_t size, uint32_t ctx) const
+        {
+            return context == ctx && data.size() == size && std::equal(data.begin(), data.end(), d);
+        }
+    };
+
+    typedef std::list<Entry> Entries;
+    typedef std::unordered_map<uint64_t, typename Entries::iterator> Index;
+
+    ParamSetCache()
+        : m_capacity(DEFAULT_CAPACITY)
+    {
+        m_stats = Stats();
+    }
+
+    ParamSetCache(const ParamSetCache &);
+    ParamSetCache & operator = (const ParamSetCache &);
+
+    // FNV-1a
+    static uint64_t Hash(const uint8_t * data, size_t size, uint32_t context)
+    {
+        uint64_t hash = 0xcbf29ce484222325ull ^ context;
+
+        for (size_t i = 0; i < size; i++)
+        {
+            hash ^= data[i];
+            hash *= 0x100000001b3ull;
+        }
+
+        return hash;
+    }
+
+    void Evict()
+    {
+        m_index.erase(m_entries.back().key);
+        m_entries.pop_back();
+        m_stats.evictions++;
+    }
+
+    Mutex   m_guard;
+    size_t  m_capacity;
+    Entries m_entries;
+    Index   m_index;
+    Stats   m_stats;
+};
+
+} // namespace UMC
+
+#endif // __UMC_PARAM_SET_CACHE_H__
@@ -75,7 +75,10 @@ ColorFormatInfo FormatInfo[] =
     {YUV420A, 4,  8, 1, {{1, 1, 1, 1}, {2, 2, 1, 1}, {2, 2, 1, 1}, {1, 1, 1, 1}}},
     {YUV422A, 4,  8, 1, {{1, 1, 1, 1}, {2, 1, 1, 1}, {2, 1, 1, 1}, {1, 1, 1, 1}}},
     {YUV444A, 4,  8, 1, {{1, 1, 1, 1}, {1, 1, 1, 1}, {1, 1, 1, 1}, {1, 1, 1, 1}}},
-    {YVU9,    3,  8, 1, {{1, 1, 1, 1}, {4, 4, 1, 1}, {4, 4, 1, 1}}}
+    {YVU9,    3,  8, 1, {{1, 1, 1, 1}, {4, 4, 1, 1}, {4, 4, 1, 1}}},
+    {AYUV,    1,  8, 4, {{1, 1, 4, 1}}},
+    {P010,    2, 10, 2, {{1, 1, 1, 1}, {1, 2, 1, 1}, }},
+    {Y210,    1, 10, 4, {{2, 1, 4, 1}}}
 };
 
 // Number of entries in the FormatInfo table
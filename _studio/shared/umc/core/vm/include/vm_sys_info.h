@@ -32,6 +32,13 @@ extern "C"
 /* Functions to obtain processor's specific information */
 uint32_t vm_sys_info_get_cpu_num(void);
 
+/* Fills the set of logical CPUs of NUMA node (bit i%32 of mask[i/32] for CPU i),
+   returns number of CPUs in the set, 0 if the node is unknown */
+uint32_t vm_sys_info_get_numa_node_cpus(uint32_t node, uint32_t *mask, uint32_t maskSize);
+
+/* Returns NUMA node of logical CPU, -1 if unknown */
+int32_t vm_sys_info_get_cpu_numa_node(uint32_t cpu);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -22,6 +22,10 @@
 
 #include "vm_sys_info.h"
 #include <unistd.h>
+#include <stdio.h>
+#include <string.h>
+
+#define VM_MAX_NUMA_NODES 64
 
 uint32_t vm_sys_info_get_cpu_num(void)
 {
@@ -32,6 +36,66 @@ uint32_t vm_sys_info_get_cpu_num(void)
 #endif
 }
 
+
+uint32_t vm_sys_info_get_numa_node_cpus(uint32_t node, uint32_t *mask, uint32_t maskSize)
+{
+    char path[64];
+    FILE *file;
+    uint32_t count = 0;
+    unsigned int first, last;
+
+    if (!mask || !maskSize)
+        return 0;
+
+    memset(mask, 0, maskSize * sizeof(uint32_t));
+
+    snprintf(path, sizeof(path), "/sys/devices/system/node/node%u/cpulist", node);
+    file = fopen(path, "r");
+    if (!file)
+        return 0;
+
+    /* the list looks like "0-9,20-29" */
+    while (1 == fscanf(file, "%u", &first))
+    {
+        int c = fgetc(file);
+
+        last = first;
+        if ('-' == c)
+        {
+            if (1 != fscanf(file, "%u", &last))
+                break;
+            c = fgetc(file);
+        }
+
+        for (; first <= last && first < maskSize * 32; first++)
+        {
+            mask[first / 32] |= 1u << (first % 32);
+            count++;
+        }
+
+        if (',' != c)
+            break;
+    }
+
+    fclose(file);
+    return count;
+}
+
+int32_t vm_sys_info_get_cpu_numa_node(uint32_t cpu)
+{
+    char path[64];
+    int32_t node;
+
+    for (node = 0; node < VM_MAX_NUMA_NODES; node++)
+    {
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u/node%d", cpu, node);
+        if (0 == access(path, F_OK))
+            return node;
+    }
+
+    return -1;
+}
+
 #else
 # pragma warning( disable: 4206 )
 #endif /* LINUX32 */
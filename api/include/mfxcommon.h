@@ -152,7 +152,15 @@ typedef struct {
     mfxU16       NumThread;
     mfxI32       SchedulingType;
     mfxI32       Priority;
+#if (MFX_VERSION >= MFX_VERSION_NEXT)
+    mfxU16       NumaNode;
+    mfxU16       reserved1;
+    mfxU32       CpuMask[16];
+    mfxU32       FrameDeadline;
+    mfxU16       reserved[20];
+#else
     mfxU16       reserved[55];
+#endif
 } mfxExtThreadsParam;
 MFX_PACK_END()
 
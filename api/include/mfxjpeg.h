@@ -21,6 +21,7 @@
 #define __MFX_JPEG_H__
 
 #include "mfxdefs.h"
+#include "mfxstructures.h"
 
 #ifdef __cplusplus
 extern "C"
@@ -48,7 +49,10 @@ enum
 
 enum {
     MFX_EXTBUFF_JPEG_QT      = MFX_MAKEFOURCC('J','P','G','Q'),
-    MFX_EXTBUFF_JPEG_HUFFMAN = MFX_MAKEFOURCC('J','P','G','H')
+    MFX_EXTBUFF_JPEG_HUFFMAN = MFX_MAKEFOURCC('J','P','G','H'),
+#if (MFX_VERSION >= MFX_VERSION_NEXT)
+    MFX_EXTBUFF_JPEG_BATCH   = MFX_MAKEFOURCC('J','P','G','B')
+#endif
 };
 
 enum {
@@ -98,6 +102,24 @@ typedef struct {
 } mfxExtJPEGHuffmanTables;
 MFX_PACK_END()
 
+#if (MFX_VERSION >= MFX_VERSION_NEXT)
+/* Frames encoded by the same EncodeFrameAsync call in addition to its input surface.
+   Attached to mfxEncodeCtrl. Every frame is encoded to its own bitstream, all of them
+   are ready when the sync point of the call is. */
+MFX_PACK_BEGIN_STRUCT_W_PTR()
+typedef struct {
+    mfxExtBuffer       Header;
+
+    mfxU16             reserved[3];
+    mfxU16             NumFrame;
+    mfxFrameSurface1** Surfaces;
+    mfxBitstream**     Bitstreams;
+    mfxU16*            Quality;     /* optional, 0 means the quality the encoder is initialized with */
+    mfxU32             reserved1[8];
+} mfxExtJPEGBatch;
+MFX_PACK_END()
+#endif
+
 #ifdef __cplusplus
 } // extern "C"
 #endif /* __cplusplus */
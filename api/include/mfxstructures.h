@@ -352,7 +352,12 @@ typedef struct {
             mfxU16  Interleaved;
             mfxU16  Quality;
             mfxU16  RestartInterval;
+#if (MFX_VERSION >= MFX_VERSION_NEXT)
+            mfxU16  OptimizeHuffman;
+            mfxU16  reserved5[9];
+#else
             mfxU16  reserved5[10];
+#endif
         };
     };
 } mfxInfoMFX;
@@ -1033,7 +1038,14 @@ MFX_PACK_END()
 /* statistics collected for decode, encode and vpp */
 MFX_PACK_BEGIN_STRUCT_W_L_TYPE()
 typedef struct {
+#if (MFX_VERSION >= MFX_VERSION_NEXT)
+    mfxU64  NumDeadlineTask;
+    mfxU64  NumMissedDeadline;
+    mfxU64  MaxDeadlineLateness;
+    mfxU32  reserved[10];
+#else
     mfxU32  reserved[16];
+#endif
     mfxU32  NumFrame;
     mfxU64  NumBit;
     mfxU32  NumCachedFrame;
@@ -1042,7 +1054,14 @@ MFX_PACK_END()
 
 MFX_PACK_BEGIN_USUAL_STRUCT()
 typedef struct {
+#if (MFX_VERSION >= MFX_VERSION_NEXT)
+    mfxU64  NumDeadlineTask;
+    mfxU64  NumMissedDeadline;
+    mfxU64  MaxDeadlineLateness;
+    mfxU32  reserved[10];
+#else
     mfxU32  reserved[16];
+#endif
     mfxU32  NumFrame;
     mfxU32  NumSkippedFrame;
     mfxU32  NumError;
@@ -1052,7 +1071,14 @@ MFX_PACK_END()
 
 MFX_PACK_BEGIN_USUAL_STRUCT()
 typedef struct {
+#if (MFX_VERSION >= MFX_VERSION_NEXT)
+    mfxU64  NumDeadlineTask;
+    mfxU64  NumMissedDeadline;
+    mfxU64  MaxDeadlineLateness;
+    mfxU32  reserved[10];
+#else
     mfxU32  reserved[16];
+#endif
     mfxU32  NumFrame;
     mfxU32  NumCachedFrame;
 } mfxVPPStat;
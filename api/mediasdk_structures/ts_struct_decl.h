@@ -259,23 +259,56 @@ STRUCT(mfxExtVPPProcAmp,
     FIELD_T(mfxF64, Saturation  )
 )
 
+#if (MFX_VERSION >= MFX_VERSION_NEXT)
+STRUCT(mfxEncodeStat,
+    FIELD_T(mfxU64, NumDeadlineTask     )
+    FIELD_T(mfxU64, NumMissedDeadline   )
+    FIELD_T(mfxU64, MaxDeadlineLateness )
+    FIELD_T(mfxU32, NumFrame            )
+    FIELD_T(mfxU64, NumBit              )
+    FIELD_T(mfxU32, NumCachedFrame      )
+)
+#else
 STRUCT(mfxEncodeStat,
     FIELD_T(mfxU32, NumFrame            )
     FIELD_T(mfxU64, NumBit              )
     FIELD_T(mfxU32, NumCachedFrame      )
 )
+#endif
 
+#if (MFX_VERSION >= MFX_VERSION_NEXT)
+STRUCT(mfxDecodeStat,
+    FIELD_T(mfxU64, NumDeadlineTask     )
+    FIELD_T(mfxU64, NumMissedDeadline   )
+    FIELD_T(mfxU64, MaxDeadlineLateness )
+    FIELD_T(mfxU32, NumFrame        )
+    FIELD_T(mfxU32, NumSkippedFrame )
+    FIELD_T(mfxU32, NumError        )
+    FIELD_T(mfxU32, NumCachedFrame  )
+)
+#else
 STRUCT(mfxDecodeStat,
     FIELD_T(mfxU32, NumFrame        )
     FIELD_T(mfxU32, NumSkippedFrame )
     FIELD_T(mfxU32, NumError        )
     FIELD_T(mfxU32, NumCachedFrame  )
 )
+#endif
 
+#if (MFX_VERSION >= MFX_VERSION_NEXT)
 STRUCT(mfxVPPStat,
+    FIELD_T(mfxU64, NumDeadlineTask     )
+    FIELD_T(mfxU64, NumMissedDeadline   )
+    FIELD_T(mfxU64, MaxDeadlineLateness )
     FIELD_T(mfxU32, NumFrame        )
     FIELD_T(mfxU32, NumCachedFrame  )
 )
+#else
+STRUCT(mfxVPPStat,
+    FIELD_T(mfxU32, NumFrame        )
+    FIELD_T(mfxU32, NumCachedFrame  )
+)
+#endif
 
 STRUCT(mfxExtVppAuxData,
     FIELD_S(mfxExtBuffer, Header)
@@ -0,0 +1,101 @@
+/******************************************************************************\
+Copyright (c) 2020, Intel Corporation
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+This sample was distributed or derived from the Intel's Media Samples package.
+The original version of this sample may be obtained from https://software.intel.com/en-us/intel-media-server-studio
+or https://software.intel.com/en-us/media-client-solutions-support.
+\**********************************************************************************/
+
+#ifndef __ANNEXB_SCANNER_H__
+#define __ANNEXB_SCANNER_H__
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+#include "mfxstructures.h"
+
+// Kind of an AVC or HEVC NAL unit or of an MPEG-2 start code
+enum AnnexBUnitClass
+{
+    UNIT_OTHER,
+    UNIT_HEADER,        // parameter set, MPEG-2 sequence header
+    UNIT_HEADER_EXT,    // MPEG-2 extension, belongs to the preceding header if any
+    UNIT_AU_PREFIX,     // may start an access unit: AUD, SEI, GOP header etc.
+    UNIT_RAP,           // first unit of a random access picture
+    UNIT_LEADING,       // first unit of a picture which isn't decodable after a seek to the preceding RAP
+    UNIT_LEADING_RADL,  // first unit of a decodable picture displayed before the preceding RAP
+    UNIT_PICTURE,       // first unit of any other picture
+    UNIT_SLICE          // rest of a picture
+};
+
+// bytes after the start code needed for classification
+const size_t ANNEXB_HEADER_BYTES = 5;
+
+// classifies the unit by the first bytes after the start code,
+// bClosedGop keeps closed_gop of the last MPEG-2 GOP header
+AnnexBUnitClass ClassifyAnnexBUnit(mfxU32 codecId, const mfxU8 hdr[ANNEXB_HEADER_BYTES], bool &bClosedGop);
+
+// type and id of the parameter set which starts with 4-byte start code,
+// a newer parameter set replaces the older one with the same key
+mfxU64 GetParamSetKey(mfxU32 codecId, const std::vector<mfxU8> &header);
+
+// Finds units of AVC, HEVC or MPEG-2 elementary stream read by parts, classifies
+// them and collects parameter sets, MPEG-2 sequence header goes with its extensions
+class CAnnexBScanner
+{
+public:
+    struct Unit
+    {
+        mfxU64          Offset; // start code position
+        AnnexBUnitClass Class;
+        const mfxU8    *Header; // ANNEXB_HEADER_BYTES after the start code, zero padded for shorter units
+    };
+
+    // a parameter set is reported when the next unit is found, before that unit
+    typedef std::function<void(const Unit &unit)> UnitHandler;
+    typedef std::function<mfxStatus(mfxU64 key, std::vector<mfxU8> &header)> HeaderHandler;
+
+    CAnnexBScanner(mfxU32 codecId, const UnitHandler &onUnit, const HeaderHandler &onHeader);
+
+    // scans the next part of the stream, stops with the first error of onHeader
+    mfxStatus Scan(const mfxU8 *data, size_t size);
+
+    // the stream is over, reports the last unit and parameter set
+    mfxStatus Finish();
+
+    // number of bytes scanned
+    mfxU64 GetPosition() const { return m_pos; }
+
+protected:
+    mfxStatus ProcessUnit(bool bComplete);
+    mfxStatus FinishCapture();
+
+    mfxU32 m_codecId;
+    UnitHandler   m_onUnit;
+    HeaderHandler m_onHeader;
+
+    mfxU64 m_pos;
+    mfxU32 m_code;                      // last four bytes
+    mfxU8  m_hdr[ANNEXB_HEADER_BYTES];
+    size_t m_hdrLen;                    // bytes of the current unit header collected
+    mfxU64 m_unitOffset;                // start code position of the current unit
+    bool   m_bClosedGop;
+
+    std::vector<mfxU8> m_capture;       // parameter set being collected
+    size_t m_captureEnd;                // capture size before the start code of the current unit
+    bool   m_bCapture;
+};
+
+#endif //__ANNEXB_SCANNER_H__
@@ -923,6 +923,8 @@ protected:
     mfxU32       m_numCreatedFiles;
     msdk_string  m_sFile;
     mfxU32       m_nViews;
+    // chroma planes of frame written in planar format
+    std::vector<mfxU8> m_planarBuf;
 };
 
 class CSmplBitstreamReader
@@ -932,15 +934,21 @@ public :
     CSmplBitstreamReader();
     virtual ~CSmplBitstreamReader();
 
-    //resets position to file begin
+    //resets position to file begin or to the point set by Seek
     virtual void      Reset();
     virtual void      Close();
     virtual mfxStatus Init(const msdk_char *strFileName);
     virtual mfxStatus ReadNextFrame(mfxBitstream *pBS);
+    //continues reading from the given offset, headers are returned before the data there
+    virtual mfxStatus Seek(mfxU64 nOffset, const std::vector<mfxU8> &headers);
 
 protected:
     FILE*     m_fSource;
     bool      m_bInited;
+
+    mfxU64             m_nStartOffset;
+    std::vector<mfxU8> m_startHeaders;
+    size_t             m_nHeadersSent;
 };
 
 class CH264FrameReader : public CSmplBitstreamReader
@@ -0,0 +1,69 @@
+/******************************************************************************\
+Copyright (c) 2020, Intel Corporation
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+This sample was distributed or derived from the Intel's Media Samples package.
+The original version of this sample may be obtained from https://software.intel.com/en-us/intel-media-server-studio
+or https://software.intel.com/en-us/media-client-solutions-support.
+\**********************************************************************************/
+
+#ifndef __STREAM_INDEX_H__
+#define __STREAM_INDEX_H__
+
+#include <vector>
+
+#include "sample_utils.h"
+
+// Picture the decoder can start from: an IDR, CRA or BLA picture of AVC/HEVC,
+// an I picture after an MPEG-2 sequence or GOP header, an AV1 key frame
+struct StreamRandomAccessPoint
+{
+    mfxU64 Offset;              // first byte of the access unit or IVF frame
+    mfxU64 TimeStamp;           // IVF frame time stamp, MFX_TIMESTAMP_UNKNOWN for elementary streams
+    mfxU32 FrameOrder;          // display order of the first picture output after a seek here
+    std::vector<mfxU16> Headers;// parameter sets to send first, indices in CStreamIndex headers
+};
+
+// List of random access points of a stream. It is built by a single scan of
+// the file and may be kept in a sidecar file to be reused by later runs.
+class CStreamIndex
+{
+public:
+    CStreamIndex();
+
+    // scans the stream, supported are AVC, HEVC and MPEG-2 elementary streams and AV1 in IVF
+    mfxStatus Build(const msdk_char *strFileName, mfxU32 codecId);
+
+    // loads the index, fails if it was built for another codec or a file of another size
+    mfxStatus Load(const msdk_char *strIndexFile, const msdk_char *strFileName, mfxU32 codecId);
+    mfxStatus Save(const msdk_char *strIndexFile) const;
+
+    // last random access point which outputs pictures up to the given one, NULL if there is none
+    const StreamRandomAccessPoint *Find(mfxU32 frameOrder) const;
+
+    // parameter sets of the random access point as they should be put before its data
+    std::vector<mfxU8> GetHeaders(const StreamRandomAccessPoint &point) const;
+
+    size_t GetPointCount() const { return m_points.size(); }
+
+protected:
+    mfxStatus BuildAnnexB(FILE *file);
+    mfxStatus BuildIVF(FILE *file);
+
+    mfxU32 m_codecId;
+    mfxU64 m_nFileSize;
+    std::vector<std::vector<mfxU8>>      m_headers;
+    std::vector<StreamRandomAccessPoint> m_points;
+};
+
+#endif //__STREAM_INDEX_H__
@@ -23,12 +23,15 @@ or https://software.intel.com/en-us/media-client-solutions-support.
 #include <stdlib.h>
 #include "base_allocator.h"
 #include <vector>
+#include <map>
+#include <mutex>
 
 struct sBuffer
 {
     mfxU32      id;
     mfxU32      nbytes;
     mfxU16      type;
+    mfxU32      capacity;   // mapped size of a pooled buffer, 0 if allocated from heap
 };
 
 struct sFrame
@@ -79,6 +82,17 @@ public:
     virtual mfxStatus LockBuffer(mfxMemId mid, mfxU8 **ptr);
     virtual mfxStatus UnlockBuffer(mfxMemId mid);
     virtual mfxStatus FreeBuffer(mfxMemId mid);
+    // unmaps idle buffers, buffers in use are not affected
+    virtual mfxStatus Close();
+
+protected:
+    void ReleaseIdleBuffers(size_t maxIdleBytes);
+
+    // large buffers are mapped in 2 MB pages and kept here after FreeBuffer,
+    // so frames reallocated on Reset reuse already faulted-in memory
+    std::multimap<mfxU32, sBuffer *> m_freeBuffers;
+    size_t     m_idleBytes;    // total capacity of m_freeBuffers
+    std::mutex m_mutex;
 };
 
 #endif // __SYSMEM_ALLOCATOR_H__
\ No newline at end of file
@@ -0,0 +1,331 @@
+/******************************************************************************\
+Copyright (c) 2020, Intel Corporation
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+This sample was distributed or derived from the Intel's Media Samples package.
+The original version of this sample may be obtained from https://software.intel.com/en-us/intel-media-server-studio
+or https://software.intel.com/en-us/media-client-solutions-support.
+\**********************************************************************************/
+
+#include "annexb_scanner.h"
+
+#include <algorithm>
+
+namespace
+{
+    const size_t MAX_HEADER_SIZE = 64 * 1024;
+
+    // reads fixed length and exp-Golomb fields of NAL unit payload, skips emulation prevention bytes
+    class NalBitReader
+    {
+    public:
+        NalBitReader(const std::vector<mfxU8> &nal, size_t start)
+            : m_nal(nal), m_pos(start), m_bit(0), m_zeros(0)
+        {
+        }
+
+        mfxU32 GetBits(mfxU32 n)
+        {
+            mfxU32 val = 0;
+            while (n--)
+                val = (val << 1) | GetBit();
+            return val;
+        }
+
+        mfxU32 GetUE()
+        {
+            mfxU32 zeros = 0;
+            while (!GetBit() && zeros < 32)
+                zeros++;
+            return zeros < 32 ? (1u << zeros) - 1 + GetBits(zeros) : 0xffffffff;
+        }
+
+    private:
+        mfxU32 GetBit()
+        {
+            if (m_bit == 0)
+            {
+                if (m_zeros >= 2 && m_pos < m_nal.size() && m_nal[m_pos] == 3)
+                {
+                    m_pos++;
+                    m_zeros = 0;
+                }
+                if (m_pos >= m_nal.size())
+                    return 0;
+                m_zeros = m_nal[m_pos] ? 0 : m_zeros + 1;
+            }
+            if (m_pos >= m_nal.size())
+                return 0;
+
+            mfxU32 bit = (m_nal[m_pos] >> (7 - m_bit)) & 1;
+            if (++m_bit == 8)
+            {
+                m_bit = 0;
+                m_pos++;
+            }
+            return bit;
+        }
+
+        const std::vector<mfxU8> &m_nal;
+        size_t m_pos;
+        mfxU32 m_bit;
+        mfxU32 m_zeros;
+    };
+}
+
+AnnexBUnitClass ClassifyAnnexBUnit(mfxU32 codecId, const mfxU8 hdr[ANNEXB_HEADER_BYTES], bool &bClosedGop)
+{
+    if (codecId == MFX_CODEC_AVC)
+    {
+        mfxU8 type = hdr[0] & 0x1f;
+        bool  bFirst = (hdr[1] & 0x80) != 0; // first_mb_in_slice is 0 if ue(v) starts with 1
+        switch (type)
+        {
+        case 7:  // SPS
+        case 8:  // PPS
+        case 13: // SPS extension
+        case 15: // subset SPS
+            return UNIT_HEADER;
+        case 6:  // SEI
+        case 9:  // access unit delimiter
+        case 14: // prefix NAL unit
+        case 16:
+        case 17:
+        case 18:
+            return UNIT_AU_PREFIX;
+        case 5:  // IDR
+            return bFirst ? UNIT_RAP : UNIT_SLICE;
+        case 1:
+        case 2:
+            return bFirst ? UNIT_PICTURE : UNIT_SLICE;
+        case 3:
+        case 4:
+        case 20: // MVC slice extension, not a picture of the base view
+            return UNIT_SLICE;
+        default:
+            return UNIT_OTHER;
+        }
+    }
+
+    if (codecId == MFX_CODEC_HEVC)
+    {
+        mfxU8 type = (hdr[0] >> 1) & 0x3f;
+        mfxU8 layer = ((hdr[0] & 1) << 5) | (hdr[1] >> 3);
+        bool  bFirst = (hdr[2] & 0x80) != 0; // first_slice_segment_in_pic_flag
+
+        if (type >= 32 && type <= 34) // VPS, SPS, PPS
+            return UNIT_HEADER;
+        if (type == 35 || type == 39 || (type >= 41 && type <= 44) || (type >= 48 && type <= 55))
+            return UNIT_AU_PREFIX;
+        if (type >= 32)
+            return UNIT_OTHER;
+        if (!bFirst || layer)
+            return UNIT_SLICE;
+        if (type >= 16 && type <= 21) // BLA, IDR, CRA
+            return UNIT_RAP;
+        if (type == 8 || type == 9)   // RASL
+            return UNIT_LEADING;
+        if (type == 6 || type == 7)   // RADL
+            return UNIT_LEADING_RADL;
+        return UNIT_PICTURE;
+    }
+
+    // MPEG-2 start codes
+    switch (hdr[0])
+    {
+    case 0xb3: // sequence header
+        return UNIT_HEADER;
+    case 0xb5: // extension
+        return UNIT_HEADER_EXT;
+    case 0xb8: // GOP header, closed_gop follows 25 bits of time_code
+        bClosedGop = (hdr[4] & 0x40) != 0;
+        return UNIT_AU_PREFIX;
+    case 0x00: // picture header, picture_coding_type follows 10 bits of temporal_reference
+        switch ((hdr[2] >> 3) & 7)
+        {
+        case 1:  return UNIT_RAP;
+        case 3:  return bClosedGop ? UNIT_LEADING_RADL : UNIT_LEADING;
+        default: return UNIT_PICTURE;
+        }
+    default:
+        return (hdr[0] >= 0x01 && hdr[0] <= 0xaf) ? UNIT_SLICE : UNIT_OTHER;
+    }
+}
+
+mfxU64 GetParamSetKey(mfxU32 codecId, const std::vector<mfxU8> &header)
+{
+    if (header.size() < 4 + ANNEXB_HEADER_BYTES)
+        return 0;
+
+    if (codecId == MFX_CODEC_AVC)
+    {
+        mfxU8 type = header[4] & 0x1f;
+        NalBitReader reader(header, 5);
+        if (type == 7 || type == 15)
+            reader.GetBits(24); // profile_idc, constraint flags, level_idc
+        return ((mfxU64)type << 32) | reader.GetUE();
+    }
+
+    if (codecId == MFX_CODEC_HEVC)
+    {
+        mfxU8 type = (header[4] >> 1) & 0x3f;
+        NalBitReader reader(header, 6);
+        mfxU32 id = 0;
+        if (type == 32)
+        {
+            id = reader.GetBits(4); // vps_video_parameter_set_id
+        }
+        else if (type == 33)
+        {
+            reader.GetBits(4); // sps_video_parameter_set_id
+            mfxU32 maxSubLayersMinus1 = reader.GetBits(3);
+            reader.GetBits(1);
+            // profile_tier_level()
+            reader.GetBits(96);
+            mfxU32 subLayerFlags = maxSubLayersMinus1 ? reader.GetBits(16) : 0;
+            for (mfxU32 i = 0; i < maxSubLayersMinus1; i++)
+            {
+                if (subLayerFlags & (0x8000 >> (2 * i)))     // sub_layer_profile_present_flag
+                    reader.GetBits(88);
+                if (subLayerFlags & (0x4000 >> (2 * i)))     // sub_layer_level_present_flag
+                    reader.GetBits(8);
+            }
+            id = reader.GetUE(); // sps_seq_parameter_set_id
+        }
+        else
+        {
+            id = reader.GetUE(); // pps_pic_parameter_set_id
+        }
+        return ((mfxU64)type << 32) | id;
+    }
+
+    // MPEG-2 stream has a single sequence header
+    return header[4];
+}
+
+CAnnexBScanner::CAnnexBScanner(mfxU32 codecId, const UnitHandler &onUnit, const HeaderHandler &onHeader)
+    : m_codecId(codecId)
+    , m_onUnit(onUnit)
+    , m_onHeader(onHeader)
+    , m_pos(0)
+    , m_code(0xffffffff)
+    , m_hdr()
+    , m_hdrLen(ANNEXB_HEADER_BYTES)
+    , m_unitOffset(0)
+    , m_bClosedGop(false)
+    , m_captureEnd(0)
+    , m_bCapture(false)
+{
+}
+
+mfxStatus CAnnexBScanner::Scan(const mfxU8 *data, size_t size)
+{
+    mfxStatus sts = MFX_ERR_NONE;
+
+    for (size_t i = 0; i < size; i++, m_pos++)
+    {
+        mfxU8 b = data[i];
+
+        if (m_bCapture)
+        {
+            m_capture.push_back(b);
+            if (m_capture.size() > MAX_HEADER_SIZE)
+                m_bCapture = false;
+        }
+
+        if (m_hdrLen < ANNEXB_HEADER_BYTES)
+        {
+            m_hdr[m_hdrLen++] = b;
+            if (m_hdrLen == ANNEXB_HEADER_BYTES)
+                sts = ProcessUnit(true);
+        }
+
+        m_code = (m_code << 8) | b;
+        if ((m_code & 0xffffff) == 0x000001)
+        {
+            if (m_hdrLen < ANNEXB_HEADER_BYTES)
+            {
+                // unit shorter than its header, classify what we have
+                std::fill(m_hdr + m_hdrLen, m_hdr + ANNEXB_HEADER_BYTES, 0);
+                sts = ProcessUnit(false);
+            }
+
+            m_captureEnd = m_capture.size() >= 3 ? m_capture.size() - 3 : 0;
+            m_unitOffset = m_pos - ((m_code >> 24) ? 2 : 3);
+            m_hdrLen = 0;
+        }
+
+        if (sts != MFX_ERR_NONE)
+            return sts;
+    }
+
+    return MFX_ERR_NONE;
+}
+
+mfxStatus CAnnexBScanner::Finish()
+{
+    if (m_hdrLen < ANNEXB_HEADER_BYTES)
+    {
+        std::fill(m_hdr + m_hdrLen, m_hdr + ANNEXB_HEADER_BYTES, 0);
+        m_hdrLen = ANNEXB_HEADER_BYTES;
+
+        mfxStatus sts = ProcessUnit(false);
+        if (sts != MFX_ERR_NONE)
+            return sts;
+    }
+    if (m_bCapture)
+    {
+        m_captureEnd = m_capture.size();
+        return FinishCapture();
+    }
+    return MFX_ERR_NONE;
+}
+
+mfxStatus CAnnexBScanner::ProcessUnit(bool bComplete)
+{
+    Unit unit;
+    unit.Offset = m_unitOffset;
+    unit.Class  = ClassifyAnnexBUnit(m_codecId, m_hdr, m_bClosedGop);
+    unit.Header = m_hdr;
+
+    if (m_bCapture && unit.Class != UNIT_HEADER_EXT)
+    {
+        mfxStatus sts = FinishCapture();
+        if (sts != MFX_ERR_NONE)
+            return sts;
+    }
+
+    // parameter set shorter than its unit header is broken, it isn't collected
+    if (unit.Class == UNIT_HEADER && bComplete)
+    {
+        m_bCapture = true;
+        m_capture.assign({ 0, 0, 0, 1 });
+        m_capture.insert(m_capture.end(), m_hdr, m_hdr + ANNEXB_HEADER_BYTES);
+    }
+
+    m_onUnit(unit);
+    return MFX_ERR_NONE;
+}
+
+mfxStatus CAnnexBScanner::FinishCapture()
+{
+    m_bCapture = false;
+    m_capture.resize(m_captureEnd);
+    if (m_codecId != MFX_CODEC_MPEG2)
+    {
+        while (m_capture.size() > 4 && m_capture.back() == 0)
+            m_capture.pop_back(); // trailing_zero_8bits and 4-byte start code
+    }
+
+    return m_onHeader(GetParamSetKey(m_codecId, m_capture), m_capture);
+}
@@ -667,6 +667,8 @@ CSmplBitstreamReader::CSmplBitstreamReader()
 {
     m_fSource = NULL;
     m_bInited = false;
+    m_nStartOffset = 0;
+    m_nHeadersSent = 0;
 }
 
 CSmplBitstreamReader::~CSmplBitstreamReader()
@@ -683,6 +685,9 @@ void CSmplBitstreamReader::Close()
     }
 
     m_bInited = false;
+    m_nStartOffset = 0;
+    m_startHeaders.clear();
+    m_nHeadersSent = 0;
 }
 
 void CSmplBitstreamReader::Reset()
@@ -690,7 +695,24 @@ void CSmplBitstreamReader::Reset()
     if (!m_bInited)
         return;
 
-    fseek(m_fSource, 0, SEEK_SET);
+#if defined(_WIN32) || defined(_WIN64)
+    _fseeki64(m_fSource, m_nStartOffset, SEEK_SET);
+#else
+    fseeko(m_fSource, m_nStartOffset, SEEK_SET);
+#endif
+    m_nHeadersSent = 0;
+}
+
+mfxStatus CSmplBitstreamReader::Seek(mfxU64 nOffset, const std::vector<mfxU8> &headers)
+{
+    if (!m_bInited)
+        return MFX_ERR_NOT_INITIALIZED;
+
+    m_nStartOffset = nOffset;
+    m_startHeaders = headers;
+    Reset();
+
+    return ferror(m_fSource) ? MFX_ERR_UNDEFINED_BEHAVIOR : MFX_ERR_NONE;
 }
 
 mfxStatus CSmplBitstreamReader::Init(const msdk_char *strFileName)
@@ -728,6 +750,16 @@ mfxStatus CSmplBitstreamReader::ReadNextFrame(mfxBitstream *pBS)
 
     memmove(pBS->Data, pBS->Data + pBS->DataOffset, pBS->DataLength);
     pBS->DataOffset = 0;
+
+    if (m_nHeadersSent < m_startHeaders.size())
+    {
+        mfxU32 nHeaderBytes = (mfxU32)std::min<size_t>(pBS->MaxLength - pBS->DataLength, m_startHeaders.size() - m_nHeadersSent);
+        MSDK_MEMCPY_BITSTREAM(*pBS, pBS->DataLength, m_startHeaders.data() + m_nHeadersSent, nHeaderBytes);
+        m_nHeadersSent += nHeaderBytes;
+        pBS->DataLength += nHeaderBytes;
+        return MFX_ERR_NONE;
+    }
+
     mfxU32 nBytesRead = (mfxU32)fread(pBS->Data + pBS->DataLength, 1, pBS->MaxLength - pBS->DataLength, m_fSource);
 
     CHECK_SET_EOS(pBS);
@@ -808,7 +840,8 @@ mfxStatus CIVFFrameReader::ReadHeader()
 void CIVFFrameReader::Reset()
 {
     CSmplBitstreamReader::Reset();
-    std::ignore = ReadHeader();
+    if (!m_nStartOffset)
+        std::ignore = ReadHeader();
 }
 
 mfxStatus CIVFFrameReader::Init(const msdk_char *strFileName)
@@ -1286,6 +1319,17 @@ mfxStatus CSmplYUVWriter::WriteNextFrame(mfxFrameSurface1 *pSurface)
     return MFX_ERR_NONE;
 }
 
+// Splits interleaved UV row to U and V rows reading it once, samples are shifted right by shift
+template <typename T>
+static void SplitUVRow(const T* pUV, T* pU, T* pV, mfxU32 width, mfxU32 shift)
+{
+    for (mfxU32 i = 0; i < width; i++)
+    {
+        pU[i] = (T)(pUV[2 * i] >> shift);
+        pV[i] = (T)(pUV[2 * i + 1] >> shift);
+    }
+}
+
 mfxStatus CSmplYUVWriter::WriteNextFrameI420(mfxFrameSurface1 *pSurface)
 {
     MSDK_CHECK_ERROR(m_bInited, false,   MFX_ERR_NOT_INITIALIZED);
@@ -1294,7 +1338,7 @@ mfxStatus CSmplYUVWriter::WriteNextFrameI420(mfxFrameSurface1 *pSurface)
     mfxFrameInfo &pInfo = pSurface->Info;
     mfxFrameData &pData = pSurface->Data;
 
-    mfxU32 i, j;
+    mfxU32 i;
     mfxU32 vid = pInfo.FrameId.ViewId;
 
     if (!m_bIsMultiView)
@@ -1307,120 +1351,86 @@ mfxStatus CSmplYUVWriter::WriteNextFrameI420(mfxFrameSurface1 *pSurface)
         MSDK_CHECK_POINTER(m_fDestMVC[vid], MFX_ERR_NULL_PTR);
     }
 
+    FILE* dstFile = m_bIsMultiView ? m_fDestMVC[vid] : m_fDest;
+
     mfxU32 ChromaW, ChromaH;
     if (MFX_ERR_NONE != GetChromaSize(pInfo, ChromaW, ChromaH))
         return MFX_ERR_UNSUPPORTED;
 
-    // Write Y
     switch (pInfo.FourCC)
     {
         case MFX_FOURCC_YV12:
-        case MFX_FOURCC_NV12:
         {
             for (i = 0; i < pInfo.CropH; i++)
             {
-                if (!m_bIsMultiView)
-                {
-                    MSDK_CHECK_NOT_EQUAL(
-                        fwrite(pData.Y + (pInfo.CropY * pData.Pitch + pInfo.CropX)+ i * pData.Pitch, 1, pInfo.CropW, m_fDest),
-                        pInfo.CropW, MFX_ERR_UNDEFINED_BEHAVIOR);
-                }
-                else
-                {
-                    MSDK_CHECK_NOT_EQUAL(
-                        fwrite(pData.Y + (pInfo.CropY * pData.Pitch + pInfo.CropX)+ i * pData.Pitch, 1, pInfo.CropW, m_fDestMVC[vid]),
-                        pInfo.CropW, MFX_ERR_UNDEFINED_BEHAVIOR);
-                }
+                MSDK_CHECK_NOT_EQUAL(
+                    fwrite(pData.Y + (pInfo.CropY * pData.Pitch + pInfo.CropX)+ i * pData.Pitch, 1, pInfo.CropW, dstFile),
+                    pInfo.CropW, MFX_ERR_UNDEFINED_BEHAVIOR);
             }
-            break;
-        }
-        default:
-        {
-            msdk_printf(MSDK_STRING("ERROR: I420 output is accessible only for NV12 and YV12.\n"));
-            return MFX_ERR_UNSUPPORTED;
-        }
-    }
-
-    // Write U and V
-    switch (pInfo.FourCC)
-    {
-        case MFX_FOURCC_YV12:
-        {
             for (i = 0; i < ChromaH; i++)
             {
-                if (!m_bIsMultiView)
-                {
-                    MSDK_CHECK_NOT_EQUAL(
-                        fwrite(pData.U + (pInfo.CropY * pData.Pitch / 2 + pInfo.CropX / 2)+ i * pData.Pitch / 2, 1, ChromaW, m_fDest),
-                        (mfxU32)pInfo.CropW/2, MFX_ERR_UNDEFINED_BEHAVIOR);
-                }
-                else
-                {
-                    MSDK_CHECK_NOT_EQUAL(
-                        fwrite(pData.U + (pInfo.CropY * pData.Pitch / 2 + pInfo.CropX / 2)+ i * pData.Pitch / 2, 1, ChromaW, m_fDestMVC[vid]),
-                        (mfxU32)pInfo.CropW/2, MFX_ERR_UNDEFINED_BEHAVIOR);
-                }
+                MSDK_CHECK_NOT_EQUAL(
+                    fwrite(pData.U + (pInfo.CropY * pData.Pitch / 2 + pInfo.CropX / 2)+ i * pData.Pitch / 2, 1, ChromaW, dstFile),
+                    ChromaW, MFX_ERR_UNDEFINED_BEHAVIOR);
             }
             for (i = 0; i < ChromaH; i++)
             {
-                if (!m_bIsMultiView)
-                {
-                    MSDK_CHECK_NOT_EQUAL(
-                        fwrite(pData.V + (pInfo.CropY * pData.Pitch / 2 + pInfo.CropX / 2)+ i * pData.Pitch / 2, 1, ChromaW, m_fDest),
-                        (mfxU32)pInfo.CropW/2, MFX_ERR_UNDEFINED_BEHAVIOR);
-                }
-                else
-                {
-                    MSDK_CHECK_NOT_EQUAL(
-                        fwrite(pData.V + (pInfo.CropY * pData.Pitch / 2 + pInfo.CropX / 2)+ i * pData.Pitch / 2, 1, ChromaW, m_fDestMVC[vid]),
-                        (mfxU32)pInfo.CropW/2, MFX_ERR_UNDEFINED_BEHAVIOR);
-                }
+                MSDK_CHECK_NOT_EQUAL(
+                    fwrite(pData.V + (pInfo.CropY * pData.Pitch / 2 + pInfo.CropX / 2)+ i * pData.Pitch / 2, 1, ChromaW, dstFile),
+                    ChromaW, MFX_ERR_UNDEFINED_BEHAVIOR);
             }
             break;
         }
         case MFX_FOURCC_NV12:
+        case MFX_FOURCC_P010:
         {
-            for (i = 0; i < ChromaH; i++)
+            // NV12 is written as I420, P010 as I010 with samples in lower bits.
+            // Each plane of the surface (which may be mapped video memory) is read only once,
+            // chroma is split to U and V planes in the buffer and written from there
+            const bool   is16bit  = (pInfo.FourCC == MFX_FOURCC_P010);
+            const mfxU32 bpp      = is16bit ? 2 : 1;
+            // bit depth may be left unset for P010, 10 bits are assumed then
+            const mfxU32 shiftY   = (is16bit && pInfo.Shift) ? (pInfo.BitDepthLuma   ? 16 - pInfo.BitDepthLuma   : 6) : 0;
+            const mfxU32 shiftUV  = (is16bit && pInfo.Shift) ? (pInfo.BitDepthChroma ? 16 - pInfo.BitDepthChroma : 6) : 0;
+            const mfxU32 planeW   = ChromaW / 2;
+            const mfxU32 planeSz  = planeW * ChromaH * bpp;
+
+            m_planarBuf.resize(std::max<size_t>(2 * planeSz, pInfo.CropW * bpp));
+
+            for (i = 0; i < pInfo.CropH; i++)
             {
-                for (j = 0; j < ChromaW; j += 2)
+                mfxU8* pY = pData.Y + pInfo.CropY * pData.Pitch + pInfo.CropX * bpp + i * pData.Pitch;
+                if (shiftY)
                 {
-                    if (!m_bIsMultiView)
-                    {
-                        MSDK_CHECK_NOT_EQUAL(
-                            fwrite(pData.UV + (pInfo.CropY * pData.Pitch / 2 + pInfo.CropX) + i * pData.Pitch + j, 1, 1, m_fDest),
-                            1, MFX_ERR_UNDEFINED_BEHAVIOR);
-                    }
-                    else
-                    {
-                        MSDK_CHECK_NOT_EQUAL(
-                            fwrite(pData.UV + (pInfo.CropY * pData.Pitch / 2 + pInfo.CropX) + i * pData.Pitch + j, 1, 1, m_fDestMVC[vid]),
-                            1, MFX_ERR_UNDEFINED_BEHAVIOR);
-                    }
+                    mfxU16* pRow = (mfxU16*)m_planarBuf.data();
+                    for (mfxU32 j = 0; j < pInfo.CropW; j++)
+                        pRow[j] = ((mfxU16*)pY)[j] >> shiftY;
+                    pY = m_planarBuf.data();
                 }
+                MSDK_CHECK_NOT_EQUAL(
+                    fwrite(pY, bpp, pInfo.CropW, dstFile),
+                    pInfo.CropW, MFX_ERR_UNDEFINED_BEHAVIOR);
             }
+
+            mfxU8* pU = m_planarBuf.data();
+            mfxU8* pV = m_planarBuf.data() + planeSz;
+
             for (i = 0; i < ChromaH; i++)
             {
-                for (j = 1; j < ChromaW; j += 2)
-                {
-                    if (!m_bIsMultiView)
-                    {
-                        MSDK_CHECK_NOT_EQUAL(
-                            fwrite(pData.UV + (pInfo.CropY * pData.Pitch / 2 + pInfo.CropX)+ i * pData.Pitch + j, 1, 1, m_fDest),
-                            1, MFX_ERR_UNDEFINED_BEHAVIOR);
-                    }
-                    else
-                    {
-                        MSDK_CHECK_NOT_EQUAL(
-                            fwrite(pData.UV + (pInfo.CropY * pData.Pitch / 2 + pInfo.CropX)+ i * pData.Pitch + j, 1, 1, m_fDestMVC[vid]),
-                            1, MFX_ERR_UNDEFINED_BEHAVIOR);
-                    }
-                }
+                mfxU8* pUV = pData.UV + (pInfo.CropY / 2) * pData.Pitch + pInfo.CropX * bpp + i * pData.Pitch;
+                if (is16bit)
+                    SplitUVRow((mfxU16*)pUV, (mfxU16*)pU + i * planeW, (mfxU16*)pV + i * planeW, planeW, shiftUV);
+                else
+                    SplitUVRow(pUV, pU + i * planeW, pV + i * planeW, planeW, 0);
             }
+
+            MSDK_CHECK_NOT_EQUAL(fwrite(pU, 1, planeSz, dstFile), planeSz, MFX_ERR_UNDEFINED_BEHAVIOR);
+            MSDK_CHECK_NOT_EQUAL(fwrite(pV, 1, planeSz, dstFile), planeSz, MFX_ERR_UNDEFINED_BEHAVIOR);
             break;
         }
         default:
         {
-            msdk_printf(MSDK_STRING("ERROR: I420 output is accessible only for NV12 and YV12.\n"));
+            msdk_printf(MSDK_STRING("ERROR: I420 output is accessible only for NV12, YV12 and P010 (written as I010).\n"));
             return MFX_ERR_UNSUPPORTED;
         }
     }
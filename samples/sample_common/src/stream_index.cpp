@@ -0,0 +1,396 @@
+/******************************************************************************\
+Copyright (c) 2020, Intel Corporation
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+This sample was distributed or derived from the Intel's Media Samples package.
+The original version of this sample may be obtained from https://software.intel.com/en-us/intel-media-server-studio
+or https://software.intel.com/en-us/media-client-solutions-support.
+\**********************************************************************************/
+
+#include "stream_index.h"
+#include "annexb_scanner.h"
+#include "sample_defs.h"
+
+#include <algorithm>
+#include <map>
+
+#if defined(_WIN32) || defined(_WIN64)
+#define INDEX_FSEEK(file, offset, origin) _fseeki64(file, offset, origin)
+#define INDEX_FTELL(file)                 _ftelli64(file)
+#else
+#define INDEX_FSEEK(file, offset, origin) fseeko(file, offset, origin)
+#define INDEX_FTELL(file)                 ftello(file)
+#endif
+
+namespace
+{
+    const size_t MAX_HEADER_SIZE  = 64 * 1024;
+    const size_t MAX_HEADER_COUNT = 0xffff;
+
+    const mfxU32 INDEX_MAGIC   = MFX_MAKEFOURCC('M','S','I','X');
+    const mfxU32 INDEX_VERSION = 1;
+
+    bool WriteValue(FILE *file, const void *value, size_t size)
+    {
+        return fwrite(value, 1, size, file) == size;
+    }
+
+    bool ReadValue(FILE *file, void *value, size_t size)
+    {
+        return fread(value, 1, size, file) == size;
+    }
+}
+
+CStreamIndex::CStreamIndex()
+    : m_codecId(0)
+    , m_nFileSize(0)
+{
+}
+
+mfxStatus CStreamIndex::Build(const msdk_char *strFileName, mfxU32 codecId)
+{
+    MSDK_CHECK_POINTER(strFileName, MFX_ERR_NULL_PTR);
+    if (codecId != MFX_CODEC_AVC && codecId != MFX_CODEC_HEVC && codecId != MFX_CODEC_MPEG2 && codecId != MFX_CODEC_AV1)
+        return MFX_ERR_UNSUPPORTED;
+
+    FILE *file = NULL;
+    MSDK_FOPEN(file, strFileName, MSDK_STRING("rb"));
+    MSDK_CHECK_POINTER(file, MFX_ERR_NULL_PTR);
+
+    m_codecId = codecId;
+    m_nFileSize = 0;
+    m_headers.clear();
+    m_points.clear();
+
+    mfxStatus sts = (codecId == MFX_CODEC_AV1) ? BuildIVF(file) : BuildAnnexB(file);
+
+    fclose(file);
+    return sts;
+}
+
+mfxStatus CStreamIndex::BuildAnnexB(FILE *file)
+{
+    // parameter set in effect: the latest one of its type and id
+    struct ActiveHeader
+    {
+        mfxU64 Key;
+        mfxU16 Index;
+    };
+
+    std::map<std::vector<mfxU8>, mfxU16> headerIndices; // the same parameter set is stored once
+    std::vector<ActiveHeader> active;   // in order of the last occurrence
+    std::vector<ActiveHeader> auActive; // the same at the start of the current access unit
+    std::vector<mfxU64>       auHeaders;// keys of headers of the current access unit
+
+    mfxU64 auOffset = 0;            // first unit of the current access unit
+    bool   bAfterPicture = true;    // next non-VCL unit starts a new access unit
+    bool   bInLeading = false;      // pictures after the last RAP may be its leading pictures
+    bool   bStreamStart = false;    // the last RAP starts the stream, its leading pictures are never output
+    mfxU32 nPictures = 0;
+
+    auto onHeader = [&](mfxU64 key, std::vector<mfxU8> &header) -> mfxStatus
+    {
+        auto it = headerIndices.find(header);
+        if (it == headerIndices.end())
+        {
+            if (m_headers.size() >= MAX_HEADER_COUNT)
+            {
+                msdk_printf(MSDK_STRING("error: more than %u different parameter sets, stream can't be indexed\n"), (mfxU32)MAX_HEADER_COUNT);
+                return MFX_ERR_UNSUPPORTED;
+            }
+            it = headerIndices.insert(std::make_pair(header, (mfxU16)m_headers.size())).first;
+            m_headers.push_back(header);
+        }
+
+        active.erase(std::remove_if(active.begin(), active.end(),
+            [&](const ActiveHeader &h) { return h.Key == key; }), active.end());
+        active.push_back({ key, it->second });
+        auHeaders.push_back(key);
+        return MFX_ERR_NONE;
+    };
+
+    auto onUnit = [&](const CAnnexBScanner::Unit &unit)
+    {
+        switch (unit.Class)
+        {
+        case UNIT_HEADER:
+        case UNIT_AU_PREFIX:
+            if (bAfterPicture)
+            {
+                auOffset = unit.Offset;
+                auActive = active;
+                auHeaders.clear();
+                bAfterPicture = false;
+            }
+            break;
+        case UNIT_RAP:
+        {
+            StreamRandomAccessPoint point;
+            point.Offset     = bAfterPicture ? unit.Offset : auOffset;
+            point.TimeStamp  = MFX_TIMESTAMP_UNKNOWN;
+            point.FrameOrder = nPictures;
+            // headers of the access unit itself replace earlier ones with the same key
+            for (const ActiveHeader &h : (bAfterPicture ? active : auActive))
+            {
+                if (bAfterPicture || std::find(auHeaders.begin(), auHeaders.end(), h.Key) == auHeaders.end())
+                    point.Headers.push_back(h.Index);
+            }
+            m_points.push_back(point);
+
+            bStreamStart = !nPictures;
+            nPictures++;
+            bInLeading = true;
+            bAfterPicture = true;
+            break;
+        }
+        case UNIT_LEADING:
+            // skipped by the decoder after a seek, shift the first output picture
+            if (!bInLeading)
+                nPictures++;
+            else if (!bStreamStart)
+            {
+                m_points.back().FrameOrder++;
+                nPictures++;
+            }
+            bAfterPicture = true;
+            break;
+        case UNIT_LEADING_RADL:
+            nPictures++;
+            bAfterPicture = true;
+            break;
+        case UNIT_PICTURE:
+            nPictures++;
+            bInLeading = false;
+            bAfterPicture = true;
+            break;
+        case UNIT_SLICE:
+            bAfterPicture = true;
+            break;
+        default:
+            break;
+        }
+    };
+
+    CAnnexBScanner scanner(m_codecId, onUnit, onHeader);
+    std::vector<mfxU8> buffer(1024 * 1024);
+    mfxStatus sts = MFX_ERR_NONE;
+
+    for (;;)
+    {
+        size_t n = fread(buffer.data(), 1, buffer.size(), file);
+        if (!n)
+            break;
+
+        sts = scanner.Scan(buffer.data(), n);
+        MSDK_CHECK_STATUS(sts, "CAnnexBScanner::Scan failed");
+    }
+
+    sts = scanner.Finish();
+    MSDK_CHECK_STATUS(sts, "CAnnexBScanner::Finish failed");
+
+    m_nFileSize = scanner.GetPosition();
+    return MFX_ERR_NONE;
+}
+
+mfxStatus CStreamIndex::BuildIVF(FILE *file)
+{
+    mfxU8 fileHeader[32];
+    if (!ReadValue(file, fileHeader, sizeof(fileHeader)) || MFX_MAKEFOURCC('D','K','I','F') != *(mfxU32 *)fileHeader)
+        return MFX_ERR_UNSUPPORTED;
+
+    mfxU64 pos = *(mfxU16 *)(fileHeader + 6); // header_len
+    MSDK_CHECK_NOT_EQUAL(INDEX_FSEEK(file, pos, SEEK_SET), 0, MFX_ERR_UNSUPPORTED);
+
+    // sequence header and the frame header are at the beginning of a temporal unit
+    std::vector<mfxU8> data(4096);
+    bool   bReducedStillPicture = false;
+    mfxU32 nFrames = 0;
+
+    for (;; nFrames++)
+    {
+        mfxU32 nBytesInFrame = 0;
+        mfxU64 nTimeStamp = 0;
+        if (!ReadValue(file, &nBytesInFrame, sizeof(nBytesInFrame)) || !ReadValue(file, &nTimeStamp, sizeof(nTimeStamp)))
+            break;
+
+        size_t size = fread(data.data(), 1, std::min<size_t>(data.size(), nBytesInFrame), file);
+        bool   bSequenceHeader = false;
+        bool   bKeyFrame = false;
+
+        for (size_t offset = 0; offset < size; )
+        {
+            mfxU8 obuHeader = data[offset++];
+            mfxU8 obuType = (obuHeader >> 3) & 0xf;
+            if (obuHeader & 0x04) // obu_extension_flag
+                offset++;
+
+            size_t obuSize = size - std::min(offset, size);
+            if (obuHeader & 0x02) // obu_has_size_field, leb128
+            {
+                obuSize = 0;
+                for (mfxU32 shift = 0; offset < size && shift < 56; shift += 7)
+                {
+                    mfxU8 b = data[offset++];
+                    obuSize |= (size_t)(b & 0x7f) << shift;
+                    if (!(b & 0x80))
+                        break;
+                }
+            }
+            if (offset >= size)
+                break;
+
+            if (obuType == 1) // OBU_SEQUENCE_HEADER: seq_profile(3) still_picture(1) reduced_still_picture_header(1)
+            {
+                bSequenceHeader = true;
+                bReducedStillPicture = (data[offset] & 0x08) != 0;
+            }
+            else if (obuType == 3 || obuType == 6) // OBU_FRAME_HEADER, OBU_FRAME
+            {
+                // show_existing_frame(1) frame_type(2) show_frame(1), KEY_FRAME is 0
+                bKeyFrame = bReducedStillPicture || (data[offset] & 0xf0) == 0x10;
+                break;
+            }
+            offset += obuSize;
+        }
+
+        if (bSequenceHeader && bKeyFrame)
+        {
+            StreamRandomAccessPoint point;
+            point.Offset     = pos;
+            point.TimeStamp  = nTimeStamp;
+            point.FrameOrder = nFrames; // a temporal unit has exactly one shown frame
+            m_points.push_back(point);
+        }
+
+        pos += 12 + (mfxU64)nBytesInFrame;
+        if (INDEX_FSEEK(file, pos, SEEK_SET))
+            break;
+    }
+
+    INDEX_FSEEK(file, 0, SEEK_END);
+    m_nFileSize = INDEX_FTELL(file);
+    return MFX_ERR_NONE;
+}
+
+mfxStatus CStreamIndex::Load(const msdk_char *strIndexFile, const msdk_char *strFileName, mfxU32 codecId)
+{
+    MSDK_CHECK_POINTER(strIndexFile, MFX_ERR_NULL_PTR);
+    MSDK_CHECK_POINTER(strFileName, MFX_ERR_NULL_PTR);
+
+    FILE *file = NULL;
+    MSDK_FOPEN(file, strFileName, MSDK_STRING("rb"));
+    MSDK_CHECK_POINTER(file, MFX_ERR_NULL_PTR);
+    INDEX_FSEEK(file, 0, SEEK_END);
+    mfxU64 nFileSize = INDEX_FTELL(file);
+    fclose(file);
+
+    MSDK_FOPEN(file, strIndexFile, MSDK_STRING("rb"));
+    if (!file)
+        return MFX_ERR_NOT_FOUND;
+
+    mfxU32 magic = 0, version = 0, codec = 0, nHeaders = 0, nPoints = 0;
+    mfxU64 nIndexedSize = 0;
+    bool   bOk = ReadValue(file, &magic, sizeof(magic)) && ReadValue(file, &version, sizeof(version))
+        && ReadValue(file, &codec, sizeof(codec)) && ReadValue(file, &nIndexedSize, sizeof(nIndexedSize))
+        && magic == INDEX_MAGIC && version == INDEX_VERSION && codec == codecId && nIndexedSize == nFileSize;
+
+    std::vector<std::vector<mfxU8>>      headers;
+    std::vector<StreamRandomAccessPoint> points;
+
+    bOk = bOk && ReadValue(file, &nHeaders, sizeof(nHeaders)) && nHeaders <= MAX_HEADER_COUNT;
+    for (mfxU32 i = 0; bOk && i < nHeaders; i++)
+    {
+        mfxU32 size = 0;
+        bOk = ReadValue(file, &size, sizeof(size)) && size <= MAX_HEADER_SIZE;
+        if (bOk)
+        {
+            headers.emplace_back(size);
+            bOk = ReadValue(file, headers.back().data(), size);
+        }
+    }
+
+    bOk = bOk && ReadValue(file, &nPoints, sizeof(nPoints));
+    for (mfxU32 i = 0; bOk && i < nPoints; i++)
+    {
+        StreamRandomAccessPoint point;
+        mfxU16 nPointHeaders = 0;
+        bOk = ReadValue(file, &point.Offset, sizeof(point.Offset)) && ReadValue(file, &point.TimeStamp, sizeof(point.TimeStamp))
+            && ReadValue(file, &point.FrameOrder, sizeof(point.FrameOrder)) && ReadValue(file, &nPointHeaders, sizeof(nPointHeaders))
+            && point.Offset < nFileSize;
+        if (bOk && nPointHeaders)
+        {
+            point.Headers.resize(nPointHeaders);
+            bOk = ReadValue(file, point.Headers.data(), nPointHeaders * sizeof(mfxU16))
+                && std::all_of(point.Headers.begin(), point.Headers.end(), [&](mfxU16 idx) { return idx < nHeaders; });
+        }
+        points.push_back(point);
+    }
+
+    fclose(file);
+    if (!bOk)
+        return MFX_ERR_NOT_FOUND;
+
+    m_codecId = codecId;
+    m_nFileSize = nFileSize;
+    m_headers.swap(headers);
+    m_points.swap(points);
+    return MFX_ERR_NONE;
+}
+
+mfxStatus CStreamIndex::Save(const msdk_char *strIndexFile) const
+{
+    MSDK_CHECK_POINTER(strIndexFile, MFX_ERR_NULL_PTR);
+
+    FILE *file = NULL;
+    MSDK_FOPEN(file, strIndexFile, MSDK_STRING("wb"));
+    MSDK_CHECK_POINTER(file, MFX_ERR_NULL_PTR);
+
+    mfxU32 nHeaders = (mfxU32)m_headers.size();
+    mfxU32 nPoints = (mfxU32)m_points.size();
+    bool   bOk = WriteValue(file, &INDEX_MAGIC, sizeof(INDEX_MAGIC)) && WriteValue(file, &INDEX_VERSION, sizeof(INDEX_VERSION))
+        && WriteValue(file, &m_codecId, sizeof(m_codecId)) && WriteValue(file, &m_nFileSize, sizeof(m_nFileSize))
+        && WriteValue(file, &nHeaders, sizeof(nHeaders));
+
+    for (const std::vector<mfxU8> &header : m_headers)
+    {
+        mfxU32 size = (mfxU32)header.size();
+        bOk = bOk && WriteValue(file, &size, sizeof(size)) && WriteValue(file, header.data(), size);
+    }
+
+    bOk = bOk && WriteValue(file, &nPoints, sizeof(nPoints));
+    for (const StreamRandomAccessPoint &point : m_points)
+    {
+        mfxU16 nPointHeaders = (mfxU16)point.Headers.size();
+        bOk = bOk && WriteValue(file, &point.Offset, sizeof(point.Offset)) && WriteValue(file, &point.TimeStamp, sizeof(point.TimeStamp))
+            && WriteValue(file, &point.FrameOrder, sizeof(point.FrameOrder)) && WriteValue(file, &nPointHeaders, sizeof(nPointHeaders))
+            && WriteValue(file, point.Headers.data(), nPointHeaders * sizeof(mfxU16));
+    }
+
+    fclose(file);
+    return bOk ? MFX_ERR_NONE : MFX_ERR_UNDEFINED_BEHAVIOR;
+}
+
+const StreamRandomAccessPoint *CStreamIndex::Find(mfxU32 frameOrder) const
+{
+    auto it = std::upper_bound(m_points.begin(), m_points.end(), frameOrder,
+        [](mfxU32 order, const StreamRandomAccessPoint &point) { return order < point.FrameOrder; });
+    return (it == m_points.begin()) ? NULL : &*(it - 1);
+}
+
+std::vector<mfxU8> CStreamIndex::GetHeaders(const StreamRandomAccessPoint &point) const
+{
+    std::vector<mfxU8> headers;
+    for (mfxU16 idx : point.Headers)
+        headers.insert(headers.end(), m_headers[idx].begin(), m_headers[idx].end());
+    return headers;
+}
@@ -20,7 +20,15 @@ or https://software.intel.com/en-us/media-client-solutions-support.
 #include "sysmem_allocator.h"
 #include "sample_utils.h"
 
+#include <iterator>
+
+#if !(defined(_WIN32) || defined(_WIN64))
+#include <sys/mman.h>
+#endif
+
 #define MSDK_ALIGN32(X) (((mfxU32)((X)+31)) & (~ (mfxU32)31))
+// frame data and rows start at cache line boundaries
+#define MSDK_ALIGN64(X) (((mfxU32)((X)+63)) & (~ (mfxU32)63))
 #define ID_BUFFER MFX_MAKEFOURCC('B','U','F','F')
 #define ID_FRAME  MFX_MAKEFOURCC('F','R','M','E')
 
@@ -71,6 +79,11 @@ mfxStatus SysMemFrameAllocator::Close()
         delete m_pBufferAllocator;
         m_pBufferAllocator = 0;
     }
+    else if (SysMemBufferAllocator *pSysMemAllocator = dynamic_cast<SysMemBufferAllocator *>(m_pBufferAllocator))
+    {
+        // shared allocator outlives us, but memory of our frames is not needed anymore
+        pSysMemAllocator->Close();
+    }
     return sts;
 }
 
@@ -98,9 +111,9 @@ mfxStatus SysMemFrameAllocator::LockFrame(mfxMemId mid, mfxFrameData *ptr)
         return MFX_ERR_INVALID_HANDLE;
     }
 
-    mfxU16 Width2 = (mfxU16)MSDK_ALIGN32(fs->info.Width);
+    mfxU16 Width2 = (mfxU16)MSDK_ALIGN64(fs->info.Width);
     mfxU16 Height2 = (mfxU16)MSDK_ALIGN32(fs->info.Height);
-    ptr->B = ptr->Y = (mfxU8 *)fs + MSDK_ALIGN32(sizeof(sFrame));
+    ptr->B = ptr->Y = (mfxU8 *)fs + MSDK_ALIGN64(sizeof(sFrame));
 
     switch (fs->info.FourCC)
     {
@@ -108,53 +121,53 @@ mfxStatus SysMemFrameAllocator::LockFrame(mfxMemId mid, mfxFrameData *ptr)
         ptr->U = ptr->Y + Width2 * Height2;
         ptr->V = ptr->U + 1;
         ptr->PitchHigh = 0;
-        ptr->PitchLow = (mfxU16)MSDK_ALIGN32(fs->info.Width);
+        ptr->PitchLow = (mfxU16)MSDK_ALIGN64(fs->info.Width);
         break;
     case MFX_FOURCC_NV16:
         ptr->U = ptr->Y + Width2 * Height2;
         ptr->V = ptr->U + 1;
         ptr->PitchHigh = 0;
-        ptr->PitchLow = (mfxU16)MSDK_ALIGN32(fs->info.Width);
+        ptr->PitchLow = (mfxU16)MSDK_ALIGN64(fs->info.Width);
         break;
     case MFX_FOURCC_YV12:
         ptr->V = ptr->Y + Width2 * Height2;
         ptr->U = ptr->V + (Width2 >> 1) * (Height2 >> 1);
         ptr->PitchHigh = 0;
-        ptr->PitchLow = (mfxU16)MSDK_ALIGN32(fs->info.Width);
+        ptr->PitchLow = (mfxU16)MSDK_ALIGN64(fs->info.Width);
         break;
     case MFX_FOURCC_UYVY:
         ptr->U = ptr->Y;
         ptr->Y = ptr->U + 1;
         ptr->V = ptr->U + 2;
-        ptr->PitchHigh = (mfxU16)((2 * MSDK_ALIGN32(fs->info.Width)) / (1 << 16));
-        ptr->PitchLow = (mfxU16)((2 * MSDK_ALIGN32(fs->info.Width)) % (1 << 16));
+        ptr->PitchHigh = (mfxU16)((2 * MSDK_ALIGN64(fs->info.Width)) / (1 << 16));
+        ptr->PitchLow = (mfxU16)((2 * MSDK_ALIGN64(fs->info.Width)) % (1 << 16));
         break;
     case MFX_FOURCC_YUY2:
         ptr->U = ptr->Y + 1;
         ptr->V = ptr->Y + 3;
-        ptr->PitchHigh = (mfxU16)((2 * MSDK_ALIGN32(fs->info.Width)) / (1 << 16));
-        ptr->PitchLow = (mfxU16)((2 * MSDK_ALIGN32(fs->info.Width)) % (1 << 16));
+        ptr->PitchHigh = (mfxU16)((2 * MSDK_ALIGN64(fs->info.Width)) / (1 << 16));
+        ptr->PitchLow = (mfxU16)((2 * MSDK_ALIGN64(fs->info.Width)) % (1 << 16));
         break;
 #if (MFX_VERSION >= 1028)
     case MFX_FOURCC_RGB565:
         ptr->G = ptr->B;
         ptr->R = ptr->B;
-        ptr->PitchHigh = (mfxU16)((2 * MSDK_ALIGN32(fs->info.Width)) / (1 << 16));
-        ptr->PitchLow = (mfxU16)((2 * MSDK_ALIGN32(fs->info.Width)) % (1 << 16));
+        ptr->PitchHigh = (mfxU16)((2 * MSDK_ALIGN64(fs->info.Width)) / (1 << 16));
+        ptr->PitchLow = (mfxU16)((2 * MSDK_ALIGN64(fs->info.Width)) % (1 << 16));
         break;
 #endif
     case MFX_FOURCC_RGB3:
         ptr->G = ptr->B + 1;
         ptr->R = ptr->B + 2;
-        ptr->PitchHigh = (mfxU16)((3 * MSDK_ALIGN32(fs->info.Width)) / (1 << 16));
-        ptr->PitchLow = (mfxU16)((3 * MSDK_ALIGN32(fs->info.Width)) % (1 << 16));
+        ptr->PitchHigh = (mfxU16)((3 * MSDK_ALIGN64(fs->info.Width)) / (1 << 16));
+        ptr->PitchLow = (mfxU16)((3 * MSDK_ALIGN64(fs->info.Width)) % (1 << 16));
         break;
 #if !(defined(_WIN32) || defined(_WIN64))
     case MFX_FOURCC_RGBP:
         ptr->G = ptr->R + Width2 * Height2;
         ptr->B = ptr->G + Width2 * Height2;
-        ptr->PitchHigh = (mfxU16)((MSDK_ALIGN32(fs->info.Width)) / (1 << 16));
-        ptr->PitchLow = (mfxU16)((MSDK_ALIGN32(fs->info.Width)) % (1 << 16));
+        ptr->PitchHigh = (mfxU16)((MSDK_ALIGN64(fs->info.Width)) / (1 << 16));
+        ptr->PitchLow = (mfxU16)((MSDK_ALIGN64(fs->info.Width)) % (1 << 16));
         break;
 #endif
     case MFX_FOURCC_RGB4:
@@ -162,13 +175,13 @@ mfxStatus SysMemFrameAllocator::LockFrame(mfxMemId mid, mfxFrameData *ptr)
         ptr->G = ptr->B + 1;
         ptr->R = ptr->B + 2;
         ptr->A = ptr->B + 3;
-        ptr->PitchHigh = (mfxU16)((4 * MSDK_ALIGN32(fs->info.Width)) / (1 << 16));
-        ptr->PitchLow = (mfxU16)((4 * MSDK_ALIGN32(fs->info.Width)) % (1 << 16));
+        ptr->PitchHigh = (mfxU16)((4 * MSDK_ALIGN64(fs->info.Width)) / (1 << 16));
+        ptr->PitchLow = (mfxU16)((4 * MSDK_ALIGN64(fs->info.Width)) % (1 << 16));
         break;
     case MFX_FOURCC_R16:
         ptr->Y16 = (mfxU16 *)ptr->B;
-        ptr->PitchHigh = (mfxU16)((2 * MSDK_ALIGN32(fs->info.Width)) / (1 << 16));
-        ptr->PitchLow = (mfxU16)((2 * MSDK_ALIGN32(fs->info.Width)) % (1 << 16));
+        ptr->PitchHigh = (mfxU16)((2 * MSDK_ALIGN64(fs->info.Width)) / (1 << 16));
+        ptr->PitchLow = (mfxU16)((2 * MSDK_ALIGN64(fs->info.Width)) % (1 << 16));
         break;
 #if (MFX_VERSION >= 1031)
     case MFX_FOURCC_P016:
@@ -177,21 +190,21 @@ mfxStatus SysMemFrameAllocator::LockFrame(mfxMemId mid, mfxFrameData *ptr)
         ptr->U = ptr->Y + Width2 * Height2 * 2;
         ptr->V = ptr->U + 2;
         ptr->PitchHigh = 0;
-        ptr->PitchLow = (mfxU16)MSDK_ALIGN32(fs->info.Width * 2);
+        ptr->PitchLow = (mfxU16)MSDK_ALIGN64(fs->info.Width * 2);
         break;
     case MFX_FOURCC_P210:
         ptr->U = ptr->Y + Width2 * Height2 * 2;
         ptr->V = ptr->U + 2;
         ptr->PitchHigh = 0;
-        ptr->PitchLow = (mfxU16)MSDK_ALIGN32(fs->info.Width * 2);
+        ptr->PitchLow = (mfxU16)MSDK_ALIGN64(fs->info.Width * 2);
         break;
     case MFX_FOURCC_AYUV:
         ptr->V = ptr->B;
         ptr->U = ptr->V + 1;
         ptr->Y = ptr->V + 2;
         ptr->A = ptr->V + 3;
-        ptr->PitchHigh = (mfxU16)((4 * MSDK_ALIGN32(fs->info.Width)) / (1 << 16));
-        ptr->PitchLow = (mfxU16)((4 * MSDK_ALIGN32(fs->info.Width)) % (1 << 16));
+        ptr->PitchHigh = (mfxU16)((4 * MSDK_ALIGN64(fs->info.Width)) / (1 << 16));
+        ptr->PitchLow = (mfxU16)((4 * MSDK_ALIGN64(fs->info.Width)) % (1 << 16));
         break;
 #if (MFX_VERSION >= 1031)
     case MFX_FOURCC_Y416:
@@ -199,8 +212,8 @@ mfxStatus SysMemFrameAllocator::LockFrame(mfxMemId mid, mfxFrameData *ptr)
         ptr->Y16 = ptr->U16 + 1;
         ptr->V16 = ptr->Y16 + 1;
         ptr->A   = (mfxU8 *)(ptr->V16 + 1);
-        ptr->PitchHigh = (mfxU16)(8 * MSDK_ALIGN32(fs->info.Width) / (1 << 16));
-        ptr->PitchLow = (mfxU16)(8 * MSDK_ALIGN32(fs->info.Width) % (1 << 16));
+        ptr->PitchHigh = (mfxU16)(8 * MSDK_ALIGN64(fs->info.Width) / (1 << 16));
+        ptr->PitchLow = (mfxU16)(8 * MSDK_ALIGN64(fs->info.Width) % (1 << 16));
         break;
     case MFX_FOURCC_Y216:
 #endif
@@ -210,13 +223,13 @@ mfxStatus SysMemFrameAllocator::LockFrame(mfxMemId mid, mfxFrameData *ptr)
         ptr->U16 = ptr->Y16 + 1;
         ptr->V16 = ptr->Y16 + 3;
         //4 words per macropixel -> 2 words per pixel -> 4 bytes per pixel
-        ptr->PitchHigh = (mfxU16)((4 * MSDK_ALIGN32(fs->info.Width)) / (1 << 16));
-        ptr->PitchLow = (mfxU16)((4 * MSDK_ALIGN32(fs->info.Width)) % (1 << 16));
+        ptr->PitchHigh = (mfxU16)((4 * MSDK_ALIGN64(fs->info.Width)) / (1 << 16));
+        ptr->PitchLow = (mfxU16)((4 * MSDK_ALIGN64(fs->info.Width)) % (1 << 16));
         break;
     case MFX_FOURCC_Y410:
         ptr->U = ptr->V = ptr->A = ptr->Y;
-        ptr->PitchHigh = (mfxU16)((4 * MSDK_ALIGN32(fs->info.Width)) / (1 << 16));
-        ptr->PitchLow = (mfxU16)((4 * MSDK_ALIGN32(fs->info.Width)) % (1 << 16));
+        ptr->PitchHigh = (mfxU16)((4 * MSDK_ALIGN64(fs->info.Width)) / (1 << 16));
+        ptr->PitchLow = (mfxU16)((4 * MSDK_ALIGN64(fs->info.Width)) % (1 << 16));
         break;
 #endif
 
@@ -359,7 +372,7 @@ mfxStatus SysMemFrameAllocator::ReallocImpl(mfxMemId mid, const mfxFrameInfo *in
     if (!m_pBufferAllocator)
         return MFX_ERR_NOT_INITIALIZED;
 
-    mfxU32 nbytes = GetSurfaceSize(info->FourCC, MSDK_ALIGN32(info->Width), MSDK_ALIGN32(info->Height));
+    mfxU32 nbytes = GetSurfaceSize(info->FourCC, MSDK_ALIGN64(info->Width), MSDK_ALIGN32(info->Height));
     if(!nbytes)
         return MFX_ERR_UNSUPPORTED;
 
@@ -373,7 +386,7 @@ mfxStatus SysMemFrameAllocator::ReallocImpl(mfxMemId mid, const mfxFrameInfo *in
         return sts;
 
     sts = m_pBufferAllocator->Alloc(m_pBufferAllocator->pthis,
-        MSDK_ALIGN32(nbytes) + MSDK_ALIGN32(sizeof(sFrame)), MFX_MEMTYPE_SYSTEM_MEMORY, pmid);
+        MSDK_ALIGN32(nbytes) + MSDK_ALIGN64(sizeof(sFrame)), MFX_MEMTYPE_SYSTEM_MEMORY, pmid);
     if (MFX_ERR_NONE != sts)
         return sts;
 
@@ -397,7 +410,7 @@ mfxStatus SysMemFrameAllocator::AllocImpl(mfxFrameAllocRequest *request, mfxFram
 
     mfxU32 numAllocated = 0;
 
-    mfxU32 nbytes = GetSurfaceSize(request->Info.FourCC, MSDK_ALIGN32(request->Info.Width), MSDK_ALIGN32(request->Info.Height));
+    mfxU32 nbytes = GetSurfaceSize(request->Info.FourCC, MSDK_ALIGN64(request->Info.Width), MSDK_ALIGN32(request->Info.Height));
     if(!nbytes)
         return MFX_ERR_UNSUPPORTED;
 
@@ -407,7 +420,7 @@ mfxStatus SysMemFrameAllocator::AllocImpl(mfxFrameAllocRequest *request, mfxFram
     for (numAllocated = 0; numAllocated < request->NumFrameSuggested; numAllocated ++)
     {
         mfxStatus sts = m_pBufferAllocator->Alloc(m_pBufferAllocator->pthis,
-            nbytes + MSDK_ALIGN32(sizeof(sFrame)), request->Type, &(mids[numAllocated]));
+            nbytes + MSDK_ALIGN64(sizeof(sFrame)), request->Type, &(mids[numAllocated]));
 
         if (MFX_ERR_NONE != sts)
             break;
@@ -469,14 +482,81 @@ mfxStatus SysMemFrameAllocator::ReleaseResponse(mfxFrameAllocResponse *response)
     return sts;
 }
 
+// Buffers of at least SYSMEM_POOL_MIN_BUFFER bytes (surfaces, in practice) are
+// mapped in whole 2 MB pages and recycled: Linux backs them with hugetlbfs pages
+// if any are reserved and with transparent huge pages otherwise, which keeps
+// TLB misses and page faults off the copy paths and out of every Reset.
+#define SYSMEM_POOL_PAGE_SIZE  (2 * 1024 * 1024)
+#define SYSMEM_POOL_MIN_BUFFER (256 * 1024)
+// idle buffers above this total are unmapped, largest first
+#define SYSMEM_POOL_MAX_IDLE   ((size_t)256 * 1024 * 1024)
+// a recycled buffer may be this much larger than requested
+#define SYSMEM_POOL_MAX_SLACK(capacity) ((capacity) / 4)
+
+static mfxU8 *MapPoolBuffer(size_t size)
+{
+#if !(defined(_WIN32) || defined(_WIN64))
+    void *ptr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (MAP_FAILED != ptr)
+        return (mfxU8 *)ptr;
+
+    // no hugetlbfs pages: over-map to get 2 MB alignment and ask for THP
+    size_t mapped = size + SYSMEM_POOL_PAGE_SIZE;
+    mfxU8 *raw = (mfxU8 *)mmap(NULL, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (MAP_FAILED == (void *)raw)
+        return NULL;
+
+    mfxU8 *aligned = (mfxU8 *)(((size_t)raw + SYSMEM_POOL_PAGE_SIZE - 1) & ~((size_t)SYSMEM_POOL_PAGE_SIZE - 1));
+    if (aligned != raw)
+        munmap(raw, aligned - raw);
+    if (raw + mapped != aligned + size)
+        munmap(aligned + size, raw + mapped - (aligned + size));
+#ifdef MADV_HUGEPAGE
+    madvise(aligned, size, MADV_HUGEPAGE);
+#endif
+    return aligned;
+#else
+    return (mfxU8 *)calloc(size, 1);
+#endif
+}
+
+static void UnmapPoolBuffer(sBuffer *bs)
+{
+#if !(defined(_WIN32) || defined(_WIN64))
+    munmap(bs, bs->capacity);
+#else
+    free(bs);
+#endif
+}
+
 SysMemBufferAllocator::SysMemBufferAllocator()
+    : m_idleBytes(0)
 {
 
 }
 
 SysMemBufferAllocator::~SysMemBufferAllocator()
 {
+    Close();
+}
+
+mfxStatus SysMemBufferAllocator::Close()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ReleaseIdleBuffers(0);
+    return MFX_ERR_NONE;
+}
 
+// must be called under m_mutex
+void SysMemBufferAllocator::ReleaseIdleBuffers(size_t maxIdleBytes)
+{
+    while (m_idleBytes > maxIdleBytes)
+    {
+        auto largest = std::prev(m_freeBuffers.end());
+        m_idleBytes -= largest->first;
+        UnmapPoolBuffer(largest->second);
+        m_freeBuffers.erase(largest);
+    }
 }
 
 mfxStatus SysMemBufferAllocator::AllocBuffer(mfxU32 nbytes, mfxU16 type, mfxMemId *mid)
@@ -488,12 +568,49 @@ mfxStatus SysMemBufferAllocator::AllocBuffer(mfxU32 nbytes, mfxU16 type, mfxMemI
         return MFX_ERR_UNSUPPORTED;
 
     mfxU32 header_size = MSDK_ALIGN32(sizeof(sBuffer));
-    mfxU8 *buffer_ptr = (mfxU8 *)calloc(header_size + nbytes + 32, 1);
+    mfxU32 alloc_size = header_size + nbytes + 64;
+    sBuffer *bs = NULL;
 
-    if (!buffer_ptr)
-        return MFX_ERR_MEMORY_ALLOC;
+    if (alloc_size >= SYSMEM_POOL_MIN_BUFFER)
+    {
+        mfxU32 capacity = (alloc_size + SYSMEM_POOL_PAGE_SIZE - 1) & ~(mfxU32)(SYSMEM_POOL_PAGE_SIZE - 1);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        // smallest idle buffer which is big enough, it has to be cleared, callers expect zeroed memory
+        auto it = m_freeBuffers.lower_bound(capacity);
+        if (it != m_freeBuffers.end() && it->first - capacity <= SYSMEM_POOL_MAX_SLACK(capacity))
+        {
+            bs = it->second;
+            capacity = it->first;
+            m_idleBytes -= capacity;
+            m_freeBuffers.erase(it);
+            memset(bs, 0, alloc_size);
+        }
+        else
+        {
+            bs = (sBuffer *)MapPoolBuffer(capacity);
+            if (!bs && !m_freeBuffers.empty())
+            {
+                // out of address space or memory: drop idle buffers and retry
+                ReleaseIdleBuffers(0);
+                bs = (sBuffer *)MapPoolBuffer(capacity);
+            }
+        }
+
+        if (!bs)
+            return MFX_ERR_MEMORY_ALLOC;
+
+        bs->capacity = capacity;
+    }
+    else
+    {
+        bs = (sBuffer *)calloc(alloc_size, 1);
+
+        if (!bs)
+            return MFX_ERR_MEMORY_ALLOC;
+    }
 
-    sBuffer *bs = (sBuffer *)buffer_ptr;
     bs->id = ID_BUFFER;
     bs->type = type;
     bs->nbytes = nbytes;
@@ -513,7 +630,7 @@ mfxStatus SysMemBufferAllocator::LockBuffer(mfxMemId mid, mfxU8 **ptr)
     if (ID_BUFFER != bs->id)
         return MFX_ERR_INVALID_HANDLE;
 
-    *ptr = (mfxU8*)((size_t)((mfxU8 *)bs+MSDK_ALIGN32(sizeof(sBuffer))+31)&(~((size_t)31)));
+    *ptr = (mfxU8*)((size_t)((mfxU8 *)bs+MSDK_ALIGN32(sizeof(sBuffer))+63)&(~((size_t)63)));
     return MFX_ERR_NONE;
 }
 
@@ -533,6 +650,16 @@ mfxStatus SysMemBufferAllocator::FreeBuffer(mfxMemId mid)
     if (!bs || ID_BUFFER != bs->id)
         return MFX_ERR_INVALID_HANDLE;
 
+    if (bs->capacity)
+    {
+        bs->id = 0;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_freeBuffers.insert(std::make_pair(bs->capacity, bs));
+        m_idleBytes += bs->capacity;
+        ReleaseIdleBuffers(SYSMEM_POOL_MAX_IDLE);
+        return MFX_ERR_NONE;
+    }
+
     free(bs);
     return MFX_ERR_NONE;
 }
@@ -35,6 +35,7 @@ or https://software.intel.com/en-us/media-client-solutions-support.
 #include <memory>
 
 #include "sample_utils.h"
+#include "stream_index.h"
 #include "base_allocator.h"
 
 #include "mfxmvc.h"
@@ -112,6 +113,7 @@ struct sInputParams
     mfxU32  fourcc;
     mfxU16  chromaType;
     mfxU32  nFrames;
+    mfxU32  nSeekFrame; // first frame to output, decoding starts at the nearest random access point
     mfxU16  eDeinterlace;
     mfxU16  ScalingMode;
     bool    outI420;
@@ -143,6 +145,7 @@ struct sInputParams
 
     msdk_char     strSrcFile[MSDK_MAX_FILENAME_LEN];
     msdk_char     strDstFile[MSDK_MAX_FILENAME_LEN];
+    msdk_char     strIndexFile[MSDK_MAX_FILENAME_LEN];
     sPluginParams pluginParams;
 
     bool bDisableFilmGrain;
@@ -223,6 +226,7 @@ protected: // functions
     mfxStatus GetImpl(const sInputParams & params, mfxIMPL & impl);
     virtual mfxStatus CreateRenderingWindow(sInputParams *pParams);
     virtual mfxStatus InitMfxParams(sInputParams *pParams);
+    virtual mfxStatus SeekInputStream(sInputParams *pParams);
 
     virtual mfxStatus AllocateExtMVCBuffers();
 
@@ -300,6 +304,7 @@ protected: // variables
     mfxU32                  m_nTimeout; // enables timeout for video playback, measured in seconds
     mfxU16                  m_nMaxFps; // limit of fps, if isn't specified equal 0.
     mfxU32                  m_nFrames; //limit number of output frames
+    mfxU32                  m_nFramesToSkip; // decoded frames before the seek target, not delivered
 
     mfxU16                  m_diMode;
     bool                    m_bVppIsUsed;
@@ -63,6 +63,7 @@ CDecodingPipeline::CDecodingPipeline()
     : m_mfxBS(8 * 1024 * 1024)
 {
     m_nFrames=0;
+    m_nFramesToSkip=0;
     m_export_mode=0;
     m_bVppFullColorRange=false;
     m_bVppIsUsed = false;
@@ -276,6 +277,50 @@ mfxStatus CDecodingPipeline::GetImpl(const sInputParams & params, mfxIMPL & impl
     return MFX_ERR_NONE;
 }
 
+mfxStatus CDecodingPipeline::SeekInputStream(sInputParams *pParams)
+{
+    MSDK_CHECK_POINTER(pParams, MFX_ERR_NULL_PTR);
+
+    CStreamIndex index;
+    CTimer timer;
+    timer.Start();
+
+    bool bIndexFile = msdk_strlen(pParams->strIndexFile) != 0;
+    mfxStatus sts = bIndexFile ? index.Load(pParams->strIndexFile, pParams->strSrcFile, pParams->videoType) : MFX_ERR_NOT_FOUND;
+    if (MFX_ERR_NOT_FOUND == sts)
+    {
+        // no index yet or it is stale
+        sts = index.Build(pParams->strSrcFile, pParams->videoType);
+        MSDK_CHECK_STATUS(sts, "CStreamIndex::Build failed");
+
+        if (bIndexFile)
+        {
+            sts = index.Save(pParams->strIndexFile);
+            MSDK_CHECK_STATUS(sts, "CStreamIndex::Save failed");
+        }
+    }
+    MSDK_CHECK_STATUS(sts, "CStreamIndex::Load failed");
+
+    const StreamRandomAccessPoint *point = index.Find(pParams->nSeekFrame);
+    if (!point)
+    {
+        // the first frames precede any random access point, decode from the beginning
+        m_nFramesToSkip = pParams->nSeekFrame;
+        return MFX_ERR_NONE;
+    }
+
+    sts = m_FileReader->Seek(point->Offset, index.GetHeaders(*point));
+    MSDK_CHECK_STATUS(sts, "m_FileReader->Seek failed");
+
+    m_nFramesToSkip = pParams->nSeekFrame - point->FrameOrder;
+
+    msdk_printf(MSDK_STRING("Seek to frame %u: random access point at byte %llu, frame %u (%u points, %.3f ms)\n"),
+        pParams->nSeekFrame, (unsigned long long)point->Offset, point->FrameOrder,
+        (mfxU32)index.GetPointCount(), timer.GetTime() * 1000);
+
+    return MFX_ERR_NONE;
+}
+
 mfxStatus CDecodingPipeline::Init(sInputParams *pParams)
 {
     MSDK_CHECK_POINTER(pParams, MFX_ERR_NULL_PTR);
@@ -381,6 +426,12 @@ mfxStatus CDecodingPipeline::Init(sInputParams *pParams)
     sts = m_FileReader->Init(pParams->strSrcFile);
     MSDK_CHECK_STATUS(sts, "m_FileReader->Init failed");
 
+    if (pParams->nSeekFrame || msdk_strlen(pParams->strIndexFile))
+    {
+        sts = SeekInputStream(pParams);
+        MSDK_CHECK_STATUS(sts, "SeekInputStream failed");
+    }
+
     mfxInitParamlWrap initPar;
 
     // we set version to 1.0 and later we will query actual version of the library which will got leaded
@@ -1716,6 +1767,13 @@ mfxStatus CDecodingPipeline::SyncOutputSurface(mfxU32 wait)
     if (MFX_WRN_IN_EXECUTION == sts) {
         return sts;
     }
+    if (MFX_ERR_NONE == sts && m_nFramesToSkip) {
+        // frame between the random access point and the seek target
+        --m_nFramesToSkip;
+        ReturnSurfaceToBuffers(m_pCurrentOutputSurface);
+        m_pCurrentOutputSurface = NULL;
+        return sts;
+    }
     if (MFX_ERR_NONE == sts) {
         // we got completely decoded frame - pushing it to the delivering thread...
         ++m_synced_count;
@@ -2096,17 +2154,22 @@ mfxStatus CDecodingPipeline::RunDecoding()
     return sts; // ERR_NONE or ERR_INCOMPATIBLE_VIDEO_PARAM
 }
 
+static const msdk_char* PlanarOutputStr(mfxU32 fourcc)
+{
+    return (fourcc == MFX_FOURCC_P010) ? MSDK_STRING("I010(YUV)") : MSDK_STRING("I420(YUV)");
+}
+
 void CDecodingPipeline::PrintInfo()
 {
     msdk_printf(MSDK_STRING("Decoding Sample Version %s\n\n"), GetMSDKSampleVersion().c_str());
     msdk_printf(MSDK_STRING("\nInput video\t%s\n"), CodecIdToStr(m_mfxVideoParams.mfx.CodecId).c_str());
     if (m_bVppIsUsed)
     {
-        msdk_printf(MSDK_STRING("Output format\t%s (using vpp)\n"), m_bOutI420 ? MSDK_STRING("I420(YUV)") : CodecIdToStr(m_mfxVppVideoParams.vpp.Out.FourCC).c_str());
+        msdk_printf(MSDK_STRING("Output format\t%s (using vpp)\n"), m_bOutI420 ? PlanarOutputStr(m_mfxVppVideoParams.vpp.Out.FourCC) : CodecIdToStr(m_mfxVppVideoParams.vpp.Out.FourCC).c_str());
     }
     else
     {
-        msdk_printf(MSDK_STRING("Output format\t%s\n"), m_bOutI420 ? MSDK_STRING("I420(YUV)") : CodecIdToStr(m_mfxVideoParams.mfx.FrameInfo.FourCC).c_str());
+        msdk_printf(MSDK_STRING("Output format\t%s\n"), m_bOutI420 ? PlanarOutputStr(m_mfxVideoParams.mfx.FrameInfo.FourCC) : CodecIdToStr(m_mfxVideoParams.mfx.FrameInfo.FourCC).c_str());
     }
 
     mfxFrameInfo Info = m_mfxVideoParams.mfx.FrameInfo;
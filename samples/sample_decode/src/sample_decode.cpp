@@ -90,6 +90,7 @@ void PrintHelp(msdk_char *strAppName, const msdk_char *strErrorMessage)
     msdk_printf(MSDK_STRING("   [-rgb4_fcr] - pipeline output format: RGB4 in full color range, output file format: RGB4 in full color range\n"));
     msdk_printf(MSDK_STRING("   [-ayuv] - pipeline output format: AYUV, output file format: AYUV\n"));
     msdk_printf(MSDK_STRING("   [-p010] - pipeline output format: P010, output file format: P010\n"));
+    msdk_printf(MSDK_STRING("   [-i010] - pipeline output format: P010, output file format: I010\n"));
     msdk_printf(MSDK_STRING("   [-a2rgb10] - pipeline output format: A2RGB10, output file format: A2RGB10\n"));
 #if (MFX_VERSION >= 1031)
     msdk_printf(MSDK_STRING("   [-p016] - pipeline output format: P010, output file format: P016\n"));
@@ -131,6 +132,10 @@ void PrintHelp(msdk_char *strAppName, const msdk_char *strErrorMessage)
     msdk_printf(MSDK_STRING("   [-gpucopy::<on,off>] Enable or disable GPU copy mode\n"));
     msdk_printf(MSDK_STRING("   [-robust:soft]            - GPU hang recovery by inserting an IDR frame\n"));
     msdk_printf(MSDK_STRING("   [-timeout]                - timeout in seconds\n"));
+    msdk_printf(MSDK_STRING("   [-seek frame]             - start output from the given frame, decoding starts at the nearest preceding random access point\n"));
+    msdk_printf(MSDK_STRING("                               (supported only for H.264, HEVC, MPEG-2 and AV1 codecs)\n"));
+    msdk_printf(MSDK_STRING("   [-index file]             - random access point index of the input stream for -seek,\n"));
+    msdk_printf(MSDK_STRING("                               it is built and saved to the file if the file is missing or stale\n"));
 #if MFX_VERSION >= 1022
     msdk_printf(MSDK_STRING("   [-dec_postproc force/auto] - resize after decoder using direct pipe\n"));
     msdk_printf(MSDK_STRING("                  force: instruct to use decoder-based post processing\n"));
@@ -598,6 +603,28 @@ mfxStatus ParseInputString(msdk_char* strInput[], mfxU8 nArgNum, sInputParams* p
                 return MFX_ERR_UNSUPPORTED;
             }
         }
+        else if (0 == msdk_strcmp(strInput[i], MSDK_STRING("-seek")))
+        {
+            if(i + 1 >= nArgNum)
+            {
+                PrintHelp(strInput[0], MSDK_STRING("Not enough parameters for -seek key"));
+                return MFX_ERR_UNSUPPORTED;
+            }
+            if (MFX_ERR_NONE != msdk_opt_read(strInput[++i], pParams->nSeekFrame))
+            {
+                PrintHelp(strInput[0], MSDK_STRING("seek frame is invalid"));
+                return MFX_ERR_UNSUPPORTED;
+            }
+        }
+        else if (0 == msdk_strcmp(strInput[i], MSDK_STRING("-index")))
+        {
+            if(i + 1 >= nArgNum)
+            {
+                PrintHelp(strInput[0], MSDK_STRING("Not enough parameters for -index key"));
+                return MFX_ERR_UNSUPPORTED;
+            }
+            msdk_opt_read(strInput[++i], pParams->strIndexFile);
+        }
         else if (0 == msdk_strcmp(strInput[i], MSDK_STRING("-n")))
         {
             if(i + 1 >= nArgNum)
@@ -652,6 +679,11 @@ mfxStatus ParseInputString(msdk_char* strInput[], mfxU8 nArgNum, sInputParams* p
         {
             pParams->fourcc = MFX_FOURCC_P010;
         }
+        else if (0 == msdk_strcmp(strInput[i], MSDK_STRING("-i010")))
+        {
+            pParams->fourcc = MFX_FOURCC_P010;
+            pParams->outI420 = true;
+        }
         else if (0 == msdk_strcmp(strInput[i], MSDK_STRING("-a2rgb10")))
         {
             pParams->fourcc = MFX_FOURCC_A2RGB10;
@@ -764,6 +796,16 @@ mfxStatus ParseInputString(msdk_char* strInput[], mfxU8 nArgNum, sInputParams* p
         pParams->nAsyncDepth = 4; //set by default;
     }
 
+    if ((pParams->nSeekFrame || msdk_strlen(pParams->strIndexFile)) &&
+        MFX_CODEC_AVC   != pParams->videoType &&
+        MFX_CODEC_HEVC  != pParams->videoType &&
+        MFX_CODEC_MPEG2 != pParams->videoType &&
+        MFX_CODEC_AV1   != pParams->videoType)
+    {
+        PrintHelp(strInput[0], MSDK_STRING("-seek and -index are supported only for H.264, HEVC, MPEG-2 and AV1 codecs"));
+        return MFX_ERR_UNSUPPORTED;
+    }
+
 #if (defined(_WIN64) || defined(_WIN32)) && (MFX_VERSION >= 1031)
     if (pParams->bPrefferdGfx && pParams->bPrefferiGfx)
     {
@@ -62,7 +62,6 @@ public:
 #endif
 
     /* Temporary memory to speed up computations */
-    std::vector<mfxI16> m_tmpForMedian;
     std::vector<mfxExtFeiPreEncMV::mfxExtFeiPreEncMVMB> m_tmpForReading;
 
     mfxExtFeiEncMV::mfxExtFeiEncMVMB m_tmpMBencMV;
@@ -65,7 +65,6 @@ public:
     FILE* m_pMBcode_out;
 
     /* Temporary memory to speed up computations */
-    std::vector<mfxI16> m_tmpForMedian;
     std::vector<mfxExtFeiPreEncMV::mfxExtFeiPreEncMVMB> m_tmpForReading;
 
     mfxExtFeiEncMV::mfxExtFeiEncMVMB m_tmpMBencMV;
@@ -54,15 +54,15 @@ public:
 
     mfxExtFeiPreEncMV::mfxExtFeiPreEncMVMB m_tmpMVMB;
 
+    /* Threads of predictors repacking, shared by all frames */
+    MBRowWorkers m_repackWorkers;
+
     /* For I/O operations with extension buffers */
     FILE* m_pMvPred_in;
     FILE* m_pMbQP_in;
     FILE* m_pMBstat_out;
     FILE* m_pMV_out;
 
-    /* Temporary memory to speed up computations */
-    std::vector<mfxI16> m_tmpForMedian;
-
     FEI_PreencInterface(MFXVideoSession* session, iTaskPool* task_pool, mfxU32 allocId, bufList* ext_bufs, bufList* enc_ext_bufs, AppConfig* config);
     ~FEI_PreencInterface();
 
@@ -26,130 +26,117 @@ or https://software.intel.com/en-us/media-client-solutions-support.
 #error MFX_VERSION not defined
 #endif
 
-struct MVP_elem
-{
-    MVP_elem(mfxExtFeiPreEncMV::mfxExtFeiPreEncMVMB * MVMB = NULL, mfxU8 idx = 0xff, mfxU16 dist = 0xffff)
-        : preenc_MVMB(MVMB)
-        , refIdx(idx)
-        , distortion(dist)
-    {}
-
-    mfxExtFeiPreEncMV::mfxExtFeiPreEncMVMB * preenc_MVMB;
-    mfxU8  refIdx;
-    mfxU16 distortion;
-};
+#include <condition_variable>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <thread>
 
-struct BestMVset
-{
-    BestMVset(iTask* eTask)
-    {
-        if (eTask)
-        {
-            bestL0.reserve((std::min)((std::max)(GetNumL0MVPs(*eTask, 0), GetNumL0MVPs(*eTask, 1)), MaxFeiEncMVPNum));
-            bestL1.reserve((std::min)((std::max)(GetNumL1MVPs(*eTask, 0), GetNumL1MVPs(*eTask, 1)), MaxFeiEncMVPNum));
-        }
-        else
-        {
-            bestL0.reserve(MaxFeiEncMVPNum);
-            bestL1.reserve(MaxFeiEncMVPNum);
-        }
-    }
-
-    void Clear()
-    {
-        bestL0.clear();
-        bestL1.clear();
-    }
-
-    std::vector<MVP_elem> bestL0;
-    std::vector<MVP_elem> bestL1;
-};
+/*  Number of MBs processed at once by batched repacking functions.
+    Per-MB values are kept in arrays of this size, one array per value,
+    so every step of processing is done for all MBs of batch at once */
+const mfxU32 MVPBatchSize = 16;
 
 /*  PreEnc outputs 16 MVs per-MB, one of the way to construct predictor from this array
-    is to extract median for x and y component
+    is to extract median for x and y component.
+    Sorting network is used instead of sorting, only compare-exchanges which affect
+    8th and 9th elements are kept. Result is equal to average of them after sorting.
 
-    preencMB - MB of motion vectors buffer
-    tmpBuf   - temporary array, for inplace sorting
-    xy       - indicates coordinate being processed [0-1] (0 - x coordinate, 1 - y coordinate)
+    preencMB - MBs of motion vectors buffer, NULL entries are skipped
+    nMB      - number of MBs in batch [1-MVPBatchSize]
     L0L1     - indicates reference list being processed [0-1] (0 - L0-list, 1 - L1-list)
-
-    returned value - median of 16 element array
+    median   - returned medians of x and y components for each MB
 */
-inline mfxI16 get16Median(mfxExtFeiPreEncMV::mfxExtFeiPreEncMVMB* preencMB, mfxI16* tmpBuf, int xy, int L0L1)
-{
-    switch (xy){
-    case 0:
-        for (int k = 0; k < 16; k++){
-            tmpBuf[k] = preencMB->MV[k][L0L1].x;
-        }
-        break;
-    case 1:
-        for (int k = 0; k < 16; k++){
-            tmpBuf[k] = preencMB->MV[k][L0L1].y;
-        }
-        break;
-    default:
-        return 0;
-    }
-
-    std::sort(tmpBuf, tmpBuf + 16);
-    return (tmpBuf[7] + tmpBuf[8]) / 2;
-}
+void get16Median(mfxExtFeiPreEncMV::mfxExtFeiPreEncMVMB* const preencMB[MVPBatchSize], mfxU32 nMB, mfxU32 L0L1, mfxI16Pair median[MVPBatchSize]);
 
 /*  Repacking of PreENC MVs with 4x downscale requires calculating 4-element median
 
-    Input/output parameters are similair with get16Median
-
-    offset - indicates position of 4 MVs which maps to current MB on full-resolution frame
+    preencMB - MB of motion vectors buffer
+    xy       - indicates coordinate being processed [0-1] (0 - x coordinate, 1 - y coordinate)
+    L0L1     - indicates reference list being processed [0-1] (0 - L0-list, 1 - L1-list)
+    offset   - indicates position of 4 MVs which maps to current MB on full-resolution frame
     (other 12 components are correspondes to another MBs on full-resolution frame)
 */
-
-inline mfxI16 get4Median(mfxExtFeiPreEncMV::mfxExtFeiPreEncMVMB* preencMB, mfxI16* tmpBuf, int xy, int L0L1, int offset)
+inline mfxI16 get4Median(mfxExtFeiPreEncMV::mfxExtFeiPreEncMVMB* preencMB, int xy, int L0L1, int offset)
 {
-    switch (xy){
-    case 0:
-        for (int k = 0; k < 4; k++){
-            tmpBuf[k] = preencMB->MV[k + offset][L0L1].x;
-        }
-        break;
-    case 1:
-        for (int k = 0; k < 4; k++){
-            tmpBuf[k] = preencMB->MV[k + offset][L0L1].y;
-        }
-        break;
-    default:
-        return 0;
-    }
-
-    std::sort(tmpBuf, tmpBuf + 4);
-    return (tmpBuf[1] + tmpBuf[2]) / 2;
-}
+    int v[4];
 
+    for (int k = 0; k < 4; k++)
+        v[k] = xy ? preencMB->MV[k + offset][L0L1].y : preencMB->MV[k + offset][L0L1].x;
+
+    // sum of two central elements is sum of all except min and max
+    int sum = v[0] + v[1] + v[2] + v[3]
+        - (std::min)((std::min)(v[0], v[1]), (std::min)(v[2], v[3]))
+        - (std::max)((std::max)(v[0], v[1]), (std::max)(v[2], v[3]));
+
+    return (mfxI16)(sum / 2);
+}
 
 /* repackPreenc2Enc passes only one predictor (median of provided preenc MVs) because we dont have distortions to choose 4 best possible */
 
-mfxStatus repackPreenc2Enc(mfxExtFeiPreEncMV::mfxExtFeiPreEncMVMB *preencMVoutMB, mfxExtFeiEncMVPredictors::mfxExtFeiEncMVPredictorsMB *EncMVPredMB, mfxU32 NumMB, mfxI16 *tmpBuf);
+mfxStatus repackPreenc2Enc(mfxExtFeiPreEncMV::mfxExtFeiPreEncMVMB *preencMVoutMB, mfxExtFeiEncMVPredictors::mfxExtFeiEncMVPredictorsMB *EncMVPredMB, mfxU32 NumMB);
 
-static inline bool compareDistortion(MVP_elem frst, MVP_elem scnd)
+/* Output buffers of PreENC multicall stage for one field, one entry per PreENC call */
+struct PreEncCandidates
 {
-    return frst.distortion < scnd.distortion;
-}
+    std::vector<mfxExtFeiPreEncMV*>     mvs;
+    std::vector<mfxExtFeiPreEncMBStat*> mbstat;
+    std::vector<const mfxU8*>           refIdx; // [L0L1]
+};
+
+mfxStatus GetPreEncCandidates(std::list<PreEncOutput>& preenc_output, mfxU32 fieldId, PreEncCandidates& cands);
 
 /*  PreENC may be called multiple times for reference frames and multiple MV, MBstat buffers are generated.
     Here PreENC results are sorted indipendently for L0 and L1 references in terms of distortion.
-    This function is called per-MB.
-
-    preenc_output - list of output PreENC buffers from multicall stage
-    RepackingInfo - structure that holds information about resulting predictors
-                    (it is shrinked to fit nPred size before return)
-    nPred         - array of numbers predictors expected by next interface (ENC/ENCODE)
-                    (nPred[0] - number of L0 predictors, nPred[1] - number of L1 predictors)
-    fieldId       - id of field being processed (0 - first field, 1 - second field)
-    MB_idx        - offset of MB being processed
+    Selection is done for batch of MBs: keys (distortion << 8 | index of PreENC call) are inserted into
+    nPred-element sorted arrays, so calls with equal distortion keep their order as with insertion sort.
+
+    cands   - output buffers of PreENC calls
+    nPred   - array of numbers predictors expected by next interface (ENC/ENCODE)
+              (nPred[0] - number of L0 predictors, nPred[1] - number of L1 predictors)
+    firstMB - offset of first MB of batch
+    nMB     - number of MBs in batch [1-MVPBatchSize]
+    best    - returned indices of PreENC calls [L0L1][predictor][MB], 0xff if there are less calls than predictors
 */
+void GetBestSetsByDistortion(const PreEncCandidates& cands, const mfxU32 nPred[2], mfxU32 firstMB, mfxU32 nMB,
+    mfxU8 best[2][MaxFeiEncMVPNum][MVPBatchSize]);
 
-mfxStatus GetBestSetsByDistortion(std::list<PreEncOutput>& preenc_output,
-    BestMVset & BestSet,
-    mfxU32 nPred[2], mfxU32 fieldId, mfxU32 MB_idx);
+/*  Threads processing ranges of whole MB rows. Threads are created on first need
+    and are reused for all following pictures, so repacking of a frame doesn't pay
+    for thread creation. */
+class MBRowWorkers
+{
+public:
+    typedef std::function<void(mfxU32 firstMB, mfxU32 lastMB)> RangeFunc;
+
+    MBRowWorkers();
+    ~MBRowWorkers();
+
+    /*  Splits MBs of picture to ranges of whole MB rows and calls func(firstMB, lastMB) for each range,
+        the first range is processed by calling thread, the rest - by workers in parallel.
+        Small pictures are processed in calling thread only. Returns when all ranges are processed. */
+    void ForEachMBRowRange(mfxU32 numMB, mfxU32 widthMB, const RangeFunc& func);
+
+private:
+    MBRowWorkers(const MBRowWorkers&);            // forbidden
+    MBRowWorkers& operator=(const MBRowWorkers&); // forbidden
+
+    void WorkerProc(mfxU32 rangeIdx, mfxU32 generation);
+
+    std::vector<std::thread> m_threads;    // worker i processes range i + 1
+    std::mutex               m_mutex;
+    std::condition_variable  m_startCond;
+    std::condition_variable  m_doneCond;
+
+    // parameters of current picture, guarded by m_mutex
+    const RangeFunc*         m_func;
+    mfxU32                   m_numMB;
+    mfxU32                   m_widthMB;
+    mfxU32                   m_rowsPerRange;
+    mfxU32                   m_numRanges;
+    mfxU32                   m_generation; // incremented for each picture to wake up workers
+    mfxU32                   m_numPending; // ranges processed by workers and not done yet
+    bool                     m_bQuit;
+};
 
 #endif // __SAMPLE_FEI_PRED_REPACKING_H__
\ No newline at end of file
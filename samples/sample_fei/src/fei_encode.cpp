@@ -268,8 +268,6 @@ mfxStatus FEI_EncodeInterface::FillParameters()
         /* Alloc temporal buffers */
         if (m_pAppConfig->bRepackPreencMV)
         {
-            m_tmpForMedian.resize(16);
-
             mfxU32 n_MB = m_pAppConfig->bDynamicRC ? m_pAppConfig->PipelineCfg.numMB_drc_max : m_pAppConfig->PipelineCfg.numMB_frame;
             m_tmpForReading.resize(n_MB);
         }
@@ -436,7 +434,7 @@ mfxStatus FEI_EncodeInterface::InitFrameParams(iTask* eTask)
                     if (m_pAppConfig->bRepackPreencMV)
                     {
                         SAFE_FREAD(&m_tmpForReading[0], sizeof(m_tmpForReading[0])*pMvPredBuf->NumMBAlloc, 1, m_pMvPred_in, MFX_ERR_MORE_DATA);
-                        repackPreenc2Enc(&m_tmpForReading[0], pMvPredBuf->MB, pMvPredBuf->NumMBAlloc, &m_tmpForMedian[0]);
+                        repackPreenc2Enc(&m_tmpForReading[0], pMvPredBuf->MB, pMvPredBuf->NumMBAlloc);
                     }
                     else {
                         SAFE_FREAD(pMvPredBuf->MB, sizeof(pMvPredBuf->MB[0])*pMvPredBuf->NumMBAlloc, 1, m_pMvPred_in, MFX_ERR_MORE_DATA);
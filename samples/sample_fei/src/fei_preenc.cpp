@@ -42,11 +42,6 @@ FEI_PreencInterface::FEI_PreencInterface(MFXVideoSession* session, iTaskPool* ta
     , m_pMBstat_out(NULL)
     , m_pMV_out(NULL)
 {
-    if (m_pAppConfig->bENCODE || m_pAppConfig->bOnlyENC || m_pAppConfig->bENCPAK)
-    {
-        m_tmpForMedian.resize(16);
-    }
-
     /* Default values for I-frames */
     for (size_t i = 0; i < 16; i++)
     {
@@ -893,9 +888,10 @@ mfxStatus FEI_PreencInterface::RepackPredictors(iTask* eTask)
 
     mfxStatus sts = MFX_ERR_NONE;
 
-    BestMVset BestSet(eTask);
+    PreEncCandidates cands;
 
-    mfxU32 i, j, numOfFields = eTask->m_fieldPicFlag ? 2 : 1;
+    mfxU32 numOfFields = eTask->m_fieldPicFlag ? 2 : 1;
+    mfxU32 widthMB     = ((m_pmfxDS ? m_DSParams.vpp.Out.Width : m_videoParams.mfx.FrameInfo.Width) + 15) >> 4;
 
     for (mfxU32 fieldId = 0; fieldId < numOfFields; fieldId++)
     {
@@ -917,41 +913,61 @@ mfxStatus FEI_PreencInterface::RepackPredictors(iTask* eTask)
         /* not necessary for pipelines PreENC + FEI_ENCODE / (ENCPAK), if number of predictors for next interface properly set */
         MSDK_ZERO_ARRAY(mvp->MB, mvp->NumMBAlloc);
 
-        for (i = 0; i < m_pAppConfig->PipelineCfg.numMB_preenc_refPic; ++i)
+        sts = GetPreEncCandidates(eTask->preenc_output, fieldId, cands);
+        MSDK_BREAK_ON_ERROR(sts);
+
+        /* MBs are processed by batches, batches of different MB rows - in parallel */
+        m_repackWorkers.ForEachMBRowRange(m_pAppConfig->PipelineCfg.numMB_preenc_refPic, widthMB, [&](mfxU32 firstMB, mfxU32 lastMB)
         {
-            /* get best L0/L1 PreENC predictors for current MB in terms of distortions */
-            sts = GetBestSetsByDistortion(eTask->preenc_output, BestSet, nPred_actual, fieldId, i);
-            MSDK_BREAK_ON_ERROR(sts);
+            mfxU8 best[2][MaxFeiEncMVPNum][MVPBatchSize];
+            mfxExtFeiPreEncMV::mfxExtFeiPreEncMVMB* preencMB[MVPBatchSize];
+            mfxI16Pair median[MVPBatchSize];
 
-            if (!m_pAppConfig->preencDSstrength)
+            for (mfxU32 i = firstMB; i < lastMB; i += MVPBatchSize)
             {
-                /* in case of PreENC on original surfaces just get median of MVs for each predictor */
-                for (j = 0; j < BestSet.bestL0.size(); ++j)
-                {
-                    mvp->MB[i].RefIdx[j].RefL0 = BestSet.bestL0[j].refIdx;
-                    mvp->MB[i].MV[j][0].x = get16Median(BestSet.bestL0[j].preenc_MVMB, &m_tmpForMedian[0], 0, 0);
-                    mvp->MB[i].MV[j][0].y = get16Median(BestSet.bestL0[j].preenc_MVMB, &m_tmpForMedian[0], 1, 0);
-                }
-                for (j = 0; j < BestSet.bestL1.size(); ++j)
+                mfxU32 nMB = (std::min)(MVPBatchSize, lastMB - i);
+
+                /* get best L0/L1 PreENC predictors for current MBs in terms of distortions */
+                GetBestSetsByDistortion(cands, nPred_actual, i, nMB, best);
+
+                for (mfxU32 L0L1 = 0; L0L1 < 2; ++L0L1)
                 {
-                    mvp->MB[i].RefIdx[j].RefL1 = BestSet.bestL1[j].refIdx;
-                    mvp->MB[i].MV[j][1].x = get16Median(BestSet.bestL1[j].preenc_MVMB, &m_tmpForMedian[0], 0, 1);
-                    mvp->MB[i].MV[j][1].y = get16Median(BestSet.bestL1[j].preenc_MVMB, &m_tmpForMedian[0], 1, 1);
+                    for (mfxU32 j = 0; j < nPred_actual[L0L1]; ++j)
+                    {
+                        for (mfxU32 k = 0; k < nMB; ++k)
+                            preencMB[k] = best[L0L1][j][k] == 0xff ? NULL : &cands.mvs[best[L0L1][j][k]]->MB[i + k];
+
+                        if (!m_pAppConfig->preencDSstrength)
+                        {
+                            /* in case of PreENC on original surfaces just get median of MVs for each predictor */
+                            get16Median(preencMB, nMB, L0L1, median);
+
+                            for (mfxU32 k = 0; k < nMB; ++k)
+                            {
+                                if (!preencMB[k])
+                                    continue;
+
+                                if (!L0L1)
+                                    mvp->MB[i + k].RefIdx[j].RefL0 = cands.refIdx[best[L0L1][j][k]][L0L1];
+                                else
+                                    mvp->MB[i + k].RefIdx[j].RefL1 = cands.refIdx[best[L0L1][j][k]][L0L1];
+
+                                mvp->MB[i + k].MV[j][L0L1] = median[k];
+                            }
+                        }
+                        else
+                        {
+                            /* in case of PreENC on downsampled surfaces we need to calculate umpsampled pridictors */
+                            for (mfxU32 k = 0; k < nMB; ++k)
+                            {
+                                if (preencMB[k])
+                                    UpsampleMVP(preencMB[k], i + k, mvp, j, cands.refIdx[best[L0L1][j][k]][L0L1], L0L1);
+                            }
+                        }
+                    }
                 }
-           }
-           else
-           {
-               /* in case of PreENC on downsampled surfaces we need to calculate umpsampled pridictors */
-               for (j = 0; j < BestSet.bestL0.size(); ++j)
-               {
-                   UpsampleMVP(BestSet.bestL0[j].preenc_MVMB, i, mvp, j, BestSet.bestL0[j].refIdx, 0);
-               }
-               for (j = 0; j < BestSet.bestL1.size(); ++j)
-               {
-                   UpsampleMVP(BestSet.bestL1[j].preenc_MVMB, i, mvp, j, BestSet.bestL1[j].refIdx, 1);
-               }
-           }
-        } // for (i = 0; i < numMBpreenc; ++i)
+            }
+        });
 
     } // for (mfxU32 fieldId = 0; fieldId < m_numOfFields; fieldId++)
 
@@ -998,8 +1014,8 @@ void FEI_PreencInterface::UpsampleMVP(mfxExtFeiPreEncMV::mfxExtFeiPreEncMVMB * p
         switch (m_pAppConfig->preencDSstrength)
         {
         case 2:
-            mvp_mb->x = get4Median(preenc_MVMB, &m_tmpForMedian[0], 0, L0L1, k);
-            mvp_mb->y = get4Median(preenc_MVMB, &m_tmpForMedian[0], 1, L0L1, k);
+            mvp_mb->x = get4Median(preenc_MVMB, 0, L0L1, k);
+            mvp_mb->y = get4Median(preenc_MVMB, 1, L0L1, k);
             break;
         case 4:
             mvp_mb->x = preenc_MVMB->MV[MVZigzagOrder[k]][L0L1].x;
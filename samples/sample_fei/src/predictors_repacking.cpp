@@ -0,0 +1,264 @@
+/******************************************************************************\
+Copyright (c) 2005-2019, Intel Corporation
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+This sample was distributed or derived from the Intel's Media Samples package.
+The original version of this sample may be obtained from https://software.intel.com/en-us/intel-media-server-studio
+or https://software.intel.com/en-us/media-client-solutions-support.
+\**********************************************************************************/
+
+
+#include "predictors_repacking.h"
+
+#ifndef MFX_VERSION
+#error MFX_VERSION not defined
+#endif
+
+/* Batcher's odd-even merge sort for 16 elements reduced to compare-exchanges affecting elements 7 and 8 */
+static const mfxU8 Median16Network[][2] =
+{
+    {0,1}, {2,3}, {0,2}, {1,3}, {1,2}, {4,5}, {6,7}, {4,6}, {5,7}, {5,6},
+    {0,4}, {2,6}, {2,4}, {1,5}, {3,7}, {3,5}, {1,2}, {3,4}, {5,6}, {8,9},
+    {10,11}, {8,10}, {9,11}, {9,10}, {12,13}, {14,15}, {12,14}, {13,15}, {13,14}, {8,12},
+    {10,14}, {10,12}, {9,13}, {11,15}, {11,13}, {9,10}, {11,12}, {13,14}, {0,8}, {4,12},
+    {4,8}, {2,10}, {6,14}, {6,10}, {6,8}, {1,9}, {5,13}, {5,9}, {3,11}, {7,15},
+    {7,11}, {7,9}, {7,8}
+};
+
+// x components of the batch are kept in first half of a row, y components in second one
+typedef mfxI16 MVLanes[2 * MVPBatchSize];
+
+static inline void CompareExchange(MVLanes& a, MVLanes& b)
+{
+    MVLanes lo, hi;
+
+    for (mfxU32 i = 0; i < 2 * MVPBatchSize; i++)
+    {
+        lo[i] = (std::min)(a[i], b[i]);
+        hi[i] = (std::max)(a[i], b[i]);
+    }
+
+    std::copy(lo, lo + 2 * MVPBatchSize, a);
+    std::copy(hi, hi + 2 * MVPBatchSize, b);
+}
+
+void get16Median(mfxExtFeiPreEncMV::mfxExtFeiPreEncMVMB* const preencMB[MVPBatchSize], mfxU32 nMB, mfxU32 L0L1, mfxI16Pair median[MVPBatchSize])
+{
+    MVLanes v[16] = {};
+
+    for (mfxU32 i = 0; i < nMB; i++)
+    {
+        if (!preencMB[i])
+            continue;
+
+        for (mfxU32 k = 0; k < 16; k++)
+        {
+            v[k][i]                = preencMB[i]->MV[k][L0L1].x;
+            v[k][MVPBatchSize + i] = preencMB[i]->MV[k][L0L1].y;
+        }
+    }
+
+    // every compare-exchange is done for all MBs of the batch at once
+    for (const mfxU8 (&ce)[2] : Median16Network)
+        CompareExchange(v[ce[0]], v[ce[1]]);
+
+    for (mfxU32 i = 0; i < nMB; i++)
+    {
+        median[i].x = (mfxI16)((v[7][i] + v[8][i]) / 2);
+        median[i].y = (mfxI16)((v[7][MVPBatchSize + i] + v[8][MVPBatchSize + i]) / 2);
+    }
+}
+
+mfxStatus repackPreenc2Enc(mfxExtFeiPreEncMV::mfxExtFeiPreEncMVMB *preencMVoutMB, mfxExtFeiEncMVPredictors::mfxExtFeiEncMVPredictorsMB *EncMVPredMB, mfxU32 NumMB)
+{
+    MSDK_ZERO_ARRAY(EncMVPredMB, NumMB);
+
+    mfxExtFeiPreEncMV::mfxExtFeiPreEncMVMB* preencMB[MVPBatchSize];
+    mfxI16Pair median[MVPBatchSize];
+
+    for (mfxU32 i = 0; i < NumMB; i += MVPBatchSize)
+    {
+        mfxU32 nMB = (std::min)(MVPBatchSize, NumMB - i);
+
+        for (mfxU32 k = 0; k < nMB; k++)
+            preencMB[k] = preencMVoutMB + i + k;
+
+        //only one ref is used for now, RefIdx are zeroed above
+        //use only first subblock component of MV
+        for (mfxU32 j = 0; j < 2; j++)
+        {
+            get16Median(preencMB, nMB, j, median);
+
+            for (mfxU32 k = 0; k < nMB; k++)
+                EncMVPredMB[i + k].MV[0][j] = median[k];
+        }
+    }
+
+    return MFX_ERR_NONE;
+}
+
+mfxStatus GetPreEncCandidates(std::list<PreEncOutput>& preenc_output, mfxU32 fieldId, PreEncCandidates& cands)
+{
+    cands.mvs.clear();
+    cands.mbstat.clear();
+    cands.refIdx.clear();
+
+    for (std::list<PreEncOutput>::iterator it = preenc_output.begin(); it != preenc_output.end(); ++it)
+    {
+        mfxExtFeiPreEncMV* mvs = reinterpret_cast<mfxExtFeiPreEncMV*> ((*it).output_bufs->PB_bufs.out.getBufById(MFX_EXTBUFF_FEI_PREENC_MV, fieldId));
+        MSDK_CHECK_POINTER(mvs, MFX_ERR_NULL_PTR);
+
+        mfxExtFeiPreEncMBStat* mbdata = reinterpret_cast<mfxExtFeiPreEncMBStat*> ((*it).output_bufs->PB_bufs.out.getBufById(MFX_EXTBUFF_FEI_PREENC_MB, fieldId));
+        MSDK_CHECK_POINTER(mbdata, MFX_ERR_NULL_PTR);
+
+        cands.mvs.push_back(mvs);
+        cands.mbstat.push_back(mbdata);
+        cands.refIdx.push_back((*it).refIdx[fieldId]);
+    }
+
+    // index of call is stored in 8 bits
+    if (cands.mvs.size() > 0xff)
+        return MFX_ERR_UNSUPPORTED;
+
+    return MFX_ERR_NONE;
+}
+
+void GetBestSetsByDistortion(const PreEncCandidates& cands, const mfxU32 nPred[2], mfxU32 firstMB, mfxU32 nMB,
+    mfxU8 best[2][MaxFeiEncMVPNum][MVPBatchSize])
+{
+    for (mfxU32 L0L1 = 0; L0L1 < 2; L0L1++)
+    {
+        mfxU32 top[MaxFeiEncMVPNum][MVPBatchSize];
+
+        if (!nPred[L0L1])
+            continue;
+
+        std::fill(&top[0][0], &top[0][0] + MaxFeiEncMVPNum * MVPBatchSize, 0xffffffff);
+
+        for (mfxU32 c = 0; c < cands.mbstat.size(); c++)
+        {
+            mfxU32 key[MVPBatchSize] = {};
+
+            for (mfxU32 i = 0; i < nMB; i++)
+                key[i] = (mfxU32(cands.mbstat[c]->MB[firstMB + i].Inter[L0L1].BestDistortion) << 8) | c;
+
+            // insertion to sorted array: smaller key stays, bigger one goes further
+            for (mfxU32 p = 0; p < nPred[L0L1]; p++)
+            {
+                for (mfxU32 i = 0; i < MVPBatchSize; i++)
+                {
+                    mfxU32 lo = (std::min)(top[p][i], key[i]);
+                    key[i]    = (std::max)(top[p][i], key[i]);
+                    top[p][i] = lo;
+                }
+            }
+        }
+
+        for (mfxU32 p = 0; p < nPred[L0L1]; p++)
+            for (mfxU32 i = 0; i < nMB; i++)
+                best[L0L1][p][i] = top[p][i] == 0xffffffff ? 0xff : mfxU8(top[p][i]);
+    }
+}
+
+MBRowWorkers::MBRowWorkers()
+    : m_func(NULL)
+    , m_numMB(0)
+    , m_widthMB(0)
+    , m_rowsPerRange(0)
+    , m_numRanges(0)
+    , m_generation(0)
+    , m_numPending(0)
+    , m_bQuit(false)
+{
+}
+
+MBRowWorkers::~MBRowWorkers()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_bQuit = true;
+    }
+    m_startCond.notify_all();
+
+    for (std::thread& t : m_threads)
+        t.join();
+}
+
+void MBRowWorkers::ForEachMBRowRange(mfxU32 numMB, mfxU32 widthMB, const RangeFunc& func)
+{
+    const mfxU32 minRowsPerRange = 4;
+
+    mfxU32 numRows   = (numMB + widthMB - 1) / widthMB;
+    mfxU32 numRanges = (std::min)((std::max)(std::thread::hardware_concurrency(), 1u), (std::max)(numRows / minRowsPerRange, 1u));
+    mfxU32 rowsPerRange = (numRows + numRanges - 1) / numRanges;
+    // rounding up may leave last ranges empty
+    numRanges = (numRows + rowsPerRange - 1) / rowsPerRange;
+
+    if (numRanges > 1)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        // new workers wait for the next generation, which is started below
+        while (m_threads.size() < numRanges - 1)
+            m_threads.emplace_back(&MBRowWorkers::WorkerProc, this, mfxU32(m_threads.size() + 1), m_generation);
+
+        m_func         = &func;
+        m_numMB        = numMB;
+        m_widthMB      = widthMB;
+        m_rowsPerRange = rowsPerRange;
+        m_numRanges    = numRanges;
+        m_numPending   = numRanges - 1;
+        m_generation++;
+
+        lock.unlock();
+        m_startCond.notify_all();
+    }
+
+    func(0u, (std::min)(rowsPerRange * widthMB, numMB));
+
+    if (numRanges > 1)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_doneCond.wait(lock, [this] { return m_numPending == 0; });
+        m_func = NULL;
+    }
+}
+
+void MBRowWorkers::WorkerProc(mfxU32 rangeIdx, mfxU32 generation)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    for (;;)
+    {
+        m_startCond.wait(lock, [this, generation] { return m_bQuit || m_generation != generation; });
+        if (m_bQuit)
+            break;
+
+        generation = m_generation;
+
+        // pictures smaller than the biggest one don't need all workers
+        if (rangeIdx >= m_numRanges)
+            continue;
+
+        const RangeFunc& func = *m_func;
+        mfxU32 firstMB = rangeIdx * m_rowsPerRange * m_widthMB;
+        mfxU32 lastMB  = (std::min)(firstMB + m_rowsPerRange * m_widthMB, m_numMB);
+
+        lock.unlock();
+        func(firstMB, lastMB);
+        lock.lock();
+
+        if (--m_numPending == 0)
+            m_doneCond.notify_one();
+    }
+}
@@ -60,6 +60,7 @@ or https://software.intel.com/en-us/media-client-solutions-support.
 
 #define TIME_STATS 1 // Enable statistics processing
 #include "time_statistics.h"
+#include "transcode_live_stats.h"
 
 #if defined(_WIN32) || defined(_WIN64)
 #include "decode_render.h"
@@ -189,9 +190,18 @@ namespace TranscodingSample
 #endif
         bool   bIsPerf;   // special performance mode. Use pre-allocated bitstreams, output
         mfxU16 nThreadsNum; // number of internal session threads number
+#if (MFX_VERSION >= MFX_VERSION_NEXT)
+        mfxU16 nNumaNode;   // bind session threads and memory to NUMA node nNumaNode-1, 0 - no binding
+        mfxU32 CpuMask[16]; // bind session threads to the set of logical CPUs
+        mfxU32 nFrameDeadline; // frame deadline in microseconds for the real-time scheduling class, 0 - regular priorities
+#endif
         bool bRobustFlag;   // Robust transcoding mode. Allows auto-recovery after hardware errors
         bool bSoftRobustFlag;
 
+        mfxU16 nChunks;         // number of IDR-aligned input chunks transcoded in parallel, 0 or 1 - linear mode
+        mfxU16 nChunkHrd;       // MFX_CODINGOPTION_OFF disables HRD signalling of chunk encoders
+        mfxU32 nChunkInitDelay; // InitialDelayInKB of chunks following the first one
+
         mfxU32 EncodeId; // type of output coded video
         mfxU32 DecodeId; // type of input coded video
 
@@ -620,6 +630,7 @@ namespace TranscodingSample
         virtual mfxStatus ProcessOutputBitstream(mfxBitstreamWrapper* pBitstream);
         virtual mfxStatus ResetInput();
         virtual mfxStatus ResetOutput();
+        virtual void      CloseOutput();
         virtual bool      IsNulOutput();
 
     protected:
@@ -662,6 +673,8 @@ namespace TranscodingSample
         { MSDK_CHECK_POINTER(m_pmfxSession.get(), MFX_ERR_NULL_PTR); return m_pmfxSession->QueryVersion(version); };
         inline mfxU32 GetPipelineID(){return m_nID;}
         inline void SetPipelineID(mfxU32 id){m_nID = id;}
+        inline void SetLiveStatistics(LiveStatsSession *pLiveStats){m_pLiveStats = pLiveStats;}
+        inline LiveStatsSession* GetLiveStatistics(){return m_pLiveStats;}
         void StopSession();
         bool IsOverlayUsed();
         size_t GetRobustFlag();
@@ -682,6 +695,9 @@ namespace TranscodingSample
 #endif
     protected:
         virtual mfxStatus CheckRequiredAPIVersion(mfxVersion& version, sInputParams *pParams);
+#if (MFX_VERSION >= MFX_VERSION_NEXT)
+        void PrintDeadlineStatistics();
+#endif
 
         virtual mfxStatus Decode();
         virtual mfxStatus Encode();
@@ -840,6 +856,7 @@ namespace TranscodingSample
         RotateParam                    m_RotateParam;
         MfxVideoParamsWrapper          m_mfxPreEncParams;
         mfxU32                         m_nTimeout;
+        mfxU32                         m_nFrameDeadline;
         bool                           m_bUseOverlay;
 
         bool                           m_bROIasQPMAP;
@@ -903,6 +920,9 @@ namespace TranscodingSample
         CIOStat inputStatistics;
         CIOStat outputStatistics;
 
+        // live counters in shared memory, NULL if not requested
+        LiveStatsSession *m_pLiveStats;
+
         bool shouldUseGreedyFormula;
 
 #if MFX_VERSION >= 1022
@@ -973,6 +993,10 @@ namespace TranscodingSample
             MSDK_CHECK_POINTER_NO_RET(pPipeline);
             transcodingSts = MFX_ERR_NONE;
 
+            LiveStatsSession *pLiveStats = pPipeline->GetLiveStatistics();
+            if (pLiveStats)
+                pLiveStats->Set(pLiveStats->Active, 1);
+
             auto start_time = system_clock::now();
             while (MFX_ERR_NONE == transcodingSts)
             {
@@ -980,6 +1004,9 @@ namespace TranscodingSample
             }
             working_time = duration_cast<duration<mfxF64>>(system_clock::now() - start_time).count();
 
+            if (pLiveStats)
+                pLiveStats->Set(pLiveStats->Active, 0);
+
             MSDK_IGNORE_MFX_STS(transcodingSts, MFX_WRN_VALUE_NOT_CHANGED);
             numTransFrames = pPipeline->GetProcessFrames();
         }
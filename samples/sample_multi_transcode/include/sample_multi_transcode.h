@@ -26,6 +26,7 @@ or https://software.intel.com/en-us/media-client-solutions-support.
 #endif
 
 #include "transcode_utils.h"
+#include "transcode_chunks.h"
 #include "pipeline_transcode.h"
 #include "sample_utils.h"
 
@@ -65,6 +66,8 @@ namespace TranscodingSample
         mfxStatus CheckAndFixAdapterDependency(mfxU32 idxSession, CTranscodingPipeline * pParentPipeline);
 #endif
         virtual mfxStatus VerifyCrossSessionsOptions();
+        virtual mfxStatus SplitChunkedSessions();
+        virtual mfxStatus StitchChunkedSessions();
         virtual mfxStatus CreateSafetyBuffers();
         virtual void      DoTranscoding();
         virtual void      DoRobustTranscoding();
@@ -73,6 +76,8 @@ namespace TranscodingSample
 
         // command line parser
         CmdProcessor m_parser;
+        // live counters shared with other processes, outlives pipelines
+        CLiveStatistics m_liveStats;
         // threads contexts to process playlist
         std::vector<std::unique_ptr<ThreadTranscodeContext>> m_pThreadContextArray;
         // allocator for each session
@@ -92,6 +97,22 @@ namespace TranscodingSample
 
         std::vector<sVppCompDstRect>         m_VppDstRects;
 
+        // session split into chunks, sessions of the chunks follow each other
+        struct ChunkedSession
+        {
+            msdk_string DstFile;      // empty for null output
+            mfxU32      FirstSession;
+            mfxU32      NumChunks;
+            mfxF64      SplitTime;
+            mfxF64      StitchTime;
+            mfxStatus   StitchSts;    // result of stitching outputs of the chunks
+        };
+        std::vector<ChunkedSession>          m_ChunkedSessions;
+        // input chunk of each session, zero size - the whole file
+        std::vector<TranscodeChunk>          m_InputChunks;
+        // par file line of each session
+        std::vector<mfxU32>                  m_SessionLines;
+
     private:
         DISALLOW_COPY_AND_ASSIGN(Launcher);
 
@@ -0,0 +1,69 @@
+/******************************************************************************\
+Copyright (c) 2020, Intel Corporation
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+This sample was distributed or derived from the Intel's Media Samples package.
+The original version of this sample may be obtained from https://software.intel.com/en-us/intel-media-server-studio
+or https://software.intel.com/en-us/media-client-solutions-support.
+\**********************************************************************************/
+
+
+#ifndef __TRANSCODE_CHUNKS_H__
+#define __TRANSCODE_CHUNKS_H__
+
+#include <vector>
+
+#include "sample_utils.h"
+
+namespace TranscodingSample
+{
+    // Part of an AVC or HEVC elementary stream which can be transcoded independently
+    struct TranscodeChunk
+    {
+        mfxU64 Offset;              // position of the chunk in the input file
+        mfxU64 Size;                // chunk size in bytes, 0 - the whole file
+        std::vector<mfxU8> Headers; // parameter sets to send before the chunk data
+
+        TranscodeChunk() : Offset(0), Size(0) {}
+    };
+
+    // Splits the stream into at most numChunks chunks of similar size. Every chunk
+    // except the first one starts with the access unit of an IDR or BLA picture, so
+    // it doesn't reference pictures of preceding chunks. Returns a single chunk if
+    // the stream has no such pictures.
+    mfxStatus SplitIntoChunks(const msdk_char *strFileName, mfxU32 codecId, mfxU32 numChunks, std::vector<TranscodeChunk> &chunks);
+
+    // Copies parts to the destination file in the given order and removes them
+    mfxStatus StitchChunks(const msdk_char *strDstFile, const std::vector<msdk_string> &parts);
+
+    // Reads one chunk of the file, parameter sets of the chunk go first
+    class CChunkBitstreamReader : public CSmplBitstreamReader
+    {
+    public:
+        CChunkBitstreamReader(const TranscodeChunk &chunk);
+
+        virtual void      Reset();
+        virtual mfxStatus Init(const msdk_char *strFileName);
+        virtual mfxStatus ReadNextFrame(mfxBitstream *pBS);
+
+    protected:
+        TranscodeChunk m_chunk;
+        size_t         m_nHeadersSent;
+        mfxU64         m_nBytesLeft;
+
+    private:
+        DISALLOW_COPY_AND_ASSIGN(CChunkBitstreamReader);
+    };
+}
+
+#endif //__TRANSCODE_CHUNKS_H__
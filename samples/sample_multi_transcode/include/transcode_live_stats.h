@@ -0,0 +1,129 @@
+/******************************************************************************\
+Copyright (c) 2020, Intel Corporation
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+This sample was distributed or derived from the Intel's Media Samples package.
+The original version of this sample may be obtained from https://software.intel.com/en-us/intel-media-server-studio
+or https://software.intel.com/en-us/media-client-solutions-support.
+\**********************************************************************************/
+
+
+#ifndef __TRANSCODE_LIVE_STATS_H__
+#define __TRANSCODE_LIVE_STATS_H__
+
+#include <atomic>
+#include <stdio.h>
+
+#include "sample_utils.h"
+
+namespace TranscodingSample
+{
+    // Counters of one session published in the shared memory segment.
+    // Every slot has a single writer (its pipeline), readers only load values.
+    struct LiveStatsSession
+    {
+        std::atomic<mfxU64> FramesIn;      // frames got from decoder or raw input
+        std::atomic<mfxU64> FramesOut;     // bitstreams passed to the writer
+        std::atomic<mfxU64> DecodeTime;    // ticks spent in decode calls
+        std::atomic<mfxU64> VppTime;       // ticks spent in VPP calls
+        std::atomic<mfxU64> EncodeTime;    // ticks spent in encode calls
+        std::atomic<mfxU64> SyncWaits;     // number of SyncOperation calls on output
+        std::atomic<mfxU64> SyncWaitTime;  // ticks spent in these calls
+        std::atomic<mfxU32> DecPoolUsed;   // locked surfaces in decoder pool
+        std::atomic<mfxU32> DecPoolSize;
+        std::atomic<mfxU32> EncPoolUsed;   // locked surfaces in encoder pool
+        std::atomic<mfxU32> EncPoolSize;
+        std::atomic<mfxU32> OutputQueue;   // bitstreams waiting for synchronization
+        std::atomic<mfxU32> Active;        // 1 while the session is running
+
+        void Add(std::atomic<mfxU64> & counter, mfxU64 value)
+        {
+            counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+        }
+        void Set(std::atomic<mfxU32> & counter, mfxU32 value)
+        {
+            counter.store(value, std::memory_order_relaxed);
+        }
+    };
+
+    // adds time spent in the scope to the session counter, does nothing without session
+    class CLiveStatsTimer
+    {
+    public:
+        CLiveStatsTimer(LiveStatsSession *pSession, std::atomic<mfxU64> LiveStatsSession::*counter)
+            : m_pSession(pSession)
+            , m_counter(counter)
+            , m_start(pSession ? msdk_time_get_tick() : 0)
+        {
+        }
+        ~CLiveStatsTimer()
+        {
+            if (m_pSession)
+                m_pSession->Add(m_pSession->*m_counter, (mfxU64)(msdk_time_get_tick() - m_start));
+        }
+
+    private:
+        LiveStatsSession                     *m_pSession;
+        std::atomic<mfxU64> LiveStatsSession::*m_counter;
+        msdk_tick                             m_start;
+
+        DISALLOW_COPY_AND_ASSIGN(CLiveStatsTimer);
+    };
+
+    struct LiveStatsHeader
+    {
+        mfxU32 Magic;
+        mfxU32 Version;
+        mfxU32 NumSessions;
+        mfxU32 ProcessId;
+        mfxU64 StartTime;    // msdk_time_get_tick() units
+        mfxU64 Frequency;    // ticks per second
+    };
+
+    // Shared memory segment with live counters of all sessions of the process.
+    // The writer creates it with -stat-live <name>, any other process can
+    // open it by the same name and print the counters while transcoding runs.
+    class CLiveStatistics
+    {
+    public:
+        CLiveStatistics();
+        ~CLiveStatistics();
+
+        mfxStatus Create(const msdk_char *name, mfxU32 numSessions);
+        mfxStatus Open(const msdk_char *name);
+        void Close();
+
+        LiveStatsSession* GetSession(mfxU32 idx);
+
+        // human readable table, one line per session
+        void PrintTable(FILE *file);
+        // Prometheus text exposition format
+        void PrintPrometheus(FILE *file);
+
+        // prints the table every interval until the writer removes the segment
+        static mfxStatus Monitor(const msdk_char *name, mfxU32 intervalMs);
+        // prints one snapshot in Prometheus format
+        static mfxStatus Export(const msdk_char *name);
+
+    private:
+        LiveStatsHeader  *m_pHeader;
+        LiveStatsSession *m_pSessions;
+        size_t            m_size;
+        bool              m_bOwner;
+        msdk_string       m_name;
+
+        DISALLOW_COPY_AND_ASSIGN(CLiveStatistics);
+    };
+}
+
+#endif //__TRANSCODE_LIVE_STATS_H__
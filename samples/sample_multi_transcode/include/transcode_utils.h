@@ -62,6 +62,7 @@ namespace TranscodingSample
         mfxStatus ParseCmdLine(int argc, msdk_char *argv[]);
         bool GetNextSessionParams(TranscodingSample::sInputParams &InputParams);
         FILE*     GetPerformanceFile() {return m_PerfFILE;};
+        const msdk_string& GetLiveStatsName() const {return LiveStatsName;};
         void      PrintParFileName();
         msdk_string GetLine(mfxU32 n);
     protected:
@@ -88,6 +89,8 @@ namespace TranscodingSample
         FILE                                         *statisticsLogFile;
         //store a name of a Logfile
         msdk_tstring                                 DumpLogFileName;
+        //shared memory object for live statistics
+        msdk_string                                  LiveStatsName;
         mfxU32                                       m_nTimeout;
         bool                                         bRobustFlag;
         bool                                         bSoftRobustFlag;
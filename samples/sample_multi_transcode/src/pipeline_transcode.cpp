@@ -144,6 +144,7 @@ CTranscodingPipeline::CTranscodingPipeline():
     m_bIsVpp(false),
     m_bIsPlugin(false),
     m_nTimeout(0),
+    m_nFrameDeadline(0),
     m_bOwnMVCSeqDescMemory(true),
     m_nID(0),
     m_AsyncDepth(0),
@@ -166,6 +167,7 @@ CTranscodingPipeline::CTranscodingPipeline():
     m_pBSProcessor(NULL),
     m_nReqFrameTime(0),
     m_nOutputFramesNum(0),
+    m_pLiveStats(NULL),
     shouldUseGreedyFormula(false),
     m_nRotationAngle(0)
 {
@@ -548,6 +550,7 @@ mfxStatus CTranscodingPipeline::DecodeOneFrame(ExtendedSurface *pExtSurface)
     mfxStatus sts = MFX_ERR_MORE_SURFACE;
     mfxFrameSurface1    *pmfxSurface = NULL;
     pExtSurface->pSurface = NULL;
+    CLiveStatsTimer liveTimer(m_pLiveStats, &LiveStatsSession::DecodeTime);
 
     //--- Time measurements
     if (statisticsWindowSize)
@@ -625,6 +628,10 @@ mfxStatus CTranscodingPipeline::DecodeOneFrame(ExtendedSurface *pExtSurface)
         HandlePossibleGpuHang(sts);
         MSDK_CHECK_ERR_NONE_STATUS(sts, MFX_ERR_ABORTED, "Decode: SyncOperation failed");
     }
+
+    if (m_pLiveStats && MFX_ERR_NONE == sts)
+        m_pLiveStats->Add(m_pLiveStats->FramesIn, 1);
+
     return sts;
 
 } // mfxStatus CTranscodingPipeline::DecodeOneFrame(ExtendedSurface *pExtSurface)
@@ -633,6 +640,7 @@ mfxStatus CTranscodingPipeline::DecodeLastFrame(ExtendedSurface *pExtSurface)
     MFX_ITT_TASK("DecodeLastFrame");
     mfxFrameSurface1    *pmfxSurface = NULL;
     mfxStatus sts = MFX_ERR_MORE_SURFACE;
+    CLiveStatsTimer liveTimer(m_pLiveStats, &LiveStatsSession::DecodeTime);
 
     //--- Time measurements
     if (statisticsWindowSize)
@@ -680,6 +688,9 @@ mfxStatus CTranscodingPipeline::DecodeLastFrame(ExtendedSurface *pExtSurface)
         MSDK_CHECK_ERR_NONE_STATUS(sts, MFX_ERR_ABORTED, "Decode: SyncOperation failed");
     }
 
+    if (m_pLiveStats && MFX_ERR_NONE == sts)
+        m_pLiveStats->Add(m_pLiveStats->FramesIn, 1);
+
     return sts;
 }
 
@@ -687,6 +698,7 @@ mfxStatus CTranscodingPipeline::VPPOneFrame(ExtendedSurface *pSurfaceIn, Extende
 {
     MFX_ITT_TASK("VPPOneFrame");
     MSDK_CHECK_POINTER(pExtSurface,  MFX_ERR_NULL_PTR);
+    CLiveStatsTimer liveTimer(m_pLiveStats, &LiveStatsSession::VppTime);
 
     // find/wait for a free working surface
     auto out_surface = GetFreeSurface(false, MSDK_SURFACE_WAIT_INTERVAL);
@@ -748,6 +760,7 @@ mfxStatus CTranscodingPipeline::VPPOneFrame(ExtendedSurface *pSurfaceIn, Extende
 mfxStatus CTranscodingPipeline::EncodeOneFrame(ExtendedSurface *pExtSurface, mfxBitstreamWrapper *pBS)
 {
     mfxStatus sts = MFX_ERR_NONE;
+    CLiveStatsTimer liveTimer(m_pLiveStats, &LiveStatsSession::EncodeTime);
 
     if (!pBS->Data)
     {
@@ -1945,7 +1958,12 @@ mfxStatus CTranscodingPipeline::PutBS()
     // get result coded stream, synchronize only if we still have sync point
     if(pBitstreamEx->Syncp)
     {
-        sts = m_pmfxSession->SyncOperation(pBitstreamEx->Syncp, MSDK_WAIT_INTERVAL);
+        {
+            CLiveStatsTimer liveTimer(m_pLiveStats, &LiveStatsSession::SyncWaitTime);
+            sts = m_pmfxSession->SyncOperation(pBitstreamEx->Syncp, MSDK_WAIT_INTERVAL);
+        }
+        if (m_pLiveStats)
+            m_pLiveStats->Add(m_pLiveStats->SyncWaits, 1);
         HandlePossibleGpuHang(sts);
         MSDK_CHECK_ERR_NONE_STATUS(sts, MFX_ERR_ABORTED, "Encode: SyncOperation failed");
     }
@@ -1971,6 +1989,12 @@ mfxStatus CTranscodingPipeline::PutBS()
         m_BSPool.pop_front();
     m_pBSStore->Release(pBitstreamEx);
 
+    if (m_pLiveStats)
+    {
+        m_pLiveStats->Add(m_pLiveStats->FramesOut, 1);
+        m_pLiveStats->Set(m_pLiveStats->OutputQueue, (mfxU32)m_BSPool.size());
+    }
+
     return sts;
 } //mfxStatus CTranscodingPipeline::PutBS()
 
@@ -3677,6 +3701,7 @@ mfxStatus CTranscodingPipeline::Init(sInputParams *pParams,
     shouldUseGreedyFormula = pParams->shouldUseGreedyFormula;
 
     m_nTimeout = pParams->nTimeout;
+    m_nFrameDeadline = pParams->nFrameDeadline;
 
     m_AsyncDepth = (0 == pParams->nAsyncDepth)? 1: pParams->nAsyncDepth;
     m_FrameNumberPreference = pParams->FrameNumberPreference;
@@ -3813,6 +3838,15 @@ mfxStatus CTranscodingPipeline::Init(sInputParams *pParams,
         auto threadsPar = m_initPar.AddExtBuffer<mfxExtThreadsParam>();
         threadsPar->NumThread = pParams->nThreadsNum;
     }
+#if (MFX_VERSION >= MFX_VERSION_NEXT)
+    if (pParams->nNumaNode || pParams->nFrameDeadline || std::any_of(std::begin(pParams->CpuMask), std::end(pParams->CpuMask), [](mfxU32 m) { return m != 0; }))
+    {
+        auto threadsPar = m_initPar.AddExtBuffer<mfxExtThreadsParam>();
+        threadsPar->NumaNode = pParams->nNumaNode;
+        std::copy(std::begin(pParams->CpuMask), std::end(pParams->CpuMask), threadsPar->CpuMask);
+        threadsPar->FrameDeadline = pParams->nFrameDeadline;
+    }
+#endif
 
     //--- GPU Copy settings
     m_initPar.GPUCopy = pParams->nGpuCopyMode;
@@ -4160,6 +4194,15 @@ mfxFrameSurface1* CTranscodingPipeline::GetFreeSurface(bool isDec, mfxU64 timeou
         }
     } while ( t.GetTime() < timeout / 1000 );
 
+    if (m_pLiveStats)
+    {
+        // the returned surface is about to be locked, count it as used
+        const mfxU32 size = (mfxU32)(isDec ? m_pSurfaceDecPool : m_pSurfaceEncPool).size();
+        const mfxU32 used = size - GetFreeSurfacesCount(isDec) + (pSurf ? 1 : 0);
+        m_pLiveStats->Set(isDec ? m_pLiveStats->DecPoolUsed : m_pLiveStats->EncPoolUsed, std::min(used, size));
+        m_pLiveStats->Set(isDec ? m_pLiveStats->DecPoolSize : m_pLiveStats->EncPoolSize, size);
+    }
+
     return pSurf;
 } // mfxFrameSurface1* CTranscodingPipeline::GetFreeSurface(bool isDec)
 
@@ -4304,8 +4347,46 @@ size_t CTranscodingPipeline::GetRobustFlag()
     return m_bRobustFlag;
 }
 
+#if (MFX_VERSION >= MFX_VERSION_NEXT)
+template <class T>
+static void PrintDeadlineStat(mfxU32 pipelineId, const T& stat)
+{
+    msdk_printf(MSDK_STRING("[%u]: deadline tasks %llu, missed %llu, max lateness %llu us\n"), pipelineId,
+                (unsigned long long)stat.NumDeadlineTask, (unsigned long long)stat.NumMissedDeadline, (unsigned long long)stat.MaxDeadlineLateness);
+}
+
+void CTranscodingPipeline::PrintDeadlineStatistics()
+{
+    // deadlines are counted by the scheduler, which is common for sessions joined together,
+    // so any component of the session reports the same numbers
+    if (m_pmfxENC.get())
+    {
+        mfxEncodeStat stat = {};
+        if (MFX_ERR_NONE == m_pmfxENC->GetEncodeStat(&stat))
+            PrintDeadlineStat(GetPipelineID(), stat);
+    }
+    else if (m_pmfxVPP.get())
+    {
+        mfxVPPStat stat = {};
+        if (MFX_ERR_NONE == m_pmfxVPP->GetVPPStat(&stat))
+            PrintDeadlineStat(GetPipelineID(), stat);
+    }
+    else if (m_pmfxDEC.get())
+    {
+        mfxDecodeStat stat = {};
+        if (MFX_ERR_NONE == m_pmfxDEC->GetDecodeStat(&stat))
+            PrintDeadlineStat(GetPipelineID(), stat);
+    }
+}
+#endif
+
 void CTranscodingPipeline::Close()
 {
+#if (MFX_VERSION >= MFX_VERSION_NEXT)
+    if (m_nFrameDeadline)
+        PrintDeadlineStatistics();
+#endif
+
     if (m_pmfxDEC.get())
         m_pmfxDEC->Close();
 
@@ -4880,6 +4961,14 @@ mfxStatus FileBitstreamProcessor::ResetOutput()
     return MFX_ERR_NONE;
 }
 
+void FileBitstreamProcessor::CloseOutput()
+{
+    if (m_pFileWriter.get())
+    {
+        m_pFileWriter->Close();
+    }
+}
+
 bool FileBitstreamProcessor::IsNulOutput()
 {
     return !m_pFileWriter.get();
@@ -134,6 +134,16 @@ mfxStatus Launcher::Init(int argc, msdk_char *argv[])
         m_InputParamsArray.push_back(InputParams);
     }
 
+    // replace chunked sessions with sessions of their chunks
+    sts = SplitChunkedSessions();
+    MSDK_CHECK_STATUS(sts, "SplitChunkedSessions failed");
+
+    if (!m_parser.GetLiveStatsName().empty())
+    {
+        sts = m_liveStats.Create(m_parser.GetLiveStatsName().c_str(), (mfxU32)m_InputParamsArray.size());
+        MSDK_CHECK_STATUS(sts, "m_liveStats.Create failed");
+    }
+
     // check correctness of input parameters
     sts = VerifyCrossSessionsOptions();
     MSDK_CHECK_STATUS(sts, "VerifyCrossSessionsOptions failed");
@@ -404,6 +414,7 @@ mfxStatus Launcher::Init(int argc, msdk_char *argv[])
         m_pExtBSProcArray.push_back(std::unique_ptr<FileBitstreamProcessor> (new FileBitstreamProcessor));
 
         pThreadPipeline->pPipeline.reset(CreatePipeline());
+        pThreadPipeline->pPipeline->SetLiveStatistics(m_liveStats.GetSession(i));
 
 #if (defined(_WIN32) || defined(_WIN64)) && (MFX_VERSION >= 1031)
         pThreadPipeline->pPipeline->SetPrefferiGfx(m_InputParamsArray[i].bPrefferiGfx);
@@ -430,6 +441,11 @@ mfxStatus Launcher::Init(int argc, msdk_char *argv[])
             reader.reset(new CSmplBitstreamReader());
         }
 
+        if (m_InputChunks[i].Size)
+        {
+            reader.reset(new CChunkBitstreamReader(m_InputChunks[i]));
+        }
+
         if (reader.get())
         {
             sts = reader->Init(m_InputParamsArray[i].strSrcFile);
@@ -586,6 +602,14 @@ void Launcher::Run()
 
     msdk_printf(MSDK_STRING("\nTranscoding finished\n"));
 
+    if (!m_ChunkedSessions.empty())
+    {
+        // status of each chunked session is kept for ProcessResult()
+        mfxStatus sts = StitchChunkedSessions();
+        if (sts < MFX_ERR_NONE)
+            msdk_printf(MSDK_STRING("\nStitching of chunks failed with status %s\n"), StatusToString(sts).c_str());
+    }
+
 } // mfxStatus Launcher::Init()
 
 void Launcher::DoTranscoding()
@@ -772,7 +796,7 @@ mfxStatus Launcher::ProcessResult()
            << framesNum << MSDK_STRING(" frames, ")
            << std::fixed << std::setprecision(3) << framesNum / workTime << MSDK_STRING(" fps")
            << std::endl
-           << m_parser.GetLine(i) << std::endl << std::endl;
+           << m_parser.GetLine(m_SessionLines[i]) << std::endl << std::endl;
 
         msdk_printf(MSDK_STRING("%s"),ss.str().c_str());
         if (pPerfFile)
@@ -783,6 +807,44 @@ mfxStatus Launcher::ProcessResult()
     }
     msdk_printf(MSDK_STRING("-------------------------------------------------------------------------------\n"));
 
+    for (const ChunkedSession& chunked : m_ChunkedSessions)
+    {
+        // the chunks share the device, so their summed time is what the linear mode would take
+        mfxF64 wallTime = 0, sumTime = 0;
+        for (mfxU32 i = chunked.FirstSession; i < chunked.FirstSession + chunked.NumChunks; i++)
+        {
+            wallTime = std::max(wallTime, m_pThreadContextArray[i]->working_time);
+            sumTime += m_pThreadContextArray[i]->working_time;
+        }
+        wallTime += chunked.SplitTime + chunked.StitchTime;
+
+        // chunks may all succeed while their outputs are not stitched
+        if (!FinalSts)
+            FinalSts = chunked.StitchSts;
+
+        msdk_stringstream ss;
+        ss << MSDK_STRING("*** sessions ") << chunked.FirstSession << MSDK_STRING("-")
+           << chunked.FirstSession + chunked.NumChunks - 1 << MSDK_STRING(" (")
+           << chunked.NumChunks << MSDK_STRING(" chunks) ")
+           << (chunked.StitchSts ? MSDK_STRING("stitch FAILED (") + StatusToString(chunked.StitchSts) + MSDK_STRING(") ") : msdk_string())
+           << MSDK_STRING("wall clock ")
+           << std::fixed << std::setprecision(3) << wallTime << MSDK_STRING(" sec (split ")
+           << chunked.SplitTime << MSDK_STRING(" sec, stitch ") << chunked.StitchTime
+           << MSDK_STRING(" sec), chunks in sequence ") << sumTime << MSDK_STRING(" sec, speedup ")
+           << (wallTime > 0 ? sumTime / wallTime : 0) << std::endl
+           << m_parser.GetLine(m_SessionLines[chunked.FirstSession]) << std::endl << std::endl;
+
+        msdk_printf(MSDK_STRING("%s"),ss.str().c_str());
+        if (pPerfFile)
+        {
+            msdk_fprintf(pPerfFile, MSDK_STRING("%s"), ss.str().c_str());
+        }
+    }
+    if (!m_ChunkedSessions.empty())
+    {
+        msdk_printf(MSDK_STRING("-------------------------------------------------------------------------------\n"));
+    }
+
     msdk_stringstream ssTest;
     ssTest << std::endl << MSDK_STRING("The test ") << (FinalSts ? msdk_string(MSDK_STRING("FAILED")) : msdk_string(MSDK_STRING("PASSED"))) << std::endl;
 
@@ -1180,6 +1242,123 @@ mfxStatus Launcher::VerifyCrossSessionsOptions()
 
 } // mfxStatus Launcher::VerifyCrossSessionsOptions()
 
+mfxStatus Launcher::SplitChunkedSessions()
+{
+    std::vector<sInputParams> sessions;
+    sessions.swap(m_InputParamsArray);
+
+    for (mfxU32 line = 0; line < sessions.size(); line++)
+    {
+        const sInputParams& params = sessions[line];
+        std::vector<TranscodeChunk> chunks;
+
+        if (params.nChunks > 1)
+        {
+            msdk_tick startTime = GetTick();
+            mfxStatus sts = SplitIntoChunks(params.strSrcFile, params.DecodeId, params.nChunks, chunks);
+            MSDK_CHECK_STATUS(sts, "SplitIntoChunks failed");
+
+            if (chunks.size() < 2)
+            {
+                msdk_printf(MSDK_STRING("WARNING: no IDR pictures to split input of session %d, it will be transcoded linearly\n"), line);
+                chunks.clear();
+            }
+            else
+            {
+                ChunkedSession chunked;
+                chunked.FirstSession = (mfxU32)m_InputParamsArray.size();
+                chunked.NumChunks    = (mfxU32)chunks.size();
+                chunked.SplitTime    = GetTime(startTime);
+                chunked.StitchTime   = 0;
+                chunked.StitchSts    = MFX_ERR_NONE;
+                if (msdk_strncmp(MSDK_STRING("null"), params.strDstFile, msdk_strlen(MSDK_STRING("null"))))
+                    chunked.DstFile = params.strDstFile;
+                m_ChunkedSessions.push_back(chunked);
+
+                msdk_printf(MSDK_STRING("Session %d is split into %d chunks\n"), line, (int)chunks.size());
+            }
+        }
+
+        if (chunks.empty())
+        {
+            m_InputParamsArray.push_back(params);
+            m_InputChunks.push_back(TranscodeChunk());
+            m_SessionLines.push_back(line);
+            continue;
+        }
+
+        for (mfxU32 k = 0; k < chunks.size(); k++)
+        {
+            sInputParams chunkParams = params;
+
+            if (!m_ChunkedSessions.back().DstFile.empty())
+            {
+                msdk_stringstream name;
+                name << params.strDstFile << MSDK_STRING(".chunk") << k;
+                if (name.str().size() + 1 > MSDK_ARRAY_LEN(chunkParams.strDstFile))
+                {
+                    msdk_printf(MSDK_STRING("error: destination file name is too long for chunks\n"));
+                    return MFX_ERR_UNSUPPORTED;
+                }
+                msdk_opt_read(name.str(), chunkParams.strDstFile);
+            }
+
+            if (params.nChunkHrd == MFX_CODINGOPTION_OFF)
+            {
+                chunkParams.nNalHrdConformance = MFX_CODINGOPTION_OFF;
+                chunkParams.nVuiNalHrdParameters = MFX_CODINGOPTION_OFF;
+            }
+            if (k && params.nChunkInitDelay)
+            {
+                chunkParams.InitialDelayInKB = params.nChunkInitDelay;
+            }
+
+            m_InputParamsArray.push_back(chunkParams);
+            m_InputChunks.push_back(chunks[k]);
+            m_SessionLines.push_back(line);
+        }
+    }
+
+    return MFX_ERR_NONE;
+} // mfxStatus Launcher::SplitChunkedSessions()
+
+mfxStatus Launcher::StitchChunkedSessions()
+{
+    mfxStatus sts = MFX_ERR_NONE;
+
+    for (ChunkedSession& chunked : m_ChunkedSessions)
+    {
+        if (chunked.DstFile.empty())
+            continue;
+
+        std::vector<msdk_string> parts;
+        bool bFailed = false;
+        for (mfxU32 i = chunked.FirstSession; i < chunked.FirstSession + chunked.NumChunks; i++)
+        {
+            bFailed = bFailed || m_pThreadContextArray[i]->transcodingSts < MFX_ERR_NONE;
+            m_pExtBSProcArray[i]->CloseOutput();
+            parts.push_back(m_InputParamsArray[i].strDstFile);
+        }
+
+        if (bFailed)
+        {
+            msdk_printf(MSDK_STRING("WARNING: chunks of %s failed, outputs of the chunks are not stitched\n"), chunked.DstFile.c_str());
+            continue;
+        }
+
+        msdk_tick startTime = GetTick();
+        chunked.StitchSts  = StitchChunks(chunked.DstFile.c_str(), parts);
+        chunked.StitchTime = GetTime(startTime);
+        if (chunked.StitchSts != MFX_ERR_NONE)
+        {
+            msdk_printf(MSDK_STRING("error: failed to stitch chunks of %s\n"), chunked.DstFile.c_str());
+            sts = chunked.StitchSts;
+        }
+    }
+
+    return sts;
+} // mfxStatus Launcher::StitchChunkedSessions()
+
 mfxStatus Launcher::CreateSafetyBuffers()
 {
     SafetySurfaceBuffer* pBuffer     = NULL;
@@ -0,0 +1,273 @@
+/******************************************************************************\
+Copyright (c) 2020, Intel Corporation
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+This sample was distributed or derived from the Intel's Media Samples package.
+The original version of this sample may be obtained from https://software.intel.com/en-us/intel-media-server-studio
+or https://software.intel.com/en-us/media-client-solutions-support.
+\**********************************************************************************/
+
+
+#include "transcode_chunks.h"
+#include "annexb_scanner.h"
+#include "sample_defs.h"
+
+#include <algorithm>
+
+#if defined(_WIN32) || defined(_WIN64)
+#define CHUNK_FSEEK(file, offset, origin) _fseeki64(file, offset, origin)
+#define CHUNK_FTELL(file)                 _ftelli64(file)
+#define CHUNK_REMOVE(name)                _tremove(name)
+#else
+#define CHUNK_FSEEK(file, offset, origin) fseeko(file, offset, origin)
+#define CHUNK_FTELL(file)                 ftello(file)
+#define CHUNK_REMOVE(name)                remove(name)
+#endif
+
+using namespace TranscodingSample;
+
+namespace
+{
+    struct ParamSet
+    {
+        mfxU64             Key;
+        std::vector<mfxU8> Data;
+    };
+}
+
+mfxStatus TranscodingSample::SplitIntoChunks(const msdk_char *strFileName, mfxU32 codecId, mfxU32 numChunks, std::vector<TranscodeChunk> &chunks)
+{
+    MSDK_CHECK_POINTER(strFileName, MFX_ERR_NULL_PTR);
+    if (codecId != MFX_CODEC_AVC && codecId != MFX_CODEC_HEVC)
+        return MFX_ERR_UNSUPPORTED;
+
+    FILE *file = NULL;
+    MSDK_FOPEN(file, strFileName, MSDK_STRING("rb"));
+    MSDK_CHECK_POINTER(file, MFX_ERR_NULL_PTR);
+
+    // chunk k starts at the first IDR or BLA access unit after k/numChunks of the file
+    CHUNK_FSEEK(file, 0, SEEK_END);
+    mfxU64 fileSize = (mfxU64)CHUNK_FTELL(file);
+    CHUNK_FSEEK(file, 0, SEEK_SET);
+
+    chunks.clear();
+    chunks.push_back(TranscodeChunk());
+
+    // the latest parameter set of every key, ordered by their last occurrence in the stream
+    std::vector<ParamSet> headers;
+
+    mfxU64 auOffset = 0;       // first NAL unit of the current access unit
+    bool   bAuHasHeaders = false;
+    bool   bAfterSlice = true; // next non-VCL NAL unit starts a new access unit
+
+    // the parameter set replaces the one with the same key
+    auto onHeader = [&](mfxU64 key, std::vector<mfxU8> &header) -> mfxStatus
+    {
+        ParamSet paramSet;
+        paramSet.Key = key;
+        paramSet.Data.swap(header);
+
+        headers.erase(std::remove_if(headers.begin(), headers.end(),
+            [&](const ParamSet &h) { return h.Key == paramSet.Key; }), headers.end());
+        headers.push_back(std::move(paramSet));
+        return MFX_ERR_NONE;
+    };
+
+    auto onUnit = [&](const CAnnexBScanner::Unit &unit)
+    {
+        switch (unit.Class)
+        {
+        case UNIT_HEADER:
+        case UNIT_AU_PREFIX:
+            if (bAfterSlice)
+            {
+                auOffset = unit.Offset;
+                bAuHasHeaders = false;
+                bAfterSlice = false;
+            }
+            bAuHasHeaders = bAuHasHeaders || unit.Class == UNIT_HEADER;
+            break;
+        case UNIT_RAP:
+        {
+            // IDR or BLA without RASL pictures, which reference the previous chunk
+            mfxU8 type = (unit.Header[0] >> 1) & 0x3f;
+            if (codecId == MFX_CODEC_AVC || (type >= 17 && type <= 20))
+            {
+                mfxU64 offset = bAfterSlice ? unit.Offset : auOffset;
+                bool bHasHeaders = !bAfterSlice && bAuHasHeaders;
+
+                if (chunks.size() < numChunks && offset > chunks.back().Offset &&
+                    offset >= fileSize * chunks.size() / numChunks)
+                {
+                    TranscodeChunk chunk;
+                    chunk.Offset = offset;
+                    if (!bHasHeaders)
+                    {
+                        for (const ParamSet &h : headers)
+                            chunk.Headers.insert(chunk.Headers.end(), h.Data.begin(), h.Data.end());
+                    }
+                    chunks.push_back(chunk);
+                }
+            }
+            bAfterSlice = true;
+            break;
+        }
+        case UNIT_LEADING:
+        case UNIT_LEADING_RADL:
+        case UNIT_PICTURE:
+        case UNIT_SLICE:
+            bAfterSlice = true;
+            break;
+        default:
+            break;
+        }
+    };
+
+    CAnnexBScanner scanner(codecId, onUnit, onHeader);
+    std::vector<mfxU8> buffer(1024 * 1024);
+
+    for (;;)
+    {
+        size_t n = fread(buffer.data(), 1, buffer.size(), file);
+        if (!n)
+            break;
+
+        scanner.Scan(buffer.data(), n);
+
+        // all split points are found, the rest of the file is not needed
+        if (chunks.size() == numChunks)
+            break;
+    }
+
+    fclose(file);
+
+    for (size_t k = 0; k < chunks.size(); k++)
+    {
+        mfxU64 end = (k + 1 < chunks.size()) ? chunks[k + 1].Offset : fileSize;
+        chunks[k].Size = end - chunks[k].Offset;
+    }
+
+    return MFX_ERR_NONE;
+}
+
+mfxStatus TranscodingSample::StitchChunks(const msdk_char *strDstFile, const std::vector<msdk_string> &parts)
+{
+    MSDK_CHECK_POINTER(strDstFile, MFX_ERR_NULL_PTR);
+
+    FILE *dst = NULL;
+    MSDK_FOPEN(dst, strDstFile, MSDK_STRING("wb"));
+    MSDK_CHECK_POINTER(dst, MFX_ERR_NULL_PTR);
+
+    std::vector<mfxU8> buffer(1024 * 1024);
+    mfxStatus sts = MFX_ERR_NONE;
+
+    for (const msdk_string &part : parts)
+    {
+        FILE *src = NULL;
+        MSDK_FOPEN(src, part.c_str(), MSDK_STRING("rb"));
+        if (!src)
+        {
+            msdk_printf(MSDK_STRING("error: failed to open chunk output %s\n"), part.c_str());
+            sts = MFX_ERR_NULL_PTR;
+            break;
+        }
+
+        size_t n;
+        while ((n = fread(buffer.data(), 1, buffer.size(), src)) > 0)
+        {
+            if (fwrite(buffer.data(), 1, n, dst) != n)
+            {
+                sts = MFX_ERR_UNDEFINED_BEHAVIOR;
+                break;
+            }
+        }
+        fclose(src);
+
+        if (sts != MFX_ERR_NONE)
+            break;
+        CHUNK_REMOVE(part.c_str());
+    }
+
+    fclose(dst);
+    return sts;
+}
+
+CChunkBitstreamReader::CChunkBitstreamReader(const TranscodeChunk &chunk)
+    : m_chunk(chunk)
+    , m_nHeadersSent(0)
+    , m_nBytesLeft(chunk.Size)
+{
+}
+
+void CChunkBitstreamReader::Reset()
+{
+    if (!m_bInited)
+        return;
+
+    CHUNK_FSEEK(m_fSource, m_chunk.Offset, SEEK_SET);
+    m_nHeadersSent = 0;
+    m_nBytesLeft = m_chunk.Size;
+}
+
+mfxStatus CChunkBitstreamReader::Init(const msdk_char *strFileName)
+{
+    mfxStatus sts = CSmplBitstreamReader::Init(strFileName);
+    MSDK_CHECK_STATUS(sts, "CSmplBitstreamReader::Init failed");
+
+    Reset();
+    return MFX_ERR_NONE;
+}
+
+mfxStatus CChunkBitstreamReader::ReadNextFrame(mfxBitstream *pBS)
+{
+    if (!m_bInited)
+        return MFX_ERR_NOT_INITIALIZED;
+
+    MSDK_CHECK_POINTER(pBS, MFX_ERR_NULL_PTR);
+
+    // Not enough memory to read new chunk of data
+    if (pBS->MaxLength == pBS->DataLength)
+        return MFX_ERR_NOT_ENOUGH_BUFFER;
+
+    memmove(pBS->Data, pBS->Data + pBS->DataOffset, pBS->DataLength);
+    pBS->DataOffset = 0;
+
+    mfxU32 nFree = pBS->MaxLength - pBS->DataLength;
+    mfxU32 nBytesRead = 0;
+
+    if (m_nHeadersSent < m_chunk.Headers.size())
+    {
+        nBytesRead = (mfxU32)std::min<size_t>(nFree, m_chunk.Headers.size() - m_nHeadersSent);
+        std::copy_n(m_chunk.Headers.begin() + m_nHeadersSent, nBytesRead, pBS->Data + pBS->DataLength);
+        m_nHeadersSent += nBytesRead;
+    }
+    else if (m_nBytesLeft)
+    {
+        nBytesRead = (mfxU32)fread(pBS->Data + pBS->DataLength, 1, (size_t)std::min<mfxU64>(nFree, m_nBytesLeft), m_fSource);
+        m_nBytesLeft = nBytesRead ? m_nBytesLeft - nBytesRead : 0;
+    }
+
+    if (m_nHeadersSent == m_chunk.Headers.size() && !m_nBytesLeft)
+    {
+        pBS->DataFlag |= MFX_BITSTREAM_EOS;
+    }
+
+    if (0 == nBytesRead)
+    {
+        return MFX_ERR_MORE_DATA;
+    }
+
+    pBS->DataLength += nBytesRead;
+
+    return MFX_ERR_NONE;
+}
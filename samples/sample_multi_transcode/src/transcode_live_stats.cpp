@@ -0,0 +1,373 @@
+/******************************************************************************\
+Copyright (c) 2020, Intel Corporation
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+This sample was distributed or derived from the Intel's Media Samples package.
+The original version of this sample may be obtained from https://software.intel.com/en-us/intel-media-server-studio
+or https://software.intel.com/en-us/media-client-solutions-support.
+\**********************************************************************************/
+
+
+#include "transcode_live_stats.h"
+#include "sample_defs.h"
+
+#include <new>
+
+// bionic has no POSIX shared memory, Android builds get the stubs
+#if !defined(_WIN32) && !defined(_WIN64) && !defined(ANDROID)
+#define LIVE_STATS_SHM
+#endif
+
+#if defined(LIVE_STATS_SHM)
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace TranscodingSample;
+
+#define LIVE_STATS_MAGIC   0x5453564C // "LVST"
+#define LIVE_STATS_VERSION 1
+
+#if defined(ATOMIC_LLONG_LOCK_FREE)
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2 && ATOMIC_INT_LOCK_FREE == 2,
+              "shared memory counters must be lock-free");
+#endif
+
+CLiveStatistics::CLiveStatistics()
+    : m_pHeader(NULL)
+    , m_pSessions(NULL)
+    , m_size(0)
+    , m_bOwner(false)
+{
+}
+
+CLiveStatistics::~CLiveStatistics()
+{
+    Close();
+}
+
+#if defined(LIVE_STATS_SHM)
+
+static msdk_string GetSegmentName(const msdk_char *name)
+{
+    // POSIX shared memory object names start with a single slash
+    msdk_string segment(name);
+    if (segment.empty() || segment[0] != '/')
+        segment.insert(0, 1, '/');
+    return segment;
+}
+
+mfxStatus CLiveStatistics::Create(const msdk_char *name, mfxU32 numSessions)
+{
+    MSDK_CHECK_POINTER(name, MFX_ERR_NULL_PTR);
+    MSDK_CHECK_ERROR(numSessions, 0, MFX_ERR_NOT_INITIALIZED);
+
+    Close();
+
+    m_name = GetSegmentName(name);
+    m_size = sizeof(LiveStatsHeader) + numSessions * sizeof(LiveStatsSession);
+
+    // never reuse an existing segment: a running instance may have it mapped,
+    // and truncating it under that instance would crash it with SIGBUS
+    int fd = shm_open(m_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0)
+    {
+        if (EEXIST == errno)
+            msdk_printf(MSDK_STRING("error: live statistics \"%s\" already exist, choose another name or remove /dev/shm%s if no transcoding uses it\n"),
+                m_name.c_str(), m_name.c_str());
+        else
+            msdk_printf(MSDK_STRING("error: failed to create shared memory \"%s\"\n"), m_name.c_str());
+        return MFX_ERR_UNKNOWN;
+    }
+
+    void *ptr = MAP_FAILED;
+    if (0 == ftruncate(fd, (off_t)m_size))
+        ptr = mmap(NULL, m_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (MAP_FAILED == ptr)
+    {
+        shm_unlink(m_name.c_str());
+        msdk_printf(MSDK_STRING("error: failed to map shared memory \"%s\"\n"), m_name.c_str());
+        return MFX_ERR_MEMORY_ALLOC;
+    }
+
+    m_bOwner    = true;
+    m_pHeader   = new (ptr) LiveStatsHeader();
+    m_pSessions = reinterpret_cast<LiveStatsSession*>(m_pHeader + 1);
+
+    for (mfxU32 i = 0; i < numSessions; i++)
+    {
+        LiveStatsSession *pSession = new (m_pSessions + i) LiveStatsSession();
+        pSession->FramesIn = pSession->FramesOut = 0;
+        pSession->DecodeTime = pSession->VppTime = pSession->EncodeTime = 0;
+        pSession->SyncWaits = pSession->SyncWaitTime = 0;
+        pSession->DecPoolUsed = pSession->DecPoolSize = 0;
+        pSession->EncPoolUsed = pSession->EncPoolSize = 0;
+        pSession->OutputQueue = pSession->Active = 0;
+    }
+
+    m_pHeader->NumSessions = numSessions;
+    m_pHeader->ProcessId   = (mfxU32)getpid();
+    m_pHeader->StartTime   = (mfxU64)msdk_time_get_tick();
+    m_pHeader->Frequency   = (mfxU64)msdk_time_get_frequency();
+    m_pHeader->Version     = LIVE_STATS_VERSION;
+    // magic is written last, so readers never see half initialized segment
+    std::atomic_thread_fence(std::memory_order_release);
+    m_pHeader->Magic       = LIVE_STATS_MAGIC;
+
+    return MFX_ERR_NONE;
+}
+
+mfxStatus CLiveStatistics::Open(const msdk_char *name)
+{
+    MSDK_CHECK_POINTER(name, MFX_ERR_NULL_PTR);
+
+    Close();
+
+    m_name = GetSegmentName(name);
+
+    int fd = shm_open(m_name.c_str(), O_RDONLY, 0);
+    if (fd < 0)
+        return MFX_ERR_NOT_FOUND;
+
+    struct stat st;
+    void *ptr = MAP_FAILED;
+    if (0 == fstat(fd, &st) && (size_t)st.st_size >= sizeof(LiveStatsHeader))
+    {
+        m_size = (size_t)st.st_size;
+        ptr = mmap(NULL, m_size, PROT_READ, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+
+    if (MAP_FAILED == ptr)
+        return MFX_ERR_NOT_FOUND;
+
+    m_pHeader   = reinterpret_cast<LiveStatsHeader*>(ptr);
+    m_pSessions = reinterpret_cast<LiveStatsSession*>(m_pHeader + 1);
+
+    if (m_pHeader->Magic != LIVE_STATS_MAGIC || m_pHeader->Version != LIVE_STATS_VERSION ||
+        m_size < sizeof(LiveStatsHeader) + m_pHeader->NumSessions * sizeof(LiveStatsSession))
+    {
+        Close();
+        return MFX_ERR_INCOMPATIBLE_VIDEO_PARAM;
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    return MFX_ERR_NONE;
+}
+
+void CLiveStatistics::Close()
+{
+    if (m_pHeader)
+    {
+        munmap(m_pHeader, m_size);
+        if (m_bOwner)
+            shm_unlink(m_name.c_str());
+    }
+
+    m_pHeader   = NULL;
+    m_pSessions = NULL;
+    m_size      = 0;
+    m_bOwner    = false;
+}
+
+mfxStatus CLiveStatistics::Monitor(const msdk_char *name, mfxU32 intervalMs)
+{
+    CLiveStatistics stats;
+    mfxStatus sts = stats.Open(name);
+    if (MFX_ERR_NONE != sts)
+    {
+        msdk_printf(MSDK_STRING("error: no live statistics \"%s\" found\n"), name);
+        return sts;
+    }
+
+    // the writer unlinks the segment when transcoding ends
+    for (;;)
+    {
+        stats.PrintTable(stdout);
+        fflush(stdout);
+
+        MSDK_SLEEP(intervalMs);
+
+        int fd = shm_open(stats.m_name.c_str(), O_RDONLY, 0);
+        if (fd < 0)
+            break;
+        close(fd);
+    }
+
+    msdk_printf(MSDK_STRING("live statistics \"%s\" closed\n"), name);
+    return MFX_ERR_NONE;
+}
+
+mfxStatus CLiveStatistics::Export(const msdk_char *name)
+{
+    CLiveStatistics stats;
+    mfxStatus sts = stats.Open(name);
+    if (MFX_ERR_NONE != sts)
+    {
+        msdk_printf(MSDK_STRING("error: no live statistics \"%s\" found\n"), name);
+        return sts;
+    }
+
+    stats.PrintPrometheus(stdout);
+    return MFX_ERR_NONE;
+}
+
+#else // Windows and Android
+
+mfxStatus CLiveStatistics::Create(const msdk_char *, mfxU32)
+{
+    return MFX_ERR_UNSUPPORTED;
+}
+
+mfxStatus CLiveStatistics::Open(const msdk_char *)
+{
+    return MFX_ERR_UNSUPPORTED;
+}
+
+void CLiveStatistics::Close()
+{
+}
+
+mfxStatus CLiveStatistics::Monitor(const msdk_char *, mfxU32)
+{
+    return MFX_ERR_UNSUPPORTED;
+}
+
+mfxStatus CLiveStatistics::Export(const msdk_char *)
+{
+    return MFX_ERR_UNSUPPORTED;
+}
+
+#endif
+
+LiveStatsSession* CLiveStatistics::GetSession(mfxU32 idx)
+{
+    if (!m_pHeader || idx >= m_pHeader->NumSessions)
+        return NULL;
+    return m_pSessions + idx;
+}
+
+static mfxF64 TicksToMs(mfxU64 ticks, mfxU64 frequency)
+{
+    return frequency ? 1000.0 * (mfxF64)ticks / (mfxF64)frequency : 0.0;
+}
+
+void CLiveStatistics::PrintTable(FILE *file)
+{
+    if (!m_pHeader || !file)
+        return;
+
+    const mfxU64 freq    = m_pHeader->Frequency;
+    const mfxF64 elapsed = TicksToMs((mfxU64)msdk_time_get_tick() - m_pHeader->StartTime, freq) / 1000.0;
+
+    fprintf(file, "pid %u, %.1f sec\n", m_pHeader->ProcessId, elapsed);
+    fprintf(file, "%4s %6s %10s %10s %8s %9s %9s %9s %9s %9s %9s %5s\n",
+        "id", "active", "in", "out", "fps", "dec,ms", "vpp,ms", "enc,ms", "sync,ms", "dec_pool", "enc_pool", "queue");
+
+    for (mfxU32 i = 0; i < m_pHeader->NumSessions; i++)
+    {
+        const LiveStatsSession &s = m_pSessions[i];
+        const mfxU64 in  = s.FramesIn.load(std::memory_order_relaxed);
+        const mfxU64 out = s.FramesOut.load(std::memory_order_relaxed);
+        const mfxU64 syncs = s.SyncWaits.load(std::memory_order_relaxed);
+
+        // per-stage times are averages per frame
+        fprintf(file, "%4u %6u %10llu %10llu %8.2f %9.3f %9.3f %9.3f %9.3f %4u/%-4u %4u/%-4u %5u\n",
+            i, s.Active.load(std::memory_order_relaxed),
+            (unsigned long long)in, (unsigned long long)out,
+            elapsed > 0 ? out / elapsed : 0.0,
+            in  ? TicksToMs(s.DecodeTime.load(std::memory_order_relaxed), freq) / in : 0.0,
+            out ? TicksToMs(s.VppTime.load(std::memory_order_relaxed), freq) / out : 0.0,
+            out ? TicksToMs(s.EncodeTime.load(std::memory_order_relaxed), freq) / out : 0.0,
+            syncs ? TicksToMs(s.SyncWaitTime.load(std::memory_order_relaxed), freq) / syncs : 0.0,
+            s.DecPoolUsed.load(std::memory_order_relaxed), s.DecPoolSize.load(std::memory_order_relaxed),
+            s.EncPoolUsed.load(std::memory_order_relaxed), s.EncPoolSize.load(std::memory_order_relaxed),
+            s.OutputQueue.load(std::memory_order_relaxed));
+    }
+    fprintf(file, "\n");
+}
+
+void CLiveStatistics::PrintPrometheus(FILE *file)
+{
+    if (!m_pHeader || !file)
+        return;
+
+    const mfxU64 freq = m_pHeader->Frequency;
+
+    struct Metric
+    {
+        const char *name;
+        const char *type;
+        const char *help;
+    };
+    static const Metric metrics[] =
+    {
+        { "msdk_transcode_active",                 "gauge",   "1 while the session is running" },
+        { "msdk_transcode_frames_in_total",        "counter", "Frames received from decoder" },
+        { "msdk_transcode_frames_out_total",       "counter", "Frames passed to the output" },
+        { "msdk_transcode_decode_seconds_total",   "counter", "Time spent in decode calls" },
+        { "msdk_transcode_vpp_seconds_total",      "counter", "Time spent in VPP calls" },
+        { "msdk_transcode_encode_seconds_total",   "counter", "Time spent in encode calls" },
+        { "msdk_transcode_sync_waits_total",       "counter", "SyncOperation calls on output" },
+        { "msdk_transcode_sync_wait_seconds_total","counter", "Time spent waiting in SyncOperation" },
+        { "msdk_transcode_dec_pool_used",          "gauge",   "Locked surfaces in decoder pool" },
+        { "msdk_transcode_dec_pool_size",          "gauge",   "Surfaces in decoder pool" },
+        { "msdk_transcode_enc_pool_used",          "gauge",   "Locked surfaces in encoder pool" },
+        { "msdk_transcode_enc_pool_size",          "gauge",   "Surfaces in encoder pool" },
+        { "msdk_transcode_output_queue",           "gauge",   "Bitstreams waiting for synchronization" },
+    };
+
+    for (mfxU32 m = 0; m < sizeof(metrics) / sizeof(metrics[0]); m++)
+    {
+        fprintf(file, "# HELP %s %s\n", metrics[m].name, metrics[m].help);
+        fprintf(file, "# TYPE %s %s\n", metrics[m].name, metrics[m].type);
+
+        for (mfxU32 i = 0; i < m_pHeader->NumSessions; i++)
+        {
+            const LiveStatsSession &s = m_pSessions[i];
+            // frame and call counts and pool gauges are exact integers, only times are fractional
+            mfxU64 count  = 0;
+            mfxU64 ticks  = 0;
+            bool   bTicks = false;
+
+            switch (m)
+            {
+            case 0:  count = s.Active.load(std::memory_order_relaxed); break;
+            case 1:  count = s.FramesIn.load(std::memory_order_relaxed); break;
+            case 2:  count = s.FramesOut.load(std::memory_order_relaxed); break;
+            case 3:  ticks = s.DecodeTime.load(std::memory_order_relaxed); bTicks = true; break;
+            case 4:  ticks = s.VppTime.load(std::memory_order_relaxed); bTicks = true; break;
+            case 5:  ticks = s.EncodeTime.load(std::memory_order_relaxed); bTicks = true; break;
+            case 6:  count = s.SyncWaits.load(std::memory_order_relaxed); break;
+            case 7:  ticks = s.SyncWaitTime.load(std::memory_order_relaxed); bTicks = true; break;
+            case 8:  count = s.DecPoolUsed.load(std::memory_order_relaxed); break;
+            case 9:  count = s.DecPoolSize.load(std::memory_order_relaxed); break;
+            case 10: count = s.EncPoolUsed.load(std::memory_order_relaxed); break;
+            case 11: count = s.EncPoolSize.load(std::memory_order_relaxed); break;
+            case 12: count = s.OutputQueue.load(std::memory_order_relaxed); break;
+            }
+
+            if (bTicks)
+                fprintf(file, "%s{pid=\"%u\",session=\"%u\"} %.6f\n", metrics[m].name, m_pHeader->ProcessId, i,
+                    TicksToMs(ticks, freq) / 1000.0);
+            else
+                fprintf(file, "%s{pid=\"%u\",session=\"%u\"} %llu\n", metrics[m].name, m_pHeader->ProcessId, i,
+                    (unsigned long long)count);
+        }
+    }
+}
@@ -115,6 +115,12 @@ void TranscodingSample::PrintHelp()
     msdk_printf(MSDK_STRING("  -stat-per-frame <name>\n"));
     msdk_printf(MSDK_STRING("                Output per-frame latency values to a file (opened in append mode). The file name will be for an input sesssion: <name>_input_ID_<N>.log\n"));
     msdk_printf(MSDK_STRING("                or, for output session: <name>_output_ID_<N>.log; <N> - a number of a session.\n"));
+    msdk_printf(MSDK_STRING("  -stat-live <name>\n"));
+    msdk_printf(MSDK_STRING("                Publish live per-session counters in shared memory object <name>\n"));
+    msdk_printf(MSDK_STRING("  -stat-live-show <name>\n"));
+    msdk_printf(MSDK_STRING("                Print counters of a running transcoding published with -stat-live <name> every second and exit\n"));
+    msdk_printf(MSDK_STRING("  -stat-live-prometheus <name>\n"));
+    msdk_printf(MSDK_STRING("                Print counters published with -stat-live <name> once in Prometheus text format and exit\n"));
 
     msdk_printf(MSDK_STRING("Options:\n"));
     //                     ("  ............xx
@@ -198,6 +204,24 @@ void TranscodingSample::PrintHelp()
     msdk_printf(MSDK_STRING("  -join         Join session with other session(s), by default sessions are not joined\n"));
     msdk_printf(MSDK_STRING("  -priority     Use priority for join sessions. 0 - Low, 1 - Normal, 2 - High. Normal by default\n"));
     msdk_printf(MSDK_STRING("  -threads num  Number of session internal threads to create\n"));
+#if (MFX_VERSION >= MFX_VERSION_NEXT)
+    msdk_printf(MSDK_STRING("  -numa_node <N>\n"));
+    msdk_printf(MSDK_STRING("                Bind session internal threads and system memory surfaces to NUMA node N\n"));
+    msdk_printf(MSDK_STRING("  -cpu_set <list>\n"));
+    msdk_printf(MSDK_STRING("                Bind session internal threads to logical CPUs from the list, like 0-9,20-29\n"));
+    msdk_printf(MSDK_STRING("  -deadline <us>\n"));
+    msdk_printf(MSDK_STRING("                Schedule session tasks earliest deadline first, a frame is due <us> microseconds after its time stamp.\n"));
+    msdk_printf(MSDK_STRING("                Numbers of tasks with deadlines and of missed ones are printed when the session closes.\n"));
+    msdk_printf(MSDK_STRING("                Use with -join to give live sessions precedence over batch ones sharing the threads\n"));
+#endif
+    msdk_printf(MSDK_STRING("  -chunks <N>   Split AVC/HEVC input at IDR pictures into N chunks, transcode them in parallel sessions\n"));
+    msdk_printf(MSDK_STRING("                and stitch outputs of the chunks in order into the destination file\n"));
+    msdk_printf(MSDK_STRING("  -chunk_hrd:<on,off>\n"));
+    msdk_printf(MSDK_STRING("                Keep (default) or disable NAL HRD conformance and VUI HRD parameters of chunk encoders.\n"));
+    msdk_printf(MSDK_STRING("                Every chunk starts a new buffering period, so HRD state is not continuous across chunks\n"));
+    msdk_printf(MSDK_STRING("  -chunk_init_delay <KB>\n"));
+    msdk_printf(MSDK_STRING("                Initial HRD buffer fullness of chunks following the first one, i.e. the level\n"));
+    msdk_printf(MSDK_STRING("                the previous chunk is expected to end at. By default each chunk uses -InitialDelayInKB\n"));
     msdk_printf(MSDK_STRING("  -n            Number of frames to transcode\n") \
         MSDK_STRING("                  (session ends after this number of frames is reached). \n") \
         MSDK_STRING("                In decoding sessions (-o::sink) this parameter limits number\n") \
@@ -633,6 +657,42 @@ mfxStatus CmdProcessor::ParseCmdLine(int argc, msdk_char *argv[])
             }
             DumpLogFileName = argv[0];
         }
+        else if (0 == msdk_strcmp(argv[0], MSDK_STRING("-stat-live")))
+        {
+            --argc;
+            ++argv;
+            if (!argv[0])
+            {
+                msdk_printf(MSDK_STRING("error: no argument given for 'stat-live' option\n"));
+                return MFX_ERR_UNSUPPORTED;
+            }
+            LiveStatsName = argv[0];
+        }
+        else if (0 == msdk_strcmp(argv[0], MSDK_STRING("-stat-live-show")))
+        {
+            --argc;
+            ++argv;
+            if (!argv[0])
+            {
+                msdk_printf(MSDK_STRING("error: no argument given for 'stat-live-show' option\n"));
+                return MFX_ERR_UNSUPPORTED;
+            }
+            // like -?, a successful run means the sample exits without transcoding
+            mfxStatus sts = CLiveStatistics::Monitor(argv[0], 1000);
+            return (MFX_ERR_NONE == sts) ? MFX_WRN_OUT_OF_RANGE : sts;
+        }
+        else if (0 == msdk_strcmp(argv[0], MSDK_STRING("-stat-live-prometheus")))
+        {
+            --argc;
+            ++argv;
+            if (!argv[0])
+            {
+                msdk_printf(MSDK_STRING("error: no argument given for 'stat-live-prometheus' option\n"));
+                return MFX_ERR_UNSUPPORTED;
+            }
+            mfxStatus sts = CLiveStatistics::Export(argv[0]);
+            return (MFX_ERR_NONE == sts) ? MFX_WRN_OUT_OF_RANGE : sts;
+        }
         else
         {
             break;
@@ -954,6 +1014,49 @@ bool ArgConvert(msdk_char* pIn, mfxU32 argn, const msdk_char* pattern, T* pArg,
     return bConvertIsOk;
 }
 
+#if (MFX_VERSION >= MFX_VERSION_NEXT)
+// parses list of logical CPUs like "0-9,20-29", bit i%32 of mask[i/32] is set for CPU i
+static bool ParseCpuSet(const msdk_char* str, mfxU32* mask, mfxU32 maskSize)
+{
+    auto readNumber = [&str](mfxU32& value)
+    {
+        if (*str < msdk_char('0') || *str > msdk_char('9'))
+            return false;
+        for (value = 0; *str >= msdk_char('0') && *str <= msdk_char('9'); ++str)
+            value = value * 10 + (*str - msdk_char('0'));
+        return true;
+    };
+
+    std::fill(mask, mask + maskSize, 0);
+
+    while (*str)
+    {
+        mfxU32 first = 0, last = 0;
+        if (!readNumber(first))
+            return false;
+        last = first;
+        if (*str == msdk_char('-'))
+        {
+            ++str;
+            if (!readNumber(last))
+                return false;
+        }
+        if (first > last || last >= maskSize * 32)
+            return false;
+
+        for (mfxU32 cpu = first; cpu <= last; cpu++)
+            mask[cpu / 32] |= 1u << (cpu % 32);
+
+        if (*str == msdk_char(','))
+            ++str;
+        else if (*str)
+            return false;
+    }
+
+    return true;
+}
+#endif
+
 //template <typename T=msdk_string>
 bool ArgConvert(msdk_char* pIn, mfxU32 argn, const msdk_char* pattern, msdk_char* pArg, mfxU32 MaxChars2Read, mfxU32& NumOfGoodConverts) {
     bool bConvertIsOk = false;
@@ -1803,6 +1906,68 @@ mfxStatus CmdProcessor::ParseParamsForOneSession(mfxU32 argc, msdk_char *argv[])
                 return MFX_ERR_UNSUPPORTED;
             }
         }
+        else if (0 == msdk_strcmp(argv[i], MSDK_STRING("-chunks")))
+        {
+            VAL_CHECK(i+1 == argc, i, argv[i]);
+            i++;
+            if (MFX_ERR_NONE != msdk_opt_read(argv[i], InputParams.nChunks))
+            {
+                PrintError(MSDK_STRING("Number of chunks is invalid"));
+                return MFX_ERR_UNSUPPORTED;
+            }
+        }
+        else if (0 == msdk_strcmp(argv[i], MSDK_STRING("-chunk_hrd:on")))
+        {
+            InputParams.nChunkHrd = MFX_CODINGOPTION_ON;
+        }
+        else if (0 == msdk_strcmp(argv[i], MSDK_STRING("-chunk_hrd:off")))
+        {
+            InputParams.nChunkHrd = MFX_CODINGOPTION_OFF;
+        }
+        else if (0 == msdk_strcmp(argv[i], MSDK_STRING("-chunk_init_delay")))
+        {
+            VAL_CHECK(i+1 == argc, i, argv[i]);
+            i++;
+            if (MFX_ERR_NONE != msdk_opt_read(argv[i], InputParams.nChunkInitDelay))
+            {
+                PrintError(MSDK_STRING("Chunk initial delay is invalid"));
+                return MFX_ERR_UNSUPPORTED;
+            }
+        }
+#if (MFX_VERSION >= MFX_VERSION_NEXT)
+        else if (0 == msdk_strcmp(argv[i], MSDK_STRING("-numa_node")))
+        {
+            VAL_CHECK(i+1 == argc, i, argv[i]);
+            i++;
+            if (MFX_ERR_NONE != msdk_opt_read(argv[i], InputParams.nNumaNode))
+            {
+                PrintError(MSDK_STRING("NUMA node is invalid"));
+                return MFX_ERR_UNSUPPORTED;
+            }
+            // 0 means no binding in mfxExtThreadsParam
+            InputParams.nNumaNode++;
+        }
+        else if (0 == msdk_strcmp(argv[i], MSDK_STRING("-deadline")))
+        {
+            VAL_CHECK(i+1 == argc, i, argv[i]);
+            i++;
+            if (MFX_ERR_NONE != msdk_opt_read(argv[i], InputParams.nFrameDeadline))
+            {
+                PrintError(MSDK_STRING("Frame deadline is invalid"));
+                return MFX_ERR_UNSUPPORTED;
+            }
+        }
+        else if (0 == msdk_strcmp(argv[i], MSDK_STRING("-cpu_set")))
+        {
+            VAL_CHECK(i+1 == argc, i, argv[i]);
+            i++;
+            if (!ParseCpuSet(argv[i], InputParams.CpuMask, MSDK_ARRAY_LEN(InputParams.CpuMask)))
+            {
+                PrintError(MSDK_STRING("CPU set \"%s\" is invalid"), argv[i]);
+                return MFX_ERR_UNSUPPORTED;
+            }
+        }
+#endif
         else if(0 == msdk_strcmp(argv[i], MSDK_STRING("-f")))
         {
             VAL_CHECK(i+1 == argc, i, argv[i]);
@@ -2965,6 +3130,30 @@ mfxStatus CmdProcessor::VerifyAndCorrectInputParams(TranscodingSample::sInputPar
 
     }
 
+    if (InputParams.nChunks > 1)
+    {
+        if (InputParams.eMode != Native || InputParams.eModeExt != Native)
+        {
+            PrintError(MSDK_STRING("-chunks can be used only in sessions with both decoder and encoder\n"));
+            return MFX_ERR_UNSUPPORTED;
+        }
+        if (InputParams.DecodeId != MFX_CODEC_AVC && InputParams.DecodeId != MFX_CODEC_HEVC)
+        {
+            PrintError(MSDK_STRING("-chunks supports only h264 and h265 input\n"));
+            return MFX_ERR_UNSUPPORTED;
+        }
+        if (InputParams.EncodeId == MFX_CODEC_VP9)
+        {
+            PrintError(MSDK_STRING("-chunks doesn't support IVF output\n"));
+            return MFX_ERR_UNSUPPORTED;
+        }
+        if (InputParams.MaxFrameNumber != MFX_INFINITE)
+        {
+            PrintError(MSDK_STRING("-chunks can't be combined with -n\n"));
+            return MFX_ERR_UNSUPPORTED;
+        }
+    }
+
     if(InputParams.EncoderFourCC && InputParams.eMode == Sink)
     {
         msdk_printf(MSDK_STRING("WARNING: -ec option is used in session without encoder, this parameter will be ignored \n"));
@@ -3008,12 +3197,14 @@ mfxStatus CmdProcessor::VerifyAndCorrectInputParams(TranscodingSample::sInputPar
 
     mfxU16 mfxU16Limit = std::numeric_limits<mfxU16>::max();
     if (InputParams.MaxKbps > mfxU16Limit || InputParams.nBitRate > mfxU16Limit ||
-        InputParams.InitialDelayInKB > mfxU16Limit || InputParams.BufferSizeInKB > mfxU16Limit)
+        InputParams.InitialDelayInKB > mfxU16Limit || InputParams.BufferSizeInKB > mfxU16Limit ||
+        InputParams.nChunkInitDelay > mfxU16Limit)
     {
         mfxU32 maxVal = std::max<mfxU32>({ InputParams.MaxKbps,
                                            InputParams.nBitRate,
                                            InputParams.InitialDelayInKB,
-                                           InputParams.BufferSizeInKB });
+                                           InputParams.BufferSizeInKB,
+                                           InputParams.nChunkInitDelay });
         InputParams.nBitRateMultiplier = (mfxU16)std::ceil(static_cast<double>(maxVal) / mfxU16Limit);
         msdk_printf(MSDK_STRING("WARNING: BitRateMultiplier(-bm) was updated, new value: %d. \n"), InputParams.nBitRateMultiplier);
 
@@ -3032,6 +3223,7 @@ mfxStatus CmdProcessor::VerifyAndCorrectInputParams(TranscodingSample::sInputPar
         recalculate(InputParams.nBitRate, MSDK_STRING("nBitRate(-b)"));
         recalculate(InputParams.InitialDelayInKB, MSDK_STRING("InitialDelayInKB"));
         recalculate(InputParams.BufferSizeInKB, MSDK_STRING("BufferSizeInKB"));
+        recalculate(InputParams.nChunkInitDelay, MSDK_STRING("chunk_init_delay"));
     }
 
     return MFX_ERR_NONE;
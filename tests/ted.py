@@ -25,7 +25,7 @@ import sys
 import argparse
 from pathlib import Path
 
-from ted import discover
+from ted import discover, perf
 
 
 if __name__ == '__main__':
@@ -43,6 +43,34 @@ if __name__ == '__main__':
         '--device', action='store', default='/dev/dri/renderD128',
         help='provide device on which to run tests (default: /dev/dri/renderD128)'
     )
+    parser.add_argument(
+        '--suite', action='store', default='tests',
+        help='folder with test definitions (default: tests, CPU-only set: perf_cpu)'
+    )
+    parser.add_argument(
+        '--perf', action='store_true',
+        help='measure performance of passed cases and compare it with baseline'
+    )
+    parser.add_argument(
+        '--perf-runs', action='store', type=int, default=3,
+        help='number of measured runs per case, median is reported (default: 3)'
+    )
+    parser.add_argument(
+        '--perf-db', action='store', default=None,
+        help='SQLite database with performance results (default: results/perf.db)'
+    )
+    parser.add_argument(
+        '--perf-tag', action='store', default='',
+        help='label of this run in performance database'
+    )
+    parser.add_argument(
+        '--tolerance', action='store', type=float, default=5.0,
+        help='allowed performance deviation from baseline in percents (default: 5)'
+    )
+    parser.add_argument(
+        '--save-baseline', action='store_true',
+        help='store measured performance as new baseline'
+    )
 
     args = parser.parse_args()
 
@@ -76,11 +104,17 @@ if __name__ == '__main__':
     n = len(tests_to_run)
     print("\nRunning {} test{}...".format(n, 's' if n > 1 else ''))
 
+    db = comparison = None
+    if args.perf:
+        db = perf.Database(Path(args.perf_db) if args.perf_db else base_dir / 'results' / 'perf.db')
+        db.start_run(args.perf_tag, cfg.environment)
+        comparison = perf.Comparison(args.tolerance)
+
     results = []
     total = passed = 0
     for test in tests_to_run:
         print('  {}'.format(test.name))
-        total_, passed_, details = test.run()
+        total_, passed_, details = test.run(db, comparison)
 
         results.append(details)
 
@@ -90,5 +124,12 @@ if __name__ == '__main__':
 
     print("\n{} of {} cases passed".format(passed, total))
 
-    # return code is number of failed cases
-    sys.exit(total - passed)
+    regressions = 0
+    if args.perf:
+        regressions = comparison.report()
+        if args.save_baseline:
+            db.save_baseline()
+            print("Baseline is updated")
+
+    # return code is number of failed cases and performance regressions
+    sys.exit(total - passed + regressions)
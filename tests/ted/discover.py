@@ -29,7 +29,7 @@ from . import test, configuration
 def tests(base_dir, cfg, args):
     base_dir = pathlib.Path(base_dir)
 
-    for fn in (base_dir / 'tests').rglob("*.json"):
+    for fn in (base_dir / args.suite).rglob("*.json"):
         try:
             yield test.Test(fn, base_dir, cfg, args)
         except Exception as ex:
@@ -0,0 +1,227 @@
+# -*- coding: utf-8 -*-
+
+# Copyright (c) 2020 Intel Corporation
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+
+import os
+import re
+import time
+import sqlite3
+import datetime
+import statistics
+import subprocess
+import collections
+
+
+# metric name -> True if bigger value is better
+METRICS = collections.OrderedDict([
+    ('fps', True),
+    ('wall_time', False),
+    ('user_time', False),
+    ('sys_time', False),
+    ('peak_rss', False),
+])
+
+# absolute differences below these are treated as measurement noise
+_NOISE = {
+    'wall_time': 0.01,
+    'user_time': 0.01,
+    'sys_time': 0.01,
+}
+
+# sample_* progress and summary lines, the last match wins
+_SAMPLE_STATS = [
+    # sample_decode
+    (re.compile(r'Frame number:\s*(\d+), fps: ([\d.]+)'), ('frames', 'fps')),
+    # sample_encode, sample_vpp
+    (re.compile(r'Frame number:\s*(\d+)\s*$'), ('frames',)),
+    (re.compile(r'Encoding fps:\s*([\d.]+)'), ('fps',)),
+    (re.compile(r'Frames per second ([\d.]+) fps'), ('fps',)),
+]
+
+# sample_multi_transcode reports every session separately
+_SESSION_STATS = re.compile(r'\*\*\* session .* ([\d.]+) sec, (\d+) frames, ([\d.]+) fps')
+
+
+def parse_sample_stats(output):
+    stats = {}
+    sessions = []
+
+    for line in re.split(r'[\r\n]+', output):
+        m = _SESSION_STATS.search(line)
+        if m:
+            sessions.append((float(m.group(2)), float(m.group(3))))
+            continue
+
+        for regex, names in _SAMPLE_STATS:
+            m = regex.search(line)
+            if m:
+                stats.update(zip(names, (float(v) for v in m.groups())))
+                break
+
+    if sessions:
+        # pipeline is as fast as its slowest session
+        stats['frames'] = sum(frames for frames, _ in sessions)
+        stats['fps'] = min(fps for _, fps in sessions)
+
+    return stats
+
+
+def run(cmd, cwd, env):
+    """Runs command and returns (returncode, output, metrics)"""
+    start = time.perf_counter()
+
+    p = subprocess.Popen(
+        cmd,
+        stdout=subprocess.PIPE,
+        stderr=subprocess.STDOUT,
+        cwd=cwd,
+        env=env,
+    )
+    output = p.stdout.read().decode('utf-8', 'replace')
+    p.stdout.close()
+
+    # resource usage of this particular child, not of all children
+    _, status, usage = os.wait4(p.pid, 0)
+    wall_time = time.perf_counter() - start
+    p.returncode = os.WEXITSTATUS(status) if os.WIFEXITED(status) else -os.WTERMSIG(status)
+
+    metrics = collections.OrderedDict()
+    metrics['wall_time'] = wall_time
+    metrics['user_time'] = usage.ru_utime
+    metrics['sys_time'] = usage.ru_stime
+    metrics['peak_rss'] = float(usage.ru_maxrss)  # KiB
+    metrics.update(parse_sample_stats(output))
+
+    return p.returncode, output, metrics
+
+
+def median(runs):
+    """Per-metric median of several runs of the same case"""
+    result = collections.OrderedDict()
+    for name in runs[0]:
+        values = [r[name] for r in runs if name in r]
+        result[name] = statistics.median(values)
+    return result
+
+
+class Database(object):
+    """Metrics of all perf runs and per-case baselines in SQLite file"""
+
+    def __init__(self, fn):
+        fn.parent.mkdir(parents=True, exist_ok=True)
+        self.db = sqlite3.connect(str(fn))
+        self.db.executescript('''
+            CREATE TABLE IF NOT EXISTS runs(
+                id INTEGER PRIMARY KEY, started TEXT, tag TEXT,
+                hostname TEXT, cpu TEXT, os TEXT);
+            CREATE TABLE IF NOT EXISTS metrics(
+                run INTEGER, test TEXT, case_id TEXT, case_key TEXT,
+                name TEXT, value REAL);
+            CREATE TABLE IF NOT EXISTS baselines(
+                test TEXT, case_key TEXT, name TEXT, value REAL, run INTEGER,
+                PRIMARY KEY(test, case_key, name));
+        ''')
+        self.run_id = None
+
+    def start_run(self, tag, environment):
+        cur = self.db.execute(
+            'INSERT INTO runs(started, tag, hostname, cpu, os) VALUES(?, ?, ?, ?, ?)',
+            (str(datetime.datetime.now()), tag,
+             environment.get('HOSTNAME'), environment.get('CPU'), environment.get('OS')))
+        self.db.commit()
+        self.run_id = cur.lastrowid
+        return self.run_id
+
+    def add(self, test, case_id, case_key, metrics):
+        self.db.executemany(
+            'INSERT INTO metrics VALUES(?, ?, ?, ?, ?, ?)',
+            [(self.run_id, test, case_id, case_key, name, value) for name, value in metrics.items()])
+        self.db.commit()
+
+    def baseline(self, test, case_key):
+        rows = self.db.execute(
+            'SELECT name, value FROM baselines WHERE test = ? AND case_key = ?',
+            (test, case_key))
+        return dict(rows.fetchall())
+
+    def save_baseline(self):
+        self.db.execute('''
+            INSERT OR REPLACE INTO baselines(test, case_key, name, value, run)
+            SELECT test, case_key, name, value, run FROM metrics WHERE run = ?''',
+            (self.run_id,))
+        self.db.commit()
+
+
+class Comparison(object):
+    def __init__(self, tolerance):
+        # default tolerance in percents, tests may override it per metric
+        self.tolerance = tolerance
+        self.rows = []
+        self.no_baseline = []
+
+    def add(self, test, case_id, current, baseline, tolerance=None):
+        if not baseline:
+            self.no_baseline.append((test, case_id))
+            return 0
+
+        tolerance = tolerance or {}
+        regressions = 0
+
+        for name, bigger_is_better in METRICS.items():
+            if name not in current or not baseline.get(name):
+                continue
+
+            change = 100.0 * (current[name] - baseline[name]) / baseline[name]
+            limit = float(tolerance.get(name, self.tolerance))
+
+            worse = -change if bigger_is_better else change
+            if abs(current[name] - baseline[name]) < _NOISE.get(name, 0):
+                status = ''
+            elif worse > limit:
+                status = 'REGRESSION'
+                regressions += 1
+            elif -worse > limit:
+                status = 'improvement'
+            else:
+                status = ''
+
+            self.rows.append((test, case_id, name, baseline[name], current[name], change, status))
+
+        return regressions
+
+    def report(self):
+        print("\nPerformance report (tolerance {}%):".format(self.tolerance))
+
+        if self.rows:
+            print('  {:<24s} {:>4s} {:<10s} {:>12s} {:>12s} {:>8s}'.format(
+                'test', 'case', 'metric', 'baseline', 'current', 'change'))
+
+        for test, case_id, name, base, cur, change, status in self.rows:
+            print('  {:<24s} {:>4s} {:<10s} {:>12.3f} {:>12.3f} {:>+7.1f}% {}'.format(
+                test, case_id, name, base, cur, change, status).rstrip())
+
+        regressions = sum(1 for r in self.rows if r[-1] == 'REGRESSION')
+        improvements = sum(1 for r in self.rows if r[-1] == 'improvement')
+
+        print("\n{} regressions, {} improvements, {} cases without baseline".format(
+            regressions, improvements, len(self.no_baseline)))
+
+        return regressions
@@ -28,6 +28,8 @@ import pathlib
 import hashlib
 import subprocess
 
+from . import perf
+
 
 class EncodedFileName(object):
     def __init__(self, case_id):
@@ -70,6 +72,7 @@ class Runner(object):
 
         self.extra_env = extra_env
         self.cfg = cfg
+        self.metrics = {}
 
     def _run(self, case_id, cmd, workdir, log):
         log.dump_header()
@@ -84,32 +87,22 @@ class Runner(object):
         log.log(subprocess.list2cmdline(cmd))
         log.separator()
 
-        try:
-            p = subprocess.run(
-                cmd,
-                stdout=subprocess.PIPE,
-                stderr=subprocess.STDOUT,
-                check=True,
-                cwd=str(workdir),
-                env=self.env,
-                #shell=True
-            )
-            log.log(p.stdout.decode('utf-8'))
-            log.separator()
-            return p.returncode
-
-        except subprocess.CalledProcessError as exc:
-            log.log(exc.output.decode('utf-8'))
-            log.separator()
-            log.log("return code: {}".format(exc.returncode))
-
-            return exc.returncode
+        returncode, output, self.metrics = perf.run(cmd, str(workdir), self.env)
+
+        log.log(output)
+        log.separator()
+        if returncode != 0:
+            log.log("return code: {}".format(returncode))
+        else:
+            log.log(pprint.pformat(dict(self.metrics)))
+
+        return returncode
 
     def other_options(self, case):
         cmd = []
         # process remaining arguments
         for k, v in case.items():
-            if k in ['platforms']:
+            if k in ['platforms', 'impl']:
                 continue
             if isinstance(v, bool):
                 if v:
@@ -121,7 +114,7 @@ class Runner(object):
 
     def sample_decode(self, case_id, case, workdir, log):
         cmd = ['sample_decode']
-        cmd.append('-hw')
+        cmd.append('-{}'.format(case.get('impl', 'hw')))
 
         stream = case.pop("stream")
         if stream.codec == "jpg":
@@ -151,7 +144,7 @@ class Runner(object):
         if encoder.plugin:
             cmd.extend(['-p', encoder.plugin['guid']])
 
-        cmd.append('-hw')
+        cmd.append('-{}'.format(case.get('impl', 'hw')))
         
         stream = case.pop('stream')
         cmd.extend(['-i', stream.path])
@@ -213,7 +206,7 @@ class Runner(object):
     def sample_vpp(self, case_id, case, workdir, log):
         cmd = ['sample_vpp']
 
-        cmd.extend(['-lib', 'hw'])
+        cmd.extend(['-lib', case.get('impl', 'hw')])
 
         stream = case.pop('stream')
         cmd.extend(['-i', stream.path])
@@ -27,7 +27,7 @@ import itertools
 
 from pathlib import Path
 
-from . import objects, run, platform
+from . import objects, run, platform, perf
 
 
 class ValidationError(Exception):
@@ -60,12 +60,17 @@ class Test(object):
         self.test_type = None
         self.base_dir = Path(base)
         self.device = args.device
+        self.perf_runs = args.perf_runs if args.perf else 0
 
         fn = Path(fn)
 
         self.config = json.loads(fn.read_text(), object_pairs_hook=collections.OrderedDict)
         self.name = fn.stem
 
+        # per metric tolerance in percents, overrides the one from command line
+        self.perf_tolerance = self.config.pop('perf_tolerance', {})
+        self.case_keys = []
+
         self.results = self.base_dir / 'results' / self.name
 
         self.generate_cases()
@@ -94,7 +99,19 @@ class Test(object):
         elif self.test_type == 'vpp':
             return self.runner.sample_vpp(case_id, params, workdir, log)
 
-    def run(self):
+    def measure(self, case_id, case, log):
+        """Runs case perf_runs times, returns median metrics or None on failure"""
+        runs = []
+        for _ in range(self.perf_runs):
+            results = self.exec_test_tool(case_id, collections.OrderedDict(case), self.results, log)
+            self.remove_generated(results, self.results)
+            if not results:
+                return None
+            runs.append(self.runner.metrics)
+
+        return perf.median(runs)
+
+    def run(self, db=None, comparison=None):
         self.clear_results()
         self.results.mkdir(parents=True, exist_ok=True)
         total = passed = 0
@@ -110,7 +127,7 @@ class Test(object):
 
             total += 1
             print("    {:04d}".format(i), end="")
-            results = self.exec_test_tool(i, case, self.results, log)
+            results = self.exec_test_tool(i, collections.OrderedDict(case), self.results, log)
 
             if results:
                 passed += 1
@@ -119,6 +136,13 @@ class Test(object):
                 error = "fail"
                 log.log('FAIL')
             self.remove_generated(results, self.results)
+
+            metrics = None
+            if results and self.perf_runs:
+                metrics = self.measure(i, case, log)
+                if metrics is None:
+                    error = "fail during performance measurement"
+                    passed -= 1
             log.separator()
             res = {
                 'id': '{:04d}'.format(i),
@@ -138,6 +162,15 @@ class Test(object):
                 res['status'] = 'PASS'
                 res['artifacts'] = results
 
+            if metrics is not None:
+                res['metrics'] = metrics
+                if db:
+                    db.add(self.name, res['id'], self.case_keys[i - 1], metrics)
+                if comparison:
+                    baseline = db.baseline(self.name, self.case_keys[i - 1]) if db else {}
+                    res['regressions'] = comparison.add(
+                        self.name, res['id'], metrics, baseline, self.perf_tolerance)
+
             details['cases'].append(res)
 
             log.log('\nfinisned: {}'.format(datetime.datetime.now()))
@@ -171,6 +204,8 @@ class Test(object):
 
         for vals in itertools.product(*values):
             case = collections.OrderedDict(zip(keys, vals))
+            # case id depends on json layout, key identifies case in perf database
+            self.case_keys.append(json.dumps(case, sort_keys=True))
             case['device'] = self.device
 
             if 'stream' not in case:
@@ -0,0 +1,54 @@
+// Copyright (c) 2020 Intel Corporation
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __MFX_UNIT_TEST_UTILS_H__
+#define __MFX_UNIT_TEST_UTILS_H__
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <iostream>
+
+// Embedded gtest predates GTEST_SKIP(), there a skipped test is reported as passed.
+#ifndef GTEST_SKIP
+#define GTEST_SKIP() return GTEST_MESSAGE_("Skipped", ::testing::TestPartResult::kSuccess)
+#endif
+
+namespace mfx_unit_test
+{
+    template <class Func>
+    double MeasureSeconds(int iterations, Func func)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; i++)
+            func();
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // Wall-clock numbers depend on machine load, so they are reported and never checked.
+    inline void ReportTiming(const char* reference, double referenceSeconds, const char* tested, double testedSeconds)
+    {
+        std::cout << "[   TIME   ] " << reference << " " << (int)(referenceSeconds * 1e6) << " us, "
+                  << tested << " " << (int)(testedSeconds * 1e6) << " us, speedup "
+                  << referenceSeconds / testedSeconds << "\n";
+    }
+}
+
+#endif // __MFX_UNIT_TEST_UTILS_H__
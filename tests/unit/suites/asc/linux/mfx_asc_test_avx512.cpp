@@ -0,0 +1,205 @@
+// Copyright (c) 2020 Intel Corporation
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "mfx_unit_test_utils.h"
+
+#include "asc_c_impl.h"
+#include "asc_avx512_impl.h"
+#include "cpu_detect.h"
+
+#include <cstring>
+#include <random>
+#include <vector>
+
+// AVX-512 kernels of the scene change detector must give the same results
+// as the C reference. Timings are reported only.
+
+namespace
+{
+    class AscAVX512Test : public ::testing::Test
+    {
+    protected:
+        int Rand(int from, int to)
+        {
+            return std::uniform_int_distribution<int>(from, to)(rng);
+        }
+
+        // picture content of given kind: 0 - noise, 1 - low contrast, 2 - flat
+        void Fill(std::vector<mfxU8>& buf, int kind)
+        {
+            for (auto& v : buf)
+                v = (mfxU8)(kind == 0 ? Rand(0, 255) : kind == 1 ? Rand(0, 15) : Rand(128, 132));
+        }
+
+        std::mt19937 rng{2020};
+    };
+}
+
+TEST_F(AscAVX512Test, ImageDiffHistogramMatchesC)
+{
+    if (!CpuFeature_AVX512())
+        GTEST_SKIP() << "CPU has no AVX-512";
+
+    for (int it = 0; it < 2000; it++)
+    {
+        int width = Rand(16, 315), height = Rand(16, 115), pitch = width + Rand(0, 69);
+        std::vector<mfxU8> src(pitch * height + 64), ref(src.size());
+        Fill(src, it % 3);
+        for (size_t i = 0; i < ref.size(); i++)
+            ref[i] = (mfxU8)(it % 3 == 2 ? src[i] + Rand(-15, 15) : Rand(0, 255));
+
+        mfxI32 hist0[5], hist1[5];
+        mfxI64 srcDC0, srcDC1, refDC0, refDC1;
+        ImageDiffHistogram_C(src.data(), ref.data(), pitch, width, height, hist0, &srcDC0, &refDC0);
+        ImageDiffHistogram_AVX512(src.data(), ref.data(), pitch, width, height, hist1, &srcDC1, &refDC1);
+
+        ASSERT_EQ(0, memcmp(hist0, hist1, sizeof(hist0))) << "width " << width << " height " << height;
+        ASSERT_EQ(srcDC0, srcDC1) << "width " << width << " height " << height;
+        ASSERT_EQ(refDC0, refDC1) << "width " << width << " height " << height;
+    }
+}
+
+TEST_F(AscAVX512Test, CalcRaCaMatchesC)
+{
+    if (!CpuFeature_AVX512())
+        GTEST_SKIP() << "CPU has no AVX-512";
+
+    for (int it = 0; it < 2000; it++)
+    {
+        int width = Rand(16, 315), height = Rand(16, 115), pitch = width + Rand(0, 69);
+        std::vector<mfxU8> src(pitch * height + 64);
+        Fill(src, it % 3);
+
+        mfxF64 raca0 = 0, raca1 = 0;
+        Calc_RaCa_pic_C(src.data(), width, height, pitch, raca0);
+        Calc_RaCa_pic_AVX512(src.data(), width, height, pitch, raca1);
+
+        ASSERT_EQ(raca0, raca1) << "width " << width << " height " << height;
+    }
+}
+
+TEST_F(AscAVX512Test, RsCsCalcMatchesC)
+{
+    if (!CpuFeature_AVX512())
+        GTEST_SKIP() << "CPU has no AVX-512";
+
+    for (int it = 0; it < 2000; it++)
+    {
+        int wblocks = Rand(4, 79), hblocks = Rand(4, 29), pitch = 4 * wblocks + Rand(0, 69);
+        std::vector<mfxU8> src(pitch * 4 * hblocks + 64);
+        Fill(src, it % 3);
+
+        std::vector<mfxU16> rs0(wblocks * hblocks, 7), cs0(rs0), rs1(rs0), cs1(rs0);
+        RsCsCalc_4x4_C(src.data(), pitch, wblocks, hblocks, rs0.data(), cs0.data());
+        RsCsCalc_4x4_AVX512(src.data(), pitch, wblocks, hblocks, rs1.data(), cs1.data());
+
+        ASSERT_EQ(rs0, rs1) << "wblocks " << wblocks << " hblocks " << hblocks;
+        ASSERT_EQ(cs0, cs1) << "wblocks " << wblocks << " hblocks " << hblocks;
+    }
+}
+
+TEST_F(AscAVX512Test, BlockSearchMatchesC)
+{
+    if (!CpuFeature_AVX512())
+        GTEST_SKIP() << "CPU has no AVX-512";
+
+    for (int it = 0; it < 2000; it++)
+    {
+        int xrange = Rand(1, 40), yrange = Rand(1, 40), pitch = xrange + 8 + Rand(0, 19);
+        std::vector<mfxU8> ref(pitch * (yrange + 8) + 64), src(pitch * 8);
+        // few distinct values give many equal SADs and check tie breaking
+        for (auto& v : ref) v = (mfxU8)(it % 2 ? Rand(0, 3) : Rand(0, 255));
+        for (auto& v : src) v = (mfxU8)(it % 2 ? Rand(0, 3) : Rand(0, 255));
+
+        mfxU16 bestSAD0 = Rand(0, 1) ? 0xffff : (mfxU16)Rand(0, 2999), bestSAD1 = bestSAD0;
+        int bestX0 = -1, bestY0 = -1, bestX1 = -1, bestY1 = -1;
+        ME_SAD_8x8_Block_Search_C(src.data(), ref.data(), pitch, xrange, yrange, &bestSAD0, &bestX0, &bestY0);
+        ME_SAD_8x8_Block_Search_AVX512(src.data(), ref.data(), pitch, xrange, yrange, &bestSAD1, &bestX1, &bestY1);
+
+        ASSERT_EQ(bestSAD0, bestSAD1) << "xrange " << xrange << " yrange " << yrange;
+        ASSERT_EQ(bestX0, bestX1) << "xrange " << xrange << " yrange " << yrange;
+        ASSERT_EQ(bestY0, bestY1) << "xrange " << xrange << " yrange " << yrange;
+    }
+}
+
+TEST_F(AscAVX512Test, PictureAnalysisTiming)
+{
+    if (!CpuFeature_AVX512())
+        GTEST_SKIP() << "CPU has no AVX-512";
+
+    // subsampled picture the detector works on
+    const int width = 112, height = 64, pitch = 128, iterations = 2000;
+    std::vector<mfxU8> src(pitch * height), ref(src.size());
+    std::vector<mfxU16> rs(width * height / 16), cs(rs.size());
+    Fill(src, 0);
+    Fill(ref, 0);
+
+    mfxI32 hist[5];
+    mfxI64 srcDC, refDC;
+    mfxF64 raca;
+
+    double c = mfx_unit_test::MeasureSeconds(iterations, [&]()
+    {
+        ImageDiffHistogram_C(src.data(), ref.data(), pitch, width, height, hist, &srcDC, &refDC);
+        Calc_RaCa_pic_C(src.data(), width, height, pitch, raca);
+        RsCsCalc_4x4_C(src.data(), pitch, width / 4, height / 4, rs.data(), cs.data());
+    });
+    double avx512 = mfx_unit_test::MeasureSeconds(iterations, [&]()
+    {
+        ImageDiffHistogram_AVX512(src.data(), ref.data(), pitch, width, height, hist, &srcDC, &refDC);
+        Calc_RaCa_pic_AVX512(src.data(), width, height, pitch, raca);
+        RsCsCalc_4x4_AVX512(src.data(), pitch, width / 4, height / 4, rs.data(), cs.data());
+    });
+
+    mfx_unit_test::ReportTiming("c", c, "avx512", avx512);
+}
+
+TEST_F(AscAVX512Test, BlockSearchTiming)
+{
+    if (!CpuFeature_AVX512())
+        GTEST_SKIP() << "CPU has no AVX-512";
+
+    const int xrange = 32, yrange = 32, pitch = 64, blocks = 64, iterations = 50;
+    std::vector<mfxU8> ref(pitch * (yrange + 8)), src(pitch * 8 * blocks);
+    Fill(ref, 0);
+    Fill(src, 0);
+
+    mfxU16 bestSAD;
+    int bestX, bestY;
+
+    double c = mfx_unit_test::MeasureSeconds(iterations, [&]()
+    {
+        for (int b = 0; b < blocks; b++)
+        {
+            bestSAD = 0xffff;
+            ME_SAD_8x8_Block_Search_C(&src[pitch * 8 * b], ref.data(), pitch, xrange, yrange, &bestSAD, &bestX, &bestY);
+        }
+    });
+    double avx512 = mfx_unit_test::MeasureSeconds(iterations, [&]()
+    {
+        for (int b = 0; b < blocks; b++)
+        {
+            bestSAD = 0xffff;
+            ME_SAD_8x8_Block_Search_AVX512(&src[pitch * 8 * b], ref.data(), pitch, xrange, yrange, &bestSAD, &bestX, &bestY);
+        }
+    });
+
+    mfx_unit_test::ReportTiming("c", c, "avx512", avx512);
+}
@@ -0,0 +1,235 @@
+// Copyright (c) 2020 Intel Corporation
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "mfx_unit_test_utils.h"
+
+#include "mfx_enctools_utils.h"
+#include "mfx_enctools_utils_avx2.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+// AVX2 column sum kernels must give the same sums as the C kernels for any
+// width, row count up to the 16-bit limit and P010 shift. The downscaler,
+// which combines them, must give the plain rounded area average for any
+// ratio and any band split. Timings are reported only.
+
+using namespace EncToolsUtils;
+
+namespace
+{
+    class EncToolsDownScaleTest : public ::testing::Test
+    {
+    protected:
+        int Rand(int from, int to)
+        {
+            return std::uniform_int_distribution<int>(from, to)(rng);
+        }
+
+        template <class T>
+        void Fill(std::vector<T>& buf, int maxValue)
+        {
+            for (auto& v : buf)
+                v = (T)Rand(0, maxValue);
+        }
+
+        // rounded average of (sample >> shift) over source pixels of each destination pixel
+        template <class T>
+        static std::vector<mfxU8> AreaAverage(std::vector<T> const& src, mfxU32 srcWidth, mfxU32 srcHeight, mfxU32 srcPitch, mfxU32 shift,
+            mfxU32 dstWidth, mfxU32 dstHeight)
+        {
+            std::vector<mfxU8> dst(dstWidth * dstHeight);
+            for (mfxU32 y = 0; y < dstHeight; y++)
+            {
+                mfxU32 top = y * srcHeight / dstHeight, bottom = (y + 1) * srcHeight / dstHeight;
+                for (mfxU32 x = 0; x < dstWidth; x++)
+                {
+                    mfxU32 left = x * srcWidth / dstWidth, right = (x + 1) * srcWidth / dstWidth;
+                    mfxU64 sum = 0;
+                    for (mfxU32 i = top; i < bottom; i++)
+                        for (mfxU32 j = left; j < right; j++)
+                            sum += src[i * srcPitch + j] >> shift;
+
+                    mfxU64 area = (right - left) * (bottom - top);
+                    dst[y * dstWidth + x] = (mfxU8)((sum + area / 2) / area);
+                }
+            }
+            return dst;
+        }
+
+        std::mt19937 rng{2020};
+    };
+}
+
+TEST_F(EncToolsDownScaleTest, SumRows8uMatchesC)
+{
+    if (!__builtin_cpu_supports("avx2"))
+        GTEST_SKIP() << "CPU has no AVX2";
+
+    const int pitch = 4000;
+
+    for (int numRows : { 1, 2, 3, 16, 128, 256, 257 })
+    {
+        for (int width : { 0, 1, 31, 32, 33, 63, 64, 65, 97, 255, 1919, 1920, 3839 })
+        {
+            std::vector<mfxU8> src(pitch * numRows + 32);
+            // all samples at maximum give the biggest sum, which must still fit in 16 bits
+            if (width & 1)
+                std::fill(src.begin(), src.end(), 255);
+            else
+                Fill(src, 255);
+
+            const mfxU8* ps = src.data() + Rand(0, 31); // any alignment
+            std::vector<mfxU16> ref(width + 1, 0xdead), sum(width + 1, 0xdead);
+
+            ASSERT_EQ(width, SumRows_8u16u_C(ps, pitch, width, numRows, ref.data()));
+            int x0 = SumRows_8u16u_AVX2(ps, pitch, width, numRows, sum.data());
+
+            // only whole vectors are processed, the tail is left to C kernel
+            ASSERT_EQ(width & ~31, x0) << "width " << width;
+            for (int x = 0; x < x0; x++)
+                ASSERT_EQ(ref[x], sum[x]) << "width " << width << " rows " << numRows << " column " << x;
+            for (int x = x0; x <= width; x++)
+                ASSERT_EQ(0xdead, sum[x]) << "width " << width << " column " << x << " is written";
+        }
+    }
+}
+
+TEST_F(EncToolsDownScaleTest, SumRows16uMatchesC)
+{
+    if (!__builtin_cpu_supports("avx2"))
+        GTEST_SKIP() << "CPU has no AVX2";
+
+    const int pitch = 4000;
+
+    // 8 - MSB aligned P010 (Shift = 1), 2 - LSB aligned 10 bits, 4 - 12 bits, 0 - 8 bits in 16-bit samples
+    for (int shift : { 8, 2, 4, 0 })
+    {
+        for (int numRows : { 1, 3, 129, 257 })
+        {
+            for (int width : { 0, 1, 15, 16, 17, 31, 33, 255, 1921, 3840 })
+            {
+                std::vector<mfxU16> src(pitch * numRows + 16);
+                Fill(src, (256 << shift) - 1);
+
+                const mfxU16* ps = src.data() + Rand(0, 15);
+                std::vector<mfxU16> ref(width + 1, 0xdead), sum(width + 1, 0xdead);
+
+                ASSERT_EQ(width, SumRows_16u16u_C(ps, pitch * sizeof(mfxU16), width, numRows, shift, ref.data()));
+                int x0 = SumRows_16u16u_AVX2(ps, pitch * sizeof(mfxU16), width, numRows, shift, sum.data());
+
+                ASSERT_EQ(width & ~15, x0) << "width " << width;
+                for (int x = 0; x < x0; x++)
+                    ASSERT_EQ(ref[x], sum[x]) << "shift " << shift << " width " << width << " rows " << numRows << " column " << x;
+                for (int x = x0; x <= width; x++)
+                    ASSERT_EQ(0xdead, sum[x]) << "width " << width << " column " << x << " is written";
+            }
+        }
+    }
+}
+
+TEST_F(EncToolsDownScaleTest, DownScaleAreaMatchesAverage)
+{
+    const struct { mfxU32 srcWidth, srcHeight, dstWidth, dstHeight; } modes[] =
+    {
+        { 3840, 2160, 256, 128 },
+        { 1921, 1081, 256, 128 },  // fractional ratios, areas of different sizes
+        {  257,  129, 256, 128 },  // areas of one and two pixels
+        {  256,  128, 256, 128 },
+        {  333, 1000, 100,   2 },  // areas taller than 257 rows are summed in parts
+        {   40,  516,   3,   2 },  // 258 rows, just above the limit
+        {   40,  600,   1,   1 },
+        { 1280,  720, 256, 128 },  // the same instance serves smaller frames after bigger ones
+        { 4096, 2176, 255, 127 },
+    };
+
+    AreaDownScaler scaler;
+
+    for (bool saturated : { false, true })
+    {
+        for (auto& m : modes)
+        {
+            mfxU32 srcPitch = m.srcWidth + 7;
+
+            // saturated pictures give the biggest column sums
+            std::vector<mfxU8> src8(srcPitch * m.srcHeight, 255);
+            if (!saturated)
+                Fill(src8, 255);
+            std::vector<mfxU8> ref = AreaAverage(src8, m.srcWidth, m.srcHeight, srcPitch, 0, m.dstWidth, m.dstHeight);
+
+            // destination is split into bands as a caller scaling in parallel would do
+            std::vector<mfxU8> dst(m.dstWidth * m.dstHeight, 0);
+            mfxU32 band = (m.dstHeight + 2) / 3;
+            for (mfxU32 y = 0; y < m.dstHeight; y += band)
+                ASSERT_EQ(MFX_ERR_NONE, scaler.DownScaleArea(src8[0], m.srcWidth, m.srcHeight, srcPitch, 0,
+                    dst[0], m.dstWidth, m.dstHeight, m.dstWidth, y, std::min(band, m.dstHeight - y)));
+            ASSERT_EQ(ref, dst) << m.srcWidth << "x" << m.srcHeight << " -> " << m.dstWidth << "x" << m.dstHeight;
+
+            for (mfxU32 shift : { 2, 8 })
+            {
+                // 16-bit samples with random bits below the shift give the same picture as 8-bit ones
+                std::vector<mfxU16> src16(src8.size());
+                for (size_t i = 0; i < src8.size(); i++)
+                    src16[i] = (mfxU16)((src8[i] << shift) | Rand(0, (1 << shift) - 1));
+
+                std::fill(dst.begin(), dst.end(), 0);
+                ASSERT_EQ(MFX_ERR_NONE, scaler.DownScaleArea(src16[0], m.srcWidth, m.srcHeight, srcPitch, shift,
+                    dst[0], m.dstWidth, m.dstHeight, m.dstWidth, 0, m.dstHeight));
+                ASSERT_EQ(ref, dst) << m.srcWidth << "x" << m.srcHeight << " -> " << m.dstWidth << "x" << m.dstHeight << ", shift " << shift;
+            }
+        }
+    }
+}
+
+TEST_F(EncToolsDownScaleTest, DownScaleAreaRejectsUpscaling)
+{
+    std::vector<mfxU8> src(64 * 64), dst(128 * 128);
+    AreaDownScaler scaler;
+
+    EXPECT_EQ(MFX_ERR_UNSUPPORTED, scaler.DownScaleArea(src[0], 64, 64, 64, 0, dst[0], 128, 32, 128, 0, 32));
+    EXPECT_EQ(MFX_ERR_UNSUPPORTED, scaler.DownScaleArea(src[0], 64, 64, 64, 0, dst[0], 32, 128, 32, 0, 128));
+    EXPECT_EQ(MFX_ERR_UNSUPPORTED, scaler.DownScaleArea(src[0], 64, 64, 64, 0, dst[0], 32, 32, 32, 16, 17));
+}
+
+TEST_F(EncToolsDownScaleTest, SumRowsTiming)
+{
+    if (!__builtin_cpu_supports("avx2"))
+        GTEST_SKIP() << "CPU has no AVX2";
+
+    // 4K luma summed in bands of 17 rows, as scaling to 128 rows does
+    const int width = 3840, height = 2160, rows = 17, iterations = 20;
+    std::vector<mfxU8> src(width * height);
+    std::vector<mfxU16> sum(width);
+    Fill(src, 255);
+
+    double c = mfx_unit_test::MeasureSeconds(iterations, [&]()
+    {
+        for (int y = 0; y + rows <= height; y += rows)
+            SumRows_8u16u_C(src.data() + y * width, width, width, rows, sum.data());
+    });
+    double avx2 = mfx_unit_test::MeasureSeconds(iterations, [&]()
+    {
+        for (int y = 0; y + rows <= height; y += rows)
+            SumRows_8u16u_AVX2(src.data() + y * width, width, width, rows, sum.data());
+    });
+
+    mfx_unit_test::ReportTiming("C", c, "AVX2", avx2);
+}
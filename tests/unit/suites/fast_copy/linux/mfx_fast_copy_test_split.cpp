@@ -0,0 +1,216 @@
+// Copyright (c) 2020 Intel Corporation
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "mfx_unit_test_utils.h"
+
+#include "fast_copy.h"
+
+#include <random>
+#include <vector>
+
+// SSE4 split kernels must give the same planes as the C kernels for any
+// source alignment and width. FastCopy dispatches to SSE4 kernels, so
+// its output is checked against planes built by C kernels row by row.
+// Timings are reported only.
+
+namespace
+{
+    class FastCopySplitTest : public ::testing::Test
+    {
+    protected:
+        int Rand(int from, int to)
+        {
+            return std::uniform_int_distribution<int>(from, to)(rng);
+        }
+
+        template <class T>
+        void Fill(std::vector<T>& buf)
+        {
+            for (auto& v : buf)
+                v = (T)Rand(0, 0xffff);
+        }
+
+        std::mt19937 rng{2020};
+    };
+}
+
+TEST_F(FastCopySplitTest, SplitUVMatchesC)
+{
+    if (!__builtin_cpu_supports("sse4.1"))
+        GTEST_SKIP() << "CPU has no SSE4.1";
+
+    for (int offset = 0; offset < 16; offset++)
+    {
+        for (int width = 0; width < 100; width++)
+        {
+            std::vector<mfxU8> src(2 * width + 16);
+            Fill(src);
+
+            std::vector<mfxU8> u0(width), v0(width), u1(width), v1(width);
+            copyVideoToSysSplitUV_C(src.data() + offset, u0.data(), v0.data(), width);
+            copyVideoToSysSplitUV_SSE4(src.data() + offset, u1.data(), v1.data(), width);
+
+            ASSERT_EQ(u0, u1) << "offset " << offset << " width " << width;
+            ASSERT_EQ(v0, v1) << "offset " << offset << " width " << width;
+        }
+    }
+}
+
+TEST_F(FastCopySplitTest, SplitUVShiftMatchesC)
+{
+    if (!__builtin_cpu_supports("sse4.1"))
+        GTEST_SKIP() << "CPU has no SSE4.1";
+
+    for (int shift : { 0, 6 })
+    {
+        for (int offset = 0; offset < 16; offset++)
+        {
+            for (int width = 0; width < 60; width++)
+            {
+                // offset is in bytes, odd ones leave samples misaligned
+                std::vector<mfxU16> src(2 * width + 8);
+                Fill(src);
+                const mfxU16* pSrc = (const mfxU16*)((const mfxU8*)src.data() + offset);
+
+                std::vector<mfxU16> u0(width), v0(width), u1(width), v1(width);
+                copyVideoToSysSplitUVShift_C(pSrc, u0.data(), v0.data(), width, shift);
+                copyVideoToSysSplitUVShift_SSE4(pSrc, u1.data(), v1.data(), width, shift);
+
+                ASSERT_EQ(u0, u1) << "shift " << shift << " offset " << offset << " width " << width;
+                ASSERT_EQ(v0, v1) << "shift " << shift << " offset " << offset << " width " << width;
+            }
+        }
+    }
+}
+
+TEST_F(FastCopySplitTest, SplitRGB4MatchesC)
+{
+    if (!__builtin_cpu_supports("sse4.1"))
+        GTEST_SKIP() << "CPU has no SSE4.1";
+
+    for (int offset = 0; offset < 16; offset++)
+    {
+        for (int width = 0; width < 60; width++)
+        {
+            std::vector<mfxU8> src(4 * width + 16);
+            Fill(src);
+
+            std::vector<mfxU8> r0(width), g0(width), b0(width), r1(width), g1(width), b1(width);
+            copyVideoToSysSplitRGB4_C(src.data() + offset, r0.data(), g0.data(), b0.data(), width);
+            copyVideoToSysSplitRGB4_SSE4(src.data() + offset, r1.data(), g1.data(), b1.data(), width);
+
+            ASSERT_EQ(r0, r1) << "offset " << offset << " width " << width;
+            ASSERT_EQ(g0, g1) << "offset " << offset << " width " << width;
+            ASSERT_EQ(b0, b1) << "offset " << offset << " width " << width;
+        }
+    }
+}
+
+TEST_F(FastCopySplitTest, CopySplitUVMatchesC)
+{
+    if (!__builtin_cpu_supports("sse4.1"))
+        GTEST_SKIP() << "CPU has no SSE4.1";
+
+    for (int it = 0; it < 200; it++)
+    {
+        mfxSize roi = { Rand(1, 200), Rand(1, 20) };
+        mfxU32 srcPitch = 2 * roi.width + Rand(0, 40), dstPitch = roi.width + Rand(0, 40);
+        std::vector<mfxU8> src(srcPitch * roi.height);
+        Fill(src);
+
+        std::vector<mfxU8> u0(dstPitch * roi.height), v0(u0), u1(u0), v1(u0);
+        for (int y = 0; y < roi.height; y++)
+            copyVideoToSysSplitUV_C(&src[y * srcPitch], &u0[y * dstPitch], &v0[y * dstPitch], roi.width);
+
+        ASSERT_EQ(MFX_ERR_NONE, FastCopy::CopySplitUV(u1.data(), v1.data(), dstPitch, src.data(), srcPitch, roi));
+        ASSERT_EQ(u0, u1) << "width " << roi.width << " src pitch " << srcPitch;
+        ASSERT_EQ(v0, v1) << "width " << roi.width << " src pitch " << srcPitch;
+    }
+}
+
+TEST_F(FastCopySplitTest, CopySplitUVAndShiftMatchesC)
+{
+    if (!__builtin_cpu_supports("sse4.1"))
+        GTEST_SKIP() << "CPU has no SSE4.1";
+
+    for (int it = 0; it < 200; it++)
+    {
+        mfxU8 shift = (mfxU8)(it % 2 ? 6 : 0);
+        mfxSize roi = { Rand(1, 200), Rand(1, 20) };
+        // pitches are in bytes
+        mfxU32 srcPitch = 4 * roi.width + 2 * Rand(0, 20), dstPitch = 2 * roi.width + 2 * Rand(0, 20);
+        std::vector<mfxU16> src(srcPitch / 2 * roi.height);
+        Fill(src);
+
+        std::vector<mfxU16> u0(dstPitch / 2 * roi.height), v0(u0), u1(u0), v1(u0);
+        for (int y = 0; y < roi.height; y++)
+            copyVideoToSysSplitUVShift_C(&src[y * srcPitch / 2], &u0[y * dstPitch / 2], &v0[y * dstPitch / 2], roi.width, shift);
+
+        ASSERT_EQ(MFX_ERR_NONE, FastCopy::CopySplitUVAndShift(u1.data(), v1.data(), dstPitch, src.data(), srcPitch, roi, shift));
+        ASSERT_EQ(u0, u1) << "width " << roi.width << " src pitch " << srcPitch;
+        ASSERT_EQ(v0, v1) << "width " << roi.width << " src pitch " << srcPitch;
+    }
+}
+
+TEST_F(FastCopySplitTest, CopySplitRGB4MatchesC)
+{
+    if (!__builtin_cpu_supports("sse4.1"))
+        GTEST_SKIP() << "CPU has no SSE4.1";
+
+    for (int it = 0; it < 200; it++)
+    {
+        mfxSize roi = { Rand(1, 200), Rand(1, 20) };
+        mfxU32 srcPitch = 4 * roi.width + Rand(0, 40), dstPitch = roi.width + Rand(0, 40);
+        std::vector<mfxU8> src(srcPitch * roi.height);
+        Fill(src);
+
+        std::vector<mfxU8> r0(dstPitch * roi.height), g0(r0), b0(r0), r1(r0), g1(r0), b1(r0);
+        for (int y = 0; y < roi.height; y++)
+            copyVideoToSysSplitRGB4_C(&src[y * srcPitch], &r0[y * dstPitch], &g0[y * dstPitch], &b0[y * dstPitch], roi.width);
+
+        ASSERT_EQ(MFX_ERR_NONE, FastCopy::CopySplitRGB4(r1.data(), g1.data(), b1.data(), dstPitch, src.data(), srcPitch, roi));
+        ASSERT_EQ(r0, r1) << "width " << roi.width << " src pitch " << srcPitch;
+        ASSERT_EQ(g0, g1) << "width " << roi.width << " src pitch " << srcPitch;
+        ASSERT_EQ(b0, b1) << "width " << roi.width << " src pitch " << srcPitch;
+    }
+}
+
+TEST_F(FastCopySplitTest, CopySplitUVTiming)
+{
+    if (!__builtin_cpu_supports("sse4.1"))
+        GTEST_SKIP() << "CPU has no SSE4.1";
+
+    // chroma of 4K NV12 picture
+    const int iterations = 100, width = 1920, height = 1080;
+    std::vector<mfxU8> src(2 * width * height), u(width * height), v(u);
+    Fill(src);
+
+    double c = mfx_unit_test::MeasureSeconds(iterations, [&]()
+    {
+        for (int y = 0; y < height; y++)
+            copyVideoToSysSplitUV_C(&src[y * 2 * width], &u[y * width], &v[y * width], width);
+    });
+    double sse4 = mfx_unit_test::MeasureSeconds(iterations, [&]()
+    {
+        FastCopy::CopySplitUV(u.data(), v.data(), width, src.data(), 2 * width, { width, height });
+    });
+
+    mfx_unit_test::ReportTiming("c", c, "sse4", sse4);
+}
@@ -0,0 +1,162 @@
+// Copyright (c) 2020 Intel Corporation
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "mfx_unit_test_utils.h"
+
+#include "umc_h265_mfx_supplier.h"
+#include "umc_h265_mfx_utils.h"
+#include "umc_param_set_cache.h"
+
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+// Decoder sessions opened on the same stream take VPS and SPS parsed by the
+// first session from the process-wide UMC::ParamSetCache.
+
+using namespace UMC_HEVC_DECODER;
+
+namespace
+{
+    typedef UMC::ParamSetCache<H265VideoParamSet> VPSCache;
+    typedef UMC::ParamSetCache<H265SeqParamSet>   SPSCache;
+
+    std::vector<mfxU8> LoadStream(const char* name)
+    {
+        std::ifstream file(std::string(TEST_CONTENT_DIR) + "/" + name, std::ios::binary);
+        return std::vector<mfxU8>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    // what DECODE_DecodeHeader does in a new session, time spent in header decoding is added to 'seconds'
+    UMC::Status DecodeHeaderInNewSession(std::vector<mfxU8>& stream, mfxVideoParam& par, double* seconds = nullptr)
+    {
+        MFXTaskSupplier_H265 supplier;
+
+        UMC::MediaData data;
+        data.SetBufferPointer(stream.data(), stream.size());
+        data.SetDataSize(stream.size());
+        data.SetFlags(UMC::MediaData::FLAG_VIDEO_DATA_NOT_FULL_FRAME);
+
+        mfxBitstream bs = {};
+        bs.Data      = stream.data();
+        bs.MaxLength = bs.DataLength = (mfxU32)stream.size();
+
+        UMC::VideoDecoderParams params;
+        params.m_pData = &data;
+
+        par = mfxVideoParam();
+        auto start = std::chrono::steady_clock::now();
+        UMC::Status sts = MFX_Utility::DecodeHeader(&supplier, &params, &bs, &par);
+        if (seconds)
+            *seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (sts != UMC::UMC_OK)
+            return sts;
+
+        H265SeqParamSet* sps = supplier.GetHeaders()->m_SeqParams.GetCurrentHeader();
+        if (!sps)
+            return UMC::UMC_ERR_FAILED;
+
+        par.mfx.FrameInfo.Width  = (mfxU16)sps->pic_width_in_luma_samples;
+        par.mfx.FrameInfo.Height = (mfxU16)sps->pic_height_in_luma_samples;
+        return sts;
+    }
+
+    class H265ParamSetCacheTest : public ::testing::Test
+    {
+    protected:
+        void SetUp() override
+        {
+            VPSCache::Instance().Clear();
+            SPSCache::Instance().Clear();
+
+            stream = LoadStream("test_stream.265");
+        }
+
+        std::vector<mfxU8> stream;
+    };
+}
+
+TEST_F(H265ParamSetCacheTest, SecondSessionHitsCache)
+{
+    ASSERT_FALSE(stream.empty());
+
+    mfxVideoParam first, second;
+
+    SPSCache::Stats before = SPSCache::Instance().GetStats();
+    ASSERT_EQ(UMC::UMC_OK, DecodeHeaderInNewSession(stream, first));
+
+    SPSCache::Stats afterFirst = SPSCache::Instance().GetStats();
+    EXPECT_EQ(before.hits, afterFirst.hits);
+    EXPECT_EQ(1u, afterFirst.size);
+
+    ASSERT_EQ(UMC::UMC_OK, DecodeHeaderInNewSession(stream, second));
+
+    SPSCache::Stats afterSecond = SPSCache::Instance().GetStats();
+    EXPECT_GT(afterSecond.hits, afterFirst.hits);
+    EXPECT_GT(VPSCache::Instance().GetStats().hits, 0u);
+
+    // cached SPS gives the same stream parameters
+    EXPECT_NE(0, first.mfx.FrameInfo.Width);
+    EXPECT_EQ(first.mfx.FrameInfo.Width,  second.mfx.FrameInfo.Width);
+    EXPECT_EQ(first.mfx.FrameInfo.Height, second.mfx.FrameInfo.Height);
+}
+
+TEST_F(H265ParamSetCacheTest, DisabledCacheParsesEverySession)
+{
+    ASSERT_FALSE(stream.empty());
+
+    SPSCache::Instance().SetCapacity(0);
+
+    mfxVideoParam par;
+    SPSCache::Stats before = SPSCache::Instance().GetStats();
+    ASSERT_EQ(UMC::UMC_OK, DecodeHeaderInNewSession(stream, par));
+    ASSERT_EQ(UMC::UMC_OK, DecodeHeaderInNewSession(stream, par));
+    EXPECT_EQ(before.hits, SPSCache::Instance().GetStats().hits);
+
+    SPSCache::Instance().SetCapacity(SPSCache::DEFAULT_CAPACITY);
+}
+
+TEST_F(H265ParamSetCacheTest, DecodeHeaderTiming)
+{
+    ASSERT_FALSE(stream.empty());
+
+    const int iterations = 1000;
+    mfxVideoParam par;
+
+    auto measure = [&]()
+    {
+        double seconds = 0;
+        for (int i = 0; i < iterations; i++)
+            DecodeHeaderInNewSession(stream, par, &seconds);
+        return seconds;
+    };
+
+    SPSCache::Instance().SetCapacity(0);
+    VPSCache::Instance().SetCapacity(0);
+    double parsed = measure();
+
+    SPSCache::Instance().SetCapacity(SPSCache::DEFAULT_CAPACITY);
+    VPSCache::Instance().SetCapacity(VPSCache::DEFAULT_CAPACITY);
+    double cached = measure();
+
+    mfx_unit_test::ReportTiming("parsing", parsed / iterations, "cached", cached / iterations);
+}
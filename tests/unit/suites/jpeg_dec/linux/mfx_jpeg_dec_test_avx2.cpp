@@ -0,0 +1,301 @@
+// Copyright (c) 2020 Intel Corporation
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "mfx_unit_test_utils.h"
+
+#include "ippj.h"
+#include "jpegdec_avx2.h"
+
+#include <cstring>
+#include <random>
+#include <vector>
+
+// AVX2 kernels of the software JPEG decoder must be bit exact with the
+// mfxi* primitives they replace. Their speed is reported.
+
+namespace
+{
+    class JpegDecAVX2Test : public ::testing::Test
+    {
+    protected:
+        int Rand(int from, int to)
+        {
+            return std::uniform_int_distribution<int>(from, to)(rng);
+        }
+
+        void Fill(std::vector<uint8_t>& buf)
+        {
+            for (auto& v : buf)
+                v = (uint8_t)Rand(0, 255);
+        }
+
+        // random quantized coefficients with given sparsity and range
+        void FillBlock(int16_t* coefs, uint16_t* qt, int range, int maxQ, int density)
+        {
+            for (int i = 0; i < 64; i++)
+            {
+                coefs[i] = Rand(0, density - 1) ? 0 : (int16_t)Rand(-range, range);
+                qt[i]    = (uint16_t)Rand(1, maxQ);
+            }
+        }
+
+        std::mt19937 rng{2020};
+    };
+
+    const struct { int range, maxQ, density; } modes[] =
+    {
+        { 2047, 255, 4 },   // full range, coarse quantizer
+        {  200,  16, 4 },   // typical quality 85-95 content
+        {   30,  99, 3 },   // sparse low energy blocks
+        { 1023,  16, 1 },   // dense blocks, saturating output
+    };
+
+    typedef IppStatus (*ScaledIdctIpp)(const Ipp16s*, Ipp8u*, int, const Ipp16u*);
+    typedef void (*ScaledIdctAVX2)(const int16_t*, uint8_t*, int, const uint16_t*,
+                                   const int16_t*, uint8_t*, int, const uint16_t*);
+
+    // inverse DCTs of 1/2 and 1/4 size decoding
+    const struct { int size; ScaledIdctIpp ipp; ScaledIdctAVX2 avx2; } scaledIdcts[] =
+    {
+        { 4, mfxiDCTQuantInv8x8To4x4LS_JPEG_16s8u_C1R, DCTQuantInv8x8To4x4LS_JPEG_16s8u_C1R_x2_AVX2 },
+        { 2, mfxiDCTQuantInv8x8To2x2LS_JPEG_16s8u_C1R, DCTQuantInv8x8To2x2LS_JPEG_16s8u_C1R_x2_AVX2 },
+    };
+}
+
+TEST_F(JpegDecAVX2Test, IdctMatchesIpp)
+{
+    if (!JpegDecUseAVX2())
+        GTEST_SKIP() << "CPU has no AVX2";
+
+    for (int it = 0; it < 40000; it++)
+    {
+        auto& mode = modes[it % 4];
+        alignas(32) int16_t  coefs0[64], coefs1[64];
+        alignas(32) uint16_t qt0[64], qt1[64];
+        FillBlock(coefs0, qt0, mode.range, mode.maxQ, mode.density);
+        FillBlock(coefs1, qt1, mode.range, mode.maxQ, mode.density);
+
+        uint8_t ref0[8 * 16] = {}, ref1[8 * 16] = {}, dst0[8 * 16] = {}, dst1[8 * 16] = {};
+        mfxiDCTQuantInv8x8LS_JPEG_16s8u_C1R(coefs0, ref0, 16, qt0);
+        mfxiDCTQuantInv8x8LS_JPEG_16s8u_C1R(coefs1, ref1, 16, qt1);
+        DCTQuantInv8x8LS_JPEG_16s8u_C1R_x2_AVX2(coefs0, dst0, 16, qt0, coefs1, dst1, 16, qt1);
+
+        ASSERT_EQ(0, memcmp(ref0, dst0, sizeof(ref0))) << "iteration " << it;
+        ASSERT_EQ(0, memcmp(ref1, dst1, sizeof(ref1))) << "iteration " << it;
+    }
+}
+
+TEST_F(JpegDecAVX2Test, ScaledIdctMatchesIpp)
+{
+    if (!JpegDecUseAVX2())
+        GTEST_SKIP() << "CPU has no AVX2";
+
+    for (auto& idct : scaledIdcts)
+    {
+        for (int it = 0; it < 40000; it++)
+        {
+            auto& mode = modes[it % 4];
+            alignas(32) int16_t  coefs0[64], coefs1[64];
+            alignas(32) uint16_t qt0[64], qt1[64];
+            FillBlock(coefs0, qt0, mode.range, mode.maxQ, mode.density);
+            FillBlock(coefs1, qt1, mode.range, mode.maxQ, mode.density);
+
+            // bytes around the output must stay intact
+            uint8_t ref0[8 * 16], ref1[8 * 16], dst0[8 * 16], dst1[8 * 16];
+            memset(ref0, 0x5a, sizeof(ref0)); memset(ref1, 0x5a, sizeof(ref1));
+            memset(dst0, 0x5a, sizeof(dst0)); memset(dst1, 0x5a, sizeof(dst1));
+            idct.ipp(coefs0, ref0 + 17, 16, qt0);
+            idct.ipp(coefs1, ref1 + 17, 16, qt1);
+            idct.avx2(coefs0, dst0 + 17, 16, qt0, coefs1, dst1 + 17, 16, qt1);
+
+            ASSERT_EQ(0, memcmp(ref0, dst0, sizeof(ref0))) << idct.size << "x" << idct.size << ", iteration " << it;
+            ASSERT_EQ(0, memcmp(ref1, dst1, sizeof(ref1))) << idct.size << "x" << idct.size << ", iteration " << it;
+        }
+    }
+}
+
+TEST_F(JpegDecAVX2Test, UpsamplingMatchesIpp)
+{
+    if (!JpegDecUseAVX2())
+        GTEST_SKIP() << "CPU has no AVX2";
+
+    for (int it = 0; it < 4000; it++)
+    {
+        int width = Rand(18, 300);
+        std::vector<uint8_t> src1(width), src2(width);
+        std::vector<uint8_t> ref(2 * width + 64, 0xAA), dst(2 * width + 64, 0xAA);
+        Fill(src1);
+        Fill(src2);
+
+        mfxiSampleUpRowH2V1_Triangle_JPEG_8u_C1(src1.data(), width, ref.data());
+        SampleUpRowH2V1_Triangle_JPEG_8u_C1_AVX2(src1.data(), width, dst.data());
+        ASSERT_EQ(ref, dst) << "H2V1 width " << width;
+
+        mfxiSampleUpRowH2V2_Triangle_JPEG_8u_C1(src1.data(), src2.data(), width, ref.data());
+        SampleUpRowH2V2_Triangle_JPEG_8u_C1_AVX2(src1.data(), src2.data(), width, dst.data());
+        ASSERT_EQ(ref, dst) << "H2V2 width " << width;
+    }
+}
+
+TEST_F(JpegDecAVX2Test, ColorConversionMatchesIpp)
+{
+    if (!JpegDecUseAVX2())
+        GTEST_SKIP() << "CPU has no AVX2";
+
+    const int step = 256;
+
+    for (int it = 0; it < 1000; it++)
+    {
+        mfxSize roi = { Rand(32, 200), Rand(1, 4) };
+        std::vector<uint8_t> y(step * roi.height), u(step * roi.height), v(step * roi.height);
+        std::vector<uint8_t> ref(4 * step * roi.height, 0x55), dst(4 * step * roi.height, 0x55);
+        Fill(y);
+        Fill(u);
+        Fill(v);
+        if (it % 3 == 0)
+        {
+            // saturated chroma checks clamping of every output channel
+            for (auto& c : u) c = Rand(0, 1) ? 0 : 255;
+            for (auto& c : v) c = Rand(0, 1) ? 0 : 255;
+        }
+
+        const uint8_t* pYCC[3] = { y.data(), u.data(), v.data() };
+        mfxiYCbCrToBGR_JPEG_8u_P3C4R(pYCC, step, ref.data(), 4 * step, roi, 0xFF);
+
+        int done = YCbCrToBGR_JPEG_8u_P3C4R_AVX2(pYCC, step, dst.data(), 4 * step, roi, 0xFF);
+        ASSERT_EQ(roi.width & ~31, done);
+
+        mfxSize tail = { roi.width - done, roi.height };
+        const uint8_t* pTail[3] = { y.data() + done, u.data() + done, v.data() + done };
+        if (tail.width)
+            mfxiYCbCrToBGR_JPEG_8u_P3C4R(pTail, step, dst.data() + 4 * done, 4 * step, tail, 0xFF);
+
+        ASSERT_EQ(ref, dst) << "width " << roi.width << " height " << roi.height;
+    }
+}
+
+TEST_F(JpegDecAVX2Test, InterleaveUV)
+{
+    if (!JpegDecUseAVX2())
+        GTEST_SKIP() << "CPU has no AVX2";
+
+    for (int width = 1; width < 300; width++)
+    {
+        std::vector<uint8_t> u(width), v(width), ref(2 * width + 64, 0x33), dst(2 * width + 64, 0x33);
+        Fill(u);
+        Fill(v);
+        for (int x = 0; x < width; x++)
+        {
+            ref[2 * x + 0] = u[x];
+            ref[2 * x + 1] = v[x];
+        }
+
+        InterleaveUV_8u_AVX2(u.data(), v.data(), width, dst.data());
+        ASSERT_EQ(ref, dst) << "width " << width;
+    }
+}
+
+TEST_F(JpegDecAVX2Test, IdctTiming)
+{
+    if (!JpegDecUseAVX2())
+        GTEST_SKIP() << "CPU has no AVX2";
+
+    const int blocks = 256, iterations = 200;
+    std::vector<int16_t>  coefs(64 * blocks);
+    std::vector<uint16_t> qt(64 * blocks);
+    std::vector<uint8_t>  dst(64 * blocks);
+    for (int b = 0; b < blocks; b++)
+        FillBlock(&coefs[64 * b], &qt[64 * b], 200, 16, 4);
+
+    double ipp = mfx_unit_test::MeasureSeconds(iterations, [&]()
+    {
+        for (int b = 0; b < blocks; b++)
+            mfxiDCTQuantInv8x8LS_JPEG_16s8u_C1R(&coefs[64 * b], &dst[64 * b], 8, &qt[64 * b]);
+    });
+    double avx2 = mfx_unit_test::MeasureSeconds(iterations, [&]()
+    {
+        for (int b = 0; b < blocks; b += 2)
+            DCTQuantInv8x8LS_JPEG_16s8u_C1R_x2_AVX2(&coefs[64 * b], &dst[64 * b], 8, &qt[64 * b],
+                                                    &coefs[64 * (b + 1)], &dst[64 * (b + 1)], 8, &qt[64 * (b + 1)]);
+    });
+
+    mfx_unit_test::ReportTiming("ipp", ipp, "avx2", avx2);
+}
+
+TEST_F(JpegDecAVX2Test, ScaledIdctTiming)
+{
+    if (!JpegDecUseAVX2())
+        GTEST_SKIP() << "CPU has no AVX2";
+
+    const int blocks = 256, iterations = 200;
+    std::vector<int16_t>  coefs(64 * blocks);
+    std::vector<uint16_t> qt(64 * blocks);
+    std::vector<uint8_t>  dst(64 * blocks);
+    for (int b = 0; b < blocks; b++)
+        FillBlock(&coefs[64 * b], &qt[64 * b], 200, 16, 4);
+
+    for (auto& idct : scaledIdcts)
+    {
+        double ipp = mfx_unit_test::MeasureSeconds(iterations, [&]()
+        {
+            for (int b = 0; b < blocks; b++)
+                idct.ipp(&coefs[64 * b], &dst[64 * b], 8, &qt[64 * b]);
+        });
+        double avx2 = mfx_unit_test::MeasureSeconds(iterations, [&]()
+        {
+            for (int b = 0; b < blocks; b += 2)
+                idct.avx2(&coefs[64 * b], &dst[64 * b], 8, &qt[64 * b],
+                          &coefs[64 * (b + 1)], &dst[64 * (b + 1)], 8, &qt[64 * (b + 1)]);
+        });
+
+        std::cout << "[   IDCT   ] " << idct.size << "x" << idct.size << "\n";
+        mfx_unit_test::ReportTiming("ipp", ipp, "avx2", avx2);
+    }
+}
+
+TEST_F(JpegDecAVX2Test, UpsamplingAndColorConversionTiming)
+{
+    if (!JpegDecUseAVX2())
+        GTEST_SKIP() << "CPU has no AVX2";
+
+    const int step = 1024, iterations = 200;
+    mfxSize roi = { 1024, 8 };
+    std::vector<uint8_t> y(step * roi.height), u(step * roi.height), v(step * roi.height);
+    std::vector<uint8_t> up(2 * step), bgr(4 * step * roi.height);
+    Fill(y);
+    Fill(u);
+    Fill(v);
+    const uint8_t* pYCC[3] = { y.data(), u.data(), v.data() };
+
+    double ipp = mfx_unit_test::MeasureSeconds(iterations, [&]()
+    {
+        for (int row = 0; row < roi.height; row++)
+            mfxiSampleUpRowH2V2_Triangle_JPEG_8u_C1(&u[row * step], &v[row * step], step / 2, up.data());
+        mfxiYCbCrToBGR_JPEG_8u_P3C4R(pYCC, step, bgr.data(), 4 * step, roi, 0xFF);
+    });
+    double avx2 = mfx_unit_test::MeasureSeconds(iterations, [&]()
+    {
+        for (int row = 0; row < roi.height; row++)
+            SampleUpRowH2V2_Triangle_JPEG_8u_C1_AVX2(&u[row * step], &v[row * step], step / 2, up.data());
+        YCbCrToBGR_JPEG_8u_P3C4R_AVX2(pYCC, step, bgr.data(), 4 * step, roi, 0xFF);
+    });
+
+    mfx_unit_test::ReportTiming("ipp", ipp, "avx2", avx2);
+}
@@ -0,0 +1,327 @@
+// Copyright (c) 2020 Intel Corporation
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "mfx_unit_test_utils.h"
+
+#include "mfx_mjpeg_encode.h"
+#include "umc_mjpeg_video_encoder.h"
+#include "umc_video_data.h"
+
+#include <random>
+#include <thread>
+#include <vector>
+
+// Frames of mfxExtJPEGBatch are encoded whole by MJPEGVideoEncoder::EncodeFrame().
+// It must produce the same stream as the pieces + PostProcessing() path used
+// for the main frame, and a batch must not reference a surface or a bitstream
+// twice since its frames are encoded in parallel.
+
+using namespace UMC;
+
+namespace
+{
+    const int width = 640, height = 480;
+
+    void InitParams(MJPEGEncoderParams& params, mfxU16 quality, int restartInterval)
+    {
+        params.quality                  = quality;
+        params.restart_interval         = restartInterval;
+        params.numThreads               = 4;
+        params.info.clip_info.width     = width;
+        params.info.clip_info.height    = height;
+        params.info.color_format        = NV12;
+        params.info.interlace_type      = PROGRESSIVE;
+        params.chroma_format            = MFX_CHROMAFORMAT_YUV420;
+        params.interleaved              = 1;
+        params.profile                  = 1;
+        params.buf_size                 = width * height * 2;
+    }
+
+    class JpegEncBatchTest : public ::testing::Test
+    {
+    protected:
+        void SetUp() override
+        {
+            image.resize(width * height * 3 / 2);
+            // smooth gradient with noise gives realistic coefficient statistics
+            for (int y = 0; y < height * 3 / 2; y++)
+                for (int x = 0; x < width; x++)
+                    image[y * width + x] = (mfxU8)((x + y) / 5 + std::uniform_int_distribution<int>(0, 15)(rng));
+        }
+
+        // YUV420 picture of 'image' with scans split by restart interval
+        MJPEGEncoderPicture* MakePicture(int restartInterval)
+        {
+            MJPEGEncoderPicture* pic = new MJPEGEncoderPicture();
+            VideoData* data = pic->m_sourceData.get();
+            data->Init(width, height, YUV420, 8);
+            data->SetImageSize(width, height);
+            data->SetPlanePointer(image.data(), 0);
+            data->SetPlanePitch(width, 0);
+            data->SetPlanePointer(image.data() + width * height, 1);
+            data->SetPlanePitch(width / 2, 1);
+            data->SetPlanePointer(image.data() + width * height * 5 / 4, 2);
+            data->SetPlanePitch(width / 2, 2);
+
+            MJPEGEncoderScan* scan = new MJPEGEncoderScan();
+            int mcus = (width / 16) * (height / 16);
+            scan->Init(restartInterval ? (mcus + restartInterval - 1) / restartInterval : 1);
+            pic->m_scans.push_back(scan);
+            return pic;
+        }
+
+        // the way the main frame of a task is encoded
+        Status EncodePieces(MJPEGVideoEncoder& encoder, int restartInterval, MediaData& out)
+        {
+            Status sts = encoder.AddPicture(MakePicture(restartInterval));
+            for (uint32_t i = 0; i < encoder.NumPiecesCollected() && UMC_OK == sts; i++)
+                sts = encoder.EncodePiece(i % 4, i);
+
+            if (UMC_OK == sts)
+                sts = encoder.PostProcessing(&out);
+            encoder.Reset();
+            return sts;
+        }
+
+        // the way a batch frame is encoded
+        Status EncodeFrame(MJPEGVideoEncoder& encoder, int restartInterval, mfxU16 quality, MediaData& out)
+        {
+            MJPEGEncoderFrame frame;
+            frame.m_pics.push_back(MakePicture(restartInterval));
+
+            return encoder.EncodeFrame(1, &frame, quality, &out);
+        }
+
+        std::vector<mfxU8> EncodePieces(MJPEGVideoEncoder& encoder, int restartInterval)
+        {
+            std::vector<mfxU8> buf(width * height * 3);
+            MediaData out;
+            out.SetBufferPointer(buf.data(), buf.size());
+            EXPECT_EQ(UMC_OK, EncodePieces(encoder, restartInterval, out));
+            buf.resize(out.GetDataSize());
+            return buf;
+        }
+
+        std::vector<mfxU8> EncodeFrame(MJPEGVideoEncoder& encoder, int restartInterval, mfxU16 quality)
+        {
+            std::vector<mfxU8> buf(width * height * 3);
+            MediaData out;
+            out.SetBufferPointer(buf.data(), buf.size());
+            EXPECT_EQ(UMC_OK, EncodeFrame(encoder, restartInterval, quality, out));
+            buf.resize(out.GetDataSize());
+            return buf;
+        }
+
+        std::vector<mfxU8> image;
+        std::mt19937 rng{2020};
+    };
+}
+
+TEST_F(JpegEncBatchTest, EncodeFrameMatchesPieces)
+{
+    for (int restartInterval : { 0, 7, 40 })
+    {
+        MJPEGEncoderParams params;
+        InitParams(params, 75, restartInterval);
+
+        MJPEGVideoEncoder pieces, frame;
+        ASSERT_EQ(UMC_OK, pieces.Init(&params));
+        ASSERT_EQ(UMC_OK, frame.Init(&params));
+
+        std::vector<mfxU8> ref = EncodePieces(pieces, restartInterval);
+        EXPECT_EQ(ref, EncodeFrame(frame, restartInterval, 0)) << "restart interval " << restartInterval;
+
+        // batch frame doesn't change tables of the main frame
+        EXPECT_EQ(ref, EncodePieces(frame, restartInterval)) << "restart interval " << restartInterval;
+    }
+}
+
+TEST_F(JpegEncBatchTest, EncodeFrameQualityOverride)
+{
+    MJPEGEncoderParams params75, params50;
+    InitParams(params75, 75, 0);
+    InitParams(params50, 50, 0);
+
+    MJPEGVideoEncoder encoder75, encoder50;
+    ASSERT_EQ(UMC_OK, encoder75.Init(&params75));
+    ASSERT_EQ(UMC_OK, encoder50.Init(&params50));
+
+    std::vector<mfxU8> ref = EncodePieces(encoder50, 0);
+    EXPECT_EQ(ref, EncodeFrame(encoder75, 0, 50));
+    EXPECT_NE(ref, EncodePieces(encoder75, 0));
+}
+
+TEST_F(JpegEncBatchTest, EncodeFrameNotEnoughBuffer)
+{
+    MJPEGEncoderParams params;
+    InitParams(params, 75, 0);
+
+    MJPEGVideoEncoder encoder;
+    ASSERT_EQ(UMC_OK, encoder.Init(&params));
+
+    std::vector<mfxU8> ref = EncodePieces(encoder, 0);
+    MediaData out;
+    out.SetBufferPointer(ref.data(), ref.size() - 3);
+    EXPECT_EQ(UMC_ERR_NOT_ENOUGH_BUFFER, EncodeFrame(encoder, 0, 0, out));
+}
+
+TEST_F(JpegEncBatchTest, EncodeFrameTiming)
+{
+    // without restart intervals a frame is a single piece, so frames of a task
+    // are encoded one after another, while batch frames run on all threads
+    const int frames = 4, iterations = 10;
+    if (std::thread::hardware_concurrency() < frames)
+        GTEST_SKIP() << "less than " << frames << " CPUs";
+
+    MJPEGEncoderParams params;
+    InitParams(params, 75, 0);
+
+    MJPEGVideoEncoder encoder;
+    ASSERT_EQ(UMC_OK, encoder.Init(&params));
+    std::vector<std::vector<mfxU8>> buf(frames, std::vector<mfxU8>(width * height * 3));
+    std::vector<MediaData> out(frames);
+
+    double pieces = mfx_unit_test::MeasureSeconds(iterations, [&]()
+    {
+        for (int i = 0; i < frames; i++)
+        {
+            out[i].SetBufferPointer(buf[i].data(), buf[i].size());
+            EncodePieces(encoder, 0, out[i]);
+        }
+    });
+    double batch = mfx_unit_test::MeasureSeconds(iterations, [&]()
+    {
+        std::vector<std::thread> threads;
+        for (int i = 0; i < frames; i++)
+        {
+            threads.emplace_back([&, i]()
+            {
+                MJPEGEncoderFrame frame;
+                frame.m_pics.push_back(MakePicture(0));
+                out[i].SetBufferPointer(buf[i].data(), buf[i].size());
+                encoder.EncodeFrame(i, &frame, 0, &out[i]);
+            });
+        }
+        for (auto& thread : threads)
+            thread.join();
+    });
+
+    mfx_unit_test::ReportTiming("pieces", pieces, "batch", batch);
+
+    std::vector<mfxU8> ref = EncodePieces(encoder, 0);
+    for (int i = 0; i < frames; i++)
+        EXPECT_EQ(ref, std::vector<mfxU8>(buf[i].data(), buf[i].data() + out[i].GetDataSize())) << "frame " << i;
+}
+
+#if (MFX_VERSION >= MFX_VERSION_NEXT)
+namespace
+{
+    // exposes batch validation of the software encoder, no core is needed for it
+    class BatchCheckEncoder : public MFXVideoENCODEMJPEG
+    {
+    public:
+        BatchCheckEncoder()
+            : MFXVideoENCODEMJPEG(nullptr, &m_status)
+        {
+            m_vParam.mfx.FrameInfo.FourCC       = MFX_FOURCC_NV12;
+            m_vParam.mfx.FrameInfo.ChromaFormat = MFX_CHROMAFORMAT_YUV420;
+        }
+
+        using MFXVideoENCODEMJPEG::CheckBatch;
+
+    private:
+        mfxStatus m_status;
+    };
+
+    class JpegEncBatchCheckTest : public ::testing::Test
+    {
+    protected:
+        void SetUp() override
+        {
+            for (int i = 0; i < 4; i++)
+            {
+                surfaces[i].Info.FourCC       = MFX_FOURCC_NV12;
+                surfaces[i].Info.ChromaFormat = MFX_CHROMAFORMAT_YUV420;
+                surfaces[i].Info.Width        = surfaces[i].Info.CropW = 64;
+                surfaces[i].Info.Height       = surfaces[i].Info.CropH = 64;
+                surfaces[i].Data.Y            = planes[i];
+                surfaces[i].Data.UV           = planes[i] + 64 * 64;
+                surfaces[i].Data.Pitch        = 64;
+
+                bitstreams[i].Data      = data[i];
+                bitstreams[i].MaxLength = sizeof(data[i]);
+            }
+
+            // frame 0 is the main one
+            batch.Header.BufferId = MFX_EXTBUFF_JPEG_BATCH;
+            batch.Header.BufferSz = sizeof(batch);
+            batch.NumFrame        = 3;
+            batch.Surfaces        = batchSurfaces;
+            batch.Bitstreams      = batchBitstreams;
+            for (int i = 0; i < 3; i++)
+            {
+                batchSurfaces[i]   = &surfaces[i + 1];
+                batchBitstreams[i] = &bitstreams[i + 1];
+            }
+        }
+
+        mfxStatus Check()
+        {
+            return encoder.CheckBatch(&batch, &surfaces[0], &bitstreams[0]);
+        }
+
+        BatchCheckEncoder  encoder;
+        mfxU8              planes[4][64 * 64 * 3 / 2] = {};
+        mfxU8              data[4][1024] = {};
+        mfxFrameSurface1   surfaces[4] = {};
+        mfxBitstream       bitstreams[4] = {};
+        mfxFrameSurface1*  batchSurfaces[3] = {};
+        mfxBitstream*      batchBitstreams[3] = {};
+        mfxExtJPEGBatch    batch = {};
+    };
+}
+
+TEST_F(JpegEncBatchCheckTest, AcceptsDistinctFrames)
+{
+    EXPECT_EQ(MFX_ERR_NONE, Check());
+}
+
+TEST_F(JpegEncBatchCheckTest, RejectsDuplicateSurface)
+{
+    batchSurfaces[2] = batchSurfaces[0];
+    EXPECT_EQ(MFX_ERR_UNDEFINED_BEHAVIOR, Check());
+}
+
+TEST_F(JpegEncBatchCheckTest, RejectsDuplicateBitstream)
+{
+    batchBitstreams[2] = batchBitstreams[1];
+    EXPECT_EQ(MFX_ERR_UNDEFINED_BEHAVIOR, Check());
+}
+
+TEST_F(JpegEncBatchCheckTest, RejectsMainFrameBuffers)
+{
+    batchSurfaces[1] = &surfaces[0];
+    EXPECT_EQ(MFX_ERR_UNDEFINED_BEHAVIOR, Check());
+
+    batchSurfaces[1]   = &surfaces[2];
+    batchBitstreams[0] = &bitstreams[0];
+    EXPECT_EQ(MFX_ERR_UNDEFINED_BEHAVIOR, Check());
+}
+#endif
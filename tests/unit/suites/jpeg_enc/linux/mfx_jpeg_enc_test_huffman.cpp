@@ -0,0 +1,227 @@
+// Copyright (c) 2020 Intel Corporation
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "mfx_unit_test_utils.h"
+
+#include "umc_mjpeg_video_encoder.h"
+#include "umc_video_data.h"
+#include "jpegdec.h" // CJPEGDecoder, when MFX_ENABLE_MJPEG_VIDEO_DECODE is on
+
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+// With huffman_opt GenerateHuffmanTablesEX() builds tables from the statistics
+// of every scan. Quantized coefficients don't depend on the tables, so the
+// optimized stream must decode to exactly the same picture as the one coded
+// with default tables, and must be smaller.
+
+using namespace UMC;
+
+namespace
+{
+    const int width = 640, height = 480;
+
+    class JpegEncHuffmanTest : public ::testing::Test
+    {
+    protected:
+        void SetUp() override
+        {
+            image.resize(width * height * 3 / 2);
+            // smooth gradient with noise gives realistic coefficient statistics
+            for (int y = 0; y < height * 3 / 2; y++)
+                for (int x = 0; x < width; x++)
+                    image[y * width + x] = (mfxU8)((x + y) / 5 + std::uniform_int_distribution<int>(0, 15)(rng));
+        }
+
+        // YUV420 picture of 'image' coded in one interleaved scan or in a scan per component
+        MJPEGEncoderPicture* MakePicture(int interleaved, uint32_t numPieces = 1)
+        {
+            MJPEGEncoderPicture* pic = new MJPEGEncoderPicture();
+            VideoData* data = pic->m_sourceData.get();
+            data->Init(width, height, YUV420, 8);
+            data->SetImageSize(width, height);
+            data->SetPlanePointer(image.data(), 0);
+            data->SetPlanePitch(width, 0);
+            data->SetPlanePointer(image.data() + width * height, 1);
+            data->SetPlanePitch(width / 2, 1);
+            data->SetPlanePointer(image.data() + width * height * 5 / 4, 2);
+            data->SetPlanePitch(width / 2, 2);
+
+            for (int i = 0; i < (interleaved ? 1 : 3); i++)
+            {
+                MJPEGEncoderScan* scan = new MJPEGEncoderScan();
+                scan->Init(numPieces);
+                pic->m_scans.push_back(scan);
+            }
+            return pic;
+        }
+
+        std::vector<mfxU8> Encode(MJPEGVideoEncoder& encoder, int interleaved)
+        {
+            std::vector<mfxU8> buf(width * height * 3);
+            MediaData out;
+            out.SetBufferPointer(buf.data(), buf.size());
+
+            Status sts = encoder.AddPicture(MakePicture(interleaved));
+            for (uint32_t i = 0; i < encoder.NumPiecesCollected() && UMC_OK == sts; i++)
+                sts = encoder.EncodePiece(0, i);
+            if (UMC_OK == sts)
+                sts = encoder.PostProcessing(&out);
+            encoder.Reset();
+
+            EXPECT_EQ(UMC_OK, sts);
+            buf.resize(UMC_OK == sts ? out.GetDataSize() : 0);
+            return buf;
+        }
+
+#if defined (MFX_ENABLE_MJPEG_VIDEO_DECODE)
+        // NV12 picture decoded by the software decoder
+        std::vector<mfxU8> Decode(std::vector<mfxU8> const& stream)
+        {
+            if (stream.empty())
+                return {};
+
+            CJPEGDecoder decoder;
+            int w = 0, h = 0, channels = 0, precision = 0;
+            JCOLOR color;
+            JSS sampling;
+            EXPECT_EQ(JPEG_OK, decoder.SetSource(stream.data(), stream.size()));
+            EXPECT_EQ(JPEG_OK, decoder.ReadHeader(&w, &h, &channels, &color, &sampling, &precision));
+            EXPECT_EQ(width, w);
+            EXPECT_EQ(height, h);
+            EXPECT_EQ(JS_420, sampling);
+
+            std::vector<mfxU8> nv12(width * height * 3 / 2);
+            uint8_t* planes[4] = { nv12.data(), nv12.data() + width * height, nullptr, nullptr };
+            int      pitches[4] = { width, width, 0, 0 };
+            mfxSize  size = { width, height };
+            EXPECT_EQ(JPEG_OK, decoder.SetDestination(planes, pitches, size, channels, JC_NV12, JS_420));
+            EXPECT_EQ(JPEG_OK, decoder.ReadData());
+            return nv12;
+        }
+
+        double MeanLumaDiff(std::vector<mfxU8> const& nv12)
+        {
+            if (nv12.empty())
+                return 255.;
+
+            long sum = 0;
+            for (int i = 0; i < width * height; i++)
+                sum += std::abs(nv12[i] - image[i]);
+            return (double)sum / (width * height);
+        }
+#endif
+
+        static void InitParams(MJPEGEncoderParams& params, mfxU16 quality, int interleaved, int huffmanOpt)
+        {
+            params.quality                  = quality;
+            params.huffman_opt              = huffmanOpt;
+            params.numThreads               = 1;
+            params.info.clip_info.width     = width;
+            params.info.clip_info.height    = height;
+            params.info.color_format        = NV12;
+            params.info.interlace_type      = PROGRESSIVE;
+            params.chroma_format            = MFX_CHROMAFORMAT_YUV420;
+            params.interleaved              = interleaved;
+            params.profile                  = 1;
+            params.buf_size                 = width * height * 2;
+        }
+
+        std::vector<mfxU8> image;
+        std::mt19937 rng{2020};
+    };
+}
+
+TEST_F(JpegEncHuffmanTest, OptimizedTablesDecodeToSamePicture)
+{
+    for (int interleaved : { 1, 0 })
+    {
+        for (mfxU16 quality : { 50, 75, 90 })
+        {
+            MJPEGEncoderParams defaultParams, optimizedParams;
+            InitParams(defaultParams, quality, interleaved, 0);
+            InitParams(optimizedParams, quality, interleaved, 1);
+
+            MJPEGVideoEncoder defaultEncoder, optimizedEncoder;
+            ASSERT_EQ(UMC_OK, defaultEncoder.Init(&defaultParams));
+            ASSERT_EQ(UMC_OK, optimizedEncoder.Init(&optimizedParams));
+
+            std::vector<mfxU8> ref = Encode(defaultEncoder, interleaved);
+            std::vector<mfxU8> opt = Encode(optimizedEncoder, interleaved);
+
+            EXPECT_LT(opt.size(), ref.size()) << "interleaved " << interleaved << ", quality " << quality;
+#if defined (MFX_ENABLE_MJPEG_VIDEO_DECODE)
+            // CJPEGDecoder::ReadData() decodes a whole picture only if it is a single interleaved scan
+            if (interleaved)
+            {
+                std::vector<mfxU8> refPicture = Decode(ref);
+                EXPECT_EQ(refPicture, Decode(opt)) << "quality " << quality;
+                EXPECT_LT(MeanLumaDiff(refPicture), 8.) << "quality " << quality;
+            }
+#endif
+
+            // tables of the previous picture don't leak into the next one
+            EXPECT_EQ(opt, Encode(optimizedEncoder, interleaved)) << "interleaved " << interleaved << ", quality " << quality;
+        }
+    }
+}
+
+TEST_F(JpegEncHuffmanTest, OptimizedTablesRejectRestartInterval)
+{
+    MJPEGEncoderParams params;
+    InitParams(params, 75, 1, 1);
+    params.restart_interval = 10;
+
+    MJPEGVideoEncoder encoder;
+    ASSERT_EQ(UMC_OK, encoder.Init(&params));
+
+    // tables are built for the whole scan and can't be split into restart intervals
+    Status sts = encoder.AddPicture(MakePicture(1, ((width / 16) * (height / 16) + 9) / 10));
+    for (uint32_t i = 0; i < encoder.NumPiecesCollected() && UMC_OK == sts; i++)
+        sts = encoder.EncodePiece(0, i);
+    EXPECT_NE(UMC_OK, sts);
+}
+
+TEST_F(JpegEncHuffmanTest, OptimizedTablesTiming)
+{
+    const int iterations = 10;
+
+    MJPEGEncoderParams defaultParams, optimizedParams;
+    InitParams(defaultParams, 75, 1, 0);
+    InitParams(optimizedParams, 75, 1, 1);
+
+    MJPEGVideoEncoder defaultEncoder, optimizedEncoder;
+    ASSERT_EQ(UMC_OK, defaultEncoder.Init(&defaultParams));
+    ASSERT_EQ(UMC_OK, optimizedEncoder.Init(&optimizedParams));
+
+    size_t defaultSize = 0, optimizedSize = 0;
+    double defaultTime = mfx_unit_test::MeasureSeconds(iterations, [&]()
+    {
+        defaultSize = Encode(defaultEncoder, 1).size();
+    });
+    double optimizedTime = mfx_unit_test::MeasureSeconds(iterations, [&]()
+    {
+        optimizedSize = Encode(optimizedEncoder, 1).size();
+    });
+
+    mfx_unit_test::ReportTiming("default tables", defaultTime, "optimized tables", optimizedTime);
+    std::cout << "[   SIZE   ] picture size: default " << defaultSize << " B, optimized " << optimizedSize << " B\n";
+}
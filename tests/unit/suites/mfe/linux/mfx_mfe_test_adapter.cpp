@@ -0,0 +1,238 @@
+// Copyright (c) 2020 Intel Corporation
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "mfx_unit_test_utils.h"
+
+#include "mfx_common.h"
+#include "mfx_mfe_adapter.h"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+// MFEVAAPIEncoder is run by several encoding threads against stubbed
+// multi-frame libva calls, which record the size of every submitted batch.
+
+namespace
+{
+    std::mutex           g_stubGuard;
+    std::vector<int>     g_batches;     // frames in each vaMFSubmit call
+    std::atomic<int>     g_released(0); // vaMFReleaseContext calls
+    VAStatus             g_addStatus = VA_STATUS_SUCCESS;
+}
+
+VAStatus vaDestroyContext(VADisplay, VAContextID)
+{
+    return VA_STATUS_SUCCESS;
+}
+
+VAStatus vaCreateMFContext(VADisplay, VAMFContextID* mf_context)
+{
+    *mf_context = 1;
+    return VA_STATUS_SUCCESS;
+}
+
+VAStatus vaMFAddContext(VADisplay, VAMFContextID, VAContextID)
+{
+    return g_addStatus;
+}
+
+VAStatus vaMFReleaseContext(VADisplay, VAMFContextID, VAContextID)
+{
+    g_released++;
+    return VA_STATUS_SUCCESS;
+}
+
+VAStatus vaMFSubmit(VADisplay, VAMFContextID, VAContextID*, int num_contexts)
+{
+    std::lock_guard<std::mutex> guard(g_stubGuard);
+    g_batches.push_back(num_contexts);
+    return VA_STATUS_SUCCESS;
+}
+
+namespace
+{
+    const VADisplay   Display  = (VADisplay)0x1;
+    const VAContextID FirstCtx = 16;
+
+    struct SimResult
+    {
+        double       avgWaitUs;   // average time spent in Submit
+        int          fullBatches; // batches of all streams
+        int          batches;
+        int          timeouts;    // batches of less than all streams
+        int          frames;      // frames in all batches
+        int          errors;
+        MFEBatchStat stat;
+    };
+
+    // numStreams streams submit a frame each period microseconds (with up to 1 ms jitter),
+    // the last stream skips frames [pauseFrom, pauseFrom + pauseLen).
+    // Adapter takes ownership of policy, default one is used if it is null
+    SimResult Simulate(MFEBatchPolicy* policy, mfxU32 numStreams, long long period, int frames, int pauseFrom, int pauseLen)
+    {
+        g_batches.clear();
+
+        MFEVAAPIEncoder mfe;
+        mfxExtMultiFrameParam par = {};
+        par.MFMode       = MFX_MF_AUTO;
+        par.MaxNumFrames = (mfxU16)numStreams;
+
+        EXPECT_EQ(MFX_ERR_NONE, mfe.Create(par, Display));
+        if (policy)
+            mfe.SetBatchPolicy(policy);
+        for (mfxU32 s = 0; s < numStreams; s++)
+            EXPECT_EQ(MFX_ERR_NONE, mfe.Join(FirstCtx + s, period));
+
+        std::atomic<long long> waited(0);
+        std::atomic<int>       submitted(0), errors(0);
+        std::vector<std::thread> threads;
+
+        auto start = std::chrono::steady_clock::now();
+        for (mfxU32 s = 0; s < numStreams; s++)
+        {
+            threads.emplace_back([&, s]()
+            {
+                std::mt19937 rng(s);
+                for (int f = 0; f < frames; f++)
+                {
+                    if (s == numStreams - 1 && f >= pauseFrom && f < pauseFrom + pauseLen)
+                        continue;
+
+                    std::this_thread::sleep_until(start + std::chrono::microseconds(f * period + rng() % 1000));
+
+                    auto t0 = std::chrono::steady_clock::now();
+                    if (mfe.Submit(FirstCtx + s, period, false) != MFX_ERR_NONE)
+                        errors++;
+                    waited += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - t0).count();
+                    submitted++;
+                }
+            });
+        }
+        for (auto& t : threads)
+            t.join();
+
+        SimResult res = { double(waited) / submitted, 0, (int)g_batches.size(), 0, 0, errors, {} };
+        for (int n : g_batches)
+        {
+            res.fullBatches += n == (int)numStreams;
+            res.timeouts    += n <  (int)numStreams;
+            res.frames      += n;
+        }
+        mfe.GetBatchStat(res.stat);
+
+        return res;
+    }
+
+    class MFEAdapterTest : public ::testing::Test
+    {
+    protected:
+        void SetUp() override
+        {
+            g_addStatus = VA_STATUS_SUCCESS;
+            g_released  = 0;
+        }
+    };
+}
+
+TEST_F(MFEAdapterTest, JoinMapsDriverErrors)
+{
+    MFEVAAPIEncoder mfe;
+    mfxExtMultiFrameParam par = {};
+    ASSERT_EQ(MFX_ERR_NONE, mfe.Create(par, Display));
+
+    g_addStatus = VA_STATUS_ERROR_INVALID_CONTEXT;
+    EXPECT_EQ(MFX_ERR_UNDEFINED_BEHAVIOR, mfe.Join(FirstCtx, 33333));
+    g_addStatus = VA_STATUS_ERROR_UNSUPPORTED_ENTRYPOINT;
+    EXPECT_EQ(MFX_ERR_UNSUPPORTED, mfe.Join(FirstCtx, 33333));
+
+    // failed streams are not registered
+    EXPECT_EQ(MFX_ERR_UNDEFINED_BEHAVIOR, mfe.Disjoin(FirstCtx));
+    EXPECT_EQ(0, g_released);
+}
+
+TEST_F(MFEAdapterTest, DisjoinReleasesOnlyJoinedContexts)
+{
+    MFEVAAPIEncoder mfe;
+    mfxExtMultiFrameParam par = {};
+    ASSERT_EQ(MFX_ERR_NONE, mfe.Create(par, Display));
+    ASSERT_EQ(MFX_ERR_NONE, mfe.Join(FirstCtx, 33333));
+    ASSERT_EQ(MFX_ERR_NONE, mfe.Join(FirstCtx + 1, 33333));
+
+    EXPECT_EQ(MFX_ERR_UNDEFINED_BEHAVIOR, mfe.Disjoin(FirstCtx + 2));
+    EXPECT_EQ(0, g_released);
+
+    EXPECT_EQ(MFX_ERR_NONE, mfe.Disjoin(FirstCtx));
+    EXPECT_EQ(1, g_released);
+
+    EXPECT_EQ(MFX_ERR_UNDEFINED_BEHAVIOR, mfe.Disjoin(FirstCtx));
+    EXPECT_EQ(1, g_released);
+}
+
+TEST_F(MFEAdapterTest, SteadyStreamsAreCombined)
+{
+    for (bool adaptive : { false, true })
+    {
+        SimResult res = Simulate(adaptive ? new MFEAdaptiveBatchPolicy : nullptr, 3, 10000, 60, 0, 0);
+
+        EXPECT_EQ(0, res.errors);
+        // scheduling jitter of the test threads may break a few batches
+        EXPECT_GE(res.fullBatches * 10, res.batches * 9) << "adaptive " << adaptive;
+    }
+}
+
+TEST_F(MFEAdapterTest, BatchStatMatchesSubmissions)
+{
+    for (bool adaptive : { false, true })
+    {
+        SimResult res = Simulate(adaptive ? new MFEAdaptiveBatchPolicy : nullptr, 3, 10000, 60, 20, 20);
+
+        EXPECT_EQ(0, res.errors);
+        EXPECT_EQ((mfxU64)res.batches, res.stat.NumSubmissions)                  << "adaptive " << adaptive;
+        EXPECT_EQ((mfxU64)res.frames,  res.stat.NumFramesSubmitted)              << "adaptive " << adaptive;
+        // a batch can expect less than all streams when the rest were just submitted
+        EXPECT_LE(res.stat.NumTimeouts, (mfxU64)res.timeouts)                    << "adaptive " << adaptive;
+        EXPECT_LE(res.stat.NumFramesExpected, 3u * res.batches)                  << "adaptive " << adaptive;
+        EXPECT_GE(res.stat.NumFramesExpected - res.frames, res.stat.NumTimeouts) << "adaptive " << adaptive;
+        EXPECT_GE(res.stat.MaxWaitTime * res.stat.NumFramesSubmitted, res.stat.TotalWaitTime);
+    }
+}
+
+TEST_F(MFEAdapterTest, PausedStreamTiming)
+{
+    // one of 3 streams pauses for a third of the run: default (fixed) policy
+    // holds every frame of others for the whole budget, adaptive one shouldn't
+    SimResult fixed    = Simulate(nullptr,                    3, 10000, 90, 30, 30);
+    SimResult adaptive = Simulate(new MFEAdaptiveBatchPolicy, 3, 10000, 90, 30, 30);
+
+    EXPECT_EQ(0, fixed.errors);
+    EXPECT_EQ(0, adaptive.errors);
+    // batching is not given up once all streams are back
+    EXPECT_GE(adaptive.fullBatches, 45);
+
+    mfx_unit_test::ReportTiming("fixed", fixed.avgWaitUs * 1e-6, "adaptive", adaptive.avgWaitUs * 1e-6);
+    std::cout << "[   STAT   ] fill ratio: fixed "
+              << double(fixed.stat.NumFramesSubmitted) / fixed.stat.NumFramesExpected << ", adaptive "
+              << double(adaptive.stat.NumFramesSubmitted) / adaptive.stat.NumFramesExpected << "\n";
+}
@@ -0,0 +1,251 @@
+// Copyright (c) 2020 Intel Corporation
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "mfx_unit_test_utils.h"
+
+#include "annexb_scanner.h"
+#include "stream_index.h"
+
+#include <cstdio>
+#include <vector>
+
+// Streams are made of hand-written units: payload bytes are only good enough
+// for the fields the index reads (unit types, first slice flags, parameter set ids).
+
+namespace
+{
+    typedef std::vector<mfxU8> Bytes;
+
+    const msdk_char *StreamFile = MSDK_STRING("sample_common_test_stream.bin");
+    const msdk_char *IndexFile  = MSDK_STRING("sample_common_test_stream.idx");
+
+    Bytes Unit(std::initializer_list<mfxU8> payload)
+    {
+        Bytes unit = { 0, 0, 0, 1 };
+        unit.insert(unit.end(), payload);
+        return unit;
+    }
+
+    // seq_parameter_set_id is 0 (0xab) or 1 (0x4b), variant changes the rest of the payload
+    Bytes AvcSps(mfxU8 id, mfxU8 variant = 0)
+    {
+        return Unit({ 0x67, 0x42, 0x00, 0x1e, mfxU8(id ? 0x4b : 0xab), mfxU8(0x80 | variant), 0x80 });
+    }
+
+    // pic_parameter_set_id and seq_parameter_set_id are 0
+    Bytes AvcPps(mfxU32 variant = 0)
+    {
+        return Unit({ 0x68, 0xce, mfxU8(0x80 | (variant & 0x7f)), mfxU8(0x80 | ((variant >> 7) & 0x7f)),
+            mfxU8(0x80 | (variant >> 14)), 0x80 });
+    }
+
+    Bytes AvcIdr() { return Unit({ 0x65, 0x88, 0x84, 0x21, 0x10 }); }
+    Bytes AvcP()   { return Unit({ 0x41, 0x9a, 0x22, 0x11, 0x44 }); }
+
+    Bytes HevcVps() { return Unit({ 0x40, 0x01, 0x0c, 0x01, 0xff, 0xff, 0x80 }); }
+    Bytes HevcPps() { return Unit({ 0x44, 0x01, 0xc1, 0x73, 0xd1, 0x89 }); }
+
+    // sps_seq_parameter_set_id follows 4 + 3 + 1 bits and profile_tier_level() of 12 bytes
+    Bytes HevcSps(mfxU8 id)
+    {
+        Bytes sps = Unit({ 0x42, 0x01, 0x01 });
+        sps.insert(sps.end(), 12, 0x11);
+        sps.push_back(id ? 0x4b : 0xab);
+        sps.push_back(0x80);
+        return sps;
+    }
+
+    // first_slice_segment_in_pic_flag is 1
+    Bytes HevcPicture(mfxU8 type) { return Unit({ mfxU8(type << 1), 0x01, 0xaf, 0x12, 0x34 }); }
+
+    const mfxU8 HEVC_TRAIL_R = 1, HEVC_RASL_N = 8, HEVC_IDR_W_RADL = 19, HEVC_CRA = 21;
+
+    class StreamIndexTest : public ::testing::Test
+    {
+    protected:
+        void TearDown() override
+        {
+            remove(StreamFile);
+            remove(IndexFile);
+        }
+
+        // appends units to the stream, returns offset of the first one
+        mfxU64 Add(std::initializer_list<Bytes> units)
+        {
+            mfxU64 offset = stream.size();
+            for (const Bytes &unit : units)
+                stream.insert(stream.end(), unit.begin(), unit.end());
+            return offset;
+        }
+
+        void Write()
+        {
+            FILE *file = fopen(StreamFile, "wb");
+            ASSERT_NE(nullptr, file);
+            ASSERT_EQ(stream.size(), fwrite(stream.data(), 1, stream.size(), file));
+            fclose(file);
+        }
+
+        static Bytes Concat(std::initializer_list<Bytes> units)
+        {
+            Bytes data;
+            for (const Bytes &unit : units)
+                data.insert(data.end(), unit.begin(), unit.end());
+            return data;
+        }
+
+        Bytes stream;
+    };
+}
+
+TEST(AnnexBScannerTest, ParamSetKeys)
+{
+    EXPECT_EQ((7ull << 32) | 0, GetParamSetKey(MFX_CODEC_AVC, AvcSps(0)));
+    EXPECT_EQ((7ull << 32) | 1, GetParamSetKey(MFX_CODEC_AVC, AvcSps(1, 5)));
+    EXPECT_EQ((8ull << 32) | 0, GetParamSetKey(MFX_CODEC_AVC, AvcPps(123)));
+
+    EXPECT_EQ((32ull << 32) | 0, GetParamSetKey(MFX_CODEC_HEVC, HevcVps()));
+    EXPECT_EQ((33ull << 32) | 1, GetParamSetKey(MFX_CODEC_HEVC, HevcSps(1)));
+    EXPECT_EQ((34ull << 32) | 0, GetParamSetKey(MFX_CODEC_HEVC, HevcPps()));
+}
+
+TEST_F(StreamIndexTest, AvcPointsAndHeaders)
+{
+    mfxU64 first  = Add({ AvcSps(0, 1), AvcPps(), AvcIdr(), AvcP(), AvcP() });
+    mfxU64 second = Add({ AvcSps(0, 2), AvcPps(), AvcIdr(), AvcP() });
+    mfxU64 third  = Add({ AvcIdr(), AvcP() });
+    Write();
+
+    CStreamIndex index;
+    ASSERT_EQ(MFX_ERR_NONE, index.Build(StreamFile, MFX_CODEC_AVC));
+    ASSERT_EQ(3u, index.GetPointCount());
+
+    const StreamRandomAccessPoint *point = index.Find(0);
+    ASSERT_NE(nullptr, point);
+    EXPECT_EQ(first, point->Offset);
+    EXPECT_EQ(0u, point->FrameOrder);
+    EXPECT_TRUE(point->Headers.empty());
+
+    // access unit has its own headers
+    point = index.Find(3);
+    ASSERT_NE(nullptr, point);
+    EXPECT_EQ(second, point->Offset);
+    EXPECT_EQ(3u, point->FrameOrder);
+    EXPECT_TRUE(point->Headers.empty());
+
+    // the re-sent SPS with the same id replaces the first one
+    point = index.Find(6);
+    ASSERT_NE(nullptr, point);
+    EXPECT_EQ(third, point->Offset);
+    EXPECT_EQ(5u, point->FrameOrder);
+    EXPECT_EQ(Concat({ AvcSps(0, 2), AvcPps() }), index.GetHeaders(*point));
+}
+
+TEST_F(StreamIndexTest, AvcActiveHeadersAreBounded)
+{
+    const int n = 100;
+    for (int i = 0; i < n; i++)
+        Add({ AvcSps(0, (mfxU8)i), AvcSps(1, (mfxU8)i), AvcPps(i), AvcIdr(), AvcP() });
+    Add({ AvcIdr(), AvcP() });
+    Write();
+
+    CStreamIndex index;
+    ASSERT_EQ(MFX_ERR_NONE, index.Build(StreamFile, MFX_CODEC_AVC));
+    ASSERT_EQ(n + 1u, index.GetPointCount());
+
+    const StreamRandomAccessPoint *point = index.Find(2 * n);
+    ASSERT_NE(nullptr, point);
+    EXPECT_EQ(3u, point->Headers.size());
+    EXPECT_EQ(Concat({ AvcSps(0, n - 1), AvcSps(1, n - 1), AvcPps(n - 1) }), index.GetHeaders(*point));
+}
+
+TEST_F(StreamIndexTest, TooManyHeadersFail)
+{
+    // indices of headers are 16-bit
+    for (mfxU32 i = 0; i <= 0xffff; i++)
+        Add({ AvcPps(i) });
+    Add({ AvcSps(0), AvcIdr() });
+    Write();
+
+    CStreamIndex index;
+    EXPECT_EQ(MFX_ERR_UNSUPPORTED, index.Build(StreamFile, MFX_CODEC_AVC));
+}
+
+TEST_F(StreamIndexTest, HevcLeadingPicturesAreSkipped)
+{
+    Add({ HevcVps(), HevcSps(0), HevcPps(), HevcPicture(HEVC_IDR_W_RADL),
+          HevcPicture(HEVC_TRAIL_R), HevcPicture(HEVC_TRAIL_R) });
+    mfxU64 cra = Add({ HevcPicture(HEVC_CRA) });
+    Add({ HevcPicture(HEVC_RASL_N), HevcPicture(HEVC_RASL_N), HevcPicture(HEVC_TRAIL_R) });
+    Write();
+
+    CStreamIndex index;
+    ASSERT_EQ(MFX_ERR_NONE, index.Build(StreamFile, MFX_CODEC_HEVC));
+    ASSERT_EQ(2u, index.GetPointCount());
+
+    // RASL pictures aren't output after a seek to CRA, pictures before them are decoded from the IDR
+    const StreamRandomAccessPoint *point = index.Find(4);
+    ASSERT_NE(nullptr, point);
+    EXPECT_EQ(0u, point->Offset);
+
+    point = index.Find(5);
+    ASSERT_NE(nullptr, point);
+    EXPECT_EQ(cra, point->Offset);
+    EXPECT_EQ(5u, point->FrameOrder);
+    EXPECT_EQ(Concat({ HevcVps(), HevcSps(0), HevcPps() }), index.GetHeaders(*point));
+}
+
+TEST_F(StreamIndexTest, SeekWithSavedIndex)
+{
+    Add({ AvcSps(0, 1), AvcPps(), AvcIdr(), AvcP(), AvcP() });
+    Add({ AvcSps(0, 2), AvcPps(), AvcIdr(), AvcP() });
+    Add({ AvcIdr(), AvcP() });
+    Write();
+
+    CStreamIndex built;
+    ASSERT_EQ(MFX_ERR_NONE, built.Build(StreamFile, MFX_CODEC_AVC));
+    ASSERT_EQ(MFX_ERR_NONE, built.Save(IndexFile));
+
+    CStreamIndex index;
+    EXPECT_EQ(MFX_ERR_NOT_FOUND, index.Load(IndexFile, StreamFile, MFX_CODEC_HEVC));
+    ASSERT_EQ(MFX_ERR_NONE, index.Load(IndexFile, StreamFile, MFX_CODEC_AVC));
+    ASSERT_EQ(built.GetPointCount(), index.GetPointCount());
+
+    const StreamRandomAccessPoint *point = index.Find(6);
+    ASSERT_NE(nullptr, point);
+    EXPECT_EQ(5u, point->FrameOrder);
+
+    CSmplBitstreamReader reader;
+    ASSERT_EQ(MFX_ERR_NONE, reader.Init(StreamFile));
+    ASSERT_EQ(MFX_ERR_NONE, reader.Seek(point->Offset, index.GetHeaders(*point)));
+
+    Bytes data(stream.size() * 2);
+    mfxBitstream bs = {};
+    bs.Data      = data.data();
+    bs.MaxLength = (mfxU32)data.size();
+    while (reader.ReadNextFrame(&bs) == MFX_ERR_NONE)
+        ;
+
+    // decoder gets parameter sets in effect at the point, then the stream from there
+    Bytes expected = index.GetHeaders(*point);
+    expected.insert(expected.end(), stream.begin() + (size_t)point->Offset, stream.end());
+    EXPECT_EQ(expected, Bytes(bs.Data + bs.DataOffset, bs.Data + bs.DataOffset + bs.DataLength));
+}
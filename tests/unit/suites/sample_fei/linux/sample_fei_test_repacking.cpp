@@ -0,0 +1,371 @@
+// Copyright (c) 2020 Intel Corporation
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "mfx_unit_test_utils.h"
+
+#include "predictors_repacking.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <random>
+#include <vector>
+
+// Batched predictor repacking of sample_fei (median network, selection of
+// best PreENC calls) must give the same predictors as straightforward
+// per-MB sorting. Timings are reported only.
+
+namespace
+{
+    typedef mfxExtFeiPreEncMV::mfxExtFeiPreEncMVMB             PreEncMVMB;
+    typedef mfxExtFeiEncMVPredictors::mfxExtFeiEncMVPredictorsMB EncMVPredMB;
+
+    mfxI16 ScalarMedian(const PreEncMVMB& mb, int xy, int L0L1, int offset, int count)
+    {
+        mfxI16 v[16];
+        for (int k = 0; k < count; k++)
+            v[k] = xy ? mb.MV[k + offset][L0L1].y : mb.MV[k + offset][L0L1].x;
+
+        std::sort(v, v + count);
+        return (mfxI16)((v[count / 2 - 1] + v[count / 2]) / 2);
+    }
+
+    // per-MB version of FEI_PreencInterface::RepackPredictors: PreENC calls
+    // are sorted by distortion, MVs of each selected call are sorted for median
+    void ScalarRepack(const PreEncCandidates& cands, const mfxU32 nPred[2], mfxU32 numMB, EncMVPredMB* out)
+    {
+        std::fill(out, out + numMB, EncMVPredMB());
+
+        std::vector<mfxU32> order(cands.mvs.size());
+
+        for (mfxU32 i = 0; i < numMB; i++)
+        {
+            for (mfxU32 L0L1 = 0; L0L1 < 2; L0L1++)
+            {
+                for (mfxU32 c = 0; c < order.size(); c++)
+                    order[c] = c;
+
+                std::stable_sort(order.begin(), order.end(), [&](mfxU32 a, mfxU32 b)
+                {
+                    return cands.mbstat[a]->MB[i].Inter[L0L1].BestDistortion < cands.mbstat[b]->MB[i].Inter[L0L1].BestDistortion;
+                });
+
+                for (mfxU32 j = 0; j < (std::min)(nPred[L0L1], (mfxU32)order.size()); j++)
+                {
+                    const PreEncMVMB& mb = cands.mvs[order[j]]->MB[i];
+
+                    if (!L0L1)
+                        out[i].RefIdx[j].RefL0 = cands.refIdx[order[j]][L0L1];
+                    else
+                        out[i].RefIdx[j].RefL1 = cands.refIdx[order[j]][L0L1];
+
+                    out[i].MV[j][L0L1].x = ScalarMedian(mb, 0, L0L1, 0, 16);
+                    out[i].MV[j][L0L1].y = ScalarMedian(mb, 1, L0L1, 0, 16);
+                }
+            }
+        }
+    }
+
+    // same loop as FEI_PreencInterface::RepackPredictors for PreENC on original surfaces
+    void BatchedRepack(MBRowWorkers& workers, const PreEncCandidates& cands, const mfxU32 nPred[2], mfxU32 numMB, mfxU32 widthMB, EncMVPredMB* out)
+    {
+        std::fill(out, out + numMB, EncMVPredMB());
+
+        workers.ForEachMBRowRange(numMB, widthMB, [&](mfxU32 firstMB, mfxU32 lastMB)
+        {
+            mfxU8 best[2][MaxFeiEncMVPNum][MVPBatchSize];
+            PreEncMVMB* preencMB[MVPBatchSize];
+            mfxI16Pair median[MVPBatchSize];
+
+            for (mfxU32 i = firstMB; i < lastMB; i += MVPBatchSize)
+            {
+                mfxU32 nMB = (std::min)(MVPBatchSize, lastMB - i);
+
+                GetBestSetsByDistortion(cands, nPred, i, nMB, best);
+
+                for (mfxU32 L0L1 = 0; L0L1 < 2; ++L0L1)
+                {
+                    for (mfxU32 j = 0; j < nPred[L0L1]; ++j)
+                    {
+                        for (mfxU32 k = 0; k < nMB; ++k)
+                            preencMB[k] = best[L0L1][j][k] == 0xff ? NULL : &cands.mvs[best[L0L1][j][k]]->MB[i + k];
+
+                        get16Median(preencMB, nMB, L0L1, median);
+
+                        for (mfxU32 k = 0; k < nMB; ++k)
+                        {
+                            if (!preencMB[k])
+                                continue;
+
+                            if (!L0L1)
+                                out[i + k].RefIdx[j].RefL0 = cands.refIdx[best[L0L1][j][k]][L0L1];
+                            else
+                                out[i + k].RefIdx[j].RefL1 = cands.refIdx[best[L0L1][j][k]][L0L1];
+
+                            out[i + k].MV[j][L0L1] = median[k];
+                        }
+                    }
+                }
+            }
+        });
+    }
+
+    class FeiRepackingTest : public ::testing::Test
+    {
+    protected:
+        int Rand(int from, int to)
+        {
+            return std::uniform_int_distribution<int>(from, to)(rng);
+        }
+
+        void FillMB(PreEncMVMB& mb, int range)
+        {
+            for (int k = 0; k < 16; k++)
+            {
+                for (int L0L1 = 0; L0L1 < 2; L0L1++)
+                {
+                    mb.MV[k][L0L1].x = (mfxI16)Rand(-range, range);
+                    mb.MV[k][L0L1].y = (mfxI16)Rand(-range, range);
+                }
+            }
+        }
+
+        // output of nCalls PreENC calls for picture of numMB MBs
+        void MakeCandidates(mfxU32 nCalls, mfxU32 numMB, int maxDistortion)
+        {
+            mvs.assign(nCalls, mfxExtFeiPreEncMV());
+            mbstat.assign(nCalls, mfxExtFeiPreEncMBStat());
+            mvData.assign(nCalls, std::vector<PreEncMVMB>(numMB));
+            mbstatData.assign(nCalls, std::vector<mfxExtFeiPreEncMBStat::mfxExtFeiPreEncMBStatMB>(numMB));
+            refIdx.resize(nCalls);
+
+            cands.mvs.clear();
+            cands.mbstat.clear();
+            cands.refIdx.clear();
+
+            for (mfxU32 c = 0; c < nCalls; c++)
+            {
+                for (auto& mb : mvData[c])
+                    FillMB(mb, 256);
+
+                for (auto& mb : mbstatData[c])
+                    for (int L0L1 = 0; L0L1 < 2; L0L1++)
+                        mb.Inter[L0L1].BestDistortion = (mfxU16)Rand(0, maxDistortion);
+
+                mvs[c].MB    = mvData[c].data();
+                mbstat[c].MB = mbstatData[c].data();
+                refIdx[c][0] = (mfxU8)c;
+                refIdx[c][1] = (mfxU8)(nCalls - 1 - c);
+
+                cands.mvs.push_back(&mvs[c]);
+                cands.mbstat.push_back(&mbstat[c]);
+                cands.refIdx.push_back(refIdx[c].data());
+            }
+        }
+
+        std::mt19937 rng{2020};
+
+        std::vector<mfxExtFeiPreEncMV>     mvs;
+        std::vector<mfxExtFeiPreEncMBStat> mbstat;
+        std::vector<std::vector<PreEncMVMB>> mvData;
+        std::vector<std::vector<mfxExtFeiPreEncMBStat::mfxExtFeiPreEncMBStatMB>> mbstatData;
+        std::vector<std::array<mfxU8, 2>>  refIdx;
+        PreEncCandidates                   cands;
+        MBRowWorkers                       workers;
+    };
+}
+
+TEST_F(FeiRepackingTest, Median4MatchesSort)
+{
+    PreEncMVMB mb;
+
+    for (int it = 0; it < 100000; it++)
+    {
+        // narrow range gives many equal elements, wide one checks overflow
+        FillMB(mb, it & 1 ? 32767 : 4);
+
+        for (int L0L1 = 0; L0L1 < 2; L0L1++)
+            for (int offset = 0; offset < 16; offset += 4)
+                for (int xy = 0; xy < 2; xy++)
+                    ASSERT_EQ(ScalarMedian(mb, xy, L0L1, offset, 4), get4Median(&mb, xy, L0L1, offset))
+                        << "iteration " << it;
+    }
+}
+
+TEST_F(FeiRepackingTest, Median16MatchesSort)
+{
+    std::vector<PreEncMVMB> mbs(MVPBatchSize);
+    PreEncMVMB* batch[MVPBatchSize];
+    mfxI16Pair median[MVPBatchSize];
+
+    for (int it = 0; it < 20000; it++)
+    {
+        mfxU32 nMB   = Rand(1, MVPBatchSize);
+        mfxU32 L0L1  = it & 1;
+
+        for (mfxU32 k = 0; k < nMB; k++)
+        {
+            FillMB(mbs[k], it & 2 ? 32767 : 4);
+            // MBs without selected PreENC call are skipped
+            batch[k] = Rand(0, 7) ? &mbs[k] : NULL;
+        }
+
+        std::fill(median, median + MVPBatchSize, mfxI16Pair{ 0x5555, 0x5555 });
+        get16Median(batch, nMB, L0L1, median);
+
+        for (mfxU32 k = 0; k < nMB; k++)
+        {
+            if (!batch[k])
+                continue;
+
+            ASSERT_EQ(ScalarMedian(mbs[k], 0, L0L1, 0, 16), median[k].x) << "iteration " << it << " MB " << k;
+            ASSERT_EQ(ScalarMedian(mbs[k], 1, L0L1, 0, 16), median[k].y) << "iteration " << it << " MB " << k;
+        }
+    }
+}
+
+TEST_F(FeiRepackingTest, RepackPreenc2EncMatchesSort)
+{
+    for (mfxU32 numMB : { 1u, 15u, 16u, 17u, 120u, 8160u })
+    {
+        std::vector<PreEncMVMB>  in(numMB);
+        std::vector<EncMVPredMB> out(numMB);
+        for (auto& mb : in)
+            FillMB(mb, 256);
+
+        ASSERT_EQ(MFX_ERR_NONE, repackPreenc2Enc(in.data(), out.data(), numMB));
+
+        for (mfxU32 i = 0; i < numMB; i++)
+        {
+            for (int L0L1 = 0; L0L1 < 2; L0L1++)
+            {
+                ASSERT_EQ(ScalarMedian(in[i], 0, L0L1, 0, 16), out[i].MV[0][L0L1].x) << "MB " << i;
+                ASSERT_EQ(ScalarMedian(in[i], 1, L0L1, 0, 16), out[i].MV[0][L0L1].y) << "MB " << i;
+            }
+        }
+    }
+}
+
+TEST_F(FeiRepackingTest, RepackPredictorsMatchesSort)
+{
+    const struct { mfxU32 widthMB, heightMB, nCalls, nPredL0, nPredL1; int maxDistortion; } modes[] =
+    {
+        {   1,  1, 1, 1, 0, 65535 },
+        {  11,  9, 2, 4, 2,     3 },   // more predictors than calls, many equal distortions
+        {  45, 30, 4, 4, 4, 65535 },
+        { 120, 68, 8, 2, 1,    15 },
+    };
+
+    for (auto& mode : modes)
+    {
+        mfxU32 numMB = mode.widthMB * mode.heightMB;
+        mfxU32 nPred[2] = { mode.nPredL0, mode.nPredL1 };
+        MakeCandidates(mode.nCalls, numMB, mode.maxDistortion);
+
+        std::vector<EncMVPredMB> ref(numMB), dst(numMB);
+        ScalarRepack(cands, nPred, numMB, ref.data());
+        BatchedRepack(workers, cands, nPred, numMB, mode.widthMB, dst.data());
+
+        ASSERT_EQ(0, memcmp(ref.data(), dst.data(), numMB * sizeof(EncMVPredMB)))
+            << mode.widthMB << "x" << mode.heightMB << " MBs, " << mode.nCalls << " calls";
+    }
+}
+
+TEST_F(FeiRepackingTest, MBRowRangesCoverPictureOnce)
+{
+    // the same workers serve pictures of growing and shrinking sizes
+    const struct { mfxU32 widthMB, numMB; } pictures[] =
+    {
+        { 120, 8160 }, { 1, 1 }, { 45, 1350 }, { 11, 95 }, { 240, 32640 }, { 120, 8160 }, { 8, 40 },
+    };
+
+    for (int it = 0; it < 10; it++)
+    {
+        for (auto& pic : pictures)
+        {
+            std::vector<std::atomic<int>> visits(pic.numMB);
+            for (auto& v : visits)
+                v = 0;
+
+            std::atomic<bool> unaligned(false);
+
+            workers.ForEachMBRowRange(pic.numMB, pic.widthMB, [&](mfxU32 firstMB, mfxU32 lastMB)
+            {
+                if (firstMB % pic.widthMB || (lastMB % pic.widthMB && lastMB != pic.numMB) || firstMB >= lastMB)
+                    unaligned = true;
+
+                for (mfxU32 i = firstMB; i < lastMB; i++)
+                    visits[i]++;
+            });
+
+            EXPECT_FALSE(unaligned) << pic.widthMB << " MBs wide picture";
+            for (mfxU32 i = 0; i < pic.numMB; i++)
+                ASSERT_EQ(1, visits[i]) << "MB " << i << " of " << pic.numMB;
+        }
+    }
+}
+
+TEST_F(FeiRepackingTest, RepackPredictorsTiming)
+{
+    // 1080p, 4 PreENC calls, 4 L0 and 2 L1 predictors
+    const mfxU32 widthMB = 120, numMB = widthMB * 68, iterations = 5;
+    const mfxU32 nPred[2] = { 4, 2 };
+    MakeCandidates(4, numMB, 65535);
+
+    std::vector<EncMVPredMB> out(numMB);
+
+    double scalar = mfx_unit_test::MeasureSeconds(iterations, [&]()
+    {
+        ScalarRepack(cands, nPred, numMB, out.data());
+    });
+    double batched = mfx_unit_test::MeasureSeconds(iterations, [&]()
+    {
+        BatchedRepack(workers, cands, nPred, numMB, widthMB, out.data());
+    });
+
+    mfx_unit_test::ReportTiming("scalar", scalar, "batched", batched);
+}
+
+TEST_F(FeiRepackingTest, RepackPreenc2EncTiming)
+{
+    const mfxU32 numMB = 120 * 68, iterations = 20;
+    std::vector<PreEncMVMB>  in(numMB);
+    std::vector<EncMVPredMB> out(numMB);
+    for (auto& mb : in)
+        FillMB(mb, 256);
+
+    double scalar = mfx_unit_test::MeasureSeconds(iterations, [&]()
+    {
+        for (mfxU32 i = 0; i < numMB; i++)
+            for (int L0L1 = 0; L0L1 < 2; L0L1++)
+            {
+                out[i].MV[0][L0L1].x = ScalarMedian(in[i], 0, L0L1, 0, 16);
+                out[i].MV[0][L0L1].y = ScalarMedian(in[i], 1, L0L1, 0, 16);
+            }
+    });
+    double batched = mfx_unit_test::MeasureSeconds(iterations, [&]()
+    {
+        repackPreenc2Enc(in.data(), out.data(), numMB);
+    });
+
+    mfx_unit_test::ReportTiming("scalar", scalar, "batched", batched);
+}
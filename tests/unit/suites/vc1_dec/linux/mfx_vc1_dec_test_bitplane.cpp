@@ -0,0 +1,527 @@
+// Copyright (c) 2020 Intel Corporation
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "mfx_unit_test_utils.h"
+
+#include "umc_defs.h"
+#include "umc_vc1_dec_seq.h"
+#include "umc_vc1_common_tables.h"
+#include "umc_vc1_huffman.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <vector>
+
+// DecodeBitplane reads IMODE and Norm-6 tile codes by a single lookup into
+// one level tables and resolves inversion and differential coding eight
+// macroblocks at once. For every coding mode it must give the same
+// bitplane, IMODE, INVERT and bitstream position as the straightforward
+// decoder, which reads one bit at a time and decodes tiles with
+// DecodeHuffmanOne from the original table of 6 and 7-bit subtables.
+// Timings are reported only.
+
+namespace
+{
+    enum { RAW, NORM2, DIFF2, NORM6, DIFF6, ROWSKIP, COLSKIP, NUM_MODES };
+
+    struct Code
+    {
+        uint32_t code;
+        int32_t  len;
+    };
+
+    // VC-1 Table 68, in order of the enum above
+    const Code ImodeCodes[NUM_MODES] = { {0, 4}, {2, 2}, {1, 3}, {3, 2}, {1, 4}, {2, 3}, {3, 3} };
+    const char* const ModeNames[NUM_MODES] = { "Raw", "Norm-2", "Diff-2", "Norm-6", "Diff-6", "Rowskip", "Colskip" };
+
+    // VC-1 bitstream: 32-bit words, most significant bit first
+    class BitWriter
+    {
+    public:
+        void Put(uint32_t value, int32_t len)
+        {
+            for (int32_t i = len - 1; i >= 0; i--, m_numBits++)
+            {
+                if (m_numBits % 32 == 0)
+                    m_words.push_back(0);
+                if ((value >> i) & 1)
+                    m_words.back() |= 1u << (31 - m_numBits % 32);
+            }
+        }
+
+        std::vector<uint32_t> m_words;
+        int32_t               m_numBits = 0;
+    };
+
+    // The decoder before table-driven decoding, tables are passed in their
+    // DecodeHuffmanOne form
+    class OldBitplaneDecoder
+    {
+    public:
+        OldBitplaneDecoder(VC1Context* context, const int32_t* imodeTable, const int32_t* tileTable)
+            : pContext(context), m_imodeTable(imodeTable), m_tileTable(tileTable)
+        {}
+
+        void Decode(uint8_t* plane, int32_t width, int32_t height, int32_t pitch, int32_t& imode, int32_t& invert)
+        {
+            invert = GetBit();
+            imode = GetVLC(m_imodeTable);
+
+            switch (imode)
+            {
+            case VC1_BITPLANE_NORM2_MODE:
+            case VC1_BITPLANE_DIFF2_MODE:
+                Norm2(plane, width, height, pitch);
+                break;
+            case VC1_BITPLANE_NORM6_MODE:
+            case VC1_BITPLANE_DIFF6_MODE:
+                Norm6(plane, width, height, pitch);
+                break;
+            case VC1_BITPLANE_ROWSKIP_MODE:
+                for (int32_t i = 0; i < height; i++)
+                {
+                    int32_t skip = GetBit();
+                    for (int32_t j = 0; j < width; j++)
+                        plane[i * pitch + j] = skip ? (uint8_t)GetBit() : 0;
+                }
+                break;
+            case VC1_BITPLANE_COLSKIP_MODE:
+                for (int32_t j = 0; j < width; j++)
+                {
+                    int32_t skip = GetBit();
+                    for (int32_t i = 0; i < height; i++)
+                        plane[i * pitch + j] = skip ? (uint8_t)GetBit() : 0;
+                }
+                break;
+            }
+
+            if (imode == VC1_BITPLANE_DIFF2_MODE || imode == VC1_BITPLANE_DIFF6_MODE)
+                InverseDiff(plane, width, height, pitch, invert);
+            else if (imode != VC1_BITPLANE_RAW_MODE && invert)
+                for (int32_t i = 0; i < pitch * height; i++)
+                    plane[i] ^= 1;
+        }
+
+    private:
+        int32_t GetBit()
+        {
+            int32_t value = 0;
+            VC1_GET_BITS(1, value);
+            return value;
+        }
+
+        int32_t GetVLC(const int32_t* table)
+        {
+            int32_t value = 0;
+            EXPECT_EQ(0, DecodeHuffmanOne(&pContext->m_bitstream.pBitstream, &pContext->m_bitstream.bitOffset, &value, table));
+            return value;
+        }
+
+        void Norm2(uint8_t* plane, int32_t width, int32_t height, int32_t pitch)
+        {
+            int32_t n = width * height, x = n & 1, y = 0;
+
+            if (n & 1)
+                plane[0] = (uint8_t)GetBit();
+
+            for (int32_t i = n & 1; i < n / 2 * 2; i += 2)
+            {
+                uint8_t* first = &plane[y * pitch + x];
+                if (++x == width) { x = 0; y++; }
+                uint8_t* second = &plane[y * pitch + x];
+                if (++x == width) { x = 0; y++; }
+
+                // 0 -> 0 0, 11 -> 1 1, 100 -> 1 0, 101 -> 0 1
+                if (!GetBit())
+                    *first = 0, *second = 0;
+                else if (GetBit())
+                    *first = 1, *second = 1;
+                else if (!GetBit())
+                    *first = 1, *second = 0;
+                else
+                    *first = 0, *second = 1;
+            }
+        }
+
+        void Norm6(uint8_t* plane, int32_t width, int32_t height, int32_t pitch)
+        {
+            int32_t residualX, residualY;
+
+            if ((width % 3) && !(height % 3))
+            {
+                // 2x3 tiles, the odd column is the residual one
+                for (int32_t i = 0; i < height / 3; i++)
+                {
+                    uint8_t* tile = &plane[i * 3 * pitch] + (width & 1);
+                    for (int32_t j = 0; j < width / 2; j++, tile += 2)
+                    {
+                        int32_t k = GetVLC(m_tileTable);
+                        for (int32_t b = 0; b < 6; b++)
+                            tile[(b / 2) * pitch + b % 2] = (k >> b) & 1;
+                    }
+                }
+                residualX = width & 1;
+                residualY = 0;
+            }
+            else
+            {
+                // 3x2 tiles, the decoder shifts tiles by width, not by pitch, below the residual row
+                for (int32_t i = 0; i < height / 2; i++)
+                {
+                    uint8_t* tile = &plane[i * 2 * pitch] + width % 3 + (height & 1) * width;
+                    for (int32_t j = 0; j < width / 3; j++, tile += 3)
+                    {
+                        int32_t k = GetVLC(m_tileTable);
+                        for (int32_t b = 0; b < 6; b++)
+                            tile[(b / 3) * pitch + b % 3] = (k >> b) & 1;
+                    }
+                }
+                residualX = width % 3;
+                residualY = height & 1;
+            }
+
+            for (int32_t j = 0; j < residualX; j++)
+            {
+                int32_t skip = GetBit();
+                for (int32_t i = 0; i < height; i++)
+                    plane[i * pitch + j] = skip ? (uint8_t)GetBit() : 0;
+            }
+
+            for (int32_t i = 0; i < residualY; i++)
+            {
+                int32_t skip = GetBit();
+                for (int32_t j = residualX; j < width; j++)
+                    plane[j] = skip ? (uint8_t)GetBit() : 0;
+            }
+        }
+
+        static void InverseDiff(uint8_t* plane, int32_t width, int32_t height, int32_t pitch, int32_t invert)
+        {
+            for (int32_t i = 0; i < height; i++)
+            {
+                for (int32_t j = 0; j < width; j++)
+                {
+                    uint8_t& b = plane[i * pitch + j];
+
+                    if (i == 0 && j == 0)
+                        b ^= invert;
+                    else if (j == 0)
+                        b ^= plane[(i - 1) * pitch];
+                    else if (i > 0 && plane[i * pitch + j - 1] != plane[(i - 1) * pitch + j])
+                        b ^= invert;
+                    else
+                        b ^= plane[i * pitch + j - 1];
+                }
+            }
+        }
+
+        VC1Context*    pContext; // the name is used by VC1_GET_BITS
+        const int32_t* m_imodeTable;
+        const int32_t* m_tileTable;
+    };
+
+    struct ContextDeleter
+    {
+        void operator()(VC1Context* p) const { free(p); }
+    };
+
+    class VC1BitplaneTest : public ::testing::Test
+    {
+    protected:
+        void SetUp() override
+        {
+            // tile codes are listed after the header of the one level table: max bits, 1 subtable, its size
+            const int32_t* spec = VC1_BitplaneTaledbitsTbl;
+            ASSERT_EQ(1, spec[1]);
+
+            oldTileSpec = { spec[0], 2, 6, 7 };
+            for (const int32_t* p = spec + 3; ; )
+            {
+                oldTileSpec.push_back(*p);
+                if (*p < 0)
+                    break;
+                for (int32_t n = *p++ * 2; n > 0; n--)
+                    oldTileSpec.push_back(*p++);
+            }
+
+            for (int32_t len = 1, pos = 4; oldTileSpec[pos] >= 0; len++)
+            {
+                int32_t n = oldTileSpec[pos++];
+                for (int32_t i = 0; i < n; i++, pos += 2)
+                    tileCodes[oldTileSpec[pos + 1]] = { (uint32_t)oldTileSpec[pos], len };
+            }
+
+            ASSERT_EQ(0, HuffmanTableInitAlloc(VC1_Bitplane_IMODE_tbl, &tables.m_Bitplane_IMODE));
+            ASSERT_EQ(0, HuffmanTableInitAlloc(VC1_BitplaneTaledbitsTbl, &tables.m_BitplaneTaledbits));
+            ASSERT_EQ(0, HuffmanTableInitAlloc(oldTileSpec.data(), &oldTileTable));
+        }
+
+        void TearDown() override
+        {
+            HuffmanTableFree(tables.m_Bitplane_IMODE);
+            HuffmanTableFree(tables.m_BitplaneTaledbits);
+            HuffmanTableFree(oldTileTable);
+        }
+
+        // structurally valid bitplane of given mode, symbols are 1 with probability p
+        void WriteBitplane(BitWriter& bs, int mode, int32_t width, int32_t height, int32_t invert, double p)
+        {
+            std::bernoulli_distribution bit(p);
+            auto sym = [&]() { return (uint32_t)bit(rng); };
+            // skip flags are set more often than symbols, so raw rows and columns are coded too
+            auto skip = [&]() { return sym() | sym(); };
+
+            bs.Put(invert, 1);
+            bs.Put(ImodeCodes[mode].code, ImodeCodes[mode].len);
+
+            switch (mode)
+            {
+            case NORM2:
+            case DIFF2:
+                if ((width * height) & 1)
+                    bs.Put(sym(), 1);
+                for (int32_t i = 0; i < width * height / 2; i++)
+                {
+                    uint32_t a = sym(), b = sym();
+                    if (!a && !b)
+                        bs.Put(0, 1);
+                    else if (a && b)
+                        bs.Put(3, 2);
+                    else
+                        bs.Put(a ? 4 : 5, 3);
+                }
+                break;
+            case NORM6:
+            case DIFF6:
+            {
+                bool tiles2x3 = (width % 3) && !(height % 3);
+                int32_t numTiles = tiles2x3 ? (width / 2) * (height / 3) : (width / 3) * (height / 2);
+                for (int32_t i = 0; i < numTiles; i++)
+                {
+                    uint32_t k = 0;
+                    for (int32_t b = 0; b < 6; b++)
+                        k |= sym() << b;
+                    bs.Put(tileCodes[k].code, tileCodes[k].len);
+                }
+
+                int32_t residualX = tiles2x3 ? (width & 1) : (width % 3);
+                int32_t residualY = tiles2x3 ? 0 : (height & 1);
+                WriteSkipped(bs, residualX, height, skip, sym);
+                WriteSkipped(bs, residualY, width - residualX, skip, sym);
+                break;
+            }
+            case ROWSKIP:
+                WriteSkipped(bs, height, width, skip, sym);
+                break;
+            case COLSKIP:
+                WriteSkipped(bs, width, height, skip, sym);
+                break;
+            }
+
+            // marker to check the position after the bitplane, and room for look ahead
+            bs.Put(0x5a5a, 16);
+            bs.Put(0, 32);
+            bs.Put(0, 32);
+        }
+
+        template <class Skip, class Sym>
+        static void WriteSkipped(BitWriter& bs, int32_t numLines, int32_t length, Skip skip, Sym sym)
+        {
+            for (int32_t i = 0; i < numLines; i++)
+            {
+                uint32_t coded = skip();
+                bs.Put(coded, 1);
+                for (int32_t j = 0; coded && j < length; j++)
+                    bs.Put(sym(), 1);
+            }
+        }
+
+        std::unique_ptr<VC1Context, ContextDeleter> MakeContext(VC1VLCTables* vlcTables, std::vector<uint8_t>& planes, int32_t pitch, int32_t height)
+        {
+            std::unique_ptr<VC1Context, ContextDeleter> context((VC1Context*)calloc(1, sizeof(VC1Context)));
+            context->m_vlcTbl = vlcTables;
+            context->m_seqLayerHeader.MaxWidthMB = pitch;
+            context->m_seqLayerHeader.heightMB = height;
+            context->m_pBitplane.m_databits = planes.data();
+            // the next bitplane is the first one of the buffer
+            context->bp_round_count = -1;
+            return context;
+        }
+
+        // decodes the stream by DecodeBitplane and by the old decoder, the results must match
+        void CheckBitplane(BitWriter& bs, int32_t width, int32_t height, int32_t pitch)
+        {
+            // bytes of other bitplanes and padding columns are garbage, which must be processed the same way
+            std::vector<uint8_t> planes(pitch * height * (VC1_MAX_BITPANE_CHUNCKS + 1));
+            for (auto& b : planes)
+                b = (uint8_t)(rng() & 1);
+            std::vector<uint8_t> refPlanes = planes;
+
+            auto context = MakeContext(&tables, planes, pitch, height);
+            context->m_bitstream.pBitstream = bs.m_words.data();
+            context->m_bitstream.bitOffset = 31;
+
+            VC1Bitplane bitplane;
+            DecodeBitplane(context.get(), &bitplane, width, height, 0);
+
+            auto refContext = MakeContext(&tables, refPlanes, pitch, height);
+            refContext->m_bitstream.pBitstream = bs.m_words.data();
+            refContext->m_bitstream.bitOffset = 31;
+
+            int32_t imode = 0, invert = 0;
+            OldBitplaneDecoder(refContext.get(), tables.m_Bitplane_IMODE, oldTileTable).Decode(refPlanes.data(), width, height, pitch, imode, invert);
+
+            ASSERT_EQ(planes.data(), bitplane.m_databits);
+            EXPECT_EQ(imode, bitplane.m_imode);
+            EXPECT_EQ(invert, bitplane.m_invert);
+            ASSERT_EQ(refPlanes, planes) << "mode " << imode << " invert " << invert << " " << width << "x" << height << " MBs, pitch " << pitch;
+            ASSERT_EQ(refContext->m_bitstream.pBitstream, context->m_bitstream.pBitstream);
+            ASSERT_EQ(refContext->m_bitstream.bitOffset, context->m_bitstream.bitOffset);
+
+            uint32_t marker = 0;
+            VC1GetNBits(context->m_bitstream.pBitstream, context->m_bitstream.bitOffset, 16, marker);
+            ASSERT_EQ(0x5a5au, marker);
+        }
+
+        std::mt19937 rng{2020};
+
+        std::vector<int32_t> oldTileSpec;
+        Code                 tileCodes[64] = {};
+        VC1VLCTables         tables = {};
+        int32_t*             oldTileTable = nullptr;
+    };
+}
+
+TEST_F(VC1BitplaneTest, TileCodesMatchOldTable)
+{
+    // every Norm-6 code decodes to its tile by the one level table and by the original one
+    for (uint32_t k = 0; k < 64; k++)
+    {
+        for (const int32_t* table : { (const int32_t*)tables.m_BitplaneTaledbits, (const int32_t*)oldTileTable })
+        {
+            BitWriter bs;
+            bs.Put(tileCodes[k].code, tileCodes[k].len);
+            bs.Put(0x5a5a, 16);
+            bs.Put(0, 32);
+
+            uint32_t* pBitstream = bs.m_words.data();
+            int32_t   bitOffset = 31;
+            int32_t   value = -1;
+            ASSERT_EQ(0, DecodeHuffmanOne(&pBitstream, &bitOffset, &value, table));
+            EXPECT_EQ((int32_t)k, value);
+
+            uint32_t marker = 0;
+            VC1GetNBits(pBitstream, bitOffset, 16, marker);
+            EXPECT_EQ(0x5a5au, marker) << "tile " << k;
+        }
+    }
+}
+
+TEST_F(VC1BitplaneTest, AllModesMatchOldDecoder)
+{
+    // 2x3 and 3x2 tiles with and without residual rows and columns, rows of eight MBs and a tail
+    const struct { int32_t width, height; } sizes[] =
+    {
+        { 1, 1 }, { 1, 7 }, { 7, 1 }, { 2, 3 }, { 3, 2 }, { 4, 3 }, { 5, 6 }, { 3, 4 }, { 6, 5 },
+        { 8, 8 }, { 9, 9 }, { 16, 2 }, { 45, 36 }, { 120, 68 }, { 121, 69 },
+    };
+
+    for (int mode = 0; mode < NUM_MODES; mode++)
+    {
+        for (int32_t invert = 0; invert < 2; invert++)
+        {
+            for (auto& size : sizes)
+            {
+                for (double p : { 0.05, 0.5, 0.95 })
+                {
+                    for (int32_t padding : { 0, 3 })
+                    {
+                        BitWriter bs;
+                        WriteBitplane(bs, mode, size.width, size.height, invert, p);
+                        CheckBitplane(bs, size.width, size.height, size.width + padding);
+                        if (HasFatalFailure())
+                            return;
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST_F(VC1BitplaneTest, RandomBitplanesMatchOldDecoder)
+{
+    for (int it = 0; it < 5000; it++)
+    {
+        int32_t width = std::uniform_int_distribution<int32_t>(1, 130)(rng);
+        int32_t height = std::uniform_int_distribution<int32_t>(1, 70)(rng);
+        int32_t pitch = width + std::uniform_int_distribution<int32_t>(0, 8)(rng);
+        int mode = std::uniform_int_distribution<int>(0, NUM_MODES - 1)(rng);
+        double p = std::uniform_real_distribution<double>(0.02, 0.98)(rng);
+
+        BitWriter bs;
+        WriteBitplane(bs, mode, width, height, it & 1, p);
+        CheckBitplane(bs, width, height, pitch);
+        if (HasFatalFailure())
+            return;
+    }
+}
+
+TEST_F(VC1BitplaneTest, BitplaneTiming)
+{
+    // 1080p picture, 64 different bitplanes per mode
+    const int32_t width = 120, height = 68, iterations = 50;
+
+    for (int mode = NORM2; mode < NUM_MODES; mode++)
+    {
+        std::vector<BitWriter> streams(64);
+        for (auto& bs : streams)
+            WriteBitplane(bs, mode, width, height, mode & 1, 0.3);
+
+        std::vector<uint8_t> planes(width * height * (VC1_MAX_BITPANE_CHUNCKS + 1));
+        auto context = MakeContext(&tables, planes, width, height);
+
+        double old = mfx_unit_test::MeasureSeconds(iterations, [&]()
+        {
+            for (auto& bs : streams)
+            {
+                context->m_bitstream.pBitstream = bs.m_words.data();
+                context->m_bitstream.bitOffset = 31;
+                int32_t imode, invert;
+                OldBitplaneDecoder(context.get(), tables.m_Bitplane_IMODE, oldTileTable).Decode(planes.data(), width, height, width, imode, invert);
+            }
+        });
+        double current = mfx_unit_test::MeasureSeconds(iterations, [&]()
+        {
+            for (auto& bs : streams)
+            {
+                context->m_bitstream.pBitstream = bs.m_words.data();
+                context->m_bitstream.bitOffset = 31;
+                context->bp_round_count = -1;
+                VC1Bitplane bitplane;
+                DecodeBitplane(context.get(), &bitplane, width, height, 0);
+            }
+        });
+
+        std::cout << "[   MODE   ] " << ModeNames[mode] << "\n";
+        mfx_unit_test::ReportTiming("old", old, "table-driven", current);
+    }
+}
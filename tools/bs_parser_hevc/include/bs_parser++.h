@@ -65,8 +65,11 @@ public:
     BSErr unlock(void* p)                       { return BS_HEVC2_Unlock(hdl, p); };
     BSErr sync(void* p)                         { return BS_HEVC2_Sync(hdl, (BS_HEVC2::NALU*)p); };
     Bs16u async_depth()                         { return BS_HEVC2_GetAsyncDepth(hdl); }
+    BSErr get_columns(BS_HEVC2::SDColumns*& c)  { return BS_HEVC2_GetColumns(hdl, c); }
 
     void set_trace_level(Bs32u level)           { BS_HEVC2_SetTraceLevel(hdl, level); };
+    // trace is written as compact binary records (see bs_trace_bin.h) instead of text
+    void set_trace_binary(bool binary)          { BS_HEVC2_SetTraceBinary(hdl, binary); };
     void* get_header() { return hdr; };
     void* get_handle() { return hdl; };
     Bs64u get_offset() {
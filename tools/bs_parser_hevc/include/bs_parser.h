@@ -31,11 +31,13 @@ extern "C"{
     BSErr __STDCALL BS_HEVC2_ParseNextAU       (BS_HEVC2::HDL hdl, BS_HEVC2::NALU*& pAU);
     BSErr __STDCALL BS_HEVC2_Close             (BS_HEVC2::HDL hdl);
     BSErr __STDCALL BS_HEVC2_SetTraceLevel     (BS_HEVC2::HDL hdl, Bs32u level);
+    BSErr __STDCALL BS_HEVC2_SetTraceBinary    (BS_HEVC2::HDL hdl, bool binary);
     BSErr __STDCALL BS_HEVC2_Lock              (BS_HEVC2::HDL hdl, void* p);
     BSErr __STDCALL BS_HEVC2_Unlock            (BS_HEVC2::HDL hdl, void* p);
     BSErr __STDCALL BS_HEVC2_GetOffset         (BS_HEVC2::HDL hdl, Bs64u& offset);
     BSErr __STDCALL BS_HEVC2_Sync              (BS_HEVC2::HDL hdl, BS_HEVC2::NALU* slice);
     Bs16u __STDCALL BS_HEVC2_GetAsyncDepth     (BS_HEVC2::HDL hdl);
+    BSErr __STDCALL BS_HEVC2_GetColumns        (BS_HEVC2::HDL hdl, BS_HEVC2::SDColumns*& columns);
 
 }
 
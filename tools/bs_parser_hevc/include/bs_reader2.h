@@ -21,8 +21,10 @@
 #pragma once
 
 #include "bs_def.h"
+#include "bs_trace_bin.h"
 #include <stdio.h>
 #include <vector>
+#include <memory>
 #include <exception>
 #include <assert.h>
 
@@ -77,15 +79,24 @@ public:
 
 #ifdef __BS_TRACE__
 
-#define BS2_TRO { if (TraceOffset()) fprintf(GetLog(), "0x%016llX[%i]: ", GetByteOffset(), GetBitOffset()); }
+#define BS2_TRO                                                                                \
+{                                                                                              \
+    if (TraceOffset()) {                                                                       \
+        if (BinTrace()) GetBinTrace().Offset(GetByteOffset(), GetBitOffset());                 \
+        else fprintf(GetLog(), "0x%016llX[%i]: ", GetByteOffset(), GetBitOffset());            \
+    }                                                                                          \
+}
 
 #define BS2_SET(val, var)                         \
 {                                                 \
     if (Trace()) {                                \
         BS2_TRO;                                  \
         var = (val);                              \
+        if (BinTrace()) {                         \
+            GetBinTrace().Value(#var, var);       \
+        } else {                                  \
         fprintf(GetLog(), std::is_same<Bs64u, decltype(var)>::value ? "%s = %lli\n" : "%s = %i\n", #var, var);\
-        fflush(GetLog());                         \
+        fflush(GetLog()); }                       \
     } else { var = (val); }                       \
 }
 
@@ -94,8 +105,11 @@ public:
     if (Trace()) {                                               \
         BS2_TRO;                                                 \
         var = (val);                                             \
+        if (BinTrace()) {                                        \
+            GetBinTrace().Mapped(#var, var, map[var]);           \
+        } else {                                                 \
         fprintf(GetLog(), "%s = %s(%d)\n", #var, map[var], var); \
-        fflush(GetLog());                                        \
+        fflush(GetLog()); }                                      \
     } else { var = (val); }                                      \
 }
 
@@ -103,17 +117,34 @@ public:
 {                                                   \
     if (Trace()) {                                  \
         BS2_TRO;                                    \
+        if (BinTrace()) {                           \
+            GetBinTrace().Value(#var, (val));       \
+        } else {                                    \
         fprintf(GetLog(), std::is_same<Bs64u, decltype(val)>::value ? "%s = %lli\n" : "%s = %i\n", #var, (val));\
-        fflush(GetLog()); }                         \
+        fflush(GetLog()); } }                       \
     else { (val); }                                 \
 }
 
-#define BS2_TRACE_STR(str)\
-    { if (Trace()) { BS2_TRO; fprintf(GetLog(), "%s\n", (str)); fflush(GetLog());} }
+#define BS2_TRACE_STR(str)                                          \
+{                                                                   \
+    if (Trace()) {                                                  \
+        BS2_TRO;                                                    \
+        if (BinTrace()) GetBinTrace().String(str);                  \
+        else { fprintf(GetLog(), "%s\n", (str)); fflush(GetLog()); }\
+    }                                                               \
+}
 
 #define BS2_SET_ARR_F(val, var, sz, split, format)                    \
 {                                                                     \
-    if (Trace()){                                                     \
+    if (Trace() && BinTrace()) {                                      \
+            BS2_TRO;                                                  \
+            GetBinTrace().ArrayBegin(#var, format, split);            \
+            for (Bs32u _i = 0; _i < Bs32u(sz); _i++){                 \
+                (var)[_i] = (val);                                    \
+                GetBinTrace().ArrayElem((var)[_i]);                   \
+            }                                                         \
+            GetBinTrace().ArrayEnd();                                 \
+    } else if (Trace()){                                              \
             BS2_TRO;                                                  \
             fprintf(GetLog(), "%s = { ", #var);                       \
             for (Bs32u _i = 0; _i < Bs32u(sz); _i++){                 \
@@ -128,7 +159,15 @@ public:
 
 #define BS2_SET_ARR_M(val, var, sz, split, format, map)              \
 {                                                                    \
-    if (Trace()){                                                    \
+    if (Trace() && BinTrace()) {                                     \
+            BS2_TRO;                                                 \
+            GetBinTrace().ArrayBegin(#var, format, split);           \
+            for (Bs32u _i = 0; _i < Bs32u(sz); _i++) {               \
+                (var)[_i] = (val);                                   \
+                GetBinTrace().ArrayElem((var)[_i], map[(var)[_i]]);  \
+            }                                                        \
+            GetBinTrace().ArrayEnd();                                \
+    } else if (Trace()){                                             \
             BS2_TRO;                                                 \
             fprintf(GetLog(), "%s = { ", #var);                      \
             for (Bs32u _i = 0; _i < Bs32u(sz); _i++) {               \
@@ -144,7 +183,13 @@ public:
 
 #define BS2_TRACE_ARR_VF(val, var, sz, split, format)  \
 {                                                      \
-    if (Trace()){                                      \
+    if (Trace() && BinTrace()) {                       \
+            BS2_TRO;                                   \
+            GetBinTrace().ArrayBegin(#var, format, split);\
+            for (Bs32u _i = 0; _i < Bs32u(sz); _i++)   \
+                GetBinTrace().ArrayElem(val);          \
+            GetBinTrace().ArrayEnd();                  \
+    } else if (Trace()){                               \
             BS2_TRO;                                   \
             fprintf(GetLog(), "%s = { ", #var);        \
             for (Bs32u _i = 0; _i < Bs32u(sz); _i++) { \
@@ -161,10 +206,16 @@ public:
 {                                                    \
     if (Trace()){                                    \
         BS2_TRO;                                     \
+        if (BinTrace()) {                            \
+            GetBinTrace().MDArray(#arr, format,      \
+                (const type*)(arr), dim,             \
+                sizeof(dim) / sizeof(Bs16u),         \
+                split, split2);                      \
+        } else {                                     \
         fprintf(GetLog(), "%s = \n", #arr);          \
         traceMDArr<type, sizeof(dim) / sizeof(Bs16u)>\
                 (arr, dim, split, format, split2);   \
-        fflush(GetLog());                            \
+        fflush(GetLog()); }                          \
     }                                                \
 }
 
@@ -172,10 +223,13 @@ public:
 {                                            \
     if (Trace()) {                           \
             BS2_TRO;                         \
+            if (BinTrace()) {                \
+                GetBinTrace().Bin(#var, pval, off, sz);\
+            } else {                         \
             fprintf(GetLog(), "%s = ", #var);\
             traceBin(pval, off, sz);         \
             fprintf(GetLog(), "\n");         \
-            fflush(GetLog());                \
+            fflush(GetLog()); }              \
     }                                        \
     else { (pval); }                         \
 }
@@ -201,6 +255,104 @@ public:
 #define BS2_TRACE_ARR_F(var, sz, split, format) BS2_TRACE_ARR_VF(var[_i], var, sz, split, format)
 #define BS2_TRACE_ARR(var, sz, split) BS2_TRACE_ARR_F(var, sz, split, "%i ")
 
+template<class T> void TraceMDArr(
+    FILE* log,
+    const T* arr,
+    const Bs16u* sz,
+    Bs32u depth,
+    Bs16u split,
+    const char* format,
+    Bs16u split2 = 0)
+{
+    std::vector<Bs16u> off(depth);
+    for (Bs32u i = 0; i < depth; i++)
+    {
+        off[i] = 1;
+        for (Bs32u j = i + 1; j < depth; j++)
+            off[i] *= sz[j];
+    }
+    for (Bs32u i = 0, j = 0; i < Bs32u(off[0] * sz[0]); i++)
+    {
+        while (i % off[j] == 0)
+        {
+            fprintf(log, "{ ");
+
+            if (j < (split))
+            {
+                fprintf(log, "\n");
+                for (Bs32u c = 0; c <= j; c++)
+                    fprintf(log, "  ");
+            }
+            if (j == depth - 2)
+                break;
+            j++;
+        }
+        fprintf(log, format, arr[i]);
+        if (split2 && (i + 1) % split2 == 0
+            && (i + 1) / split2 > 0
+            && (i + 1) % off[j] != 0)
+        {
+            fprintf(log, "\n");
+            for (Bs32u c = 0; c <= j; c++)
+                fprintf(log, "  ");
+        }
+        while ((i + 1) % off[j] == 0)
+        {
+            bool f = j ? (i + 1) % off[--j] == 0 : !!j--;
+            fprintf(log, "} ");
+            if (j < (split))
+            {
+                fprintf(log, "\n");
+                for (Bs32u c = 0; c + f <= j; c++)
+                    fprintf(log, "  ");
+            }
+            if (!f)
+            {
+                j++;
+                break;
+            }
+        }
+    }
+    fprintf(log, "\n");
+}
+
+template<class T> void TraceBin(FILE* log, const T* p, Bs32u off, Bs32u sz)
+{
+    Bs32u S0 = sizeof(T) * 8;
+    Bs32u O = off;
+    const T* P0 = p;
+
+    if (off + sz > BS_MAX(S0, 32))
+    {
+        fprintf(log, "\n");
+
+        for (Bs32u i = 0; i < off; i++)
+            fprintf(log, " ");
+    }
+
+    while (sz)
+    {
+        Bs32u S = S0 - O;
+        Bs32u S1 = S0 - (O + BS_MIN(sz, S));
+
+        sz -= (S - S1);
+
+        while (S-- > S1)
+            fprintf(log, "%d", !!(*p & (1 << S)));
+
+        p++;
+        O = 0;
+
+        if (sz)
+        {
+            if ((p - P0) * S0 % 32 == 0)
+                fprintf(log, "\n");
+            else
+                fprintf(log, " ");
+        }
+    }
+}
+
 struct State
 {
     BufferUpdater* m_updater;
@@ -214,6 +366,7 @@ struct State
     Bs64u m_startOffset;
     bool  m_trace;
     bool  m_traceOffset;
+    bool  m_binTrace;
     Bs32u m_traceLevel;
     FILE* m_log;
 };
@@ -268,21 +421,32 @@ public:
 #ifdef __BS_TRACE__
     inline bool Trace() { return m_trace; }
     inline bool TraceOffset() { return m_traceOffset; }
+    inline bool BinTrace() { return m_binTrace; }
     inline void TLStart(Bs32u level) { m_trace = !!(m_traceLevel & level); m_tln++; m_tla |= (Bs64u(m_trace) << m_tln); };
     inline void TLEnd() { m_tla &= ~(Bs64u(1) << m_tln); m_tln--; m_trace = !!(1 & (m_tla >> m_tln)); };
     inline bool TLTest(Bs32u tl) { return !!(m_traceLevel & tl); }
     inline void SetTraceLevel(Bs32u level) { m_traceLevel = level; m_traceOffset = !!(level & 0x80000000); };
+    inline void SetBinTrace(bool f) { m_binTrace = f; };
 #else
     inline bool Trace() { return false; }
     inline bool TraceOffset() { return false; }
+    inline bool BinTrace() { return false; }
     inline void TLStart(Bs32u /*level*/) { };
     inline void TLEnd() {};
     inline bool TLTest(Bs32u /*tl*/) { return false; }
     inline void SetTraceLevel(Bs32u /*level*/) { };
+    inline void SetBinTrace(bool /*f*/) { };
 #endif
 
     inline FILE* GetLog() { return m_log; }
-    inline void SetLog(FILE* log) { m_log = log; }
+    inline void SetLog(FILE* log) { m_binLog.reset(); m_log = log; }
+
+    inline BinTraceWriter& GetBinTrace()
+    {
+        if (!m_binLog)
+            m_binLog.reset(new BinTraceWriter(m_log));
+        return *m_binLog;
+    }
 
     template<class T, Bs32u depth> void traceMDArr(
         const void* arr,
@@ -291,98 +455,18 @@ public:
         const char* format,
         Bs16u split2 = 0)
     {
-        Bs16u off[depth];
-        for (Bs32u i = 0; i < depth; i++)
-        {
-            off[i] = 1;
-            for (Bs32u j = i + 1; j < depth; j++)
-                off[i] *= sz[j];
-        }
-        for (Bs32u i = 0, j = 0; i < Bs32u(off[0] * sz[0]); i++)
-        {
-            while (i % off[j] == 0)
-            {
-                fprintf(GetLog(), "{ ");
-
-                if (j < (split))
-                {
-                    fprintf(GetLog(), "\n");
-                    for (Bs32u c = 0; c <= j; c++)
-                        fprintf(GetLog(), "  ");
-                }
-                if (j == depth - 2)
-                    break;
-                j++;
-            }
-            fprintf(GetLog(), format, ((const T*)arr)[i]);
-            if (split2 && (i + 1) % split2 == 0
-                && (i + 1) / split2 > 0
-                && (i + 1) % off[j] != 0)
-            {
-                fprintf(GetLog(), "\n");
-                for (Bs32u c = 0; c <= j; c++)
-                    fprintf(GetLog(), "  ");
-            }
-            while ((i + 1) % off[j] == 0)
-            {
-                bool f = j ? (i + 1) % off[--j] == 0 : !!j--;
-                fprintf(GetLog(), "} ");
-                if (j < (split))
-                {
-                    fprintf(GetLog(), "\n");
-                    for (Bs32u c = 0; c + f <= j; c++)
-                        fprintf(GetLog(), "  ");
-                }
-                if (!f)
-                {
-                    j++;
-                    break;
-                }
-            }
-        }
-        fprintf(GetLog(), "\n");
+        TraceMDArr(GetLog(), (const T*)arr, sz, depth, split, format, split2);
     }
 
     template<class T> void traceBin(T* p, Bs32u off, Bs32u sz)
     {
-        Bs32u S0 = sizeof(T) * 8;
-        Bs32u O = off;
-        T* P0 = p;
-
-        if (off + sz > BS_MAX(S0, 32))
-        {
-            fprintf(GetLog(), "\n");
-
-            for (Bs32u i = 0; i < off; i++)
-                fprintf(GetLog(), " ");
-        }
-
-        while (sz)
-        {
-            Bs32u S = S0 - O;
-            Bs32u S1 = S0 - (O + BS_MIN(sz, S));
-
-            sz -= (S - S1);
-
-            while (S-- > S1)
-                fprintf(GetLog(), "%d", !!(*p & (1 << S)));
-
-            p++;
-            O = 0;
-
-            if (sz)
-            {
-                if ((p - P0) * S0 % 32 == 0)
-                    fprintf(GetLog(), "\n");
-                else
-                    fprintf(GetLog(), " ");
-            }
-        }
+        TraceBin(GetLog(), (const T*)p, off, sz);
     }
 
 private:
     Bs64u m_tla;
     Bs32u m_tln;
+    std::unique_ptr<BinTraceWriter> m_binLog;
 
     void MoreData(Bs32u keepBytes = 4);
     bool MoreDataNoThrow(Bs32u keepBytes = 4);
@@ -0,0 +1,268 @@
+// Copyright (c) 2018-2020 Intel Corporation
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "bs_def.h"
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <type_traits>
+
+namespace BsReader2
+{
+
+/*
+Binary trace stream layout:
+    header: "BSTB" + version byte
+    records: tag byte followed by LEB128 varints
+
+    tag = type | BT_HAS_OFFSET | BT_HAS_CABAC
+    offset (if BT_HAS_OFFSET): zigzag(byte offset delta) << 3 | bit offset
+    CABAC state (if BT_HAS_CABAC): R, V
+
+    Names, printf() formats and mapped strings are sent once as BT_STRING_DEF
+    and referenced by index afterwards. Signed values are zigzag-coded.
+*/
+
+static const Bs8u BIN_TRACE_MAGIC[4] = { 'B', 'S', 'T', 'B' };
+static const Bs8u BIN_TRACE_VERSION  = 1;
+
+enum BIN_TRACE_RECORD
+{
+    BT_STRING_DEF = 0, // length, chars
+    BT_VALUE,          // name, value
+    BT_VALUE64,        // name, value
+    BT_MAPPED,         // name, value, string
+    BT_STRING,         // string
+    BT_ARRAY,          // name, format, split, size, values
+    BT_ARRAY_MAPPED,   // name, format, split, size, (value, string) pairs
+    BT_MDARRAY,        // name, format, split, split2, depth, dims, values
+    BT_BIN,            // name, element size, bit offset, bit count, elements
+
+    BT_TYPE_MASK  = 0x0F,
+    BT_HAS_OFFSET = 0x10,
+    BT_HAS_CABAC  = 0x20
+};
+
+// values traced only through a map (e.g. RefPic) have no numeric representation
+template<class T> inline typename std::enable_if<std::is_arithmetic<T>::value || std::is_enum<T>::value, Bs32s>::type
+BinTraceValue(const T& v) { return Bs32s(v); }
+
+template<class T> inline typename std::enable_if<!std::is_arithmetic<T>::value && !std::is_enum<T>::value, Bs32s>::type
+BinTraceValue(const T&) { return 0; }
+
+class BinTraceWriter
+{
+public:
+    BinTraceWriter(FILE* f);
+    ~BinTraceWriter();
+
+    inline FILE* GetFile() { return m_f; }
+    void Flush();
+
+    // attached to the next record
+    inline void Offset(Bs64u byteOffset, Bs32u bitOffset)
+    {
+        m_flags = BT_HAS_OFFSET;
+        m_byteOffset = byteOffset;
+        m_bitOffset = bitOffset;
+    }
+    inline void Offset(Bs64u byteOffset, Bs32u bitOffset, Bs32u r, Bs32u v)
+    {
+        Offset(byteOffset, bitOffset);
+        m_flags |= BT_HAS_CABAC;
+        m_r = r;
+        m_v = v;
+    }
+
+    template<class T> void Value(const char* name, T v)
+    {
+        // same conversion as text trace does for "%i"/"%lli"
+        bool is64 = std::is_same<Bs64u, T>::value;
+        Bs32u id = Id(name);
+        Start(is64 ? BT_VALUE64 : BT_VALUE);
+        PutU(id);
+        PutS(is64 ? Bs64s(v) : Bs64s(int(v)));
+        End();
+    }
+
+    void Mapped(const char* name, Bs32s v, const char* str);
+    void String(const char* str);
+
+    // array elements are collected until ArrayEnd() to keep the stream
+    // consistent if parsing throws in the middle of the array
+    void ArrayBegin(const char* name, const char* format, Bs32u split);
+    template<class T> void ArrayElem(const T& v) { m_arr.push_back(BinTraceValue(v)); }
+    template<class T> void ArrayElem(const T& v, const char* str) { m_arr.push_back(BinTraceValue(v)); m_arrStr.push_back(IdStr(str)); }
+    void ArrayEnd();
+
+    template<class T> void MDArray(
+        const char* name,
+        const char* format,
+        const T* arr,
+        const Bs16u* dim,
+        Bs32u depth,
+        Bs16u split,
+        Bs16u split2)
+    {
+        Bs32u n = 1;
+        Bs32u idName = Id(name);
+        Bs32u idFormat = Id(format);
+
+        Start(BT_MDARRAY);
+        PutU(idName);
+        PutU(idFormat);
+        PutU(split);
+        PutU(split2);
+        PutU(depth);
+        for (Bs32u i = 0; i < depth; i++)
+        {
+            PutU(dim[i]);
+            n *= dim[i];
+        }
+        for (Bs32u i = 0; i < n; i++)
+            PutS(int(arr[i]));
+        End();
+    }
+
+    template<class T> void Bin(const char* name, const T* p, Bs32u off, Bs32u sz)
+    {
+        Bs32u S0 = sizeof(T) * 8;
+        Bs32u n = (off + sz + S0 - 1) / S0;
+        Bs32u id = Id(name);
+
+        Start(BT_BIN);
+        PutU(id);
+        PutU(sizeof(T));
+        PutU(off);
+        PutU(sz);
+        Put(p, sz ? n * sizeof(T) : 0);
+        End();
+    }
+
+private:
+    static const Bs32u BUFF_SIZE = (1 << 16);
+
+    FILE* m_f;
+    std::vector<Bs8u> m_buf;
+    std::unordered_map<const void*, Bs32u> m_id;
+    std::unordered_map<std::string, Bs32u> m_idStr;
+    Bs32u m_numStr;
+
+    Bs32u m_flags;
+    Bs64u m_byteOffset;
+    Bs64u m_lastByteOffset;
+    Bs32u m_bitOffset;
+    Bs32u m_r;
+    Bs32u m_v;
+
+    Bs32u m_arrName;
+    Bs32u m_arrFormat;
+    Bs32u m_arrSplit;
+    std::vector<Bs32s> m_arr;
+    std::vector<Bs32u> m_arrStr;
+
+    inline void PutU(Bs64u v)
+    {
+        while (v >= 0x80)
+        {
+            m_buf.push_back(Bs8u(v | 0x80));
+            v >>= 7;
+        }
+        m_buf.push_back(Bs8u(v));
+    }
+    inline void PutS(Bs64s v) { PutU((Bs64u(v) << 1) ^ Bs64u(v >> 63)); }
+    inline void Put(const void* p, Bs32u n) { m_buf.insert(m_buf.end(), (const Bs8u*)p, (const Bs8u*)p + n); }
+
+    // strings with static storage (names, formats) are looked up by address,
+    // trace maps may return temporary buffers so those are looked up by content
+    Bs32u Id(const char* str);
+    Bs32u IdStr(const char* str);
+    Bs32u DefStr(const char* str);
+
+    void Start(Bs32u type);
+    inline void End() { if (m_buf.size() >= BUFF_SIZE) Flush(); }
+};
+
+struct BinTraceRecord
+{
+    Bs32u Type;
+    bool  HasOffset;
+    bool  HasCABAC;
+    Bs64u ByteOffset;
+    Bs32u BitOffset;
+    Bs32u R;
+    Bs32u V;
+
+    const char* Name;
+    const char* Format;
+    Bs32u Split;
+    Bs32u Split2;
+    Bs32u ElemSize; // BT_BIN
+    Bs32u Offset;   // BT_BIN
+    Bs32u Size;     // BT_BIN
+
+    std::vector<Bs16u>       Dim;
+    std::vector<Bs64s>       Value;
+    std::vector<const char*> Str;
+    std::vector<Bs8u>        Raw;   // BT_BIN elements
+};
+
+class BinTraceReader
+{
+public:
+    BinTraceReader();
+
+    // reads and checks stream header
+    bool Open(FILE* f);
+    // returns false at the end of stream or on error
+    bool Next(BinTraceRecord& rec);
+    inline bool Error() { return m_err; }
+
+private:
+    static const Bs32u BUFF_SIZE = (1 << 16);
+
+    FILE* m_f;
+    std::vector<Bs8u> m_buf;
+    Bs8u* m_cur;
+    Bs8u* m_end;
+    bool  m_err;
+    Bs64u m_lastByteOffset;
+    std::deque<std::string> m_str;
+
+    bool More();
+    inline bool GetByte(Bs8u& b)
+    {
+        if (m_cur == m_end && !More())
+            return false;
+        b = *m_cur++;
+        return true;
+    }
+    Bs64u GetU();
+    inline Bs64s GetS() { Bs64u v = GetU(); return Bs64s(v >> 1) ^ -Bs64s(v & 1); }
+    const char* GetStr();
+    void Get(void* p, Bs32u n);
+};
+
+}
@@ -29,6 +29,7 @@
 #include <algorithm>
 #include <vector>
 #include <list>
+#include <memory>
 
 namespace BS_HEVC2
 {
@@ -114,6 +115,22 @@ inline bool isRASL(NALU& nalu) {
     return ((nalu.nal_unit_type == RASL_R) || (nalu.nal_unit_type == RASL_N));
 }
 
+inline bool isSLNonRefPic(NALU& nalu) {
+    switch (nalu.nal_unit_type) {
+    case TRAIL_N:
+    case TSA_N:
+    case STSA_N:
+    case RADL_N:
+    case RASL_N:
+    case RSV_VCL_N10:
+    case RSV_VCL_N12:
+    case RSV_VCL_N14:
+        return true;
+    default:
+        return false;
+    }
+}
+
 inline bool isBLA(NALU& nalu) {
     return ((nalu.nal_unit_type == BLA_W_LP)
         || (nalu.nal_unit_type == BLA_W_RADL)
@@ -403,6 +420,8 @@ public:
            Bs16u PaletteEscapeVal(Bs16u cIdx, bool cu_transquant_bypass_flag);
 };
 
+class SDColumnsBuilder;
+
 class SDParser //Slice data parser
     : public  BsReader2::Reader
     , private CABAC
@@ -477,8 +496,12 @@ private:
     void parseDQP (CU& cu);
     void parseCQPO(CU& cu);
 
+    bool   NeedColMv(NALU& nalu);
+    ColMv* BuildColMv(Slice& slice, const PU* pu, Bs32u nPU);
+
 public:
     BS_MEM::Allocator* m_pAllocator;
+    SDColumnsBuilder*  m_pColumns;
 
     SDParser(bool report_TC = false);
 
@@ -531,6 +554,89 @@ struct SyncPoint
     BS_MEM::Allocator* pAllocator;
 };
 
+class SDColumnsBuilder
+{
+public:
+    SDColumnsBuilder() : m_cols() {}
+
+    // starts new AU, memory of columns is kept for reuse
+    void Reset();
+    // appends slice segment from slice data parser working arrays,
+    // elements of each level are contiguous and in parsing order there
+    void Append(Slice& slice, CTU* ctu, Bs32u nCTU, CU* cu, Bs32u nCU, PU* pu, Bs32u nPU, TU* tu, Bs32u nTU);
+    SDColumns& Get();
+
+private:
+    // leaves elements added by resize() uninitialized, Append() writes all of them
+    template<class T> struct NoInitAllocator : std::allocator<T>
+    {
+        template<class U> struct rebind { typedef NoInitAllocator<U> other; };
+
+        NoInitAllocator() = default;
+        template<class U> NoInitAllocator(const NoInitAllocator<U>&) {}
+
+        template<class U> void construct(U* p) { ::new((void*)p) U; }
+        template<class U, class... Args> void construct(U* p, Args&&... args) { ::new((void*)p) U(std::forward<Args>(args)...); }
+    };
+
+    template<class T> using Col = std::vector<T, NoInitAllocator<T>>;
+
+    // appends n elements to column, returns pointer to the first one
+    template<class T> static T* Grow(Col<T>& col, Bs32u n)
+    {
+        size_t size = col.size();
+        col.resize(size + n);
+        return col.data() + size;
+    }
+
+    Col<Slice*> m_sliceHeader;
+    Col<Bs32u>  m_sliceFirstCtu;
+    Col<Bs32u>  m_sliceNumCtu;
+
+    Col<Bs16u>  m_ctbAddrInRs;
+    Col<Bs16u>  m_ctbAddrInTs;
+    Col<Bs8u>   m_ctuEndOfSliceSegment;
+    Col<SAO>    m_ctuSao;
+    Col<Bs32u>  m_ctuFirstCu;
+    Col<Bs16u>  m_ctuNumCu;
+
+    Col<Bs16u>  m_cuX;
+    Col<Bs16u>  m_cuY;
+    Col<Bs8u>   m_cuLog2CbSize;
+    Col<Bs8u>   m_cuPredMode;
+    Col<Bs8u>   m_cuPartMode;
+    Col<Bs8u>   m_cuFlags;
+    Col<Bs8u>   m_cuChromaQpOffsetIdx;
+    Col<Bs8u>   m_cuIntraPredModeY;
+    Col<Bs8u>   m_cuIntraPredModeC;
+    Col<Bs16s>  m_cuQp;
+    Col<Bs32u>  m_cuFirstPu;
+    Col<Bs8u>   m_cuNumPu;
+    Col<Bs32u>  m_cuFirstTu;
+    Col<Bs16u>  m_cuNumTu;
+
+    Col<Bs16u>  m_puX;
+    Col<Bs16u>  m_puY;
+    Col<Bs8u>   m_puW;
+    Col<Bs8u>   m_puH;
+    Col<Bs8u>   m_puMergeFlag;
+    Col<Bs8u>   m_puMergeIdx;
+    Col<Bs8u>   m_puInterPredIdc;
+    Col<Bs8u>   m_puMvpFlag;
+    Col<Bs8u>   m_puRefIdx;
+    Col<Bs16s>  m_puMvLX;
+
+    Col<Bs16u>  m_tuX;
+    Col<Bs16u>  m_tuY;
+    Col<Bs8u>   m_tuLog2TrafoSize;
+    Col<Bs8u>   m_tuCbf;
+    Col<Bs8u>   m_tuTransformSkip;
+    Col<Bs16s>  m_tuQp;
+    Col<Bs32s*> m_tuTcLevelsLuma;
+
+    SDColumns m_cols;
+};
+
 class Parser
     : private BS_MEM::Allocator
     , private BsReader2::File
@@ -588,6 +694,7 @@ private:
     BSErr m_auErr;
     Bs16u m_asyncAUMax;
     Bs16u m_asyncAUCnt;
+    SDColumnsBuilder m_columns;
 
     static BsThread::State ParallelAU(void* self, unsigned int);
     static BsThread::State ParallelSD(void* self, unsigned int);
@@ -610,11 +717,13 @@ public:
 
     BSErr parse_next_au(NALU*& pAU);
     BSErr sync(NALU* pAU);
+    BSErr get_columns(SDColumns*& pColumns);
 
     BSErr Lock(void* p);
     BSErr Unlock(void* p);
 
     void set_trace_level(Bs32u level);
+    void set_trace_binary(bool binary);
     inline Bs64u get_cur_pos() { return GetByteOffset(); }
     inline Bs16u get_async_depth() { return m_asyncAUMax; }
 
@@ -35,6 +35,7 @@ enum INIT_MODE
     PARALLEL_SD         = 0x04,
     PARALLEL_TILES      = 0x08,
     PARSE_SSD_TC        = 0x10 | PARSE_SSD,
+    PARSE_SSD_SOA       = 0x20 | PARSE_SSD, // slice data of AU is reported as SDColumns, no CTU lists, TMVP uses Slice::colMv, not compatible with ASYNC
 
     ASYNC               = (PARALLEL_AU | PARALLEL_SD | PARALLEL_TILES)
 };
@@ -875,6 +876,14 @@ struct CTU
     CTU* Next;
 };
 
+// Motion of 16x16 luma block of collocated picture (8.5.3.2.8),
+// kept instead of CTU lists in PARSE_SSD_SOA mode
+struct ColMv
+{
+    Bs16s MvLX[2][2];
+    Bs8s  RefIdxLX[2]; // -1 if PredFlagLX is 0, both are -1 for intra block
+};
+
 struct Slice
 {
     Bs32u first_slice_segment_in_pic_flag           : 1;
@@ -953,6 +962,7 @@ struct Slice
     PPS    *pps;
     SPS    *sps;
     CTU    *ctu;
+    ColMv  *colMv; // [NumCTU][CtbSizeY/16][CtbSizeY/16], PARSE_SSD_SOA only
 };
 
 struct NALU
@@ -980,4 +990,84 @@ struct NALU
     NALU* next;
 };
 
+enum CU_FLAGS
+{
+    CU_TRANSQUANT_BYPASS = 0x01,
+    CU_PCM               = 0x02,
+    CU_PALETTE           = 0x04,
+    CU_CHROMA_QP_OFFSET  = 0x08
+};
+
+enum TU_CBF
+{
+    TU_CBF_LUMA = 0x01,
+    TU_CBF_CB   = 0x02,
+    TU_CBF_CB1  = 0x04,
+    TU_CBF_CR   = 0x08,
+    TU_CBF_CR1  = 0x10
+};
+
+// Slice data of one AU in structure-of-arrays layout (PARSE_SSD_SOA).
+// Element i of each level is described by i-th entries of the level columns,
+// its children are [First*[i], First*[i] + Num*[i]) of the next level, in parsing order.
+// Columns are owned by parser and valid until next AU is parsed.
+struct SDColumns
+{
+    Bs32u NumSlices;
+    Bs32u NumCTU;
+    Bs32u NumCU;
+    Bs32u NumPU;
+    Bs32u NumTU;
+
+    //slice segments
+    Slice** SliceHeader;
+    Bs32u*  SliceFirstCtu;
+    Bs32u*  SliceNumCtu;
+
+    //CTUs
+    Bs16u*  CtbAddrInRs;
+    Bs16u*  CtbAddrInTs;
+    Bs8u*   CtuEndOfSliceSegment;
+    SAO   (*CtuSao)[3];
+    Bs32u*  CtuFirstCu;
+    Bs16u*  CtuNumCu;
+
+    //CUs
+    Bs16u*  CuX;
+    Bs16u*  CuY;
+    Bs8u*   CuLog2CbSize;
+    Bs8u*   CuPredMode;
+    Bs8u*   CuPartMode;
+    Bs8u*   CuFlags; //CU_FLAGS
+    Bs8u*   CuChromaQpOffsetIdx;
+    Bs8u  (*CuIntraPredModeY)[2][2];
+    Bs8u  (*CuIntraPredModeC)[2][2];
+    Bs16s (*CuQp)[3]; //QpY, QpCb, QpCr
+    Bs32u*  CuFirstPu;
+    Bs8u*   CuNumPu;
+    Bs32u*  CuFirstTu;
+    Bs16u*  CuNumTu;
+
+    //PUs
+    Bs16u*  PuX;
+    Bs16u*  PuY;
+    Bs8u*   PuW;
+    Bs8u*   PuH;
+    Bs8u*   PuMergeFlag;
+    Bs8u*   PuMergeIdx;
+    Bs8u*   PuInterPredIdc;
+    Bs8u  (*PuMvpFlag)[2];
+    Bs8u  (*PuRefIdx)[2];
+    Bs16s (*PuMvLX)[2][2];
+
+    //TUs
+    Bs16u*  TuX;
+    Bs16u*  TuY;
+    Bs8u*   TuLog2TrafoSize;
+    Bs8u*   TuCbf; //TU_CBF
+    Bs8u*   TuTransformSkip;
+    Bs16s (*TuQp)[3];
+    Bs32s** TuTcLevelsLuma;
+};
+
 };
@@ -102,6 +102,7 @@ Reader::Reader()
     m_updater = 0;
     m_trace = true;
     m_traceOffset = true;
+    m_binTrace = false;
     m_traceLevel = 0xFFFFFFFF;
     m_tla = m_trace;
     m_tln = 0;
@@ -0,0 +1,385 @@
+// Copyright (c) 2018-2020 Intel Corporation
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "bs_trace_bin.h"
+
+#if defined(_WIN32) || defined(_WIN64)
+#include <io.h>
+#include <fcntl.h>
+#endif
+
+namespace BsReader2
+{
+
+BinTraceWriter::BinTraceWriter(FILE* f)
+    : m_f(f)
+    , m_numStr(0)
+    , m_flags(0)
+    , m_byteOffset(0)
+    , m_lastByteOffset(0)
+    , m_bitOffset(0)
+    , m_r(0)
+    , m_v(0)
+    , m_arrName(0)
+    , m_arrFormat(0)
+    , m_arrSplit(0)
+{
+#if defined(_WIN32) || defined(_WIN64)
+    _setmode(_fileno(m_f), _O_BINARY);
+#endif
+    m_buf.reserve(BUFF_SIZE * 2);
+    Put(BIN_TRACE_MAGIC, sizeof(BIN_TRACE_MAGIC));
+    m_buf.push_back(BIN_TRACE_VERSION);
+}
+
+BinTraceWriter::~BinTraceWriter()
+{
+    Flush();
+}
+
+void BinTraceWriter::Flush()
+{
+    if (m_buf.empty())
+        return;
+
+    fwrite(m_buf.data(), 1, m_buf.size(), m_f);
+    fflush(m_f);
+    m_buf.clear();
+}
+
+Bs32u BinTraceWriter::DefStr(const char* str)
+{
+    Bs32u len = Bs32u(strlen(str));
+
+    m_buf.push_back(BT_STRING_DEF);
+    PutU(len);
+    Put(str, len);
+
+    return m_numStr++;
+}
+
+Bs32u BinTraceWriter::Id(const char* str)
+{
+    auto it = m_id.find(str);
+
+    if (it != m_id.end())
+        return it->second;
+
+    return m_id[str] = DefStr(str);
+}
+
+Bs32u BinTraceWriter::IdStr(const char* str)
+{
+    auto it = m_idStr.find(str);
+
+    if (it != m_idStr.end())
+        return it->second;
+
+    return m_idStr[str] = DefStr(str);
+}
+
+void BinTraceWriter::Start(Bs32u type)
+{
+    m_buf.push_back(Bs8u(type | m_flags));
+
+    if (m_flags & BT_HAS_OFFSET)
+    {
+        Bs64s d = Bs64s(m_byteOffset - m_lastByteOffset);
+        PutU((((Bs64u(d) << 1) ^ Bs64u(d >> 63)) << 3) | (m_bitOffset & 7));
+        m_lastByteOffset = m_byteOffset;
+    }
+
+    if (m_flags & BT_HAS_CABAC)
+    {
+        PutU(m_r);
+        PutU(m_v);
+    }
+
+    m_flags = 0;
+}
+
+void BinTraceWriter::Mapped(const char* name, Bs32s v, const char* str)
+{
+    Bs32u idName = Id(name);
+    Bs32u idStr = IdStr(str);
+
+    Start(BT_MAPPED);
+    PutU(idName);
+    PutS(v);
+    PutU(idStr);
+    End();
+}
+
+void BinTraceWriter::String(const char* str)
+{
+    Bs32u id = IdStr(str);
+
+    Start(BT_STRING);
+    PutU(id);
+    End();
+}
+
+void BinTraceWriter::ArrayBegin(const char* name, const char* format, Bs32u split)
+{
+    m_arrName = Id(name);
+    m_arrFormat = Id(format);
+    m_arrSplit = split;
+    m_arr.clear();
+    m_arrStr.clear();
+}
+
+void BinTraceWriter::ArrayEnd()
+{
+    bool mapped = !m_arrStr.empty();
+
+    Start(mapped ? BT_ARRAY_MAPPED : BT_ARRAY);
+    PutU(m_arrName);
+    PutU(m_arrFormat);
+    PutU(m_arrSplit);
+    PutU(m_arr.size());
+
+    for (size_t i = 0; i < m_arr.size(); i++)
+    {
+        PutS(m_arr[i]);
+        if (mapped)
+            PutU(m_arrStr[i]);
+    }
+
+    End();
+}
+
+BinTraceReader::BinTraceReader()
+    : m_f(0)
+    , m_cur(0)
+    , m_end(0)
+    , m_err(false)
+    , m_lastByteOffset(0)
+{
+}
+
+bool BinTraceReader::Open(FILE* f)
+{
+    Bs8u hdr[sizeof(BIN_TRACE_MAGIC) + 1] = {};
+
+    m_f = f;
+    m_buf.resize(BUFF_SIZE);
+    m_cur = m_end = m_buf.data();
+    m_err = false;
+    m_lastByteOffset = 0;
+    m_str.clear();
+
+#if defined(_WIN32) || defined(_WIN64)
+    _setmode(_fileno(m_f), _O_BINARY);
+#endif
+
+    Get(hdr, sizeof(hdr));
+
+    m_err |= !!memcmp(hdr, BIN_TRACE_MAGIC, sizeof(BIN_TRACE_MAGIC))
+        || hdr[sizeof(BIN_TRACE_MAGIC)] != BIN_TRACE_VERSION;
+
+    return !m_err;
+}
+
+bool BinTraceReader::More()
+{
+    size_t n = fread(m_buf.data(), 1, m_buf.size(), m_f);
+
+    m_cur = m_buf.data();
+    m_end = m_cur + n;
+
+    return !!n;
+}
+
+Bs64u BinTraceReader::GetU()
+{
+    Bs64u v = 0;
+    Bs8u b = 0x80;
+
+    for (Bs32u s = 0; (b & 0x80) && s < 64; s += 7)
+    {
+        if (!GetByte(b))
+        {
+            m_err = true;
+            return 0;
+        }
+        v |= Bs64u(b & 0x7F) << s;
+    }
+
+    return v;
+}
+
+void BinTraceReader::Get(void* p, Bs32u n)
+{
+    Bs8u* dst = (Bs8u*)p;
+
+    for (Bs32u i = 0; i < n; i++)
+    {
+        if (!GetByte(dst[i]))
+        {
+            m_err = true;
+            return;
+        }
+    }
+}
+
+const char* BinTraceReader::GetStr()
+{
+    Bs64u id = GetU();
+
+    if (id >= m_str.size())
+    {
+        m_err = true;
+        return "";
+    }
+
+    return m_str[size_t(id)].c_str();
+}
+
+bool BinTraceReader::Next(BinTraceRecord& rec)
+{
+    Bs8u tag = 0;
+
+    if (m_err)
+        return false;
+
+    for (;;)
+    {
+        if (!GetByte(tag))
+            return false; // end of stream
+
+        if ((tag & BT_TYPE_MASK) != BT_STRING_DEF)
+            break;
+
+        std::string s(size_t(GetU()), ' ');
+        Get(&s[0], Bs32u(s.size()));
+        m_str.push_back(s);
+
+        if (m_err)
+            return false;
+    }
+
+    rec.Type      = (tag & BT_TYPE_MASK);
+    rec.HasOffset = !!(tag & BT_HAS_OFFSET);
+    rec.HasCABAC  = !!(tag & BT_HAS_CABAC);
+    rec.Name      = "";
+    rec.Format    = "";
+    rec.Split     = 0;
+    rec.Split2    = 0;
+    rec.Dim.clear();
+    rec.Value.clear();
+    rec.Str.clear();
+    rec.Raw.clear();
+
+    if (rec.HasOffset)
+    {
+        Bs64u v = GetU();
+        Bs64u d = v >> 3;
+        m_lastByteOffset += Bs64u(Bs64s(d >> 1) ^ -Bs64s(d & 1));
+        rec.ByteOffset = m_lastByteOffset;
+        rec.BitOffset = Bs32u(v & 7);
+    }
+
+    if (rec.HasCABAC)
+    {
+        rec.R = Bs32u(GetU());
+        rec.V = Bs32u(GetU());
+    }
+
+    switch (rec.Type)
+    {
+    case BT_VALUE:
+    case BT_VALUE64:
+        rec.Name = GetStr();
+        rec.Value.push_back(GetS());
+        break;
+    case BT_MAPPED:
+        rec.Name = GetStr();
+        rec.Value.push_back(GetS());
+        rec.Str.push_back(GetStr());
+        break;
+    case BT_STRING:
+        rec.Str.push_back(GetStr());
+        break;
+    case BT_ARRAY:
+    case BT_ARRAY_MAPPED:
+    {
+        rec.Name = GetStr();
+        rec.Format = GetStr();
+        rec.Split = Bs32u(GetU());
+
+        Bs64u n = GetU();
+
+        for (Bs64u i = 0; i < n && !m_err; i++)
+        {
+            rec.Value.push_back(GetS());
+            if (rec.Type == BT_ARRAY_MAPPED)
+                rec.Str.push_back(GetStr());
+        }
+        break;
+    }
+    case BT_MDARRAY:
+    {
+        Bs64u n = 1;
+
+        rec.Name = GetStr();
+        rec.Format = GetStr();
+        rec.Split = Bs32u(GetU());
+        rec.Split2 = Bs32u(GetU());
+        rec.Dim.resize(size_t(GetU()));
+
+        for (auto& d : rec.Dim)
+        {
+            d = Bs16u(GetU());
+            n *= d;
+        }
+
+        for (Bs64u i = 0; i < n && !m_err; i++)
+            rec.Value.push_back(GetS());
+        break;
+    }
+    case BT_BIN:
+    {
+        rec.Name = GetStr();
+        rec.ElemSize = Bs32u(GetU());
+        rec.Offset = Bs32u(GetU());
+        rec.Size = Bs32u(GetU());
+
+        if (!rec.ElemSize || rec.ElemSize > 8)
+        {
+            m_err = true;
+            break;
+        }
+
+        Bs32u S0 = rec.ElemSize * 8;
+        Bs32u n = rec.Size ? (rec.Offset + rec.Size + S0 - 1) / S0 : 0;
+
+        rec.Raw.resize(n * rec.ElemSize);
+        Get(rec.Raw.data(), Bs32u(rec.Raw.size()));
+        break;
+    }
+    default:
+        m_err = true;
+        break;
+    }
+
+    return !m_err;
+}
+
+}
@@ -43,6 +43,8 @@ Bs32u BS_GetVal( void* hdr, Bs32u* element_idx ){
 
 BSErr __STDCALL BS_HEVC2_Init(BS_HEVC2::HDL& hdl, Bs32u mode){
     hdl = NULL;
+    if ((mode & BS_HEVC2::PARSE_SSD_SOA) == BS_HEVC2::PARSE_SSD_SOA && (mode & BS_HEVC2::ASYNC))
+        return BS_ERR_INVALID_PARAMS;
     hdl = new BS_HEVC2::Parser(mode);
     if (hdl)
         return BS_ERR_NONE;
@@ -78,6 +80,12 @@ BSErr __STDCALL BS_HEVC2_SetTraceLevel(BS_HEVC2::HDL hdl, Bs32u level){
     return BS_ERR_NONE;
 }
 
+BSErr __STDCALL BS_HEVC2_SetTraceBinary(BS_HEVC2::HDL hdl, bool binary){
+    if (!hdl) return BS_ERR_BAD_HANDLE;
+    hdl->set_trace_binary(binary);
+    return BS_ERR_NONE;
+}
+
 BSErr __STDCALL BS_HEVC2_Lock(BS_HEVC2::HDL hdl, void* p){
     if (!hdl) return BS_ERR_BAD_HANDLE;
     return hdl->Lock(p);
@@ -104,4 +112,9 @@ Bs16u __STDCALL BS_HEVC2_GetAsyncDepth(BS_HEVC2::HDL hdl){
     return hdl->get_async_depth();
 }
 
+BSErr __STDCALL BS_HEVC2_GetColumns(BS_HEVC2::HDL hdl, BS_HEVC2::SDColumns*& columns){
+    if (!hdl) return BS_ERR_BAD_HANDLE;
+    return hdl->get_columns(columns);
+}
+
 } // extern "C"
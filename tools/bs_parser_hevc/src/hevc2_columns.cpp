@@ -0,0 +1,276 @@
+// Copyright (c) 2020 Intel Corporation
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "hevc2_parser.h"
+
+using namespace BS_HEVC2;
+
+void SDColumnsBuilder::Reset()
+{
+    m_sliceHeader.clear();
+    m_sliceFirstCtu.clear();
+    m_sliceNumCtu.clear();
+
+    m_ctbAddrInRs.clear();
+    m_ctbAddrInTs.clear();
+    m_ctuEndOfSliceSegment.clear();
+    m_ctuSao.clear();
+    m_ctuFirstCu.clear();
+    m_ctuNumCu.clear();
+
+    m_cuX.clear();
+    m_cuY.clear();
+    m_cuLog2CbSize.clear();
+    m_cuPredMode.clear();
+    m_cuPartMode.clear();
+    m_cuFlags.clear();
+    m_cuChromaQpOffsetIdx.clear();
+    m_cuIntraPredModeY.clear();
+    m_cuIntraPredModeC.clear();
+    m_cuQp.clear();
+    m_cuFirstPu.clear();
+    m_cuNumPu.clear();
+    m_cuFirstTu.clear();
+    m_cuNumTu.clear();
+
+    m_puX.clear();
+    m_puY.clear();
+    m_puW.clear();
+    m_puH.clear();
+    m_puMergeFlag.clear();
+    m_puMergeIdx.clear();
+    m_puInterPredIdc.clear();
+    m_puMvpFlag.clear();
+    m_puRefIdx.clear();
+    m_puMvLX.clear();
+
+    m_tuX.clear();
+    m_tuY.clear();
+    m_tuLog2TrafoSize.clear();
+    m_tuCbf.clear();
+    m_tuTransformSkip.clear();
+    m_tuQp.clear();
+    m_tuTcLevelsLuma.clear();
+}
+
+void SDColumnsBuilder::Append(Slice& slice, CTU* ctu, Bs32u nCTU, CU* cu, Bs32u nCU, PU* pu, Bs32u nPU, TU* tu, Bs32u nTU)
+{
+    Bs32u firstCtu = Bs32u(m_ctbAddrInRs.size());
+    Bs32u firstCu  = Bs32u(m_cuX.size());
+    Bs32u firstPu  = Bs32u(m_puX.size());
+    Bs32u firstTu  = Bs32u(m_tuX.size());
+
+    m_sliceHeader.push_back(&slice);
+    m_sliceFirstCtu.push_back(firstCtu);
+    m_sliceNumCtu.push_back(nCTU);
+
+    {
+        auto ctbAddrInRs = Grow(m_ctbAddrInRs, nCTU);
+        auto ctbAddrInTs = Grow(m_ctbAddrInTs, nCTU);
+        auto endOfSS     = Grow(m_ctuEndOfSliceSegment, nCTU);
+        auto sao         = Grow(m_ctuSao, 3 * nCTU);
+        auto firstCU     = Grow(m_ctuFirstCu, nCTU);
+        auto numCU       = Grow(m_ctuNumCu, nCTU);
+
+        for (Bs32u i = 0; i < nCTU; i++)
+        {
+            auto& e = ctu[i];
+            // CUs of next CTU follow CUs of this one
+            Bs32u cur  = Bs32u(e.Cu - cu);
+            Bs32u next = (i + 1 < nCTU) ? Bs32u(ctu[i + 1].Cu - cu) : nCU;
+
+            ctbAddrInRs[i] = e.CtbAddrInRs;
+            ctbAddrInTs[i] = e.CtbAddrInTs;
+            endOfSS[i]     = Bs8u(e.end_of_slice_segment_flag);
+            std::copy(e.sao, e.sao + 3, sao + 3 * i);
+            firstCU[i]     = firstCu + cur;
+            numCU[i]       = Bs16u(next - cur);
+        }
+    }
+
+    {
+        auto x         = Grow(m_cuX, nCU);
+        auto y         = Grow(m_cuY, nCU);
+        auto log2Size  = Grow(m_cuLog2CbSize, nCU);
+        auto predMode  = Grow(m_cuPredMode, nCU);
+        auto partMode  = Grow(m_cuPartMode, nCU);
+        auto flags     = Grow(m_cuFlags, nCU);
+        auto cqpoIdx   = Grow(m_cuChromaQpOffsetIdx, nCU);
+        auto ipmY      = Grow(m_cuIntraPredModeY, 4 * nCU);
+        auto ipmC      = Grow(m_cuIntraPredModeC, 4 * nCU);
+        auto qp        = Grow(m_cuQp, 3 * nCU);
+        auto firstPU   = Grow(m_cuFirstPu, nCU);
+        auto numPU     = Grow(m_cuNumPu, nCU);
+        auto firstTU   = Grow(m_cuFirstTu, nCU);
+        auto numTU     = Grow(m_cuNumTu, nCU);
+        Bs32u nextPu   = nPU;
+        Bs32u nextTu   = nTU;
+
+        // CU without PUs or TUs gets empty range at position of next CU's ones,
+        // so ranges are resolved backwards
+        for (Bs32u i = nCU; i--;)
+        {
+            auto& e = cu[i];
+            Bs32u curPu = e.Pu ? Bs32u(e.Pu - pu) : nextPu;
+            Bs32u curTu = e.Tu ? Bs32u(e.Tu - tu) : nextTu;
+
+            x[i]        = e.x;
+            y[i]        = e.y;
+            log2Size[i] = Bs8u(e.log2CbSize);
+            predMode[i] = Bs8u(e.PredMode);
+            partMode[i] = Bs8u(e.PartMode);
+            flags[i]    = Bs8u(
+                  (e.transquant_bypass_flag ? CU_TRANSQUANT_BYPASS : 0)
+                | (e.pcm_flag               ? CU_PCM : 0)
+                | (e.palette_mode_flag      ? CU_PALETTE : 0)
+                | (e.chroma_qp_offset_flag  ? CU_CHROMA_QP_OFFSET : 0));
+            cqpoIdx[i]  = Bs8u(e.chroma_qp_offset_idx);
+            std::copy(&e.IntraPredModeY[0][0], &e.IntraPredModeY[0][0] + 4, ipmY + 4 * i);
+            std::copy(&e.IntraPredModeC[0][0], &e.IntraPredModeC[0][0] + 4, ipmC + 4 * i);
+            qp[3 * i + 0] = e.QpY;
+            qp[3 * i + 1] = e.QpCb;
+            qp[3 * i + 2] = e.QpCr;
+            firstPU[i]  = firstPu + curPu;
+            numPU[i]    = Bs8u(nextPu - curPu);
+            firstTU[i]  = firstTu + curTu;
+            numTU[i]    = Bs16u(nextTu - curTu);
+
+            nextPu = curPu;
+            nextTu = curTu;
+        }
+    }
+
+    {
+        auto x         = Grow(m_puX, nPU);
+        auto y         = Grow(m_puY, nPU);
+        auto w         = Grow(m_puW, nPU);
+        auto h         = Grow(m_puH, nPU);
+        auto mergeFlag = Grow(m_puMergeFlag, nPU);
+        auto mergeIdx  = Grow(m_puMergeIdx, nPU);
+        auto predIdc   = Grow(m_puInterPredIdc, nPU);
+        auto mvpFlag   = Grow(m_puMvpFlag, 2 * nPU);
+        auto refIdx    = Grow(m_puRefIdx, 2 * nPU);
+        auto mv        = Grow(m_puMvLX, 4 * nPU);
+
+        for (Bs32u i = 0; i < nPU; i++)
+        {
+            auto& e = pu[i];
+
+            x[i]         = e.x;
+            y[i]         = e.y;
+            w[i]         = Bs8u(e.w);
+            h[i]         = Bs8u(e.h);
+            mergeFlag[i] = Bs8u(e.merge_flag);
+            mergeIdx[i]  = Bs8u(e.merge_idx);
+            predIdc[i]   = Bs8u(e.inter_pred_idc);
+            mvpFlag[2 * i + 0] = Bs8u(e.mvp_l0_flag);
+            mvpFlag[2 * i + 1] = Bs8u(e.mvp_l1_flag);
+            refIdx[2 * i + 0]  = Bs8u(e.ref_idx_l0);
+            refIdx[2 * i + 1]  = Bs8u(e.ref_idx_l1);
+            std::copy(&e.MvLX[0][0], &e.MvLX[0][0] + 4, mv + 4 * i);
+        }
+    }
+
+    {
+        auto x         = Grow(m_tuX, nTU);
+        auto y         = Grow(m_tuY, nTU);
+        auto log2Size  = Grow(m_tuLog2TrafoSize, nTU);
+        auto cbf       = Grow(m_tuCbf, nTU);
+        auto tskip     = Grow(m_tuTransformSkip, nTU);
+        auto qp        = Grow(m_tuQp, 3 * nTU);
+        auto tcLevels  = Grow(m_tuTcLevelsLuma, nTU);
+
+        for (Bs32u i = 0; i < nTU; i++)
+        {
+            auto& e = tu[i];
+
+            x[i]        = e.x;
+            y[i]        = e.y;
+            log2Size[i] = Bs8u(e.log2TrafoSize);
+            cbf[i]      = Bs8u(
+                  (e.cbf_luma ? TU_CBF_LUMA : 0)
+                | (e.cbf_cb   ? TU_CBF_CB : 0)
+                | (e.cbf_cb1  ? TU_CBF_CB1 : 0)
+                | (e.cbf_cr   ? TU_CBF_CR : 0)
+                | (e.cbf_cr1  ? TU_CBF_CR1 : 0));
+            tskip[i]    = Bs8u(e.transform_skip_flag);
+            std::copy(e.QP, e.QP + 3, qp + 3 * i);
+            tcLevels[i] = e.tc_levels_luma;
+        }
+    }
+}
+
+SDColumns& SDColumnsBuilder::Get()
+{
+    auto& c = m_cols;
+
+    c.NumSlices = Bs32u(m_sliceHeader.size());
+    c.NumCTU    = Bs32u(m_ctbAddrInRs.size());
+    c.NumCU     = Bs32u(m_cuX.size());
+    c.NumPU     = Bs32u(m_puX.size());
+    c.NumTU     = Bs32u(m_tuX.size());
+
+    c.SliceHeader   = m_sliceHeader.data();
+    c.SliceFirstCtu = m_sliceFirstCtu.data();
+    c.SliceNumCtu   = m_sliceNumCtu.data();
+
+    c.CtbAddrInRs          = m_ctbAddrInRs.data();
+    c.CtbAddrInTs          = m_ctbAddrInTs.data();
+    c.CtuEndOfSliceSegment = m_ctuEndOfSliceSegment.data();
+    c.CtuSao               = (SAO(*)[3])m_ctuSao.data();
+    c.CtuFirstCu           = m_ctuFirstCu.data();
+    c.CtuNumCu             = m_ctuNumCu.data();
+
+    c.CuX                 = m_cuX.data();
+    c.CuY                 = m_cuY.data();
+    c.CuLog2CbSize        = m_cuLog2CbSize.data();
+    c.CuPredMode          = m_cuPredMode.data();
+    c.CuPartMode          = m_cuPartMode.data();
+    c.CuFlags             = m_cuFlags.data();
+    c.CuChromaQpOffsetIdx = m_cuChromaQpOffsetIdx.data();
+    c.CuIntraPredModeY    = (Bs8u(*)[2][2])m_cuIntraPredModeY.data();
+    c.CuIntraPredModeC    = (Bs8u(*)[2][2])m_cuIntraPredModeC.data();
+    c.CuQp                = (Bs16s(*)[3])m_cuQp.data();
+    c.CuFirstPu           = m_cuFirstPu.data();
+    c.CuNumPu             = m_cuNumPu.data();
+    c.CuFirstTu           = m_cuFirstTu.data();
+    c.CuNumTu             = m_cuNumTu.data();
+
+    c.PuX            = m_puX.data();
+    c.PuY            = m_puY.data();
+    c.PuW            = m_puW.data();
+    c.PuH            = m_puH.data();
+    c.PuMergeFlag    = m_puMergeFlag.data();
+    c.PuMergeIdx     = m_puMergeIdx.data();
+    c.PuInterPredIdc = m_puInterPredIdc.data();
+    c.PuMvpFlag      = (Bs8u(*)[2])m_puMvpFlag.data();
+    c.PuRefIdx       = (Bs8u(*)[2])m_puRefIdx.data();
+    c.PuMvLX         = (Bs16s(*)[2][2])m_puMvLX.data();
+
+    c.TuX             = m_tuX.data();
+    c.TuY             = m_tuY.data();
+    c.TuLog2TrafoSize = m_tuLog2TrafoSize.data();
+    c.TuCbf           = m_tuCbf.data();
+    c.TuTransformSkip = m_tuTransformSkip.data();
+    c.TuQp            = (Bs16s(*)[3])m_tuQp.data();
+    c.TuTcLevelsLuma  = m_tuTcLevelsLuma.data();
+
+    return c;
+}
@@ -257,23 +257,6 @@ const Bs8u ScanTraverse5[32 * 32][2] =
     {31,31},{30,31},{29,31},{28,31},{27,31},{26,31},{25,31},{24,31},{23,31},{22,31},{21,31},{20,31},{19,31},{18,31},{17,31},{16,31},{15,31},{14,31},{13,31},{12,31},{11,31},{10,31},{ 9,31},{ 8,31},{ 7,31},{ 6,31},{ 5,31},{ 4,31},{ 3,31},{ 2,31},{ 1,31},{ 0,31},
 };
 
-
-inline bool isSLNonRefPic(NALU& nalu){
-    switch(nalu.nal_unit_type){
-    case TRAIL_N:
-    case TSA_N:
-    case STSA_N:
-    case RADL_N:
-    case RASL_N:
-    case RSV_VCL_N10:
-    case RSV_VCL_N12:
-    case RSV_VCL_N14:
-        return true;
-    default:
-        return false;
-    }
-}
-
 void Info::decodeSSH(NALU& nalu, bool bNewSequence)
 {
     Bs32s i = 0, j = 0, x = 0, y = 0, p = 0, m = 0, tileIdx = 0;
@@ -1550,7 +1533,8 @@ bool Info::decodeMvLXCol(Bs16u xPb, Bs16u yPb, Bs16u nPbW, Bs16u nPbH, Bs16u X,
     Slice* ColPic;
     CU* colCU;
     PU* colPb;
-    Bs16u ColTs, ColRs, refIdxCol;
+    ColMv colMv;
+    Bs16u ColTs, ColRs, ColFirstTs, refIdxCol;
     Bs16s mvCol[2];
     auto& sps = *m_cSlice->sps;
     RefPic *listCol, *LX = (X ? m_cSlice->L1 : m_cSlice->L0);
@@ -1577,65 +1561,88 @@ l_start:
     for (Bs32s i = 0;; i++)
     {
         ColPic = ColPicSlices[i];
-        ColTs  = ColPic->pps->CtbAddrRsToTs[ColRs];
 
-        if (   ColTs >= ColPic->ctu->CtbAddrInTs
-            && ColTs <  (ColPic->ctu->CtbAddrInTs + ColPic->NumCTU))
+        if (!ColPic->ctu && !ColPic->colMv)
+            throw InvalidSyntax();
+
+        ColTs      = ColPic->pps->CtbAddrRsToTs[ColRs];
+        ColFirstTs = ColPic->ctu ? ColPic->ctu->CtbAddrInTs : ColPic->pps->CtbAddrRsToTs[ColPic->slice_segment_address];
+
+        if (   ColTs >= ColFirstTs
+            && ColTs <  (ColFirstTs + ColPic->NumCTU))
             break;
         if (i + 1 >= NumColSlices)
             throw InvalidSyntax();
     }
 
-    if (ColPic->Split)
+    if (ColPic->colMv)
     {
-        colCU = 0;
-        auto pCTU = ColPic->ctu;
-
-        while (pCTU && pCTU->CtbAddrInTs != ColTs)
-            pCTU = pCTU->Next;
+        Bs16u log2BlkInCtb = CtbLog2SizeY - 4;
+        Bs16u blkMask      = (1 << log2BlkInCtb) - 1;
 
-        if (pCTU)
-            colCU = pCTU->Cu;
+        colMv = ColPic->colMv[((ColTs - ColFirstTs) << (2 * log2BlkInCtb))
+            + (((yColPb >> 4) & blkMask) << log2BlkInCtb) + ((xColPb >> 4) & blkMask)];
     }
     else
     {
-        colCU = ColPic->ctu[ColTs - ColPic->ctu[0].CtbAddrInTs].Cu;
+        if (ColPic->Split)
+        {
+            colCU = 0;
+            auto pCTU = ColPic->ctu;
+
+            while (pCTU && pCTU->CtbAddrInTs != ColTs)
+                pCTU = pCTU->Next;
+
+            if (pCTU)
+                colCU = pCTU->Cu;
+        }
+        else
+        {
+            colCU = ColPic->ctu[ColTs - ColFirstTs].Cu;
+        }
+        if (!colCU)
+            throw InvalidSyntax();
+
+        colCU = GetUnit(*colCU, xColPb, yColPb);
+        if (!colCU)
+            throw InvalidSyntax();
+        if (!colCU->Pu)
+            goto l_end;
+
+        colPb = GetUnit(*colCU->Pu, xColPb, yColPb);
+        if (!colPb)
+            throw InvalidSyntax();
+
+        CP(colMv.MvLX, colPb->MvLX);
+        colMv.RefIdxLX[0] = PredFlagLX(*colPb, 0) ? Bs8s(colPb->ref_idx_l0) : -1;
+        colMv.RefIdxLX[1] = PredFlagLX(*colPb, 1) ? Bs8s(colPb->ref_idx_l1) : -1;
     }
-    if (!colCU)
-        throw InvalidSyntax();
 
-    colCU = GetUnit(*colCU, xColPb, yColPb);
-    if (!colCU)
-        throw InvalidSyntax();
-    if (!colCU->Pu)
+    if (colMv.RefIdxLX[0] < 0 && colMv.RefIdxLX[1] < 0)
         goto l_end;
 
-    colPb = GetUnit(*colCU->Pu, xColPb, yColPb);
-    if (!colPb)
-        throw InvalidSyntax();
-
-    if (PredFlagLX(*colPb, 0) == 0)
+    if (colMv.RefIdxLX[0] < 0)
     {
-        CP(mvCol, colPb->MvLX[1]);
-        refIdxCol = colPb->ref_idx_l1;
+        CP(mvCol, colMv.MvLX[1]);
+        refIdxCol = colMv.RefIdxLX[1];
         listCol   = ColPic->L1;
     }
-    else if (PredFlagLX(*colPb, 1) == 0)
+    else if (colMv.RefIdxLX[1] < 0)
     {
-        CP(mvCol, colPb->MvLX[0]);
-        refIdxCol = colPb->ref_idx_l0;
+        CP(mvCol, colMv.MvLX[0]);
+        refIdxCol = colMv.RefIdxLX[0];
         listCol   = ColPic->L0;
     }
     else if (NoBackwardPredFlag)
     {
-        CP(mvCol, colPb->MvLX[X]);
-        refIdxCol = X ? colPb->ref_idx_l1 : colPb->ref_idx_l0;
+        CP(mvCol, colMv.MvLX[X]);
+        refIdxCol = colMv.RefIdxLX[X];
         listCol   = X ? ColPic->L1 : ColPic->L0;
     }
     else
     {
-        CP(mvCol, colPb->MvLX[!m_cSlice->collocated_from_l0_flag]);
-        refIdxCol = m_cSlice->collocated_from_l0_flag ? colPb->ref_idx_l0 : colPb->ref_idx_l1;
+        CP(mvCol, colMv.MvLX[!m_cSlice->collocated_from_l0_flag]);
+        refIdxCol = colMv.RefIdxLX[!m_cSlice->collocated_from_l0_flag];
         listCol   = m_cSlice->collocated_from_l0_flag ? ColPic->L0 : ColPic->L1;
     }
 
@@ -43,6 +43,9 @@ Parser::Parser(Bs32u mode)
     memset(&m_prevPOC, 0, sizeof(m_prevPOC));
     m_pAllocator = &(BS_MEM::Allocator&)*this;
 
+    if ((m_mode & PARSE_SSD_SOA) == PARSE_SSD_SOA)
+        m_pColumns = &m_columns;
+
     m_asyncAUMax = 0;
     m_asyncAUCnt = 0;
 
@@ -146,6 +149,14 @@ void Parser::set_trace_level(Bs32u level)
         t.p.SetTraceLevel(level);
 }
 
+void Parser::set_trace_binary(bool binary)
+{
+    SetBinTrace(binary);
+
+    for (auto& t : m_sdt)
+        t.p.SetBinTrace(binary);
+}
+
 inline bool isSuffix(NALU& nalu, bool nextBit){
     return (isSlice(nalu) && !nextBit)
         || (nalu.nal_unit_type == SUFFIX_SEI_NUT)
@@ -382,6 +393,16 @@ BSErr Parser::parse_next_au(NALU*& pAU)
     return sts;
 }
 
+BSErr Parser::get_columns(SDColumns*& pColumns)
+{
+    if ((m_mode & PARSE_SSD_SOA) != PARSE_SSD_SOA)
+        return BS_ERR_INVALID_PARAMS;
+
+    pColumns = &m_columns.Get();
+
+    return BS_ERR_NONE;
+}
+
 BSErr Parser::ParseNextAuSubmit(NALU*& pAU)
 {
     std::unique_lock<std::mutex> lock(m_mtx);
@@ -512,6 +533,9 @@ BSErr Parser::ParseNextAu(NALU*& pAU)
     AutoUnlockSDT _au(pSDT);
     m_activeSPS = 0;
 
+    if ((m_mode & PARSE_SSD_SOA) == PARSE_SSD_SOA)
+        m_columns.Reset();
+
     try
     {
         for (;; auSize++)
@@ -568,7 +592,9 @@ BSErr Parser::ParseNextAu(NALU*& pAU)
                         else
                         {
                             m_cSlice->ctu = parseSSD(*nalu.p, GetColPic(*m_cSlice));
-                            bound(m_cSlice->ctu, m_cSlice);
+
+                            if (m_cSlice->ctu)
+                                bound(m_cSlice->ctu, m_cSlice);
                         }
 
                         UpdateColPics(firstNALU, *m_cSlice);
@@ -26,14 +26,17 @@ using namespace BsReader2;
 
 #undef BS2_TRO
 #define BS2_TRO\
- if (TraceOffset()) fprintf(GetLog(), "0x%016llX[%i]|%3u|%3u: ",\
-     GetByteOffset(), GetBitOffset(), GetR(), GetV());
+ if (TraceOffset()) {\
+   if (BinTrace()) GetBinTrace().Offset(GetByteOffset(), GetBitOffset(), GetR(), GetV());\
+   else fprintf(GetLog(), "0x%016llX[%i]|%3u|%3u: ",\
+     GetByteOffset(), GetBitOffset(), GetR(), GetV()); }
 
 SDParser::SDParser(bool report_TC)
     : Reader()
     , CABAC((Reader&)*this)
     , report_TCLevels(report_TC)
     , m_pAllocator(nullptr)
+    , m_pColumns(nullptr)
 {
     SetTraceLevel(TRACE_DEFAULT);
     SetEmulation(false);
@@ -171,6 +174,11 @@ CTU* SDParser::parseSSD(NALU& nalu, NALU* pColPic, Bs32u NumCtb)
             break;
         }
 
+        // slice data without end_of_slice_segment_flag on last CTB of picture,
+        // CtbAddrTsToRs[] and SliceAddrRsInTs[] have only PicSizeInCtbsY entries
+        if (CtbAddrInTs + 1u >= PicSizeInCtbsY)
+            throw InvalidSyntax();
+
         pCTU->Next = Alloc<CTU>();
         pCTU = pCTU->Next;
         CtbAddrInTs++;
@@ -215,7 +223,23 @@ CTU* SDParser::parseSSD(NALU& nalu, NALU* pColPic, Bs32u NumCtb)
     if (!pCTU || (!pCTU->end_of_slice_segment_flag && !slice.Split))
         throw InvalidSyntax();
 
-    if (m_pAllocator)
+    if (m_pColumns)
+    {
+        m_pColumns->Append(slice
+            , m_ctu.data() + nCTU, Bs32u(m_ctu.size() - nCTU)
+            , m_cu.data() + nCU, Bs32u(m_cu.size() - nCU)
+            , m_pu.data() + nPU, Bs32u(m_pu.size() - nPU)
+            , m_tu.data() + nTU, Bs32u(m_tu.size() - nTU));
+
+        BS2_SET(Bs32u(m_ctu.size() - nCTU), slice.NumCTU);
+
+        if (m_pAllocator && NeedColMv(nalu))
+            slice.colMv = BuildColMv(slice, m_pu.data() + nPU, Bs32u(m_pu.size() - nPU));
+
+        pCTU = 0;
+    }
+
+    if (m_pAllocator && pCTU)
     {
         nCTU = m_ctu.size() - nCTU;
         nCU  = m_cu.size()  - nCU;
@@ -304,6 +328,49 @@ CTU* SDParser::parseSSD(NALU& nalu, NALU* pColPic, Bs32u NumCtb)
     return pCTU;
 }
 
+bool SDParser::NeedColMv(NALU& nalu)
+{
+    auto& sps = *nalu.slice->sps;
+
+    // pictures which can't be collocated ones don't need motion field
+    return sps.temporal_mvp_enabled_flag
+        && !(   isSLNonRefPic(nalu)
+             && nalu.nuh_temporal_id_plus1 - 1 == sps.max_sub_layers_minus1);
+}
+
+ColMv* SDParser::BuildColMv(Slice& slice, const PU* pu, Bs32u nPU)
+{
+    Bs16u log2BlkInCtb = CtbLog2SizeY - 4;
+    Bs32u blkMask      = (1 << log2BlkInCtb) - 1;
+    Bs32u nBlk         = slice.NumCTU << (2 * log2BlkInCtb);
+    Bs32u firstTs      = CtbAddrRsToTs[slice.slice_segment_address];
+    ColMv intra        = { { { 0, 0 }, { 0, 0 } }, { -1, -1 } };
+
+    auto colMv = m_pAllocator->alloc_nozero<ColMv>(&slice, nBlk);
+    std::fill_n(colMv, nBlk, intra);
+
+    // 8.5.3.2.8 takes motion of PU covering top-left sample of 16x16 block,
+    // blocks of intra CUs have no PU and stay unavailable
+    for (Bs32u i = 0; i < nPU; i++)
+    {
+        auto& e = pu[i];
+        ColMv mv = {};
+
+        memcpy(mv.MvLX, e.MvLX, sizeof(mv.MvLX));
+        mv.RefIdxLX[0] = (e.inter_pred_idc != PRED_L1) ? Bs8s(e.ref_idx_l0) : -1;
+        mv.RefIdxLX[1] = (e.inter_pred_idc != PRED_L0) ? Bs8s(e.ref_idx_l1) : -1;
+
+        Bs32u ts  = CtbAddrRsToTs[(e.y >> CtbLog2SizeY) * PicWidthInCtbsY + (e.x >> CtbLog2SizeY)];
+        auto  ctb = colMv + ((ts - firstTs) << (2 * log2BlkInCtb));
+
+        for (Bs32u y = (e.y + 15u) & ~15u; y < Bs32u(e.y + e.h); y += 16)
+            for (Bs32u x = (e.x + 15u) & ~15u; x < Bs32u(e.x + e.w); x += 16)
+                ctb[(((y >> 4) & blkMask) << log2BlkInCtb) + ((x >> 4) & blkMask)] = mv;
+    }
+
+    return colMv;
+}
+
 void SDParser::parseSAO(CTU& ctu, Bs16u rx, Bs16u ry)
 {
     TLAuto tl(*this, TRACE_CTU);
@@ -0,0 +1,373 @@
+// Copyright (c) 2020 Intel Corporation
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Converts binary trace written by bs_parser_hevc after set_trace_binary(true)
+// to the text trace or to CSV tables
+
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <bs_reader2.h>
+
+#if !defined(__GNUC__) && !defined(__clang__)
+  #pragma warning(disable:4996)
+#endif
+
+using namespace BsReader2;
+
+static const char CTU_START[] = "ctu.CtbAddrInRs";
+static const char CTU_END[]   = "ctu.end_of_slice_segment_flag";
+
+int printUsage(char* argv[])
+{
+    printf("Usage: %s [-text|-csv|-ctu] <binary_trace> [<output>]\n", argv[0]);
+    printf("    -text  restore text trace (default)\n");
+    printf("    -csv   one row per traced syntax element\n");
+    printf("    -ctu   one row per CTU, one column per syntax element traced inside CTU\n");
+    return -1;
+}
+
+template<class T> void PrintBin(FILE* out, const BinTraceRecord& rec)
+{
+    std::vector<T> p(rec.Raw.size() / sizeof(T));
+
+    if (!p.empty())
+        memcpy(p.data(), rec.Raw.data(), rec.Raw.size());
+
+    TraceBin(out, p.data(), rec.Offset, rec.Size);
+}
+
+void PrintText(FILE* out, const BinTraceRecord& rec)
+{
+    if (rec.HasOffset && rec.HasCABAC)
+        fprintf(out, "0x%016llX[%i]|%3u|%3u: ", rec.ByteOffset, rec.BitOffset, rec.R, rec.V);
+    else if (rec.HasOffset)
+        fprintf(out, "0x%016llX[%i]: ", rec.ByteOffset, rec.BitOffset);
+
+    switch (rec.Type)
+    {
+    case BT_VALUE:
+        fprintf(out, "%s = %i\n", rec.Name, int(rec.Value[0]));
+        break;
+    case BT_VALUE64:
+        fprintf(out, "%s = %lli\n", rec.Name, rec.Value[0]);
+        break;
+    case BT_MAPPED:
+        fprintf(out, "%s = %s(%d)\n", rec.Name, rec.Str[0], int(rec.Value[0]));
+        break;
+    case BT_STRING:
+        fprintf(out, "%s\n", rec.Str[0]);
+        break;
+    case BT_ARRAY:
+    case BT_ARRAY_MAPPED:
+        fprintf(out, "%s = { ", rec.Name);
+        for (size_t i = 0; i < rec.Value.size(); i++)
+        {
+            if (rec.Split != 0 && i % rec.Split == 0)
+                fprintf(out, "\n");
+            if (rec.Type == BT_ARRAY_MAPPED)
+                fprintf(out, rec.Format, rec.Str[i], int(rec.Value[i]));
+            else
+                fprintf(out, rec.Format, int(rec.Value[i]));
+        }
+        fprintf(out, "}\n");
+        break;
+    case BT_MDARRAY:
+    {
+        std::vector<int> arr(rec.Value.begin(), rec.Value.end());
+        fprintf(out, "%s = \n", rec.Name);
+        TraceMDArr(out, arr.data(), rec.Dim.data(), Bs32u(rec.Dim.size()), Bs16u(rec.Split), rec.Format, Bs16u(rec.Split2));
+        break;
+    }
+    case BT_BIN:
+        fprintf(out, "%s = ", rec.Name);
+        switch (rec.ElemSize)
+        {
+        case 1: PrintBin<Bs8u>(out, rec); break;
+        case 2: PrintBin<Bs16u>(out, rec); break;
+        case 4: PrintBin<Bs32u>(out, rec); break;
+        default: PrintBin<Bs64u>(out, rec); break;
+        }
+        fprintf(out, "\n");
+        break;
+    default:
+        break;
+    }
+}
+
+std::string CsvField(const char* s)
+{
+    std::string f(s);
+
+    if (f.find_first_of(",\"\n") == std::string::npos)
+        return f;
+
+    for (size_t i = f.find('"'); i != std::string::npos; i = f.find('"', i + 2))
+        f.insert(i, 1, '"');
+
+    return "\"" + f + "\"";
+}
+
+// values of one record, array elements are separated with ':'
+std::string Values(const BinTraceRecord& rec)
+{
+    std::string v;
+
+    if (rec.Type == BT_BIN)
+    {
+        for (Bs32u i = 0; i < rec.Size; i++)
+        {
+            Bs32u bit = rec.Offset + i;
+            Bs32u S0 = rec.ElemSize * 8;
+            Bs32u elem = bit / S0;
+            Bs64u e = 0;
+
+            memcpy(&e, rec.Raw.data() + elem * rec.ElemSize, rec.ElemSize);
+            v += ((e >> (S0 - 1 - bit % S0)) & 1) ? '1' : '0';
+        }
+        return v;
+    }
+
+    for (size_t i = 0; i < rec.Value.size(); i++)
+    {
+        if (i)
+            v += ':';
+        v += std::to_string(rec.Value[i]);
+    }
+
+    return v;
+}
+
+std::string Labels(const BinTraceRecord& rec)
+{
+    std::string l;
+
+    for (size_t i = 0; i < rec.Str.size(); i++)
+    {
+        if (i)
+            l += ' ';
+        l += rec.Str[i];
+    }
+
+    return l;
+}
+
+bool IsCtuStart(const BinTraceRecord& rec)
+{
+    return rec.Type == BT_VALUE && !strcmp(rec.Name, CTU_START);
+}
+
+bool IsCtuEnd(const BinTraceRecord& rec)
+{
+    return rec.Type == BT_STRING || (rec.Type == BT_VALUE && !strcmp(rec.Name, CTU_END));
+}
+
+int DumpText(BinTraceReader& reader, FILE* out)
+{
+    BinTraceRecord rec = {};
+
+    while (reader.Next(rec))
+        PrintText(out, rec);
+
+    return reader.Error() ? -1 : 0;
+}
+
+int DumpCsv(BinTraceReader& reader, FILE* out)
+{
+    BinTraceRecord rec = {};
+    std::string ctu;
+
+    fprintf(out, "byte_offset,bit_offset,r,v,ctu,name,value,label\n");
+
+    while (reader.Next(rec))
+    {
+        if (IsCtuStart(rec))
+            ctu = std::to_string(rec.Value[0]);
+
+        if (rec.HasOffset)
+            fprintf(out, "%llu,%u,", rec.ByteOffset, rec.BitOffset);
+        else
+            fprintf(out, ",,");
+
+        if (rec.HasCABAC)
+            fprintf(out, "%u,%u,", rec.R, rec.V);
+        else
+            fprintf(out, ",,");
+
+        fprintf(out, "%s,%s,%s,%s\n"
+            , ctu.c_str()
+            , CsvField(rec.Name).c_str()
+            , Values(rec).c_str()
+            , CsvField(Labels(rec).c_str()).c_str());
+
+        if (IsCtuEnd(rec))
+            ctu.clear();
+    }
+
+    return reader.Error() ? -1 : 0;
+}
+
+// two passes: the first one collects columns, the second one fills rows
+int DumpCtu(BinTraceReader& reader, FILE* in, FILE* out)
+{
+    BinTraceRecord rec = {};
+    std::vector<std::string> row;
+    std::unordered_map<std::string, size_t> colIdx;
+    std::vector<std::string> cols;
+    bool inCtu = false;
+
+    while (reader.Next(rec))
+    {
+        inCtu |= IsCtuStart(rec);
+
+        if (inCtu && rec.Type != BT_STRING && !colIdx.count(rec.Name))
+        {
+            colIdx[rec.Name] = cols.size();
+            cols.push_back(rec.Name);
+        }
+
+        inCtu &= !IsCtuEnd(rec);
+    }
+
+    if (reader.Error() || fseek(in, 0, SEEK_SET) || !reader.Open(in))
+        return -1;
+
+    fprintf(out, "pic,ctu,byte_offset");
+    for (auto& c : cols)
+        fprintf(out, ",%s", CsvField(c.c_str()).c_str());
+    fprintf(out, "\n");
+
+    Bs32s pic = -1;
+    Bs32u nCtu = 0;
+    Bs64u ctuOffset = 0;
+
+    auto flush = [&]()
+    {
+        fprintf(out, "%d,%u,%llu", pic, nCtu++, ctuOffset);
+        for (auto& c : row)
+            fprintf(out, ",%s", c.c_str());
+        fprintf(out, "\n");
+        inCtu = false;
+    };
+
+    while (reader.Next(rec))
+    {
+        if (IsCtuStart(rec))
+        {
+            if (inCtu)
+                flush();
+
+            inCtu = true;
+            pic += !rec.Value[0];
+            ctuOffset = rec.ByteOffset;
+            row.assign(cols.size(), std::string());
+        }
+
+        if (!inCtu)
+            continue;
+
+        if (rec.Type != BT_STRING)
+        {
+            std::string& cell = row[colIdx[rec.Name]];
+
+            if (!cell.empty())
+                cell += ' ';
+            cell += Values(rec);
+        }
+
+        if (IsCtuEnd(rec))
+            flush();
+    }
+
+    if (inCtu)
+        flush();
+
+    return reader.Error() ? -1 : 0;
+}
+
+int main(int argc, char* argv[])
+{
+    int   argIdx = 1;
+    int   sts = 0;
+    char  mode = 't';
+    FILE* in = 0;
+    FILE* out = stdout;
+    BinTraceReader reader;
+
+    if (argc > 1 && argv[1][0] == '-')
+    {
+        if (!strcmp(argv[1], "-text"))
+            mode = 't';
+        else if (!strcmp(argv[1], "-csv"))
+            mode = 'c';
+        else if (!strcmp(argv[1], "-ctu"))
+            mode = 'u';
+        else
+            return printUsage(argv);
+        argIdx++;
+    }
+
+    if (argIdx >= argc)
+        return printUsage(argv);
+
+    in = fopen(argv[argIdx], "rb");
+    if (!in)
+    {
+        fprintf(stderr, "ERROR: Unable to open %s\n", argv[argIdx]);
+        return -1;
+    }
+
+    if (argIdx + 1 < argc)
+    {
+        out = fopen(argv[argIdx + 1], "w");
+        if (!out)
+        {
+            fprintf(stderr, "ERROR: Unable to open %s\n", argv[argIdx + 1]);
+            fclose(in);
+            return -1;
+        }
+    }
+
+    if (!reader.Open(in))
+    {
+        fprintf(stderr, "ERROR: %s is not a binary trace\n", argv[argIdx]);
+        sts = -1;
+    }
+    else
+    {
+        if (mode == 'c')
+            sts = DumpCsv(reader, out);
+        else if (mode == 'u')
+            sts = DumpCtu(reader, in, out);
+        else
+            sts = DumpText(reader, out);
+
+        if (sts)
+            fprintf(stderr, "ERROR: corrupted binary trace\n");
+    }
+
+    fclose(in);
+    if (out != stdout)
+        fclose(out);
+
+    return sts;
+}
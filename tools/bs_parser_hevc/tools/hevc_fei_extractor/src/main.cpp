@@ -30,6 +30,7 @@
 #include <fstream>
 #include <iomanip>
 #include <algorithm>
+#include <chrono>
 #include <bs_parser++.h>
 #include "mfxfeihevc.h"
 
@@ -97,6 +98,31 @@ public:
     };
 };
 
+// Splits wall-clock time of CTU/CU dump into parsing of AUs and building of PAK records (-time)
+class DumpTimer
+{
+public:
+    void StartParse() { m_start = clock::now(); }
+    void StopParse()  { m_parse += clock::now() - m_start; }
+    void CountAU()    { m_numAU++; }
+
+    void Print() const
+    {
+        double total = std::chrono::duration<double, std::milli>(clock::now() - m_begin).count();
+        double parse = std::chrono::duration<double, std::milli>(m_parse).count();
+
+        printf("%u AUs: parsing %.1f ms, PAK records %.1f ms, total %.1f ms\n", m_numAU, parse, total - parse, total);
+    }
+
+private:
+    typedef std::chrono::steady_clock clock;
+
+    clock::time_point m_begin = clock::now();
+    clock::time_point m_start;
+    clock::duration   m_parse = clock::duration::zero();
+    unsigned int      m_numAU = 0;
+};
+
 using namespace BS_HEVC2;
 
 inline bool IsHEVCSlice(Bs32u nut) { return (nut <= 21) && ((nut < 10) || (nut > 15)); }
@@ -113,9 +139,11 @@ inline bool IsHEVCSlice(Bs32u nut) { return (nut <= 21) && ((nut < 10) || (nut >
 int printUsage(char* argv[])
 {
     printf("Parser for HEVC bit-streams dumps fei-specific information.\n");
-    printf("Usage: %s <stream_name> <fei_hevc_pak_ctu> <fei_hevc_pak_cu>\n", argv[0]);
+    printf("Usage: %s <stream_name> <fei_hevc_pak_ctu> <fei_hevc_pak_cu> [-soa] [-time]\n", argv[0]);
     printf("   or: %s <stream_name> -pic_file <pic_refinfo>\n", argv[0]);
     printf("   or: %s <stream_name> -multi_pak_str <multi_repack_output_file>\n", argv[0]);
+    printf("   -soa: read slice data from structure-of-arrays columns instead of CTU/CU/PU lists\n");
+    printf("   -time: print time spent in parsing and in building of PAK records\n");
     return 1;
 }
 
@@ -154,35 +182,40 @@ mfxU32 GetIntraChromaModeFEI(Bs8u intraPredModeC_0_0)
     }
 }
 
-void SetIntraPredModeFEI(const CU* pCU, mfxFeiHevcPakCuRecordV0& pakCuRecorderV0)
+void SetIntraPredModeFEI(const Bs8u (&IntraPredModeY)[2][2], const Bs8u (&IntraPredModeC)[2][2], mfxFeiHevcPakCuRecordV0& pakCuRecorderV0)
 {
-    if(pCU == nullptr)
-        throw std::string("ERROR: SetIntraPredModeFEI: pCU is equal to nullptr");
-
     // Luma
-    if (pCU->IntraPredModeY[0][0] > 34
-        || pCU->IntraPredModeY[1][0] > 34
-        || pCU->IntraPredModeY[0][1] > 34
-        || pCU->IntraPredModeY[1][1] > 34)
+    if (IntraPredModeY[0][0] > 34
+        || IntraPredModeY[1][0] > 34
+        || IntraPredModeY[0][1] > 34
+        || IntraPredModeY[1][1] > 34)
     {
         throw std::string("ERROR: SetIntraPredModeFEI: incorrect IntraPredModeY[X][X]\n");
     }
 
-    pakCuRecorderV0.IntraMode0 = pCU->IntraPredModeY[0][0];
-    pakCuRecorderV0.IntraMode1 = pCU->IntraPredModeY[1][0];
-    pakCuRecorderV0.IntraMode2 = pCU->IntraPredModeY[0][1];
-    pakCuRecorderV0.IntraMode3 = pCU->IntraPredModeY[1][1];
+    pakCuRecorderV0.IntraMode0 = IntraPredModeY[0][0];
+    pakCuRecorderV0.IntraMode1 = IntraPredModeY[1][0];
+    pakCuRecorderV0.IntraMode2 = IntraPredModeY[0][1];
+    pakCuRecorderV0.IntraMode3 = IntraPredModeY[1][1];
 
     // Chroma
     // For ChromaArrayType != 3 (4:4:4) all elements of the array intra_chroma_pred_mode[2][2] are equal
     // Table 7.3.8.5 from ITU-T H.265 (V4)
     // HEVC FEI ENCODE on SKL supports 4:2:0 mode only
-    if (pCU->IntraPredModeC[0][0] > 34)
+    if (IntraPredModeC[0][0] > 34)
     {
         throw std::string("ERROR: SetIntraPredModeFEI: incorrect IntraPredModeC[0][0]");
     }
 
-    pakCuRecorderV0.IntraChromaMode = GetIntraChromaModeFEI(pCU->IntraPredModeC[0][0]);
+    pakCuRecorderV0.IntraChromaMode = GetIntraChromaModeFEI(IntraPredModeC[0][0]);
+}
+
+void SetIntraPredModeFEI(const CU* pCU, mfxFeiHevcPakCuRecordV0& pakCuRecorderV0)
+{
+    if(pCU == nullptr)
+        throw std::string("ERROR: SetIntraPredModeFEI: pCU is equal to nullptr");
+
+    SetIntraPredModeFEI(pCU->IntraPredModeY, pCU->IntraPredModeC, pakCuRecorderV0);
 }
 
 void SetLevel2(mfxFeiHevcPakCtuRecordV0& pakCtuRecordV0, Bs32u& startShift, Bs32u ctbLog2SizeY, Bs32u log2CbSize, Bs32u idxQuadTreeLevel2, Bs32u idxQuadTreeLevel1)
@@ -277,29 +310,34 @@ inline void SetInterpredIdc(mfxFeiHevcPakCuRecordV0& pakCuRecordV0, Bs16u interp
         pakCuRecordV0.InterpredIdc |= interpredIdc << (2 * countPU);
 }
 
-inline void SetPURefIdx(mfxFeiHevcPakCuRecordV0& pakCuRecordV0, PU* pPU, Bs32u countPU)
+inline void SetPURefIdx(mfxFeiHevcPakCuRecordV0& pakCuRecordV0, Bs8u refIdxL0, Bs8u refIdxL1, Bs32u countPU)
 {
     switch (countPU)
     {
     case 0:
-        pakCuRecordV0.RefIdx[0].Ref0 = pPU->ref_idx_l0;
-        pakCuRecordV0.RefIdx[1].Ref0 = pPU->ref_idx_l1;
+        pakCuRecordV0.RefIdx[0].Ref0 = refIdxL0;
+        pakCuRecordV0.RefIdx[1].Ref0 = refIdxL1;
         break;
     case 1:
-        pakCuRecordV0.RefIdx[0].Ref1 = pPU->ref_idx_l0;
-        pakCuRecordV0.RefIdx[1].Ref1 = pPU->ref_idx_l1;
+        pakCuRecordV0.RefIdx[0].Ref1 = refIdxL0;
+        pakCuRecordV0.RefIdx[1].Ref1 = refIdxL1;
         break;
     case 2:
-        pakCuRecordV0.RefIdx[0].Ref2 = pPU->ref_idx_l0;
-        pakCuRecordV0.RefIdx[1].Ref2 = pPU->ref_idx_l1;
+        pakCuRecordV0.RefIdx[0].Ref2 = refIdxL0;
+        pakCuRecordV0.RefIdx[1].Ref2 = refIdxL1;
         break;
     case 3:
-        pakCuRecordV0.RefIdx[0].Ref3 = pPU->ref_idx_l0;
-        pakCuRecordV0.RefIdx[1].Ref3 = pPU->ref_idx_l1;
+        pakCuRecordV0.RefIdx[0].Ref3 = refIdxL0;
+        pakCuRecordV0.RefIdx[1].Ref3 = refIdxL1;
         break;
     }
 }
 
+inline void SetPURefIdx(mfxFeiHevcPakCuRecordV0& pakCuRecordV0, PU* pPU, Bs32u countPU)
+{
+    SetPURefIdx(pakCuRecordV0, (Bs8u)pPU->ref_idx_l0, (Bs8u)pPU->ref_idx_l1, countPU);
+}
+
 int DumpPicStruct(BS_HEVC2_parser& parser, const char* name)
 {
     std::ofstream ofs(name, std::ofstream::out);
@@ -514,6 +552,114 @@ int DumpMultiPassPak(BS_HEVC2_parser& parser, const char* name)
     return 0;
 }
 
+// Same records as the main loop produces from CTU/CU/PU lists, read from SDColumns
+int DumpPakColumns(BS_HEVC2_parser& parser, FileHandler& handlerCTU, FileHandler& handlerCU, DumpTimer& timer)
+{
+    mfxFeiHevcPakCtuRecordV0 pakCtuRecordV0;
+    mfxFeiHevcPakCuRecordV0 pakCuRecordV0;
+    BSErr bs_sts = BS_ERR_NONE;
+    BS_HEVC2::NALU* pNALU = nullptr;
+    std::vector<CUBlock> vecCUs;
+
+    while (true)
+    {
+        timer.StartParse();
+        bs_sts = parser.parse_next_au(pNALU);
+        timer.StopParse();
+
+        if (bs_sts == BS_ERR_NOT_IMPLEMENTED)
+            continue;
+        if (bs_sts)
+            break;
+
+        timer.CountAU();
+
+        SDColumns* pCols = nullptr;
+        CHECK_STATUS(parser.get_columns(pCols), BS_ERR_NONE);
+        auto& cols = *pCols;
+
+        for (Bs32u idxSlice = 0; idxSlice < cols.NumSlices; ++idxSlice)
+        {
+            auto& sps = *cols.SliceHeader[idxSlice]->sps;
+
+            Bs32u minCbLog2SizeY = sps.log2_min_luma_coding_block_size_minus3 + 3;
+            Bs32u ctbLog2SizeY = minCbLog2SizeY + sps.log2_diff_max_min_luma_coding_block_size;
+            Bs32u ctbSizeY = 1 << ctbLog2SizeY;
+            Bs32u maxNumCuInCtu = (1 << (sps.log2_diff_max_min_luma_coding_block_size + sps.log2_diff_max_min_luma_coding_block_size));
+            Bs32u widthInCTU = ALIGN(sps.pic_width_in_luma_samples, ctbSizeY) >> ctbLog2SizeY;
+
+            for (Bs32u countCTU = 0; countCTU < cols.SliceNumCtu[idxSlice]; ++countCTU)
+            {
+                Bs32u idxCTU = cols.SliceFirstCtu[idxSlice] + countCTU;
+                Bs32u firstCU = cols.CtuFirstCu[idxCTU];
+                Bs32u countCU = cols.CtuNumCu[idxCTU];
+
+                memset(&pakCtuRecordV0, 0, sizeof(pakCtuRecordV0));
+                vecCUs.clear();
+
+                for (Bs32u idxCU = firstCU; idxCU < firstCU + countCU; ++idxCU)
+                {
+                    memset(&pakCuRecordV0, 0, sizeof(pakCuRecordV0));
+
+                    vecCUs.emplace_back((Bs32u)cols.CuX[idxCU], (Bs32u)cols.CuY[idxCU], (Bs32u)cols.CuLog2CbSize[idxCU]);
+
+                    CHECK_STATUS(ConvertPredModeToFeiPredMode(cols.CuPredMode[idxCU], pakCuRecordV0), BS_ERR_NONE);
+                    pakCuRecordV0.PartMode = cols.CuPartMode[idxCU];
+
+                    if (cols.CuPredMode[idxCU] == MODE_INTRA)
+                        SetIntraPredModeFEI(cols.CuIntraPredModeY[idxCU], cols.CuIntraPredModeC[idxCU], pakCuRecordV0);
+
+                    if (cols.CuNumPu[idxCU] > MAX_PU_NUM)
+                        throw std::string("ERROR: DumpPakColumns: Number of PUs more than 4");
+
+                    for (Bs32u countPU = 0; countPU < cols.CuNumPu[idxCU]; ++countPU)
+                    {
+                        Bs32u idxPU = cols.CuFirstPu[idxCU] + countPU;
+
+                        SetInterpredIdc(pakCuRecordV0, cols.PuInterPredIdc[idxPU], countPU);
+
+                        for (Bs32u listIdx = 0; listIdx < 2; listIdx++)
+                        {
+                            pakCuRecordV0.MVs[listIdx].x[countPU] = cols.PuMvLX[idxPU][listIdx][0];
+                            pakCuRecordV0.MVs[listIdx].y[countPU] = cols.PuMvLX[idxPU][listIdx][1];
+                        }
+
+                        SetPURefIdx(pakCuRecordV0, cols.PuRefIdx[idxPU][0], cols.PuRefIdx[idxPU][1], countPU);
+                    }
+
+                    handlerCU.Write(pakCuRecordV0);
+                    if (handlerCU.CheckStatus())
+                        throw std::string("ERROR: DumpPakColumns: issue with file writing");
+                }
+
+                // Alignment with zero-padding for FEI CU buffer
+                memset(&pakCuRecordV0, 0, sizeof(pakCuRecordV0));
+
+                for (Bs32u idxEmptyCU = countCU; idxEmptyCU < maxNumCuInCtu; ++idxEmptyCU)
+                {
+                    handlerCU.Write(pakCuRecordV0);
+                    if (handlerCU.CheckStatus())
+                        throw std::string("ERROR: DumpPakColumns: issue with file writing");
+                }
+
+                SetLevel0(pakCtuRecordV0, ctbLog2SizeY, vecCUs);
+
+                pakCtuRecordV0.CuCountMinus1 = countCU - 1;
+                pakCtuRecordV0.CtuAddrX = countCTU % widthInCTU;
+                pakCtuRecordV0.CtuAddrY = countCTU / widthInCTU;
+
+                handlerCTU.Write(pakCtuRecordV0);
+                if (handlerCTU.CheckStatus())
+                    throw std::string("ERROR: DumpPakColumns: issue with file writing");
+            }
+        }
+    }
+
+    CHECK_STATUS(bs_sts, BS_ERR_MORE_DATA);
+
+    return 0;
+}
+
 #endif // MFX_VERSION
 
 int main(int argc, char* argv[]) {
@@ -529,7 +675,21 @@ int main(int argc, char* argv[]) {
         }
         BSErr bs_sts = BS_ERR_NONE;
 
-        BS_HEVC2_parser parser(PARSE_SSD);
+        bool soa = false, time = false;
+
+        for (int i = 4; i < argc; i++)
+        {
+            if (strcmp(argv[i], "-soa") == 0)
+                soa = true;
+            else if (strcmp(argv[i], "-time") == 0)
+                time = true;
+            else
+                return printUsage(argv);
+        }
+
+        DumpTimer timer;
+
+        BS_HEVC2_parser parser(soa ? PARSE_SSD_SOA : PARSE_SSD);
 
         CHECK_STATUS(parser.open(argv[1]), BS_ERR_NONE);
 
@@ -553,6 +713,14 @@ int main(int argc, char* argv[]) {
         if (handlerCU.CheckStatus())
             throw std::string("ERROR: main: issue with file opening");
 
+        if (soa)
+        {
+            int sts = DumpPakColumns(parser, handlerCTU, handlerCU, timer);
+            if (time)
+                timer.Print();
+            return sts;
+        }
+
         // CTU information
         mfxFeiHevcPakCtuRecordV0 pakCtuRecordV0;
         memset(&pakCtuRecordV0, 0, sizeof(pakCtuRecordV0));
@@ -565,13 +733,17 @@ int main(int argc, char* argv[]) {
 
         while (true)
         {
+            timer.StartParse();
             bs_sts = parser.parse_next_au(pNALU);
+            timer.StopParse();
 
             if (bs_sts == BS_ERR_NOT_IMPLEMENTED)
                 continue;
             if (bs_sts)
                 break;
 
+            timer.CountAU();
+
             for (auto pNALUIdx = pNALU; pNALUIdx; pNALUIdx = pNALUIdx->next)
             {
                 if (!IsHEVCSlice(pNALUIdx->nal_unit_type))
@@ -667,6 +839,9 @@ int main(int argc, char* argv[]) {
             }// End for (auto pNALUIdx = pNALU; pNALUIdx; pNALUIdx = pNALUIdx->next)
         }// End while(1)
         CHECK_STATUS(bs_sts, BS_ERR_MORE_DATA);
+
+        if (time)
+            timer.Print();
     }
     catch (std::string & e) {
         std::cout << e << std::endl;
@@ -441,6 +441,9 @@ std::string DumpContext::dump(const std::string structName, const mfxInfoMFX &mf
     str += structName + ".Interleaved=" + ToString(mfx.Interleaved) + "\n";
     str += structName + ".Quality=" + ToString(mfx.Quality) + "\n";
     str += structName + ".RestartInterval=" + ToString(mfx.RestartInterval) + "\n";
+#if (MFX_VERSION >= MFX_VERSION_NEXT)
+    str += structName + ".OptimizeHuffman=" + ToString(mfx.OptimizeHuffman) + "\n";
+#endif
     str += structName + ".reserved5[]=" + DUMP_RESERVED_ARRAY(mfx.reserved5) + "\n";
     return str;
 }